@@ -10,7 +10,7 @@ namespace Attr
 AttrExitHandler AttributeDefinitionBase::attrExitHandler;
 
 Util::HashTable<Util::String, const AttributeDefinitionBase*>* AttributeDefinitionBase::NameRegistry = 0;
-Util::Dictionary<Util::FourCC, const AttributeDefinitionBase*>* AttributeDefinitionBase::FourCCRegistry = 0;
+Util::HashTable<Util::FourCC, const AttributeDefinitionBase*>* AttributeDefinitionBase::FourCCRegistry = 0;
 Util::Array<const AttributeDefinitionBase*>* AttributeDefinitionBase::DynamicAttributes = 0;
    
 //------------------------------------------------------------------------------
@@ -168,7 +168,7 @@ AttributeDefinitionBase::CheckCreateFourCCRegistry()
 {
     if (0 == FourCCRegistry)
     {
-        FourCCRegistry = new Util::Dictionary<Util::FourCC, const AttributeDefinitionBase*>;
+        FourCCRegistry = new Util::HashTable<Util::FourCC, const AttributeDefinitionBase*>(1024);
     }
 }
 
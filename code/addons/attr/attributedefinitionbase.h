@@ -90,7 +90,7 @@ private:
     friend class AttrId;
     static AttrExitHandler attrExitHandler;
     static Util::HashTable<Util::String, const AttributeDefinitionBase*>* NameRegistry;
-    static Util::Dictionary<Util::FourCC, const AttributeDefinitionBase*>* FourCCRegistry;
+    static Util::HashTable<Util::FourCC, const AttributeDefinitionBase*>* FourCCRegistry;
     static Util::Array<const AttributeDefinitionBase*>* DynamicAttributes;
 };
 
@@ -102,13 +102,14 @@ const AttributeDefinitionBase*
 AttributeDefinitionBase::FindByName(const Util::String& n)
 {
     n_assert(0 != NameRegistry);
-    if (!NameRegistry->Contains(n))
+    IndexT index = NameRegistry->FindIndex(n);
+    if (InvalidIndex == index)
     {
         return 0;
     }
     else
     {
-        return (*NameRegistry)[n];
+        return NameRegistry->ValueAtIndex(index);
     }
 }
 
@@ -120,13 +121,14 @@ const AttributeDefinitionBase*
 AttributeDefinitionBase::FindByFourCC(const Util::FourCC& fcc)
 {
     n_assert(0 != FourCCRegistry);
-    if (!FourCCRegistry->Contains(fcc))
+    IndexT index = FourCCRegistry->FindIndex(fcc);
+    if (InvalidIndex == index)
     {
         return 0;
     }
     else
     {
-        return (*FourCCRegistry)[fcc];
+        return FourCCRegistry->ValueAtIndex(index);
     }
 }
 
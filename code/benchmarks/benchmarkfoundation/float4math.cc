@@ -4,6 +4,7 @@
 //------------------------------------------------------------------------------
 #include "stdneb.h"
 #include "float4math.h"
+#include "math/sse/sse_ops.h"
 
 namespace Benchmarking
 {
@@ -12,6 +13,50 @@ __ImplementClass(Benchmarking::Float4Math, 'F4MT', Benchmarking::Benchmark);
 using namespace Timing;
 using namespace Math;
 
+//------------------------------------------------------------------------------
+/**
+    Defines a function which runs the same mix of operations as the
+    benchmark directly on the primitives of one primitive set of the
+    portable math backend (ScalarOps, SSE41Ops or AVX2Ops) and prints
+    the time.
+*/
+#define __Float4MathOps(OPS) \
+static void \
+OPS##Math(IndexT run, const float4* f0, const float4* f1, float4* res, SizeT num) \
+{ \
+    const OPS::vec4 half = OPS::splat(0.5f); \
+    Timer benchTimer; \
+    benchTimer.Start(); \
+    IndexT i; \
+    for (i = 0; i < 100; i++) \
+    { \
+        IndexT j; \
+        for (j = 0; j < num; j++) \
+        { \
+            OPS::vec4 v0 = OPS::load((const float*)&f0[j]); \
+            OPS::vec4 v1 = OPS::load((const float*)&f1[j]); \
+            OPS::vec4 tmp0 = OPS::add(v0, v1); \
+            OPS::vec4 tmp1 = OPS::mul(tmp0, OPS::dot3(v0, v1)); \
+            OPS::vec4 tmp2 = OPS::cross3(tmp0, tmp1); \
+            tmp1 = OPS::madd(OPS::sub(tmp2, tmp0), half, tmp0); \
+            tmp0 = OPS::div(tmp1, OPS::sqrt(OPS::dot4(tmp1, tmp1))); \
+            tmp1 = OPS::max(tmp0, tmp1); \
+            tmp2 = OPS::min(tmp0, tmp1); \
+            OPS::store((float*)&res[j], OPS::sub(tmp1, tmp2)); \
+        } \
+    } \
+    benchTimer.Stop(); \
+    n_printf("Run %d: " #OPS " float4 math on %d vectors: %f\n", run, 100 * num, benchTimer.GetTime()); \
+}
+
+__Float4MathOps(ScalarOps);
+#if NEBULA3_MATH_HAS_SSE41
+__Float4MathOps(SSE41Ops);
+#endif
+#if NEBULA3_MATH_HAS_AVX2
+__Float4MathOps(AVX2Ops);
+#endif
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -60,6 +105,19 @@ Float4Math::Run(Timer& timer)
         }
     }
     timer.Stop();
+
+    // compare the primitive sets against each other
+    IndexT run;
+    for (run = 0; run < 3; run++)
+    {
+        ScalarOpsMath(run, f0, f1, res, num);
+        #if NEBULA3_MATH_HAS_SSE41
+        SSE41OpsMath(run, f0, f1, res, num);
+        #endif
+        #if NEBULA3_MATH_HAS_AVX2
+        AVX2OpsMath(run, f0, f1, res, num);
+        #endif
+    }
     n_delete_array(f0);
     n_delete_array(f1);
     n_delete_array(res);
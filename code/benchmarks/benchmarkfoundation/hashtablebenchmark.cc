@@ -0,0 +1,156 @@
+//------------------------------------------------------------------------------
+//  hashtablebenchmark.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "hashtablebenchmark.h"
+#include "util/dictionary.h"
+#include "util/hashtable.h"
+#include "util/fixedarray.h"
+#include "util/fourcc.h"
+
+namespace Benchmarking
+{
+__ImplementClass(Benchmarking::HashTableBenchmark, 'HTBM', Benchmarking::Benchmark);
+
+using namespace Timing;
+using namespace Util;
+
+//------------------------------------------------------------------------------
+/**
+    Inserts 50000 keys into each container and looks every key up 10 times,
+    half of the lookups are for keys which don't exist (like the
+    Contains() checks in the factory and the attribute registry).
+*/
+void
+HashTableBenchmark::Run(Timer& timer)
+{
+    timer.Start();
+
+    const SizeT NumKeys = 50000;
+    const SizeT NumLookups = 10;
+    FixedArray<String> strings(NumKeys * 2);
+    FixedArray<FourCC> fourccs(NumKeys * 2);
+    IndexT i;
+    for (i = 0; i < NumKeys * 2; i++)
+    {
+        strings[i].Format("Attr::SomeAttributeName%d", i);
+        fourccs[i] = FourCC(0x41414141 + (i * 7919));
+    }
+
+    Timer benchTimer;
+    IndexT run;
+    for (run = 0; run < 3; run++)
+    {
+        IndexT lookup;
+        SizeT numFound;
+
+        // dictionary with string keys
+        Dictionary<String, IndexT> stringDict;
+        benchTimer.Reset();
+        benchTimer.Start();
+        stringDict.BeginBulkAdd();
+        for (i = 0; i < NumKeys; i++)
+        {
+            stringDict.Add(strings[i], i);
+        }
+        stringDict.EndBulkAdd();
+        benchTimer.Stop();
+        n_printf("Run %d: Dictionary insert %d strings: %f\n", run, NumKeys, benchTimer.GetTime());
+
+        numFound = 0;
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (lookup = 0; lookup < NumLookups; lookup++)
+        {
+            for (i = 0; i < NumKeys * 2; i += 2)
+            {
+                numFound += stringDict.Contains(strings[i]) ? 1 : 0;
+            }
+        }
+        benchTimer.Stop();
+        n_assert(numFound == (NumKeys / 2) * NumLookups);
+        n_printf("Run %d: Dictionary lookup %d strings: %f\n", run, NumKeys * NumLookups, benchTimer.GetTime());
+
+        // hash table with string keys
+        HashTable<String, IndexT> stringTable;
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (i = 0; i < NumKeys; i++)
+        {
+            stringTable.Add(strings[i], i);
+        }
+        benchTimer.Stop();
+        n_printf("Run %d: HashTable insert %d strings: %f\n", run, NumKeys, benchTimer.GetTime());
+
+        numFound = 0;
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (lookup = 0; lookup < NumLookups; lookup++)
+        {
+            for (i = 0; i < NumKeys * 2; i += 2)
+            {
+                numFound += (InvalidIndex != stringTable.FindIndex(strings[i])) ? 1 : 0;
+            }
+        }
+        benchTimer.Stop();
+        n_assert(numFound == (NumKeys / 2) * NumLookups);
+        n_printf("Run %d: HashTable lookup %d strings: %f\n", run, NumKeys * NumLookups, benchTimer.GetTime());
+
+        // dictionary with fourcc keys
+        Dictionary<FourCC, IndexT> fourccDict;
+        benchTimer.Reset();
+        benchTimer.Start();
+        fourccDict.BeginBulkAdd();
+        for (i = 0; i < NumKeys; i++)
+        {
+            fourccDict.Add(fourccs[i], i);
+        }
+        fourccDict.EndBulkAdd();
+        benchTimer.Stop();
+        n_printf("Run %d: Dictionary insert %d fourccs: %f\n", run, NumKeys, benchTimer.GetTime());
+
+        numFound = 0;
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (lookup = 0; lookup < NumLookups; lookup++)
+        {
+            for (i = 0; i < NumKeys * 2; i += 2)
+            {
+                numFound += fourccDict.Contains(fourccs[i]) ? 1 : 0;
+            }
+        }
+        benchTimer.Stop();
+        n_assert(numFound == (NumKeys / 2) * NumLookups);
+        n_printf("Run %d: Dictionary lookup %d fourccs: %f\n", run, NumKeys * NumLookups, benchTimer.GetTime());
+
+        // hash table with fourcc keys
+        HashTable<FourCC, IndexT> fourccTable;
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (i = 0; i < NumKeys; i++)
+        {
+            fourccTable.Add(fourccs[i], i);
+        }
+        benchTimer.Stop();
+        n_printf("Run %d: HashTable insert %d fourccs: %f\n", run, NumKeys, benchTimer.GetTime());
+
+        numFound = 0;
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (lookup = 0; lookup < NumLookups; lookup++)
+        {
+            for (i = 0; i < NumKeys * 2; i += 2)
+            {
+                numFound += (InvalidIndex != fourccTable.FindIndex(fourccs[i])) ? 1 : 0;
+            }
+        }
+        benchTimer.Stop();
+        n_assert(numFound == (NumKeys / 2) * NumLookups);
+        n_printf("Run %d: HashTable lookup %d fourccs: %f\n", run, NumKeys * NumLookups, benchTimer.GetTime());
+    }
+
+    timer.Stop();
+}
+
+} // namespace Benchmarking
@@ -0,0 +1,25 @@
+#pragma once
+//------------------------------------------------------------------------------
+/** 
+    @class Benchmarking::HashTableBenchmark
+    
+    Compare insert and lookup times of Util::HashTable with Util::Dictionary,
+    with string keys and with FourCC keys.
+    
+    (C) 2010 Radon Labs GmbH
+*/
+#include "benchmarkbase/benchmark.h"
+
+//------------------------------------------------------------------------------
+namespace Benchmarking
+{
+class HashTableBenchmark : public Benchmark
+{
+    __DeclareClass(HashTableBenchmark);
+public:
+    /// run the benchmark
+    virtual void Run(Timing::Timer& timer);
+};        
+
+} // namespace Benchmarking
+//------------------------------------------------------------------------------
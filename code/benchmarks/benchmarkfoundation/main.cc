@@ -11,14 +11,20 @@
 #include "createobjectsbyfourcc.h"
 #include "createobjectsbyclassname.h"
 #include "float4math.h"
+#include "hashtablebenchmark.h"
+#include "mathbatchbenchmark.h"
 #include "matrix44inverse.h"
 #include "matrix44multiply.h"
 #include "mempoolbenchmark.h"
+#include "messagequeuebenchmark.h"
+#include "slotmapbenchmark.h"
+#include "smallobjectbenchmark.h"
+#include "stringatombenchmark.h"
 
 using namespace Core;
 using namespace Benchmarking;
 
-void __cdecl
+int __cdecl
 main()
 {
     // create Nebula3 runtime
@@ -28,10 +34,16 @@ main()
 
     // setup and run benchmarks
     Ptr<BenchmarkRunner> runner = BenchmarkRunner::Create();    
-//    runner->AttachBenchmark(Matrix44Multiply::Create());
-//    runner->AttachBenchmark(Matrix44Inverse::Create());
-//    runner->AttachBenchmark(Float4Math::Create());
+    runner->AttachBenchmark(Matrix44Multiply::Create());
+    runner->AttachBenchmark(Matrix44Inverse::Create());
+    runner->AttachBenchmark(Float4Math::Create());
+    runner->AttachBenchmark(MathBatchBenchmark::Create());
     runner->AttachBenchmark(MemPoolBenchmark::Create());
+    runner->AttachBenchmark(SmallObjectBenchmark::Create());
+    runner->AttachBenchmark(SlotMapBenchmark::Create());
+    runner->AttachBenchmark(HashTableBenchmark::Create());
+    runner->AttachBenchmark(MessageQueueBenchmark::Create());
+    runner->AttachBenchmark(StringAtomBenchmark::Create());
     runner->AttachBenchmark(CreateObjects::Create());
     runner->AttachBenchmark(CreateObjectsByFourCC::Create());
     runner->AttachBenchmark(CreateObjectsByClassName::Create());
@@ -42,4 +54,5 @@ main()
     coreServer->Close();
     coreServer = 0;
     SysFunc::Exit(0);
+    return 0;
 }
@@ -0,0 +1,224 @@
+//------------------------------------------------------------------------------
+//  mathbatchbenchmark.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "mathbatchbenchmark.h"
+#include "math/batch.h"
+
+namespace Benchmarking
+{
+__ImplementClass(Benchmarking::MathBatchBenchmark, 'MBBM', Benchmarking::Benchmark);
+
+using namespace Timing;
+using namespace Math;
+
+//------------------------------------------------------------------------------
+/**
+    Runs each kernel over 10000 values (a typical number of transform
+    nodes or visibility boxes in a level), 100 times per measurement.
+*/
+void
+MathBatchBenchmark::Run(Timer& timer)
+{
+    timer.Start();
+
+    const SizeT NumValues = 10000;
+    const SizeT NumIterations = 100;
+    matrix44* m0 = n_new_array(matrix44, NumValues);
+    matrix44* m1 = n_new_array(matrix44, NumValues);
+    matrix44* outMatrices = n_new_array(matrix44, NumValues);
+    float4* points = n_new_array(float4, NumValues);
+    float4* outPoints = n_new_array(float4, NumValues);
+    bbox* boxes = n_new_array(bbox, NumValues);
+    bbox* outBoxes = n_new_array(bbox, NumValues);
+    ClipStatus::Type* outStatus = n_new_array(ClipStatus::Type, NumValues);
+    quaternion* q0 = n_new_array(quaternion, NumValues);
+    quaternion* q1 = n_new_array(quaternion, NumValues);
+    quaternion* outQuaternions = n_new_array(quaternion, NumValues);
+    IndexT i;
+    for (i = 0; i < NumValues; i++)
+    {
+        q0[i] = quaternion::rotationyawpitchroll(n_rand(-N_PI, N_PI), n_rand(-N_PI, N_PI), n_rand(-N_PI, N_PI));
+        q1[i] = quaternion::rotationyawpitchroll(n_rand(-N_PI, N_PI), n_rand(-N_PI, N_PI), n_rand(-N_PI, N_PI));
+        m0[i] = matrix44::rotationquaternion(q0[i]);
+        m0[i].setrow3(float4(n_rand(-100.0f, 100.0f), n_rand(-100.0f, 100.0f), n_rand(-100.0f, 100.0f), 1.0f));
+        m1[i] = matrix44::rotationquaternion(q1[i]);
+        points[i].set(n_rand(-1.0f, 1.0f), n_rand(-1.0f, 1.0f), n_rand(-1.0f, 1.0f), 1.0f);
+        boxes[i].set(point(n_rand(-100.0f, 100.0f), n_rand(-100.0f, 100.0f), n_rand(-100.0f, 100.0f)), 
+                     vector(n_rand(0.5f, 5.0f), n_rand(0.5f, 5.0f), n_rand(0.5f, 5.0f)));
+    }
+    matrix44 view = matrix44::lookatrh(point(0.0f, 0.0f, 0.0f), point(1.0f, 0.0f, 1.0f), vector(0.0f, 1.0f, 0.0f));
+    matrix44 viewProj = matrix44::multiply(view, matrix44::perspfovrh(n_deg2rad(60.0f), 1.33f, 0.1f, 200.0f));
+
+    Timer benchTimer;
+    IndexT run;
+    for (run = 0; run < 3; run++)
+    {
+        IndexT iter;
+
+        // multiply matrix pairs
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (iter = 0; iter < NumIterations; iter++)
+        {
+            for (i = 0; i < NumValues; i++)
+            {
+                outMatrices[i] = matrix44::multiply(m0[i], m1[i]);
+            }
+        }
+        benchTimer.Stop();
+        n_printf("Run %d: matrix44::multiply() %d matrices: %f\n", run, NumValues, benchTimer.GetTime());
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (iter = 0; iter < NumIterations; iter++)
+        {
+            Batch::MultiplyMatrices(m0, m1, outMatrices, NumValues);
+        }
+        benchTimer.Stop();
+        n_printf("Run %d: Batch::MultiplyMatrices() %d matrices: %f\n", run, NumValues, benchTimer.GetTime());
+
+        // multiply by the same matrix
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (iter = 0; iter < NumIterations; iter++)
+        {
+            for (i = 0; i < NumValues; i++)
+            {
+                outMatrices[i] = matrix44::multiply(m0[i], viewProj);
+            }
+        }
+        benchTimer.Stop();
+        n_printf("Run %d: matrix44::multiply() %d matrices by one matrix: %f\n", run, NumValues, benchTimer.GetTime());
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (iter = 0; iter < NumIterations; iter++)
+        {
+            Batch::MultiplyMatrices(m0, viewProj, outMatrices, NumValues);
+        }
+        benchTimer.Stop();
+        n_printf("Run %d: Batch::MultiplyMatrices() %d matrices by one matrix: %f\n", run, NumValues, benchTimer.GetTime());
+
+        // transform points
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (iter = 0; iter < NumIterations; iter++)
+        {
+            for (i = 0; i < NumValues; i++)
+            {
+                outPoints[i] = matrix44::transform(points[i], m0[0]);
+            }
+        }
+        benchTimer.Stop();
+        n_printf("Run %d: matrix44::transform() %d points: %f\n", run, NumValues, benchTimer.GetTime());
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (iter = 0; iter < NumIterations; iter++)
+        {
+            Batch::TransformPoints(m0[0], points, outPoints, NumValues);
+        }
+        benchTimer.Stop();
+        n_printf("Run %d: Batch::TransformPoints() %d points: %f\n", run, NumValues, benchTimer.GetTime());
+
+        // transform bounding boxes
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (iter = 0; iter < NumIterations; iter++)
+        {
+            for (i = 0; i < NumValues; i++)
+            {
+                outBoxes[i] = boxes[i];
+                outBoxes[i].transform(m0[i]);
+            }
+        }
+        benchTimer.Stop();
+        n_printf("Run %d: bbox::transform() %d boxes: %f\n", run, NumValues, benchTimer.GetTime());
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (iter = 0; iter < NumIterations; iter++)
+        {
+            Batch::TransformBoxes(boxes, m0, outBoxes, NumValues);
+        }
+        benchTimer.Stop();
+        n_printf("Run %d: Batch::TransformBoxes() %d boxes: %f\n", run, NumValues, benchTimer.GetTime());
+
+        // clip bounding boxes
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (iter = 0; iter < NumIterations; iter++)
+        {
+            for (i = 0; i < NumValues; i++)
+            {
+                outStatus[i] = boxes[i].clipstatus(viewProj);
+            }
+        }
+        benchTimer.Stop();
+        n_printf("Run %d: bbox::clipstatus() %d boxes: %f\n", run, NumValues, benchTimer.GetTime());
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (iter = 0; iter < NumIterations; iter++)
+        {
+            Batch::ClipBoxes(viewProj, boxes, outStatus, NumValues);
+        }
+        benchTimer.Stop();
+        n_printf("Run %d: Batch::ClipBoxes() %d boxes: %f\n", run, NumValues, benchTimer.GetTime());
+
+        // slerp quaternions
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (iter = 0; iter < NumIterations; iter++)
+        {
+            for (i = 0; i < NumValues; i++)
+            {
+                outQuaternions[i] = quaternion::slerp(q0[i], q1[i], 0.3f);
+            }
+        }
+        benchTimer.Stop();
+        n_printf("Run %d: quaternion::slerp() %d quaternions: %f\n", run, NumValues, benchTimer.GetTime());
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (iter = 0; iter < NumIterations; iter++)
+        {
+            Batch::SlerpQuaternions(q0, q1, 0.3f, outQuaternions, NumValues);
+        }
+        benchTimer.Stop();
+        n_printf("Run %d: Batch::SlerpQuaternions() %d quaternions: %f\n", run, NumValues, benchTimer.GetTime());
+
+        // normalize quaternions
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (iter = 0; iter < NumIterations; iter++)
+        {
+            for (i = 0; i < NumValues; i++)
+            {
+                outQuaternions[i] = quaternion::normalize(q0[i]);
+            }
+        }
+        benchTimer.Stop();
+        n_printf("Run %d: quaternion::normalize() %d quaternions: %f\n", run, NumValues, benchTimer.GetTime());
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (iter = 0; iter < NumIterations; iter++)
+        {
+            Batch::NormalizeQuaternions(q0, outQuaternions, NumValues);
+        }
+        benchTimer.Stop();
+        n_printf("Run %d: Batch::NormalizeQuaternions() %d quaternions: %f\n", run, NumValues, benchTimer.GetTime());
+    }
+
+    n_delete_array(m0);
+    n_delete_array(m1);
+    n_delete_array(outMatrices);
+    n_delete_array(points);
+    n_delete_array(outPoints);
+    n_delete_array(boxes);
+    n_delete_array(outBoxes);
+    n_delete_array(outStatus);
+    n_delete_array(q0);
+    n_delete_array(q1);
+    n_delete_array(outQuaternions);
+
+    timer.Stop();
+}
+
+} // namespace Benchmarking
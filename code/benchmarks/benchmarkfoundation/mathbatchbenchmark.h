@@ -0,0 +1,28 @@
+#pragma once
+#ifndef BENCHMARKING_MATHBATCHBENCHMARK_H
+#define BENCHMARKING_MATHBATCHBENCHMARK_H
+//------------------------------------------------------------------------------
+/**
+    @class Benchmarking::MathBatchBenchmark
+    
+    Compares the throughput of the Math::Batch stream kernels with
+    calling the per-value math functions in a loop.
+    
+    (C) 2010 Radon Labs GmbH
+*/
+#include "benchmarkbase/benchmark.h"
+
+//------------------------------------------------------------------------------
+namespace Benchmarking
+{
+class MathBatchBenchmark : public Benchmark
+{
+    __DeclareClass(MathBatchBenchmark);
+public:
+    /// run the benchmark
+    virtual void Run(Timing::Timer& timer);
+};
+
+} // namespace Benchmarking
+//------------------------------------------------------------------------------
+#endif
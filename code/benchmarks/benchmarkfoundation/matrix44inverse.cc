@@ -4,6 +4,7 @@
 //------------------------------------------------------------------------------
 #include "stdneb.h"
 #include "matrix44inverse.h"
+#include "math/sse/sse_ops.h"
 
 namespace Benchmarking
 {
@@ -12,6 +13,41 @@ __ImplementClass(Benchmarking::Matrix44Inverse, 'M4IN', Benchmarking::Benchmark)
 using namespace Timing;
 using namespace Math;
 
+//------------------------------------------------------------------------------
+/**
+    Defines a function which inverts the matrices directly with the
+    primitives of one primitive set of the portable math backend
+    (ScalarOps, SSE41Ops or AVX2Ops) and prints the time.
+*/
+#define __Matrix44InverseOps(OPS) \
+static void \
+OPS##Inverse(IndexT run, const matrix44* m0, matrix44* res, SizeT num) \
+{ \
+    const OPS::mat44* a = (const OPS::mat44*) m0; \
+    OPS::mat44* r = (OPS::mat44*) res; \
+    Timer benchTimer; \
+    benchTimer.Start(); \
+    IndexT i; \
+    for (i = 0; i < 10; i++) \
+    { \
+        IndexT j; \
+        for (j = 0; j < num; j++) \
+        { \
+            r[j] = OPS::inverse(a[j]); \
+        } \
+    } \
+    benchTimer.Stop(); \
+    n_printf("Run %d: " #OPS " invert %d matrices: %f\n", run, 10 * num, benchTimer.GetTime()); \
+}
+
+__Matrix44InverseOps(ScalarOps);
+#if NEBULA3_MATH_HAS_SSE41
+__Matrix44InverseOps(SSE41Ops);
+#endif
+#if NEBULA3_MATH_HAS_AVX2
+__Matrix44InverseOps(AVX2Ops);
+#endif
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -42,6 +78,21 @@ Matrix44Inverse::Run(Timer& timer)
         }
     }
     timer.Stop();
+
+    // compare the primitive sets against each other
+    IndexT run;
+    for (run = 0; run < 3; run++)
+    {
+        ScalarOpsInverse(run, m0, res, num);
+        #if NEBULA3_MATH_HAS_SSE41
+        SSE41OpsInverse(run, m0, res, num);
+        #endif
+        #if NEBULA3_MATH_HAS_AVX2
+        AVX2OpsInverse(run, m0, res, num);
+        #endif
+    }
+    n_delete_array(m0);
+    n_delete_array(res);
 }
 
 } // namespace Math
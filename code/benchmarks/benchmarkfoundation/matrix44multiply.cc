@@ -4,6 +4,7 @@
 //------------------------------------------------------------------------------
 #include "stdneb.h"
 #include "matrix44multiply.h"
+#include "math/sse/sse_ops.h"
 
 namespace Benchmarking
 {
@@ -12,6 +13,47 @@ __ImplementClass(Benchmarking::Matrix44Multiply, 'M4ML', Benchmarking::Benchmark
 using namespace Timing;
 using namespace Math;
 
+//------------------------------------------------------------------------------
+/**
+    Defines a function which runs the multiply chain of the benchmark
+    directly on the primitives of one primitive set of the portable math
+    backend (ScalarOps, SSE41Ops or AVX2Ops) and prints the time.
+*/
+#define __Matrix44MultiplyOps(OPS) \
+static void \
+OPS##Multiply(IndexT run, const matrix44* m0, const matrix44* m1, matrix44* res, SizeT num) \
+{ \
+    const OPS::mat44* a = (const OPS::mat44*) m0; \
+    const OPS::mat44* b = (const OPS::mat44*) m1; \
+    OPS::mat44* r = (OPS::mat44*) res; \
+    Timer benchTimer; \
+    benchTimer.Start(); \
+    IndexT i; \
+    for (i = 0; i < 10; i++) \
+    { \
+        IndexT j; \
+        for (j = 0; j < num; j++) \
+        { \
+            OPS::mat44 tmp0 = OPS::multiply(a[j], b[j]); \
+            OPS::mat44 tmp1 = OPS::multiply(b[j], a[j]); \
+            OPS::mat44 tmp2 = OPS::multiply(tmp0, tmp1); \
+            tmp0 = OPS::multiply(tmp1, tmp2); \
+            tmp1 = OPS::multiply(tmp0, tmp2); \
+            r[j] = OPS::multiply(tmp0, tmp1); \
+        } \
+    } \
+    benchTimer.Stop(); \
+    n_printf("Run %d: " #OPS " multiply %d matrices: %f\n", run, 60 * num, benchTimer.GetTime()); \
+}
+
+__Matrix44MultiplyOps(ScalarOps);
+#if NEBULA3_MATH_HAS_SSE41
+__Matrix44MultiplyOps(SSE41Ops);
+#endif
+#if NEBULA3_MATH_HAS_AVX2
+__Matrix44MultiplyOps(AVX2Ops);
+#endif
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -55,6 +97,22 @@ Matrix44Multiply::Run(Timer& timer)
         }
     }
     timer.Stop();
+
+    // compare the primitive sets against each other
+    IndexT run;
+    for (run = 0; run < 3; run++)
+    {
+        ScalarOpsMultiply(run, m0, m1, res, num);
+        #if NEBULA3_MATH_HAS_SSE41
+        SSE41OpsMultiply(run, m0, m1, res, num);
+        #endif
+        #if NEBULA3_MATH_HAS_AVX2
+        AVX2OpsMultiply(run, m0, m1, res, num);
+        #endif
+    }
+    n_delete_array(m0);
+    n_delete_array(m1);
+    n_delete_array(res);
 }
 
 } // namespace Math
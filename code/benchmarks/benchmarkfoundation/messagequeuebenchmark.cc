@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------------
+//  messagequeuebenchmark.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "messagequeuebenchmark.h"
+#include "messaging/messagequeue.h"
+#include "threading/safequeue.h"
+#include "util/fixedarray.h"
+
+namespace Benchmarking
+{
+__ImplementClass(Benchmarking::MessageQueueBenchmark, 'MQBM', Benchmarking::Benchmark);
+
+using namespace Timing;
+using namespace Util;
+using namespace Messaging;
+using namespace Threading;
+
+//------------------------------------------------------------------------------
+/**
+    Sends 100000 messages in batches of 1000 (like a game frame sending
+    messages to the render thread), once with messages which are created
+    before and once including message creation.
+*/
+void
+MessageQueueBenchmark::Run(Timer& timer)
+{
+    timer.Start();
+
+    const SizeT NumMessages = 100000;
+    const SizeT BatchSize = 1000;
+    FixedArray<Ptr<Message> > messages(NumMessages);
+    IndexT i;
+    for (i = 0; i < NumMessages; i++)
+    {
+        messages[i] = Message::Create();
+    }
+
+    Timer benchTimer;
+    IndexT run;
+    for (run = 0; run < 3; run++)
+    {
+        IndexT batch;
+        Array<Ptr<Message> > msgArray;
+
+        // safe queue with existing messages
+        SafeQueue<Ptr<Message> > safeQueue;
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (batch = 0; batch < NumMessages; batch += BatchSize)
+        {
+            for (i = batch; i < batch + BatchSize; i++)
+            {
+                safeQueue.Enqueue(messages[i]);
+            }
+            safeQueue.DequeueAll(msgArray);
+        }
+        benchTimer.Stop();
+        n_printf("Run %d: SafeQueue send %d messages: %f\n", run, NumMessages, benchTimer.GetTime());
+
+        // message queue with existing messages
+        MessageQueue msgQueue;
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (batch = 0; batch < NumMessages; batch += BatchSize)
+        {
+            for (i = batch; i < batch + BatchSize; i++)
+            {
+                msgQueue.Enqueue(messages[i]);
+            }
+            msgQueue.DequeueAll(msgArray);
+        }
+        benchTimer.Stop();
+        n_printf("Run %d: MessageQueue send %d messages: %f\n", run, NumMessages, benchTimer.GetTime());
+
+        // safe queue with message creation
+        msgArray.Clear();
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (batch = 0; batch < NumMessages; batch += BatchSize)
+        {
+            for (i = batch; i < batch + BatchSize; i++)
+            {
+                safeQueue.Enqueue(Message::Create());
+            }
+            safeQueue.DequeueAll(msgArray);
+        }
+        msgArray.Clear();
+        benchTimer.Stop();
+        n_printf("Run %d: SafeQueue create and send %d messages: %f\n", run, NumMessages, benchTimer.GetTime());
+
+        // message queue with message creation
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (batch = 0; batch < NumMessages; batch += BatchSize)
+        {
+            for (i = batch; i < batch + BatchSize; i++)
+            {
+                msgQueue.Enqueue(Message::Create());
+            }
+            msgQueue.DequeueAll(msgArray);
+        }
+        msgArray.Clear();
+        benchTimer.Stop();
+        n_printf("Run %d: MessageQueue create and send %d messages: %f\n", run, NumMessages, benchTimer.GetTime());
+    }
+
+    timer.Stop();
+}
+
+} // namespace Benchmarking
@@ -0,0 +1,25 @@
+#pragma once
+//------------------------------------------------------------------------------
+/** 
+    @class Benchmarking::MessageQueueBenchmark
+    
+    Compare the message throughput of the lock-free Messaging::MessageQueue
+    with the Threading::SafeQueue it replaced in the handler threads.
+    
+    (C) 2010 Radon Labs GmbH
+*/
+#include "benchmarkbase/benchmark.h"
+
+//------------------------------------------------------------------------------
+namespace Benchmarking
+{
+class MessageQueueBenchmark : public Benchmark
+{
+    __DeclareClass(MessageQueueBenchmark);
+public:
+    /// run the benchmark
+    virtual void Run(Timing::Timer& timer);
+};        
+
+} // namespace Benchmarking
+//------------------------------------------------------------------------------
@@ -0,0 +1,105 @@
+//------------------------------------------------------------------------------
+//  slotmapbenchmark.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "slotmapbenchmark.h"
+#include "util/dictionary.h"
+#include "util/fixedarray.h"
+#include "util/slotmap.h"
+
+namespace Benchmarking
+{
+__ImplementClass(Benchmarking::SlotMapBenchmark, 'SMBM', Benchmarking::Benchmark);
+
+using namespace Timing;
+using namespace Util;
+using namespace Core;
+
+//------------------------------------------------------------------------------
+/**
+    Registers 50000 objects, looks each of them up and unregisters them
+    in a different order than they have been registered, like graphics
+    entities which are attached to and removed from a stage.
+*/
+void
+SlotMapBenchmark::Run(Timer& timer)
+{
+    timer.Start();
+
+    const SizeT NumObjects = 50000;
+    FixedArray<Ptr<RefCounted> > objects(NumObjects);
+    FixedArray<SlotMap<Ptr<RefCounted> >::Handle> handles(NumObjects);
+    IndexT i;
+    for (i = 0; i < NumObjects; i++)
+    {
+        objects[i] = RefCounted::Create();
+    }
+
+    Timer benchTimer;
+    IndexT run;
+    for (run = 0; run < 3; run++)
+    {
+        // dictionary keyed by object pointer
+        Dictionary<Ptr<RefCounted>, Ptr<RefCounted> > dict;
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (i = 0; i < NumObjects; i++)
+        {
+            dict.Add(objects[i], objects[i]);
+        }
+        benchTimer.Stop();
+        n_printf("Run %d: Dictionary register %d objects: %f\n", run, NumObjects, benchTimer.GetTime());
+
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (i = 0; i < NumObjects; i++)
+        {
+            n_assert(dict[objects[i]] == objects[i]);
+        }
+        benchTimer.Stop();
+        n_printf("Run %d: Dictionary lookup %d objects: %f\n", run, NumObjects, benchTimer.GetTime());
+
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (i = 0; i < NumObjects; i++)
+        {
+            dict.Erase(objects[(i * 7919) % NumObjects]);
+        }
+        benchTimer.Stop();
+        n_printf("Run %d: Dictionary unregister %d objects: %f\n", run, NumObjects, benchTimer.GetTime());
+
+        // slot map with handles stored per object
+        SlotMap<Ptr<RefCounted> > slotMap;
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (i = 0; i < NumObjects; i++)
+        {
+            handles[i] = slotMap.Add(objects[i]);
+        }
+        benchTimer.Stop();
+        n_printf("Run %d: SlotMap register %d objects: %f\n", run, NumObjects, benchTimer.GetTime());
+
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (i = 0; i < NumObjects; i++)
+        {
+            n_assert(slotMap[handles[i]] == objects[i]);
+        }
+        benchTimer.Stop();
+        n_printf("Run %d: SlotMap lookup %d objects: %f\n", run, NumObjects, benchTimer.GetTime());
+
+        benchTimer.Reset();
+        benchTimer.Start();
+        for (i = 0; i < NumObjects; i++)
+        {
+            slotMap.Erase(handles[(i * 7919) % NumObjects]);
+        }
+        benchTimer.Stop();
+        n_printf("Run %d: SlotMap unregister %d objects: %f\n", run, NumObjects, benchTimer.GetTime());
+    }
+
+    timer.Stop();
+}
+
+} // namespace Benchmarking
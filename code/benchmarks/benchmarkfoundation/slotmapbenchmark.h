@@ -0,0 +1,25 @@
+#pragma once
+//------------------------------------------------------------------------------
+/** 
+    @class Benchmarking::SlotMapBenchmark
+    
+    Compare register/unregister cycles of a Util::Dictionary keyed by
+    object pointers with handle based Util::SlotMap access.
+    
+    (C) 2010 Radon Labs GmbH
+*/
+#include "benchmarkbase/benchmark.h"
+
+//------------------------------------------------------------------------------
+namespace Benchmarking
+{
+class SlotMapBenchmark : public Benchmark
+{
+    __DeclareClass(SlotMapBenchmark);
+public:
+    /// run the benchmark
+    virtual void Run(Timing::Timer& timer);
+};        
+
+} // namespace Benchmarking
+//------------------------------------------------------------------------------
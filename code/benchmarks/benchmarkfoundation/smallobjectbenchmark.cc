@@ -0,0 +1,157 @@
+//------------------------------------------------------------------------------
+//  smallobjectbenchmark.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "smallobjectbenchmark.h"
+#include "memory/smallobjectallocator.h"
+
+namespace Benchmarking
+{
+__ImplementClass(Benchmarking::SmallObjectBenchmark, 'SOBM', Benchmarking::Benchmark);
+__ImplementClass(Benchmarking::SmallObjectBenchmark::WorkerThread, 'SOBT', Threading::Thread);
+
+using namespace Timing;
+using namespace Memory;
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+SmallObjectBenchmark::Run(Timer& timer)
+{
+    timer.Start();
+
+    const SizeT NumThreads = 4;
+    const SizeT NumBlocksPerThread = 250000;
+    const SizeT NumBlocks = NumThreads * NumBlocksPerThread;
+    void** ptrs = (void**) Memory::Alloc(Memory::DefaultHeap, NumBlocks * sizeof(void*));
+
+    MemoryPool pool;
+    pool.Setup(Memory::DefaultHeap, BlockSize, NumBlocks);
+
+    IndexT run;
+    for (run = 0; run < 3; run++)
+    {
+        // all threads allocate and free their own blocks
+        Time time = this->RunWorkers(AllocFree, &pool, ptrs, NumThreads, NumBlocksPerThread);
+        n_printf("Run %d: %d threads alloc/free %d memory pool blocks: %f\n", run, NumThreads, NumBlocks, time);
+        time = this->RunWorkers(AllocFree, 0, ptrs, NumThreads, NumBlocksPerThread);
+        n_printf("Run %d: %d threads alloc/free %d blocks: %f\n", run, NumThreads, NumBlocks, time);
+
+        // blocks are allocated by one thread and freed by another thread,
+        // like messages which are sent to a handler thread
+        time = this->RunWorkers(AllocOnly, &pool, ptrs, 1, NumBlocks);
+        time += this->RunWorkers(FreeOnly, &pool, ptrs, 1, NumBlocks);
+        n_printf("Run %d: cross-thread alloc/free %d memory pool blocks: %f\n", run, NumBlocks, time);
+        time = this->RunWorkers(AllocOnly, 0, ptrs, 1, NumBlocks);
+        time += this->RunWorkers(FreeOnly, 0, ptrs, 1, NumBlocks);
+        n_printf("Run %d: cross-thread alloc/free %d blocks: %f\n", run, NumBlocks, time);
+    }
+
+    #if NEBULA3_USE_SMALLOBJECT_ALLOCATOR
+    n_printf("SmallObjectAllocator: %d chunks committed\n", SmallObjectAllocator::GetNumChunks());
+    #endif
+
+    Memory::Free(Memory::DefaultHeap, ptrs);
+    timer.Stop();
+}
+
+//------------------------------------------------------------------------------
+/**
+    Start the worker threads, each thread works on its own range of
+    the pointer array.
+*/
+Time
+SmallObjectBenchmark::RunWorkers(Mode mode, MemoryPool* pool, void** ptrs, SizeT numThreads, SizeT numBlocksPerThread)
+{
+    Util::Array<Ptr<WorkerThread> > threads;
+    IndexT i;
+    for (i = 0; i < numThreads; i++)
+    {
+        Ptr<WorkerThread> thread = WorkerThread::Create();
+        thread->SetName("SmallObjectBenchmark Worker Thread");
+        thread->Setup(mode, pool, ptrs + i * numBlocksPerThread, numBlocksPerThread);
+        threads.Append(thread);
+    }
+
+    Timer workTimer;
+    workTimer.Start();
+    for (i = 0; i < numThreads; i++)
+    {
+        threads[i]->Start();
+    }
+    for (i = 0; i < numThreads; i++)
+    {
+        threads[i]->WaitDone();
+    }
+    workTimer.Stop();
+    return workTimer.GetTime();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+SmallObjectBenchmark::WorkerThread::WorkerThread() :
+    mode(AllocFree),
+    pool(0),
+    ptrs(0),
+    numBlocks(0)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+SmallObjectBenchmark::WorkerThread::Setup(Mode m, MemoryPool* p, void** ptrArray, SizeT num)
+{
+    n_assert(!this->IsRunning());
+    this->mode = m;
+    this->pool = p;
+    this->ptrs = ptrArray;
+    this->numBlocks = num;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+SmallObjectBenchmark::WorkerThread::WaitDone()
+{
+    this->doneEvent.Wait();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+SmallObjectBenchmark::WorkerThread::DoWork()
+{
+    IndexT i;
+    if (FreeOnly != this->mode)
+    {
+        for (i = 0; i < this->numBlocks; i++)
+        {
+            this->ptrs[i] = (0 != this->pool) ? this->pool->Alloc() : Memory::Alloc(Memory::DefaultHeap, BlockSize);
+        }
+    }
+    if (AllocOnly != this->mode)
+    {
+        for (i = 0; i < this->numBlocks; i++)
+        {
+            if (0 != this->pool)
+            {
+                this->pool->Free(this->ptrs[i]);
+            }
+            else
+            {
+                Memory::Free(Memory::DefaultHeap, this->ptrs[i]);
+            }
+        }
+    }
+    this->doneEvent.Signal();
+}
+
+} // namespace Benchmarking
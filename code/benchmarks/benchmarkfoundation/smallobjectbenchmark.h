@@ -0,0 +1,67 @@
+#pragma once
+//------------------------------------------------------------------------------
+/** 
+    @class Benchmarking::SmallObjectBenchmark
+    
+    Compares small block allocations through Memory::Alloc() (which uses
+    the Memory::SmallObjectAllocator) with a shared MemoryPool, from
+    several threads at once, and with blocks which are freed by another
+    thread than the one which allocated them. See also MemPoolBenchmark
+    and CreateObjects for the single-threaded case.
+    
+    (C) 2010 Radon Labs GmbH
+*/
+#include "benchmarkbase/benchmark.h"
+#include "threading/thread.h"
+#include "threading/event.h"
+#include "memory/memorypool.h"
+
+//------------------------------------------------------------------------------
+namespace Benchmarking
+{
+class SmallObjectBenchmark : public Benchmark
+{
+    __DeclareClass(SmallObjectBenchmark);
+public:
+    /// run the benchmark
+    virtual void Run(Timing::Timer& timer);
+
+private:
+    /// what a worker thread does with its blocks
+    enum Mode
+    {
+        AllocFree,      // allocate and free the blocks
+        AllocOnly,      // only allocate the blocks
+        FreeOnly,       // only free the blocks
+    };
+
+    /// a worker thread which allocates or frees blocks
+    class WorkerThread : public Threading::Thread
+    {
+        __DeclareClass(WorkerThread);
+    public:
+        /// constructor
+        WorkerThread();
+        /// setup the work, pool may be 0 to use Memory::Alloc()
+        void Setup(Mode mode, Memory::MemoryPool* pool, void** ptrs, SizeT numBlocks);
+        /// wait until the work is done
+        void WaitDone();
+    private:
+        /// this method runs in the thread context
+        virtual void DoWork();
+
+        Mode mode;
+        Memory::MemoryPool* pool;
+        void** ptrs;
+        SizeT numBlocks;
+        Threading::Event doneEvent;
+    };
+
+    /// run worker threads and return the elapsed time
+    Timing::Time RunWorkers(Mode mode, Memory::MemoryPool* pool, void** ptrs, SizeT numThreads, SizeT numBlocksPerThread);
+
+    static const SizeT BlockSize = 48;
+};        
+
+} // namespace Benchmarking
+//------------------------------------------------------------------------------
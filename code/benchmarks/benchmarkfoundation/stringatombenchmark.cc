@@ -0,0 +1,130 @@
+//------------------------------------------------------------------------------
+//  stringatombenchmark.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "stringatombenchmark.h"
+#include "threading/thread.h"
+#include "threading/event.h"
+#include "util/stringatom.h"
+
+namespace Benchmarking
+{
+__ImplementClass(Benchmarking::StringAtomBenchmark, 'SABM', Benchmarking::Benchmark);
+
+using namespace Timing;
+using namespace Util;
+using namespace Threading;
+
+//------------------------------------------------------------------------------
+/**
+    Worker thread which creates string atoms from an array of strings.
+*/
+class StringAtomBenchmarkThread : public Thread
+{
+    __DeclareClass(StringAtomBenchmarkThread);
+public:
+    /// this method runs in the thread context
+    virtual void DoWork();
+
+    Array<String> strings;
+    Event finishedEvent;
+};
+__ImplementClass(Benchmarking::StringAtomBenchmarkThread, 'SABT', Threading::Thread);
+
+//------------------------------------------------------------------------------
+/**
+    Every string is turned into an atom twice, the first time the string
+    is new (or has just been added by another thread), the second time
+    the string is already in the atom table.
+*/
+void
+StringAtomBenchmarkThread::DoWork()
+{
+    IndexT pass;
+    for (pass = 0; pass < 2; pass++)
+    {
+        IndexT i;
+        for (i = 0; i < this->strings.Size(); i++)
+        {
+            StringAtom atom(this->strings[i].AsCharPtr());
+            n_assert(atom.IsValid());
+        }
+    }
+    this->finishedEvent.Signal();
+
+    // wait until the benchmark stops the thread
+    while (!this->ThreadStopRequested())
+    {
+        n_sleep(0.001);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Runs 1, 2 and 4 threads, each creating 20000 atoms. Half of the strings
+    are shared by all threads, the other half is only used by one thread.
+    With perfect scaling, the time stays the same for all thread counts.
+*/
+void
+StringAtomBenchmark::Run(Timer& timer)
+{
+    timer.Start();
+
+    const SizeT NumAtoms = 20000;
+    Timer benchTimer;
+    IndexT run;
+    for (run = 0; run < 3; run++)
+    {
+        SizeT numThreads;
+        for (numThreads = 1; numThreads <= 4; numThreads *= 2)
+        {
+            // setup worker threads with strings which are not atoms yet
+            Array<Ptr<StringAtomBenchmarkThread> > threads;
+            IndexT threadIndex;
+            for (threadIndex = 0; threadIndex < numThreads; threadIndex++)
+            {
+                Ptr<StringAtomBenchmarkThread> thread = StringAtomBenchmarkThread::Create();
+                thread->SetName("StringAtomBenchmarkThread");
+                thread->strings.Reserve(NumAtoms);
+                IndexT i;
+                for (i = 0; i < NumAtoms; i++)
+                {
+                    String str;
+                    if (0 == (i & 1))
+                    {
+                        str.Format("stringatombenchmark/run%d/threads%d/shared/node%d", run, numThreads, i);
+                    }
+                    else
+                    {
+                        str.Format("stringatombenchmark/run%d/threads%d/thread%d/node%d", run, numThreads, threadIndex, i);
+                    }
+                    thread->strings.Append(str);
+                }
+                threads.Append(thread);
+            }
+
+            benchTimer.Reset();
+            benchTimer.Start();
+            for (threadIndex = 0; threadIndex < numThreads; threadIndex++)
+            {
+                threads[threadIndex]->Start();
+            }
+            for (threadIndex = 0; threadIndex < numThreads; threadIndex++)
+            {
+                threads[threadIndex]->finishedEvent.Wait();
+            }
+            benchTimer.Stop();
+            n_printf("Run %d: %d threads create %d atoms each: %f\n", run, numThreads, NumAtoms * 2, benchTimer.GetTime());
+
+            for (threadIndex = 0; threadIndex < numThreads; threadIndex++)
+            {
+                threads[threadIndex]->Stop();
+            }
+        }
+    }
+
+    timer.Stop();
+}
+
+} // namespace Benchmarking
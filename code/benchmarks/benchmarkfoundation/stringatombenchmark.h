@@ -0,0 +1,25 @@
+#pragma once
+//------------------------------------------------------------------------------
+/** 
+    @class Benchmarking::StringAtomBenchmark
+    
+    Measures how StringAtom creation scales with the number of threads
+    which create atoms at the same time (like several loader threads).
+    
+    (C) 2010 Radon Labs GmbH
+*/
+#include "benchmarkbase/benchmark.h"
+
+//------------------------------------------------------------------------------
+namespace Benchmarking
+{
+class StringAtomBenchmark : public Benchmark
+{
+    __DeclareClass(StringAtomBenchmark);
+public:
+    /// run the benchmark
+    virtual void Run(Timing::Timer& timer);
+};        
+
+} // namespace Benchmarking
+//------------------------------------------------------------------------------
@@ -30,6 +30,13 @@
 #define __PS3__ (1)
 #endif
 
+#ifdef __LINUX__
+#undef __LINUX__
+#endif
+#if (defined(__linux__) && !defined(__CELLOS_LV2__))
+#define __LINUX__ (1)
+#endif
+
 //------------------------------------------------------------------------------
 /**
     Nebula3 configuration.
@@ -63,6 +70,10 @@ static const int JobMaxSliceSize = 0x3FFF;
 #define NEBULA3_NATIVE_ARCHIVE_SUPPORT (0)
 #endif
 
+// use Nebula3 archives (.n3a, see IO::N3Archive) instead of zip archives
+// on platforms without native archive support
+#define NEBULA3_USE_N3ARCHIVES (0)
+
 // enable/disable Nebula3 memory stats
 #if NEBULA3_DEBUG
 #define NEBULA3_MEMORY_STATS (1)
@@ -80,6 +91,60 @@ static const int JobMaxSliceSize = 0x3FFF;
 #define NEBULA3_OBJECTS_USE_MEMORYPOOL (0)
 #endif
 
+// number of instances per message class which are recycled in a per-class
+// memory pool (see Messaging::Message), 0 disables message pooling
+#define NEBULA3_MESSAGE_POOL_SIZE (256)
+
+// enable/disable the thread-caching small block allocator for small
+// allocations from Memory::Alloc() (see Memory::SmallObjectAllocator)
+#if (__WIN32__ || __LINUX__)
+#define NEBULA3_USE_SMALLOBJECT_ALLOCATOR (1)
+#else
+#define NEBULA3_USE_SMALLOBJECT_ALLOCATOR (0)
+#endif
+
+// use SSE2 to probe 16 slots at once in Util::HashTable
+#if (__WIN32__ || __LINUX__)
+#define NEBULA3_HASHTABLE_USE_SSE2 (1)
+#else
+#define NEBULA3_HASHTABLE_USE_SSE2 (0)
+#endif
+
+// automatic hardware instancing of identical shape node instances in
+// Frame::FrameBatch, needs RenderDevice::DrawIndexedInstanced()
+#if __WIN32__
+#define NEBULA3_ENABLE_AUTO_INSTANCING (1)
+#else
+#define NEBULA3_ENABLE_AUTO_INSTANCING (0)
+#endif
+
+// Vector primitives of the portable math backend in math/sse, which is
+// used on platforms without XNAMath (Linux, OSX). By default the best
+// instruction set enabled in the compiler settings is used, define
+// NEBULA3_MATH_BACKEND to force the scalar reference implementation.
+#define NEBULA3_MATH_BACKEND_SCALAR (0)
+#define NEBULA3_MATH_BACKEND_SSE41 (1)
+#define NEBULA3_MATH_BACKEND_AVX2 (2)
+#if (defined(__SSE4_1__) || defined(__AVX__))
+#define NEBULA3_MATH_HAS_SSE41 (1)
+#else
+#define NEBULA3_MATH_HAS_SSE41 (0)
+#endif
+#if (defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER)))
+#define NEBULA3_MATH_HAS_AVX2 (1)
+#else
+#define NEBULA3_MATH_HAS_AVX2 (0)
+#endif
+#ifndef NEBULA3_MATH_BACKEND
+#if NEBULA3_MATH_HAS_AVX2
+#define NEBULA3_MATH_BACKEND NEBULA3_MATH_BACKEND_AVX2
+#elif NEBULA3_MATH_HAS_SSE41
+#define NEBULA3_MATH_BACKEND NEBULA3_MATH_BACKEND_SSE41
+#else
+#define NEBULA3_MATH_BACKEND NEBULA3_MATH_BACKEND_SCALAR
+#endif
+#endif
+
 // Enable/disable serial job system (ONLY SET FOR DEBUGGING!)
 // You'll also need to fix the foundation_*.epk file to use the jobs/serial source files
 // instead of jobs/tp!
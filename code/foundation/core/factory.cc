@@ -192,8 +192,10 @@ Factory::Create(const String& className) const
 {
     n_assert(className.IsValid());
     
-    // check if class exists, otherwise give a meaningful error
-    if (!this->ClassExists(className))
+    // lookup RTTI object of class through hash table, if class 
+    // doesn't exist give a meaningful error
+    IndexT index = this->nameTable.FindIndex(className);
+    if (InvalidIndex == index)
     {
         String errorMsg;
         errorMsg.Format("Factory::Create('%s'): unknown class name!", className.AsCharPtr());
@@ -201,8 +203,8 @@ Factory::Create(const String& className) const
         return 0;
     }
 
-    // lookup RTTI object of class through hash table and create new object
-    const Rtti* rtti = this->nameTable[className];
+    // create new object
+    const Rtti* rtti = this->nameTable.ValueAtIndex(index);
     n_assert(0 != rtti);
     RefCounted* newObject = rtti->Create();
     return newObject;
@@ -217,8 +219,10 @@ Factory::Create(const FourCC classFourCC) const
 {
     n_assert(classFourCC.IsValid());
 
-    // check if class exists, otherwise give meaningful error
-    if (!this->ClassExists(classFourCC))
+    // lookup RTTI object of class through hash table, if class
+    // doesn't exist give a meaningful error
+    IndexT index = this->fourccTable.FindIndex(classFourCC);
+    if (InvalidIndex == index)
     {
         String errorMsg;
         errorMsg.Format("Factory::Create('%s'): unknown class FourCC code!", classFourCC.AsString().AsCharPtr());
@@ -226,8 +230,8 @@ Factory::Create(const FourCC classFourCC) const
         return 0;
     }
 
-    // lookup RTTI object of class through hash table and create new object
-    const Rtti* rtti = this->fourccTable[classFourCC];
+    // create new object
+    const Rtti* rtti = this->fourccTable.ValueAtIndex(index);
     n_assert(0 != rtti);
     RefCounted* newObject = rtti->Create();
     return newObject;
@@ -58,7 +58,7 @@ private:
 
     static Factory* Singleton;
     Util::HashTable<Util::String, const Rtti*> nameTable;     // for fast lookup by class name
-    Util::Dictionary<Util::FourCC, const Rtti*> fourccTable;  // for fast lookup by fourcc code
+    Util::HashTable<Util::FourCC, const Rtti*> fourccTable;   // for fast lookup by fourcc code
 };
 
 } // namespace Foundation
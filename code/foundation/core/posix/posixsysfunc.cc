@@ -0,0 +1,177 @@
+//------------------------------------------------------------------------------
+//  posixsysfunc.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "core/posix/posixsysfunc.h"
+#include "core/refcounted.h"
+#include "util/blob.h"
+#include "threading/thread.h"
+#include "util/globalstringatomtable.h"
+#include "util/localstringatomtable.h"  
+#include "system/systeminfo.h"
+
+namespace Posix
+{
+using namespace Util;
+
+bool volatile SysFunc::SetupCalled = false;
+const Core::ExitHandler* SysFunc::ExitHandlers = 0;
+System::SystemInfo SysFunc::systemInfo;
+
+Util::GlobalStringAtomTable* globalStringAtomTable = 0;
+#if NEBULA3_ENABLE_THREADLOCAL_STRINGATOM_TABLES
+    Util::LocalStringAtomTable* localStringAtomTable = 0;
+#endif
+
+//------------------------------------------------------------------------------
+/**
+    This method must be called at application start before any threads
+    are spawned. It is used to setup static objects beforehand (i.e.
+    private heaps of various utility classes). Doing this eliminates
+    the need for fine-grained locking in the affected classes.
+*/
+void
+SysFunc::Setup()
+{
+    if (!SetupCalled)
+    {
+        SetupCalled = true;
+        Threading::Thread::SetMyThreadName("MainThread");
+        Memory::SetupHeaps();
+        Memory::Heap::Setup();
+        Blob::Setup();
+
+        globalStringAtomTable = n_new(Util::GlobalStringAtomTable);
+        #if NEBULA3_ENABLE_THREADLOCAL_STRINGATOM_TABLES
+            localStringAtomTable = n_new(Util::LocalStringAtomTable);
+        #endif    
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    This method is called by Application::Exit(), or otherwise must be
+    called right before the end of the programs main() function. The method
+    will properly shutdown the Nebula3 runtime environment, and report 
+    refcounting and memory leaks (debug builds only). This method will not
+    return.
+*/
+void
+SysFunc::Exit(int exitCode)
+{
+    // delete string atom tables
+    n_delete(globalStringAtomTable);
+    #if NEBULA3_ENABLE_THREADLOCAL_STRINGATOM_TABLES
+        n_delete(localStringAtomTable);
+    #endif
+
+    // first produce a RefCount leak report
+    #if NEBULA3_DEBUG
+    Core::RefCounted::DumpRefCountingLeaks();
+    #endif
+
+    // call exit handlers
+    const Core::ExitHandler* exitHandler = SysFunc::ExitHandlers;
+    while (0 != exitHandler)
+    {
+        exitHandler->OnExit();
+        exitHandler = exitHandler->Next();
+    }
+
+    // call static shutdown methods
+    Blob::Shutdown();
+
+    // shutdown global factory object
+    Core::Factory::Destroy();
+
+    // delete the memory pools
+    #if NEBULA3_OBJECTS_USE_MEMORYPOOL        
+    n_delete(Memory::ObjectPoolAllocator);
+    Memory::ObjectPoolAllocator = 0;
+    #endif
+
+    // report mem leaks
+    #if NEBULA3_MEMORY_ADVANCED_DEBUGGING
+    Memory::DumpMemoryLeaks();
+    #endif   
+
+    // finally terminate the process, this will NOT run static destructors,
+    // which would otherwise run after the heaps are gone
+    fflush(stdout);
+    fflush(stderr);
+    _exit(exitCode);
+}
+
+//------------------------------------------------------------------------------
+/**
+    This puts an error message to stderr and quits the program.
+*/
+void
+SysFunc::Error(const char* error)
+{
+    fprintf(stderr, "NEBULA3 SYSTEM ERROR: %s\n", error);
+    fflush(stderr);
+    abort();
+}
+
+//------------------------------------------------------------------------------
+/**
+    There are no message boxes on POSIX platforms, the message goes to 
+    stderr instead.
+*/
+void
+SysFunc::MessageBox(const char* msg)
+{
+    fprintf(stderr, "NEBULA3 MESSAGE: %s\n", msg);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Sleep for a specified amount of seconds, give up time slice.
+*/
+void
+SysFunc::Sleep(double sec)
+{
+    struct timespec ts;
+    ts.tv_sec = (time_t) sec;
+    ts.tv_nsec = (long) ((sec - double(ts.tv_sec)) * 1000000000.0);
+    while ((0 != nanosleep(&ts, &ts)) && (EINTR == errno));
+}
+
+//------------------------------------------------------------------------------
+/**
+    Put a message on the debug console.
+*/
+void
+SysFunc::DebugOut(const char* msg)
+{
+    fputs(msg, stderr);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Register a new exit handler. This method is called at startup time
+    from the constructor of static exit handler objects. This is the only
+    supported way to register exit handlers. The method will return
+    a pointer to the next exit handler in the forward linked list 
+    (or 0 if this is the first exit handler).
+*/
+const Core::ExitHandler*
+SysFunc::RegisterExitHandler(const Core::ExitHandler* exitHandler)
+{
+    const Core::ExitHandler* firstHandler = ExitHandlers;
+    ExitHandlers = exitHandler;
+    return firstHandler;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const System::SystemInfo*
+SysFunc::GetSystemInfo()
+{
+    return &SysFunc::systemInfo;
+}
+
+} // namespace Posix
@@ -0,0 +1,37 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @file core/posix/precompiled.h
+
+    Contains precompiled headers on POSIX platforms (Linux).
+
+    (C) 2010 Radon Labs GmbH
+*/
+
+// crt headers
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+
+// POSIX and Linux system headers
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+// C++ runtime
+#include <new>
+#include <algorithm>
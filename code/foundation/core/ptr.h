@@ -76,6 +76,23 @@ private:
     TYPE* ptr;
 };
 
+//------------------------------------------------------------------------------
+/**
+    A Ptr can be moved with a memcpy, which saves the AddRef()/Release()
+    pair when a container relocates its elements.
+*/
+namespace Core
+{
+template<class TYPE> struct TypeTraits<Ptr<TYPE> >
+{
+    enum
+    {
+        IsTrivial = false,
+        IsRelocatable = true
+    };
+};
+} // namespace Core
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -7,6 +7,7 @@
 #include "core/refcounted.h"
 #include "core/sysfunc.h"
 #include "memory/poolarrayallocator.h"
+#include "threading/interlocked.h"
 
 namespace Core
 {
@@ -30,6 +31,8 @@ Rtti::Construct(const char* className, FourCC fcc, Creator creatorFunc, const Rt
     this->fourCC = fcc;     // NOTE: may be 0
     this->creator = creatorFunc;
     this->instanceSize = instSize;
+    this->numPoolInstances = 0;
+    this->instancePool = 0;
 
     // register class with factory
     this->name = className;
@@ -168,6 +171,20 @@ Rtti::IsDerivedFrom(const Util::FourCC& otherClassFourCC) const
 void*
 Rtti::AllocInstanceMemory()
 {
+    if (this->numPoolInstances > 0)
+    {
+        Memory::MemoryPool* pool = this->instancePool;
+        if (0 == pool)
+        {
+            pool = this->SetupInstancePool();
+        }
+        void* ptr = pool->Alloc();
+        if (0 != ptr)
+        {
+            return ptr;
+        }
+        // pool exhausted, fall back to the object heap
+    }
     #if NEBULA3_OBJECTS_USE_MEMORYPOOL    
     void* ptr = Memory::ObjectPoolAllocator->Alloc(this->instanceSize);
     #else
@@ -182,6 +199,12 @@ Rtti::AllocInstanceMemory()
 void
 Rtti::FreeInstanceMemory(void* ptr)
 {
+    Memory::MemoryPool* pool = this->instancePool;
+    if ((0 != pool) && pool->IsPoolBlock(ptr))
+    {
+        pool->Free(ptr);
+        return;
+    }
     #if NEBULA3_OBJECTS_USE_MEMORYPOOL
     Memory::ObjectPoolAllocator->Free(ptr, this->instanceSize);
     #else
@@ -189,4 +212,41 @@ Rtti::FreeInstanceMemory(void* ptr)
     #endif
 }
 
+//------------------------------------------------------------------------------
+/**
+    Recycle the memory of up to numInstances objects of this class in a
+    memory pool instead of returning it to the heap, if more objects are
+    alive, the additional objects come from the heap. This is meant for
+    short-lived objects which are created at a high rate, like messages.
+    The pool itself is only created when the first object is allocated.
+    Must be called after the Rtti object has been constructed, returns
+    true so it can be used to initialize a static.
+*/
+bool
+Rtti::EnableInstancePool(SizeT numInstances)
+{
+    n_assert(0 == this->instancePool);
+    this->numPoolInstances = numInstances;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+    If two threads create the pool at the same time, the loser discards
+    its pool again.
+*/
+Memory::MemoryPool*
+Rtti::SetupInstancePool()
+{
+    Memory::MemoryPool* pool = n_new(Memory::MemoryPool);
+    pool->Setup(Memory::ObjectHeap, this->instanceSize, this->numPoolInstances);
+    void* prev = Threading::Interlocked::CompareExchangePointer((void* volatile*)&this->instancePool, pool, 0);
+    if (0 != prev)
+    {
+        n_delete(pool);
+        pool = (Memory::MemoryPool*) prev;
+    }
+    return pool;
+}
+
 } // namespace Core
@@ -16,6 +16,7 @@
 #include "core/sysfunc.h"
 #include "util/string.h"
 #include "util/fourcc.h"
+#include "memory/memorypool.h"
 
 //------------------------------------------------------------------------------
 namespace Core
@@ -55,8 +56,12 @@ public:
     void* AllocInstanceMemory();
     /// free instance memory block (called by class delete operator)
     void FreeInstanceMemory(void* ptr);
+    /// recycle instance memory in a per-class memory pool, returns true
+    bool EnableInstancePool(SizeT numInstances);
 
 private:
+    /// create the instance pool on first allocation (thread-safe)
+    Memory::MemoryPool* SetupInstancePool();
     /// constructor method, called from the various constructors
     void Construct(const char* className, Util::FourCC fcc, Creator creatorFunc, const Core::Rtti* parentClass, SizeT instSize);
 
@@ -65,6 +70,8 @@ private:
     Util::FourCC fourCC;
     Creator creator;
     SizeT instanceSize;
+    SizeT numPoolInstances;
+    Memory::MemoryPool* volatile instancePool;
 };
 
 //------------------------------------------------------------------------------
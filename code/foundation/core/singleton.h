@@ -17,6 +17,8 @@
 #include "core/ps3/ps3singleton.h"
 #elif __OSX__
 #include "core/osx/osxsingleton.h"
+#elif __LINUX__
+#include "core/posix/posixsingleton.h"
 #else
 #error "IMPLEMENT ME!"
 #endif
@@ -53,6 +53,15 @@ class SysFunc : public OSX::SysFunc
     // empty
 };
 } // namespace Core
+#elif __LINUX__
+#include "core/posix/posixsysfunc.h"
+namespace Core
+{
+class SysFunc : public Posix::SysFunc
+{
+    // empty
+};
+} // namespace Core
 #else
 #error "Core::SysFunc not implemented on this platform!"
 #endif
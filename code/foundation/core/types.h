@@ -11,6 +11,7 @@
 #if !SPU
 #include "memory/memory.h"
 #endif
+#include "core/typetraits.h"
 
 // fixing Windows defines...
 #ifdef DeleteFile
@@ -42,7 +43,7 @@ static const int InvalidIndex = -1;
 #define BITS_TO_BYTES(x) (((x)+7)>>3)
 #define BYTES_TO_BITS(x) ((x)<<3)
 
-#if (__PS3__ || __WII__ || __OSX__)
+#if (__PS3__ || __WII__ || __OSX__ || __LINUX__)
 inline ushort                _byteswap_ushort(ushort x)              { return ((x>>8) | (x<<8)); }
 inline ulong                 _byteswap_ulong(ulong x)                { return ((x&0xff000000)>>24) | ((x&0x00ff0000)>>8) | ((x&0x00000ff00)<<8) | ((x&0x000000ff)<<24); }
 inline unsigned long long    _byteswap_uint64(unsigned long long x)  { return ((((unsigned long long)_byteswap_ulong((ulong)(x & 0xffffffff))) << 32) | ((unsigned long long)_byteswap_ulong((ulong)(x >> 32)))); }
@@ -63,6 +64,9 @@ inline unsigned long long    _byteswap_uint64(unsigned long long x)  { return ((
 #elif __OSX__
 #define n_stricmp strcasecmp
 #define n_snprintf sprintf
+#elif __LINUX__
+#define n_stricmp strcasecmp
+#define n_snprintf snprintf
 #else
 #error "Unsupported platform!"
 #endif
@@ -82,6 +86,8 @@ inline unsigned long long    _byteswap_uint64(unsigned long long x)  { return ((
 // we keep the definition as it is so that GCC throws an error
 // if it encounters ThreadLocal!
 #define ThreadLocal __thread
+#elif __LINUX__
+#define ThreadLocal __thread
 #else
 #error "Unsupported platform!"
 #endif
@@ -0,0 +1,107 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Core::TypeTraits
+
+    Compile-time properties of a type which allow the container classes
+    to copy and move elements in a cheaper way:
+
+    IsTrivial       - objects need no construction and destruction, and can
+                      be copied with a memcpy (fundamental types, pointers,
+                      float4 and other math types with an empty default
+                      constructor)
+    IsRelocatable   - objects can be moved to a different address with a
+                      memcpy, instead of copy-constructing the object at the
+                      new address and destroying the old object (Ptr<>,
+                      Util::String, and most other classes which don't
+                      keep pointers into themselves)
+
+    Both properties are false by default. A class declares its traits
+    outside of any namespace, after the class declaration:
+
+    @code
+    __DeclareTrivialType(Math::float4)
+    __DeclareRelocatableType(Util::String)
+    @endcode
+
+    Class templates specialize Core::TypeTraits directly, see Ptr or
+    Util::KeyValuePair for examples.
+
+    (C) 2010 Radon Labs GmbH
+*/
+
+//------------------------------------------------------------------------------
+namespace Core
+{
+template<class TYPE> struct TypeTraits
+{
+    enum
+    {
+        IsTrivial = false,
+        IsRelocatable = false
+    };
+};
+
+template<class TYPE> struct TypeTraits<TYPE*>
+{
+    enum
+    {
+        IsTrivial = true,
+        IsRelocatable = true
+    };
+};
+
+} // namespace Core
+
+//------------------------------------------------------------------------------
+/**
+    Declare a type as trivial (implies relocatable). Only use this for
+    types whose default constructor doesn't initialize anything, since
+    the containers won't call it (for instance matrix44 is only
+    relocatable because it must be initialized to identity).
+*/
+#define __DeclareTrivialType(type) \
+namespace Core \
+{ \
+template<> struct TypeTraits<type> \
+{ \
+    enum \
+    { \
+        IsTrivial = true, \
+        IsRelocatable = true \
+    }; \
+}; \
+}
+
+//------------------------------------------------------------------------------
+/**
+    Declare a type as relocatable.
+*/
+#define __DeclareRelocatableType(type) \
+namespace Core \
+{ \
+template<> struct TypeTraits<type> \
+{ \
+    enum \
+    { \
+        IsTrivial = false, \
+        IsRelocatable = true \
+    }; \
+}; \
+}
+
+__DeclareTrivialType(bool)
+__DeclareTrivialType(char)
+__DeclareTrivialType(signed char)
+__DeclareTrivialType(unsigned char)
+__DeclareTrivialType(short)
+__DeclareTrivialType(unsigned short)
+__DeclareTrivialType(int)
+__DeclareTrivialType(unsigned int)
+__DeclareTrivialType(long)
+__DeclareTrivialType(unsigned long)
+__DeclareTrivialType(long long)
+__DeclareTrivialType(unsigned long long)
+__DeclareTrivialType(float)
+__DeclareTrivialType(double)
+//------------------------------------------------------------------------------
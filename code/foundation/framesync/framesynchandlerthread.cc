@@ -245,8 +245,8 @@ FrameSyncHandlerThread::SyncFlipMessageQueue()
 
 //------------------------------------------------------------------------------
 /**
-    Add a message to the producer queue, since we're using double buffering
-    so we don't need thread-synchronization.
+    Add a message to the producer queue, this is a lock-free operation
+    (see Messaging::MessageQueue).
 */
 void
 FrameSyncHandlerThread::AddMessage(const Ptr<Message>& msg)
@@ -263,7 +263,7 @@ FrameSyncHandlerThread::AddMessage(const Ptr<Message>& msg)
 void
 FrameSyncHandlerThread::CancelMessage(const Ptr<Message>& msg)
 {
-    this->msgQueue.EraseMatchingElements(msg);
+    this->msgQueue.Cancel(msg);
 }
 
 //------------------------------------------------------------------------------
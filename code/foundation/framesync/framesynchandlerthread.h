@@ -24,7 +24,7 @@
 #include "messaging/handlerthreadbase.h"
 #include "timing/timer.h"
 #include "threading/threadbarrier.h"
-#include "threading/safequeue.h"
+#include "messaging/messagequeue.h"
 #include "threading/criticalsection.h"
 
 //------------------------------------------------------------------------------
@@ -103,7 +103,7 @@ private:
     Timing::Time fixedFrameTime;
     Timing::Time realTime;
 
-    Threading::SafeQueue<Ptr<Messaging::Message> > msgQueue;   // incoming messages
+    Messaging::MessageQueue msgQueue;                          // incoming messages
     Util::Array<Ptr<Messaging::Message> > msgArray;            // processed messages
 };    
 
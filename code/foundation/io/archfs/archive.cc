@@ -7,7 +7,9 @@
 
 namespace IO
 {
-#if __WIN32__ || __XBOX360__
+#if (__WIN32__ || __XBOX360__ || __LINUX__) && NEBULA3_USE_N3ARCHIVES
+__ImplementClass(IO::Archive, 'ARCV', IO::N3Archive);
+#elif __WIN32__ || __XBOX360__ || __LINUX__
 __ImplementClass(IO::Archive, 'ARCV', IO::ZipArchive);
 #elif __WII__
 __ImplementClass(IO::Archive, 'ARCV', Wii::WiiArchive);
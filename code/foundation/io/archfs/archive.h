@@ -7,7 +7,16 @@
     
     (C) 2009 Radon Labs GmbH
 */    
-#if __WIN32__ || __XBOX360__
+#if (__WIN32__ || __XBOX360__ || __LINUX__) && NEBULA3_USE_N3ARCHIVES
+#include "io/n3fs/n3archive.h"
+namespace IO
+{
+class Archive : public N3Archive
+{
+    __DeclareClass(Archive);
+};
+}
+#elif __WIN32__ || __XBOX360__ || __LINUX__
 #include "io/zipfs/ziparchive.h"
 namespace IO
 {
@@ -102,4 +102,18 @@ ArchiveBase::ConvertToPathInArchive(const String& absPath) const
     return absPath;
 }
 
+//------------------------------------------------------------------------------
+/**
+    This method should return the position of a file's data in the
+    archive file. It's only used to read files in the order in which they
+    are stored in the archive, so it may be approximate.
+
+    Override this method in a subclass!
+*/
+Stream::Position
+ArchiveBase::GetFileOffset(const String& pathInArchive) const
+{
+    return 0;
+}
+
 } // namespace IO
@@ -10,6 +10,7 @@
 */
 #include "core/refcounted.h"
 #include "io/uri.h"
+#include "io/stream.h"
 
 //------------------------------------------------------------------------------
 namespace IO
@@ -40,6 +41,8 @@ public:
     URI ConvertToArchiveURI(const URI& fileURI) const;
     /// convert an absolute path to local path inside archive, returns empty string if absPath doesn't point into this archive
     Util::String ConvertToPathInArchive(const Util::String& absPath) const;
+    /// get position of a file's data in the archive file (only used to order reads)
+    Stream::Position GetFileOffset(const Util::String& pathInArchive) const;
 
 protected:
     bool isValid;
@@ -7,7 +7,10 @@
 
 namespace IO
 {
-#if __WIN32__ || __XBOX360__
+#if (__WIN32__ || __XBOX360__ || __LINUX__) && NEBULA3_USE_N3ARCHIVES
+__ImplementClass(IO::ArchiveFileSystem, 'ARFS', IO::N3ArchiveFileSystem);
+__ImplementInterfaceSingleton(IO::ArchiveFileSystem);
+#elif __WIN32__ || __XBOX360__ || __LINUX__
 __ImplementClass(IO::ArchiveFileSystem, 'ARFS', IO::ZipFileSystem);
 __ImplementInterfaceSingleton(IO::ArchiveFileSystem);
 #elif __WII__
@@ -7,7 +7,22 @@
     
     (C) 2009 Radon Labs GmbH
 */
-#if __WIN32__ || __XBOX360__
+#if (__WIN32__ || __XBOX360__ || __LINUX__) && NEBULA3_USE_N3ARCHIVES
+#include "io/n3fs/n3archivefilesystem.h"
+namespace IO
+{
+class ArchiveFileSystem : public N3ArchiveFileSystem
+{
+    __DeclareClass(ArchiveFileSystem);
+    __DeclareInterfaceSingleton(ArchiveFileSystem);
+public:
+    /// constructor
+    ArchiveFileSystem();
+    /// destructor
+    virtual ~ArchiveFileSystem();
+};
+}
+#elif __WIN32__ || __XBOX360__ || __LINUX__
 #include "io/zipfs/zipfilesystem.h"
 namespace IO
 {
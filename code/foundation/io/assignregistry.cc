@@ -108,7 +108,7 @@ AssignRegistry::SetupSystemAssigns()
     }
     #endif
     
-    #if __WIN32__
+    #if (__WIN32__ || __LINUX__)
     String appDataLocation = FSWrapper::GetAppDataDirectory();
     if (appDataLocation.IsValid())
     {
@@ -146,6 +146,8 @@ AssignRegistry::SetupProjectAssigns()
         this->SetAssign(Assign("export", "root:export_ps3"));
     #elif __OSX__
         this->SetAssign(Assign("export", "root:export_osx"));
+    #elif __LINUX__
+        this->SetAssign(Assign("export", "root:export_linux"));
     #else
     #error "PLATFORM FIXME: setup platform specific assigns!"
     #endif
@@ -15,6 +15,8 @@
 #include "io/ps3/ps3consolehandler.h"
 #elif __OSX__
 #include "io/osx/osxconsolehandler.h"
+#elif __LINUX__
+#include "io/posix/posixconsolehandler.h"
 #endif
 
 namespace IO
@@ -70,6 +72,8 @@ Console::Open()
     Ptr<ConsoleHandler> consoleHandler = PS3::PS3ConsoleHandler::Create();
     #elif __OSX__
     Ptr<ConsoleHandler> consoleHandler = OSX::OSXConsoleHandler::Create();
+    #elif __LINUX__
+    Ptr<ConsoleHandler> consoleHandler = Posix::PosixConsoleHandler::Create();
     #endif
     this->AttachHandler(consoleHandler);    
 
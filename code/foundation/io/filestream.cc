@@ -17,7 +17,9 @@ using namespace Core;
 */
 FileStream::FileStream() :
     handle(0),
-    mappedContent(0)
+    mappedContent(0),
+    mappedSize(0),
+    osMapped(false)
 {
     // empty
 }
@@ -207,10 +209,24 @@ FileStream::Map()
     
     Size size = this->GetSize();
     n_assert(size > 0);
-    this->mappedContent = Memory::Alloc(Memory::ScratchHeap, size);
-    this->Seek(0, Begin);
-    Size readSize = this->Read(this->mappedContent, size);
-    n_assert(readSize == size);
+    if (ReadAccess == this->accessMode)
+    {
+        this->mappedContent = FSWrapper::MapFile(this->handle, size, this->accessPattern);
+    }
+    if (0 != this->mappedContent)
+    {
+        this->osMapped = true;
+    }
+    else
+    {
+        // fallback: read the file into memory
+        this->mappedContent = Memory::Alloc(Memory::ScratchHeap, size);
+        this->Seek(0, Begin);
+        Size readSize = this->Read(this->mappedContent, size);
+        n_assert(readSize == size);
+        this->osMapped = false;
+    }
+    this->mappedSize = size;
     Stream::Map();
     return this->mappedContent;
 }
@@ -223,8 +239,17 @@ FileStream::Unmap()
 {
     n_assert(0 != this->mappedContent);
     Stream::Unmap();
-    Memory::Free(Memory::ScratchHeap, this->mappedContent);
+    if (this->osMapped)
+    {
+        FSWrapper::UnmapFile(this->mappedContent, this->mappedSize);
+    }
+    else
+    {
+        Memory::Free(Memory::ScratchHeap, this->mappedContent);
+    }
     this->mappedContent = 0;
+    this->mappedSize = 0;
+    this->osMapped = false;
 }
 
 } // namespace IO
@@ -4,6 +4,12 @@
     @class IO::FileStream
   
     A stream to which offers read/write access to filesystem files.
+
+    Map() maps files which are opened for read access directly into memory
+    through the operating system (if supported by the platform), so that
+    the mapped content isn't copied. The mapped pages are copy-on-write, 
+    the access pattern of the stream is handed to the OS as hint. Other 
+    files are read into a memory buffer on Map().
     
     (C) 2006 Radon Labs GmbH
 */
@@ -57,6 +63,8 @@ public:
 private:
     FSWrapper::Handle handle;
     void* mappedContent;
+    Size mappedSize;
+    bool osMapped;
 };
 
 } // namespace IO
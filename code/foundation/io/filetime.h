@@ -34,6 +34,12 @@ namespace IO
 {
 typedef OSX::OSXFileTime FileTime;
 }
+#elif __LINUX__
+#include "io/posix/posixfiletime.h"
+namespace IO
+{
+typedef Posix::PosixFileTime FileTime;
+}
 #else
 #error "FileTime class not implemented on this platform!"
 #endif
@@ -38,6 +38,13 @@ namespace IO
 class FSWrapper : public OSX::OSXFSWrapper
 { };
 }
+#elif __LINUX__
+#include "io/posix/posixfswrapper.h"
+namespace IO
+{
+class FSWrapper : public Posix::PosixFSWrapper
+{ };
+}
 #else
 #error "FSWrapper class not implemented on this platform!"
 #endif
@@ -7,7 +7,7 @@
 
 namespace IO
 {
-#if (__WIN32__ || __XBOX360__ || __WII__ || __OSX__)
+#if (__WIN32__ || __XBOX360__ || __WII__ || __OSX__ || __LINUX__)
 __ImplementClass(IO::GameContentServer, 'IGCS', Base::GameContentServerBase);
 #elif __PS3__
 __ImplementClass(IO::GameContentServer, 'IGCS', PS3::PS3GameContentServer);
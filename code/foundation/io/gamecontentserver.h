@@ -10,7 +10,7 @@
     (C) 2009 Radon Labs GmbH
 */
 #include "core/config.h"
-#if (__WIN32__ || __XBOX360__ || __WII__ || __OSX__)
+#if (__WIN32__ || __XBOX360__ || __WII__ || __OSX__ || __LINUX__)
 #include "io/base/gamecontentserverbase.h"
 namespace IO
 {
@@ -44,7 +44,9 @@ IoInterface::Open()
 #if __WII_
     handlerThread->SetPriority(Thread::NormalBoost);
 #endif        
-    handlerThread->AttachHandler(IoInterfaceHandler::Create());
+    Ptr<IoInterfaceHandler> handler = IoInterfaceHandler::Create();
+    handler->SetHandlerThread(handlerThread.get());
+    handlerThread->AttachHandler(handler.upcast<Handler>());
     this->SetHandlerThread(handlerThread.cast<HandlerThreadBase>());
 
     InterfaceBase::Open();
@@ -8,7 +8,8 @@
     Communication with the IO::Interface happens by sending messages to
     the Interface object. Messages are guaranteed to be handled sequentially 
     in FIFO order (there's exactly one handler thread which handles all 
-    messages).
+    messages). ReadStream messages are the exception, they are read
+    in parallel by an IoRequestQueue, see IoInterfaceHandler for details.
     
     (C) 2006 Radon Labs GmbH
 */
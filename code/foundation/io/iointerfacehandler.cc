@@ -5,6 +5,7 @@
 #include "stdneb.h"
 #include "io/iointerfacehandler.h"
 #include "io/filestream.h"
+#include "messaging/blockinghandlerthread.h"
 
 namespace IO
 {
@@ -16,7 +17,8 @@ using namespace Messaging;
 //------------------------------------------------------------------------------
 /**    
 */
-IoInterfaceHandler::IoInterfaceHandler()
+IoInterfaceHandler::IoInterfaceHandler() :
+    handlerThread(0)
 {
 }
 
@@ -28,6 +30,18 @@ IoInterfaceHandler::~IoInterfaceHandler()
     n_assert(!this->IsOpen());
 }
 
+//------------------------------------------------------------------------------
+/**
+    Set the handler thread which runs this handler, the request queue
+    wakes it up when a read request has been completed.
+*/
+void
+IoInterfaceHandler::SetHandlerThread(BlockingHandlerThread* t)
+{
+    n_assert(!this->IsOpen());
+    this->handlerThread = t;
+}
+
 //------------------------------------------------------------------------------
 /**
     Opens the Interface message handler which does all the interesting stuff.
@@ -44,6 +58,9 @@ IoInterfaceHandler::Open()
     this->httpClientRegistry = Http::HttpClientRegistry::Create();
     this->httpClientRegistry->Setup();
     #endif
+    this->requestQueue = IO::IoRequestQueue::Create();
+    this->requestQueue->SetHandlerThread(this->handlerThread);
+    this->requestQueue->Open();
 }
 
 //------------------------------------------------------------------------------
@@ -55,6 +72,9 @@ IoInterfaceHandler::Open()
 void
 IoInterfaceHandler::Close()
 {
+    this->FlushReadRequests();
+    this->requestQueue->Close();
+    this->requestQueue = 0;
     #if __NEBULA3_HTTP_FILESYSTEM__
     this->httpClientRegistry->Discard();
     this->httpClientRegistry = 0;
@@ -71,6 +91,14 @@ bool
 IoInterfaceHandler::HandleMessage(const Ptr<Message>& msg)
 {
     n_assert(msg.isvalid());
+    if (msg->CheckId(ReadStream::Id))
+    {
+        this->OnReadStream(msg.downcast<IO::ReadStream>());
+        return true;
+    }
+
+    // all other messages may depend on the outcome of pending reads
+    this->FlushReadRequests();
     if (msg->CheckId(MountArchive::Id))
     {
         this->OnMountArchive(msg.downcast<IO::MountArchive>());
@@ -91,10 +119,6 @@ IoInterfaceHandler::HandleMessage(const Ptr<Message>& msg)
     {
         this->OnWriteStream(msg.downcast<IO::WriteStream>());
     }
-    else if (msg->CheckId(ReadStream::Id))
-    {
-        this->OnReadStream(msg.downcast<IO::ReadStream>());
-    }
     else if (msg->CheckId(CopyFile::Id))
     {
         this->OnCopyFile(msg.downcast<IO::CopyFile>());
@@ -191,38 +215,43 @@ IoInterfaceHandler::OnWriteStream(const Ptr<IO::WriteStream>& msg)
 
 //------------------------------------------------------------------------------
 /**
+    ReadStream messages are deferred and collected, the collected messages
+    are submitted as one batch to the request queue in DoWork(), which
+    is called after all currently queued messages have been handled.
 */
 void
 IoInterfaceHandler::OnReadStream(const Ptr<IO::ReadStream>& msg)
 {
     // n_printf("IOInterface: ReadStream %s\n", msg->GetURI().AsString().AsCharPtr());
-
-    // create a file stream which reads in the data from disc
     msg->SetResult(false);
-    Ptr<Stream> srcStream = IO::IoServer::Instance()->CreateStream(msg->GetURI());
-    srcStream->SetAccessMode(Stream::ReadAccess);
-    if (srcStream->Open())
+    msg->SetDeferred(true);
+    this->pendingReadMsgs.Append(msg);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Submit the collected ReadStream messages to the request queue.
+*/
+void
+IoInterfaceHandler::DoWork()
+{
+    if (!this->pendingReadMsgs.IsEmpty())
     {
-        /// @todo handle non-mappable stream!
-        const Ptr<Stream>& dstStream = msg->GetStream();
-        n_assert(dstStream.isvalid());
-        n_assert(dstStream->CanBeMapped());
-        dstStream->SetAccessMode(Stream::WriteAccess);
-        Stream::Size srcSize = srcStream->GetSize();
-        n_assert(srcSize > 0);
-        dstStream->SetURI(msg->GetURI());
-        if (dstStream->Open())
-        {
-            dstStream->SetSize(srcSize);
-            void* ptr = dstStream->Map();
-            n_assert(0 != ptr);
-            srcStream->Read(ptr, srcSize);
-            dstStream->Unmap();
-            dstStream->Close();
-            msg->SetResult(true);
-        }
-        srcStream->Close();
+        this->requestQueue->Submit(this->pendingReadMsgs);
+        this->pendingReadMsgs.Clear();
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+    Submit the collected ReadStream messages and wait until all read
+    requests have been completed.
+*/
+void
+IoInterfaceHandler::FlushReadRequests()
+{
+    this->DoWork();
+    this->requestQueue->WaitIdle();
+}
+
 } // namespace IO
\ No newline at end of file
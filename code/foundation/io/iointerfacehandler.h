@@ -4,6 +4,11 @@
     @class IO::IoInterfaceHandler
     
     Handler class for io interfaces.
+
+    ReadStream messages are deferred and handed to an IoRequestQueue
+    in batches, which reads them in its own reader threads. All other
+    messages first wait for the pending read requests to complete, so
+    that their effects are still ordered with the reads.
     
     (C) 2006 Radon Labs GmbH
 */
@@ -11,6 +16,7 @@
 #include "io/console.h"
 #include "io/ioserver.h"
 #include "io/iointerfaceprotocol.h"
+#include "io/iorequestqueue.h"
 #if __NEBULA3_HTTP_FILESYSTEM__
 #include "http/httpclientregistry.h"
 #endif
@@ -26,6 +32,8 @@ public:
     IoInterfaceHandler();
     /// destructor
     virtual ~IoInterfaceHandler();
+    /// set the handler thread which runs this handler
+    void SetHandlerThread(Messaging::BlockingHandlerThread* handlerThread);
     
     /// open the handler
     virtual void Open();
@@ -33,6 +41,8 @@ public:
     virtual void Close();
     /// handle a message, return true if handled
     virtual bool HandleMessage(const Ptr<Messaging::Message>& msg);
+    /// submit collected read requests
+    virtual void DoWork();
 
 protected:
     /// handle CreateDirectory message
@@ -49,8 +59,13 @@ protected:
     void OnCopyFile(const Ptr<IO::CopyFile>& msg);
     /// handle MountArchive message
     void OnMountArchive(const Ptr<IO::MountArchive>& msg);
+    /// submit collected read requests and wait until all reads have been completed
+    void FlushReadRequests();
 
+    Messaging::BlockingHandlerThread* handlerThread;
     Ptr<IO::IoServer> ioServer;
+    Ptr<IO::IoRequestQueue> requestQueue;
+    Util::Array<Ptr<IO::ReadStream> > pendingReadMsgs;
     #if __NEBULA3_HTTP_FILESYSTEM__
     Ptr<Http::HttpClientRegistry> httpClientRegistry;
     #endif
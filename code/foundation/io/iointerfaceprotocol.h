@@ -5,6 +5,7 @@
     DO NOT EDIT
 */
 #include "messaging/message.h"
+#include "timing/time.h"
 
 //------------------------------------------------------------------------------
 namespace IO
@@ -131,7 +132,9 @@ class ReadStream : public IOMessage
     __DeclareClass(ReadStream);
     __DeclareMsgId;
 public:
-    ReadStream() 
+    ReadStream() :
+        priority(0),
+        deadline(0.0)
     { };
 public:
     void SetStream(const Ptr<IO::Stream>& val)
@@ -145,6 +148,30 @@ public:
     };
 private:
     Ptr<IO::Stream> stream;
+public:
+    void SetPriority(int val)
+    {
+        n_assert(!this->handled);
+        this->priority = val;
+    };
+    int GetPriority() const
+    {
+        return this->priority;
+    };
+private:
+    int priority;
+public:
+    void SetDeadline(const Timing::Time& val)
+    {
+        n_assert(!this->handled);
+        this->deadline = val;
+    };
+    const Timing::Time& GetDeadline() const
+    {
+        return this->deadline;
+    };
+private:
+    Timing::Time deadline;
 };
 //------------------------------------------------------------------------------
 class WriteStream : public IOMessage
@@ -0,0 +1,394 @@
+//------------------------------------------------------------------------------
+//  iorequestqueue.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "io/iorequestqueue.h"
+#include "io/ioserver.h"
+#include "io/archfs/archivefilesystem.h"
+#include "messaging/blockinghandlerthread.h"
+
+namespace IO
+{
+__ImplementClass(IO::IoRequestQueue, 'IORQ', Core::RefCounted);
+__ImplementClass(IO::IoRequestQueue::ReaderThread, 'IORT', Threading::Thread);
+
+using namespace Util;
+
+const Timing::Time IoRequestQueue::NoDeadline = 1.0e30;
+
+//------------------------------------------------------------------------------
+/**
+*/
+IoRequestQueue::IoRequestQueue() :
+    isOpen(false),
+    numThreads(DefaultNumThreads),
+    handlerThread(0),
+    numRequestsInFlight(0),
+    numMissedDeadlines(0),
+    nextSequence(0)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+IoRequestQueue::~IoRequestQueue()
+{
+    if (this->IsOpen())
+    {
+        this->Close();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+IoRequestQueue::SetNumThreads(SizeT num)
+{
+    n_assert(!this->IsOpen());
+    n_assert(num > 0);
+    this->numThreads = num;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+IoRequestQueue::Open()
+{
+    n_assert(!this->IsOpen());
+    n_assert(0 != this->handlerThread);
+    this->isOpen = true;
+    this->timer.Start();
+    this->readerThreads.SetSize(this->numThreads);
+    IndexT i;
+    for (i = 0; i < this->numThreads; i++)
+    {
+        Ptr<ReaderThread> readerThread = ReaderThread::Create();
+        readerThread->SetName("IoRequestQueue Reader Thread");
+        readerThread->SetCoreId(System::Cpu::IoThreadCore);
+        readerThread->SetRequestQueue(this);
+        readerThread->Start();
+        this->readerThreads[i] = readerThread;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Waits until all pending requests have been completed, and stops
+    the reader threads.
+*/
+void
+IoRequestQueue::Close()
+{
+    n_assert(this->IsOpen());
+    this->WaitIdle();
+    this->isOpen = false;
+    IndexT i;
+    for (i = 0; i < this->readerThreads.Size(); i++)
+    {
+        this->readerThreads[i]->Stop();
+        this->readerThreads[i] = 0;
+    }
+    this->readerThreads.SetSize(0);
+    this->timer.Stop();
+    this->handlerThread = 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Submit a batch of ReadStream messages. The messages must have been
+    flagged as deferred by the caller. The source streams are created
+    here (in the caller's thread), the actual reading happens in the
+    reader threads.
+*/
+void
+IoRequestQueue::Submit(const Array<Ptr<ReadStream> >& msgs)
+{
+    n_assert(this->IsOpen());
+    if (msgs.IsEmpty())
+    {
+        return;
+    }
+
+    // setup request objects outside of the critical section
+    Timing::Time curTime = this->timer.GetTime();
+    Array<Request> requests(msgs.Size(), 0);
+    IndexT i;
+    for (i = 0; i < msgs.Size(); i++)
+    {
+        const Ptr<ReadStream>& msg = msgs[i];
+        n_assert(msg->IsDeferred());
+        Request request;
+        request.msg = msg;
+        request.srcStream = IoServer::Instance()->CreateStream(msg->GetURI());
+        request.offset = 0;
+        request.priority = msg->GetPriority();
+        request.deadline = (msg->GetDeadline() > 0.0) ? curTime + msg->GetDeadline() : NoDeadline;
+        request.sequence = 0;
+
+        // find the archive and position of the file data if the file is in an archive
+        Dictionary<String,String> params = request.srcStream->GetURI().ParseQuery();
+        if (params.Contains("file"))
+        {
+            request.archive = ArchiveFileSystem::Instance()->FindArchive(request.srcStream->GetURI());
+            if (request.archive.isvalid())
+            {
+                request.offset = request.archive->GetFileOffset(params["file"]);
+            }
+        }
+        requests.Append(request);
+    }
+
+    this->critSect.Enter();
+    for (i = 0; i < requests.Size(); i++)
+    {
+        requests[i].sequence = this->nextSequence++;
+        this->pendingRequests.Append(requests[i]);
+    }
+    this->pendingRequests.Sort();
+    this->numRequestsInFlight += requests.Size();
+    this->critSect.Leave();
+
+    // wake up a reader thread, which will wake up the next one if necessary
+    this->requestEvent.Signal();
+}
+
+//------------------------------------------------------------------------------
+/**
+    Take the most urgent request, and the requests which directly follow
+    it in the same archive, up to MaxRunSize requests. Called by the
+    reader threads.
+*/
+bool
+IoRequestQueue::TakeRequests(Array<Request>& outRun)
+{
+    this->critSect.Enter();
+    while (!this->pendingRequests.IsEmpty() && (outRun.Size() < MaxRunSize))
+    {
+        const Request& request = this->pendingRequests.Front();
+        if (!outRun.IsEmpty() && !request.Continues(outRun.Back()))
+        {
+            break;
+        }
+        outRun.Append(request);
+        this->pendingRequests.EraseIndex(0);
+    }
+    bool moreRequests = !this->pendingRequests.IsEmpty();
+    this->critSect.Leave();
+
+    // let the next reader thread handle the remaining requests
+    if (moreRequests)
+    {
+        this->requestEvent.Signal();
+    }
+    return !outRun.IsEmpty();
+}
+
+//------------------------------------------------------------------------------
+/**
+    Update the statistics, and wake up the handler thread, which will
+    set the handled flag of the message. Called by the reader threads
+    after the message has been flagged as deferred-handled.
+*/
+void
+IoRequestQueue::CompleteRequest(const Request& request)
+{
+    Timing::Time curTime = this->timer.GetTime();
+    this->critSect.Enter();
+    if (curTime > request.deadline)
+    {
+        this->numMissedDeadlines++;
+    }
+    n_assert(this->numRequestsInFlight > 0);
+    bool idle = (0 == --this->numRequestsInFlight);
+    this->critSect.Leave();
+    if (idle)
+    {
+        this->idleEvent.Signal();
+    }
+    this->handlerThread->EmitWakeupSignal();
+}
+
+//------------------------------------------------------------------------------
+/**
+    Wait until all submitted requests have been completed. Note that the
+    handler thread may not have set the handled flag on the messages yet.
+*/
+void
+IoRequestQueue::WaitIdle()
+{
+    while (this->GetNumRequestsInFlight() > 0)
+    {
+        this->idleEvent.Wait();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+SizeT
+IoRequestQueue::GetNumRequestsInFlight() const
+{
+    this->critSect.Enter();
+    SizeT num = this->numRequestsInFlight;
+    this->critSect.Leave();
+    return num;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+SizeT
+IoRequestQueue::GetNumMissedDeadlines() const
+{
+    this->critSect.Enter();
+    SizeT num = this->numMissedDeadlines;
+    this->critSect.Leave();
+    return num;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Read the complete source stream into the message's destination stream.
+    Called by the reader threads.
+*/
+bool
+IoRequestQueue::ReadRequest(const Request& request)
+{
+    bool success = false;
+    const Ptr<Stream>& srcStream = request.srcStream;
+    srcStream->SetAccessMode(Stream::ReadAccess);
+    if (srcStream->Open())
+    {
+        /// @todo handle non-mappable stream!
+        const Ptr<Stream>& dstStream = request.msg->GetStream();
+        n_assert(dstStream.isvalid());
+        n_assert(dstStream->CanBeMapped());
+        dstStream->SetAccessMode(Stream::WriteAccess);
+        Stream::Size srcSize = srcStream->GetSize();
+        n_assert(srcSize > 0);
+        dstStream->SetURI(request.msg->GetURI());
+        if (dstStream->Open())
+        {
+            dstStream->SetSize(srcSize);
+            void* ptr = dstStream->Map();
+            n_assert(0 != ptr);
+            success = (srcSize == srcStream->Read(ptr, srcSize));
+            dstStream->Unmap();
+            dstStream->Close();
+        }
+        srcStream->Close();
+    }
+    return success;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+IoRequestQueue::Request::operator<(const Request& rhs) const
+{
+    if (this->priority != rhs.priority)
+    {
+        return this->priority > rhs.priority;
+    }
+    if (this->deadline != rhs.deadline)
+    {
+        return this->deadline < rhs.deadline;
+    }
+    if (this->archive.get_unsafe() != rhs.archive.get_unsafe())
+    {
+        return this->archive.get_unsafe() < rhs.archive.get_unsafe();
+    }
+    if (this->offset != rhs.offset)
+    {
+        return this->offset < rhs.offset;
+    }
+    return this->sequence < rhs.sequence;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+IoRequestQueue::Request::Continues(const Request& prev) const
+{
+    return this->archive.isvalid() &&
+           (this->archive.get_unsafe() == prev.archive.get_unsafe()) &&
+           (this->priority == prev.priority) &&
+           (this->deadline == prev.deadline) &&
+           (this->offset >= prev.offset);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+IoRequestQueue::ReaderThread::ReaderThread() :
+    requestQueue(0)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+IoRequestQueue::ReaderThread::SetRequestQueue(IoRequestQueue* q)
+{
+    n_assert(!this->IsRunning());
+    this->requestQueue = q;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+IoRequestQueue::ReaderThread::EmitWakeupSignal()
+{
+    this->requestQueue->requestEvent.Signal();
+}
+
+//------------------------------------------------------------------------------
+/**
+    The reader thread loop. Each reader thread runs its own minimal
+    Nebula3 IO runtime.
+*/
+void
+IoRequestQueue::ReaderThread::DoWork()
+{
+    Ptr<IoServer> ioServer = IoServer::Create();
+    Array<Request> run;
+    while (!this->ThreadStopRequested())
+    {
+        if (this->requestQueue->TakeRequests(run))
+        {
+            IndexT i;
+            for (i = 0; i < run.Size(); i++)
+            {
+                const Request& request = run[i];
+                request.msg->SetResult(IoRequestQueue::ReadRequest(request));
+                request.msg->SetDeferredHandled(true);
+                this->requestQueue->CompleteRequest(request);
+            }
+            run.Clear();
+        }
+        else if (this->requestQueue->IsOpen())
+        {
+            this->requestQueue->requestEvent.Wait();
+        }
+        else
+        {
+            // the queue is closing, another reader thread may have
+            // consumed our wakeup signal, so pass it on
+            this->requestQueue->requestEvent.Signal();
+            break;
+        }
+    }
+    ioServer = 0;
+}
+
+} // namespace IO
@@ -0,0 +1,171 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class IO::IoRequestQueue
+
+    Schedules ReadStream requests on a pool of reader threads. Used by
+    the IoInterfaceHandler, so that many read requests can be in flight
+    at the same time instead of being handled one by one in the
+    IoInterface thread.
+
+    Requests are submitted in batches. Pending requests are served in
+    this order:
+
+    - higher ReadStream priority first
+    - earlier deadline first (requests without deadline last)
+    - grouped by archive, and by position of the file data in the archive
+
+    A reader thread takes a run of up to MaxRunSize adjacent requests
+    into the same archive at once and reads them in file order, so that
+    files which are stored next to each other are read in one sequential
+    sweep through the archive file.
+
+    When a request has been completed, the ReadStream message is flagged
+    as deferred-handled and the owner's message handler thread is woken
+    up, which then sets the message's handled flag. Thus the message
+    itself works as the future of the request, use the usual
+    AsyncPort::Peek() or AsyncPort::Wait() on it.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/refcounted.h"
+#include "threading/thread.h"
+#include "threading/criticalsection.h"
+#include "threading/event.h"
+#include "timing/timer.h"
+#include "io/iointerfaceprotocol.h"
+#include "io/archfs/archive.h"
+#include "util/fixedarray.h"
+
+namespace Messaging
+{
+class BlockingHandlerThread;
+}
+
+//------------------------------------------------------------------------------
+namespace IO
+{
+class IoRequestQueue : public Core::RefCounted
+{
+    __DeclareClass(IoRequestQueue);
+public:
+    /// constructor
+    IoRequestQueue();
+    /// destructor
+    virtual ~IoRequestQueue();
+
+    /// set number of reader threads (default is DefaultNumThreads)
+    void SetNumThreads(SizeT num);
+    /// get number of reader threads
+    SizeT GetNumThreads() const;
+    /// set the handler thread which is woken up when a request has been completed
+    void SetHandlerThread(Messaging::BlockingHandlerThread* handlerThread);
+    /// open the queue, starts the reader threads
+    void Open();
+    /// close the queue, waits for pending requests and stops the reader threads
+    void Close();
+    /// return true if open
+    bool IsOpen() const;
+
+    /// submit a batch of ReadStream messages
+    void Submit(const Util::Array<Ptr<ReadStream> >& msgs);
+    /// wait until all submitted requests have been completed
+    void WaitIdle();
+    /// get number of pending or running requests
+    SizeT GetNumRequestsInFlight() const;
+    /// get number of completed requests which missed their deadline
+    SizeT GetNumMissedDeadlines() const;
+
+    static const SizeT DefaultNumThreads = 2;
+    static const SizeT MaxRunSize = 16;
+
+private:
+    /// a pending read request
+    struct Request
+    {
+        /// sort by priority, deadline and position in archive
+        bool operator<(const Request& rhs) const;
+        /// return true if the request continues a run of requests into the same archive
+        bool Continues(const Request& prev) const;
+
+        Ptr<ReadStream> msg;
+        Ptr<Stream> srcStream;
+        Ptr<Archive> archive;       // invalid if not in an archive
+        Stream::Position offset;    // position of the data in the archive
+        int priority;
+        Timing::Time deadline;      // absolute, or NoDeadline
+        IndexT sequence;            // submission order
+    };
+
+    /// a reader thread
+    class ReaderThread : public Threading::Thread
+    {
+        __DeclareClass(ReaderThread);
+    public:
+        /// constructor
+        ReaderThread();
+        /// set pointer to the owning request queue
+        void SetRequestQueue(IoRequestQueue* requestQueue);
+    private:
+        /// this method runs in the thread context
+        virtual void DoWork();
+        /// called if thread needs a wakeup call before stopping
+        virtual void EmitWakeupSignal();
+
+        IoRequestQueue* requestQueue;
+    };
+    friend class ReaderThread;
+
+    /// take the next run of requests (called by reader threads)
+    bool TakeRequests(Util::Array<Request>& outRun);
+    /// complete a request (called by reader threads)
+    void CompleteRequest(const Request& request);
+    /// read the source stream into the message's stream (called by reader threads)
+    static bool ReadRequest(const Request& request);
+
+    static const Timing::Time NoDeadline;
+
+    bool isOpen;
+    SizeT numThreads;
+    Messaging::BlockingHandlerThread* handlerThread;
+    Util::FixedArray<Ptr<ReaderThread> > readerThreads;
+    Timing::Timer timer;
+    Threading::CriticalSection critSect;
+    Threading::Event requestEvent;      // signalled when requests have been submitted
+    Threading::Event idleEvent;         // signalled when the last request has been completed
+    Util::Array<Request> pendingRequests;
+    SizeT numRequestsInFlight;
+    SizeT numMissedDeadlines;
+    IndexT nextSequence;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+IoRequestQueue::IsOpen() const
+{
+    return this->isOpen;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+IoRequestQueue::GetNumThreads() const
+{
+    return this->numThreads;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+IoRequestQueue::SetHandlerThread(Messaging::BlockingHandlerThread* t)
+{
+    n_assert(!this->IsOpen());
+    this->handlerThread = t;
+}
+
+} // namespace IO
+//------------------------------------------------------------------------------
@@ -0,0 +1,418 @@
+//------------------------------------------------------------------------------
+//  n3archive.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "io/n3fs/n3archive.h"
+#include "io/assignregistry.h"
+
+namespace IO
+{
+__ImplementClass(IO::N3Archive, 'N3AR', IO::ArchiveBase);
+
+using namespace Util;
+
+//------------------------------------------------------------------------------
+/**
+*/
+N3Archive::N3Archive() :
+    fileHandle(0),
+    mappedData(0),
+    mappedSize(0),
+    directoryBuffer(0),
+    header(0),
+    entries(0),
+    bucketSeeds(0),
+    slots(0),
+    stringPool(0)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+N3Archive::~N3Archive()
+{
+    if (this->IsValid())
+    {
+        this->Discard();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Open the archive file and setup the directory. The archive is memory
+    mapped if possible, otherwise only the directory block is read.
+*/
+bool
+N3Archive::Setup(const URI& archiveURI)
+{
+    n_assert(!this->IsValid());
+    n_assert(0 == this->fileHandle);
+
+    if (ArchiveBase::Setup(archiveURI))
+    {
+        // extract the root location of the archive
+        this->rootPath = this->uri.LocalPath().ExtractDirName();
+
+        // open the archive file
+        URI absPath = AssignRegistry::Instance()->ResolveAssigns(this->uri);
+        String localPath = absPath.LocalPath();
+        localPath.Append(".n3a");
+        this->fileHandle = FSWrapper::OpenFile(localPath, Stream::ReadAccess, Stream::Random);
+        if (0 != this->fileHandle)
+        {
+            Stream::Size archiveSize = FSWrapper::GetFileSize(this->fileHandle);
+            if (archiveSize >= (Stream::Size)sizeof(N3ArchiveHeader))
+            {
+                // try to map the entire archive, this makes the directory
+                // and all stored files directly accessible
+                this->mappedData = (uchar*) FSWrapper::MapFile(this->fileHandle, archiveSize, Stream::Random);
+                if (0 != this->mappedData)
+                {
+                    this->mappedSize = archiveSize;
+                    if (this->SetupDirectory(this->mappedData, archiveSize))
+                    {
+                        return true;
+                    }
+                }
+                else
+                {
+                    // fallback: read the header, then the complete directory block
+                    N3ArchiveHeader fileHeader;
+                    if ((sizeof(fileHeader) == FSWrapper::ReadAt(this->fileHandle, &fileHeader, sizeof(fileHeader), 0)) &&
+                        (N3ArchiveMagic == fileHeader.magic) &&
+                        (fileHeader.directorySize >= sizeof(fileHeader)) &&
+                        (fileHeader.directorySize <= (uint)archiveSize))
+                    {
+                        this->directoryBuffer = (uchar*) Memory::Alloc(Memory::DefaultHeap, fileHeader.directorySize);
+                        if ((fileHeader.directorySize == (uint)FSWrapper::ReadAt(this->fileHandle, this->directoryBuffer, fileHeader.directorySize, 0)) &&
+                            this->SetupDirectory(this->directoryBuffer, archiveSize))
+                        {
+                            return true;
+                        }
+                    }
+                }
+            }
+            n_printf("N3Archive: invalid archive file '%s'!\n", localPath.AsCharPtr());
+        }
+
+        // fallthrough: failure
+        this->Discard();
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Setup the pointers into the directory block, and make sure that the
+    directory is consistent, so that lookups don't need to validate anything.
+*/
+bool
+N3Archive::SetupDirectory(const uchar* directory, SizeT archiveSize)
+{
+    const N3ArchiveHeader* dirHeader = (const N3ArchiveHeader*) directory;
+    if ((N3ArchiveMagic != dirHeader->magic) || (N3ArchiveVersion != dirHeader->version))
+    {
+        return false;
+    }
+    if ((0 == dirHeader->numEntries) ||
+        (0 == dirHeader->numBuckets) || (0 != (dirHeader->numBuckets & (dirHeader->numBuckets - 1))) ||
+        (0 == dirHeader->numSlots) || (0 != (dirHeader->numSlots & (dirHeader->numSlots - 1))))
+    {
+        return false;
+    }
+    uint entriesOffset = sizeof(N3ArchiveHeader);
+    uint seedsOffset = entriesOffset + dirHeader->numEntries * sizeof(N3ArchiveEntry);
+    uint slotsOffset = seedsOffset + dirHeader->numBuckets * sizeof(uint);
+    uint stringPoolOffset = slotsOffset + dirHeader->numSlots * sizeof(uint);
+    if (((stringPoolOffset + dirHeader->stringPoolSize) > dirHeader->directorySize) ||
+        (dirHeader->directorySize > (uint)archiveSize))
+    {
+        return false;
+    }
+    const N3ArchiveEntry* dirEntries = (const N3ArchiveEntry*) (directory + entriesOffset);
+    const uint* dirSlots = (const uint*) (directory + slotsOffset);
+    const char* dirStringPool = (const char*) (directory + stringPoolOffset);
+    if ((dirHeader->stringPoolSize > 0) && (0 != dirStringPool[dirHeader->stringPoolSize - 1]))
+    {
+        return false;
+    }
+
+    // check slots and entries, this is a single linear pass over the directory
+    IndexT i;
+    for (i = 0; i < (IndexT)dirHeader->numSlots; i++)
+    {
+        if ((N3ArchiveInvalidEntry != dirSlots[i]) && (dirSlots[i] >= dirHeader->numEntries))
+        {
+            return false;
+        }
+    }
+    for (i = 0; i < (IndexT)dirHeader->numEntries; i++)
+    {
+        const N3ArchiveEntry& entry = dirEntries[i];
+        if ((entry.pathOffset + entry.pathLength >= dirHeader->stringPoolSize) ||
+            (entry.nameOffset < entry.pathOffset) || (entry.nameOffset > entry.pathOffset + entry.pathLength) ||
+            (entry.parentEntry >= dirHeader->numEntries))
+        {
+            return false;
+        }
+        if (0 != (entry.flags & N3ArchiveDirectory))
+        {
+            if (entry.firstChild + entry.numChildren > dirHeader->numEntries)
+            {
+                return false;
+            }
+        }
+        else if ((entry.dataOffset + entry.dataSize < entry.dataOffset) || (entry.dataOffset + entry.dataSize > (uint)archiveSize))
+        {
+            return false;
+        }
+    }
+    if (0 == (dirEntries[0].flags & N3ArchiveDirectory))
+    {
+        return false;
+    }
+
+    this->header = dirHeader;
+    this->entries = dirEntries;
+    this->bucketSeeds = (const uint*) (directory + seedsOffset);
+    this->slots = dirSlots;
+    this->stringPool = dirStringPool;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Unmap and close the archive.
+*/
+void
+N3Archive::Discard()
+{
+    n_assert(this->IsValid());
+    if (0 != this->mappedData)
+    {
+        FSWrapper::UnmapFile(this->mappedData, this->mappedSize);
+        this->mappedData = 0;
+        this->mappedSize = 0;
+    }
+    if (0 != this->directoryBuffer)
+    {
+        Memory::Free(Memory::DefaultHeap, this->directoryBuffer);
+        this->directoryBuffer = 0;
+    }
+    if (0 != this->fileHandle)
+    {
+        FSWrapper::CloseFile(this->fileHandle);
+        this->fileHandle = 0;
+    }
+    this->header = 0;
+    this->entries = 0;
+    this->bucketSeeds = 0;
+    this->slots = 0;
+    this->stringPool = 0;
+    ArchiveBase::Discard();
+}
+
+//------------------------------------------------------------------------------
+/**
+    Find an entry through the perfect hash table. Leading and trailing
+    slashes are ignored, backslashes are treated as slashes, an empty path
+    returns the root directory entry. This doesn't allocate memory.
+*/
+const N3ArchiveEntry*
+N3Archive::FindEntry(const char* pathInArchive, SizeT length) const
+{
+    n_assert(0 != this->header);
+    const char* path;
+    SizeT pathLength;
+    N3ArchiveTrimPath(pathInArchive, length, path, pathLength);
+    if (0 == pathLength)
+    {
+        return &(this->entries[0]);
+    }
+
+    uint bucket = N3ArchiveHashPath(path, pathLength, 0) & (this->header->numBuckets - 1);
+    uint slot = N3ArchiveHashPath(path, pathLength, this->bucketSeeds[bucket]) & (this->header->numSlots - 1);
+    uint entryIndex = this->slots[slot];
+    if (N3ArchiveInvalidEntry != entryIndex)
+    {
+        const N3ArchiveEntry* entry = &(this->entries[entryIndex]);
+        if (N3ArchivePathEqual(path, pathLength, this->stringPool + entry->pathOffset, entry->pathLength))
+        {
+            return entry;
+        }
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const N3ArchiveEntry*
+N3Archive::FindFileEntry(const String& pathInArchive) const
+{
+    const N3ArchiveEntry* entry = this->FindEntry(pathInArchive.AsCharPtr(), pathInArchive.Length());
+    if ((0 != entry) && (0 == (entry->flags & N3ArchiveDirectory)))
+    {
+        return entry;
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const N3ArchiveEntry*
+N3Archive::FindDirEntry(const String& pathInArchive) const
+{
+    const N3ArchiveEntry* entry = this->FindEntry(pathInArchive.AsCharPtr(), pathInArchive.Length());
+    if ((0 != entry) && (0 != (entry->flags & N3ArchiveDirectory)))
+    {
+        return entry;
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Read file data with a positional read, this may be called from
+    several threads at once.
+*/
+bool
+N3Archive::ReadData(const N3ArchiveEntry* entry, void* buf, SizeT numBytes, SizeT offsetInData) const
+{
+    n_assert(0 != entry);
+    n_assert(0 == (entry->flags & N3ArchiveDirectory));
+    n_assert((uint)(offsetInData + numBytes) <= entry->dataSize);
+    if (0 != this->mappedData)
+    {
+        Memory::Copy(this->mappedData + entry->dataOffset + offsetInData, buf, numBytes);
+        return true;
+    }
+    return (numBytes == FSWrapper::ReadAt(this->fileHandle, buf, numBytes, entry->dataOffset + offsetInData));
+}
+
+//------------------------------------------------------------------------------
+/**
+    Test if an absolute path points into the archive and return a local
+    path into the archive. This doesn't check whether the file or directory
+    actually exists in the archive.
+*/
+String
+N3Archive::ConvertToPathInArchive(const String& absPath) const
+{
+    IndexT rootPathIndex = absPath.FindStringIndex(this->rootPath, 0);
+    if (0 == rootPathIndex)
+    {
+        String localPath = absPath;
+        localPath.SubstituteString(this->rootPath, "");
+        return localPath;
+    }
+    // path doesn't point into this archive
+    return "";
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns the position of a file's data in the archive file, or 0 if
+    the file doesn't exist.
+*/
+Stream::Position
+N3Archive::GetFileOffset(const String& pathInArchive) const
+{
+    const N3ArchiveEntry* entry = this->FindFileEntry(pathInArchive);
+    if (0 != entry)
+    {
+        return entry->dataOffset;
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+    List the files in a directory. The children of a directory are stored
+    contiguously, so this doesn't need any lookups besides the directory.
+*/
+Array<String>
+N3Archive::ListFiles(const String& dirPathInArchive, const String& pattern) const
+{
+    Array<String> result;
+    const N3ArchiveEntry* dirEntry = this->FindDirEntry(dirPathInArchive);
+    if (0 != dirEntry)
+    {
+        String fileName;
+        IndexT i;
+        for (i = 0; i < (IndexT)dirEntry->numChildren; i++)
+        {
+            const N3ArchiveEntry& entry = this->entries[dirEntry->firstChild + i];
+            if (0 == (entry.flags & N3ArchiveDirectory))
+            {
+                fileName = this->GetEntryName(&entry);
+                if (String::MatchPattern(fileName, pattern))
+                {
+                    result.Append(fileName);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Array<String>
+N3Archive::ListDirectories(const String& dirPathInArchive, const String& pattern) const
+{
+    Array<String> result;
+    const N3ArchiveEntry* dirEntry = this->FindDirEntry(dirPathInArchive);
+    if (0 != dirEntry)
+    {
+        String subDirName;
+        IndexT i;
+        for (i = 0; i < (IndexT)dirEntry->numChildren; i++)
+        {
+            const N3ArchiveEntry& entry = this->entries[dirEntry->firstChild + i];
+            if (0 != (entry.flags & N3ArchiveDirectory))
+            {
+                subDirName = this->GetEntryName(&entry);
+                if (String::MatchPattern(subDirName, pattern))
+                {
+                    result.Append(subDirName);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Convert a "file:" URI into a "n3a:" URI which points to the file in
+    this archive (see N3FileStream).
+*/
+URI
+N3Archive::ConvertToArchiveURI(const URI& fileURI) const
+{
+    n_assert(fileURI.LocalPath().IsValid());
+
+    // localize path into archive, fail hard if URI doesn't point into archive
+    String localPath = this->ConvertToPathInArchive(fileURI.LocalPath());
+    if (!localPath.IsValid())
+    {
+        n_error("N3Archive::ConvertToArchiveURI(): file '%s' doesn't point into this archive (%s)!\n",
+            fileURI.AsString().AsCharPtr(), this->uri.AsString().AsCharPtr());
+    }
+
+    URI archiveURI = this->uri;
+    archiveURI.SetScheme("n3a");
+    String query;
+    query.Append("file=");
+    query.Append(localPath);
+    archiveURI.SetQuery(query);
+    return archiveURI;
+}
+
+} // namespace IO
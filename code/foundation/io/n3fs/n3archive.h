@@ -0,0 +1,139 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class IO::N3Archive
+
+    A mounted Nebula3 archive (.n3a), see n3archiveformat.h for the
+    file format.
+
+    Setup() memory maps the entire archive and uses the directory block
+    in place, so mounting doesn't depend on the number of files in the
+    archive. Files are found through a perfect hash table over their full
+    paths, FindEntry() neither allocates memory nor takes a lock. If the
+    archive can't be memory mapped, only the directory block is read into
+    memory, and file data is read with positional reads.
+
+    All methods are thread-safe after Setup().
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "io/archfs/archivebase.h"
+#include "io/fswrapper.h"
+#include "io/n3fs/n3archiveformat.h"
+
+//------------------------------------------------------------------------------
+namespace IO
+{
+class N3Archive : public ArchiveBase
+{
+    __DeclareClass(N3Archive);
+public:
+    /// constructor
+    N3Archive();
+    /// destructor
+    virtual ~N3Archive();
+
+    /// setup the archive from an URI (without file extension)
+    bool Setup(const URI& uri);
+    /// discard the archive
+    void Discard();
+
+    /// list all files in a directory in the archive
+    Util::Array<Util::String> ListFiles(const Util::String& dirPathInArchive, const Util::String& pattern) const;
+    /// list all subdirectories in a directory in the archive
+    Util::Array<Util::String> ListDirectories(const Util::String& dirPathInArchive, const Util::String& pattern) const;
+    /// convert a "file:" URI into a "n3a:" URI pointing into this archive
+    URI ConvertToArchiveURI(const URI& fileURI) const;
+    /// convert an absolute path to local path inside archive, returns empty string if absPath doesn't point into this archive
+    Util::String ConvertToPathInArchive(const Util::String& absPath) const;
+    /// get position of a file's data in the archive file (only used to order reads)
+    Stream::Position GetFileOffset(const Util::String& pathInArchive) const;
+
+    /// find a file or directory entry by its path in the archive, return 0 if not exists
+    const N3ArchiveEntry* FindEntry(const char* pathInArchive, SizeT length) const;
+    /// find a file entry, return 0 if not exists
+    const N3ArchiveEntry* FindFileEntry(const Util::String& pathInArchive) const;
+    /// find a directory entry, return 0 if not exists
+    const N3ArchiveEntry* FindDirEntry(const Util::String& pathInArchive) const;
+    /// get the full path of an entry
+    const char* GetEntryPath(const N3ArchiveEntry* entry) const;
+    /// get the file or directory name of an entry
+    const char* GetEntryName(const N3ArchiveEntry* entry) const;
+    /// get the number of entries (files and directories)
+    SizeT GetNumEntries() const;
+
+    /// return true if the archive is memory mapped
+    bool IsMapped() const;
+    /// get pointer to the data of a file entry, only if the archive is memory mapped
+    const uchar* GetMappedData(const N3ArchiveEntry* entry) const;
+    /// read data of a file entry with a positional read
+    bool ReadData(const N3ArchiveEntry* entry, void* buf, SizeT numBytes, SizeT offsetInData) const;
+
+private:
+    /// setup pointers into the directory block, return false if the directory is invalid
+    bool SetupDirectory(const uchar* directory, SizeT archiveSize);
+
+    Util::String rootPath;              // location of the archive file
+    FSWrapper::Handle fileHandle;
+    uchar* mappedData;                  // the memory mapped archive
+    Stream::Size mappedSize;
+    uchar* directoryBuffer;             // directory block, if archive isn't memory mapped
+    const N3ArchiveHeader* header;
+    const N3ArchiveEntry* entries;
+    const uint* bucketSeeds;
+    const uint* slots;
+    const char* stringPool;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const char*
+N3Archive::GetEntryPath(const N3ArchiveEntry* entry) const
+{
+    n_assert(0 != entry);
+    return this->stringPool + entry->pathOffset;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const char*
+N3Archive::GetEntryName(const N3ArchiveEntry* entry) const
+{
+    n_assert(0 != entry);
+    return this->stringPool + entry->nameOffset;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+N3Archive::GetNumEntries() const
+{
+    n_assert(0 != this->header);
+    return this->header->numEntries;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+N3Archive::IsMapped() const
+{
+    return (0 != this->mappedData);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const uchar*
+N3Archive::GetMappedData(const N3ArchiveEntry* entry) const
+{
+    n_assert(0 != this->mappedData);
+    n_assert(0 == (entry->flags & N3ArchiveDirectory));
+    return this->mappedData + entry->dataOffset;
+}
+
+} // namespace IO
+//------------------------------------------------------------------------------
@@ -0,0 +1,134 @@
+//------------------------------------------------------------------------------
+//  n3archivefilesystem.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "io/n3fs/n3archivefilesystem.h"
+#include "io/n3fs/n3archive.h"
+#include "io/n3fs/n3filestream.h"
+#include "io/ioserver.h"
+#include "io/archfs/archive.h"
+
+namespace IO
+{
+__ImplementClass(IO::N3ArchiveFileSystem, 'N3FS', IO::ArchiveFileSystemBase);
+__ImplementInterfaceSingleton(IO::N3ArchiveFileSystem);
+
+using namespace Util;
+
+//------------------------------------------------------------------------------
+/**
+*/
+N3ArchiveFileSystem::N3ArchiveFileSystem()
+{
+    __ConstructInterfaceSingleton;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+N3ArchiveFileSystem::~N3ArchiveFileSystem()
+{
+    if (this->IsValid())
+    {
+        this->Discard();
+    }
+    __DestructInterfaceSingleton;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Setup the N3ArchiveFileSystem. Registers the N3FileStream class.
+*/
+void
+N3ArchiveFileSystem::Setup()
+{
+    n_assert(!this->IsValid());
+    ArchiveFileSystemBase::Setup();
+    SchemeRegistry::Instance()->RegisterUriScheme("n3a", N3FileStream::RTTI);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+N3ArchiveFileSystem::Discard()
+{
+    n_assert(this->IsValid());
+    SchemeRegistry::Instance()->UnregisterUriScheme("n3a");
+    ArchiveFileSystemBase::Discard();
+}
+
+//------------------------------------------------------------------------------
+/**
+    This method takes a normal file URI and checks if the local path
+    of the URI is contained as file entry in any mounted archive. If yes
+    ptr to the archive is returned, otherwise a 0 pointer. If the same 
+    path resides in several archives, the first archive in alphabetical
+    order which contains the file is returned.
+*/
+Ptr<Archive>
+N3ArchiveFileSystem::FindArchiveWithFile(const URI& uri) const
+{
+    // get the local path from the URI
+    String localPath = AssignRegistry::Instance()->ResolveAssigns(uri).LocalPath();
+    n_assert(localPath.IsValid());
+
+    // check each mounted archive
+    Ptr<N3Archive> result;
+    this->critSect.Enter();
+    IndexT i;
+    for (i = 0; i < this->archives.Size(); i++)
+    {
+        const Ptr<N3Archive>& arch = this->archives.ValueAtIndex(i).cast<N3Archive>();
+        String pathInArchive = arch->ConvertToPathInArchive(localPath);
+        if (pathInArchive.IsValid())
+        {
+            if (0 != arch->FindFileEntry(pathInArchive))
+            {
+                result = arch;
+                break;
+            }
+        }
+    }
+    this->critSect.Leave(); 
+
+    // result may be invalid pointer at this point
+    return result.cast<Archive>();
+}
+
+//------------------------------------------------------------------------------
+/**
+    Same as FindArchiveWithFile(), but checks for a directory entry.
+*/
+Ptr<Archive>
+N3ArchiveFileSystem::FindArchiveWithDir(const URI& uri) const
+{
+    // get the local path from the URI
+    String localPath = AssignRegistry::Instance()->ResolveAssigns(uri).LocalPath();
+    n_assert(localPath.IsValid());
+
+    // check each mounted archive
+    Ptr<N3Archive> result;
+    this->critSect.Enter();
+    IndexT i;
+    for (i = 0; i < this->archives.Size(); i++)
+    {
+        const Ptr<N3Archive>& arch = this->archives.ValueAtIndex(i).cast<N3Archive>();
+        String pathInArchive = arch->ConvertToPathInArchive(localPath);
+        if (pathInArchive.IsValid())
+        {
+            if (0 != arch->FindDirEntry(pathInArchive))
+            {
+                result = arch;
+                break;
+            }
+        }
+    }
+    this->critSect.Leave(); 
+
+    // result may be invalid pointer at this point
+    return result.cast<Archive>();
+}
+
+} // namespace IO
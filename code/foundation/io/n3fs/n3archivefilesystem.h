@@ -0,0 +1,40 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class IO::N3ArchiveFileSystem
+
+    An archive filesystem wrapper for Nebula3 archives (.n3a), see 
+    N3Archive. Registers the N3FileStream class for the "n3a" URI scheme.
+    Selected as IO::ArchiveFileSystem if NEBULA3_USE_N3ARCHIVES is enabled
+    in core/config.h.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "io/archfs/archivefilesystembase.h"
+
+//------------------------------------------------------------------------------
+namespace IO
+{
+class N3ArchiveFileSystem : public ArchiveFileSystemBase
+{
+    __DeclareClass(N3ArchiveFileSystem);
+    __DeclareInterfaceSingleton(N3ArchiveFileSystem);
+public:
+    /// constructor
+    N3ArchiveFileSystem();
+    /// destructor
+    virtual ~N3ArchiveFileSystem();
+
+    /// setup the archive file system
+    void Setup();
+    /// discard the archive file system
+    void Discard();
+
+    /// find first archive which contains the file path
+    Ptr<Archive> FindArchiveWithFile(const URI& fileUri) const;
+    /// find first archive which contains the directory path
+    Ptr<Archive> FindArchiveWithDir(const URI& dirUri) const;
+};
+
+} // namespace IO
+//------------------------------------------------------------------------------
@@ -0,0 +1,167 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @file io/n3fs/n3archiveformat.h
+
+    File format of Nebula3 archives (.n3a), see N3Archive and N3ArchiveWriter.
+
+    An archive consists of a directory block, followed by the file data:
+
+    - N3ArchiveHeader
+    - N3ArchiveEntry[numEntries]: all directories and files, entry 0 is
+      the root directory, the children of a directory are stored
+      contiguously (breadth first order), so that a directory can be
+      listed without any lookups
+    - uint bucketSeeds[numBuckets], uint slots[numSlots]: a perfect hash
+      table over the full paths of all entries ("hash and displace"), a
+      path is hashed with seed 0 to find its bucket, and then with the
+      bucket's seed to find its slot, every slot contains an entry index
+      or N3ArchiveInvalidEntry
+    - the string pool: full path of every entry ('/' separated, no leading
+      or trailing slash), 0-terminated
+    - file data, every file starts at a N3ArchiveDataAlignment boundary,
+      and is either stored as is or block-compressed (see ZipBlockCodec)
+
+    All values are stored in the byte order of the target platform, so that
+    the directory block can be used directly from a memory mapped archive.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+
+//------------------------------------------------------------------------------
+namespace IO
+{
+/// magic number of Nebula3 archives ('N3AR')
+static const uint N3ArchiveMagic = 0x4e334152;
+/// current version of the archive format
+static const uint N3ArchiveVersion = 1;
+/// alignment of file data in the archive
+static const uint N3ArchiveDataAlignment = 16;
+/// an empty hash table slot
+static const uint N3ArchiveInvalidEntry = 0xffffffff;
+
+/// archive header
+struct N3ArchiveHeader
+{
+    uint magic;
+    uint version;
+    uint numEntries;
+    uint numBuckets;            // power of 2
+    uint numSlots;              // power of 2
+    uint stringPoolSize;
+    uint directorySize;         // size of the directory block in bytes
+    uint reserved;
+};
+
+/// entry flags
+enum N3ArchiveEntryFlags
+{
+    N3ArchiveDirectory = (1<<0),        // entry is a directory
+    N3ArchiveBlockCompressed = (1<<1),  // file data is block-compressed
+};
+
+/// a file or directory entry
+struct N3ArchiveEntry
+{
+    uint pathOffset;            // offset of the full path in the string pool
+    uint pathLength;            // length of the full path
+    uint nameOffset;            // offset of the file name in the string pool
+    uint flags;                 // N3ArchiveEntryFlags
+    uint parentEntry;           // index of the parent directory entry
+    uint firstChild;            // directories: index of first child entry
+    uint numChildren;           // directories: number of child entries
+    uint dataOffset;            // files: offset of the file data in the archive
+    uint dataSize;              // files: size of the file data in the archive
+    uint fileSize;              // files: uncompressed file size
+    uint reserved[2];
+};
+
+//------------------------------------------------------------------------------
+/**
+    Return true if a character is a path separator.
+*/
+inline bool
+N3ArchiveIsSeparator(char c)
+{
+    return ('/' == c) || ('\\' == c);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Strip leading and trailing separators from a path, returns the
+    start and length of the remaining path. Doesn't allocate.
+*/
+inline void
+N3ArchiveTrimPath(const char* path, SizeT length, const char*& outStart, SizeT& outLength)
+{
+    while ((length > 0) && N3ArchiveIsSeparator(path[0]))
+    {
+        path++;
+        length--;
+    }
+    while ((length > 0) && N3ArchiveIsSeparator(path[length - 1]))
+    {
+        length--;
+    }
+    outStart = path;
+    outLength = length;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Hash a path for the perfect hash table, backslashes are
+    hashed as slashes (FNV-1a with a final avalanche step).
+*/
+inline uint
+N3ArchiveHashPath(const char* path, SizeT length, uint seed)
+{
+    uint hash = 2166136261U ^ (seed * 0x9e3779b9);
+    IndexT i;
+    for (i = 0; i < length; i++)
+    {
+        char c = path[i];
+        if ('\\' == c)
+        {
+            c = '/';
+        }
+        hash = (hash ^ uchar(c)) * 16777619U;
+    }
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Compare a (trimmed) path with a path from the string pool, backslashes
+    match slashes.
+*/
+inline bool
+N3ArchivePathEqual(const char* path, SizeT length, const char* poolPath, SizeT poolLength)
+{
+    if (length != poolLength)
+    {
+        return false;
+    }
+    IndexT i;
+    for (i = 0; i < length; i++)
+    {
+        char c = path[i];
+        if ('\\' == c)
+        {
+            c = '/';
+        }
+        if (c != poolPath[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace IO
+//------------------------------------------------------------------------------
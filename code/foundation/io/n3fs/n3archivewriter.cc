@@ -0,0 +1,480 @@
+//------------------------------------------------------------------------------
+//  n3archivewriter.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "io/n3fs/n3archivewriter.h"
+#include "io/zipfs/zipblockcodec.h"
+#include "io/ioserver.h"
+#include "io/memorystream.h"
+#include "util/dictionary.h"
+#include "util/keyvaluepair.h"
+
+namespace IO
+{
+using namespace Util;
+using namespace System;
+
+// max number of seeds tried for a hash bucket before the table is grown
+static const uint N3ArchiveMaxBucketSeed = 1 << 16;
+
+//------------------------------------------------------------------------------
+/**
+*/
+N3ArchiveWriter::N3ArchiveWriter() :
+    byteOrder(ByteOrder::LittleEndian),
+    blockSize(ZipBlockCodec::DefaultBlockSize)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+N3ArchiveWriter::SetByteOrder(ByteOrder::Type order)
+{
+    this->byteOrder = order;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+N3ArchiveWriter::SetBlockSize(SizeT size)
+{
+    n_assert(size > 0);
+    this->blockSize = size;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Add a file, pathInArchive is the '/' separated path of the file in
+    the archive, without leading slash.
+*/
+void
+N3ArchiveWriter::AddFile(const String& pathInArchive, const URI& srcUri, bool compress)
+{
+    n_assert(pathInArchive.IsValid());
+    File file;
+    file.path = pathInArchive;
+    file.path.ConvertBackslashes();
+    file.path.Trim("/");
+    file.srcUri = srcUri;
+    file.compress = compress;
+    this->files.Append(file);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Write a uint in the byte order of the target platform, and advance
+    the pointer.
+*/
+void
+N3ArchiveWriter::WriteUInt(uchar*& ptr, uint val) const
+{
+    if (ByteOrder::LittleEndian == this->byteOrder)
+    {
+        ptr[0] = uchar(val & 0xff);
+        ptr[1] = uchar((val >> 8) & 0xff);
+        ptr[2] = uchar((val >> 16) & 0xff);
+        ptr[3] = uchar((val >> 24) & 0xff);
+    }
+    else
+    {
+        ptr[0] = uchar((val >> 24) & 0xff);
+        ptr[1] = uchar((val >> 16) & 0xff);
+        ptr[2] = uchar((val >> 8) & 0xff);
+        ptr[3] = uchar(val & 0xff);
+    }
+    ptr += 4;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+N3ArchiveWriter::WritePadding(const Ptr<Stream>& stream) const
+{
+    static const uchar zeros[N3ArchiveDataAlignment] = { 0 };
+    SizeT pos = stream->GetPosition();
+    SizeT padding = (N3ArchiveDataAlignment - (pos % N3ArchiveDataAlignment)) % N3ArchiveDataAlignment;
+    if (padding > 0)
+    {
+        stream->Write(zeros, padding);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Build the directory tree from the file paths, and sort the nodes
+    into breadth-first order, so that the children of each directory
+    are contiguous (sorted by name). Node 0 is the root directory.
+*/
+void
+N3ArchiveWriter::BuildTree(Array<Node>& outNodes, Array<IndexT>& outOrder) const
+{
+    outNodes.Clear();
+    outOrder.Clear();
+    Node rootNode;
+    rootNode.isDirectory = true;
+    rootNode.fileIndex = InvalidIndex;
+    outNodes.Append(rootNode);
+
+    Dictionary<String, IndexT> dirNodes;
+    Array<String> tokens;
+    IndexT fileIndex;
+    for (fileIndex = 0; fileIndex < this->files.Size(); fileIndex++)
+    {
+        const File& file = this->files[fileIndex];
+        file.path.Tokenize("/", tokens);
+        n_assert(tokens.Size() > 0);
+
+        // find or create the directory nodes
+        IndexT parentIndex = 0;
+        String path;
+        IndexT tokenIndex;
+        for (tokenIndex = 0; tokenIndex < tokens.Size() - 1; tokenIndex++)
+        {
+            if (path.IsValid())
+            {
+                path.Append("/");
+            }
+            path.Append(tokens[tokenIndex]);
+            IndexT dictIndex = dirNodes.FindIndex(path);
+            if (InvalidIndex == dictIndex)
+            {
+                Node dirNode;
+                dirNode.path = path;
+                dirNode.name = tokens[tokenIndex];
+                dirNode.isDirectory = true;
+                dirNode.fileIndex = InvalidIndex;
+                outNodes.Append(dirNode);
+                outNodes[parentIndex].children.Append(outNodes.Size() - 1);
+                parentIndex = outNodes.Size() - 1;
+                dirNodes.Add(path, parentIndex);
+            }
+            else
+            {
+                parentIndex = dirNodes.ValueAtIndex(dictIndex);
+            }
+        }
+
+        // add the file node
+        Node fileNode;
+        fileNode.path = file.path;
+        fileNode.name = tokens.Back();
+        fileNode.isDirectory = false;
+        fileNode.fileIndex = fileIndex;
+        outNodes.Append(fileNode);
+        outNodes[parentIndex].children.Append(outNodes.Size() - 1);
+    }
+
+    // breadth-first order, children sorted by name
+    outOrder.Reserve(outNodes.Size());
+    outOrder.Append(0);
+    Array<KeyValuePair<String, IndexT> > sortedChildren;
+    IndexT i;
+    for (i = 0; i < outOrder.Size(); i++)
+    {
+        Node& node = outNodes[outOrder[i]];
+        sortedChildren.Clear();
+        IndexT childIndex;
+        for (childIndex = 0; childIndex < node.children.Size(); childIndex++)
+        {
+            IndexT child = node.children[childIndex];
+            sortedChildren.Append(KeyValuePair<String, IndexT>(outNodes[child].name, child));
+        }
+        sortedChildren.Sort();
+        for (childIndex = 0; childIndex < sortedChildren.Size(); childIndex++)
+        {
+            node.children[childIndex] = sortedChildren[childIndex].Value();
+            outOrder.Append(sortedChildren[childIndex].Value());
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Compute the perfect hash table ("hash and displace"). Paths are
+    distributed into buckets with hash seed 0, then for each bucket (largest
+    first) a seed is searched which maps all paths of the bucket to free
+    slots. The table is grown if no seed can be found for a bucket.
+    Path 0 (the root directory) isn't added to the table.
+*/
+void
+N3ArchiveWriter::BuildHashTable(const Array<String>& paths, uint& outNumBuckets, Array<uint>& outBucketSeeds, Array<uint>& outSlots) const
+{
+    SizeT numKeys = paths.Size() - 1;
+    uint numBuckets = 1;
+    while (numBuckets < uint(numKeys / 4))
+    {
+        numBuckets <<= 1;
+    }
+    uint numSlots = 1;
+    while (numSlots < uint(numKeys + numKeys / 4))
+    {
+        numSlots <<= 1;
+    }
+
+    // distribute keys into buckets
+    Array<Array<IndexT> > buckets;
+    buckets.Fill(0, numBuckets, Array<IndexT>());
+    IndexT keyIndex;
+    for (keyIndex = 1; keyIndex < paths.Size(); keyIndex++)
+    {
+        const String& path = paths[keyIndex];
+        uint bucket = N3ArchiveHashPath(path.AsCharPtr(), path.Length(), 0) & (numBuckets - 1);
+        buckets[bucket].Append(keyIndex);
+    }
+
+    // sort buckets by size, largest first
+    Array<KeyValuePair<IndexT, IndexT> > bucketOrder;
+    bucketOrder.Reserve(numBuckets);
+    IndexT bucketIndex;
+    for (bucketIndex = 0; bucketIndex < (IndexT)numBuckets; bucketIndex++)
+    {
+        if (buckets[bucketIndex].Size() > 0)
+        {
+            bucketOrder.Append(KeyValuePair<IndexT, IndexT>(-buckets[bucketIndex].Size(), bucketIndex));
+        }
+    }
+    bucketOrder.Sort();
+
+    bool success = false;
+    Array<uint> bucketSlots;
+    while (!success)
+    {
+        outBucketSeeds.Clear();
+        outBucketSeeds.Fill(0, numBuckets, 0);
+        outSlots.Clear();
+        outSlots.Fill(0, numSlots, N3ArchiveInvalidEntry);
+        success = true;
+        IndexT orderIndex;
+        for (orderIndex = 0; success && (orderIndex < bucketOrder.Size()); orderIndex++)
+        {
+            const Array<IndexT>& bucket = buckets[bucketOrder[orderIndex].Value()];
+            uint seed;
+            bool placed = false;
+            for (seed = 1; (seed < N3ArchiveMaxBucketSeed) && !placed; seed++)
+            {
+                // check whether all keys of the bucket map to distinct free slots
+                bucketSlots.Clear();
+                placed = true;
+                IndexT i;
+                for (i = 0; placed && (i < bucket.Size()); i++)
+                {
+                    const String& path = paths[bucket[i]];
+                    uint slot = N3ArchiveHashPath(path.AsCharPtr(), path.Length(), seed) & (numSlots - 1);
+                    placed = (N3ArchiveInvalidEntry == outSlots[slot]) && (InvalidIndex == bucketSlots.FindIndex(slot));
+                    bucketSlots.Append(slot);
+                }
+                if (placed)
+                {
+                    for (i = 0; i < bucket.Size(); i++)
+                    {
+                        outSlots[bucketSlots[i]] = bucket[i];
+                    }
+                    outBucketSeeds[bucketOrder[orderIndex].Value()] = seed;
+                }
+            }
+            success = placed;
+        }
+        if (!success)
+        {
+            // grow the table and try again, this only fails for duplicate paths
+            numSlots <<= 1;
+            if (numSlots > uint(64 * paths.Size()))
+            {
+                n_error("N3ArchiveWriter: failed to build hash table, duplicate paths in archive?\n");
+            }
+        }
+    }
+    outNumBuckets = numBuckets;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Write the archive. The file data is written first behind a placeholder
+    for the directory block, then the directory block is written to the
+    start of the archive file.
+*/
+bool
+N3ArchiveWriter::Write(const URI& dstUri)
+{
+    IoServer* ioServer = IoServer::Instance();
+
+    // build the directory tree and the perfect hash table
+    Array<Node> nodes;
+    Array<IndexT> order;
+    this->BuildTree(nodes, order);
+    SizeT numEntries = order.Size();
+    FixedArray<IndexT> entryIndices(nodes.Size());
+    Array<String> paths;
+    paths.Reserve(numEntries);
+    SizeT stringPoolSize = 0;
+    IndexT i;
+    for (i = 0; i < numEntries; i++)
+    {
+        entryIndices[order[i]] = i;
+        paths.Append(nodes[order[i]].path);
+        stringPoolSize += nodes[order[i]].path.Length() + 1;
+    }
+    uint numBuckets = 0;
+    Array<uint> bucketSeeds;
+    Array<uint> slots;
+    this->BuildHashTable(paths, numBuckets, bucketSeeds, slots);
+    SizeT directorySize = sizeof(N3ArchiveHeader) + numEntries * sizeof(N3ArchiveEntry) +
+                          (bucketSeeds.Size() + slots.Size()) * sizeof(uint) + stringPoolSize;
+
+    // entries, the file data offsets are filled in below
+    Array<N3ArchiveEntry> entries;
+    entries.Reserve(numEntries);
+    uint stringPoolOffset = 0;
+    for (i = 0; i < numEntries; i++)
+    {
+        const Node& node = nodes[order[i]];
+        N3ArchiveEntry entry;
+        Memory::Clear(&entry, sizeof(entry));
+        entry.pathOffset = stringPoolOffset;
+        entry.pathLength = node.path.Length();
+        entry.nameOffset = stringPoolOffset + node.path.Length() - node.name.Length();
+        entry.flags = node.isDirectory ? N3ArchiveDirectory : 0;
+        entry.parentEntry = 0;
+        if (node.isDirectory)
+        {
+            entry.numChildren = node.children.Size();
+            entry.firstChild = (node.children.Size() > 0) ? entryIndices[node.children[0]] : 0;
+        }
+        entries.Append(entry);
+        stringPoolOffset += node.path.Length() + 1;
+    }
+    for (i = 0; i < numEntries; i++)
+    {
+        IndexT childIndex;
+        for (childIndex = 0; childIndex < (IndexT)entries[i].numChildren; childIndex++)
+        {
+            entries[entries[i].firstChild + childIndex].parentEntry = i;
+        }
+    }
+
+    // open the destination file and write a placeholder for the directory block
+    Ptr<Stream> stream = ioServer->CreateStream(dstUri);
+    stream->SetAccessMode(Stream::WriteAccess);
+    if (!stream->Open())
+    {
+        n_printf("N3ArchiveWriter: failed to open '%s'!\n", dstUri.AsString().AsCharPtr());
+        return false;
+    }
+    uchar* directory = (uchar*) Memory::Alloc(Memory::ScratchHeap, directorySize);
+    Memory::Clear(directory, directorySize);
+    stream->Write(directory, directorySize);
+
+    // write the file data
+    bool success = true;
+    Ptr<MemoryStream> compressedStream = MemoryStream::Create();
+    for (i = 0; success && (i < numEntries); i++)
+    {
+        const Node& node = nodes[order[i]];
+        if (node.isDirectory)
+        {
+            continue;
+        }
+        const File& file = this->files[node.fileIndex];
+        N3ArchiveEntry& entry = entries[i];
+        Ptr<Stream> srcStream = ioServer->CreateStream(file.srcUri);
+        srcStream->SetAccessMode(Stream::ReadAccess);
+        if (!srcStream->Open())
+        {
+            n_printf("N3ArchiveWriter: failed to open '%s'!\n", file.srcUri.AsString().AsCharPtr());
+            success = false;
+            break;
+        }
+        SizeT srcSize = srcStream->GetSize();
+        const void* srcData = (srcSize > 0) ? srcStream->Map() : 0;
+        const void* data = srcData;
+        SizeT dataSize = srcSize;
+        if (file.compress && (srcSize > 0))
+        {
+            // block-compress, keep the result only if it's smaller
+            compressedStream->SetAccessMode(Stream::WriteAccess);
+            compressedStream->Open();
+            if (ZipBlockCodec::Encode(srcData, srcSize, compressedStream.upcast<Stream>(), this->blockSize) &&
+                (compressedStream->GetSize() < srcSize))
+            {
+                data = compressedStream->GetRawPointer();
+                dataSize = compressedStream->GetSize();
+                entry.flags |= N3ArchiveBlockCompressed;
+            }
+        }
+        this->WritePadding(stream);
+        entry.dataOffset = stream->GetPosition();
+        entry.dataSize = dataSize;
+        entry.fileSize = srcSize;
+        if (dataSize > 0)
+        {
+            stream->Write(data, dataSize);
+        }
+        if (compressedStream->IsOpen())
+        {
+            compressedStream->Close();
+        }
+        if (srcSize > 0)
+        {
+            srcStream->Unmap();
+        }
+        srcStream->Close();
+    }
+
+    if (success)
+    {
+        // fill the directory block in target byte order
+        uchar* ptr = directory;
+        this->WriteUInt(ptr, N3ArchiveMagic);
+        this->WriteUInt(ptr, N3ArchiveVersion);
+        this->WriteUInt(ptr, numEntries);
+        this->WriteUInt(ptr, numBuckets);
+        this->WriteUInt(ptr, slots.Size());
+        this->WriteUInt(ptr, stringPoolSize);
+        this->WriteUInt(ptr, directorySize);
+        this->WriteUInt(ptr, 0);
+        for (i = 0; i < numEntries; i++)
+        {
+            const N3ArchiveEntry& entry = entries[i];
+            this->WriteUInt(ptr, entry.pathOffset);
+            this->WriteUInt(ptr, entry.pathLength);
+            this->WriteUInt(ptr, entry.nameOffset);
+            this->WriteUInt(ptr, entry.flags);
+            this->WriteUInt(ptr, entry.parentEntry);
+            this->WriteUInt(ptr, entry.firstChild);
+            this->WriteUInt(ptr, entry.numChildren);
+            this->WriteUInt(ptr, entry.dataOffset);
+            this->WriteUInt(ptr, entry.dataSize);
+            this->WriteUInt(ptr, entry.fileSize);
+            this->WriteUInt(ptr, 0);
+            this->WriteUInt(ptr, 0);
+        }
+        for (i = 0; i < bucketSeeds.Size(); i++)
+        {
+            this->WriteUInt(ptr, bucketSeeds[i]);
+        }
+        for (i = 0; i < slots.Size(); i++)
+        {
+            // slots contain path indices, which are the entry indices
+            this->WriteUInt(ptr, slots[i]);
+        }
+        for (i = 0; i < numEntries; i++)
+        {
+            Memory::Copy(paths[i].AsCharPtr(), ptr, paths[i].Length() + 1);
+            ptr += paths[i].Length() + 1;
+        }
+        n_assert(ptr == directory + directorySize);
+        stream->Seek(0, Stream::Begin);
+        stream->Write(directory, directorySize);
+    }
+    stream->Close();
+    Memory::Free(Memory::ScratchHeap, directory);
+    return success;
+}
+
+} // namespace IO
@@ -0,0 +1,88 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class IO::N3ArchiveWriter
+
+    Writes a Nebula3 archive (.n3a) from a list of files, see
+    n3archiveformat.h for the file format. Used by the archiver3 tool.
+
+    Files which are added with compression enabled are block-compressed
+    (see ZipBlockCodec), unless compression doesn't make them smaller.
+    The directory block is written in the byte order of the target
+    platform, and contains a perfect hash table over all paths, which is
+    computed here, so that mounting an archive doesn't need to build
+    any lookup structures.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+#include "io/uri.h"
+#include "io/stream.h"
+#include "io/n3fs/n3archiveformat.h"
+#include "system/byteorder.h"
+#include "util/array.h"
+#include "util/fixedarray.h"
+
+//------------------------------------------------------------------------------
+namespace IO
+{
+class N3ArchiveWriter
+{
+public:
+    /// constructor
+    N3ArchiveWriter();
+
+    /// set the byte order of the target platform (default is host byte order)
+    void SetByteOrder(System::ByteOrder::Type byteOrder);
+    /// set the uncompressed block size of compressed files
+    void SetBlockSize(SizeT blockSize);
+    /// add a file to the archive
+    void AddFile(const Util::String& pathInArchive, const URI& srcUri, bool compress);
+    /// get number of added files
+    SizeT GetNumFiles() const;
+    /// write the archive file
+    bool Write(const URI& dstUri);
+
+private:
+    /// a file or directory during archive construction
+    struct Node
+    {
+        Util::String path;
+        Util::String name;
+        bool isDirectory;
+        IndexT fileIndex;
+        Util::Array<IndexT> children;
+    };
+    /// a file to add
+    struct File
+    {
+        Util::String path;
+        URI srcUri;
+        bool compress;
+    };
+
+    /// build the directory tree, returns entries in breadth-first order
+    void BuildTree(Util::Array<Node>& outNodes, Util::Array<IndexT>& outOrder) const;
+    /// compute the perfect hash table for the entry paths
+    void BuildHashTable(const Util::Array<Util::String>& paths, uint& outNumBuckets, Util::Array<uint>& outBucketSeeds, Util::Array<uint>& outSlots) const;
+    /// write a uint in target byte order
+    void WriteUInt(uchar*& ptr, uint val) const;
+    /// write zeros up to the data alignment
+    void WritePadding(const Ptr<Stream>& stream) const;
+
+    System::ByteOrder::Type byteOrder;
+    SizeT blockSize;
+    Util::Array<File> files;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+N3ArchiveWriter::GetNumFiles() const
+{
+    return this->files.Size();
+}
+
+} // namespace IO
+//------------------------------------------------------------------------------
@@ -0,0 +1,421 @@
+//------------------------------------------------------------------------------
+//  n3filestream.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "io/n3fs/n3filestream.h"
+#include "io/n3fs/n3archive.h"
+#include "io/n3fs/n3archivefilesystem.h"
+#include "io/archfs/archive.h"
+
+namespace IO
+{
+__ImplementClass(IO::N3FileStream, 'N3FT', IO::Stream);
+
+using namespace Util;
+
+//------------------------------------------------------------------------------
+/**
+*/
+N3FileStream::N3FileStream() :
+    entry(0),
+    size(0),
+    position(0),
+    mapBuffer(0),
+    ownsMapBuffer(false),
+    blockCompressed(false),
+    blockBuffer(0),
+    blockBufferIndex(InvalidIndex)
+{
+    Memory::Clear(&this->blockHeader, sizeof(this->blockHeader));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+N3FileStream::~N3FileStream()
+{
+    if (this->IsOpen())
+    {
+        this->Close();
+    }
+    n_assert(!this->mapBuffer);
+    n_assert(!this->blockBuffer);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+N3FileStream::CanRead() const
+{
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+N3FileStream::CanWrite() const
+{
+    return false;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+N3FileStream::CanSeek() const
+{
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+N3FileStream::CanBeMapped() const
+{
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Stream::Size
+N3FileStream::GetSize() const
+{
+    return this->size;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Stream::Position
+N3FileStream::GetPosition() const
+{
+    return this->position;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Open the stream for reading. This only looks up the file entry, no
+    data is read until Read() or Map() is called.
+*/
+bool
+N3FileStream::Open()
+{
+    n_assert(!this->IsOpen());
+    n_assert(!this->mapBuffer);
+    // allow only read access
+    if (ReadAccess == this->accessMode)
+    {
+        if (Stream::Open())
+        {
+            // get the archive which contains the file
+            this->archive = N3ArchiveFileSystem::Instance()->FindArchive(this->uri).cast<N3Archive>();
+            if (this->archive.isvalid())
+            {
+                Dictionary<String,String> params = this->uri.ParseQuery();
+                if (params.Contains("file"))
+                {
+                    this->entry = this->archive->FindFileEntry(params["file"]);
+                    if (0 != this->entry)
+                    {
+                        this->size = this->entry->fileSize;
+                        this->position = 0;
+                        this->blockCompressed = (0 != (this->entry->flags & N3ArchiveBlockCompressed));
+                        if (!this->blockCompressed || this->SetupBlocks())
+                        {
+                            return true;
+                        }
+                        n_printf("N3FileStream: invalid block-compressed file '%s'!\n", this->uri.AsString().AsCharPtr());
+                    }
+                }
+            }
+            // fallthrough: failure
+            this->Close();
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+N3FileStream::Close()
+{
+    n_assert(this->IsOpen());
+    if (this->IsMapped())
+    {
+        this->Unmap();
+    }
+    Stream::Close();
+    if (0 != this->blockBuffer)
+    {
+        Memory::Free(Memory::StreamDataHeap, this->blockBuffer);
+        this->blockBuffer = 0;
+    }
+    this->blockBufferIndex = InvalidIndex;
+    this->blockOffsets.SetSize(0);
+    this->blockCompressed = false;
+    this->entry = 0;
+    this->archive = 0;
+    this->size = 0;
+    this->position = 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Read the header and seek table of a block-compressed file.
+*/
+bool
+N3FileStream::SetupBlocks()
+{
+    n_assert(this->blockCompressed);
+    uchar headerData[ZipBlockCodec::HeaderSize];
+    if (((SizeT)this->entry->dataSize < ZipBlockCodec::HeaderSize) ||
+        !this->archive->ReadData(this->entry, headerData, ZipBlockCodec::HeaderSize, 0) ||
+        !ZipBlockCodec::DecodeHeader(headerData, this->entry->dataSize, this->blockHeader) ||
+        (this->blockHeader.uncompressedSize != this->entry->fileSize))
+    {
+        return false;
+    }
+    SizeT seekTableSize = ZipBlockCodec::GetSeekTableSize(this->blockHeader);
+    bool valid = false;
+    if (this->archive->IsMapped())
+    {
+        const uchar* seekTableData = this->archive->GetMappedData(this->entry) + ZipBlockCodec::HeaderSize;
+        ZipBlockCodec::DecodeSeekTable(seekTableData, this->blockHeader, this->blockOffsets);
+        valid = true;
+    }
+    else
+    {
+        void* seekTableData = Memory::Alloc(Memory::ScratchHeap, seekTableSize);
+        if (this->archive->ReadData(this->entry, seekTableData, seekTableSize, ZipBlockCodec::HeaderSize))
+        {
+            ZipBlockCodec::DecodeSeekTable(seekTableData, this->blockHeader, this->blockOffsets);
+            valid = true;
+        }
+        Memory::Free(Memory::ScratchHeap, seekTableData);
+    }
+    IndexT i;
+    for (i = 0; valid && (i < (IndexT)this->blockHeader.numBlocks); i++)
+    {
+        valid = (this->blockOffsets[i] <= this->blockOffsets[i + 1]);
+    }
+    return valid && (this->blockOffsets[this->blockHeader.numBlocks] <= this->entry->dataSize);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Decompress a single block. In a memory mapped archive, the block is
+    decompressed directly from the mapped archive data.
+*/
+bool
+N3FileStream::DecodeBlock(IndexT blockIndex, void* buf, SizeT bufSize)
+{
+    n_assert(this->blockCompressed);
+    uint blockOffset = this->blockOffsets[blockIndex];
+    SizeT compressedBlockSize = this->blockOffsets[blockIndex + 1] - blockOffset;
+    if (this->archive->IsMapped())
+    {
+        const uchar* compressedData = this->archive->GetMappedData(this->entry) + blockOffset;
+        return ZipBlockCodec::DecodeBlock(compressedData, compressedBlockSize, buf, bufSize);
+    }
+    if (compressedBlockSize == bufSize)
+    {
+        // block is stored uncompressed
+        return this->archive->ReadData(this->entry, buf, bufSize, blockOffset);
+    }
+    bool success = false;
+    void* compressedData = Memory::Alloc(Memory::StreamDataHeap, compressedBlockSize);
+    if (this->archive->ReadData(this->entry, compressedData, compressedBlockSize, blockOffset))
+    {
+        success = ZipBlockCodec::DecodeBlock(compressedData, compressedBlockSize, buf, bufSize);
+    }
+    Memory::Free(Memory::StreamDataHeap, compressedData);
+    return success;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Read from a block-compressed file. Complete blocks are decompressed
+    directly into the destination, a partially read block is decompressed
+    into the block buffer and kept there for the next Read().
+*/
+bool
+N3FileStream::ReadBlocks(void* ptr, Size numBytes)
+{
+    n_assert(this->blockCompressed);
+    unsigned char* dst = (unsigned char*) ptr;
+    SizeT blockSize = this->blockHeader.blockSize;
+    Position pos = this->position;
+    Size bytesLeft = numBytes;
+    while (bytesLeft > 0)
+    {
+        IndexT blockIndex = pos / blockSize;
+        Size blockBytes = ZipBlockCodec::GetUncompressedBlockSize(this->blockHeader, blockIndex);
+        Size offsetInBlock = pos - blockIndex * blockSize;
+        Size copyBytes = Math::n_min(bytesLeft, blockBytes - offsetInBlock);
+        if ((copyBytes == blockBytes) && (blockIndex != this->blockBufferIndex))
+        {
+            if (!this->DecodeBlock(blockIndex, dst, blockBytes))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            if (blockIndex != this->blockBufferIndex)
+            {
+                if (0 == this->blockBuffer)
+                {
+                    this->blockBuffer = (unsigned char*) Memory::Alloc(Memory::StreamDataHeap, blockSize);
+                }
+                this->blockBufferIndex = InvalidIndex;
+                if (!this->DecodeBlock(blockIndex, this->blockBuffer, blockBytes))
+                {
+                    return false;
+                }
+                this->blockBufferIndex = blockIndex;
+            }
+            Memory::Copy(this->blockBuffer + offsetInBlock, dst, copyBytes);
+        }
+        dst += copyBytes;
+        pos += copyBytes;
+        bytesLeft -= copyBytes;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Stream::Size
+N3FileStream::Read(void* ptr, Size numBytes)
+{
+    n_assert(ptr);
+    n_assert(this->IsOpen());
+    n_assert(!this->IsMapped());
+    n_assert((this->position >= 0) && (this->position <= this->size));
+
+    // check if end-of-stream is near
+    Size readBytes = Math::n_min(numBytes, this->size - this->position);
+    if (readBytes > 0)
+    {
+        if (this->blockCompressed)
+        {
+            if (!this->ReadBlocks(ptr, readBytes)) return 0;
+        }
+        else
+        {
+            if (!this->archive->ReadData(this->entry, ptr, readBytes, this->position)) return 0;
+        }
+        this->position += readBytes;
+    }
+    return readBytes;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Seeking only moves the read position, the data at the new position
+    is read on the next Read().
+*/
+void
+N3FileStream::Seek(Offset offset, SeekOrigin origin)
+{
+    n_assert(this->IsOpen());
+    n_assert(!this->IsMapped());
+    switch (origin)
+    {
+        case Begin:
+            this->position = offset;
+            break;
+        case Current:
+            this->position += offset;
+            break;
+        case End:
+            this->position = this->size + offset;
+            break;
+        default:
+            n_assert(false);
+    }
+
+    // make sure read/write position doesn't become invalid
+    this->position = Math::n_iclamp(this->position, 0, this->size);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+N3FileStream::Eof() const
+{
+    n_assert(this->IsOpen());
+    n_assert(!this->IsMapped());
+    n_assert((this->position >= 0) && (this->position <= this->size));
+    return (this->position == this->size);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Uncompressed files in a memory mapped archive are returned directly,
+    all other files are read into a new buffer. The mapped data must
+    not be modified!
+*/
+void*
+N3FileStream::Map()
+{
+    n_assert(this->IsOpen());
+    Stream::Map();
+    n_assert(this->GetSize() > 0);
+    n_assert(!this->mapBuffer);
+    if (!this->blockCompressed && this->archive->IsMapped())
+    {
+        this->mapBuffer = const_cast<unsigned char*>(this->archive->GetMappedData(this->entry));
+        this->ownsMapBuffer = false;
+    }
+    else
+    {
+        this->mapBuffer = (unsigned char*) Memory::Alloc(Memory::StreamDataHeap, this->size);
+        this->ownsMapBuffer = true;
+        bool success;
+        if (this->blockCompressed)
+        {
+            Position oldPosition = this->position;
+            this->position = 0;
+            success = this->ReadBlocks(this->mapBuffer, this->size);
+            this->position = oldPosition;
+        }
+        else
+        {
+            success = this->archive->ReadData(this->entry, this->mapBuffer, this->size, 0);
+        }
+        if (!success)
+        {
+            n_error("N3FileStream: failed to read '%s'!\n", this->uri.AsString().AsCharPtr());
+        }
+    }
+    return this->mapBuffer;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+N3FileStream::Unmap()
+{
+    n_assert(this->IsOpen());
+    Stream::Unmap();
+    n_assert(this->mapBuffer);
+    if (this->ownsMapBuffer)
+    {
+        Memory::Free(Memory::StreamDataHeap, this->mapBuffer);
+    }
+    this->mapBuffer = 0;
+    this->ownsMapBuffer = false;
+}
+
+} // namespace IO
@@ -0,0 +1,87 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class IO::N3FileStream
+
+    Wraps a file in a Nebula3 archive (.n3a) into a stream. The URI
+    format is the same as for ZipFileStream:
+
+    n3a://[samba server]/bla/blob/archive?file=path/in/archive
+
+    Files which are stored uncompressed in a memory mapped archive are
+    neither copied nor decompressed, Map() returns a pointer directly into
+    the mapped archive. Block-compressed files are decompressed block by
+    block on Read(), seeking in any direction costs at most one block
+    decompression. Any number of files of the same archive may be open
+    at the same time.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "io/stream.h"
+#include "io/n3fs/n3archiveformat.h"
+#include "io/zipfs/zipblockcodec.h"
+#include "util/fixedarray.h"
+
+//------------------------------------------------------------------------------
+namespace IO
+{
+class N3Archive;
+
+class N3FileStream : public Stream
+{
+    __DeclareClass(N3FileStream);
+public:
+    /// constructor
+    N3FileStream();
+    /// destructor
+    virtual ~N3FileStream();
+    /// supports reading
+    virtual bool CanRead() const;
+    /// doesn't support writing
+    virtual bool CanWrite() const;
+    /// supports seeking
+    virtual bool CanSeek() const;
+    /// is mappable
+    virtual bool CanBeMapped() const;
+    /// get the size of the stream in bytes
+    virtual Size GetSize() const;
+    /// get the current position of the read/write cursor
+    virtual Position GetPosition() const;
+    /// open the stream
+    virtual bool Open();
+    /// close the stream
+    virtual void Close();
+    /// directly read from the stream
+    virtual Size Read(void* ptr, Size numBytes);
+    /// seek in stream
+    virtual void Seek(Offset offset, SeekOrigin origin);
+    /// return true if end-of-stream reached
+    virtual bool Eof() const;
+    /// map for direct memory-access
+    virtual void* Map();
+    /// unmap a mapped stream
+    virtual void Unmap();
+
+private:
+    /// read the header and seek table of a block-compressed file
+    bool SetupBlocks();
+    /// read from a block-compressed file
+    bool ReadBlocks(void* ptr, Size numBytes);
+    /// decompress a single block
+    bool DecodeBlock(IndexT blockIndex, void* buf, SizeT bufSize);
+
+    Ptr<N3Archive> archive;
+    const N3ArchiveEntry* entry;
+    Size size;
+    Position position;
+    unsigned char* mapBuffer;
+    bool ownsMapBuffer;
+    bool blockCompressed;
+    ZipBlockCodec::Header blockHeader;
+    Util::FixedArray<uint> blockOffsets;
+    unsigned char* blockBuffer;         // the last partially read block
+    IndexT blockBufferIndex;
+};
+
+} // namespace IO
+//------------------------------------------------------------------------------
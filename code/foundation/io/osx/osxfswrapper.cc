@@ -49,6 +49,16 @@ OSXFSWrapper::Read(Handle handle, void* buf, Stream::Size numBytes)
     n_error("OSXFSWrapper::Read(): IMPLEMENT ME!\n");
     return 0;
 }
+
+//------------------------------------------------------------------------------
+/**
+*/
+Stream::Size
+OSXFSWrapper::ReadAt(Handle handle, void* buf, Stream::Size numBytes, Stream::Position pos)
+{
+    n_error("OSXFSWrapper::ReadAt(): IMPLEMENT ME!\n");
+    return 0;
+}
     
 //------------------------------------------------------------------------------
 /**
@@ -97,6 +107,26 @@ OSXFSWrapper::GetFileSize(Handle handle)
     n_error("OSXFSWrapper::GetFileSize(): IMPLEMENT ME!\n");
     return 0;
 }
+
+//------------------------------------------------------------------------------
+/**
+    File mapping is not implemented yet, FileStream falls back to 
+    reading the file into memory.
+*/
+void*
+OSXFSWrapper::MapFile(Handle handle, Stream::Size size, Stream::AccessPattern accessPattern)
+{
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+OSXFSWrapper::UnmapFile(void* ptr, Stream::Size size)
+{
+    n_error("OSXFSWrapper::UnmapFile(): IMPLEMENT ME!\n");
+}
     
 //------------------------------------------------------------------------------
 /**
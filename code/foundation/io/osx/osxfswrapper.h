@@ -29,6 +29,8 @@ public:
     static void Write(Handle h, const void* buf, IO::Stream::Size numBytes);
     /// read from a file
     static IO::Stream::Size Read(Handle h, void* buf, IO::Stream::Size numBytes);
+    /// read from a file at an absolute position without moving the file pointer of other readers (thread-safe)
+    static IO::Stream::Size ReadAt(Handle h, void* buf, IO::Stream::Size numBytes, IO::Stream::Position pos);
     /// seek in a file
     static void Seek(Handle h, IO::Stream::Offset offset, IO::Stream::SeekOrigin orig);
     /// get position in file
@@ -39,6 +41,10 @@ public:
     static bool Eof(Handle h);
     /// get size of a file in bytes
     static IO::Stream::Size GetFileSize(Handle h);
+    /// map a file opened for read access into memory, returns 0 if not supported
+    static void* MapFile(Handle h, IO::Stream::Size size, IO::Stream::AccessPattern accessPattern);
+    /// unmap a file mapped with MapFile()
+    static void UnmapFile(void* ptr, IO::Stream::Size size);
     /// set read-only status of a file
     static void SetReadOnly(const Util::String& path, bool readOnly);
     /// get read-only status of a file
@@ -0,0 +1,88 @@
+//------------------------------------------------------------------------------
+//  posixconsolehandler.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "io/posix/posixconsolehandler.h"
+#include "core/coreserver.h"
+#include "core/sysfunc.h"
+
+namespace Posix
+{
+__ImplementClass(Posix::PosixConsoleHandler, 'PXCH', IO::ConsoleHandler);
+    
+using namespace Util;
+    
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PosixConsoleHandler::Print(const String& s)
+{
+    fputs(s.AsCharPtr(), stdout);
+}
+    
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PosixConsoleHandler::DebugOut(const String& s)
+{
+    fputs(s.AsCharPtr(), stderr);
+}
+    
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PosixConsoleHandler::Error(const String& msg)
+{
+    const char* appName = "???";
+    if (Core::CoreServer::HasInstance())
+    {
+        appName = Core::CoreServer::Instance()->GetAppName().Value();
+    }
+    String str;
+    str.Format("*** ERROR ***\nApplication: %s\nError: %s", appName, msg.AsCharPtr());
+    Core::SysFunc::Error(str.AsCharPtr());
+}
+    
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PosixConsoleHandler::Warning(const String& s)
+{
+    fprintf(stderr, "*** WARNING *** %s", s.AsCharPtr());
+}
+    
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PosixConsoleHandler::Confirm(const String& s)
+{
+    Core::SysFunc::MessageBox(s.AsCharPtr());
+}
+    
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+PosixConsoleHandler::HasInput()
+{
+    // console input not implemented on POSIX platforms
+    return false;
+}
+    
+//------------------------------------------------------------------------------
+/**
+*/
+String
+PosixConsoleHandler::GetInput()
+{
+    // console input not implemented on POSIX platforms
+    return "";
+}
+    
+} // namespace Posix
@@ -0,0 +1,79 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Posix::PosixFileTime
+
+    Wraps file-system related timestamps on POSIX platforms.
+ 
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+
+//------------------------------------------------------------------------------
+namespace Posix
+{
+class PosixFileTime
+{
+public:
+    /// constructor
+    PosixFileTime();
+    /// operator ==
+    friend bool operator==(const PosixFileTime& a, const PosixFileTime& b);
+    /// operator !=
+    friend bool operator!=(const PosixFileTime& a, const PosixFileTime& b);
+    /// operator >
+    friend bool operator>(const PosixFileTime& a, const PosixFileTime& b);
+    /// operator <
+    friend bool operator<(const PosixFileTime& a, const PosixFileTime& b);
+    
+    time_t fileTime;
+};
+    
+//------------------------------------------------------------------------------
+/**
+*/
+inline
+PosixFileTime::PosixFileTime() :
+    fileTime(0)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool 
+operator==(const PosixFileTime& a, const PosixFileTime& b)
+{
+    return (a.fileTime == b.fileTime);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool 
+operator!=(const PosixFileTime& a, const PosixFileTime& b)
+{
+    return (a.fileTime != b.fileTime);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+operator>(const PosixFileTime& a, const PosixFileTime& b)
+{
+    return (a.fileTime > b.fileTime);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+operator<(const PosixFileTime& a, const PosixFileTime& b)
+{
+    return (a.fileTime < b.fileTime);
+}
+    
+} // namespace Posix
+//------------------------------------------------------------------------------
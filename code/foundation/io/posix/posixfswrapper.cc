@@ -0,0 +1,625 @@
+//------------------------------------------------------------------------------
+//  posixfswrapper.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "io/posix/posixfswrapper.h"
+#include <dirent.h>
+#include <fnmatch.h>
+#include <utime.h>
+#include <sys/mman.h>
+
+namespace Posix
+{
+using namespace Util;
+using namespace IO;
+
+//------------------------------------------------------------------------------
+/**
+    The local path of a file URI never contains the leading slash, 
+    put it back in front of the path to get an absolute native path.
+*/
+String
+PosixFSWrapper::NativePath(const String& path)
+{
+    if ((path.Length() > 0) && (path[0] == '/'))
+    {
+        return path;
+    }
+    else
+    {
+        return String("/") + path;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Open a file using fopen(). Returns a handle to the file which must be 
+    passed to the other PosixFSWrapper file methods. If opening the file 
+    fails, the function will return 0. 
+*/
+PosixFSWrapper::Handle
+PosixFSWrapper::OpenFile(const String& path, Stream::AccessMode accessMode, Stream::AccessPattern accessPattern)
+{
+    String nativePath = NativePath(path);
+    Handle handle = 0;
+    switch (accessMode)
+    {
+        case Stream::ReadAccess:
+            handle = fopen(nativePath.AsCharPtr(), "rb");
+            break;
+
+        case Stream::WriteAccess:
+            handle = fopen(nativePath.AsCharPtr(), "wb");
+            break;
+
+        case Stream::ReadWriteAccess:
+        case Stream::AppendAccess:
+            // open existing file, or create it if it doesn't exist
+            handle = fopen(nativePath.AsCharPtr(), "r+b");
+            if (0 == handle)
+            {
+                handle = fopen(nativePath.AsCharPtr(), "w+b");
+            }
+            break;
+    }
+    if (0 != handle)
+    {
+        // give the kernel a read-ahead hint
+        #if defined(POSIX_FADV_SEQUENTIAL)
+        int advice = (Stream::Sequential == accessPattern) ? POSIX_FADV_SEQUENTIAL : POSIX_FADV_RANDOM;
+        posix_fadvise(fileno(handle), 0, 0, advice);
+        #endif
+
+        // in append mode, we need to seek to the end of the file
+        if (Stream::AppendAccess == accessMode)
+        {
+            fseeko(handle, 0, SEEK_END);
+        }
+    }
+    return handle;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Closes a file opened by PosixFSWrapper::OpenFile().
+*/
+void
+PosixFSWrapper::CloseFile(Handle handle)
+{
+    n_assert(0 != handle);
+    fclose(handle);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Write data to a file.
+*/
+void
+PosixFSWrapper::Write(Handle handle, const void* buf, Stream::Size numBytes)
+{
+    n_assert(0 != handle);
+    n_assert(buf != 0);
+    n_assert(numBytes > 0);
+    size_t bytesWritten = fwrite(buf, 1, numBytes, handle);
+    if (bytesWritten != (size_t)numBytes)
+    {
+        n_error("PosixFSWrapper::Write(): fwrite() failed!");
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Read data from a file, returns number of bytes actually read.
+*/
+Stream::Size
+PosixFSWrapper::Read(Handle handle, void* buf, Stream::Size numBytes)
+{
+    n_assert(0 != handle);
+    n_assert(buf != 0);
+    n_assert(numBytes > 0);
+    size_t bytesRead = fread(buf, 1, numBytes, handle);
+    if (ferror(handle))
+    {
+        n_error("PosixFSWrapper::Read(): fread() failed!");
+    }
+    return (Stream::Size) bytesRead;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Read data from an absolute file position with pread(), returns number 
+    of bytes actually read. Several threads may read from the same handle
+    at the same time. Don't mix with Read() and Seek() on the same handle.
+*/
+Stream::Size
+PosixFSWrapper::ReadAt(Handle handle, void* buf, Stream::Size numBytes, Stream::Position pos)
+{
+    n_assert(0 != handle);
+    n_assert(buf != 0);
+    n_assert(numBytes > 0);
+    int fd = fileno(handle);
+    Stream::Size totalBytesRead = 0;
+    while (totalBytesRead < numBytes)
+    {
+        ssize_t bytesRead = pread(fd, (char*)buf + totalBytesRead, numBytes - totalBytesRead, pos + totalBytesRead);
+        if (bytesRead < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            n_error("PosixFSWrapper::ReadAt(): pread() failed!");
+        }
+        if (0 == bytesRead)
+        {
+            break;
+        }
+        totalBytesRead += (Stream::Size) bytesRead;
+    }
+    return totalBytesRead;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Seek in a file.
+*/
+void
+PosixFSWrapper::Seek(Handle handle, Stream::Offset offset, Stream::SeekOrigin orig)
+{
+    n_assert(0 != handle);
+    int whence = SEEK_SET;
+    switch (orig)
+    {
+        case Stream::Begin:
+            whence = SEEK_SET;
+            break;
+        case Stream::Current:
+            whence = SEEK_CUR;
+            break;
+        case Stream::End:
+            whence = SEEK_END;
+            break;
+    }
+    fseeko(handle, (off_t) offset, whence);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Get current position in file.
+*/
+Stream::Position
+PosixFSWrapper::Tell(Handle handle)
+{
+    n_assert(0 != handle);
+    return (Stream::Position) ftello(handle);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Flush unwritten data to disk.
+*/
+void
+PosixFSWrapper::Flush(Handle handle)
+{
+    n_assert(0 != handle);
+    fflush(handle);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns true if current position is at end of file.
+*/
+bool
+PosixFSWrapper::Eof(Handle handle)
+{
+    n_assert(0 != handle);
+    return Tell(handle) >= GetFileSize(handle);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns the size of a file in bytes.
+*/
+Stream::Size
+PosixFSWrapper::GetFileSize(Handle handle)
+{
+    n_assert(0 != handle);
+    fflush(handle);
+    struct stat st;
+    if (0 == fstat(fileno(handle), &st))
+    {
+        return (Stream::Size) st.st_size;
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Map a file into memory with mmap(). The pages are mapped private
+    (copy-on-write), so that they are shared with the page cache as long
+    as they are only read. The access pattern is handed to madvise(),
+    sequentially read files are also prefetched. Returns 0 if the file
+    can't be mapped.
+*/
+void*
+PosixFSWrapper::MapFile(Handle handle, Stream::Size size, Stream::AccessPattern accessPattern)
+{
+    n_assert(0 != handle);
+    n_assert(size > 0);
+    void* ptr = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(handle), 0);
+    if (MAP_FAILED == ptr)
+    {
+        return 0;
+    }
+    if (Stream::Sequential == accessPattern)
+    {
+        madvise(ptr, size, MADV_SEQUENTIAL);
+        madvise(ptr, size, MADV_WILLNEED);
+    }
+    else
+    {
+        madvise(ptr, size, MADV_RANDOM);
+    }
+    return ptr;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Unmap a file mapped with MapFile().
+*/
+void
+PosixFSWrapper::UnmapFile(void* ptr, Stream::Size size)
+{
+    n_assert(0 != ptr);
+    munmap(ptr, size);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Set the read-only status of a file.
+*/
+void
+PosixFSWrapper::SetReadOnly(const String& path, bool readOnly)
+{
+    n_assert(path.IsValid());
+    String nativePath = NativePath(path);
+    struct stat st;
+    if (0 == stat(nativePath.AsCharPtr(), &st))
+    {
+        mode_t mode = st.st_mode;
+        if (readOnly)
+        {
+            mode &= ~(S_IWUSR | S_IWGRP | S_IWOTH);
+        }
+        else
+        {
+            mode |= S_IWUSR;
+        }
+        chmod(nativePath.AsCharPtr(), mode);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Get the read-only status of a file.
+*/
+bool
+PosixFSWrapper::IsReadOnly(const String& path)
+{
+    n_assert(path.IsValid());
+    return 0 != access(NativePath(path).AsCharPtr(), W_OK);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Deletes a file. Returns true if the operation was successful. The delete
+    will fail if the fail doesn't exist or the file is read-only.
+*/
+bool
+PosixFSWrapper::DeleteFile(const String& path)
+{
+    n_assert(path.IsValid());
+    return 0 == unlink(NativePath(path).AsCharPtr());
+}
+
+//------------------------------------------------------------------------------
+/**
+    Delete an empty directory. Returns true if the operation was successful.
+*/
+bool
+PosixFSWrapper::DeleteDirectory(const String& path)
+{
+    n_assert(path.IsValid());
+    return 0 == rmdir(NativePath(path).AsCharPtr());
+}
+
+//------------------------------------------------------------------------------
+/**
+    Return true if a file exists.
+*/
+bool
+PosixFSWrapper::FileExists(const String& path)
+{
+    n_assert(path.IsValid());
+    struct stat st;
+    if (0 == stat(NativePath(path).AsCharPtr(), &st))
+    {
+        return !S_ISDIR(st.st_mode);
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Return true if a directory exists.
+*/
+bool
+PosixFSWrapper::DirectoryExists(const String& path)
+{
+    n_assert(path.IsValid());
+    struct stat st;
+    if (0 == stat(NativePath(path).AsCharPtr(), &st))
+    {
+        return S_ISDIR(st.st_mode);
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Set the write-access time stamp of a file.
+*/
+void
+PosixFSWrapper::SetFileWriteTime(const String& path, FileTime fileTime)
+{
+    n_assert(path.IsValid());
+    String nativePath = NativePath(path);
+    struct stat st;
+    struct utimbuf times;
+    times.actime = fileTime.fileTime;
+    times.modtime = fileTime.fileTime;
+    if (0 == stat(nativePath.AsCharPtr(), &st))
+    {
+        times.actime = st.st_atime;
+    }
+    if (0 != utime(nativePath.AsCharPtr(), &times))
+    {
+        n_error("PosixFSWrapper::SetFileWriteTime(): failed to set time stamp of file '%s'!", path.AsCharPtr());
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Return the last write-access time to a file.
+*/
+FileTime
+PosixFSWrapper::GetFileWriteTime(const String& path)
+{
+    n_assert(path.IsValid());
+    FileTime fileTime;
+    struct stat st;
+    if (0 == stat(NativePath(path).AsCharPtr(), &st))
+    {
+        fileTime.fileTime = st.st_mtime;
+    }
+    return fileTime;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Creates a new directory.
+*/
+bool
+PosixFSWrapper::CreateDirectory(const String& path)
+{
+    n_assert(path.IsValid());
+    if (0 == mkdir(NativePath(path).AsCharPtr(), 0755))
+    {
+        return true;
+    }
+    return (EEXIST == errno);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Lists all entries in a directory which match the pattern, either
+    only regular files or only directories. The special directories 
+    ".." and "." are never returned.
+*/
+Array<String>
+PosixFSWrapper::ListEntries(const String& dirPath, const String& pattern, bool dirs)
+{
+    n_assert(dirPath.IsValid());
+    n_assert(pattern.IsValid());
+
+    Array<String> result;
+    String nativeDirPath = NativePath(dirPath);
+    DIR* dir = opendir(nativeDirPath.AsCharPtr());
+    if (0 != dir)
+    {
+        struct dirent* entry;
+        while (0 != (entry = readdir(dir)))
+        {
+            if ((0 == strcmp(entry->d_name, ".")) || (0 == strcmp(entry->d_name, "..")))
+            {
+                continue;
+            }
+            if (0 != fnmatch(pattern.AsCharPtr(), entry->d_name, 0))
+            {
+                continue;
+            }
+            bool isDir = false;
+            if (DT_UNKNOWN != entry->d_type)
+            {
+                isDir = (DT_DIR == entry->d_type);
+            }
+            else
+            {
+                // filesystem doesn't provide the entry type, need to stat
+                String entryPath = nativeDirPath + "/" + entry->d_name;
+                struct stat st;
+                isDir = (0 == stat(entryPath.AsCharPtr(), &st)) && S_ISDIR(st.st_mode);
+            }
+            if (isDir == dirs)
+            {
+                result.Append(entry->d_name);
+            }
+        }
+        closedir(dir);
+    }
+    return result;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Lists all files in a directory, filtered by a pattern.
+*/
+Array<String>
+PosixFSWrapper::ListFiles(const String& dirPath, const String& pattern)
+{
+    return ListEntries(dirPath, pattern, false);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Lists all subdirectories in a directory, filtered by a pattern. This will
+    not return the special directories ".." and ".".
+*/
+Array<String>
+PosixFSWrapper::ListDirectories(const String& dirPath, const String& pattern)
+{
+    return ListEntries(dirPath, pattern, true);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns the user's home directory from the HOME environment variable.
+*/
+String
+PosixFSWrapper::GetUserDirectory()
+{
+    const char* home = getenv("HOME");
+    if (0 == home)
+    {
+        home = "/tmp";
+    }
+    String result(home);
+    result.TrimRight("/");
+    return String("file://") + NativePath(result);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns XDG_DATA_HOME, or ~/.local/share if not defined.
+*/
+String
+PosixFSWrapper::GetAppDataDirectory()
+{
+    const char* dataHome = getenv("XDG_DATA_HOME");
+    if (0 != dataHome)
+    {
+        String result(dataHome);
+        result.TrimRight("/");
+        return String("file://") + NativePath(result);
+    }
+    return GetUserDirectory() + "/.local/share";
+}
+
+//------------------------------------------------------------------------------
+/**
+    There is no programs directory on POSIX platforms, /usr/local is 
+    the closest equivalent.
+*/
+String 
+PosixFSWrapper::GetProgramsDirectory()
+{
+    return "file:///usr/local";
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns TMPDIR, or /tmp if not defined.
+*/
+String
+PosixFSWrapper::GetTempDirectory()
+{
+    const char* tmpDir = getenv("TMPDIR");
+    if (0 == tmpDir)
+    {
+        tmpDir = "/tmp";
+    }
+    String result(tmpDir);
+    result.TrimRight("/");
+    return String("file://") + NativePath(result);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns the absolute directory of the executable, read from the
+    /proc/self/exe link.
+*/
+String
+PosixFSWrapper::GetExeDirectory()
+{
+    char buf[NEBULA3_MAXPATH];
+    ssize_t len = readlink("/proc/self/exe", buf, sizeof(buf) - 1);
+    n_assert(len > 0);
+    buf[len] = 0;
+    String pathToExe(buf);
+    String result = pathToExe.ExtractDirName();
+    result.TrimRight("/");
+    return result;
+}
+
+//------------------------------------------------------------------------------
+/**
+    This method sould return the directory where the application executable
+    is located.
+*/
+String
+PosixFSWrapper::GetBinDirectory()
+{
+    return String("file://") + GetExeDirectory();
+}
+
+//------------------------------------------------------------------------------
+/**
+    This method should return the installation directory of the
+    application.
+*/
+String
+PosixFSWrapper::GetHomeDirectory()
+{
+    String exeDir = GetExeDirectory();
+
+    // check if executable resides in a linux directory
+    String dirName = exeDir.ExtractFileName();
+    if (n_stricmp(dirName.AsCharPtr(), "linux") == 0)
+    {
+        // normal home:bin/linux directory structure, strip bin/linux
+        String homePath = exeDir.ExtractDirName();
+        homePath.TrimRight("/");
+        homePath = homePath.ExtractDirName();
+        homePath.TrimRight("/");
+        return String("file://") + homePath;
+    }
+    else
+    {
+        // not in normal home:bin/linux directory structure, 
+        // use the exe's directory as home path
+        return String("file://") + exeDir;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    There are no device names on POSIX platforms.
+*/
+bool
+PosixFSWrapper::IsDeviceName(const Util::String& str)
+{
+    return false;
+}
+
+} // namespace Posix
@@ -0,0 +1,98 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Posix::PosixFSWrapper
+    
+    Internal filesystem wrapper for POSIX platforms. All paths must be 
+    native paths (i.e. not contain Nebula assigns). Since the local path 
+    of a file URI has its leading slash stripped, relative paths are 
+    interpreted as absolute paths from the filesystem root.
+    
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+#include "util/string.h"
+#include "util/array.h"
+#include "io/stream.h"
+#include "io/filetime.h"
+
+//------------------------------------------------------------------------------
+namespace Posix
+{
+class PosixFSWrapper
+{
+public:
+    typedef FILE* Handle; 
+    
+    /// open a file
+    static Handle OpenFile(const Util::String& path, IO::Stream::AccessMode accessMode, IO::Stream::AccessPattern accessPattern);
+    /// close a file
+    static void CloseFile(Handle h);
+    /// write to a file
+    static void Write(Handle h, const void* buf, IO::Stream::Size numBytes);
+    /// read from a file
+    static IO::Stream::Size Read(Handle h, void* buf, IO::Stream::Size numBytes);
+    /// read from a file at an absolute position without moving the file pointer of other readers (thread-safe)
+    static IO::Stream::Size ReadAt(Handle h, void* buf, IO::Stream::Size numBytes, IO::Stream::Position pos);
+    /// seek in a file
+    static void Seek(Handle h, IO::Stream::Offset offset, IO::Stream::SeekOrigin orig);
+    /// get position in file
+    static IO::Stream::Position Tell(Handle h);
+    /// flush a file
+    static void Flush(Handle h);
+    /// return true if at end-of-file
+    static bool Eof(Handle h);
+    /// get size of a file in bytes
+    static IO::Stream::Size GetFileSize(Handle h);
+    /// map a file opened for read access into memory, returns 0 if not supported
+    static void* MapFile(Handle h, IO::Stream::Size size, IO::Stream::AccessPattern accessPattern);
+    /// unmap a file mapped with MapFile()
+    static void UnmapFile(void* ptr, IO::Stream::Size size);
+    /// set read-only status of a file
+    static void SetReadOnly(const Util::String& path, bool readOnly);
+    /// get read-only status of a file
+    static bool IsReadOnly(const Util::String& path);
+    /// delete a file
+    static bool DeleteFile(const Util::String& path);
+    /// delete an empty directory
+    static bool DeleteDirectory(const Util::String& path);
+    /// return true if a file exists
+    static bool FileExists(const Util::String& path);
+    /// return true if a directory exists
+    static bool DirectoryExists(const Util::String& path);
+    /// set the write-access time stamp of a file
+    static void SetFileWriteTime(const Util::String& path, IO::FileTime fileTime);
+    /// get the last write-access time stamp of a file
+    static IO::FileTime GetFileWriteTime(const Util::String& path);
+    /// create a directory
+    static bool CreateDirectory(const Util::String& path);
+    /// list all files in a directory
+    static Util::Array<Util::String> ListFiles(const Util::String& dirPath, const Util::String& pattern);
+    /// list all subdirectories in a directory
+    static Util::Array<Util::String> ListDirectories(const Util::String& dirPath, const Util::String& pattern);
+    /// get path to the current user's home directory (for user: standard assign)
+    static Util::String GetUserDirectory();
+    /// get path to the current user's appdata directory (for appdata: standard assign)
+    static Util::String GetAppDataDirectory();
+    /// get path to the current user's temp directory (for temp: standard assign)
+    static Util::String GetTempDirectory();
+    /// get path to the current application directory (for home: standard assign)
+    static Util::String GetHomeDirectory();
+    /// get path to the current bin directory (for bin: standard assign)
+    static Util::String GetBinDirectory();
+    /// get path to the programs directory
+    static Util::String GetProgramsDirectory();
+    /// return true when the string is a device name
+    static bool IsDeviceName(const Util::String& str);
+
+private:
+    /// convert a local path into an absolute native path
+    static Util::String NativePath(const Util::String& path);
+    /// list directory entries matching a pattern
+    static Util::Array<Util::String> ListEntries(const Util::String& dirPath, const Util::String& pattern, bool dirs);
+    /// get the directory of the executable
+    static Util::String GetExeDirectory();
+};
+
+} // namespace Posix
+//------------------------------------------------------------------------------
@@ -149,6 +149,31 @@ Win360FSWrapper::Read(Handle handle, void* buf, Stream::Size numBytes)
     return bytesRead;
 }
 
+//------------------------------------------------------------------------------
+/**
+    Read data from an absolute file position, returns number of bytes read.
+    The position is handed to ReadFile() in an OVERLAPPED structure, so
+    several threads may read from the same handle at the same time. 
+    Don't mix with Read() and Seek() on the same handle.
+*/
+Stream::Size
+Win360FSWrapper::ReadAt(Handle handle, void* buf, Stream::Size numBytes, Stream::Position pos)
+{
+    n_assert(0 != handle);
+    n_assert(buf != 0);
+    n_assert(numBytes > 0);
+    OVERLAPPED overlapped;
+    Memory::Clear(&overlapped, sizeof(overlapped));
+    overlapped.Offset = pos;
+    DWORD bytesRead = 0;
+    BOOL result = ReadFile(handle, buf, numBytes, &bytesRead, &overlapped);
+    if ((0 == result) && (ERROR_HANDLE_EOF != GetLastError()))
+    {
+        n_error("Win360FSWrapper: ReadFile() failed!");
+    }
+    return bytesRead;
+}
+
 //------------------------------------------------------------------------------
 /**
     Seek in a file.
@@ -225,6 +250,50 @@ Win360FSWrapper::GetFileSize(Handle handle)
     return ::GetFileSize(handle, NULL);
 }
 
+//------------------------------------------------------------------------------
+/**
+    Map a file into memory with MapViewOfFile(). The view is mapped 
+    copy-on-write, so that the pages are shared with the file cache 
+    as long as they are only read. The access pattern hint has already
+    been handed to CreateFile() when the file was opened. Returns 0 
+    if the file can't be mapped, which is always the case on the Xbox360.
+*/
+void*
+Win360FSWrapper::MapFile(Handle handle, Stream::Size size, Stream::AccessPattern accessPattern)
+{
+    n_assert(0 != handle);
+    n_assert(size > 0);
+    #if __XBOX360__
+    return 0;
+    #else
+    HANDLE mapping = CreateFileMapping(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (NULL == mapping)
+    {
+        return 0;
+    }
+    void* ptr = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, size);
+
+    // the view keeps a reference to the file mapping object
+    CloseHandle(mapping);
+    return ptr;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+/**
+    Unmap a file mapped with MapFile().
+*/
+void
+Win360FSWrapper::UnmapFile(void* ptr, Stream::Size size)
+{
+    n_assert(0 != ptr);
+    #if __XBOX360__
+    n_error("Win360FSWrapper::UnmapFile(): not supported on Xbox360!\n");
+    #else
+    UnmapViewOfFile(ptr);
+    #endif
+}
+
 //------------------------------------------------------------------------------
 /**
     Set the read-only status of a file. This method does nothing on the
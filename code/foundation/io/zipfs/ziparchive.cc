@@ -18,7 +18,8 @@ using namespace Util;
 /**
 */
 ZipArchive::ZipArchive() :
-    zipFileHandle(0)
+    zipFileHandle(0),
+    fileHandle(0)
 {
     // empty
 }
@@ -60,6 +61,10 @@ ZipArchive::Setup(const URI& zipFileURI)
             return false;
         }
 
+        // open a second handle for parallel positional reads, 
+        // if this fails, all files are read through the zip file handle
+        this->fileHandle = FSWrapper::OpenFile(localPath, Stream::ReadAccess, Stream::Random);
+
         // read the table of contents
         this->ParseTableOfContents();    
         return true;
@@ -82,6 +87,11 @@ ZipArchive::Discard()
 
     unzClose(this->zipFileHandle);
     this->zipFileHandle = 0;
+    if (0 != this->fileHandle)
+    {
+        FSWrapper::CloseFile(this->fileHandle);
+        this->fileHandle = 0;
+    }
 
     ArchiveBase::Discard();
 }
@@ -168,7 +178,7 @@ ZipArchive::AddEntry(const String& path)
     else
     {
         ZipFileEntry* finalFileEntry = dirEntry->AddFileEntry(finalName);
-        finalFileEntry->Setup(finalName, this->zipFileHandle, &this->archiveCritSect);
+        finalFileEntry->Setup(finalName, this->zipFileHandle, this->fileHandle, &this->archiveCritSect);
     }
 }
 
@@ -196,6 +206,22 @@ ZipArchive::ConvertToPathInArchive(const Util::String& absPath) const
     return "";
 }
 
+//------------------------------------------------------------------------------
+/**
+    Returns the position of a file's data in the zip archive file, or
+    0 if the file doesn't exist.
+*/
+Stream::Position
+ZipArchive::GetFileOffset(const String& pathInArchive) const
+{
+    const ZipFileEntry* fileEntry = this->FindFileEntry(pathInArchive);
+    if (0 != fileEntry)
+    {
+        return fileEntry->GetArchiveOffset();
+    }
+    return 0;
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -8,12 +8,16 @@
     
     Multithreading: access to zlib archives needs to be serialized. A
     ZipArchive objects contains a critical section which it will hand down
-    to ZipFileEntry objects.
+    to ZipFileEntry objects. Unencrypted stored or deflated files are
+    read without the critical section through a second file handle which
+    only uses positional reads (see ZipFileEntry::ReadParallel()), so that
+    several threads can decompress files of the same archive at once.
 
     (C) 2006 Radon Labs GmbH
 */
 #include "io/archfs/archivebase.h"
 #include "zlib/unzip.h"
+#include "io/fswrapper.h"
 #include "io/zipfs/zipfileentry.h"
 #include "io/zipfs/zipdirentry.h"
 
@@ -42,6 +46,8 @@ public:
     URI ConvertToArchiveURI(const URI& fileURI) const;
     /// convert an absolute path to local path inside archive, returns empty string if absPath doesn't point into this archive
     Util::String ConvertToPathInArchive(const Util::String& absPath) const;
+    /// get position of a file's data in the zip archive file (only used to order reads)
+    Stream::Position GetFileOffset(const Util::String& pathInArchive) const;
 
 private:
     friend class ZipFileSystem;
@@ -60,6 +66,7 @@ private:
 
     Util::String rootPath;                      // location of the zip archive file
     unzFile zipFileHandle;                      // the zip file handle
+    FSWrapper::Handle fileHandle;               // file handle for positional reads
     ZipDirEntry rootEntry;                      // the root entry of the zip archive
     Threading::CriticalSection archiveCritSect; // need to serialize access to archive from multiple threads!
 };
@@ -0,0 +1,176 @@
+//------------------------------------------------------------------------------
+//  zipblockcodec.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "io/zipfs/zipblockcodec.h"
+#include "zlib/zlib.h"
+
+namespace IO
+{
+using namespace Util;
+
+// magic number of block-compressed files ('N3BC')
+static const uint ZipBlockMagic = 0x4e334243;
+
+//------------------------------------------------------------------------------
+/**
+    Read a little endian 32 bit value.
+*/
+static inline uint
+ZipBlockReadUInt(const uchar* ptr)
+{
+    return uint(ptr[0]) | (uint(ptr[1]) << 8) | (uint(ptr[2]) << 16) | (uint(ptr[3]) << 24);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Write a little endian 32 bit value.
+*/
+static inline void
+ZipBlockWriteUInt(uchar* ptr, uint val)
+{
+    ptr[0] = uchar(val & 0xff);
+    ptr[1] = uchar((val >> 8) & 0xff);
+    ptr[2] = uchar((val >> 16) & 0xff);
+    ptr[3] = uchar((val >> 24) & 0xff);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Compress the source data block by block and write the block-compressed
+    file to the destination stream, which must be open for writing.
+*/
+bool
+ZipBlockCodec::Encode(const void* srcData, SizeT srcNumBytes, const Ptr<Stream>& dstStream, SizeT blockSize)
+{
+    n_assert((0 != srcData) || (0 == srcNumBytes));
+    n_assert(dstStream->IsOpen() && dstStream->CanWrite());
+    n_assert(blockSize > 0);
+
+    Header header;
+    header.blockSize = blockSize;
+    header.uncompressedSize = srcNumBytes;
+    header.numBlocks = (srcNumBytes + blockSize - 1) / blockSize;
+
+    // compress all blocks into one buffer, and build the seek table
+    SizeT seekTableSize = GetSeekTableSize(header);
+    SizeT maxBlockSize = compressBound(blockSize);
+    SizeT maxDataSize = HeaderSize + seekTableSize + header.numBlocks * maxBlockSize;
+    uchar* dstData = (uchar*) Memory::Alloc(Memory::ScratchHeap, maxDataSize);
+    ZipBlockWriteUInt(dstData, ZipBlockMagic);
+    ZipBlockWriteUInt(dstData + 4, header.blockSize);
+    ZipBlockWriteUInt(dstData + 8, header.uncompressedSize);
+    ZipBlockWriteUInt(dstData + 12, header.numBlocks);
+    uchar* seekTable = dstData + HeaderSize;
+    SizeT dstOffset = HeaderSize + seekTableSize;
+    bool success = true;
+    IndexT blockIndex;
+    for (blockIndex = 0; blockIndex < (IndexT)header.numBlocks; blockIndex++)
+    {
+        const uchar* srcBlock = ((const uchar*)srcData) + blockIndex * blockSize;
+        SizeT srcBlockSize = GetUncompressedBlockSize(header, blockIndex);
+        ZipBlockWriteUInt(seekTable + blockIndex * sizeof(uint), dstOffset);
+
+        uLongf compressedSize = maxBlockSize;
+        int res = compress2((Bytef*)(dstData + dstOffset), &compressedSize, (const Bytef*)srcBlock, srcBlockSize, Z_BEST_COMPRESSION);
+        if (Z_OK != res)
+        {
+            success = false;
+            break;
+        }
+        if (compressedSize >= (uLongf)srcBlockSize)
+        {
+            // no gain from compression, store the block as is
+            Memory::Copy(srcBlock, dstData + dstOffset, srcBlockSize);
+            compressedSize = srcBlockSize;
+        }
+        dstOffset += compressedSize;
+    }
+    ZipBlockWriteUInt(seekTable + header.numBlocks * sizeof(uint), dstOffset);
+
+    if (success)
+    {
+        dstStream->Write(dstData, dstOffset);
+    }
+    Memory::Free(Memory::ScratchHeap, dstData);
+    return success;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Decode the header from the start of a file, srcNumBytes is the
+    size of the entire file.
+*/
+bool
+ZipBlockCodec::DecodeHeader(const void* srcData, SizeT srcNumBytes, Header& outHeader)
+{
+    n_assert(0 != srcData);
+    if (srcNumBytes < (SizeT)HeaderSize)
+    {
+        return false;
+    }
+    const uchar* ptr = (const uchar*) srcData;
+    if (ZipBlockMagic != ZipBlockReadUInt(ptr))
+    {
+        return false;
+    }
+    outHeader.blockSize = ZipBlockReadUInt(ptr + 4);
+    outHeader.uncompressedSize = ZipBlockReadUInt(ptr + 8);
+    outHeader.numBlocks = ZipBlockReadUInt(ptr + 12);
+
+    // reject headers which don't describe a consistent file
+    if (0 == outHeader.blockSize)
+    {
+        return false;
+    }
+    if (outHeader.numBlocks != (outHeader.uncompressedSize + outHeader.blockSize - 1) / outHeader.blockSize)
+    {
+        return false;
+    }
+    if ((SizeT)(HeaderSize + GetSeekTableSize(outHeader)) > srcNumBytes)
+    {
+        return false;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Decode the seek table, srcData points to the start of the seek table
+    (directly behind the header).
+*/
+void
+ZipBlockCodec::DecodeSeekTable(const void* srcData, const Header& header, FixedArray<uint>& outBlockOffsets)
+{
+    n_assert(0 != srcData);
+    const uchar* ptr = (const uchar*) srcData;
+    outBlockOffsets.SetSize(header.numBlocks + 1);
+    IndexT i;
+    for (i = 0; i < outBlockOffsets.Size(); i++)
+    {
+        outBlockOffsets[i] = ZipBlockReadUInt(ptr + i * sizeof(uint));
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Decode a single block, dstNumBytes must be the uncompressed size of
+    the block. Blocks which have been stored uncompressed are just copied.
+*/
+bool
+ZipBlockCodec::DecodeBlock(const void* srcData, SizeT srcNumBytes, void* dstData, SizeT dstNumBytes)
+{
+    n_assert(0 != srcData);
+    n_assert(0 != dstData);
+    if (srcNumBytes == dstNumBytes)
+    {
+        Memory::Copy(srcData, dstData, dstNumBytes);
+        return true;
+    }
+    uLongf uncompressedSize = dstNumBytes;
+    int res = uncompress((Bytef*)dstData, &uncompressedSize, (const Bytef*)srcData, srcNumBytes);
+    return (Z_OK == res) && (uncompressedSize == (uLongf)dstNumBytes);
+}
+
+} // namespace IO
@@ -0,0 +1,84 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class IO::ZipBlockCodec
+
+    Encoder/decoder for block-compressed files. A block-compressed file
+    is split into blocks of a fixed uncompressed size (64 KB by default)
+    which are compressed independently of each other, so that any byte
+    of the file can be read by decompressing a single block.
+
+    Block-compressed files are stored *uncompressed* in zip archives,
+    ZipFileEntry recognizes them by their header and ZipFileStream
+    decompresses them block by block, which makes seeking in both
+    directions cheap.
+
+    Layout (all values are little endian uints):
+
+    - header: magic 'N3BC', block size, uncompressed size, number of blocks
+    - seek table: numBlocks + 1 offsets of the compressed blocks from
+      the start of the file, the last entry is the end of the last block
+    - the compressed blocks, a block which doesn't get smaller by
+      compression is stored as is
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+#include "io/stream.h"
+#include "util/fixedarray.h"
+
+//------------------------------------------------------------------------------
+namespace IO
+{
+class ZipBlockCodec
+{
+public:
+    /// header of a block-compressed file
+    struct Header
+    {
+        uint blockSize;
+        uint uncompressedSize;
+        uint numBlocks;
+    };
+
+    /// default uncompressed size of a block
+    static const SizeT DefaultBlockSize = 64 * 1024;
+    /// size of the header in bytes
+    static const SizeT HeaderSize = 16;
+
+    /// encode data into a block-compressed file
+    static bool Encode(const void* srcData, SizeT srcNumBytes, const Ptr<Stream>& dstStream, SizeT blockSize = DefaultBlockSize);
+    /// decode the header, returns false if the data isn't a block-compressed file
+    static bool DecodeHeader(const void* srcData, SizeT srcNumBytes, Header& outHeader);
+    /// get the size of the seek table in bytes
+    static SizeT GetSeekTableSize(const Header& header);
+    /// decode the seek table which follows the header
+    static void DecodeSeekTable(const void* srcData, const Header& header, Util::FixedArray<uint>& outBlockOffsets);
+    /// get the uncompressed size of a block
+    static SizeT GetUncompressedBlockSize(const Header& header, IndexT blockIndex);
+    /// decode a single compressed block
+    static bool DecodeBlock(const void* srcData, SizeT srcNumBytes, void* dstData, SizeT dstNumBytes);
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+ZipBlockCodec::GetSeekTableSize(const Header& header)
+{
+    return (header.numBlocks + 1) * sizeof(uint);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+ZipBlockCodec::GetUncompressedBlockSize(const Header& header, IndexT blockIndex)
+{
+    n_assert(blockIndex < (IndexT)header.numBlocks);
+    SizeT blockStart = blockIndex * header.blockSize;
+    return Math::n_min((SizeT)header.blockSize, (SizeT)header.uncompressedSize - blockStart);
+}
+
+} // namespace IO
+//------------------------------------------------------------------------------
@@ -4,19 +4,54 @@
 //------------------------------------------------------------------------------
 #include "stdneb.h"
 #include "io/zipfs/zipfileentry.h"
+#include "io/zipfs/zipblockcodec.h"
 
 namespace IO
 {
 using namespace Util;
 using namespace Threading;
 
+// zip file format signatures and record sizes
+static const uint ZipCentralDirSignature = 0x02014b50;
+static const uint ZipCentralDirRecordSize = 46;
+static const uint ZipLocalHeaderSignature = 0x04034b50;
+static const uint ZipLocalHeaderSize = 30;
+
+//------------------------------------------------------------------------------
+/**
+    Read a little endian 16 bit value from a zip record.
+*/
+static inline uint
+ZipReadUShort(const uchar* ptr)
+{
+    return uint(ptr[0]) | (uint(ptr[1]) << 8);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Read a little endian 32 bit value from a zip record.
+*/
+static inline uint
+ZipReadUInt(const uchar* ptr)
+{
+    return uint(ptr[0]) | (uint(ptr[1]) << 8) | (uint(ptr[2]) << 16) | (uint(ptr[3]) << 24);
+}
+
 //------------------------------------------------------------------------------
 /**
 */
 ZipFileEntry::ZipFileEntry() :
     archiveCritSect(0),
     zipFileHandle(0),
-    uncompressedSize(0)
+    uncompressedSize(0),
+    fileHandle(0),
+    dataOffset(0),
+    compressedSize(0),
+    compressionMethod(0),
+    crc(0),
+    parallelRead(false),
+    blockCompressed(false),
+    blockSize(0)
 {
     Memory::Clear(&this->filePosInfo, sizeof(this->filePosInfo));
 }
@@ -33,7 +68,7 @@ ZipFileEntry::~ZipFileEntry()
 /**
 */
 void
-ZipFileEntry::Setup(const StringAtom& n, unzFile h, CriticalSection* critSect)
+ZipFileEntry::Setup(const StringAtom& n, unzFile h, FSWrapper::Handle fh, CriticalSection* critSect)
 {
     n_assert(0 != h);
     n_assert(0 == this->zipFileHandle);
@@ -41,6 +76,7 @@ ZipFileEntry::Setup(const StringAtom& n, unzFile h, CriticalSection* critSect)
 
     this->name = n;
     this->zipFileHandle = h;
+    this->fileHandle = fh;
 
     // store pointer to archive's critical section
     this->archiveCritSect = critSect;
@@ -54,6 +90,102 @@ ZipFileEntry::Setup(const StringAtom& n, unzFile h, CriticalSection* critSect)
     res = unzGetCurrentFileInfo(this->zipFileHandle, &fileInfo, 0, 0, 0, 0, 0, 0);
     n_assert(UNZ_OK == res);
     this->uncompressedSize = fileInfo.uncompressed_size;
+    this->SetupParallelRead(fileInfo);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Find the position of the raw file data in the archive. Minizip doesn't
+    expose the position of the local file header, so it is read from the
+    central directory record of the current file. Encrypted files and 
+    unsupported compression methods are only read through minizip.
+*/
+void
+ZipFileEntry::SetupParallelRead(const unz_file_info& fileInfo)
+{
+    this->parallelRead = false;
+    if (0 == this->fileHandle)
+    {
+        return;
+    }
+    if ((0 != (fileInfo.flag & 1)) || ((0 != fileInfo.compression_method) && (Z_DEFLATED != fileInfo.compression_method)))
+    {
+        return;
+    }
+
+    // read offset of the local file header from the central directory record
+    uchar centralDirRecord[ZipCentralDirRecordSize];
+    Stream::Position centralDirPos = unzGetOffset(this->zipFileHandle);
+    if ((ZipCentralDirRecordSize != FSWrapper::ReadAt(this->fileHandle, centralDirRecord, ZipCentralDirRecordSize, centralDirPos)) ||
+        (ZipCentralDirSignature != ZipReadUInt(centralDirRecord)))
+    {
+        return;
+    }
+    uint localHeaderPos = ZipReadUInt(centralDirRecord + 42);
+
+    // the file data follows the local header, file name and extra field
+    uchar localHeader[ZipLocalHeaderSize];
+    if ((ZipLocalHeaderSize != FSWrapper::ReadAt(this->fileHandle, localHeader, ZipLocalHeaderSize, localHeaderPos)) ||
+        (ZipLocalHeaderSignature != ZipReadUInt(localHeader)))
+    {
+        return;
+    }
+    uint fileNameLength = ZipReadUShort(localHeader + 26);
+    uint extraFieldLength = ZipReadUShort(localHeader + 28);
+    this->dataOffset = localHeaderPos + ZipLocalHeaderSize + fileNameLength + extraFieldLength;
+    this->compressedSize = fileInfo.compressed_size;
+    this->compressionMethod = fileInfo.compression_method;
+    this->crc = fileInfo.crc;
+    this->parallelRead = true;
+    if (0 == this->compressionMethod)
+    {
+        this->SetupBlockRead();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Check whether a stored file is block-compressed. If yes, the seek table
+    is read, and the file size is replaced by the decompressed size.
+*/
+void
+ZipFileEntry::SetupBlockRead()
+{
+    n_assert(this->parallelRead);
+    this->blockCompressed = false;
+
+    uchar headerData[ZipBlockCodec::HeaderSize];
+    ZipBlockCodec::Header header;
+    if (((SizeT)this->compressedSize < ZipBlockCodec::HeaderSize) ||
+        (ZipBlockCodec::HeaderSize != FSWrapper::ReadAt(this->fileHandle, headerData, ZipBlockCodec::HeaderSize, this->dataOffset)) ||
+        !ZipBlockCodec::DecodeHeader(headerData, this->compressedSize, header))
+    {
+        return;
+    }
+
+    // read the seek table and validate the block offsets
+    SizeT seekTableSize = ZipBlockCodec::GetSeekTableSize(header);
+    void* seekTableData = Memory::Alloc(Memory::ScratchHeap, seekTableSize);
+    bool valid = (seekTableSize == FSWrapper::ReadAt(this->fileHandle, seekTableData, seekTableSize, this->dataOffset + ZipBlockCodec::HeaderSize));
+    if (valid)
+    {
+        ZipBlockCodec::DecodeSeekTable(seekTableData, header, this->blockOffsets);
+        IndexT i;
+        for (i = 0; valid && (i < (IndexT)header.numBlocks); i++)
+        {
+            valid = (this->blockOffsets[i] <= this->blockOffsets[i + 1]);
+        }
+        valid = valid && (this->blockOffsets[header.numBlocks] <= this->compressedSize);
+    }
+    Memory::Free(Memory::ScratchHeap, seekTableData);
+    if (!valid)
+    {
+        this->blockOffsets.SetSize(0);
+        return;
+    }
+    this->blockSize = header.blockSize;
+    this->uncompressedSize = header.uncompressedSize;
+    this->blockCompressed = true;
 }
 
 //------------------------------------------------------------------------------
@@ -62,6 +194,9 @@ ZipFileEntry::Setup(const StringAtom& n, unzFile h, CriticalSection* critSect)
 bool
 ZipFileEntry::Open(const String& password)
 {
+    // block-compressed files must be read with ReadBlock() or ReadParallel()
+    n_assert(!this->blockCompressed);
+
     // critical section active until close is called or this function fails
     this->archiveCritSect->Enter();
 
@@ -123,4 +258,100 @@ ZipFileEntry::Read(void* buf, Stream::Size numBytes) const
     return true;
 }
 
+//------------------------------------------------------------------------------
+/**
+    Reads the raw file data with a positional read and inflates it into
+    the provided buffer. Every call uses its own inflate state and the
+    archive isn't locked, so any number of threads may read files
+    from the same archive at the same time.
+*/
+bool
+ZipFileEntry::ReadParallel(void* buf, Stream::Size numBytes) const
+{
+    n_assert(this->parallelRead);
+    n_assert(0 != buf);
+    n_assert(numBytes == (Stream::Size)this->uncompressedSize);
+    if (0 == numBytes)
+    {
+        return true;
+    }
+
+    bool success = false;
+    if (this->blockCompressed)
+    {
+        // decompress block by block, every block is checked by zlib
+        uchar* dst = (uchar*) buf;
+        success = true;
+        IndexT blockIndex;
+        for (blockIndex = 0; success && (blockIndex < this->GetNumBlocks()); blockIndex++)
+        {
+            SizeT blockBytes = this->GetUncompressedBlockSize(blockIndex);
+            success = this->ReadBlock(blockIndex, dst, blockBytes);
+            dst += blockBytes;
+        }
+        return success;
+    }
+    else if (0 == this->compressionMethod)
+    {
+        // stored file, read directly into the destination buffer
+        success = (numBytes == FSWrapper::ReadAt(this->fileHandle, buf, numBytes, this->dataOffset));
+    }
+    else
+    {
+        void* compressedData = Memory::Alloc(Memory::StreamDataHeap, this->compressedSize);
+        if (this->compressedSize == (uint)FSWrapper::ReadAt(this->fileHandle, compressedData, this->compressedSize, this->dataOffset))
+        {
+            // negative window bits: raw deflate data without zlib header
+            z_stream zipStream;
+            Memory::Clear(&zipStream, sizeof(zipStream));
+            zipStream.next_in = (Bytef*) compressedData;
+            zipStream.avail_in = this->compressedSize;
+            zipStream.next_out = (Bytef*) buf;
+            zipStream.avail_out = numBytes;
+            if (Z_OK == inflateInit2(&zipStream, -MAX_WBITS))
+            {
+                int res = inflate(&zipStream, Z_FINISH);
+                success = (Z_STREAM_END == res) && (zipStream.total_out == (uLong)numBytes);
+                inflateEnd(&zipStream);
+            }
+        }
+        Memory::Free(Memory::StreamDataHeap, compressedData);
+    }
+    if (success)
+    {
+        success = (this->crc == crc32(crc32(0L, Z_NULL, 0), (const Bytef*) buf, numBytes));
+    }
+    return success;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Read and decompress a single block of a block-compressed file. Like
+    ReadParallel() this doesn't lock the archive. bufSize must be the
+    uncompressed size of the block.
+*/
+bool
+ZipFileEntry::ReadBlock(IndexT blockIndex, void* buf, SizeT bufSize) const
+{
+    n_assert(this->blockCompressed);
+    n_assert(0 != buf);
+    n_assert(bufSize == this->GetUncompressedBlockSize(blockIndex));
+
+    uint blockPos = this->dataOffset + this->blockOffsets[blockIndex];
+    SizeT compressedBlockSize = this->blockOffsets[blockIndex + 1] - this->blockOffsets[blockIndex];
+    if (compressedBlockSize == bufSize)
+    {
+        // block is stored uncompressed
+        return (bufSize == FSWrapper::ReadAt(this->fileHandle, buf, bufSize, blockPos));
+    }
+    bool success = false;
+    void* compressedData = Memory::Alloc(Memory::StreamDataHeap, compressedBlockSize);
+    if (compressedBlockSize == FSWrapper::ReadAt(this->fileHandle, compressedData, compressedBlockSize, blockPos))
+    {
+        success = ZipBlockCodec::DecodeBlock(compressedData, compressedBlockSize, buf, bufSize);
+    }
+    Memory::Free(Memory::StreamDataHeap, compressedData);
+    return success;
+}
+
 } // namespace ZipFileEntry
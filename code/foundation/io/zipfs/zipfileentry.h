@@ -6,12 +6,25 @@
     A file entry in a zip archive. The ZipFileEntry class is thread-safe,
     all public methods can be invoked from on the same object from different
     threads.
+
+    Open()/Read()/Close() go through the shared minizip handle of the 
+    archive and lock the archive until Close(). If CanReadParallel() 
+    returns true, ReadParallel() reads the raw file data with positional
+    reads and inflates it with its own inflate state, without locking
+    the archive.
+
+    Stored files which are block-compressed (see ZipBlockCodec) are
+    decompressed transparently: GetFileSize() returns the decompressed
+    size and ReadBlock() decompresses a single block, so that a stream
+    can access the file at any position.
     
     (C) 2006 Radon Labs GmbH
 */    
 #include "io/stream.h"
+#include "io/fswrapper.h"
 #include "zlib/unzip.h"
 #include "util/stringatom.h"
+#include "util/fixedarray.h"
 
 //------------------------------------------------------------------------------
 namespace IO
@@ -28,6 +41,8 @@ public:
     const Util::StringAtom& GetName() const;
     /// get the uncompressed file size in bytes
     IO::Stream::Size GetFileSize() const;
+    /// get the position of the file in the archive file
+    IO::Stream::Position GetArchiveOffset() const;
 
     /// open the zip file
     bool Open(const Util::String& password = "");
@@ -36,17 +51,46 @@ public:
     /// read the *entire* content into the provided memory buffer
     bool Read(void* buf, IO::Stream::Size bufSize) const;
 
+    /// return true if the file can be read with ReadParallel()
+    bool CanReadParallel() const;
+    /// read the *entire* content without locking the archive, doesn't require Open()
+    bool ReadParallel(void* buf, IO::Stream::Size bufSize) const;
+
+    /// return true if the file is block-compressed
+    bool IsBlockCompressed() const;
+    /// get the uncompressed size of a block (all blocks but the last have this size)
+    SizeT GetBlockSize() const;
+    /// get the number of blocks
+    SizeT GetNumBlocks() const;
+    /// get the uncompressed size of a specific block
+    SizeT GetUncompressedBlockSize(IndexT blockIndex) const;
+    /// decompress a single block without locking the archive, doesn't require Open()
+    bool ReadBlock(IndexT blockIndex, void* buf, SizeT bufSize) const;
+
 private:
     friend class ZipArchive;
     
     /// setup the file entry object
-    void Setup(const Util::StringAtom& name, unzFile zipFileHandle, Threading::CriticalSection* critSect);
+    void Setup(const Util::StringAtom& name, unzFile zipFileHandle, FSWrapper::Handle fileHandle, Threading::CriticalSection* critSect);
+    /// locate the raw file data for ReadParallel()
+    void SetupParallelRead(const unz_file_info& fileInfo);
+    /// check for a block-compressed file and read its seek table
+    void SetupBlockRead();
 
     Threading::CriticalSection* archiveCritSect;
     Util::StringAtom name;
     unzFile zipFileHandle;    // handle on zip file
     unz_file_pos filePosInfo; // info about position in zip file
     uint uncompressedSize;    // uncompressed size of the file
+    FSWrapper::Handle fileHandle;   // archive file handle for positional reads
+    uint dataOffset;                // position of the raw file data in the archive
+    uint compressedSize;            // size of the raw file data
+    uint compressionMethod;         // 0 (stored) or Z_DEFLATED
+    uint crc;                       // crc32 of the uncompressed data
+    bool parallelRead;              // true if ReadParallel() is possible
+    bool blockCompressed;           // true if the file is block-compressed
+    uint blockSize;                 // uncompressed size of a block
+    Util::FixedArray<uint> blockOffsets;    // block offsets relative to dataOffset, plus end of last block
 };
 
 //------------------------------------------------------------------------------
@@ -67,6 +111,66 @@ ZipFileEntry::GetFileSize() const
     return this->uncompressedSize;
 }
 
+//------------------------------------------------------------------------------
+/**
+    Returns the position of the raw file data in the archive. If it hasn't
+    been located, the position of the file's central directory record is
+    returned instead, which is in the same order as the file data.
+*/
+inline IO::Stream::Position
+ZipFileEntry::GetArchiveOffset() const
+{
+    return (IO::Stream::Position) (this->parallelRead ? this->dataOffset : this->filePosInfo.pos_in_zip_directory);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+ZipFileEntry::CanReadParallel() const
+{
+    return this->parallelRead;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+ZipFileEntry::IsBlockCompressed() const
+{
+    return this->blockCompressed;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+ZipFileEntry::GetBlockSize() const
+{
+    return this->blockSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+ZipFileEntry::GetNumBlocks() const
+{
+    return this->blockCompressed ? this->blockOffsets.Size() - 1 : 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+ZipFileEntry::GetUncompressedBlockSize(IndexT blockIndex) const
+{
+    n_assert(this->blockCompressed);
+    n_assert((blockIndex >= 0) && (blockIndex < this->GetNumBlocks()));
+    SizeT blockStart = blockIndex * this->blockSize;
+    return Math::n_min((SizeT)this->blockSize, (SizeT)this->uncompressedSize - blockStart);
+}
+
 } // namespace IO
 //------------------------------------------------------------------------------
 
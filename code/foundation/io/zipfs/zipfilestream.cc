@@ -21,7 +21,15 @@ using namespace Util;
 ZipFileStream::ZipFileStream() :
     size(0),
     position(0),
-    mapBuffer(0)
+    zipFileEntry(0),
+    mapBuffer(0),
+    contentBuffer(0),
+    parallelRead(false),
+    blockRead(false),
+    blockCacheSize(2),
+    blockCacheTime(0),
+    numBlockDecodes(0),
+    numBlockCacheHits(0)
 {
     // empty
 }
@@ -36,6 +44,19 @@ ZipFileStream::~ZipFileStream()
         this->Close();
     }
     n_assert(!this->mapBuffer);
+    n_assert(!this->contentBuffer);
+    n_assert(this->blockCache.IsEmpty());
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ZipFileStream::SetBlockCacheSize(SizeT numBlocks)
+{
+    n_assert(!this->IsOpen());
+    n_assert(numBlocks > 0);
+    this->blockCacheSize = numBlocks;
 }
 
 //------------------------------------------------------------------------------
@@ -128,8 +149,16 @@ ZipFileStream::Open()
                     {
                         // read content of zip file entry into private buffer
                         this->size = this->zipFileEntry->GetFileSize();
-                        if(!this->zipFileEntry->Open(pwd)) return false;
                         this->position = 0;
+                        this->blockRead = this->zipFileEntry->IsBlockCompressed();
+                        this->parallelRead = this->blockRead || (pwd.IsEmpty() && this->zipFileEntry->CanReadParallel());
+                        this->blockCacheTime = 0;
+                        this->numBlockDecodes = 0;
+                        this->numBlockCacheHits = 0;
+                        if (!this->parallelRead)
+                        {
+                            if(!this->zipFileEntry->Open(pwd)) return false;
+                        }
                         return true;
                     }
                 }
@@ -154,11 +183,168 @@ ZipFileStream::Close()
         this->Unmap();
     }
     Stream::Close();
-    this->zipFileEntry->Close();
+    if (this->parallelRead)
+    {
+        if (0 != this->contentBuffer)
+        {
+            Memory::Free(Memory::StreamDataHeap, this->contentBuffer);
+            this->contentBuffer = 0;
+        }
+        this->DiscardBlockCache();
+        this->parallelRead = false;
+        this->blockRead = false;
+    }
+    else
+    {
+        this->zipFileEntry->Close();
+    }
     this->size = 0;
     this->position = 0;
 }
 
+//------------------------------------------------------------------------------
+/**
+    Decompress the entire file into the content buffer (only for
+    parallel reads).
+*/
+void
+ZipFileStream::ReadContent()
+{
+    n_assert(this->parallelRead);
+    n_assert(0 == this->contentBuffer);
+    this->contentBuffer = (unsigned char*) Memory::Alloc(Memory::StreamDataHeap, Math::n_max(this->size, 1));
+    n_assert(0 != this->contentBuffer);
+    bool success = this->zipFileEntry->ReadParallel(this->contentBuffer, this->size);
+    if (!success)
+    {
+        n_error("ZipFileStream: failed to read '%s'!\n", this->uri.AsString().AsCharPtr());
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Free the decompressed blocks in the block cache.
+*/
+void
+ZipFileStream::DiscardBlockCache()
+{
+    IndexT i;
+    for (i = 0; i < this->blockCache.Size(); i++)
+    {
+        Memory::Free(Memory::StreamDataHeap, this->blockCache[i].data);
+    }
+    this->blockCache.Clear();
+}
+
+//------------------------------------------------------------------------------
+/**
+    Return a pointer to the decompressed data of a block. If the block
+    isn't in the cache, it is decompressed into a new cache slot, or into 
+    the least recently used slot if the cache is full. Returns 0 if 
+    decompressing the block failed.
+*/
+const unsigned char*
+ZipFileStream::GetCachedBlock(IndexT blockIndex)
+{
+    n_assert(this->blockRead);
+    this->blockCacheTime++;
+
+    // check for a cache hit, and find the least recently used slot
+    IndexT lruIndex = 0;
+    IndexT i;
+    for (i = 0; i < this->blockCache.Size(); i++)
+    {
+        CachedBlock& cachedBlock = this->blockCache[i];
+        if (cachedBlock.blockIndex == blockIndex)
+        {
+            cachedBlock.lastUse = this->blockCacheTime;
+            this->numBlockCacheHits++;
+            return cachedBlock.data;
+        }
+        if (cachedBlock.lastUse < this->blockCache[lruIndex].lastUse)
+        {
+            lruIndex = i;
+        }
+    }
+
+    // cache miss, decompress the block
+    if (this->blockCache.Size() < this->blockCacheSize)
+    {
+        CachedBlock newBlock;
+        newBlock.blockIndex = InvalidIndex;
+        newBlock.lastUse = 0;
+        newBlock.data = (unsigned char*) Memory::Alloc(Memory::StreamDataHeap, this->zipFileEntry->GetBlockSize());
+        this->blockCache.Append(newBlock);
+        lruIndex = this->blockCache.Size() - 1;
+    }
+    CachedBlock& cachedBlock = this->blockCache[lruIndex];
+    cachedBlock.blockIndex = InvalidIndex;
+    this->numBlockDecodes++;
+    if (!this->zipFileEntry->ReadBlock(blockIndex, cachedBlock.data, this->zipFileEntry->GetUncompressedBlockSize(blockIndex)))
+    {
+        return 0;
+    }
+    cachedBlock.blockIndex = blockIndex;
+    cachedBlock.lastUse = this->blockCacheTime;
+    return cachedBlock.data;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Read from a block-compressed file at the current position. Blocks 
+    which are read completely and aren't cached are decompressed directly
+    into the destination buffer, partially read blocks go through
+    the block cache.
+*/
+bool
+ZipFileStream::ReadBlocks(void* ptr, Size numBytes)
+{
+    n_assert(this->blockRead);
+    unsigned char* dst = (unsigned char*) ptr;
+    SizeT blockSize = this->zipFileEntry->GetBlockSize();
+    Position pos = this->position;
+    Size bytesLeft = numBytes;
+    while (bytesLeft > 0)
+    {
+        IndexT blockIndex = pos / blockSize;
+        Size blockBytes = this->zipFileEntry->GetUncompressedBlockSize(blockIndex);
+        Size offsetInBlock = pos - blockIndex * blockSize;
+        Size copyBytes = Math::n_min(bytesLeft, blockBytes - offsetInBlock);
+
+        bool isCached = false;
+        IndexT i;
+        for (i = 0; i < this->blockCache.Size(); i++)
+        {
+            if (this->blockCache[i].blockIndex == blockIndex)
+            {
+                isCached = true;
+                break;
+            }
+        }
+        if ((copyBytes == blockBytes) && !isCached)
+        {
+            this->numBlockDecodes++;
+            if (!this->zipFileEntry->ReadBlock(blockIndex, dst, blockBytes))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            const unsigned char* blockData = this->GetCachedBlock(blockIndex);
+            if (0 == blockData)
+            {
+                return false;
+            }
+            Memory::Copy(blockData + offsetInBlock, dst, copyBytes);
+        }
+        dst += copyBytes;
+        pos += copyBytes;
+        bytesLeft -= copyBytes;
+    }
+    return true;
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -177,7 +363,31 @@ ZipFileStream::Read(void* ptr, Size numBytes)
     n_assert((this->position + readBytes) <= this->size);
     if (readBytes > 0)
     {
-        if(!this->zipFileEntry->Read(ptr, readBytes)) return 0;
+        if (this->blockRead && (0 == this->contentBuffer))
+        {
+            // block-compressed file, only decompress the blocks we need
+            if (!this->ReadBlocks(ptr, readBytes)) return 0;
+        }
+        else if (this->parallelRead)
+        {
+            if ((0 == this->contentBuffer) && (0 == this->position) && (readBytes == this->size))
+            {
+                // reading the entire file, decompress directly into the destination
+                if (!this->zipFileEntry->ReadParallel(ptr, readBytes)) return 0;
+            }
+            else
+            {
+                if (0 == this->contentBuffer)
+                {
+                    this->ReadContent();
+                }
+                Memory::Copy(this->contentBuffer + this->position, ptr, readBytes);
+            }
+        }
+        else
+        {
+            if(!this->zipFileEntry->Read(ptr, readBytes)) return 0;
+        }
         this->position += readBytes;
     }
     return readBytes;
@@ -213,6 +423,14 @@ ZipFileStream::Seek(Offset offset, SeekOrigin origin)
     // make sure read/write position doesn't become invalid
     this->position = Math::n_iclamp(this->position, 0, this->size);
 
+    // parallel reads work on the decompressed content, and block-compressed
+    // files decompress the block at the new position on the next Read(),
+    // no need to skip data
+    if (this->parallelRead)
+    {
+        return;
+    }
+
     n_assert(this->position >= posBefore);
     if(this->position == posBefore) return;
 
@@ -248,6 +466,16 @@ ZipFileStream::Map()
     Stream::Map();
     n_assert(this->GetSize() > 0);
     n_assert(!this->mapBuffer);
+    if (this->parallelRead)
+    {
+        // the content buffer is kept until the stream is closed
+        if (0 == this->contentBuffer)
+        {
+            this->ReadContent();
+        }
+        this->mapBuffer = this->contentBuffer;
+        return this->mapBuffer;
+    }
     this->mapBuffer = (unsigned char*)Memory::Alloc(Memory::StreamDataHeap, this->size);
     n_assert(0 != this->mapBuffer);
     bool success = this->zipFileEntry->Read(this->mapBuffer, this->size);
@@ -264,7 +492,10 @@ ZipFileStream::Unmap()
     n_assert(this->IsOpen());
     Stream::Unmap();
     n_assert(this->mapBuffer);
-    Memory::Free(Memory::StreamDataHeap, this->mapBuffer);
+    if (!this->parallelRead)
+    {
+        Memory::Free(Memory::StreamDataHeap, this->mapBuffer);
+    }
     this->mapBuffer = NULL;
 }
 
@@ -7,6 +7,18 @@
     The file int the zip-archive is not cached. Only forward reading is allowed.
     Only one file must be opened in that archive at a time.
 
+    Files which support ZipFileEntry::ReadParallel() (and aren't opened
+    with a password) are decompressed completely on the first Read() or
+    Map() without locking the archive, so that any number of these files
+    can be open at a time and seeking is not restricted.
+
+    Block-compressed files (see ZipBlockCodec) are never decompressed
+    completely, Read() only decompresses the blocks which contain the
+    requested data. Seeking just moves the read position, so that a seek
+    in any direction costs at most one block decompression on the next
+    Read(). Partially read blocks are kept in a small LRU block cache,
+    which can be resized with SetBlockCacheSize() before opening the stream.
+
     The IO::Server allows transparent access to data in zip files through
     normal "file:" URIs by first checking whether the file is part of
     a mounted zip archive. Only if this is not the case, the file will
@@ -28,6 +40,7 @@
     (C) 2006 Radon Labs GmbH
 */
 #include "io/stream.h"
+#include "util/array.h"
 
 //------------------------------------------------------------------------------
 namespace IO
@@ -68,12 +81,84 @@ public:
     /// unmap a mapped stream
     virtual void Unmap();
 
+    /// set the number of cached blocks for block-compressed files (default is 2)
+    void SetBlockCacheSize(SizeT numBlocks);
+    /// get the number of cached blocks
+    SizeT GetBlockCacheSize() const;
+    /// return true if the file is block-compressed (only valid while open)
+    bool IsBlockCompressed() const;
+    /// get number of block decompressions since the stream has been opened
+    SizeT GetNumBlockDecodes() const;
+    /// get number of block cache hits since the stream has been opened
+    SizeT GetNumBlockCacheHits() const;
+
 private:
+    /// a decompressed block in the block cache
+    struct CachedBlock
+    {
+        IndexT blockIndex;
+        uint lastUse;
+        unsigned char* data;
+    };
+
+    /// decompress the entire file for parallel reads
+    void ReadContent();
+    /// read from a block-compressed file
+    bool ReadBlocks(void* ptr, Size numBytes);
+    /// get a decompressed block from the block cache, decompress the block if not cached
+    const unsigned char* GetCachedBlock(IndexT blockIndex);
+    /// free the block cache
+    void DiscardBlockCache();
+
     Size size;
     Position position;
     ZipFileEntry *zipFileEntry;
     unsigned char *mapBuffer;
+    unsigned char *contentBuffer;   // decompressed content for parallel reads
+    bool parallelRead;
+    bool blockRead;                 // true if file is block-compressed
+    Util::Array<CachedBlock> blockCache;
+    SizeT blockCacheSize;
+    uint blockCacheTime;
+    SizeT numBlockDecodes;
+    SizeT numBlockCacheHits;
 };
 
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+ZipFileStream::GetBlockCacheSize() const
+{
+    return this->blockCacheSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+ZipFileStream::IsBlockCompressed() const
+{
+    return this->blockRead;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+ZipFileStream::GetNumBlockDecodes() const
+{
+    return this->numBlockDecodes;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+ZipFileStream::GetNumBlockCacheHits() const
+{
+    return this->numBlockCacheHits;
+}
+
 } // namespace IO
 //------------------------------------------------------------------------------
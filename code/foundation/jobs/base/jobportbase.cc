@@ -59,6 +59,17 @@ JobPortBase::PushJob(const Ptr<Job>& job)
     // override in subclass!
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+void
+JobPortBase::PushDependentJob(const Ptr<Job>& job, const Array<Ptr<Job> >& predecessors)
+{
+    (void)job;          // shutoff unused parameter warning
+    (void)predecessors; // shutoff unused parameter warning
+    // override in subclass!
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -6,6 +6,12 @@
     A JobPort accepts Jobs for execution and is used to wait for the 
     completion of jobs or to synchronize the execution of jobs which
     depend on each other.
+
+    Dependencies between jobs can be expressed as a job graph with
+    PushDependentJob(), a job pushed this way will only start after
+    all of its predecessor jobs have finished, but it doesn't block 
+    any other jobs in the job system. Predecessors must have been pushed
+    before their successors (possibly to a different job port).
     
     (C) 2009 Radon Labs GmbH
 */
@@ -33,6 +39,8 @@ public:
 
     /// push a job for execution
     void PushJob(const Ptr<Jobs::Job>& job);
+    /// push a job which may only start after all its predecessor jobs have finished
+    void PushDependentJob(const Ptr<Jobs::Job>& job, const Util::Array<Ptr<Jobs::Job> >& predecessors);
     /// push a job chain, each job in the chain depends on previous job
     void PushJobChain(const Util::Array<Ptr<Jobs::Job> >& jobs);
     /// push a flush command (makes sure that jobs don't re-use uniform data from previous jobs)
@@ -40,7 +48,7 @@ public:
     /// push a sync command (waits for completion of all previous jobs on this port)
     void PushSync();
     
-    /// wait for completion
+    /// wait for completion of all jobs pushed to this port
     void WaitDone();
     /// check for completion, return immediately
     bool CheckDone();
@@ -26,7 +26,7 @@ class Job : public SerialJob
     __DeclareClass(Job);
 };
 } // namespace Jobs
-#elif (__WIN32__ || __XBOX360__)
+#elif (__WIN32__ || __XBOX360__ || __LINUX__)
 #include "jobs/tp/tpjob.h"
 namespace Jobs
 {
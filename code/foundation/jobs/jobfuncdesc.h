@@ -20,7 +20,7 @@ namespace Jobs
 {
 typedef SerialJobFuncDesc JobFuncDesc;
 }
-#elif (__WIN32__ || __XBOX360__)
+#elif (__WIN32__ || __XBOX360__ || __LINUX__)
 #include "jobs/tp/tpjobfuncdesc.h"
 namespace Jobs
 {
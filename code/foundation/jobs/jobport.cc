@@ -11,7 +11,7 @@ namespace Jobs
 __ImplementClass(Jobs::JobPort, 'JBPT', PS3::PS3JobPort);
 #elif (NEBULA3_USE_SERIAL_JOBSYSTEM || __WII__)
 __ImplementClass(Jobs::JobPort, 'JBPT', Jobs::SerialJobPort);
-#elif (__WIN32__ || __XBOX360__)
+#elif (__WIN32__ || __XBOX360__ || __LINUX__)
 __ImplementClass(Jobs::JobPort, 'JBPT', Jobs::TPJobPort);
 #else
 #error "Jobs::JobPort not implemented on this platform!"
@@ -26,7 +26,7 @@ class JobPort : public SerialJobPort
     __DeclareClass(JobPort);
 };
 } // namespace Jobs
-#elif (__WIN32__ || __XBOX360__)
+#elif (__WIN32__ || __XBOX360__ || __LINUX__)
 #include "jobs/tp/tpjobport.h"
 namespace Jobs
 {
@@ -105,6 +105,18 @@ SerialJobPort::PushJob(const Ptr<Job>& job)
 	}
 }
 
+//------------------------------------------------------------------------------
+/**
+    In the serial job system, all predecessors have already been executed
+    when they have been pushed, so the job can be executed immediately.
+*/
+void
+SerialJobPort::PushDependentJob(const Ptr<Job>& job, const Util::Array<Ptr<Job> >& predecessors)
+{
+    (void)predecessors; // shutoff unused parameter warning
+    this->PushJob(job);
+}
+
 //------------------------------------------------------------------------------
 /**
     Push a job chain, where each job in the chain depends on the previous
@@ -26,6 +26,8 @@ public:
     
     /// push a job for execution
     void PushJob(const Ptr<Jobs::Job>& job);
+    /// push a job which may only start after all its predecessor jobs have finished
+    void PushDependentJob(const Ptr<Jobs::Job>& job, const Util::Array<Ptr<Jobs::Job> >& predecessors);
     /// push a job chain, each job in the chain depends on previous job
     void PushJobChain(const Util::Array<Ptr<Jobs::Job> >& jobs);
     /// push a flush command (makes sure that jobs don't re-use uniform data from previous jobs)
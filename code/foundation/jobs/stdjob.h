@@ -27,6 +27,9 @@
 #include "jobs/jobfunccontext.h"
 #include "jobs/ps3/ps3jobfuncwrapper.h"
 #include "jobs/ps3/ps3spuconfig.h"
+#elif __LINUX__
+#include "core/posix/precompiled.h"
+#include "jobs/jobfunccontext.h"
 #else
 #error "Job functions not supported on this platform!"
 #endif    
@@ -21,7 +21,9 @@ using namespace Threading;
 */
 TPJob::TPJob() :
     completionCounter(0),
-    completionEvent(true)  // configure as manual reset event
+    completionEvent(true),  // configure as manual reset event
+    numPendingPredecessors(0),
+    isComplete(true)
 {
     // empty
 }
@@ -72,4 +74,105 @@ TPJob::Discard()
     JobBase::Discard();
 }
 
-} // namespace Jobs
\ No newline at end of file
+//------------------------------------------------------------------------------
+/**
+    This method will be called from a worker thread(!) when it has finished
+    processing a slice. The owning worker thread calls this method after
+    every slice, a worker thread which stole a range of slices calls it
+    once for the whole range. The thread which completes the last slice
+    dispatches all successor jobs which have no other pending predecessors.
+*/
+void
+TPJob::NotifySlicesComplete(ushort numSlices)
+{
+    int modify = -numSlices;
+
+    // NOTE: not a bug, Interlocked::Add return previous value!
+    if (Interlocked::Add(this->completionCounter, modify) == numSlices)
+    {
+        // the job is complete, no successors can be added after the 
+        // complete flag has been set, so the successor array can 
+        // be processed outside the critical section
+        this->successorCritSect.Enter();
+        this->isComplete = true;
+        this->successorCritSect.Leave();
+
+        IndexT i;
+        for (i = 0; i < this->successors.Size(); i++)
+        {
+            this->successors[i]->NotifyPredecessorComplete();
+        }
+        this->successors.Reset();
+        this->completionEvent.Signal();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Add a predecessor job. The predecessor must have been started before
+    (so that its completion state refers to the current run). The
+    pending counter is incremented before the successor is registered,
+    since the predecessor may finish on a worker thread at any time.
+*/
+void
+TPJob::AddPredecessor(TPJob* predecessor)
+{
+    n_assert(0 != predecessor);
+    n_assert(predecessor != this);
+    Interlocked::Increment(this->numPendingPredecessors);
+    if (!predecessor->AddSuccessor(this))
+    {
+        // predecessor has already finished
+        Interlocked::Decrement(this->numPendingPredecessors);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+TPJob::AddSuccessor(TPJob* successor)
+{
+    bool added = false;
+    this->successorCritSect.Enter();
+    if (!this->isComplete)
+    {
+        this->successors.Append(successor);
+        added = true;
+    }
+    this->successorCritSect.Leave();
+    return added;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TPJob::ReleaseDispatchGuard()
+{
+    this->NotifyPredecessorComplete();
+}
+
+//------------------------------------------------------------------------------
+/**
+    NOTE: this method may be called from a worker thread.
+*/
+void
+TPJob::NotifyPredecessorComplete()
+{
+    if (0 == Interlocked::Decrement(this->numPendingPredecessors))
+    {
+        this->Dispatch();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TPJob::Dispatch()
+{
+    JobSystem::Instance()->GetThreadPool()->PushJobSlices(&(this->jobSlices[0]), this->jobSlices.Size());
+}
+
+} // namespace Jobs
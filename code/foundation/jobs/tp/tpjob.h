@@ -4,6 +4,12 @@
     @class Jobs::TPJob
   
     Job implementation for the thread-pool job system.
+
+    A TPJob may depend on other jobs (its predecessors). The job
+    slices of a job with unfinished predecessors are not pushed into
+    the thread pool before the last predecessor has finished, the
+    worker thread which finishes the last predecessor dispatches
+    the job slices of its successors.
     
     (C) 2009 Radon Labs GmbH
 */
@@ -11,6 +17,8 @@
 #include "jobs/tp/tpjobslice.h"
 #include "util/fixedarray.h"
 #include "threading/event.h"
+#include "threading/criticalsection.h"
+#include "threading/interlocked.h"
 
 //------------------------------------------------------------------------------
 namespace Jobs
@@ -37,6 +45,16 @@ private:
     void NotifyStart();
     /// signal completion of N slices, called by TPWorkerThread!
     void NotifySlicesComplete(ushort numSlices);
+    /// add a predecessor job, the job will not be dispatched before the predecessor has finished
+    void AddPredecessor(TPJob* predecessor);
+    /// release the dispatch guard, dispatches the job if all predecessors have finished (called by TPJobPort)
+    void ReleaseDispatchGuard();
+    /// add a successor job, returns false if this job has already finished
+    bool AddSuccessor(TPJob* successor);
+    /// notify that a predecessor has finished, dispatches the job if it was the last one
+    void NotifyPredecessorComplete();
+    /// push the job slices into the thread pool
+    void Dispatch();
     /// get job slices
     const Util::FixedArray<TPJobSlice>& GetJobSlices() const;
     /// get pointer to the completion event
@@ -45,6 +63,10 @@ private:
     Util::FixedArray<TPJobSlice> jobSlices;
     volatile int completionCounter;
     Threading::Event completionEvent;
+    volatile int numPendingPredecessors;
+    Threading::CriticalSection successorCritSect;
+    Util::Array<TPJob*> successors;
+    bool isComplete;
 };
 
 //------------------------------------------------------------------------------
@@ -75,26 +97,13 @@ TPJob::NotifyStart()
     n_assert(0 == this->completionCounter);
     Threading::Interlocked::Exchange(&this->completionCounter, this->jobSlices.Size());
     this->completionEvent.Reset();
-}
-
-//------------------------------------------------------------------------------
-/**
-    This method will be called from a worker thread(!) when it has finished
-    processing a slice.
-    Also, due to the nature of the thread-pool system, this method will
-    not be called very frequently (not after every job slice, but only
-    max 4 times per job (number of parallel worker threads).
-*/
-inline void
-TPJob::NotifySlicesComplete(ushort numSlices)
-{
-    int modify = -numSlices;
 
-    // NOTE: not a bug, Interlocked::Add return previous value!
-    if (Threading::Interlocked::Add(this->completionCounter, modify) == numSlices)
-    {
-        this->completionEvent.Signal();
-    }
+    // the pending predecessor counter starts with 1, this guards against
+    // the job being dispatched while predecessors are still being added
+    Threading::Interlocked::Exchange(&this->numPendingPredecessors, 1);
+    this->successorCritSect.Enter();
+    this->isComplete = false;
+    this->successorCritSect.Leave();
 }
 
 } // namespace Jobs
@@ -20,7 +20,6 @@ public:
     enum Code
     {
         Run,        // run job slices
-        Sync,       // wait on an event
         
         InvalidCode,
     };
@@ -28,15 +27,11 @@ public:
     /// constructor
     TPJobCommand();
 
-    /// setup for sync command
-    void SetupSync(const Threading::Event* syncEvent);
     /// setup for run job slices command
     void SetupRun(TPJobSlice* firstSlice, ushort numSlices, ushort stride);
 
     /// get the command code
     Code GetCode() const;
-    /// get pointer to sync event object
-    const Threading::Event* GetSyncEvent() const;
     /// get pointer to first job slice
     TPJobSlice* GetFirstSlice() const;
     /// get number of slices
@@ -46,11 +41,7 @@ public:
     
 private:    
     Code code;
-    union
-    {
-        const Threading::Event* syncEvent;
-        TPJobSlice* firstSlice;
-    };
+    TPJobSlice* firstSlice;
     ushort numSlices;
     ushort stride;
 };
@@ -60,6 +51,7 @@ private:
 */
 inline
 TPJobCommand::TPJobCommand() :
+    code(InvalidCode),
     firstSlice(0),
     numSlices(0),
     stride(0)
@@ -67,18 +59,6 @@ TPJobCommand::TPJobCommand() :
     // empty
 }
 
-//------------------------------------------------------------------------------
-/**
-*/
-inline void
-TPJobCommand::SetupSync(const Threading::Event* syncEvent_)
-{
-    this->code = Sync;
-    this->syncEvent = syncEvent_;
-    this->numSlices = 0;
-    this->stride = 0;
-}
-
 //------------------------------------------------------------------------------
 /**
 */
@@ -100,16 +80,6 @@ TPJobCommand::GetCode() const
     return this->code;
 }
 
-//------------------------------------------------------------------------------
-/**
-*/
-inline const Threading::Event*
-TPJobCommand::GetSyncEvent() const
-{
-    n_assert(Sync == this->code);
-    return this->syncEvent;
-}
-
 //------------------------------------------------------------------------------
 /**
 */
@@ -39,50 +39,109 @@ void
 TPJobPort::Discard()
 {
     n_assert(this->IsValid());
-    this->lastPushedJob = 0;
+    this->pendingJobs.Clear();
+    this->newJobs.Clear();
+    this->syncJobs.Clear();
     JobPortBase::Discard();
 }
 
 //------------------------------------------------------------------------------
 /**
+    Start a job and add the jobs of the last sync point as predecessors.
+    The job will not be dispatched into the thread pool before EndJob()
+    is called, so that more predecessors can be added in between.
 */
 void
-TPJobPort::PushJob(const Ptr<Job>& job)
+TPJobPort::BeginJob(const Ptr<Job>& job)
 {
-    this->lastPushedJob = job;
+    if (this->pendingJobs.Size() >= PendingJobsPruneThreshold)
+    {
+        RemoveCompletedJobs(this->pendingJobs);
+        RemoveCompletedJobs(this->newJobs);
+    }
+    this->pendingJobs.Append(job);
+    this->newJobs.Append(job);
     job->NotifyStart();
-    const FixedArray<TPJobSlice>& jobSlices = job->GetJobSlices();
-    JobSystem::Instance()->GetThreadPool()->PushJobSlices(&(jobSlices[0]), jobSlices.Size());
+    IndexT i;
+    for (i = 0; i < this->syncJobs.Size(); i++)
+    {
+        job->AddPredecessor(this->syncJobs[i]);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TPJobPort::EndJob(const Ptr<Job>& job)
+{
+    job->ReleaseDispatchGuard();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TPJobPort::RemoveCompletedJobs(Array<Ptr<Job> >& jobs)
+{
+    IndexT i;
+    for (i = jobs.Size() - 1; i >= 0; i--)
+    {
+        if (jobs[i]->GetCompletionEvent()->Peek())
+        {
+            jobs.EraseIndex(i);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TPJobPort::PushJob(const Ptr<Job>& job)
+{
+    this->BeginJob(job);
+    this->EndJob(job);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Push a job which depends on other jobs. The job will be dispatched
+    into the thread pool by the worker thread which finishes the 
+    last predecessor job. All predecessors must have been pushed
+    before (to this or to any other job port).
+*/
+void
+TPJobPort::PushDependentJob(const Ptr<Job>& job, const Array<Ptr<Job> >& predecessors)
+{
+    this->BeginJob(job);
+    IndexT i;
+    for (i = 0; i < predecessors.Size(); i++)
+    {
+        job->AddPredecessor(predecessors[i]);
+    }
+    this->EndJob(job);
 }
 
 //------------------------------------------------------------------------------
 /**
     Push a job chain, where each job in the chain depends on the previous
-    job. This will also guarantee, that the first job slice of each
-    job will run on the same worker thread. In case of simple jobs
-    (with only one slice) this improves load.
+    job. Each job is dispatched when its predecessor has finished.
 */
 void
 TPJobPort::PushJobChain(const Array<Ptr<Job> >& jobs)
 {    
     n_assert(!jobs.IsEmpty());
-    TPJobThreadPool* threadPool = JobSystem::Instance()->GetThreadPool();
-    IndexT threadIndex = threadPool->GetNextThreadIndex();
     IndexT i;
     for (i = 0; i < jobs.Size(); i++)
     {
-        // push a sync between jobs
+        this->BeginJob(jobs[i]);
         if (i > 0)
         {
-            JobSystem::Instance()->GetThreadPool()->PushSync(jobs[i - 1]->GetCompletionEvent());
+            jobs[i]->AddPredecessor(jobs[i - 1]);
         }
-
-        // push the job slices
-        jobs[i]->NotifyStart();
-        const FixedArray<TPJobSlice>& jobSlices = jobs[i]->GetJobSlices();
-        JobSystem::Instance()->GetThreadPool()->PushJobSlices(&(jobSlices[0]), jobSlices.Size(), threadIndex);
+        this->EndJob(jobs[i]);
     }
-    this->lastPushedJob = jobs.Back();
 }
 
 //------------------------------------------------------------------------------
@@ -98,13 +157,22 @@ TPJobPort::PushFlush()
 
 //------------------------------------------------------------------------------
 /**
+    In the thread-pool job system, a sync doesn't block the worker threads,
+    instead all jobs pushed to this port before the sync become 
+    predecessors of all jobs pushed after the sync.
+
+    Only the jobs pushed since the previous sync become predecessors,
+    since they already depend on the jobs before the previous sync.
+    If no job has been pushed since the previous sync, the sync jobs
+    remain the same.
 */
 void
 TPJobPort::PushSync()
 {
-    if (this->lastPushedJob.isvalid())
+    if (!this->newJobs.IsEmpty())
     {
-        JobSystem::Instance()->GetThreadPool()->PushSync(this->lastPushedJob->GetCompletionEvent());
+        this->syncJobs = this->newJobs;
+        this->newJobs.Clear();
     }
 }
 
@@ -114,8 +182,14 @@ TPJobPort::PushSync()
 void
 TPJobPort::WaitDone()
 {
-    n_assert(this->lastPushedJob.isvalid());
-    this->lastPushedJob->GetCompletionEvent()->Wait();
+    IndexT i;
+    for (i = 0; i < this->pendingJobs.Size(); i++)
+    {
+        this->pendingJobs[i]->GetCompletionEvent()->Wait();
+    }
+    this->pendingJobs.Clear();
+    this->newJobs.Clear();
+    this->syncJobs.Clear();
 }
 
 //------------------------------------------------------------------------------
@@ -124,11 +198,18 @@ TPJobPort::WaitDone()
 bool
 TPJobPort::CheckDone()
 {
-    if (this->lastPushedJob.isvalid())
+    IndexT i;
+    for (i = 0; i < this->pendingJobs.Size(); i++)
     {
-        return this->lastPushedJob->GetCompletionEvent()->Peek();
+        if (!this->pendingJobs[i]->GetCompletionEvent()->Peek())
+        {
+            return false;
+        }
     }
+    this->pendingJobs.Clear();
+    this->newJobs.Clear();
+    this->syncJobs.Clear();
     return true;
 }
 
-} // namespace Jobs
\ No newline at end of file
+} // namespace Jobs
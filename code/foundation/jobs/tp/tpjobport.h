@@ -4,6 +4,12 @@
     @class Jobs::TPJobPort
   
     Thread-pool implementation of JobPort.
+
+    Dependencies between jobs (PushDependentJob(), PushJobChain() and
+    PushSync()) are resolved as edges of a job graph: a job with
+    unfinished predecessors is not pushed into the thread pool 
+    before its last predecessor has finished, other jobs in the 
+    thread pool are never blocked by a dependency.
     
     (C) 2009 Radon Labs GmbH
 */    
@@ -26,20 +32,32 @@ public:
     
     /// push a job for execution
     void PushJob(const Ptr<Job>& job);
+    /// push a job which may only start after all its predecessor jobs have finished
+    void PushDependentJob(const Ptr<Job>& job, const Util::Array<Ptr<Jobs::Job> >& predecessors);
     /// push a job chain, each job in the chain depends on previous job
     void PushJobChain(const Util::Array<Ptr<Jobs::Job> >& jobs);
     /// push a flush command (no effect in thread-pool job system)
     void PushFlush();
-    /// push a sync command
+    /// push a sync command, following jobs on this port depend on all previous jobs
     void PushSync();
 
-    /// wait for completion
+    /// wait for completion of all jobs pushed to this port
     void WaitDone();
     /// check for completion, return immediately
     bool CheckDone();
 
 private:
-    Ptr<Job> lastPushedJob;     // pointer to last pushed job
+    /// start a job, returns with the dispatch guard of the job held
+    void BeginJob(const Ptr<Job>& job);
+    /// release the dispatch guard of a job, the job may start immediately
+    void EndJob(const Ptr<Job>& job);
+    /// remove finished jobs from a job array
+    static void RemoveCompletedJobs(Util::Array<Ptr<Job> >& jobs);
+
+    static const SizeT PendingJobsPruneThreshold = 64;
+    Util::Array<Ptr<Job> > pendingJobs;     // jobs pushed since the last WaitDone()
+    Util::Array<Ptr<Job> > newJobs;         // jobs pushed since the last PushSync()
+    Util::Array<Ptr<Job> > syncJobs;        // jobs which must finish before following jobs may start
 };
 
 } // namespace Jobs
@@ -29,6 +29,7 @@ public:
 
 private:
     friend class TPJobPort;
+    friend class TPJob;
 
     /// get pointer to thread pool
     TPJobThreadPool* GetThreadPool();
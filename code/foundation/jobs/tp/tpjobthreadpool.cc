@@ -16,8 +16,9 @@ using namespace Threading;
 /**
 */
 TPJobThreadPool::TPJobThreadPool() :
-    isValid(false),
-    nextThreadIndex(0)
+    numIdleWorkers(0),
+    nextThreadIndex(0),
+    isValid(false)
 {
     // empty
 }
@@ -39,21 +40,45 @@ TPJobThreadPool::Setup()
     n_assert(!this->IsValid());
     this->isValid = true;
 
-    // setup worker threads
+    // setup one worker thread per CPU core, leave one core for the main thread
+    #if __XBOX360__
+    SizeT numWorkerThreads = 4;
+    #else
+    SystemInfo systemInfo;
+    SizeT numWorkerThreads = systemInfo.GetNumCpuCores() - 1;
+    if (numWorkerThreads < 1)
+    {
+        numWorkerThreads = 1;
+    }
+    else if (numWorkerThreads > MaxNumWorkerThreads)
+    {
+        numWorkerThreads = MaxNumWorkerThreads;
+    }
+    #endif
+    this->workerThreads.SetSize(numWorkerThreads);
+    this->numIdleWorkers = 0;
+
     // FIXME: on Win32 platforms handle distribution of threads to
     // cores a bit more clever...
     String threadName;
     IndexT i;
-    for (i = 0; i < NumWorkerThreads; i++)
+    for (i = 0; i < numWorkerThreads; i++)
     {
         threadName.Format("JobWorker%d", i);
         this->workerThreads[i] = TPWorkerThread::Create();
+        this->workerThreads[i]->SetThreadPool(this, i);
         this->workerThreads[i]->SetPriority(Thread::High);
         this->workerThreads[i]->SetCoreId(Cpu::JobThreadFirstCore + i);
         this->workerThreads[i]->SetName(threadName);
-        this->workerThreads[i]->Start();
     }
     this->nextThreadIndex = 0;
+
+    // only start the threads when all of them exist, since a worker
+    // thread may try to steal from any other worker thread
+    for (i = 0; i < numWorkerThreads; i++)
+    {
+        this->workerThreads[i]->Start();
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -65,11 +90,17 @@ TPJobThreadPool::Discard()
     n_assert(this->IsValid());
     this->isValid = false;
     IndexT i;
-    for (i = 0; i < NumWorkerThreads; i++)
+    for (i = 0; i < this->workerThreads.Size(); i++)
     {
         this->workerThreads[i]->Stop();
+    }
+    // release the threads after all of them have stopped, the running
+    // threads may still steal from stopped threads
+    for (i = 0; i < this->workerThreads.Size(); i++)
+    {
         this->workerThreads[i] = 0;
     }
+    this->workerThreads.SetSize(0);
 }
 
 //------------------------------------------------------------------------------
@@ -81,53 +112,68 @@ TPJobThreadPool::PushJobSlices(TPJobSlice* firstSlice, SizeT numSlices, IndexT t
     n_assert(0 != firstSlice);
     n_assert(numSlices > 0);
 
-    // override start thread index if defined
+    // get the start thread index, this may be called from several
+    // threads at once, so the round-robin index is advanced atomically
+    SizeT numWorkerThreads = this->workerThreads.Size();
+    IndexT startIndex;
     if (InvalidIndex != threadIndex)
     {
-        this->nextThreadIndex = threadIndex;
+        startIndex = threadIndex;
     }
-
-    // split the job slices into NumWorkerThreads chunks
-    IndexT i;
-    ushort numWorkUnitSlices[NumWorkerThreads];
-    for (i = 0; i < NumWorkerThreads; i++)
+    else
     {
-        numWorkUnitSlices[i] = ushort(numSlices / NumWorkerThreads);
+        startIndex = uint(Interlocked::Increment(this->nextThreadIndex)) % numWorkerThreads;
     }
-    SizeT remainder = numSlices % NumWorkerThreads;
-    ushort stride = NumWorkerThreads;
-    for (i = 0; i < remainder; i++)
+
+    // split the job slices into one strided chunk per worker thread,
+    // worker threads which run out of work will steal slices from
+    // busy worker threads
+    ushort stride = ushort(numWorkerThreads);
+    SizeT numChunks = (numSlices < numWorkerThreads) ? numSlices : numWorkerThreads;
+    SizeT remainder = numSlices % numWorkerThreads;
+    IndexT i;
+    for (i = 0; i < numChunks; i++)
     {
-        numWorkUnitSlices[i] += 1;
+        ushort numChunkSlices = ushort(numSlices / numWorkerThreads);
+        if (i < remainder)
+        {
+            numChunkSlices += 1;
+        }
+        TPJobCommand jobCmd;
+        jobCmd.SetupRun(firstSlice + i, numChunkSlices, stride);
+        this->workerThreads[(startIndex + i) % numWorkerThreads]->PushJobCommand(jobCmd);
     }
-    for (i = 0; i < NumWorkerThreads; i++)
+
+    // if some worker threads are sleeping, wake them up so that they
+    // can steal from the worker threads we just fed
+    if (this->numIdleWorkers > 0)
     {
-        if (numWorkUnitSlices[i] > 0)
+        for (i = 0; i < numWorkerThreads; i++)
         {
-            TPJobCommand jobCmd;
-            jobCmd.SetupRun(firstSlice + i, numWorkUnitSlices[i], stride);
-            this->workerThreads[nextThreadIndex++]->PushJobCommand(jobCmd);
-            if (this->nextThreadIndex >= NumWorkerThreads)
-            {
-                this->nextThreadIndex = 0;
-            }
+            this->workerThreads[i]->Wakeup();
         }
     }
 }
 
 //------------------------------------------------------------------------------
 /**
+    Try to steal job slices from another worker thread, starting with
+    the neighbour of the thief. This method is called from worker threads.
 */
-void
-TPJobThreadPool::PushSync(const Threading::Event* syncEvent)
+bool
+TPJobThreadPool::StealJobSlices(IndexT thiefIndex, TPJobCommand& outCmd)
 {
-    TPJobCommand jobCmd;
-    jobCmd.SetupSync(syncEvent);
+    SizeT numWorkerThreads = this->workerThreads.Size();
     IndexT i;
-    for (i = 0; i < NumWorkerThreads; i++)
+    for (i = 1; i < numWorkerThreads; i++)
     {
-        this->workerThreads[i]->PushJobCommand(jobCmd);
+        IndexT victimIndex = (thiefIndex + i) % numWorkerThreads;
+        if (this->workerThreads[victimIndex]->StealJobSlices(outCmd))
+        {
+            return true;
+        }
     }
+    return false;
 }
 
 } // namespace Jobs
@@ -4,14 +4,21 @@
     @class Jobs::TPJobThreadPool
     
     Manages the thread-pool, distributes TPJobSlice objects to the
-    worker threads.
+    worker threads. The number of worker threads is derived from the
+    number of CPU cores reported by System::SystemInfo. Job slices
+    are distributed round-robin to the worker threads, idle worker
+    threads steal job slices from busy worker threads (see
+    TPWorkerThread for details).
 
-    FIXME: class is currently not thread-safe!
+    PushJobSlices() may be called from any thread (worker threads
+    dispatch successor jobs when a predecessor job has finished).
     
     (C) 2009 Radon Labs GmbH
 */
 #include "core/types.h"
+#include "util/fixedarray.h"
 #include "jobs/tp/tpworkerthread.h"
+#include "threading/interlocked.h"
 
 //------------------------------------------------------------------------------
 namespace Jobs
@@ -31,19 +38,27 @@ public:
     /// return true if object is setup
     bool IsValid() const;
 
-    /// push a sync command into the thread pool
-    void PushSync(const Threading::Event* syncEvent);
     /// push job slices into the the thread pool
     void PushJobSlices(TPJobSlice* firstSlice, SizeT numSlices, IndexT threadIndex=InvalidIndex);
     /// get a suitable worker thread index (optimally a thread with currently no load)
     IndexT GetNextThreadIndex() const;
+    /// get number of worker threads
+    SizeT GetNumWorkerThreads() const;
 
 private:
-    static const SizeT NumWorkerThreads = 4;
-    Threading::CriticalSection critSect;
-    Ptr<TPWorkerThread> workerThreads[NumWorkerThreads];
-    Util::Array<TPJobSlice*> tmpJobSliceQueue[NumWorkerThreads];
-    IndexT nextThreadIndex;
+    friend class TPWorkerThread;
+
+    /// steal job slices from another worker thread (called by idle worker threads)
+    bool StealJobSlices(IndexT thiefIndex, TPJobCommand& outCmd);
+    /// called by a worker thread before it goes to sleep
+    void EnterIdle();
+    /// called by a worker thread after it woke up
+    void LeaveIdle();
+
+    static const SizeT MaxNumWorkerThreads = 16;
+    Util::FixedArray<Ptr<TPWorkerThread> > workerThreads;
+    volatile int numIdleWorkers;
+    volatile int nextThreadIndex;
     bool isValid;
 };
 
@@ -62,7 +77,34 @@ TPJobThreadPool::IsValid() const
 inline IndexT
 TPJobThreadPool::GetNextThreadIndex() const
 {
-    return this->nextThreadIndex;
+    return uint(this->nextThreadIndex) % this->workerThreads.Size();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+TPJobThreadPool::GetNumWorkerThreads() const
+{
+    return this->workerThreads.Size();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+TPJobThreadPool::EnterIdle()
+{
+    Threading::Interlocked::Increment(this->numIdleWorkers);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+TPJobThreadPool::LeaveIdle()
+{
+    Threading::Interlocked::Decrement(this->numIdleWorkers);
 }
 
 } // namespace Jobs
@@ -4,6 +4,7 @@
 //------------------------------------------------------------------------------
 #include "stdneb.h"
 #include "jobs/tp/tpworkerthread.h"
+#include "jobs/tp/tpjobthreadpool.h"
 #include "jobs/job.h"
 #include "jobs/jobfuncdesc.h"
 #include "debug/debugserver.h"
@@ -18,9 +19,14 @@ using namespace Util;
 /**
 */
 TPWorkerThread::TPWorkerThread() :
+    threadPool(0),
+    workerIndex(InvalidIndex),
+    queue(InitialQueueCapacity),
+    queueHead(0),
+    queueSize(0),
     scratchBuffer(0)
 {
-    this->jobQueue.SetSignalOnEnqueueEnabled(true);
+    // empty
 }
 
 //------------------------------------------------------------------------------
@@ -28,7 +34,19 @@ TPWorkerThread::TPWorkerThread() :
 */
 TPWorkerThread::~TPWorkerThread()
 {
-    n_assert(this->jobQueue.IsEmpty());
+    n_assert(0 == this->queueSize);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TPWorkerThread::SetThreadPool(TPJobThreadPool* pool, IndexT index)
+{
+    n_assert(0 != pool);
+    n_assert(InvalidIndex != index);
+    this->threadPool = pool;
+    this->workerIndex = index;
 }
 
 //------------------------------------------------------------------------------
@@ -37,7 +55,33 @@ TPWorkerThread::~TPWorkerThread()
 void
 TPWorkerThread::EmitWakeupSignal()
 {
-    this->jobQueue.Signal();
+    this->wakeupEvent.Signal();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TPWorkerThread::Wakeup()
+{
+    this->wakeupEvent.Signal();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+TPWorkerThread::GrowQueue()
+{
+    SizeT oldCapacity = this->queue.Size();
+    FixedArray<TPJobCommand> newQueue(oldCapacity * 2);
+    IndexT i;
+    for (i = 0; i < this->queueSize; i++)
+    {
+        newQueue[i] = this->queue[(this->queueHead + i) % oldCapacity];
+    }
+    this->queue = newQueue;
+    this->queueHead = 0;
 }
 
 //------------------------------------------------------------------------------
@@ -46,7 +90,81 @@ TPWorkerThread::EmitWakeupSignal()
 void
 TPWorkerThread::PushJobCommand(const TPJobCommand& cmd)
 {
-    this->jobQueue.Enqueue(cmd);
+    this->queueCritSect.Enter();
+    if (this->queueSize == this->queue.Size())
+    {
+        this->GrowQueue();
+    }
+    this->queue[(this->queueHead + this->queueSize) % this->queue.Size()] = cmd;
+    this->queueSize++;
+    this->queueCritSect.Leave();
+    this->wakeupEvent.Signal();
+}
+
+//------------------------------------------------------------------------------
+/**
+    Take the next command from the front of the queue. A run command
+    is handed out one slice at a time, so that the remaining slices
+    stay visible to stealing worker threads.
+*/
+bool
+TPWorkerThread::TakeJobCommand(TPJobCommand& outCmd)
+{
+    bool result = false;
+    this->queueCritSect.Enter();
+    if (this->queueSize > 0)
+    {
+        TPJobCommand& front = this->queue[this->queueHead];
+        ushort stride = front.GetStride();
+        outCmd.SetupRun(front.GetFirstSlice(), 1, stride);
+        if (front.GetNumSlices() > 1)
+        {
+            front.SetupRun(front.GetFirstSlice() + stride, front.GetNumSlices() - 1, stride);
+        }
+        else
+        {
+            this->queueHead = (this->queueHead + 1) % this->queue.Size();
+            this->queueSize--;
+        }
+        result = true;
+    }
+    this->queueCritSect.Leave();
+    return result;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Steal job slices from this worker thread, this method is called
+    from another (idle) worker thread. The thief takes the back half
+    of the remaining slices of the command at the front of the queue.
+*/
+bool
+TPWorkerThread::StealJobSlices(TPJobCommand& outCmd)
+{
+    bool result = false;
+    this->queueCritSect.Enter();
+    if (this->queueSize > 0)
+    {
+        TPJobCommand& front = this->queue[this->queueHead];
+        ushort numSlices = front.GetNumSlices();
+        ushort stride = front.GetStride();
+        if (numSlices > 1)
+        {
+            ushort numStolen = numSlices / 2;
+            ushort numKept = numSlices - numStolen;
+            outCmd.SetupRun(front.GetFirstSlice() + numKept * stride, numStolen, stride);
+            front.SetupRun(front.GetFirstSlice(), numKept, stride);
+        }
+        else
+        {
+            outCmd = front;
+            this->queueHead = (this->queueHead + 1) % this->queue.Size();
+            this->queueSize--;
+        }
+        result = true;
+    }
+    this->queueCritSect.Leave();
+    return result;
 }
 
 //------------------------------------------------------------------------------
@@ -55,36 +173,42 @@ TPWorkerThread::PushJobCommand(const TPJobCommand& cmd)
 void
 TPWorkerThread::DoWork()
 {
+    n_assert(0 != this->threadPool);
+
     // allocate the scratch buffer
     n_assert(0 == this->scratchBuffer);
     this->scratchBuffer = (ubyte*) Memory::Alloc(Memory::ScratchHeap, MaxScratchSize);
 
-    Array<TPJobCommand> curCommands;
+    TPJobCommand curCmd;
     while (!this->ThreadStopRequested())
     {
-        // dequeue current work entries
-        this->jobQueue.DequeueAll(curCommands);
-
-        // process work entries
-        IndexT i;
-        for (i = 0; i < curCommands.Size(); i++)
+        if (this->TakeJobCommand(curCmd))
+        {
+            // process a slice from our own queue
+            this->ProcessJobSlices(curCmd.GetFirstSlice(), curCmd.GetNumSlices(), curCmd.GetStride());
+        }
+        else if (this->threadPool->StealJobSlices(this->workerIndex, curCmd))
         {
-            const TPJobCommand& curCmd = curCommands[i];
-            switch (curCmd.GetCode())
+            this->ProcessJobSlices(curCmd.GetFirstSlice(), curCmd.GetNumSlices(), curCmd.GetStride());
+        }
+        else
+        {
+            // nothing to do, announce that we're idle and try to steal
+            // once more before going to sleep, this closes the gap
+            // where new work is pushed after the first steal attempt
+            this->threadPool->EnterIdle();
+            if (this->threadPool->StealJobSlices(this->workerIndex, curCmd))
             {
-                case TPJobCommand::Run:
-                    this->ProcessJobSlices(curCmd.GetFirstSlice(), curCmd.GetNumSlices(), curCmd.GetStride());
-                    break;
-
-                case TPJobCommand::Sync:
-                    curCmd.GetSyncEvent()->Wait();
-                    break;
+                this->threadPool->LeaveIdle();
+                this->ProcessJobSlices(curCmd.GetFirstSlice(), curCmd.GetNumSlices(), curCmd.GetStride());
+            }
+            else
+            {
+                this->wakeupEvent.Wait();
+                this->threadPool->LeaveIdle();
             }
         }
-
-        // wait for new jobs
-        this->jobQueue.Wait();
-    }   
+    }
 
     // free scratch buffer
     Memory::Free(Memory::ScratchHeap, this->scratchBuffer);
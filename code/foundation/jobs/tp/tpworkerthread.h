@@ -2,19 +2,29 @@
 //------------------------------------------------------------------------------
 /**
     @class Jobs::TPWorkerThread
-  
+
     The worker thread class of the thread-pool job system.
-    
+
+    Each worker thread owns a command deque. The owner takes job slices
+    one by one from the front of its deque, idle worker threads steal
+    half of the remaining slices of the front command from a busy
+    worker. Dependencies between jobs are resolved by TPJobPort before
+    their slices are pushed, so a queue never blocks.
+
     (C) 2009 Radon Labs GmbH
 */
 #include "threading/thread.h"
-#include "threading/safequeue.h"
-#include "jobs/tp/tpjobcommand.h"     
+#include "threading/criticalsection.h"
+#include "threading/event.h"
+#include "util/fixedarray.h"
+#include "jobs/tp/tpjobcommand.h"
 #include "debug/debugtimer.h"
 
 //------------------------------------------------------------------------------
 namespace Jobs
 {
+class TPJobThreadPool;
+
 class TPWorkerThread : public Threading::Thread
 {
     __DeclareClass(TPWorkerThread);
@@ -23,26 +33,43 @@ public:
     TPWorkerThread();
     /// destructor
     virtual ~TPWorkerThread();
-    
+
+    /// set the owning thread pool and the index of this worker thread in the pool
+    void SetThreadPool(TPJobThreadPool* threadPool, IndexT workerIndex);
     /// called if thread needs a wakeup call before stopping
     virtual void EmitWakeupSignal();
     /// this method runs in the thread context
-    virtual void DoWork();      
+    virtual void DoWork();
     /// request threading code to stop, returns when thread has actually finished
     void Stop();
 
     /// push a job command onto the job queue
     void PushJobCommand(const TPJobCommand& cmd);
+    /// wakeup the thread if it is waiting for work
+    void Wakeup();
+    /// steal job slices from the front of the queue (called from other worker threads)
+    bool StealJobSlices(TPJobCommand& outCmd);
 
 private:
+    /// take a single job slice from the front of the own queue
+    bool TakeJobCommand(TPJobCommand& outCmd);
+    /// grow the command queue ring buffer
+    void GrowQueue();
     /// process a single job slice
     void ProcessJobSlices(TPJobSlice* firstSlice, ushort numSlices, ushort stride);
 
     static const SizeT MaxScratchSize = (64 * 1024);    // 64 kB max scratch size
+    static const SizeT InitialQueueCapacity = 64;
 
-    Threading::SafeQueue<TPJobCommand> jobQueue;
+    TPJobThreadPool* threadPool;
+    IndexT workerIndex;
+    Threading::CriticalSection queueCritSect;
+    Util::FixedArray<TPJobCommand> queue;
+    IndexT queueHead;
+    SizeT queueSize;
+    Threading::Event wakeupEvent;
     ubyte* scratchBuffer;
-      
+
 #if NEBULA3_ENABLE_PROFILING
     _declare_timer(debugTimer);
 #endif
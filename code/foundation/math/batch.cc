@@ -0,0 +1,272 @@
+//------------------------------------------------------------------------------
+//  batch.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "math/batch.h"
+
+namespace Math
+{
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+Batch::MultiplyMatrices(const matrix44* m0, const matrix44* m1, matrix44* outMatrices, SizeT num)
+{
+    n_assert((0 != m0) && (0 != m1) && (0 != outMatrices));
+    IndexT i;
+    for (i = 0; i < num; i++)
+    {
+        outMatrices[i] = matrix44::multiply(m0[i], m1[i]);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Same as above with a shared right hand matrix, e.g. to transform
+    model matrices into view space. The output array may not be
+    identical with m1.
+*/
+void
+Batch::MultiplyMatrices(const matrix44* m0, const matrix44& m1, matrix44* outMatrices, SizeT num)
+{
+    n_assert((0 != m0) && (0 != outMatrices));
+    IndexT i;
+    for (i = 0; i < num; i++)
+    {
+        outMatrices[i] = matrix44::multiply(m0[i], m1);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    The w component of the source decides whether a point (w = 1) or a
+    direction (w = 0) is transformed.
+*/
+void
+Batch::TransformPoints(const matrix44& m, const float4* points, float4* outPoints, SizeT num)
+{
+    n_assert((0 != points) && (0 != outPoints));
+    const float4 r0 = m.getrow0();
+    const float4 r1 = m.getrow1();
+    const float4 r2 = m.getrow2();
+    const float4 r3 = m.getrow3();
+    IndexT i;
+    for (i = 0; i < num; i++)
+    {
+        const float4& p = points[i];
+        outPoints[i] = float4::multiply(float4::splat_x(p), r0) + float4::multiply(float4::splat_y(p), r1) +
+                       float4::multiply(float4::splat_z(p), r2) + float4::multiply(float4::splat_w(p), r3);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Transforms the center point and the extents of each box instead of
+    its 8 corners: the extents along each axis of the destination space
+    are the extents weighted with the absolute rotation/scale rows of the
+    matrix. The result is identical to bbox::transform() for affine
+    matrices, projective matrices are not supported.
+*/
+void
+Batch::TransformBoxes(const bbox* boxes, const matrix44* matrices, bbox* outBoxes, SizeT num)
+{
+    n_assert((0 != boxes) && (0 != matrices) && (0 != outBoxes));
+    IndexT i;
+    for (i = 0; i < num; i++)
+    {
+        const matrix44& m = matrices[i];
+        float4 center = (boxes[i].pmax + boxes[i].pmin) * 0.5f;
+        float4 extents = (boxes[i].pmax - boxes[i].pmin) * 0.5f;
+        float4 newCenter = float4::multiply(float4::splat_x(center), m.getrow0()) + float4::multiply(float4::splat_y(center), m.getrow1()) +
+                           float4::multiply(float4::splat_z(center), m.getrow2()) + m.getrow3();
+        float4 newExtents = float4::multiply(float4::splat_x(extents), m.getrow0().abs()) +
+                            float4::multiply(float4::splat_y(extents), m.getrow1().abs()) +
+                            float4::multiply(float4::splat_z(extents), m.getrow2().abs());
+        outBoxes[i].pmin = newCenter - newExtents;
+        outBoxes[i].pmax = newCenter + newExtents;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Extracts the 6 side planes of the view volume from the view-projection
+    matrix once, and stores them transposed in two groups of 4 planes (the
+    last 2 planes are dummies which never clip). For each box the signed
+    distances of the center to 4 planes and the projected extents along
+    the 4 plane normals are then computed in a single float4 each. A box
+    is outside if it is completely behind one of the planes, and inside
+    if it is completely in front of all planes. This gives the same
+    results as bbox::clipstatus(), which transforms all 8 corners into
+    clip space, except for boxes behind the viewer (w < 0) which
+    bbox::clipstatus() may report as clipped although they are outside.
+*/
+void
+Batch::ClipBoxes(const matrix44& viewProjection, const bbox* boxes, ClipStatus::Type* outStatus, SizeT num)
+{
+    n_assert((0 != boxes) && (0 != outStatus));
+
+    // the columns of the view-projection matrix give the clip space
+    // coordinates, a point is inside if -w <= x,y,z <= w
+    matrix44 columns = matrix44::transpose(viewProjection);
+    float4 planes[8];
+    planes[0] = columns.getrow3() + columns.getrow0();
+    planes[1] = columns.getrow3() - columns.getrow0();
+    planes[2] = columns.getrow3() + columns.getrow1();
+    planes[3] = columns.getrow3() - columns.getrow1();
+    planes[4] = columns.getrow3() + columns.getrow2();
+    planes[5] = columns.getrow3() - columns.getrow2();
+    planes[6].set(0.0f, 0.0f, 0.0f, 1.0f);
+    planes[7].set(0.0f, 0.0f, 0.0f, 1.0f);
+
+    // transpose into structure-of-arrays form
+    float4 nx[2], ny[2], nz[2], nd[2], ax[2], ay[2], az[2];
+    IndexT group;
+    for (group = 0; group < 2; group++)
+    {
+        const float4* p = &planes[group * 4];
+        nx[group].set(p[0].x(), p[1].x(), p[2].x(), p[3].x());
+        ny[group].set(p[0].y(), p[1].y(), p[2].y(), p[3].y());
+        nz[group].set(p[0].z(), p[1].z(), p[2].z(), p[3].z());
+        nd[group].set(p[0].w(), p[1].w(), p[2].w(), p[3].w());
+        ax[group] = nx[group].abs();
+        ay[group] = ny[group].abs();
+        az[group] = nz[group].abs();
+    }
+
+    const float4 zero(0.0f, 0.0f, 0.0f, 0.0f);
+    IndexT i;
+    for (i = 0; i < num; i++)
+    {
+        float4 center = (boxes[i].pmax + boxes[i].pmin) * 0.5f;
+        float4 extents = (boxes[i].pmax - boxes[i].pmin) * 0.5f;
+        float4 cx = float4::splat_x(center);
+        float4 cy = float4::splat_y(center);
+        float4 cz = float4::splat_z(center);
+        float4 ex = float4::splat_x(extents);
+        float4 ey = float4::splat_y(extents);
+        float4 ez = float4::splat_z(extents);
+
+        float4 dist0 = float4::multiply(nx[0], cx) + float4::multiply(ny[0], cy) + float4::multiply(nz[0], cz) + nd[0];
+        float4 dist1 = float4::multiply(nx[1], cx) + float4::multiply(ny[1], cy) + float4::multiply(nz[1], cz) + nd[1];
+        float4 radius0 = float4::multiply(ax[0], ex) + float4::multiply(ay[0], ey) + float4::multiply(az[0], ez);
+        float4 radius1 = float4::multiply(ax[1], ex) + float4::multiply(ay[1], ey) + float4::multiply(az[1], ez);
+
+        if (float4::less4_any(dist0 + radius0, zero) || float4::less4_any(dist1 + radius1, zero))
+        {
+            outStatus[i] = ClipStatus::Outside;
+        }
+        else if (float4::less4_any(dist0 - radius0, zero) || float4::less4_any(dist1 - radius1, zero))
+        {
+            outStatus[i] = ClipStatus::Clipped;
+        }
+        else
+        {
+            outStatus[i] = ClipStatus::Inside;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Uses a polynomial approximation of the slerp weights
+    sin(t * omega) / sin(omega) in cos(omega) instead of acos() and sin()
+    (D. Eberly, "A Fast and Accurate Algorithm for Computing SLERP"). The
+    series is cut off after 12 terms, the last term is scaled by a fitted
+    factor which brings the maximum error below 1e-6. Since t is the
+    same for all quaternions, the coefficients are computed once, and
+    the weights of 4 quaternions are evaluated in each float4. Like
+    quaternion::slerp() this interpolates along the shorter arc.
+*/
+void
+Batch::SlerpQuaternions(const quaternion* q0, const quaternion* q1, scalar t, quaternion* outQuaternions, SizeT num)
+{
+    n_assert((0 != q0) && (0 != q1) && (0 != outQuaternions));
+
+    // per-call coefficients of the weights for q1 (t) and q0 (1 - t),
+    // term i is (t^2 / (i * (2i + 1)) - i / (2i + 1)) * (cos(omega) - 1)
+    const IndexT NumTerms = 12;
+    const scalar LastTermScale = 1.894f;
+    scalar d = 1.0f - t;
+    float4 coeffT[NumTerms];
+    float4 coeffD[NumTerms];
+    IndexT term;
+    for (term = 0; term < NumTerms; term++)
+    {
+        scalar i = scalar(term + 1);
+        scalar u = 1.0f / (i * (2.0f * i + 1.0f));
+        scalar v = i / (2.0f * i + 1.0f);
+        if (term == (NumTerms - 1))
+        {
+            u *= LastTermScale;
+            v *= LastTermScale;
+        }
+        coeffT[term] = float4::splat(u * t * t - v);
+        coeffD[term] = float4::splat(u * d * d - v);
+    }
+    const float4 one = float4::splat(1.0f);
+
+    IndexT i;
+    for (i = 0; i < num; i += 4)
+    {
+        // gather the cosines of 4 quaternion pairs, flip signs for the shorter arc
+        SizeT numLanes = n_min(4, num - i);
+        NEBULA3_ALIGN16 scalar cosOmega[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+        NEBULA3_ALIGN16 scalar sign[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+        IndexT lane;
+        for (lane = 0; lane < numLanes; lane++)
+        {
+            cosOmega[lane] = quaternion::dot(q0[i + lane], q1[i + lane]);
+            if (cosOmega[lane] < 0.0f)
+            {
+                cosOmega[lane] = -cosOmega[lane];
+                sign[lane] = -1.0f;
+            }
+        }
+        float4 xm1;
+        xm1.load(cosOmega);
+        xm1 = xm1 - one;
+
+        // evaluate both weight polynomials with Horner's scheme
+        float4 weightT = one + float4::multiply(coeffT[NumTerms - 1], xm1);
+        float4 weightD = one + float4::multiply(coeffD[NumTerms - 1], xm1);
+        for (term = NumTerms - 2; term >= 0; term--)
+        {
+            weightT = one + float4::multiply(float4::multiply(coeffT[term], xm1), weightT);
+            weightD = one + float4::multiply(float4::multiply(coeffD[term], xm1), weightD);
+        }
+        float4 signs;
+        signs.load(sign);
+        weightT = float4::multiply(weightT * t, signs);
+        weightD = weightD * d;
+
+        NEBULA3_ALIGN16 scalar wT[4];
+        NEBULA3_ALIGN16 scalar wD[4];
+        weightT.store(wT);
+        weightD.store(wD);
+        for (lane = 0; lane < numLanes; lane++)
+        {
+            float4 v0, v1;
+            v0.load((const scalar*)&q0[i + lane]);
+            v1.load((const scalar*)&q1[i + lane]);
+            outQuaternions[i + lane] = v0 * wD[lane] + v1 * wT[lane];
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+Batch::NormalizeQuaternions(const quaternion* quaternions, quaternion* outQuaternions, SizeT num)
+{
+    n_assert((0 != quaternions) && (0 != outQuaternions));
+    IndexT i;
+    for (i = 0; i < num; i++)
+    {
+        outQuaternions[i] = quaternion::normalize(quaternions[i]);
+    }
+}
+
+} // namespace Math
@@ -0,0 +1,49 @@
+#pragma once
+#ifndef MATH_BATCH_H
+#define MATH_BATCH_H
+//------------------------------------------------------------------------------
+/**
+    @class Math::Batch
+    
+    Stream kernels which apply a math operation to whole arrays of values.
+    Use these instead of calling the per-value functions in a loop when
+    updating thousands of transforms, bounding boxes or joints at once.
+    Per-call constants are set up once per array, and the kernels are
+    written against the float4 API, so that they use the SIMD
+    instructions of the math backend on every platform.
+
+    Unless noted otherwise, the source and destination arrays may be
+    identical, but must not partially overlap.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "math/matrix44.h"
+#include "math/quaternion.h"
+#include "math/bbox.h"
+#include "math/clipstatus.h"
+
+//------------------------------------------------------------------------------
+namespace Math
+{
+class Batch
+{
+public:
+    /// multiply num pairs of matrices (outMatrices[i] = m0[i] * m1[i])
+    static void MultiplyMatrices(const matrix44* m0, const matrix44* m1, matrix44* outMatrices, SizeT num);
+    /// multiply num matrices by the same matrix (outMatrices[i] = m0[i] * m1)
+    static void MultiplyMatrices(const matrix44* m0, const matrix44& m1, matrix44* outMatrices, SizeT num);
+    /// transform num points or vectors by a matrix
+    static void TransformPoints(const matrix44& m, const float4* points, float4* outPoints, SizeT num);
+    /// transform num axis aligned bounding boxes by num affine matrices
+    static void TransformBoxes(const bbox* boxes, const matrix44* matrices, bbox* outBoxes, SizeT num);
+    /// check num bounding boxes against the view volume of a view-projection matrix
+    static void ClipBoxes(const matrix44& viewProjection, const bbox* boxes, ClipStatus::Type* outStatus, SizeT num);
+    /// spherical interpolation between num pairs of unit quaternions
+    static void SlerpQuaternions(const quaternion* q0, const quaternion* q1, scalar t, quaternion* outQuaternions, SizeT num);
+    /// normalize num quaternions
+    static void NormalizeQuaternions(const quaternion* quaternions, quaternion* outQuaternions, SizeT num);
+};
+
+} // namespace Math
+//------------------------------------------------------------------------------
+#endif
@@ -317,5 +317,6 @@ bbox::diagonal_size() const
 }
 
 } // namespace Math
+__DeclareRelocatableType(Math::bbox)
 //------------------------------------------------------------------------------
 #endif
@@ -386,5 +386,6 @@ float2::minimize(const float2& v0, const float2& v1)
 }
 
 } // namespace Math
+__DeclareTrivialType(Math::float2)
 //------------------------------------------------------------------------------
 #endif
@@ -12,6 +12,8 @@
 */
 #if __WIN32__ || __XBOX360__
 #include "math/xnamath/xna_float4.h"
+#elif (__LINUX__ || __OSX__)
+#include "math/sse/sse_float4.h"
 #elif __WII__
 #include "math/wii/wii_float4.h"
 #elif __PS3__
@@ -19,5 +21,6 @@
 #else
 #error "float4 class not implemented!"
 #endif
+__DeclareTrivialType(Math::float4)
 //------------------------------------------------------------------------------
 #endif
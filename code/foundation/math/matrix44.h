@@ -11,6 +11,8 @@
 */
 #if __WIN32__ || __XBOX360__
 #include "math/xnamath/xna_matrix44.h"
+#elif (__LINUX__ || __OSX__)
+#include "math/sse/sse_matrix44.h"
 #elif __WII__
 #include "math/wii/wii_matrix44.h"
 #elif __PS3__
@@ -18,5 +20,6 @@
 #else
 #error "matrix44 class not implemented!"
 #endif
+__DeclareRelocatableType(Math::matrix44)
 //-------------------------------------------------------------------
 #endif
@@ -11,6 +11,8 @@
 */
 #if __WIN32__ || __XBOX360__
 #include "math/xnamath/xna_plane.h"
+#elif (__LINUX__ || __OSX__)
+#include "math/sse/sse_plane.h"
 #elif __WII__
 #include "math/wii/wii_plane.h"
 #elif __PS3__
@@ -12,6 +12,8 @@
 */
 #if __WIN32__ || __XBOX360__
 #include "math/xnamath/xna_point.h"
+#elif (__LINUX__ || __OSX__)
+#include "math/sse/sse_point.h"
 #elif __WII__
 #include "math/wii/wii_point.h"
 #elif __PS3__
@@ -19,6 +21,7 @@
 #else
 #error "point class not implemented!"
 #endif
+__DeclareRelocatableType(Math::point)
 //------------------------------------------------------------------------------
 #endif
     
\ No newline at end of file
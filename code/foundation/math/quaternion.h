@@ -11,6 +11,8 @@
 */
 #if __WIN32__ || __XBOX360__
 #include "math/xnamath/xna_quaternion.h"
+#elif (__LINUX__ || __OSX__)
+#include "math/sse/sse_quaternion.h"
 #elif __WII__
 #include "math/wii/wii_quaternion.h"
 #elif __PS3__
@@ -18,5 +20,6 @@
 #else
 #error "quaternion class not implemented!"
 #endif
+__DeclareTrivialType(Math::quaternion)
 //-------------------------------------------------------------------
 #endif
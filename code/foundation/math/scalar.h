@@ -15,6 +15,8 @@
 
 #if __WIN32__ || __XBOX360__
 #include "math/xnamath/xna_scalar.h"
+#elif (__LINUX__ || __OSX__)
+#include "math/sse/sse_scalar.h"
 #elif __WII__
 #include "math/wii/wii_scalar.h"
 #elif __PS3__
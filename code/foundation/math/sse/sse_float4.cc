@@ -0,0 +1,95 @@
+//------------------------------------------------------------------------------
+//  sse_float4.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "math/float4.h"
+#include "math/matrix44.h"
+#include "system/byteorder.h"
+
+#if (__LINUX__ || __OSX__)
+namespace Math
+{
+
+//------------------------------------------------------------------------------
+/**
+*/
+float4
+float4::transform(__Float4Arg v, const matrix44 &m)
+{
+    return Ops::transform(v.vec, m.mx);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+float4
+float4::clamp(__Float4Arg vClamp, __Float4Arg vMin, __Float4Arg vMax)
+{
+    return Ops::min(Ops::max(vClamp.vec, vMin.vec), vMax.vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+scalar
+float4::angle(__Float4Arg v0, __Float4Arg v1)
+{
+    scalar cosAngle = float4::unpack_x(Ops::dot4(v0.vec, v1.vec)) / (v0.length() * v1.length());
+    return n_acos(cosAngle);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+float4::load_ubyte4n_signed(const void* ptr, float w)
+{
+    // need to endian-convert the source...
+    uint ub4nValue = System::ByteOrder::Convert<uint>(System::ByteOrder::Host, System::ByteOrder::LittleEndian, *(uint*)ptr);
+    Ops::vec4 v = Ops::set(scalar(ub4nValue & 0xff), scalar((ub4nValue >> 8) & 0xff), scalar((ub4nValue >> 16) & 0xff), 0.0f);
+    this->vec = Ops::sub(Ops::scale(v, 2.0f / 255.0f), Ops::splat(1.0f));
+    this->set_w(w);
+}
+
+//------------------------------------------------------------------------------
+/**
+    The indices are stored as integers in the components of the control
+    vector.
+*/
+float4
+float4::permute_control(unsigned int i0, unsigned int i1, unsigned int i2, unsigned int i3)
+{
+    n_assert((i0 < 8) && (i1 < 8) && (i2 < 8) && (i3 < 8));
+    NEBULA3_ALIGN16 uint control[4] = { i0, i1, i2, i3 };
+    float4 res;
+    res.load((const scalar*)control);
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/**
+    This is not a vector operation, it is only used in rare cases (e.g.
+    to rotate the up vector in matrix44::lookatlh()).
+*/
+float4
+float4::permute(const float4& v0, const float4& v1, const float4& control)
+{
+    NEBULA3_ALIGN16 scalar src[8];
+    NEBULA3_ALIGN16 uint indices[4];
+    NEBULA3_ALIGN16 scalar dst[4];
+    v0.store(src);
+    v1.store(src + 4);
+    control.store((scalar*)indices);
+    IndexT i;
+    for (i = 0; i < 4; i++)
+    {
+        dst[i] = src[indices[i] & 7];
+    }
+    float4 res;
+    res.load(dst);
+    return res;
+}
+
+} // namespace Math
+#endif // (__LINUX__ || __OSX__)
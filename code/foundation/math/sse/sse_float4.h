@@ -0,0 +1,982 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Math::float4
+
+    float4 class of the portable math backend, has the same interface
+    as the XNAMath float4. The components are kept in a vector register
+    of the primitives selected in math/sse/sse_ops.h.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+#include "math/scalar.h"
+#include "math/sse/sse_ops.h"
+
+//------------------------------------------------------------------------------
+namespace Math
+{
+class matrix44;
+class float4;
+
+typedef const float4& __Float4Arg;
+
+class NEBULA3_ALIGN16 float4
+{
+public:
+    /// default constructor, NOTE: does NOT setup components!
+    float4();
+    /// construct from values
+    float4(scalar x, scalar y, scalar z, scalar w);
+    /// construct from a vector register
+    float4(Ops::vec4 rhs);
+
+    /// assignment operator
+    void operator=(const float4 &rhs);
+    /// assign a vector register
+    void operator=(Ops::vec4 rhs);
+    /// flip sign
+    float4 operator-() const;
+    /// inplace add
+    void operator+=(const float4 &rhs);
+    /// inplace sub
+    void operator-=(const float4 &rhs);
+    /// inplace scalar multiply
+    void operator*=(scalar s);
+    /// muliply by a vector component-wise
+    void operator*=(const float4& rhs);
+    /// add 2 vectors
+    float4 operator+(const float4 &rhs) const;
+    /// subtract 2 vectors
+    float4 operator-(const float4 &rhs) const;
+    /// multiply with scalar
+    float4 operator*(scalar s) const;
+    /// equality operator
+    bool operator==(const float4 &rhs) const;
+    /// inequality operator
+    bool operator!=(const float4 &rhs) const;
+
+    /// load content from 16-byte-aligned memory
+    void load(const scalar* ptr);
+    /// load content from unaligned memory
+    void loadu(const scalar* ptr);
+    /// write content to 16-byte-aligned memory through the write cache
+    void store(scalar* ptr) const;
+    /// write content to unaligned memory through the write cache
+    void storeu(scalar* ptr) const;
+    /// stream content to 16-byte-aligned memory circumventing the write-cache
+    void stream(scalar* ptr) const;
+
+    /// load 3 floats into x,y,z from unaligned memory
+    void load_float3(const void* ptr, float w);
+    /// load from UByte4N packed vector, move range to -1..+1
+    void load_ubyte4n_signed(const void* ptr, float w);
+
+    /// set content
+    void set(scalar x, scalar y, scalar z, scalar w);
+    /// set the x component
+    void set_x(scalar x);
+    /// set the y component
+    void set_y(scalar y);
+    /// set the z component
+    void set_z(scalar z);
+    /// set the w component
+    void set_w(scalar w);
+
+    /// read/write access to x component
+    scalar& x();
+    /// read/write access to y component
+    scalar& y();
+    /// read/write access to z component
+    scalar& z();
+    /// read/write access to w component
+    scalar& w();
+    /// read-only access to x component
+    scalar x() const;
+    /// read-only access to y component
+    scalar y() const;
+    /// read-only access to z component
+    scalar z() const;
+    /// read-only access to w component
+    scalar w() const;
+
+    /// return length of vector
+    scalar length() const;
+    /// return squared length of vector
+    scalar lengthsq() const;
+    /// return compononent-wise absolute
+    float4 abs() const;
+
+    /// return 1.0 / vec
+    static float4 reciprocal(const float4 &v);
+    /// component-wise multiplication
+    static float4 multiply(const float4 &v0, const float4 &v1);
+    /// return 3-dimensional cross product
+    static float4 cross3(const float4 &v0, const float4 &v1);
+    /// return 3d dot product of vectors
+    static scalar dot3(const float4 &v0, const float4 &v1);
+    /// return point in barycentric coordinates
+    static float4 barycentric(const float4 &v0, const float4 &v1, const float4 &v2, scalar f, scalar g);
+    /// perform Catmull-Rom interpolation
+    static float4 catmullrom(const float4 &v0, const float4 &v1, const float4 &v2, const float4 &v3, scalar s);
+    /// perform Hermite spline interpolation
+    static float4 hermite(const float4 &v1, const float4 &t1, const float4 &v2, const float4 &t2, scalar s);
+    /// perform linear interpolation between 2 4d vectors
+    static float4 lerp(const float4 &v0, const float4 &v1, scalar s);
+    /// return 4d vector made up of largest components of 2 vectors
+    static float4 maximize(const float4 &v0, const float4 &v1);
+    /// return 4d vector made up of smallest components of 2 vectors
+    static float4 minimize(const float4 &v0, const float4 &v1);
+    /// return normalized version of 4d vector
+    static float4 normalize(const float4 &v);
+    /// transform 4d vector by matrix44 (deprecated, use matrix44::transform())
+    static float4 transform(__Float4Arg v, const matrix44 &m);
+    /// reflect a vector v
+    static float4 reflect(const float4 &normal, const float4 &incident);
+    /// clamp to min/max vector
+    static float4 clamp(__Float4Arg Clamp, __Float4Arg vMin, __Float4Arg vMax);
+    /// angle between two vectors
+    static scalar angle(__Float4Arg v0, __Float4Arg v1);
+
+    /// return true if any XYZ component is less-then
+    static bool less3_any(const float4 &v0, const float4 &v1);
+    /// return true if all XYZ components are less-then
+    static bool less3_all(const float4 &v0, const float4 &v1);
+    /// return true if any XYZ component is less-or-equal
+    static bool lessequal3_any(const float4 &v0, const float4 &v1);
+    /// return true if all XYZ components are less-or-equal
+    static bool lessequal3_all(const float4 &v0, const float4 &v1);
+    /// return true if any XYZ component is greater
+    static bool greater3_any(const float4 &v0, const float4 &v1);
+    /// return true if all XYZ components are greater
+    static bool greater3_all(const float4 &v0, const float4 &v1);
+    /// return true if any XYZ component is greater-or-equal
+    static bool greaterequal3_any(const float4 &v0, const float4 &v1);
+    /// return true if all XYZ components are greater-or-equal
+    static bool greaterequal3_all(const float4 &v0, const float4 &v1);
+    /// return true if any XYZ component is equal
+    static bool equal3_any(const float4 &v0, const float4 &v1);
+    /// return true if all XYZ components are equal
+    static bool equal3_all(const float4 &v0, const float4 &v1);
+    /// perform near equal comparison with given epsilon (3 components)
+    static bool nearequal3(const float4 &v0, const float4 &v1, const float4 &epsilon);
+
+    /// return true if any XYZW component is less-then
+    static bool less4_any(const float4 &v0, const float4 &v1);
+    /// return true if all XYZW components are less-then
+    static bool less4_all(const float4 &v0, const float4 &v1);
+    /// return true if any XYZW component is less-or-equal
+    static bool lessequal4_any(const float4 &v0, const float4 &v1);
+    /// return true if all XYZW components are less-or-equal
+    static bool lessequal4_all(const float4 &v0, const float4 &v1);
+    /// return true if any XYZW component is greater
+    static bool greater4_any(const float4 &v0, const float4 &v1);
+    /// return true if all XYZW components are greater
+    static bool greater4_all(const float4 &v0, const float4 &v1);
+    /// return true if any XYZW component is greater-or-equal
+    static bool greaterequal4_any(const float4 &v0, const float4 &v1);
+    /// return true if all XYZW components are greater-or-equal
+    static bool greaterequal4_all(const float4 &v0, const float4 &v1);
+    /// return true if any XYZW component is equal
+    static bool equal4_any(const float4 &v0, const float4 &v1);
+    /// return true if all XYZW components are equal
+    static bool equal4_all(const float4 &v0, const float4 &v1);
+    /// perform near equal comparison with given epsilon (4 components)
+    static bool nearequal4(const float4 &v0, const float4 &v1, const float4 &epsilon);
+    /// unpack the first element from a vector register
+    static float unpack_x(Ops::vec4 v);
+    /// unpack the second element from a vector register
+    static float unpack_y(Ops::vec4 v);
+    /// unpack the third element from a vector register
+    static float unpack_z(Ops::vec4 v);
+    /// unpack the fourth element from a vector register
+    static float unpack_w(Ops::vec4 v);
+    /// splat scalar into each component of a vector
+    static float4 splat(scalar s);
+    /// return a vector with all elements set to element n of v. 0 <= element <= 3
+    static float4 splat(const float4 &v, uint element);
+    /// return a vector with all elements set to v.x
+    static float4 splat_x(const float4 &v);
+    /// return a vector with all elements set to v.y
+    static float4 splat_y(const float4 &v);
+    /// return a vector with all elements set to v.z
+    static float4 splat_z(const float4 &v);
+    /// return a vector with all elements set to v.w
+    static float4 splat_w(const float4 &v);
+    /// return control vector for permute, indices 0..3 select from v0, 4..7 from v1
+    static float4 permute_control(unsigned int i0, unsigned int i1, unsigned int i2, unsigned int i3);
+    /// merge components of 2 vectors into 1
+    static float4 permute(const float4& v0, const float4& v1, const float4& control);
+
+    Ops::vec4 vec;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline
+float4::float4()
+{
+    //  empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline
+float4::float4(scalar x, scalar y, scalar z, scalar w)
+{
+    this->vec = Ops::set(x, y, z, w);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline
+float4::float4(Ops::vec4 rhs) :
+    vec(rhs)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+float4::operator=(const float4 &rhs)
+{
+    this->vec = rhs.vec;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+float4::operator=(Ops::vec4 rhs)
+{
+    this->vec = rhs;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+float4::operator==(const float4 &rhs) const
+{
+    return (0xf == Ops::cmpeq(this->vec, rhs.vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+float4::operator!=(const float4 &rhs) const
+{
+    return (0xf != Ops::cmpeq(this->vec, rhs.vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+    Load 4 floats from 16-byte-aligned memory.
+*/
+__forceinline void
+float4::load(const scalar* ptr)
+{
+    this->vec = Ops::load(ptr);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Load 4 floats from unaligned memory.
+*/
+__forceinline void
+float4::loadu(const scalar* ptr)
+{
+    this->vec = Ops::loadu(ptr);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Store to 16-byte-aligned float pointer.
+*/
+__forceinline void
+float4::store(scalar* ptr) const
+{
+    Ops::store(ptr, this->vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Store to non-aligned float pointer.
+*/
+__forceinline void
+float4::storeu(scalar* ptr) const
+{
+    Ops::storeu(ptr, this->vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+float4::stream(scalar* ptr) const
+{
+    Ops::stream(ptr, this->vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+float4::load_float3(const void* ptr, float w)
+{
+    const scalar* f = (const scalar*) ptr;
+    this->vec = Ops::set(f[0], f[1], f[2], w);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float4
+float4::operator-() const
+{
+    return Ops::negate(this->vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float4
+float4::operator*(scalar t) const
+{
+    return Ops::scale(this->vec, t);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+float4::operator*=(const float4& rhs)
+{
+    this->vec = Ops::mul(this->vec, rhs.vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+float4::operator+=(const float4 &rhs)
+{
+    this->vec = Ops::add(this->vec, rhs.vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+float4::operator-=(const float4 &rhs)
+{
+    this->vec = Ops::sub(this->vec, rhs.vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+float4::operator*=(scalar s)
+{
+    this->vec = Ops::scale(this->vec, s);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float4
+float4::operator+(const float4 &rhs) const
+{
+    return Ops::add(this->vec, rhs.vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float4
+float4::operator-(const float4 &rhs) const
+{
+    return Ops::sub(this->vec, rhs.vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+float4::set(scalar x, scalar y, scalar z, scalar w)
+{
+    this->vec = Ops::set(x, y, z, w);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline scalar&
+float4::x()
+{
+    return ((scalar*)&this->vec)[0];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline scalar
+float4::x() const
+{
+    return Ops::getx(this->vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline scalar&
+float4::y()
+{
+    return ((scalar*)&this->vec)[1];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline scalar
+float4::y() const
+{
+    return Ops::gety(this->vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline scalar&
+float4::z()
+{
+    return ((scalar*)&this->vec)[2];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline scalar
+float4::z() const
+{
+    return Ops::getz(this->vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline scalar&
+float4::w()
+{
+    return ((scalar*)&this->vec)[3];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline scalar
+float4::w() const
+{
+    return Ops::getw(this->vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+float4::set_x(scalar x)
+{
+    this->vec = Ops::setx(this->vec, x);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+float4::set_y(scalar y)
+{
+    this->vec = Ops::sety(this->vec, y);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+float4::set_z(scalar z)
+{
+    this->vec = Ops::setz(this->vec, z);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+float4::set_w(scalar w)
+{
+    this->vec = Ops::setw(this->vec, w);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline scalar
+float4::length() const
+{
+    return Ops::getx(Ops::sqrt(Ops::dot4(this->vec, this->vec)));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline scalar
+float4::lengthsq() const
+{
+    return Ops::getx(Ops::dot4(this->vec, this->vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float4
+float4::reciprocal(const float4 &v)
+{
+    return Ops::reciprocal(v.vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float4
+float4::multiply(const float4 &v0, const float4 &v1)
+{
+    return Ops::mul(v0.vec, v1.vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float4
+float4::abs() const
+{
+    return Ops::abs(this->vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float4
+float4::cross3(const float4 &v0, const float4 &v1)
+{
+    return Ops::cross3(v0.vec, v1.vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline scalar
+float4::dot3(const float4 &v0, const float4 &v1)
+{
+    return Ops::getx(Ops::dot3(v0.vec, v1.vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns v0 + f * (v1 - v0) + g * (v2 - v0).
+*/
+__forceinline float4
+float4::barycentric(const float4 &v0, const float4 &v1, const float4 &v2, scalar f, scalar g)
+{
+    Ops::vec4 res = Ops::madd(Ops::sub(v1.vec, v0.vec), Ops::splat(f), v0.vec);
+    return Ops::madd(Ops::sub(v2.vec, v0.vec), Ops::splat(g), res);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float4
+float4::catmullrom(const float4 &v0, const float4 &v1, const float4 &v2, const float4 &v3, scalar s)
+{
+    scalar s2 = s * s;
+    scalar s3 = s2 * s;
+    Ops::vec4 res = Ops::scale(v0.vec, (-s3 + 2.0f * s2 - s) * 0.5f);
+    res = Ops::madd(v1.vec, Ops::splat((3.0f * s3 - 5.0f * s2 + 2.0f) * 0.5f), res);
+    res = Ops::madd(v2.vec, Ops::splat((-3.0f * s3 + 4.0f * s2 + s) * 0.5f), res);
+    res = Ops::madd(v3.vec, Ops::splat((s3 - s2) * 0.5f), res);
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float4
+float4::hermite(const float4 &v1, const float4 &t1, const float4 &v2, const float4 &t2, scalar s)
+{
+    scalar s2 = s * s;
+    scalar s3 = s2 * s;
+    Ops::vec4 res = Ops::scale(v1.vec, 2.0f * s3 - 3.0f * s2 + 1.0f);
+    res = Ops::madd(t1.vec, Ops::splat(s3 - 2.0f * s2 + s), res);
+    res = Ops::madd(v2.vec, Ops::splat(-2.0f * s3 + 3.0f * s2), res);
+    res = Ops::madd(t2.vec, Ops::splat(s3 - s2), res);
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float4
+float4::lerp(const float4 &v0, const float4 &v1, scalar s)
+{
+    return Ops::madd(Ops::sub(v1.vec, v0.vec), Ops::splat(s), v0.vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float4
+float4::maximize(const float4 &v0, const float4 &v1)
+{
+    return Ops::max(v0.vec, v1.vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float4
+float4::minimize(const float4 &v0, const float4 &v1)
+{
+    return Ops::min(v0.vec, v1.vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float4
+float4::normalize(const float4 &v)
+{
+    if (float4::equal3_all(v, float4(0,0,0,0))) return v;
+    return Ops::div(v.vec, Ops::sqrt(Ops::dot4(v.vec, v.vec)));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float4
+float4::reflect(const float4 &normal, const float4 &incident)
+{
+    Ops::vec4 d = Ops::dot3(incident.vec, normal.vec);
+    return Ops::sub(incident.vec, Ops::mul(Ops::add(d, d), normal.vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+float4::less4_any(const float4 &v0, const float4 &v1)
+{
+    return (0 != Ops::cmplt(v0.vec, v1.vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+float4::less4_all(const float4 &v0, const float4 &v1)
+{
+    return (0xf == Ops::cmplt(v0.vec, v1.vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+float4::lessequal4_any(const float4 &v0, const float4 &v1)
+{
+    return (0 != Ops::cmple(v0.vec, v1.vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+float4::lessequal4_all(const float4 &v0, const float4 &v1)
+{
+    return (0xf == Ops::cmple(v0.vec, v1.vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+float4::greater4_any(const float4 &v0, const float4 &v1)
+{
+    return (0 != Ops::cmpgt(v0.vec, v1.vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+float4::greater4_all(const float4 &v0, const float4 &v1)
+{
+    return (0xf == Ops::cmpgt(v0.vec, v1.vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+float4::greaterequal4_any(const float4 &v0, const float4 &v1)
+{
+    return (0 != Ops::cmpge(v0.vec, v1.vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+float4::greaterequal4_all(const float4 &v0, const float4 &v1)
+{
+    return (0xf == Ops::cmpge(v0.vec, v1.vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+float4::equal4_any(const float4 &v0, const float4 &v1)
+{
+    return (0 != Ops::cmpeq(v0.vec, v1.vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+float4::equal4_all(const float4 &v0, const float4 &v1)
+{
+    return (0xf == Ops::cmpeq(v0.vec, v1.vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+float4::nearequal4(const float4 &v0, const float4 &v1, const float4 &epsilon)
+{
+    return (0xf == Ops::cmple(Ops::abs(Ops::sub(v0.vec, v1.vec)), epsilon.vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+float4::less3_any(const float4 &v0, const float4 &v1)
+{
+    return (0 != (Ops::cmplt(v0.vec, v1.vec) & 0x7));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+float4::less3_all(const float4 &v0, const float4 &v1)
+{
+    return (0x7 == (Ops::cmplt(v0.vec, v1.vec) & 0x7));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+float4::lessequal3_any(const float4 &v0, const float4 &v1)
+{
+    return (0 != (Ops::cmple(v0.vec, v1.vec) & 0x7));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+float4::lessequal3_all(const float4 &v0, const float4 &v1)
+{
+    return (0x7 == (Ops::cmple(v0.vec, v1.vec) & 0x7));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+float4::greater3_any(const float4 &v0, const float4 &v1)
+{
+    return (0 != (Ops::cmpgt(v0.vec, v1.vec) & 0x7));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+float4::greater3_all(const float4 &v0, const float4 &v1)
+{
+    return (0x7 == (Ops::cmpgt(v0.vec, v1.vec) & 0x7));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+float4::greaterequal3_any(const float4 &v0, const float4 &v1)
+{
+    return (0 != (Ops::cmpge(v0.vec, v1.vec) & 0x7));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+float4::greaterequal3_all(const float4 &v0, const float4 &v1)
+{
+    return (0x7 == (Ops::cmpge(v0.vec, v1.vec) & 0x7));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+float4::equal3_any(const float4 &v0, const float4 &v1)
+{
+    return (0 != (Ops::cmpeq(v0.vec, v1.vec) & 0x7));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+float4::equal3_all(const float4 &v0, const float4 &v1)
+{
+    return (0x7 == (Ops::cmpeq(v0.vec, v1.vec) & 0x7));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+float4::nearequal3(const float4 &v0, const float4 &v1, const float4 &epsilon)
+{
+    return (0x7 == (Ops::cmple(Ops::abs(Ops::sub(v0.vec, v1.vec)), epsilon.vec) & 0x7));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float
+float4::unpack_x(Ops::vec4 v)
+{
+    return Ops::getx(v);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float
+float4::unpack_y(Ops::vec4 v)
+{
+    return Ops::gety(v);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float
+float4::unpack_z(Ops::vec4 v)
+{
+    return Ops::getz(v);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float
+float4::unpack_w(Ops::vec4 v)
+{
+    return Ops::getw(v);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline
+float4
+float4::splat(scalar s)
+{
+    return float4(Ops::splat(s));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline
+float4
+float4::splat(const float4 &v, uint element)
+{
+    n_assert(element < 4);
+    switch(element)
+    {
+    case 0:
+        return float4(Ops::splatx(v.vec));
+    case 1:
+        return float4(Ops::splaty(v.vec));
+    case 2:
+        return float4(Ops::splatz(v.vec));
+    }
+    return float4(Ops::splatw(v.vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline
+float4
+float4::splat_x(const float4 &v)
+{
+    return float4(Ops::splatx(v.vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline
+float4
+float4::splat_y(const float4 &v)
+{
+    return float4(Ops::splaty(v.vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline
+float4
+float4::splat_z(const float4 &v)
+{
+    return float4(Ops::splatz(v.vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline
+float4
+float4::splat_w(const float4 &v)
+{
+    return float4(Ops::splatw(v.vec));
+}
+
+} // namespace Math
+//------------------------------------------------------------------------------
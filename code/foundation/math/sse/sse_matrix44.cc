@@ -0,0 +1,123 @@
+//------------------------------------------------------------------------------
+//  sse_matrix44.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "math/matrix44.h"
+#include "math/plane.h"
+#include "math/quaternion.h"
+
+#if (__LINUX__ || __OSX__)
+namespace Math
+{
+
+//------------------------------------------------------------------------------
+/**
+*/
+matrix44
+matrix44::reflect(const plane& p)
+{
+    Ops::vec4 normPlane = plane::normalize(p).vec;
+    Ops::vec4 s = Ops::mul(normPlane, Ops::set(-2.0f, -2.0f, -2.0f, 0.0f));
+    return matrix44(Ops::madd(Ops::splatx(normPlane), s, Ops::set(1.0f, 0.0f, 0.0f, 0.0f)),
+                    Ops::madd(Ops::splaty(normPlane), s, Ops::set(0.0f, 1.0f, 0.0f, 0.0f)),
+                    Ops::madd(Ops::splatz(normPlane), s, Ops::set(0.0f, 0.0f, 1.0f, 0.0f)),
+                    Ops::madd(Ops::splatw(normPlane), s, Ops::set(0.0f, 0.0f, 0.0f, 1.0f)));
+}
+
+//------------------------------------------------------------------------------
+/**
+    A negative determinant is handled by negating the x scale.
+*/
+void
+matrix44::decompose(float4& outScale, quaternion& outRotation, float4& outTranslation) const
+{
+    scalar sx = n_sqrt(float4::dot3(this->getrow0(), this->getrow0()));
+    scalar sy = n_sqrt(float4::dot3(this->getrow1(), this->getrow1()));
+    scalar sz = n_sqrt(float4::dot3(this->getrow2(), this->getrow2()));
+    n_assert((sx > N_TINY) && (sy > N_TINY) && (sz > N_TINY));
+    if (this->determinant() < 0.0f)
+    {
+        sx = -sx;
+    }
+    matrix44 rot(Ops::setw(Ops::scale(this->mx.r[0], 1.0f / sx), 0.0f),
+                 Ops::setw(Ops::scale(this->mx.r[1], 1.0f / sy), 0.0f),
+                 Ops::setw(Ops::scale(this->mx.r[2], 1.0f / sz), 0.0f),
+                 Ops::set(0.0f, 0.0f, 0.0f, 1.0f));
+    outScale.set(sx, sy, sz, 0.0f);
+    outRotation = quaternion::rotationmatrix(rot);
+    outTranslation = this->mx.r[3];
+    outTranslation.set_w(0.0f);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+matrix44
+matrix44::affinetransformation(scalar scaling, float4 const &rotationCenter, const quaternion& rotation, float4 const &translation)
+{
+    Ops::vec4 center = Ops::setw(rotationCenter.vec, 0.0f);
+    matrix44 m = matrix44::scaling(scaling, scaling, scaling);
+    m.mx.r[3] = Ops::sub(m.mx.r[3], center);
+    m = matrix44::multiply(m, matrix44::rotationquaternion(rotation));
+    m.mx.r[3] = Ops::add(m.mx.r[3], center);
+    m.mx.r[3] = Ops::add(m.mx.r[3], Ops::setw(translation.vec, 0.0f));
+    return m;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+matrix44
+matrix44::rotationquaternion(const quaternion& q)
+{
+    scalar x = q.x(), y = q.y(), z = q.z(), w = q.w();
+    scalar xx = x * x, yy = y * y, zz = z * z;
+    scalar xy = x * y, xz = x * z, yz = y * z;
+    scalar xw = x * w, yw = y * w, zw = z * w;
+    return matrix44(float4(1.0f - 2.0f * (yy + zz), 2.0f * (xy + zw), 2.0f * (xz - yw), 0.0f),
+                    float4(2.0f * (xy - zw), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + xw), 0.0f),
+                    float4(2.0f * (xz + yw), 2.0f * (yz - xw), 1.0f - 2.0f * (xx + yy), 0.0f),
+                    float4(0.0f, 0.0f, 0.0f, 1.0f));
+}
+
+//------------------------------------------------------------------------------
+/**
+    Same order of transformations as XMMatrixTransformation().
+*/
+matrix44
+matrix44::transformation(float4 const &scalingCenter, const quaternion& scalingRotation, float4 const &scaling, float4 const &rotationCenter, const quaternion& rotation, float4 const &translation)
+{
+    Ops::vec4 vScalingCenter = Ops::setw(scalingCenter.vec, 0.0f);
+    Ops::vec4 vRotationCenter = Ops::setw(rotationCenter.vec, 0.0f);
+    matrix44 scalingOrientation = matrix44::rotationquaternion(scalingRotation);
+
+    matrix44 m = matrix44::translation(Ops::negate(vScalingCenter));
+    m = matrix44::multiply(m, matrix44::transpose(scalingOrientation));
+    m = matrix44::multiply(m, matrix44::scaling(scaling));
+    m = matrix44::multiply(m, scalingOrientation);
+    m.mx.r[3] = Ops::add(m.mx.r[3], vScalingCenter);
+    m.mx.r[3] = Ops::sub(m.mx.r[3], vRotationCenter);
+    m = matrix44::multiply(m, matrix44::rotationquaternion(rotation));
+    m.mx.r[3] = Ops::add(m.mx.r[3], vRotationCenter);
+    m.mx.r[3] = Ops::add(m.mx.r[3], Ops::setw(translation.vec, 0.0f));
+    return m;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+matrix44::ispointinside(const float4& p, const matrix44& m)
+{
+    float4 p1 = matrix44::transform(p, m);
+    // vectorized compare operation
+    return !(float4::less4_any(float4(p1.x(), p1.w(), p1.y(), p1.w()),
+             float4(-p1.w(), p1.x(), -p1.w(), p1.y()))
+            ||
+            float4::less4_any(float4(p1.z(), p1.w(), 0, 0),
+            float4(-p1.w(), p1.z(), 0, 0)));
+}
+
+} // namespace Math
+#endif // (__LINUX__ || __OSX__)
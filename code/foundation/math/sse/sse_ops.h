@@ -0,0 +1,39 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @file math/sse/sse_ops.h
+
+    Selects the vector primitives of the portable math backend. The math
+    classes in math/sse are written against the Math::Ops namespace,
+    which is an alias for ScalarOps, SSE41Ops or AVX2Ops depending on
+    NEBULA3_MATH_BACKEND (see core/config.h).
+
+    All primitive sets which are enabled in the compiler settings are
+    available at the same time, so that tests and benchmarks can compare
+    them against each other.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+#include "math/sse/sse_ops_scalar.h"
+#include "math/sse/sse_ops_sse41.h"
+#include "math/sse/sse_ops_avx2.h"
+
+//------------------------------------------------------------------------------
+#if ((NEBULA3_MATH_BACKEND == NEBULA3_MATH_BACKEND_AVX2) && !NEBULA3_MATH_HAS_AVX2)
+#error "AVX2 math backend selected, but AVX2 and FMA are not enabled in the compiler settings!"
+#elif ((NEBULA3_MATH_BACKEND == NEBULA3_MATH_BACKEND_SSE41) && !NEBULA3_MATH_HAS_SSE41)
+#error "SSE4.1 math backend selected, but SSE4.1 is not enabled in the compiler settings!"
+#endif
+
+namespace Math
+{
+#if (NEBULA3_MATH_BACKEND == NEBULA3_MATH_BACKEND_AVX2)
+namespace Ops = AVX2Ops;
+#elif (NEBULA3_MATH_BACKEND == NEBULA3_MATH_BACKEND_SSE41)
+namespace Ops = SSE41Ops;
+#else
+namespace Ops = ScalarOps;
+#endif
+} // namespace Math
+//------------------------------------------------------------------------------
@@ -0,0 +1,203 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @file math/sse/sse_ops_avx2.h
+
+    AVX2/FMA implementation of the vector primitives of the portable math
+    backend. Most primitives are the same as the SSE4.1 primitives, only
+    the multiply-add chains use fused multiply-adds, and the matrix
+    multiply computes two rows at once in 256 bit registers. Only
+    compiled if AVX2 and FMA are enabled in the compiler settings
+    (NEBULA3_MATH_HAS_AVX2).
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "math/sse/sse_ops_sse41.h"
+
+#if NEBULA3_MATH_HAS_AVX2
+#include <immintrin.h>
+
+//------------------------------------------------------------------------------
+namespace Math
+{
+namespace AVX2Ops
+{
+using SSE41Ops::vec4;
+using SSE41Ops::mat44;
+using SSE41Ops::set;
+using SSE41Ops::splat;
+using SSE41Ops::load;
+using SSE41Ops::loadu;
+using SSE41Ops::store;
+using SSE41Ops::storeu;
+using SSE41Ops::stream;
+using SSE41Ops::getx;
+using SSE41Ops::gety;
+using SSE41Ops::getz;
+using SSE41Ops::getw;
+using SSE41Ops::setx;
+using SSE41Ops::sety;
+using SSE41Ops::setz;
+using SSE41Ops::setw;
+using SSE41Ops::add;
+using SSE41Ops::sub;
+using SSE41Ops::mul;
+using SSE41Ops::div;
+using SSE41Ops::scale;
+using SSE41Ops::negate;
+using SSE41Ops::abs;
+using SSE41Ops::min;
+using SSE41Ops::max;
+using SSE41Ops::reciprocal;
+using SSE41Ops::sqrt;
+using SSE41Ops::splatx;
+using SSE41Ops::splaty;
+using SSE41Ops::splatz;
+using SSE41Ops::splatw;
+using SSE41Ops::dot3;
+using SSE41Ops::dot4;
+using SSE41Ops::cross3;
+using SSE41Ops::cmpeq;
+using SSE41Ops::cmplt;
+using SSE41Ops::cmple;
+using SSE41Ops::cmpgt;
+using SSE41Ops::cmpge;
+using SSE41Ops::identity;
+using SSE41Ops::transpose;
+
+//------------------------------------------------------------------------------
+/**
+    Returns v0 * v1 + v2 (with a single rounding).
+*/
+__forceinline vec4
+madd(vec4 v0, vec4 v1, vec4 v2)
+{
+    return _mm_fmadd_ps(v0, v1, v2);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Transform a row vector by a matrix (v * m).
+*/
+__forceinline vec4
+transform(vec4 v, const mat44& m)
+{
+    vec4 res = _mm_mul_ps(N_SSE_SWIZZLE(v, 0, 0, 0, 0), m.r[0]);
+    res = _mm_fmadd_ps(N_SSE_SWIZZLE(v, 1, 1, 1, 1), m.r[1], res);
+    res = _mm_fmadd_ps(N_SSE_SWIZZLE(v, 2, 2, 2, 2), m.r[2], res);
+    res = _mm_fmadd_ps(N_SSE_SWIZZLE(v, 3, 3, 3, 3), m.r[3], res);
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns m0 * m1. Each 256 bit register holds two rows of m0, the
+    rows of m1 are broadcast into both halves.
+*/
+__forceinline mat44
+multiply(const mat44& m0, const mat44& m1)
+{
+    __m256 b0 = _mm256_broadcast_ps(&m1.r[0]);
+    __m256 b1 = _mm256_broadcast_ps(&m1.r[1]);
+    __m256 b2 = _mm256_broadcast_ps(&m1.r[2]);
+    __m256 b3 = _mm256_broadcast_ps(&m1.r[3]);
+    __m256 a01 = _mm256_loadu_ps((const float*)&m0.r[0]);
+    __m256 a23 = _mm256_loadu_ps((const float*)&m0.r[2]);
+
+    __m256 r01 = _mm256_mul_ps(_mm256_permute_ps(a01, 0x00), b0);
+    __m256 r23 = _mm256_mul_ps(_mm256_permute_ps(a23, 0x00), b0);
+    r01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, 0x55), b1, r01);
+    r23 = _mm256_fmadd_ps(_mm256_permute_ps(a23, 0x55), b1, r23);
+    r01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, 0xaa), b2, r01);
+    r23 = _mm256_fmadd_ps(_mm256_permute_ps(a23, 0xaa), b2, r23);
+    r01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, 0xff), b3, r01);
+    r23 = _mm256_fmadd_ps(_mm256_permute_ps(a23, 0xff), b3, r23);
+
+    mat44 res;
+    _mm256_storeu_ps((float*)&res.r[0], r01);
+    _mm256_storeu_ps((float*)&res.r[2], r23);
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Same as SSE41Ops::adjugate(), with fused multiply-adds.
+*/
+inline mat44
+adjugate(const mat44& m, float& outDet)
+{
+    vec4 r0 = m.r[0];
+    vec4 r1 = m.r[1];
+    vec4 r2 = m.r[2];
+    vec4 r3 = m.r[3];
+
+    // (s23, s23, s13, s12), (s13, s03, s03, s02), (s12, s02, s01, s01)
+    vec4 sA = _mm_fmsub_ps(N_SSE_SWIZZLE(r0, 2, 2, 1, 1), N_SSE_SWIZZLE(r1, 3, 3, 3, 2),
+                           _mm_mul_ps(N_SSE_SWIZZLE(r0, 3, 3, 3, 2), N_SSE_SWIZZLE(r1, 2, 2, 1, 1)));
+    vec4 sB = _mm_fmsub_ps(N_SSE_SWIZZLE(r0, 1, 0, 0, 0), N_SSE_SWIZZLE(r1, 3, 3, 3, 2),
+                           _mm_mul_ps(N_SSE_SWIZZLE(r0, 3, 3, 3, 2), N_SSE_SWIZZLE(r1, 1, 0, 0, 0)));
+    vec4 sC = _mm_fmsub_ps(N_SSE_SWIZZLE(r0, 1, 0, 0, 0), N_SSE_SWIZZLE(r1, 2, 2, 1, 1),
+                           _mm_mul_ps(N_SSE_SWIZZLE(r0, 2, 2, 1, 1), N_SSE_SWIZZLE(r1, 1, 0, 0, 0)));
+
+    // same for the lower two rows
+    vec4 cA = _mm_fmsub_ps(N_SSE_SWIZZLE(r2, 2, 2, 1, 1), N_SSE_SWIZZLE(r3, 3, 3, 3, 2),
+                           _mm_mul_ps(N_SSE_SWIZZLE(r2, 3, 3, 3, 2), N_SSE_SWIZZLE(r3, 2, 2, 1, 1)));
+    vec4 cB = _mm_fmsub_ps(N_SSE_SWIZZLE(r2, 1, 0, 0, 0), N_SSE_SWIZZLE(r3, 3, 3, 3, 2),
+                           _mm_mul_ps(N_SSE_SWIZZLE(r2, 3, 3, 3, 2), N_SSE_SWIZZLE(r3, 1, 0, 0, 0)));
+    vec4 cC = _mm_fmsub_ps(N_SSE_SWIZZLE(r2, 1, 0, 0, 0), N_SSE_SWIZZLE(r3, 2, 2, 1, 1),
+                           _mm_mul_ps(N_SSE_SWIZZLE(r2, 2, 2, 1, 1), N_SSE_SWIZZLE(r3, 1, 0, 0, 0)));
+
+    // columns of the adjugate matrix, with alternating signs
+    const vec4 signPNPN = _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f);
+    const vec4 signNPNP = _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+    vec4 col0 = _mm_fmadd_ps(N_SSE_SWIZZLE(r1, 3, 3, 3, 2), cC,
+                             _mm_fmsub_ps(N_SSE_SWIZZLE(r1, 1, 0, 0, 0), cA, _mm_mul_ps(N_SSE_SWIZZLE(r1, 2, 2, 1, 1), cB)));
+    vec4 col1 = _mm_fmadd_ps(N_SSE_SWIZZLE(r0, 3, 3, 3, 2), cC,
+                             _mm_fmsub_ps(N_SSE_SWIZZLE(r0, 1, 0, 0, 0), cA, _mm_mul_ps(N_SSE_SWIZZLE(r0, 2, 2, 1, 1), cB)));
+    vec4 col2 = _mm_fmadd_ps(N_SSE_SWIZZLE(r3, 3, 3, 3, 2), sC,
+                             _mm_fmsub_ps(N_SSE_SWIZZLE(r3, 1, 0, 0, 0), sA, _mm_mul_ps(N_SSE_SWIZZLE(r3, 2, 2, 1, 1), sB)));
+    vec4 col3 = _mm_fmadd_ps(N_SSE_SWIZZLE(r2, 3, 3, 3, 2), sC,
+                             _mm_fmsub_ps(N_SSE_SWIZZLE(r2, 1, 0, 0, 0), sA, _mm_mul_ps(N_SSE_SWIZZLE(r2, 2, 2, 1, 1), sB)));
+
+    mat44 res;
+    res.r[0] = _mm_xor_ps(col0, signPNPN);
+    res.r[1] = _mm_xor_ps(col1, signNPNP);
+    res.r[2] = _mm_xor_ps(col2, signPNPN);
+    res.r[3] = _mm_xor_ps(col3, signNPNP);
+    outDet = _mm_cvtss_f32(_mm_dp_ps(r0, res.r[0], 0xf1));
+    _MM_TRANSPOSE4_PS(res.r[0], res.r[1], res.r[2], res.r[3]);
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline mat44
+inverse(const mat44& m)
+{
+    float det;
+    mat44 res = AVX2Ops::adjugate(m, det);
+    vec4 invDet = _mm_div_ps(_mm_set1_ps(1.0f), _mm_set1_ps(det));
+    res.r[0] = _mm_mul_ps(res.r[0], invDet);
+    res.r[1] = _mm_mul_ps(res.r[1], invDet);
+    res.r[2] = _mm_mul_ps(res.r[2], invDet);
+    res.r[3] = _mm_mul_ps(res.r[3], invDet);
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline float
+determinant(const mat44& m)
+{
+    float det;
+    AVX2Ops::adjugate(m, det);
+    return det;
+}
+
+} // namespace AVX2Ops
+} // namespace Math
+
+#endif // NEBULA3_MATH_HAS_AVX2
+//------------------------------------------------------------------------------
@@ -0,0 +1,554 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @file math/sse/sse_ops_scalar.h
+
+    Scalar reference implementation of the vector primitives of the
+    portable math backend. This is used on CPUs without SSE4.1, and by
+    the math tests to check the SIMD implementations against.
+
+    All primitive namespaces (ScalarOps, SSE41Ops, AVX2Ops) implement
+    the same functions, only the vec4 type differs. The results are
+    exactly the same except for the summation order of dot products and
+    the fused multiply-adds of the AVX2 primitives.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+#include <math.h>
+
+//------------------------------------------------------------------------------
+namespace Math
+{
+namespace ScalarOps
+{
+/// a 4-component vector
+struct vec4
+{
+    float f[4];
+};
+
+/// a 4x4 matrix made of 4 row vectors
+struct mat44
+{
+    vec4 r[4];
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+set(float x, float y, float z, float w)
+{
+    vec4 res;
+    res.f[0] = x; res.f[1] = y; res.f[2] = z; res.f[3] = w;
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+splat(float s)
+{
+    return set(s, s, s, s);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+load(const float* ptr)
+{
+    return set(ptr[0], ptr[1], ptr[2], ptr[3]);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+loadu(const float* ptr)
+{
+    return set(ptr[0], ptr[1], ptr[2], ptr[3]);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+store(float* ptr, vec4 v)
+{
+    ptr[0] = v.f[0]; ptr[1] = v.f[1]; ptr[2] = v.f[2]; ptr[3] = v.f[3];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+storeu(float* ptr, vec4 v)
+{
+    store(ptr, v);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+stream(float* ptr, vec4 v)
+{
+    store(ptr, v);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float
+getx(vec4 v)
+{
+    return v.f[0];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float
+gety(vec4 v)
+{
+    return v.f[1];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float
+getz(vec4 v)
+{
+    return v.f[2];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float
+getw(vec4 v)
+{
+    return v.f[3];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+setx(vec4 v, float x)
+{
+    v.f[0] = x;
+    return v;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+sety(vec4 v, float y)
+{
+    v.f[1] = y;
+    return v;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+setz(vec4 v, float z)
+{
+    v.f[2] = z;
+    return v;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+setw(vec4 v, float w)
+{
+    v.f[3] = w;
+    return v;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+add(vec4 v0, vec4 v1)
+{
+    return set(v0.f[0] + v1.f[0], v0.f[1] + v1.f[1], v0.f[2] + v1.f[2], v0.f[3] + v1.f[3]);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+sub(vec4 v0, vec4 v1)
+{
+    return set(v0.f[0] - v1.f[0], v0.f[1] - v1.f[1], v0.f[2] - v1.f[2], v0.f[3] - v1.f[3]);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+mul(vec4 v0, vec4 v1)
+{
+    return set(v0.f[0] * v1.f[0], v0.f[1] * v1.f[1], v0.f[2] * v1.f[2], v0.f[3] * v1.f[3]);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+div(vec4 v0, vec4 v1)
+{
+    return set(v0.f[0] / v1.f[0], v0.f[1] / v1.f[1], v0.f[2] / v1.f[2], v0.f[3] / v1.f[3]);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+scale(vec4 v, float s)
+{
+    return set(v.f[0] * s, v.f[1] * s, v.f[2] * s, v.f[3] * s);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns v0 * v1 + v2.
+*/
+__forceinline vec4
+madd(vec4 v0, vec4 v1, vec4 v2)
+{
+    return add(mul(v0, v1), v2);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+negate(vec4 v)
+{
+    return set(-v.f[0], -v.f[1], -v.f[2], -v.f[3]);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+abs(vec4 v)
+{
+    return set(fabsf(v.f[0]), fabsf(v.f[1]), fabsf(v.f[2]), fabsf(v.f[3]));
+}
+
+//------------------------------------------------------------------------------
+/**
+    Same NaN behaviour as the minps instruction.
+*/
+__forceinline vec4
+min(vec4 v0, vec4 v1)
+{
+    return set((v0.f[0] < v1.f[0]) ? v0.f[0] : v1.f[0],
+               (v0.f[1] < v1.f[1]) ? v0.f[1] : v1.f[1],
+               (v0.f[2] < v1.f[2]) ? v0.f[2] : v1.f[2],
+               (v0.f[3] < v1.f[3]) ? v0.f[3] : v1.f[3]);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Same NaN behaviour as the maxps instruction.
+*/
+__forceinline vec4
+max(vec4 v0, vec4 v1)
+{
+    return set((v0.f[0] > v1.f[0]) ? v0.f[0] : v1.f[0],
+               (v0.f[1] > v1.f[1]) ? v0.f[1] : v1.f[1],
+               (v0.f[2] > v1.f[2]) ? v0.f[2] : v1.f[2],
+               (v0.f[3] > v1.f[3]) ? v0.f[3] : v1.f[3]);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+reciprocal(vec4 v)
+{
+    return div(splat(1.0f), v);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+sqrt(vec4 v)
+{
+    return set(sqrtf(v.f[0]), sqrtf(v.f[1]), sqrtf(v.f[2]), sqrtf(v.f[3]));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+splatx(vec4 v)
+{
+    return splat(v.f[0]);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+splaty(vec4 v)
+{
+    return splat(v.f[1]);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+splatz(vec4 v)
+{
+    return splat(v.f[2]);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+splatw(vec4 v)
+{
+    return splat(v.f[3]);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns the 3d dot product in all components.
+*/
+__forceinline vec4
+dot3(vec4 v0, vec4 v1)
+{
+    return splat(v0.f[0] * v1.f[0] + v0.f[1] * v1.f[1] + v0.f[2] * v1.f[2]);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns the 4d dot product in all components.
+*/
+__forceinline vec4
+dot4(vec4 v0, vec4 v1)
+{
+    return splat(v0.f[0] * v1.f[0] + v0.f[1] * v1.f[1] + v0.f[2] * v1.f[2] + v0.f[3] * v1.f[3]);
+}
+
+//------------------------------------------------------------------------------
+/**
+    The w component of the result is 0.
+*/
+__forceinline vec4
+cross3(vec4 v0, vec4 v1)
+{
+    return set(v0.f[1] * v1.f[2] - v0.f[2] * v1.f[1],
+               v0.f[2] * v1.f[0] - v0.f[0] * v1.f[2],
+               v0.f[0] * v1.f[1] - v0.f[1] * v1.f[0],
+               0.0f);
+}
+
+//------------------------------------------------------------------------------
+/**
+    The compare functions return a bit mask with bit n set if the
+    comparison is true for component n.
+*/
+__forceinline int
+cmpeq(vec4 v0, vec4 v1)
+{
+    return ((v0.f[0] == v1.f[0]) ? 1 : 0) | ((v0.f[1] == v1.f[1]) ? 2 : 0) |
+           ((v0.f[2] == v1.f[2]) ? 4 : 0) | ((v0.f[3] == v1.f[3]) ? 8 : 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline int
+cmplt(vec4 v0, vec4 v1)
+{
+    return ((v0.f[0] < v1.f[0]) ? 1 : 0) | ((v0.f[1] < v1.f[1]) ? 2 : 0) |
+           ((v0.f[2] < v1.f[2]) ? 4 : 0) | ((v0.f[3] < v1.f[3]) ? 8 : 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline int
+cmple(vec4 v0, vec4 v1)
+{
+    return ((v0.f[0] <= v1.f[0]) ? 1 : 0) | ((v0.f[1] <= v1.f[1]) ? 2 : 0) |
+           ((v0.f[2] <= v1.f[2]) ? 4 : 0) | ((v0.f[3] <= v1.f[3]) ? 8 : 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline int
+cmpgt(vec4 v0, vec4 v1)
+{
+    return cmplt(v1, v0);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline int
+cmpge(vec4 v0, vec4 v1)
+{
+    return cmple(v1, v0);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline mat44
+identity()
+{
+    mat44 res;
+    res.r[0] = set(1.0f, 0.0f, 0.0f, 0.0f);
+    res.r[1] = set(0.0f, 1.0f, 0.0f, 0.0f);
+    res.r[2] = set(0.0f, 0.0f, 1.0f, 0.0f);
+    res.r[3] = set(0.0f, 0.0f, 0.0f, 1.0f);
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Transform a row vector by a matrix (v * m).
+*/
+__forceinline vec4
+transform(vec4 v, const mat44& m)
+{
+    vec4 res;
+    IndexT i;
+    for (i = 0; i < 4; i++)
+    {
+        res.f[i] = v.f[0] * m.r[0].f[i] + v.f[1] * m.r[1].f[i] + v.f[2] * m.r[2].f[i] + v.f[3] * m.r[3].f[i];
+    }
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns m0 * m1.
+*/
+__forceinline mat44
+multiply(const mat44& m0, const mat44& m1)
+{
+    mat44 res;
+    res.r[0] = transform(m0.r[0], m1);
+    res.r[1] = transform(m0.r[1], m1);
+    res.r[2] = transform(m0.r[2], m1);
+    res.r[3] = transform(m0.r[3], m1);
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline mat44
+transpose(const mat44& m)
+{
+    mat44 res;
+    IndexT i;
+    for (i = 0; i < 4; i++)
+    {
+        res.r[i] = set(m.r[0].f[i], m.r[1].f[i], m.r[2].f[i], m.r[3].f[i]);
+    }
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns the adjugate matrix and the determinant. The cofactors are
+    computed from the 2x2 sub-determinants of the upper and lower
+    two rows (Laplace expansion).
+*/
+inline mat44
+adjugate(const mat44& m, float& outDet)
+{
+    const float* m0 = m.r[0].f;
+    const float* m1 = m.r[1].f;
+    const float* m2 = m.r[2].f;
+    const float* m3 = m.r[3].f;
+
+    // 2x2 sub-determinants of the upper rows
+    float s01 = m0[0] * m1[1] - m0[1] * m1[0];
+    float s02 = m0[0] * m1[2] - m0[2] * m1[0];
+    float s03 = m0[0] * m1[3] - m0[3] * m1[0];
+    float s12 = m0[1] * m1[2] - m0[2] * m1[1];
+    float s13 = m0[1] * m1[3] - m0[3] * m1[1];
+    float s23 = m0[2] * m1[3] - m0[3] * m1[2];
+
+    // 2x2 sub-determinants of the lower rows
+    float c01 = m2[0] * m3[1] - m2[1] * m3[0];
+    float c02 = m2[0] * m3[2] - m2[2] * m3[0];
+    float c03 = m2[0] * m3[3] - m2[3] * m3[0];
+    float c12 = m2[1] * m3[2] - m2[2] * m3[1];
+    float c13 = m2[1] * m3[3] - m2[3] * m3[1];
+    float c23 = m2[2] * m3[3] - m2[3] * m3[2];
+
+    mat44 res;
+    res.r[0] = set( m1[1] * c23 - m1[2] * c13 + m1[3] * c12,
+                   -m0[1] * c23 + m0[2] * c13 - m0[3] * c12,
+                    m3[1] * s23 - m3[2] * s13 + m3[3] * s12,
+                   -m2[1] * s23 + m2[2] * s13 - m2[3] * s12);
+    res.r[1] = set(-m1[0] * c23 + m1[2] * c03 - m1[3] * c02,
+                    m0[0] * c23 - m0[2] * c03 + m0[3] * c02,
+                   -m3[0] * s23 + m3[2] * s03 - m3[3] * s02,
+                    m2[0] * s23 - m2[2] * s03 + m2[3] * s02);
+    res.r[2] = set( m1[0] * c13 - m1[1] * c03 + m1[3] * c01,
+                   -m0[0] * c13 + m0[1] * c03 - m0[3] * c01,
+                    m3[0] * s13 - m3[1] * s03 + m3[3] * s01,
+                   -m2[0] * s13 + m2[1] * s03 - m2[3] * s01);
+    res.r[3] = set(-m1[0] * c12 + m1[1] * c02 - m1[2] * c01,
+                    m0[0] * c12 - m0[1] * c02 + m0[2] * c01,
+                   -m3[0] * s12 + m3[1] * s02 - m3[2] * s01,
+                    m2[0] * s12 - m2[1] * s02 + m2[2] * s01);
+    outDet = m0[0] * res.r[0].f[0] + m0[1] * res.r[1].f[0] + m0[2] * res.r[2].f[0] + m0[3] * res.r[3].f[0];
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline mat44
+inverse(const mat44& m)
+{
+    float det;
+    mat44 res = adjugate(m, det);
+    float invDet = 1.0f / det;
+    res.r[0] = scale(res.r[0], invDet);
+    res.r[1] = scale(res.r[1], invDet);
+    res.r[2] = scale(res.r[2], invDet);
+    res.r[3] = scale(res.r[3], invDet);
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline float
+determinant(const mat44& m)
+{
+    float det;
+    adjugate(m, det);
+    return det;
+}
+
+} // namespace ScalarOps
+} // namespace Math
+//------------------------------------------------------------------------------
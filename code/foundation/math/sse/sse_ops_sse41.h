@@ -0,0 +1,538 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @file math/sse/sse_ops_sse41.h
+
+    SSE4.1 implementation of the vector primitives of the portable math
+    backend, see math/sse/sse_ops_scalar.h for the reference
+    implementation. Only compiled if SSE4.1 is enabled in the compiler
+    settings (NEBULA3_MATH_HAS_SSE41).
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+
+#if NEBULA3_MATH_HAS_SSE41
+#include <smmintrin.h>
+
+// swizzle the components of a vector
+#define N_SSE_SWIZZLE(v, x, y, z, w) _mm_shuffle_ps((v), (v), _MM_SHUFFLE(w, z, y, x))
+
+//------------------------------------------------------------------------------
+namespace Math
+{
+namespace SSE41Ops
+{
+/// a 4-component vector
+typedef __m128 vec4;
+
+/// a 4x4 matrix made of 4 row vectors
+struct mat44
+{
+    vec4 r[4];
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+set(float x, float y, float z, float w)
+{
+    return _mm_setr_ps(x, y, z, w);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+splat(float s)
+{
+    return _mm_set1_ps(s);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+load(const float* ptr)
+{
+    return _mm_load_ps(ptr);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+loadu(const float* ptr)
+{
+    return _mm_loadu_ps(ptr);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+store(float* ptr, vec4 v)
+{
+    _mm_store_ps(ptr, v);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+storeu(float* ptr, vec4 v)
+{
+    _mm_storeu_ps(ptr, v);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+stream(float* ptr, vec4 v)
+{
+    _mm_stream_ps(ptr, v);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float
+getx(vec4 v)
+{
+    return _mm_cvtss_f32(v);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float
+gety(vec4 v)
+{
+    return _mm_cvtss_f32(N_SSE_SWIZZLE(v, 1, 1, 1, 1));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float
+getz(vec4 v)
+{
+    return _mm_cvtss_f32(_mm_movehl_ps(v, v));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline float
+getw(vec4 v)
+{
+    return _mm_cvtss_f32(N_SSE_SWIZZLE(v, 3, 3, 3, 3));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+setx(vec4 v, float x)
+{
+    return _mm_insert_ps(v, _mm_set_ss(x), 0x00);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+sety(vec4 v, float y)
+{
+    return _mm_insert_ps(v, _mm_set_ss(y), 0x10);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+setz(vec4 v, float z)
+{
+    return _mm_insert_ps(v, _mm_set_ss(z), 0x20);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+setw(vec4 v, float w)
+{
+    return _mm_insert_ps(v, _mm_set_ss(w), 0x30);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+add(vec4 v0, vec4 v1)
+{
+    return _mm_add_ps(v0, v1);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+sub(vec4 v0, vec4 v1)
+{
+    return _mm_sub_ps(v0, v1);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+mul(vec4 v0, vec4 v1)
+{
+    return _mm_mul_ps(v0, v1);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+div(vec4 v0, vec4 v1)
+{
+    return _mm_div_ps(v0, v1);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+scale(vec4 v, float s)
+{
+    return _mm_mul_ps(v, _mm_set1_ps(s));
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns v0 * v1 + v2.
+*/
+__forceinline vec4
+madd(vec4 v0, vec4 v1, vec4 v2)
+{
+    return _mm_add_ps(_mm_mul_ps(v0, v1), v2);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+negate(vec4 v)
+{
+    return _mm_xor_ps(v, _mm_set1_ps(-0.0f));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+abs(vec4 v)
+{
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+min(vec4 v0, vec4 v1)
+{
+    return _mm_min_ps(v0, v1);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+max(vec4 v0, vec4 v1)
+{
+    return _mm_max_ps(v0, v1);
+}
+
+//------------------------------------------------------------------------------
+/**
+    This is an exact division, rcpps is not precise enough for most
+    uses of reciprocal().
+*/
+__forceinline vec4
+reciprocal(vec4 v)
+{
+    return _mm_div_ps(_mm_set1_ps(1.0f), v);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+sqrt(vec4 v)
+{
+    return _mm_sqrt_ps(v);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+splatx(vec4 v)
+{
+    return N_SSE_SWIZZLE(v, 0, 0, 0, 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+splaty(vec4 v)
+{
+    return N_SSE_SWIZZLE(v, 1, 1, 1, 1);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+splatz(vec4 v)
+{
+    return N_SSE_SWIZZLE(v, 2, 2, 2, 2);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vec4
+splatw(vec4 v)
+{
+    return N_SSE_SWIZZLE(v, 3, 3, 3, 3);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns the 3d dot product in all components.
+*/
+__forceinline vec4
+dot3(vec4 v0, vec4 v1)
+{
+    return _mm_dp_ps(v0, v1, 0x7f);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns the 4d dot product in all components.
+*/
+__forceinline vec4
+dot4(vec4 v0, vec4 v1)
+{
+    return _mm_dp_ps(v0, v1, 0xff);
+}
+
+//------------------------------------------------------------------------------
+/**
+    The w component of the result is 0.
+*/
+__forceinline vec4
+cross3(vec4 v0, vec4 v1)
+{
+    vec4 res = _mm_sub_ps(_mm_mul_ps(N_SSE_SWIZZLE(v0, 1, 2, 0, 3), N_SSE_SWIZZLE(v1, 2, 0, 1, 3)),
+                          _mm_mul_ps(N_SSE_SWIZZLE(v0, 2, 0, 1, 3), N_SSE_SWIZZLE(v1, 1, 2, 0, 3)));
+    return _mm_blend_ps(res, _mm_setzero_ps(), 0x8);
+}
+
+//------------------------------------------------------------------------------
+/**
+    The compare functions return a bit mask with bit n set if the
+    comparison is true for component n.
+*/
+__forceinline int
+cmpeq(vec4 v0, vec4 v1)
+{
+    return _mm_movemask_ps(_mm_cmpeq_ps(v0, v1));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline int
+cmplt(vec4 v0, vec4 v1)
+{
+    return _mm_movemask_ps(_mm_cmplt_ps(v0, v1));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline int
+cmple(vec4 v0, vec4 v1)
+{
+    return _mm_movemask_ps(_mm_cmple_ps(v0, v1));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline int
+cmpgt(vec4 v0, vec4 v1)
+{
+    return _mm_movemask_ps(_mm_cmpgt_ps(v0, v1));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline int
+cmpge(vec4 v0, vec4 v1)
+{
+    return _mm_movemask_ps(_mm_cmpge_ps(v0, v1));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline mat44
+identity()
+{
+    mat44 res;
+    res.r[0] = _mm_setr_ps(1.0f, 0.0f, 0.0f, 0.0f);
+    res.r[1] = _mm_setr_ps(0.0f, 1.0f, 0.0f, 0.0f);
+    res.r[2] = _mm_setr_ps(0.0f, 0.0f, 1.0f, 0.0f);
+    res.r[3] = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Transform a row vector by a matrix (v * m).
+*/
+__forceinline vec4
+transform(vec4 v, const mat44& m)
+{
+    vec4 res = _mm_mul_ps(N_SSE_SWIZZLE(v, 0, 0, 0, 0), m.r[0]);
+    res = _mm_add_ps(res, _mm_mul_ps(N_SSE_SWIZZLE(v, 1, 1, 1, 1), m.r[1]));
+    res = _mm_add_ps(res, _mm_mul_ps(N_SSE_SWIZZLE(v, 2, 2, 2, 2), m.r[2]));
+    res = _mm_add_ps(res, _mm_mul_ps(N_SSE_SWIZZLE(v, 3, 3, 3, 3), m.r[3]));
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns m0 * m1.
+*/
+__forceinline mat44
+multiply(const mat44& m0, const mat44& m1)
+{
+    mat44 res;
+    res.r[0] = transform(m0.r[0], m1);
+    res.r[1] = transform(m0.r[1], m1);
+    res.r[2] = transform(m0.r[2], m1);
+    res.r[3] = transform(m0.r[3], m1);
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline mat44
+transpose(const mat44& m)
+{
+    mat44 res = m;
+    _MM_TRANSPOSE4_PS(res.r[0], res.r[1], res.r[2], res.r[3]);
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Same algorithm as ScalarOps::adjugate(), but computes the columns
+    of the adjugate matrix as vectors: each column is a cross-product-like
+    combination of one row of the matrix with three vectors of
+    2x2 sub-determinants. The result is transposed at the end.
+*/
+inline mat44
+adjugate(const mat44& m, float& outDet)
+{
+    vec4 r0 = m.r[0];
+    vec4 r1 = m.r[1];
+    vec4 r2 = m.r[2];
+    vec4 r3 = m.r[3];
+
+    // (s23, s23, s13, s12), (s13, s03, s03, s02), (s12, s02, s01, s01)
+    vec4 sA = _mm_sub_ps(_mm_mul_ps(N_SSE_SWIZZLE(r0, 2, 2, 1, 1), N_SSE_SWIZZLE(r1, 3, 3, 3, 2)),
+                         _mm_mul_ps(N_SSE_SWIZZLE(r0, 3, 3, 3, 2), N_SSE_SWIZZLE(r1, 2, 2, 1, 1)));
+    vec4 sB = _mm_sub_ps(_mm_mul_ps(N_SSE_SWIZZLE(r0, 1, 0, 0, 0), N_SSE_SWIZZLE(r1, 3, 3, 3, 2)),
+                         _mm_mul_ps(N_SSE_SWIZZLE(r0, 3, 3, 3, 2), N_SSE_SWIZZLE(r1, 1, 0, 0, 0)));
+    vec4 sC = _mm_sub_ps(_mm_mul_ps(N_SSE_SWIZZLE(r0, 1, 0, 0, 0), N_SSE_SWIZZLE(r1, 2, 2, 1, 1)),
+                         _mm_mul_ps(N_SSE_SWIZZLE(r0, 2, 2, 1, 1), N_SSE_SWIZZLE(r1, 1, 0, 0, 0)));
+
+    // same for the lower two rows
+    vec4 cA = _mm_sub_ps(_mm_mul_ps(N_SSE_SWIZZLE(r2, 2, 2, 1, 1), N_SSE_SWIZZLE(r3, 3, 3, 3, 2)),
+                         _mm_mul_ps(N_SSE_SWIZZLE(r2, 3, 3, 3, 2), N_SSE_SWIZZLE(r3, 2, 2, 1, 1)));
+    vec4 cB = _mm_sub_ps(_mm_mul_ps(N_SSE_SWIZZLE(r2, 1, 0, 0, 0), N_SSE_SWIZZLE(r3, 3, 3, 3, 2)),
+                         _mm_mul_ps(N_SSE_SWIZZLE(r2, 3, 3, 3, 2), N_SSE_SWIZZLE(r3, 1, 0, 0, 0)));
+    vec4 cC = _mm_sub_ps(_mm_mul_ps(N_SSE_SWIZZLE(r2, 1, 0, 0, 0), N_SSE_SWIZZLE(r3, 2, 2, 1, 1)),
+                         _mm_mul_ps(N_SSE_SWIZZLE(r2, 2, 2, 1, 1), N_SSE_SWIZZLE(r3, 1, 0, 0, 0)));
+
+    // columns of the adjugate matrix, with alternating signs
+    const vec4 signPNPN = _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f);
+    const vec4 signNPNP = _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+    vec4 col0 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(N_SSE_SWIZZLE(r1, 1, 0, 0, 0), cA),
+                                      _mm_mul_ps(N_SSE_SWIZZLE(r1, 2, 2, 1, 1), cB)),
+                           _mm_mul_ps(N_SSE_SWIZZLE(r1, 3, 3, 3, 2), cC));
+    vec4 col1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(N_SSE_SWIZZLE(r0, 1, 0, 0, 0), cA),
+                                      _mm_mul_ps(N_SSE_SWIZZLE(r0, 2, 2, 1, 1), cB)),
+                           _mm_mul_ps(N_SSE_SWIZZLE(r0, 3, 3, 3, 2), cC));
+    vec4 col2 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(N_SSE_SWIZZLE(r3, 1, 0, 0, 0), sA),
+                                      _mm_mul_ps(N_SSE_SWIZZLE(r3, 2, 2, 1, 1), sB)),
+                           _mm_mul_ps(N_SSE_SWIZZLE(r3, 3, 3, 3, 2), sC));
+    vec4 col3 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(N_SSE_SWIZZLE(r2, 1, 0, 0, 0), sA),
+                                      _mm_mul_ps(N_SSE_SWIZZLE(r2, 2, 2, 1, 1), sB)),
+                           _mm_mul_ps(N_SSE_SWIZZLE(r2, 3, 3, 3, 2), sC));
+
+    mat44 res;
+    res.r[0] = _mm_xor_ps(col0, signPNPN);
+    res.r[1] = _mm_xor_ps(col1, signNPNP);
+    res.r[2] = _mm_xor_ps(col2, signPNPN);
+    res.r[3] = _mm_xor_ps(col3, signNPNP);
+    outDet = _mm_cvtss_f32(_mm_dp_ps(r0, res.r[0], 0xf1));
+    _MM_TRANSPOSE4_PS(res.r[0], res.r[1], res.r[2], res.r[3]);
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline mat44
+inverse(const mat44& m)
+{
+    float det;
+    mat44 res = adjugate(m, det);
+    vec4 invDet = _mm_div_ps(_mm_set1_ps(1.0f), _mm_set1_ps(det));
+    res.r[0] = _mm_mul_ps(res.r[0], invDet);
+    res.r[1] = _mm_mul_ps(res.r[1], invDet);
+    res.r[2] = _mm_mul_ps(res.r[2], invDet);
+    res.r[3] = _mm_mul_ps(res.r[3], invDet);
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline float
+determinant(const mat44& m)
+{
+    float det;
+    adjugate(m, det);
+    return det;
+}
+
+} // namespace SSE41Ops
+} // namespace Math
+
+#endif // NEBULA3_MATH_HAS_SSE41
+//------------------------------------------------------------------------------
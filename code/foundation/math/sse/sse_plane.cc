@@ -0,0 +1,23 @@
+//------------------------------------------------------------------------------
+//  sse_plane.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "math/plane.h"
+#include "math/matrix44.h"
+
+#if (__LINUX__ || __OSX__)
+namespace Math
+{
+
+//------------------------------------------------------------------------------
+/**
+*/
+plane
+plane::transform(__PlaneArg p, const matrix44& m)
+{
+    return Ops::transform(p.vec, m.mx);
+}
+
+} // namespace Math
+#endif // (__LINUX__ || __OSX__)
@@ -0,0 +1,350 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Math::plane
+
+    A plane class of the portable math backend, has the same interface
+    as the XNAMath plane.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+#include "math/scalar.h"
+#include "math/float4.h"
+#include "math/line.h"
+#include "math/clipstatus.h"
+
+//------------------------------------------------------------------------------
+namespace Math
+{
+class matrix44;
+class plane;
+
+typedef const plane& __PlaneArg;
+
+class NEBULA3_ALIGN16 plane
+{
+public:
+    /// default constructor, NOTE: does NOT setup componenets!
+    plane();
+    /// construct from components
+    plane(scalar a, scalar b, scalar c, scalar d);
+    /// construct from points
+    plane(const float4& p0, const float4& p1, const float4& p2);
+    /// construct from point and normal
+    plane(const float4& p, const float4& n);
+    /// construct from a vector register
+    plane(Ops::vec4 rhs);
+
+    /// setup from points
+    void setup_from_points(const float4& p0, const float4& p1, const float4& p2);
+    /// setup from point and normal
+    void setup_from_point_and_normal(const float4& p, const float4& n);
+    /// set componenets
+    void set(scalar a, scalar b, scalar c, scalar d);
+    /// set the x component
+    void set_a(scalar a);
+    /// set the y component
+    void set_b(scalar b);
+    /// set the z component
+    void set_c(scalar c);
+    /// set the w component
+    void set_d(scalar d);
+
+    /// read/write access to A component
+    scalar& a();
+    /// read/write access to B component
+    scalar& b();
+    /// read/write access to C component
+    scalar& c();
+    /// read/write access to D component
+    scalar& d();
+    /// read-only access to A component
+    scalar a() const;
+    /// read-only access to B component
+    scalar b() const;
+    /// read-only access to C component
+    scalar c() const;
+    /// read-only access to D component
+    scalar d() const;
+
+    /// compute dot product of plane and vector
+    scalar dot(const float4& v) const;
+    /// find intersection with line
+    bool intersectline(const float4& startPoint, const float4& endPoint, float4& outIntersectPoint) const;
+    /// clip line against this plane
+    ClipStatus::Type clip(const line& l, line& outClippedLine) const;
+    /// normalize plane components a,b,c
+    static plane normalize(const plane& p);
+
+    /// transform plane by inverse transpose of transform (deprecated, use matrix44::transform())
+    static plane transform(__PlaneArg p, const matrix44& m);
+
+private:
+    friend class matrix44;
+
+    Ops::vec4 vec;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline
+plane::plane()
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline
+plane::plane(scalar a, scalar b, scalar c, scalar d)
+{
+    this->vec = Ops::set(a, b, c, d);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline
+plane::plane(const float4& p0, const float4& p1, const float4& p2)
+{
+    this->setup_from_points(p0, p1, p2);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline
+plane::plane(const float4& p0, const float4& n)
+{
+    this->setup_from_point_and_normal(p0, n);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline
+plane::plane(Ops::vec4 rhs) :
+    vec(rhs)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+plane::setup_from_points(const float4& p0, const float4& p1, const float4& p2)
+{
+    Ops::vec4 normal = Ops::cross3(Ops::sub(p1.vec, p0.vec), Ops::sub(p2.vec, p0.vec));
+    normal = Ops::div(normal, Ops::sqrt(Ops::dot3(normal, normal)));
+    this->vec = Ops::setw(normal, -Ops::getx(Ops::dot3(normal, p0.vec)));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+plane::setup_from_point_and_normal(const float4& p, const float4& n)
+{
+    this->vec = Ops::setw(n.vec, -Ops::getx(Ops::dot3(p.vec, n.vec)));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+plane::set(scalar a, scalar b, scalar c, scalar d)
+{
+    this->vec = Ops::set(a, b, c, d);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline scalar&
+plane::a()
+{
+    return ((scalar*)&this->vec)[0];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline scalar
+plane::a() const
+{
+    return Ops::getx(this->vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline scalar&
+plane::b()
+{
+    return ((scalar*)&this->vec)[1];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/ 
+inline scalar
+plane::b() const
+{
+    return Ops::gety(this->vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline scalar&
+plane::c()
+{
+    return ((scalar*)&this->vec)[2];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline scalar
+plane::c() const
+{
+    return Ops::getz(this->vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline scalar&
+plane::d()
+{
+    return ((scalar*)&this->vec)[3];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline scalar
+plane::d() const
+{
+    return Ops::getw(this->vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline scalar
+plane::dot(const float4& v) const
+{
+    return Ops::getx(Ops::dot4(this->vec, v.vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+plane::intersectline(const float4& startPoint, const float4& endPoint, float4& outIntersectPoint) const
+{
+    scalar denom = Ops::getx(Ops::dot3(this->vec, Ops::sub(startPoint.vec, endPoint.vec)));
+    if (n_abs(denom) <= N_TINY)
+    {
+        // line is parallel to the plane
+        return false;
+    }
+    scalar t = (Ops::getx(Ops::dot3(this->vec, startPoint.vec)) + this->d()) / denom;
+    outIntersectPoint = Ops::madd(Ops::sub(endPoint.vec, startPoint.vec), Ops::splat(t), startPoint.vec);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline plane
+plane::normalize(const plane& p)
+{
+    scalar len = n_sqrt(Ops::getx(Ops::dot3(p.vec, p.vec)));
+    if (len > 0.0f)
+    {
+        return Ops::scale(p.vec, 1.0f / len);
+    }
+    return p;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void 
+plane::set_a(scalar a)
+{
+    this->vec = Ops::setx(this->vec, a);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void 
+plane::set_b(scalar b)
+{
+    this->vec = Ops::sety(this->vec, b);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void 
+plane::set_c(scalar c)
+{
+    this->vec = Ops::setz(this->vec, c);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void 
+plane::set_d(scalar d)
+{
+    this->vec = Ops::setw(this->vec, d);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline ClipStatus::Type
+plane::clip(const line& l, line& clippedLine) const
+{
+    n_assert(&l != &clippedLine);
+    float d0 = this->dot(l.start());
+    float d1 = this->dot(l.end());
+    if ((d0 >= N_TINY) && (d1 >= N_TINY))
+    {
+        // start and end point above plane
+        clippedLine = l;
+        return ClipStatus::Inside;
+    }
+    else if ((d0 < N_TINY) && (d1 < N_TINY))
+    {
+        // start and end point below plane
+        return ClipStatus::Outside;
+    }
+    else
+    {
+        // line is clipped
+        point clipPoint;
+        this->intersectline(l.start(), l.end(), clipPoint);
+        if (d0 >= N_TINY)
+        {
+            clippedLine.set(l.start(), clipPoint);
+        }
+        else
+        {
+            clippedLine.set(clipPoint, l.end());
+        }
+        return ClipStatus::Clipped;
+    }
+}
+
+} // namespace Math
+//------------------------------------------------------------------------------
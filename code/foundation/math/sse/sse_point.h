@@ -0,0 +1,196 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Math::point
+    
+    A point in homogenous space. A point describes a position in space,
+    and has its W component set to 1.0.
+    
+    (C) 2010 Radon Labs GmbH
+*/
+#include "math/float4.h"
+#include "math/vector.h"
+
+//------------------------------------------------------------------------------
+namespace Math
+{
+class point;
+
+typedef const point& __PointArg;
+
+class NEBULA3_ALIGN16 point : public float4
+{
+public:
+    /// default constructor
+    point();
+    /// construct from components
+    point(scalar x, scalar y, scalar z);
+    /// construct from float4
+    point(const float4& rhs);
+    /// construct from a vector register
+    point(Ops::vec4 rhs);
+    /// return a point at the origin (0, 0, 0)
+    static point origin();
+    /// assignment operator
+    void operator=(const point& rhs);
+    /// assign a vector register
+    void operator=(Ops::vec4 rhs);
+    /// inplace add vector
+    void operator+=(const vector& rhs);
+    /// inplace subtract vector
+    void operator-=(const vector& rhs);
+    /// add point and vector
+    point operator+(const vector& rhs) const;
+    /// subtract vectors from point
+    point operator-(const vector& rhs) const;
+    /// subtract point from point into a vector
+    vector operator-(const point& rhs) const;
+    /// equality operator
+    bool operator==(const point& rhs) const;
+    /// inequality operator
+    bool operator!=(const point& rhs) const;
+    /// set components
+    void set(scalar x, scalar y, scalar z);
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline
+point::point() :
+    float4(0.0f, 0.0f, 0.0f, 1.0f)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline
+point::point(scalar x, scalar y, scalar z) :
+    float4(x, y, z, 1.0f)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline
+point::point(const float4& rhs) :
+    float4(rhs)
+{
+    this->set_w(1.0f);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline
+point::point(Ops::vec4 rhs) :
+    float4(rhs)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline point
+point::origin()
+{
+    return point(0.0f, 0.0f, 0.0f);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+point::operator=(const point& rhs)
+{
+    this->vec = rhs.vec;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+point::operator=(Ops::vec4 rhs)
+{
+    this->vec = rhs;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+point::operator+=(const vector& rhs)
+{
+    this->vec = Ops::add(this->vec, rhs.vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+point::operator-=(const vector& rhs)
+{
+    this->vec = Ops::sub(this->vec, rhs.vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline point
+point::operator+(const vector& rhs) const
+{
+    return Ops::add(this->vec, rhs.vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline point
+point::operator-(const vector& rhs) const
+{
+    return Ops::sub(this->vec, rhs.vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline vector
+point::operator-(const point& rhs) const
+{
+    return Ops::sub(this->vec, rhs.vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+point::operator==(const point& rhs) const
+{
+    return (0xf == Ops::cmpeq(this->vec, rhs.vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+point::operator!=(const point& rhs) const
+{
+    return (0xf != Ops::cmpeq(this->vec, rhs.vec));
+}    
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+point::set(scalar x, scalar y, scalar z)
+{
+    float4::set(x, y, z, 1.0f);
+}
+
+} // namespace Math
+//------------------------------------------------------------------------------
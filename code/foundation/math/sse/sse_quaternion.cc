@@ -0,0 +1,195 @@
+//------------------------------------------------------------------------------
+//  sse_quaternion.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "math/float4.h"
+#include "math/matrix44.h"
+#include "math/quaternion.h"
+
+#if (__LINUX__ || __OSX__)
+namespace Math
+{
+
+//------------------------------------------------------------------------------
+/**
+*/
+quaternion
+quaternion::barycentric(const quaternion& q0, const quaternion& q1, const quaternion& q2, scalar f, scalar g)
+{
+    scalar s = f + g;
+    if ((s < 0.00001f) && (s > -0.00001f))
+    {
+        return q0;
+    }
+    quaternion q01 = quaternion::slerp(q0, q1, s);
+    quaternion q02 = quaternion::slerp(q0, q2, s);
+    return quaternion::slerp(q01, q02, g / s);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+quaternion
+quaternion::exp(const quaternion& q)
+{
+    scalar theta = n_sqrt(Ops::getx(Ops::dot3(q.vec, q.vec)));
+    scalar s = 1.0f;
+    if (theta > N_TINY)
+    {
+        s = n_sin(theta) / theta;
+    }
+    return Ops::setw(Ops::scale(q.vec, s), n_cos(theta));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+quaternion
+quaternion::ln(const quaternion& q)
+{
+    scalar w = q.w();
+    Ops::vec4 res = q.vec;
+    if (n_abs(w) < (1.0f - 0.000001f))
+    {
+        scalar theta = n_acos(w);
+        res = Ops::scale(res, theta / n_sin(theta));
+    }
+    return Ops::setw(res, 0.0f);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Assumes that the upper 3x3 part of the matrix is a pure rotation.
+*/
+quaternion
+quaternion::rotationmatrix(const matrix44& m)
+{
+    const float4& r0 = m.getrow0();
+    const float4& r1 = m.getrow1();
+    const float4& r2 = m.getrow2();
+    scalar m00 = r0.x(), m01 = r0.y(), m02 = r0.z();
+    scalar m10 = r1.x(), m11 = r1.y(), m12 = r1.z();
+    scalar m20 = r2.x(), m21 = r2.y(), m22 = r2.z();
+    scalar trace = m00 + m11 + m22;
+    if (trace > 0.0f)
+    {
+        scalar s = 0.5f / n_sqrt(trace + 1.0f);
+        return quaternion((m12 - m21) * s, (m20 - m02) * s, (m01 - m10) * s, 0.25f / s);
+    }
+    else if ((m00 > m11) && (m00 > m22))
+    {
+        scalar s = 2.0f * n_sqrt(1.0f + m00 - m11 - m22);
+        return quaternion(0.25f * s, (m01 + m10) / s, (m02 + m20) / s, (m12 - m21) / s);
+    }
+    else if (m11 > m22)
+    {
+        scalar s = 2.0f * n_sqrt(1.0f + m11 - m00 - m22);
+        return quaternion((m01 + m10) / s, 0.25f * s, (m12 + m21) / s, (m20 - m02) / s);
+    }
+    else
+    {
+        scalar s = 2.0f * n_sqrt(1.0f + m22 - m00 - m11);
+        return quaternion((m02 + m20) / s, (m12 + m21) / s, 0.25f * s, (m01 - m10) / s);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Rotates around z first (roll), then around x (pitch) and then
+    around y (yaw), like XMQuaternionRotationRollPitchYaw().
+*/
+quaternion
+quaternion::rotationyawpitchroll(scalar yaw, scalar pitch, scalar roll)
+{
+    scalar sy = n_sin(0.5f * yaw),   cy = n_cos(0.5f * yaw);
+    scalar sp = n_sin(0.5f * pitch), cp = n_cos(0.5f * pitch);
+    scalar sr = n_sin(0.5f * roll),  cr = n_cos(0.5f * roll);
+    return quaternion(cy * sp * cr + sy * cp * sr,
+                      sy * cp * cr - cy * sp * sr,
+                      cy * cp * sr - sy * sp * cr,
+                      cy * cp * cr + sy * sp * sr);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Interpolates along the shorter arc, falls back to linear interpolation
+    if the quaternions are almost equal.
+*/
+quaternion
+quaternion::slerp(const quaternion& q1, const quaternion& q2, scalar t)
+{
+    scalar cosOmega = quaternion::dot(q1, q2);
+    scalar sign = 1.0f;
+    if (cosOmega < 0.0f)
+    {
+        cosOmega = -cosOmega;
+        sign = -1.0f;
+    }
+    scalar s0, s1;
+    if ((1.0f - cosOmega) > 0.00001f)
+    {
+        scalar sinOmega = n_sqrt(1.0f - cosOmega * cosOmega);
+        scalar omega = atan2f(sinOmega, cosOmega);
+        s0 = n_sin((1.0f - t) * omega) / sinOmega;
+        s1 = n_sin(t * omega) / sinOmega;
+    }
+    else
+    {
+        s0 = 1.0f - t;
+        s1 = t;
+    }
+    return Ops::madd(q2.vec, Ops::splat(s1 * sign), Ops::scale(q1.vec, s0));
+}
+
+//------------------------------------------------------------------------------
+/**
+    Same control points as XMQuaternionSquadSetup().
+*/
+void
+quaternion::squadsetup(const quaternion& q0, const quaternion& q1, const quaternion& q2, const quaternion& q3, quaternion& aOut, quaternion& bOut, quaternion& cOut)
+{
+    // choose the shortest arcs between the quaternions
+    quaternion sq2 = q2;
+    if (float4(Ops::add(q1.vec, q2.vec)).lengthsq() < float4(Ops::sub(q1.vec, q2.vec)).lengthsq())
+    {
+        sq2 = Ops::negate(q2.vec);
+    }
+    quaternion sq0 = q0;
+    if (float4(Ops::add(q0.vec, q1.vec)).lengthsq() < float4(Ops::sub(q0.vec, q1.vec)).lengthsq())
+    {
+        sq0 = Ops::negate(q0.vec);
+    }
+    quaternion sq3 = q3;
+    if (float4(Ops::add(sq2.vec, q3.vec)).lengthsq() < float4(Ops::sub(sq2.vec, q3.vec)).lengthsq())
+    {
+        sq3 = Ops::negate(q3.vec);
+    }
+
+    quaternion invQ1 = quaternion::inverse(q1);
+    quaternion invQ2 = quaternion::inverse(sq2);
+    quaternion lnQ0 = quaternion::ln(quaternion::multiply(invQ1, sq0));
+    quaternion lnQ2 = quaternion::ln(quaternion::multiply(invQ1, sq2));
+    quaternion lnQ1 = quaternion::ln(quaternion::multiply(invQ2, q1));
+    quaternion lnQ3 = quaternion::ln(quaternion::multiply(invQ2, sq3));
+    quaternion expQ02 = quaternion::exp(Ops::scale(Ops::add(lnQ0.vec, lnQ2.vec), -0.25f));
+    quaternion expQ13 = quaternion::exp(Ops::scale(Ops::add(lnQ1.vec, lnQ3.vec), -0.25f));
+
+    aOut = quaternion::multiply(q1, expQ02);
+    bOut = quaternion::multiply(sq2, expQ13);
+    cOut = sq2;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+quaternion
+quaternion::squad(const quaternion& q1, const quaternion& a, const quaternion& b, const quaternion& c, scalar t)
+{
+    quaternion q03 = quaternion::slerp(q1, c, t);
+    quaternion q12 = quaternion::slerp(a, b, t);
+    return quaternion::slerp(q03, q12, 2.0f * t * (1.0f - t));
+}
+
+} // namespace Math
+#endif // (__LINUX__ || __OSX__)
@@ -0,0 +1,506 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Math::quaternion
+
+    A quaternion class of the portable math backend, has the same
+    interface as the XNAMath quaternion.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+#include "math/scalar.h"
+#include "math/float4.h"
+
+//------------------------------------------------------------------------------
+namespace Math
+{
+class quaternion;
+
+typedef const quaternion& __QuaternionArg;
+
+class NEBULA3_ALIGN16 quaternion
+{
+public:
+    /// default constructor, NOTE: does NOT setup components!
+    quaternion();
+    /// construct from components
+    quaternion(scalar x, scalar y, scalar z, scalar w);
+    /// construct from float4
+    quaternion(float4 const &rhs);
+    /// construct from a vector register
+    quaternion(Ops::vec4 rhs);
+
+    /// assignment operator
+    void operator=(const quaternion& rhs);
+    /// assign a vector register
+    void operator=(Ops::vec4 rhs);
+    /// equality operator
+    bool operator==(const quaternion& rhs) const;
+    /// inequality operator
+    bool operator!=(const quaternion& rhs) const;
+
+    /// load content from 16-byte-aligned memory
+    void load(const scalar* ptr);
+    /// load content from unaligned memory
+    void loadu(const scalar* ptr);
+    /// write content to 16-byte-aligned memory through the write cache
+    void store(scalar* ptr) const;
+    /// write content to unaligned memory through the write cache
+    void storeu(scalar* ptr) const;
+    /// stream content to 16-byte-aligned memory circumventing the write-cache
+    void stream(scalar* ptr) const;
+
+    /// set content
+    void set(scalar x, scalar y, scalar z, scalar w);
+    /// set from float4
+    void set(float4 const &f4);
+    /// set the x component
+    void set_x(scalar x);
+    /// set the y component
+    void set_y(scalar y);
+    /// set the z component
+    void set_z(scalar z);
+    /// set the w component
+    void set_w(scalar w);
+
+    /// read/write access to x component
+    scalar& x();
+    /// read/write access to y component
+    scalar& y();
+    /// read/write access to z component
+    scalar& z();
+    /// read/write access to w component
+    scalar& w();
+    /// read-only access to x component
+    scalar x() const;
+    /// read-only access to y component
+    scalar y() const;
+    /// read-only access to z component
+    scalar z() const;
+    /// read-only access to w component
+    scalar w() const;
+    
+    /// return true if quaternion is identity
+    bool isidentity() const;
+    /// returns length
+    scalar length() const;
+    /// returns length squared
+    scalar lengthsq() const;
+    /// un-denormalize quaternion (this is sort of a hack since Maya likes to return denormal quaternions)
+    void undenormalize();
+
+    /// return quaternion in barycentric coordinates
+    static quaternion barycentric(const quaternion& q0, const quaternion& q1, const quaternion& q2, scalar f, scalar g);
+    /// return conjugate of a normalized quaternion
+    static quaternion conjugate(const quaternion& q);
+    /// return dot product of two normalized quaternions
+    static scalar dot(const quaternion& q0, const quaternion& q1);
+    /// calculate the exponential
+    static quaternion exp(const quaternion& q0);
+    /// returns an identity quaternion
+    static quaternion identity();
+    /// conjugates and renormalizes quaternion
+    static quaternion inverse(const quaternion& q);
+    /// calculate the natural logarithm
+    static quaternion ln(const quaternion& q);
+    /// multiply 2 quaternions
+    static quaternion multiply(const quaternion& q0, const quaternion& q1);
+    /// compute unit length quaternion
+    static quaternion normalize(const quaternion& q);
+    /// build quaternion from axis and clockwise rotation angle in radians
+    static quaternion rotationaxis(const float4& axis, scalar angle);
+    /// build quaternion from rotation matrix
+    static quaternion rotationmatrix(const matrix44& m);
+    /// build quaternion from yaw, pitch and roll
+    static quaternion rotationyawpitchroll(scalar yaw, scalar pitch, scalar roll);
+    /// interpolate between 2 quaternion using spherical interpolation
+    static quaternion slerp(const quaternion& q1, const quaternion& q2, scalar t);
+    /// setup control points for spherical quadrangle interpolation
+    static void squadsetup(const quaternion& q0, const quaternion& q1, const quaternion& q2, const quaternion& q3, quaternion& aOut, quaternion& bOut, quaternion& cOut);
+    /// interpolate between quaternions using spherical quadrangle interpolation
+    static quaternion squad(const quaternion& q1, const quaternion& a, const quaternion& b, const quaternion& c, scalar t);
+    /// convert quaternion to axis and angle
+    static void to_axisangle(const quaternion& q, float4& outAxis, scalar& outAngle);
+
+private:
+    friend class matrix44;
+
+    Ops::vec4 vec;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline
+quaternion::quaternion()
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline
+quaternion::quaternion(scalar x, scalar y, scalar z, scalar w)
+{
+    this->vec = Ops::set(x, y, z, w);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline
+quaternion::quaternion(float4 const &rhs) :
+    vec(rhs.vec)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline
+quaternion::quaternion(Ops::vec4 rhs) :
+    vec(rhs)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+quaternion::operator=(const quaternion& rhs)
+{
+    this->vec = rhs.vec;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+quaternion::operator=(Ops::vec4 rhs)
+{
+    this->vec = rhs;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+quaternion::operator==(const quaternion& rhs) const
+{
+    return (0xf == Ops::cmpeq(this->vec, rhs.vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+quaternion::operator!=(const quaternion& rhs) const
+{
+    return (0xf != Ops::cmpeq(this->vec, rhs.vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+quaternion::load(const scalar* ptr)
+{
+    this->vec = Ops::load(ptr);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+quaternion::loadu(const scalar* ptr)
+{
+    this->vec = Ops::loadu(ptr);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+quaternion::store(scalar* ptr) const
+{
+    Ops::store(ptr, this->vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+quaternion::storeu(scalar* ptr) const
+{
+    Ops::storeu(ptr, this->vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+quaternion::stream(scalar* ptr) const
+{
+    Ops::stream(ptr, this->vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+quaternion::set(scalar x, scalar y, scalar z, scalar w)
+{
+    this->vec = Ops::set(x, y, z, w);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+quaternion::set_x(scalar x)
+{
+    this->vec = Ops::setx(this->vec, x);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+quaternion::set_y(scalar y)
+{
+    this->vec = Ops::sety(this->vec, y);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+quaternion::set_z(scalar z)
+{
+    this->vec = Ops::setz(this->vec, z);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+quaternion::set_w(scalar w)
+{
+    this->vec = Ops::setw(this->vec, w);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+quaternion::set(float4 const &f4)
+{
+    this->vec = f4.vec;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline scalar&
+quaternion::x()
+{
+    return ((scalar*)&this->vec)[0];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline scalar
+quaternion::x() const
+{
+    return Ops::getx(this->vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline scalar&
+quaternion::y()
+{
+    return ((scalar*)&this->vec)[1];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline scalar
+quaternion::y() const
+{
+    return Ops::gety(this->vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline scalar&
+quaternion::z()
+{
+    return ((scalar*)&this->vec)[2];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline scalar
+quaternion::z() const
+{
+    return Ops::getz(this->vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline scalar&
+quaternion::w()
+{
+    return ((scalar*)&this->vec)[3];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline scalar
+quaternion::w() const
+{
+    return Ops::getw(this->vec);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline bool
+quaternion::isidentity() const
+{
+    return (0xf == Ops::cmpeq(this->vec, Ops::set(0.0f, 0.0f, 0.0f, 1.0f)));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline scalar
+quaternion::length() const
+{
+    return Ops::getx(Ops::sqrt(Ops::dot4(this->vec, this->vec)));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline scalar
+quaternion::lengthsq() const
+{
+    return Ops::getx(Ops::dot4(this->vec, this->vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+quaternion::undenormalize()
+{
+    this->set_x(n_undenormalize(this->x()));
+    this->set_y(n_undenormalize(this->y()));
+    this->set_z(n_undenormalize(this->z()));
+    this->set_w(n_undenormalize(this->w()));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline quaternion
+quaternion::conjugate(const quaternion& q)
+{
+    return Ops::mul(q.vec, Ops::set(-1.0f, -1.0f, -1.0f, 1.0f));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline scalar
+quaternion::dot(const quaternion& q0, const quaternion& q1)
+{
+    return Ops::getx(Ops::dot4(q0.vec, q1.vec));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline quaternion
+quaternion::identity()
+{
+    return Ops::set(0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns a zero quaternion if the length of q is (almost) zero, like
+    the XNAMath version.
+*/
+__forceinline quaternion
+quaternion::inverse(const quaternion& q)
+{
+    Ops::vec4 lengthSq = Ops::dot4(q.vec, q.vec);
+    if (Ops::getx(lengthSq) <= N_TINY)
+    {
+        return Ops::splat(0.0f);
+    }
+    return Ops::div(quaternion::conjugate(q).vec, lengthSq);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns the rotation q0 followed by the rotation q1 (which is the
+    quaternion product q1 * q0, the same as in XNAMath).
+*/
+__forceinline quaternion
+quaternion::multiply(const quaternion& q0, const quaternion& q1)
+{
+    Ops::vec4 res = Ops::mul(Ops::splatw(q1.vec), q0.vec);
+    res = Ops::madd(Ops::splatx(q1.vec), Ops::set(q0.w(), -q0.z(), q0.y(), -q0.x()), res);
+    res = Ops::madd(Ops::splaty(q1.vec), Ops::set(q0.z(), q0.w(), -q0.x(), -q0.y()), res);
+    res = Ops::madd(Ops::splatz(q1.vec), Ops::set(-q0.y(), q0.x(), q0.w(), -q0.z()), res);
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline quaternion
+quaternion::normalize(const quaternion& q)
+{
+    return Ops::div(q.vec, Ops::sqrt(Ops::dot4(q.vec, q.vec)));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline quaternion
+quaternion::rotationaxis(const float4& axis, scalar angle)
+{
+    Ops::vec4 normAxis = Ops::div(axis.vec, Ops::sqrt(Ops::dot3(axis.vec, axis.vec)));
+    scalar halfAngle = 0.5f * angle;
+    return Ops::setw(Ops::scale(normAxis, n_sin(halfAngle)), n_cos(halfAngle));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+quaternion::to_axisangle(const quaternion& q, float4& outAxis, scalar& outAngle)
+{
+    outAxis = q.vec;
+    outAxis.set_w(0.0f);
+    outAngle = 2.0f * n_acos(q.w());
+}
+
+} // namespace Math
+//------------------------------------------------------------------------------
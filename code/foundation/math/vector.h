@@ -12,6 +12,8 @@
 */
 #if __WIN32__ || __XBOX360__
 #include "math/xnamath/xna_vector.h"
+#elif (__LINUX__ || __OSX__)
+#include "math/sse/sse_vector.h"
 #elif __WII__
 #include "math/wii/wii_vector.h"
 #elif __PS3__
@@ -19,5 +21,6 @@
 #else
 #error "vector class not implemented!"
 #endif
+__DeclareRelocatableType(Math::vector)
 //------------------------------------------------------------------------------
 #endif
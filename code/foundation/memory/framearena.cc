@@ -0,0 +1,118 @@
+//------------------------------------------------------------------------------
+//  framearena.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "memory/framearena.h"
+
+namespace Memory
+{
+Threading::ThreadLocalSlot FrameArena::ThreadArena;
+
+//------------------------------------------------------------------------------
+/**
+*/
+FrameArena::FrameArena() :
+    heapType(InvalidHeapType),
+    memory(0),
+    bufferSize(0),
+    numBuffers(0),
+    frameId(InvalidIndex),
+    bufferStart(0),
+    usedSize(0),
+    maxUsedSize(0),
+    numFailedAllocs(0)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+FrameArena::~FrameArena()
+{
+    if (this->IsValid())
+    {
+        this->Discard();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Allocates all buffers at once from the heap. The buffer size is
+    rounded up to the alignment.
+*/
+void
+FrameArena::Setup(HeapType heap, SizeT size, SizeT num)
+{
+    n_assert(!this->IsValid());
+    n_assert(size > 0);
+    n_assert((num > 0) && (num <= MaxNumBuffers));
+    this->heapType = heap;
+    this->bufferSize = (size + (Alignment - 1)) & ~(Alignment - 1);
+    this->numBuffers = num;
+    this->memory = (unsigned char*) Memory::Alloc(this->heapType, this->bufferSize * this->numBuffers);
+    this->frameId = InvalidIndex;
+    this->bufferStart = this->memory;
+    this->usedSize = 0;
+    this->maxUsedSize = 0;
+    this->numFailedAllocs = 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+FrameArena::Discard()
+{
+    n_assert(this->IsValid());
+    if (ThreadArena.Get() == this)
+    {
+        ThreadArena.Set(0);
+    }
+    Memory::Free(this->heapType, this->memory);
+    this->memory = 0;
+    this->bufferStart = 0;
+    this->bufferSize = 0;
+    this->numBuffers = 0;
+    this->usedSize = 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Switch to the buffer of the new frame, everything which has been
+    allocated numBuffers frames ago becomes invalid. Nothing happens if
+    the frame id didn't change, so this may be called several times
+    per frame.
+*/
+void
+FrameArena::BeginFrame(IndexT id)
+{
+    n_assert(this->IsValid());
+    if (id != this->frameId)
+    {
+        if (this->usedSize > this->maxUsedSize)
+        {
+            this->maxUsedSize = this->usedSize;
+        }
+        this->frameId = id;
+        IndexT bufferIndex = IndexT(uint(id) % uint(this->numBuffers));
+        this->bufferStart = this->memory + bufferIndex * this->bufferSize;
+        this->usedSize = 0;
+        #if NEBULA3_DEBUG
+        // make use of stale frame data obvious
+        Memory::Fill(this->bufferStart, this->bufferSize, 0xCD);
+        #endif
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+FrameArena::SetThreadArena(FrameArena* arena)
+{
+    ThreadArena.Set(arena);
+}
+
+} // namespace Memory
@@ -0,0 +1,195 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Memory::FrameArena
+
+    A linear allocator for data which only lives for a few frames, like
+    temporary arrays which are rebuilt every frame. Allocating is just
+    an increment of the current buffer offset, there is no Free(), all
+    allocations of a frame are released at once when the frame's buffer
+    is reused.
+
+    The arena is divided into 2 or 3 buffers. BeginFrame() is called
+    once per frame with the frame id from the FrameSyncTimer and switches
+    to the next buffer, so data allocated in one frame stays valid for
+    numBuffers - 1 following frames (e.g. for results of asynchronous
+    jobs which are applied in the next frame).
+
+    A FrameArena is not thread-safe, it should only be used by the
+    thread which owns it. A thread makes its arena available to the
+    Util::ArrayFrameAllocator with SetThreadArena(), the arena is kept
+    in a thread local slot, so each thread sees only its own arena.
+
+    If the current buffer is exhausted, Alloc() returns 0 and the caller
+    should fall back to the heap. GetNumFailedAllocs() tells whether
+    the buffer size should be increased.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+#include "threading/threadlocalslot.h"
+
+//------------------------------------------------------------------------------
+namespace Memory
+{
+class FrameArena
+{
+public:
+    /// constructor
+    FrameArena();
+    /// destructor
+    ~FrameArena();
+
+    /// setup the arena
+    void Setup(HeapType heapType, SizeT bufferSize, SizeT numBuffers = 2);
+    /// discard the arena
+    void Discard();
+    /// return true if the arena has been setup
+    bool IsValid() const;
+
+    /// switch to the next buffer if the frame id has changed
+    void BeginFrame(IndexT frameId);
+    /// allocate 16-byte aligned memory from the current buffer, returns 0 if exhausted
+    void* Alloc(size_t size);
+    /// return true if a pointer has been allocated from this arena
+    bool Owns(const void* ptr) const;
+
+    /// get the current frame id
+    IndexT GetFrameId() const;
+    /// get size of one buffer
+    SizeT GetBufferSize() const;
+    /// get number of buffers
+    SizeT GetNumBuffers() const;
+    /// get number of bytes allocated from the current buffer
+    SizeT GetUsedSize() const;
+    /// get max number of bytes which have been allocated in one frame
+    SizeT GetMaxUsedSize() const;
+    /// get number of allocations which didn't fit into a buffer
+    SizeT GetNumFailedAllocs() const;
+
+    /// make an arena available to the calling thread (may be 0)
+    static void SetThreadArena(FrameArena* arena);
+    /// get the arena of the calling thread, may return 0
+    static FrameArena* GetThreadArena();
+
+    static const SizeT MaxNumBuffers = 3;
+
+private:
+    static const SizeT Alignment = 16;
+
+    HeapType heapType;
+    unsigned char* memory;
+    SizeT bufferSize;
+    SizeT numBuffers;
+    IndexT frameId;
+    unsigned char* bufferStart;
+    SizeT usedSize;
+    SizeT maxUsedSize;
+    SizeT numFailedAllocs;
+
+    static Threading::ThreadLocalSlot ThreadArena;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+FrameArena::IsValid() const
+{
+    return (0 != this->memory);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void*
+FrameArena::Alloc(size_t size)
+{
+    #if NEBULA3_BOUNDSCHECKS
+    n_assert(this->IsValid());
+    #endif
+    size_t alignedSize = (size + (Alignment - 1)) & ~size_t(Alignment - 1);
+    if (alignedSize > size_t(this->bufferSize - this->usedSize))
+    {
+        this->numFailedAllocs++;
+        return 0;
+    }
+    void* ptr = this->bufferStart + this->usedSize;
+    this->usedSize += SizeT(alignedSize);
+    return ptr;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+FrameArena::Owns(const void* ptr) const
+{
+    return ((size_t)ptr - (size_t)this->memory) < size_t(this->bufferSize * this->numBuffers);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline IndexT
+FrameArena::GetFrameId() const
+{
+    return this->frameId;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+FrameArena::GetBufferSize() const
+{
+    return this->bufferSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+FrameArena::GetNumBuffers() const
+{
+    return this->numBuffers;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+FrameArena::GetUsedSize() const
+{
+    return this->usedSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+FrameArena::GetMaxUsedSize() const
+{
+    return this->maxUsedSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+FrameArena::GetNumFailedAllocs() const
+{
+    return this->numFailedAllocs;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline FrameArena*
+FrameArena::GetThreadArena()
+{
+    return (FrameArena*) ThreadArena.Get();
+}
+
+} // namespace Memory
+//------------------------------------------------------------------------------
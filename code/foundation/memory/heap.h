@@ -32,6 +32,12 @@ namespace Memory
 {
 typedef OSX::OSXHeap Heap;
 }
+#elif __LINUX__
+#include "memory/posix/posixheap.h"
+namespace Memory
+{
+typedef Posix::PosixHeap Heap;
+}
 #else
 #error "IMPLEMENT ME!"
 #endif
@@ -17,6 +17,8 @@
 #include "memory/ps3/ps3memory.h"
 #elif __OSX__
 #include "memory/osx/osxmemory.h"
+#elif __LINUX__
+#include "memory/posix/posixmemory.h"
 #else
 #error "UNKNOWN PLATFORM"
 #endif
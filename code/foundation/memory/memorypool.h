@@ -32,6 +32,12 @@ namespace Memory
 {
 typedef OSX::OSXMemoryPool MemoryPool;
 }
+#elif __LINUX__
+#include "memory/posix/posixmemorypool.h"
+namespace Memory
+{
+typedef Posix::PosixMemoryPool MemoryPool;
+}
 #else
 #error "IMPLEMENT ME!"
 #endif
@@ -219,6 +219,22 @@ Copy(const void* from, void* to, size_t numBytes)
         memcpy(to, from, numBytes);
     }
 }
+
+//------------------------------------------------------------------------------
+/**
+    Copy a chunk of memory, the source and destination may overlap
+    (note the argument order is different from memmove()!!!)
+*/
+void
+Move(const void* from, void* to, size_t numBytes)
+{
+    if (numBytes > 0)
+    {
+        n_assert(0 != from);
+        n_assert(0 != to);
+        memmove(to, from, numBytes);
+    }
+}
     
 //------------------------------------------------------------------------------
 /**
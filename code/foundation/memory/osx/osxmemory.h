@@ -37,6 +37,8 @@ extern char* DuplicateCString(const char* from);
 extern bool IsOverlapping(const unsigned char* srcPtr, size_t srcSize, const unsigned char* dstPtr, size_t dstSize);
 /// copy a chunk of memory
 extern void Copy(const void* from, void* to, size_t numBytes);
+/// copy a chunk of memory, source and destination may overlap
+extern void Move(const void* from, void* to, size_t numBytes);
 /// overwrite a chunk of memory with zero
 extern void Clear(void* ptr, size_t numBytes);
 /// fill memory with a specific byte
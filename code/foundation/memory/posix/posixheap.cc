@@ -0,0 +1,201 @@
+//------------------------------------------------------------------------------
+//  posixheap.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "memory/posix/posixheap.h"
+#include "core/sysfunc.h"
+
+namespace Posix
+{
+using namespace Threading;
+using namespace Util;
+
+#if NEBULA3_MEMORY_STATS
+List<PosixHeap*>* PosixHeap::list = 0;
+CriticalSection* PosixHeap::criticalSection = 0;
+#endif
+
+//------------------------------------------------------------------------------
+/**
+    This method must be called at the beginning of the application before
+    any threads are spawned.
+*/
+void
+PosixHeap::Setup()
+{
+    #if NEBULA3_MEMORY_STATS
+    n_assert(0 == list);
+    n_assert(0 == criticalSection);
+    list = n_new(List<PosixHeap*>);
+    criticalSection = n_new(CriticalSection);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+/**
+    The initial and maximum size are ignored, heap arenas always grow
+    on demand.
+*/
+PosixHeap::PosixHeap(const char* heapName, size_t initialSize, size_t maxSize)
+{
+    n_assert(0 != heapName);
+    this->name = heapName;
+    this->arena = PosixHeapArena::Create(heapName);
+    n_assert(0 != this->arena);
+
+    // link into Heap list
+    #if NEBULA3_MEMORY_STATS
+    n_assert(0 != criticalSection);
+    this->allocCount = 0;
+    this->allocSize  = 0;
+    criticalSection->Enter();
+    this->listIterator = list->AddBack(this);
+    criticalSection->Leave();
+    #endif
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+PosixHeap::~PosixHeap()
+{
+    #if NEBULA3_MEMORY_STATS
+    this->DumpLeaks();
+    #endif
+
+    PosixHeapArena::Destroy(this->arena);
+    this->arena = 0;
+
+    // dump memory leaks and unlink from Heap list
+    #if NEBULA3_MEMORY_STATS
+    n_assert(0 == this->allocCount);
+    n_assert(0 != criticalSection);
+    n_assert(0 != this->listIterator);
+    criticalSection->Enter();
+    list->Remove(this->listIterator);
+    criticalSection->Leave();
+    this->listIterator = 0;
+    #endif   
+}
+
+#if NEBULA3_MEMORY_STATS
+//------------------------------------------------------------------------------
+/**
+    Validate the heap. This walks over the heap arena's segments and free 
+    lists and checks the control structures.
+*/
+bool
+PosixHeap::ValidateHeap() const
+{
+    return this->arena->Validate();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+int
+PosixHeap::GetAllocCount() const
+{
+    return this->allocCount;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+int
+PosixHeap::GetAllocSize() const
+{
+    return this->allocSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Array<PosixHeap::Stats>
+PosixHeap::GetAllHeapStats()
+{
+    n_assert(0 != criticalSection);
+    Array<Stats> result;
+    criticalSection->Enter();
+    List<PosixHeap*>::Iterator iter;
+    for (iter = list->Begin(); iter != list->End(); iter++)
+    {
+        Stats stats;
+        stats.name       = (*iter)->GetName();
+        stats.allocCount = (*iter)->GetAllocCount();
+        stats.allocSize  = (*iter)->GetAllocSize();        
+        result.Append(stats);
+    }
+    criticalSection->Leave();
+    return result;
+}
+
+//------------------------------------------------------------------------------
+/**
+    This static method calls the ValidateHeap() method on all heaps.
+*/
+bool
+PosixHeap::ValidateAllHeaps()
+{
+    n_assert(0 != criticalSection);
+    criticalSection->Enter();
+    bool result = true;
+    List<PosixHeap*>::Iterator iter;
+    for (iter = list->Begin(); iter != list->End(); iter++)
+    {
+        result &= (*iter)->ValidateHeap();
+    }
+    criticalSection->Leave();
+    return result;
+}
+
+//------------------------------------------------------------------------------
+/**
+    This is a helper method which writes a leak summary for a heap arena
+    to DebugOut. The arena doesn't track individual blocks, so only
+    the number of leaked blocks is reported.
+*/
+void
+PosixHeap::DumpHeapMemoryLeaks(const char* heapName, PosixHeapArena* arena)
+{
+    int allocCount = arena->GetAllocCount();
+    if (allocCount > 0)
+    {
+        char strBuf[256];
+        snprintf(strBuf, sizeof(strBuf), "!!! HEAP MEMORY LEAKS !!! (Heap: %s): %d blocks\n", heapName, allocCount);
+        Core::SysFunc::DebugOut(strBuf);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Generates a memory leak report for this heap.
+*/
+void
+PosixHeap::DumpLeaks()
+{
+    n_assert(0 != this->name);
+    n_assert(0 != this->arena);
+    PosixHeap::DumpHeapMemoryLeaks(this->name, this->arena);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Generates memory leaks for every heap object.
+*/
+void
+PosixHeap::DumpLeaksAllHeaps()
+{
+    n_assert(0 != criticalSection);
+    criticalSection->Enter();
+    List<PosixHeap*>::Iterator iter;
+    for (iter = list->Begin(); iter != list->End(); iter++)
+    {
+        (*iter)->DumpLeaks();
+    }
+    criticalSection->Leave();
+}
+#endif // NEBULA3_MEMORY_STATS
+
+} // namespace Posix
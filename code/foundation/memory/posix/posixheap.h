@@ -0,0 +1,144 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Posix::PosixHeap
+  
+    POSIX implementation of the class Memory::Heap. Each heap object
+    owns a private mmap-backed Posix::PosixHeapArena.
+    
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+#include "threading/interlocked.h"
+#include "threading/criticalsection.h"
+#include "util/array.h"
+#include "util/list.h"
+
+//------------------------------------------------------------------------------
+namespace Posix
+{
+class PosixHeap
+{
+public:
+    /// static setup method (called by Core::SysFunc::Setup)
+    static void Setup();
+    /// constructor (name must be static string!)
+    PosixHeap(const char* name, size_t initialSize=0, size_t maxSize=0);
+    /// destructor
+    ~PosixHeap();
+    /// get heap name
+    const char* GetName() const;
+    /// allocate a block of memory from the heap
+    void* Alloc(size_t size);
+    /// re-allocate a block of memory
+    void* Realloc(void* ptr, size_t newSize);
+    /// free a block of memory which has been allocated from this heap
+    void Free(void* ptr);
+
+    #if NEBULA3_MEMORY_STATS
+    /// heap stats structure
+    struct Stats
+    {
+        const char* name;
+        int allocCount;
+        int allocSize;
+    };
+    /// gather stats from all existing heaps
+    static Util::Array<Stats> GetAllHeapStats();
+    /// validate all heaps
+    static bool ValidateAllHeaps();
+    /// validate the heap (only useful in Debug builds)
+    bool ValidateHeap() const;
+    /// dump memory leaks from this heap
+    void DumpLeaks();
+    /// dump memory leaks from all heaps
+    static void DumpLeaksAllHeaps();
+    /// get the current alloc count
+    int GetAllocCount() const;
+    /// get the current alloc size
+    int GetAllocSize() const;
+    /// helper method: generate a mem leak report for provided heap arena
+    static void DumpHeapMemoryLeaks(const char* heapName, PosixHeapArena* arena);
+    #endif
+
+private:
+    /// default constructor not allowed
+    PosixHeap();
+
+    PosixHeapArena* arena;
+    const char* name;
+
+    #if NEBULA3_MEMORY_STATS
+    int volatile allocCount;
+    int volatile allocSize;
+    static Threading::CriticalSection*  criticalSection;
+    static Util::List<PosixHeap*>* list;
+    Util::List<PosixHeap*>::Iterator listIterator;
+    #endif
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const char*
+PosixHeap::GetName() const
+{
+    n_assert(0 != this->name);
+    return this->name;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void*
+PosixHeap::Alloc(size_t size)
+{
+    void* ptr = this->arena->Alloc(size);
+    if (0 == ptr)
+    {
+        n_error("PosixHeap::Alloc(): Out of memory in heap '%s' trying to allocate '%lu' bytes\n", this->name, (long unsigned int) size);
+    }
+    #if NEBULA3_MEMORY_STATS
+    Threading::Interlocked::Increment(this->allocCount);
+    Threading::Interlocked::Add(this->allocSize, int(PosixHeapArena::Size(ptr)));
+    #endif
+    return ptr;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void*
+PosixHeap::Realloc(void* ptr, size_t size)
+{
+    #if NEBULA3_MEMORY_STATS
+    size_t curSize = PosixHeapArena::Size(ptr);
+    #endif
+    void* newPtr = this->arena->Realloc(ptr, size);
+    if (0 == newPtr)
+    {
+        n_error("PosixHeap::Realloc(): Out of memory in heap '%s' trying to allocate '%lu' bytes\n", this->name, (long unsigned int) size);
+    }
+    #if NEBULA3_MEMORY_STATS
+    Threading::Interlocked::Add(this->allocSize, int(PosixHeapArena::Size(newPtr) - curSize));
+    #endif
+    return newPtr;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+PosixHeap::Free(void* ptr)
+{
+    n_assert(0 != ptr);
+    #if NEBULA3_MEMORY_STATS
+    size_t size = PosixHeapArena::Size(ptr);
+    Threading::Interlocked::Add(this->allocSize, -int(size));
+    Threading::Interlocked::Decrement(this->allocCount);
+    #endif
+    this->arena->Free(ptr);
+}
+
+} // namespace Posix
+//------------------------------------------------------------------------------
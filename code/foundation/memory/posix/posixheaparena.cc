@@ -0,0 +1,384 @@
+//------------------------------------------------------------------------------
+//  posixheaparena.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "memory/posix/posixheaparena.h"
+#include "core/types.h"
+#include <new>
+
+namespace Posix
+{
+
+//------------------------------------------------------------------------------
+/**
+    Creates a new arena object in its own mmap'ed memory block.
+*/
+PosixHeapArena*
+PosixHeapArena::Create(const char* name)
+{
+    void* mem = mmap(0, sizeof(PosixHeapArena), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == mem)
+    {
+        return 0;
+    }
+    return ::new(mem) PosixHeapArena(name);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PosixHeapArena::Destroy(PosixHeapArena* arena)
+{
+    n_assert(0 != arena);
+    arena->~PosixHeapArena();
+    munmap(arena, sizeof(PosixHeapArena));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+PosixHeapArena::PosixHeapArena(const char* n) :
+    name(n),
+    largeSegments(0),
+    allocCount(0),
+    mappedSize(0)
+{
+    IndexT i;
+    for (i = 0; i < NumSizeClasses; i++)
+    {
+        SizeClass& sc = this->sizeClasses[i];
+        pthread_mutex_init(&sc.lock, 0);
+        if (i < 16)
+        {
+            sc.blockSize = (i + 1) * 16;
+        }
+        else
+        {
+            int b = 8 + ((i - 16) / 4);
+            int k = (i - 16) % 4;
+            sc.blockSize = (size_t(1) << b) + ((k + 1) * (size_t(1) << (b - 2)));
+        }
+        n_assert(SizeToClass(sc.blockSize) == i);
+        sc.freeList = 0;
+        sc.bumpPtr = 0;
+        sc.bumpEnd = 0;
+        sc.segments = 0;
+    }
+    pthread_mutex_init(&this->largeLock, 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Releases all segments back to the OS, blocks which haven't been
+    freed yet become invalid!
+*/
+PosixHeapArena::~PosixHeapArena()
+{
+    IndexT i;
+    for (i = 0; i < NumSizeClasses; i++)
+    {
+        SizeClass& sc = this->sizeClasses[i];
+        while (0 != sc.segments)
+        {
+            Segment* next = sc.segments->next;
+            this->UnmapSegment(sc.segments);
+            sc.segments = next;
+        }
+        pthread_mutex_destroy(&sc.lock);
+    }
+    while (0 != this->largeSegments)
+    {
+        Segment* next = this->largeSegments->next;
+        this->UnmapSegment(this->largeSegments);
+        this->largeSegments = next;
+    }
+    pthread_mutex_destroy(&this->largeLock);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Map a new segment from the OS. Since mmap() only guarantees page
+    alignment, SegmentSize additional bytes are mapped and the unaligned
+    head and tail are unmapped again.
+*/
+PosixHeapArena::Segment*
+PosixHeapArena::MapSegment(size_t size)
+{
+    size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+    size = (size + pageSize - 1) & ~(pageSize - 1);
+    size_t mapSize = size + SegmentSize;
+    unsigned char* mem = (unsigned char*) mmap(0, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == (void*)mem)
+    {
+        return 0;
+    }
+    unsigned char* aligned = (unsigned char*) ((((size_t)mem) + SegmentSize - 1) & ~(SegmentSize - 1));
+    size_t headSize = aligned - mem;
+    size_t tailSize = mapSize - headSize - size;
+    if (headSize > 0)
+    {
+        munmap(mem, headSize);
+    }
+    if (tailSize > 0)
+    {
+        munmap(aligned + size, tailSize);
+    }
+
+    Segment* seg = (Segment*) aligned;
+    seg->magic = SegmentMagic;
+    seg->sizeClass = LargeSizeClass;
+    seg->size = 0;
+    seg->mappedSize = size;
+    seg->arena = this;
+    seg->next = 0;
+    seg->prev = 0;
+    __atomic_add_fetch(&this->mappedSize, size, __ATOMIC_RELAXED);
+    return seg;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PosixHeapArena::UnmapSegment(Segment* seg)
+{
+    n_assert(SegmentMagic == seg->magic);
+    size_t size = seg->mappedSize;
+    seg->magic = 0;
+    __atomic_sub_fetch(&this->mappedSize, size, __ATOMIC_RELAXED);
+    munmap(seg, size);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Take a block from the free list of the size class, if the free list
+    is empty carve a new block from the current segment of the size class
+    and map a new segment if the current segment is exhausted. Segment
+    memory is only touched when it is handed out, so that the OS only 
+    needs to commit pages which are actually used.
+*/
+void*
+PosixHeapArena::AllocSmall(int sizeClass)
+{
+    SizeClass& sc = this->sizeClasses[sizeClass];
+    void* ptr = 0;
+    pthread_mutex_lock(&sc.lock);
+    if (0 != sc.freeList)
+    {
+        ptr = sc.freeList;
+        sc.freeList = sc.freeList->next;
+    }
+    else
+    {
+        if ((sc.bumpPtr + sc.blockSize) > sc.bumpEnd)
+        {
+            Segment* seg = this->MapSegment(SegmentSize);
+            if (0 != seg)
+            {
+                seg->sizeClass = sizeClass;
+                seg->next = sc.segments;
+                if (0 != sc.segments)
+                {
+                    sc.segments->prev = seg;
+                }
+                sc.segments = seg;
+                sc.bumpPtr = ((unsigned char*)seg) + SegmentHeaderSize;
+                sc.bumpEnd = ((unsigned char*)seg) + SegmentSize;
+            }
+        }
+        if ((sc.bumpPtr + sc.blockSize) <= sc.bumpEnd)
+        {
+            ptr = sc.bumpPtr;
+            sc.bumpPtr += sc.blockSize;
+        }
+    }
+    pthread_mutex_unlock(&sc.lock);
+    return ptr;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void*
+PosixHeapArena::AllocLarge(size_t size)
+{
+    Segment* seg = this->MapSegment(size + SegmentHeaderSize);
+    if (0 == seg)
+    {
+        return 0;
+    }
+    seg->size = size;
+    pthread_mutex_lock(&this->largeLock);
+    seg->next = this->largeSegments;
+    if (0 != this->largeSegments)
+    {
+        this->largeSegments->prev = seg;
+    }
+    this->largeSegments = seg;
+    pthread_mutex_unlock(&this->largeLock);
+    return ((unsigned char*)seg) + SegmentHeaderSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void*
+PosixHeapArena::Alloc(size_t size)
+{
+    void* ptr;
+    if (size <= MaxSmallSize)
+    {
+        ptr = this->AllocSmall(SizeToClass(size));
+    }
+    else
+    {
+        ptr = this->AllocLarge(size);
+    }
+    if (0 != ptr)
+    {
+        __atomic_add_fetch(&this->allocCount, 1, __ATOMIC_RELAXED);
+    }
+    return ptr;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Small blocks are re-used if the new size still falls into the
+    same size class, large blocks are re-used as long as the new size 
+    fits into the mapped segment.
+*/
+void*
+PosixHeapArena::Realloc(void* ptr, size_t size)
+{
+    if (0 == ptr)
+    {
+        return this->Alloc(size);
+    }
+    Segment* seg = BlockToSegment(ptr);
+    n_assert((SegmentMagic == seg->magic) && (this == seg->arena));
+    size_t oldSize;
+    if (LargeSizeClass == seg->sizeClass)
+    {
+        if ((size > MaxSmallSize) && ((size + SegmentHeaderSize) <= seg->mappedSize))
+        {
+            seg->size = size;
+            return ptr;
+        }
+        oldSize = seg->size;
+    }
+    else
+    {
+        if ((size <= MaxSmallSize) && (SizeToClass(size) == seg->sizeClass))
+        {
+            return ptr;
+        }
+        oldSize = this->sizeClasses[seg->sizeClass].blockSize;
+    }
+    void* newPtr = this->Alloc(size);
+    if (0 != newPtr)
+    {
+        memcpy(newPtr, ptr, (oldSize < size) ? oldSize : size);
+        this->Free(ptr);
+    }
+    return newPtr;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PosixHeapArena::Free(void* ptr)
+{
+    n_assert(0 != ptr);
+    Segment* seg = BlockToSegment(ptr);
+    n_assert((SegmentMagic == seg->magic) && (this == seg->arena));
+    if (LargeSizeClass == seg->sizeClass)
+    {
+        pthread_mutex_lock(&this->largeLock);
+        if (0 != seg->prev)
+        {
+            seg->prev->next = seg->next;
+        }
+        else
+        {
+            this->largeSegments = seg->next;
+        }
+        if (0 != seg->next)
+        {
+            seg->next->prev = seg->prev;
+        }
+        pthread_mutex_unlock(&this->largeLock);
+        this->UnmapSegment(seg);
+    }
+    else
+    {
+        SizeClass& sc = this->sizeClasses[seg->sizeClass];
+        FreeBlock* block = (FreeBlock*) ptr;
+        pthread_mutex_lock(&sc.lock);
+        block->next = sc.freeList;
+        sc.freeList = block;
+        pthread_mutex_unlock(&sc.lock);
+    }
+    __atomic_sub_fetch(&this->allocCount, 1, __ATOMIC_RELAXED);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+size_t
+PosixHeapArena::Size(const void* ptr)
+{
+    n_assert(0 != ptr);
+    const Segment* seg = BlockToSegment(ptr);
+    n_assert(SegmentMagic == seg->magic);
+    if (LargeSizeClass == seg->sizeClass)
+    {
+        return seg->size;
+    }
+    else
+    {
+        return seg->arena->sizeClasses[seg->sizeClass].blockSize;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Walks all segments and free lists and checks that every free block 
+    lives in a segment of the right size class.
+*/
+bool
+PosixHeapArena::Validate() const
+{
+    bool result = true;
+    IndexT i;
+    for (i = 0; i < NumSizeClasses; i++)
+    {
+        SizeClass& sc = this->sizeClasses[i];
+        pthread_mutex_lock(&sc.lock);
+        const Segment* seg;
+        for (seg = sc.segments; 0 != seg; seg = seg->next)
+        {
+            result &= (SegmentMagic == seg->magic) && (this == seg->arena) && (i == seg->sizeClass);
+        }
+        const FreeBlock* block;
+        for (block = sc.freeList; result && (0 != block); block = block->next)
+        {
+            seg = BlockToSegment(block);
+            result &= (SegmentMagic == seg->magic) && (this == seg->arena) && (i == seg->sizeClass);
+            result &= (0 == ((((const unsigned char*)block) - ((const unsigned char*)seg) - SegmentHeaderSize) % sc.blockSize));
+        }
+        pthread_mutex_unlock(&sc.lock);
+    }
+    pthread_mutex_lock(&this->largeLock);
+    const Segment* seg;
+    for (seg = this->largeSegments; 0 != seg; seg = seg->next)
+    {
+        result &= (SegmentMagic == seg->magic) && (this == seg->arena) && (LargeSizeClass == seg->sizeClass);
+    }
+    pthread_mutex_unlock(&this->largeLock);
+    return result;
+}
+
+} // namespace Posix
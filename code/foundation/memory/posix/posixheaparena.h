@@ -0,0 +1,176 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Posix::PosixHeapArena
+    
+    The low level allocator behind the global heaps and Memory::Heap 
+    objects on POSIX platforms, this is the equivalent of a Win32 heap 
+    handle. Memory is requested from the OS in 256 kByte segments with 
+    mmap(), which are aligned to their size so that the segment header 
+    of any block can be found by masking the block address.
+    
+    Small blocks (up to 16 kByte) are rounded up to one of 40 size 
+    classes, each size class has its own lock, free list and a
+    bump-allocated current segment (segments are never shared between 
+    size classes). Large blocks get their own mmap'ed segment which is
+    returned to the OS when the block is freed. All blocks are 16-byte 
+    aligned.
+
+    PosixHeapArena objects live in their own mmap'ed memory, so
+    that they can be created before the C++ runtime and the
+    Nebula3 heaps have been setup.
+    
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/config.h"
+#include <stddef.h>
+#include <pthread.h>
+
+//------------------------------------------------------------------------------
+namespace Posix
+{
+class PosixHeapArena
+{
+public:
+    /// create a new arena (name must be static string!)
+    static PosixHeapArena* Create(const char* name);
+    /// destroy an arena, releases all memory back to the OS
+    static void Destroy(PosixHeapArena* arena);
+    /// get the usable size of a block
+    static size_t Size(const void* ptr);
+
+    /// get arena name
+    const char* GetName() const;
+    /// allocate a 16-byte aligned block of memory, returns 0 if out of memory
+    void* Alloc(size_t size);
+    /// re-allocate a block of memory, returns 0 if out of memory
+    void* Realloc(void* ptr, size_t size);
+    /// free a block of memory which has been allocated from this arena
+    void Free(void* ptr);
+    /// check the segment lists and free lists for consistency
+    bool Validate() const;
+    /// get the number of currently allocated blocks
+    int GetAllocCount() const;
+    /// get the number of bytes currently mapped from the OS
+    size_t GetMappedSize() const;
+
+private:
+    /// constructor (called from Create())
+    PosixHeapArena(const char* name);
+    /// destructor (called from Destroy())
+    ~PosixHeapArena();
+
+    static const unsigned int SegmentMagic = ('N' << 24) | ('S' << 16) | ('E' << 8) | 'G';
+    static const size_t SegmentSize = (256 * 1024);
+    static const size_t SegmentHeaderSize = 64;
+    static const size_t MaxSmallSize = (16 * 1024);
+    static const int NumSizeClasses = 40;
+    static const int LargeSizeClass = -1;
+
+    /// segment header, located at the start of each segment
+    struct Segment
+    {
+        unsigned int magic;
+        int sizeClass;
+        size_t size;            // block size for large segments
+        size_t mappedSize;
+        PosixHeapArena* arena;
+        Segment* next;
+        Segment* prev;
+    };
+    /// free list entry, stored in the free block itself
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+    /// per size class data
+    struct SizeClass
+    {
+        pthread_mutex_t lock;
+        size_t blockSize;
+        FreeBlock* freeList;
+        unsigned char* bumpPtr;
+        unsigned char* bumpEnd;
+        Segment* segments;
+    };
+
+    /// map size to size class index
+    static int SizeToClass(size_t size);
+    /// get the segment header of a block
+    static Segment* BlockToSegment(const void* ptr);
+    /// map a new segment aligned to SegmentSize
+    Segment* MapSegment(size_t size);
+    /// unmap a segment
+    void UnmapSegment(Segment* seg);
+    /// allocate a small block
+    void* AllocSmall(int sizeClass);
+    /// allocate a large block
+    void* AllocLarge(size_t size);
+
+    const char* name;
+    mutable SizeClass sizeClasses[NumSizeClasses];
+    mutable pthread_mutex_t largeLock;
+    Segment* largeSegments;
+    int volatile allocCount;
+    size_t volatile mappedSize;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const char*
+PosixHeapArena::GetName() const
+{
+    return this->name;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline int
+PosixHeapArena::GetAllocCount() const
+{
+    return this->allocCount;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline size_t
+PosixHeapArena::GetMappedSize() const
+{
+    return this->mappedSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Size classes are spaced 16 bytes apart up to 256 bytes, above that
+    each power of two is divided into 4 size classes.
+*/
+__forceinline int
+PosixHeapArena::SizeToClass(size_t size)
+{
+    if (size <= 256)
+    {
+        return (size <= 16) ? 0 : int((size - 1) >> 4);
+    }
+    else
+    {
+        // size is in (2^b, 2^(b+1)]
+        int b = (8 * sizeof(unsigned long) - 1) - __builtin_clzl((unsigned long)(size - 1));
+        int k = int((size - (size_t(1) << b) - 1) >> (b - 2));
+        return 16 + ((b - 8) * 4) + k;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline PosixHeapArena::Segment*
+PosixHeapArena::BlockToSegment(const void* ptr)
+{
+    return (Segment*) (((size_t)ptr) & ~(SegmentSize - 1));
+}
+
+} // namespace Posix
+//------------------------------------------------------------------------------
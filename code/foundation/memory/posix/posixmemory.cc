@@ -0,0 +1,390 @@
+//------------------------------------------------------------------------------
+//  posixmemory.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "core/types.h"
+#include "core/sysfunc.h"
+#include "memory/heap.h"
+#include "memory/smallobjectallocator.h"
+
+#if !NEBULA3_EDITOR
+//------------------------------------------------------------------------------
+/*
+    Override new / delete operators.
+*/
+void*
+operator new(size_t size)
+{
+    return Memory::Alloc(Memory::ObjectHeap, size);
+}
+
+void*
+operator new(size_t size, const std::nothrow_t& noThrow) throw()
+{
+    return Memory::Alloc(Memory::ObjectHeap, size);
+}
+
+void*
+operator new[](size_t size)
+{
+    return Memory::Alloc(Memory::ObjectArrayHeap, size);
+}
+
+void*
+operator new[](size_t size, const std::nothrow_t& noThrow) throw()
+{
+    return Memory::Alloc(Memory::ObjectArrayHeap, size);
+}
+
+void
+operator delete(void* p) throw()
+{
+    Memory::Free(Memory::ObjectHeap, p);
+}
+
+void
+operator delete[](void* p) throw()
+{
+    Memory::Free(Memory::ObjectArrayHeap, p);
+}
+#endif
+
+namespace Memory
+{
+int volatile TotalAllocCount = 0;
+int volatile TotalAllocSize = 0;
+int volatile HeapTypeAllocCount[NumHeapTypes] = { 0 };
+int volatile HeapTypeAllocSize[NumHeapTypes] = { 0 };
+bool volatile MemoryLoggingEnabled = false;
+unsigned int volatile MemoryLoggingThreshold = 0;
+HeapType volatile MemoryLoggingHeapType = InvalidHeapType;
+
+#if NEBULA3_MEMORY_STATS
+//------------------------------------------------------------------------------
+/**
+    Get the actual size of a block from the small object allocator or
+    from a heap arena.
+*/
+static size_t
+GetAllocSize(const void* ptr)
+{
+    #if NEBULA3_USE_SMALLOBJECT_ALLOCATOR
+    if (SmallObjectAllocator::IsSmallBlock(ptr))
+    {
+        return SmallObjectAllocator::GetBlockSize(ptr);
+    }
+    #endif
+    return Posix::PosixHeapArena::Size(ptr);
+}
+#endif
+
+//------------------------------------------------------------------------------
+/**
+    Allocate a block of memory from one of the global heaps.
+*/
+void*
+Alloc(HeapType heapType, size_t size)
+{
+    n_assert(heapType < NumHeapTypes);
+    
+    // need to make sure everything has been setup
+    Core::SysFunc::Setup();
+
+    void* allocPtr = 0;
+    #if NEBULA3_USE_SMALLOBJECT_ALLOCATOR
+    if (SmallObjectAllocator::IsSmallObjectHeap(heapType))
+    {
+        allocPtr = SmallObjectAllocator::Alloc(size);
+    }
+    if (0 == allocPtr)
+    #endif
+    {
+        n_assert(0 != Heaps[heapType]);
+        allocPtr = Heaps[heapType]->Alloc(size);
+        if (0 == allocPtr)
+        {
+            n_error("Alloc: Out of memory, allocating '%s' trying to allocate '%lu' bytes\n",
+                    GetHeapTypeName(heapType), (long unsigned int) size);
+        }
+    }
+    n_assert((((size_t)allocPtr) & 15) == 0);
+    #if NEBULA3_MEMORY_STATS
+        size = GetAllocSize(allocPtr);
+        Threading::Interlocked::Increment(TotalAllocCount);
+        Threading::Interlocked::Add(TotalAllocSize, (int)size);
+        Threading::Interlocked::Increment(HeapTypeAllocCount[heapType]);
+        Threading::Interlocked::Add(HeapTypeAllocSize[heapType], (int)size);
+        if (MemoryLoggingEnabled && (size >= MemoryLoggingThreshold) &&
+            ((MemoryLoggingHeapType == InvalidHeapType) || (MemoryLoggingHeapType == heapType)))
+        {
+            n_printf("Allocate(size=%lu, heapType=%d): 0x%lx\n", (long unsigned int) size, heapType, (long unsigned int) allocPtr);
+        }
+    #endif
+    return allocPtr;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Reallocate a block of memory.
+*/
+void*
+Realloc(HeapType heapType, void* ptr, size_t size)
+{
+    n_assert((heapType < NumHeapTypes) && (0 != Heaps[heapType]));
+    #if NEBULA3_USE_SMALLOBJECT_ALLOCATOR
+    if (SmallObjectAllocator::IsSmallBlock(ptr))
+    {
+        // small blocks can shrink in place, but can't grow
+        size_t oldSize = SmallObjectAllocator::GetBlockSize(ptr);
+        if (size <= oldSize)
+        {
+            return ptr;
+        }
+        void* newPtr = Alloc(heapType, size);
+        Memory::Copy(ptr, newPtr, oldSize);
+        Free(heapType, ptr);
+        return newPtr;
+    }
+    #endif
+    #if NEBULA3_MEMORY_STATS
+        size_t oldSize = (0 != ptr) ? Posix::PosixHeapArena::Size(ptr) : 0;
+    #endif
+    void* allocPtr = Heaps[heapType]->Realloc(ptr, size);
+    if (0 == allocPtr)
+    {
+        n_error("Realloc: Out of memory, allocating '%s' trying to allocate '%lu' bytes\n",
+                GetHeapTypeName(heapType), (long unsigned int) size);
+    }
+    n_assert((((size_t)allocPtr) & 15) == 0);
+    #if NEBULA3_MEMORY_STATS
+        size_t newSize = Posix::PosixHeapArena::Size(allocPtr);
+        if (0 == ptr)
+        {
+            Threading::Interlocked::Increment(TotalAllocCount);
+            Threading::Interlocked::Increment(HeapTypeAllocCount[heapType]);
+        }
+        Threading::Interlocked::Add(TotalAllocSize, int(newSize - oldSize));
+        Threading::Interlocked::Add(HeapTypeAllocSize[heapType], int(newSize - oldSize));
+        if (MemoryLoggingEnabled && (size >= MemoryLoggingThreshold) &&
+            ((MemoryLoggingHeapType == InvalidHeapType) || (MemoryLoggingHeapType == heapType)))
+        {
+            n_printf("Reallocate(size=%lu, heapType=%d): 0x%lx\n", (long unsigned int) size, heapType, (long unsigned int) allocPtr);
+        }
+    #endif
+    return allocPtr;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Free a chunk of memory from the process heap.
+*/
+void
+Free(HeapType heapType, void* ptr)
+{
+    if (0 != ptr)
+    {
+        n_assert(heapType < NumHeapTypes);
+        n_assert(0 != Heaps[heapType]);
+        #if NEBULA3_MEMORY_STATS
+            size_t size = GetAllocSize(ptr);
+        #endif
+        #if NEBULA3_USE_SMALLOBJECT_ALLOCATOR
+        if (SmallObjectAllocator::IsSmallBlock(ptr))
+        {
+            SmallObjectAllocator::Free(ptr);
+        }
+        else
+        #endif
+        {
+            Heaps[heapType]->Free(ptr);
+        }
+        #if NEBULA3_MEMORY_STATS
+            Threading::Interlocked::Add(TotalAllocSize, -int(size));
+            Threading::Interlocked::Decrement(TotalAllocCount);
+            Threading::Interlocked::Add(HeapTypeAllocSize[heapType], -int(size));
+            Threading::Interlocked::Decrement(HeapTypeAllocCount[heapType]);
+            if (MemoryLoggingEnabled && (size >= MemoryLoggingThreshold) &&
+                ((MemoryLoggingHeapType == InvalidHeapType) || (MemoryLoggingHeapType == heapType)))
+            {
+                n_printf("Mem::Free(heapType=%d, ptr=0x%lx, allocSize=%lu)\n", heapType, (long unsigned int) ptr, (long unsigned int) size);
+            }
+        #endif
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Duplicate a 0-terminated string. The memory will be allocated from
+    the StringDataHeap (important when freeing the memory!)
+*/
+char*
+DuplicateCString(const char* from)
+{
+    n_assert(0 != from);
+    size_t len = (unsigned int) strlen(from) + 1;
+    char* to = (char*) Memory::Alloc(Memory::StringDataHeap, len);
+    Memory::Copy((void*)from, to, len);
+    return to;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Test if 2 areas of memory areas are overlapping.
+*/
+bool
+IsOverlapping(const unsigned char* srcPtr, size_t srcSize, const unsigned char* dstPtr, size_t dstSize)
+{
+    if (srcPtr == dstPtr)
+    {
+        return true;
+    }
+    else if (srcPtr > dstPtr)
+    {
+        return (srcPtr + srcSize) > dstPtr;
+    }
+    else
+    {
+        return (dstPtr + dstSize) > srcPtr;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Get the system's total memory status. Values are clamped to 4 GByte.
+*/
+TotalMemoryStatus
+GetTotalMemoryStatus()
+{
+    unsigned long long pageSize = (unsigned long long) sysconf(_SC_PAGESIZE);
+    unsigned long long totalPhys = pageSize * (unsigned long long) sysconf(_SC_PHYS_PAGES);
+    unsigned long long availPhys = pageSize * (unsigned long long) sysconf(_SC_AVPHYS_PAGES);
+    const unsigned long long maxValue = 0xffffffffULL;
+    TotalMemoryStatus result;
+    result.totalPhysical = (unsigned int) ((totalPhys < maxValue) ? totalPhys : maxValue);
+    result.availPhysical = (unsigned int) ((availPhys < maxValue) ? availPhys : maxValue);
+    result.totalVirtual  = result.totalPhysical;
+    result.availVirtual  = result.availPhysical;
+    return result;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Dump detail memory status information.
+*/
+void
+DumpTotalMemoryStatus()
+{
+    n_printf("DumpTotalMemoryStatus() not implemented yet in N3.\n");   
+}
+
+#if NEBULA3_MEMORY_STATS
+//------------------------------------------------------------------------------
+/**
+    Enable memory logging.
+*/
+void
+EnableMemoryLogging(unsigned int threshold, HeapType heapType)
+{
+    MemoryLoggingEnabled = true;
+    MemoryLoggingThreshold = threshold;
+    MemoryLoggingHeapType = heapType;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Disable memory logging.
+*/
+void
+DisableMemoryLogging()
+{
+    MemoryLoggingEnabled = false;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Toggle memory logging.
+*/
+void
+ToggleMemoryLogging(unsigned int threshold, HeapType heapType)
+{
+    if (MemoryLoggingEnabled)
+    {
+        DisableMemoryLogging();
+    }
+    else
+    {
+        EnableMemoryLogging(threshold, heapType);
+    }
+}
+#endif // NEBULA3_MEMORY_STATS
+
+#if NEBULA3_MEMORY_ADVANCED_DEBUGGING
+//------------------------------------------------------------------------------
+/**
+    Debug function which validates the global heaps and all local heaps. 
+*/
+bool
+ValidateMemory()
+{
+    bool res = true;
+
+    // validate global heaps
+    IndexT i;
+    for (i = 0; i < NumHeapTypes; i++)
+    {
+        if (0 != Heaps[i])
+        {
+            res &= Heaps[i]->Validate();
+        }
+    }
+
+    // validate local heaps
+    res &= Heap::ValidateAllHeaps();
+    return res;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Write memory debugging info to log.
+*/
+void
+Checkpoint(const char* msg)
+{
+    n_printf("MEMORY LOG: %s\n", msg);
+    ValidateMemory();
+
+    // also dump a general alloc count/alloc size by heap type...
+    n_printf("NEBULA ALLOC COUNT / SIZE: %d / %d\n", TotalAllocCount, TotalAllocSize);
+    IndexT i;
+    for (i = 0; i < NumHeapTypes; i++)
+    {
+        const char* heapName = GetHeapTypeName((HeapType)i);
+        n_printf("HEAP ALLOC COUNT / SIZE / MAPPED: %s %d / %d / %d\n", heapName, 
+            HeapTypeAllocCount[i], HeapTypeAllocSize[i], (int) Heaps[i]->GetMappedSize());
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Generate a memory leak dump for all heaps managed by Nebula.
+*/
+void
+DumpMemoryLeaks()
+{
+    // dump heap object memory leaks
+    Heap::DumpLeaksAllHeaps();
+
+    // dump global heaps
+    IndexT i;
+    for (i = 0; i < NumHeapTypes; i++)
+    {
+        if (0 != Heaps[i])
+        {
+            Heap::DumpHeapMemoryLeaks(GetHeapTypeName((HeapType)i), Heaps[i]);
+        }
+    }
+}
+#endif
+
+} // namespace Memory
@@ -0,0 +1,179 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @file memory/posix/posixmemory.h
+    
+    Lowlevel memory functions for POSIX platforms.
+    
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/config.h"
+#include "core/debug.h"
+#include "memory/posix/posixmemoryconfig.h"
+#include <string.h>
+
+namespace Memory
+{
+extern int volatile TotalAllocCount;
+extern int volatile TotalAllocSize;
+extern int volatile HeapTypeAllocCount[NumHeapTypes];
+extern int volatile HeapTypeAllocSize[NumHeapTypes];
+extern unsigned int volatile MemoryLoggingThreshold;
+extern HeapType volatile MemoryLoggingHeapType;
+
+//------------------------------------------------------------------------------
+/**
+    Global memory functions.
+*/
+/// allocate a chunk of memory
+extern void* Alloc(HeapType heapType, size_t size);
+/// re-allocate a chunk of memory
+extern void* Realloc(HeapType heapType, void* ptr, size_t size);
+/// free a chunk of memory
+extern void Free(HeapType heapType, void* ptr);
+/// duplicate a C-string (obsolete)
+extern char* DuplicateCString(const char* from);
+/// check if 2 memory regions are overlapping
+extern bool IsOverlapping(const unsigned char* srcPtr, size_t srcSize, const unsigned char* dstPtr, size_t dstSize);
+
+//------------------------------------------------------------------------------
+/**
+    Get the system's total current memory, this does not only include
+    Nebula3's memory allocations but the memory usage of the entire system.
+*/
+struct TotalMemoryStatus
+{
+    unsigned int totalPhysical;
+    unsigned int availPhysical;
+    unsigned int totalVirtual;
+    unsigned int availVirtual;
+};
+
+extern TotalMemoryStatus GetTotalMemoryStatus();
+extern void DumpTotalMemoryStatus();
+
+//------------------------------------------------------------------------------
+/**
+    Debug and memory validation functions.
+*/
+#if NEBULA3_MEMORY_STATS
+/// enable memory logging
+void EnableMemoryLogging(unsigned int threshold, HeapType heapType = InvalidHeapType);
+/// disable memory logging
+void DisableMemoryLogging();
+/// toggle memory logging
+void ToggleMemoryLogging(unsigned int threshold, HeapType heapType = InvalidHeapType);
+#endif
+
+#if NEBULA3_MEMORY_ADVANCED_DEBUGGING
+/// check memory lists for consistency
+extern bool ValidateMemory();
+/// dump current memory status to log file
+extern void Checkpoint(const char* msg);
+/// dump memory leaks
+void DumpMemoryLeaks();
+#endif
+
+#if NEBULA3_MEMORY_ADVANCED_DEBUGGING
+#define __MEMORY_CHECKPOINT(s) Memory::Checkpoint(s)
+#else
+#define __MEMORY_CHECKPOINT(s)
+#endif
+
+// FIXME: Memory-Validation disabled for now
+#define __MEMORY_VALIDATE(s)
+
+//------------------------------------------------------------------------------
+/**
+    Copy a chunk of memory (note the argument order is different from memcpy()!!!)
+*/
+__forceinline void
+Copy(const void* from, void* to, size_t numBytes)
+{
+    if (numBytes > 0)
+    {
+        n_assert(0 != from);
+        n_assert(0 != to);
+        n_assert(from != to);
+        memcpy(to, from, numBytes);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Copy a chunk of memory, the source and destination may overlap
+    (note the argument order is different from memmove()!!!)
+*/
+__forceinline void
+Move(const void* from, void* to, size_t numBytes)
+{
+    if (numBytes > 0)
+    {
+        n_assert(0 != from);
+        n_assert(0 != to);
+        memmove(to, from, numBytes);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Copy data from a system memory buffer to graphics resource memory. Some
+    platforms may need special handling of this case.
+*/
+__forceinline void
+CopyToGraphicsMemory(const void* from, void* to, size_t numBytes)
+{
+    // no special handling on POSIX platforms
+    Memory::Copy(from, to, numBytes);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Overwrite a chunk of memory with 0's.
+*/
+__forceinline void
+Clear(void* ptr, size_t numBytes)
+{
+    memset(ptr, 0, numBytes);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Fill memory with a specific byte.
+*/
+__forceinline void
+Fill(void* ptr, size_t numBytes, unsigned char value)
+{
+    memset(ptr, value, numBytes);
+}
+
+} // namespace Memory
+
+#ifdef new
+#undef new
+#endif
+
+#ifdef delete
+#undef delete
+#endif
+
+//------------------------------------------------------------------------------
+/**
+    Replacement global new/delete operators, these must not be inline
+    under GCC, so they are implemented in posixmemory.cc.
+*/
+#if !NEBULA3_EDITOR
+#include <new>
+extern void* operator new(size_t size);
+extern void* operator new(size_t size, const std::nothrow_t& noThrow) throw();
+extern void* operator new[](size_t size);
+extern void* operator new[](size_t size, const std::nothrow_t& noThrow) throw();
+extern void operator delete(void* p) throw();
+extern void operator delete[](void* p) throw();
+#endif
+
+#define n_new(type) new type
+#define n_new_array(type,size) new type[size]
+#define n_delete(ptr) delete ptr
+#define n_delete_array(ptr) delete[] ptr
+//------------------------------------------------------------------------------
@@ -0,0 +1,89 @@
+//------------------------------------------------------------------------------
+//  posixmemoryconfig.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "memory/posix/posixmemoryconfig.h"
+#include "core/sysfunc.h"
+#include "memory/smallobjectallocator.h"
+
+#if NEBULA3_OBJECTS_USE_MEMORYPOOL
+#include "memory/poolarrayallocator.h"
+#endif
+
+namespace Memory
+{
+Posix::PosixHeapArena* volatile Heaps[NumHeapTypes] = { 0 };
+
+#if NEBULA3_OBJECTS_USE_MEMORYPOOL
+PoolArrayAllocator* ObjectPoolAllocator = 0;
+#endif
+
+//------------------------------------------------------------------------------
+/**
+    This method is called once at application startup from 
+    Core::SysFunc::Setup() to setup the various Nebula3 heaps.
+*/
+void
+SetupHeaps()
+{
+    unsigned int i;
+    for (i = 0; i < NumHeapTypes; i++)
+    {
+        n_assert(0 == Heaps[i]);
+        Heaps[i] = Posix::PosixHeapArena::Create(GetHeapTypeName((HeapType)i));
+        if (0 == Heaps[i])
+        {
+            Core::SysFunc::Error("Failed to create heap in Memory::SetupHeaps() (posixmemoryconfig.cc)!");
+        }
+    }
+
+    #if NEBULA3_USE_SMALLOBJECT_ALLOCATOR
+    // setup the allocator for small blocks from the general purpose heaps
+    SmallObjectAllocator::Setup(SmallObjectAllocator::DefaultArenaSize);
+    #endif
+
+    #if NEBULA3_OBJECTS_USE_MEMORYPOOL
+    // setup the RefCounted pool allocator
+    const unsigned int kiloByte = 1024;
+    uint objectPoolSizes[PoolArrayAllocator::NumPools] = {
+        2048 * kiloByte,    // 28 byte blocks
+        2048 * kiloByte,    // 60 byte blocks
+        1024 * kiloByte,    // 92 byte blocks
+        1024 * kiloByte,    // 124 byte blocks
+        128 * kiloByte,     // 156 byte blocks
+        128 * kiloByte,     // 188 byte blocks
+        2048 * kiloByte,    // 220 byte blocks
+        2048 * kiloByte     // 252 byte blocks
+    };
+    ObjectPoolAllocator = n_new(PoolArrayAllocator);
+    ObjectPoolAllocator->Setup("ObjectPoolAllocator", ObjectHeap, objectPoolSizes);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+const char*
+GetHeapTypeName(HeapType heapType)
+{
+    switch (heapType)
+    {
+        case DefaultHeap:               return "Default Heap";
+        case ObjectHeap:                return "Object Heap";
+        case ObjectArrayHeap:           return "Object Array Heap";
+        case ResourceHeap:              return "Resource Heap";
+        case ScratchHeap:               return "Scratch Heap";
+        case StringDataHeap:            return "String Data Heap";
+        case StreamDataHeap:            return "Stream Data Heap";
+        case PhysicsHeap:               return "Physics Heap";
+        case AppHeap:                   return "App Heap";
+        case NetworkHeap:               return "Network Heap";
+        case ScaleformHeap:             return "Scaleform Heap";
+        default:
+            Core::SysFunc::Error("Invalid HeapType arg in Memory::GetHeapTypeName()! (posixmemoryconfig.cc)");
+            return 0;
+    }
+}
+
+} // namespace Memory
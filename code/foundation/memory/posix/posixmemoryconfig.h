@@ -0,0 +1,75 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @file memory/posix/posixmemoryconfig.h
+    
+    Central config file for memory setup on POSIX platforms.
+    
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/config.h"
+#include "core/debug.h"
+#include "memory/posix/posixheaparena.h"
+
+namespace Memory
+{
+
+//------------------------------------------------------------------------------
+/**
+    Heap types are defined here. The main purpose for the different heap
+    types is to decrease memory fragmentation and to improve cache
+    usage by grouping similar data together. Platform ports may define
+    platform-specific heap types, as long as only platform specific
+    code uses those new heap types.
+*/
+enum HeapType
+{
+    DefaultHeap = 0,            // for stuff that doesn't fit into any category
+    ObjectHeap,                 // heap for global new allocator
+    ObjectArrayHeap,            // heap for global new[] allocator
+    ResourceHeap,               // heap for resource data (like animation buffers)
+    ScratchHeap,                // for short-lived scratch memory (encode/decode buffers, etc...)
+    StringDataHeap,             // special heap for string data
+    StreamDataHeap,             // special heap for stream data like memory streams, zip file streams, etc...
+    PhysicsHeap,                // physics engine allocations go here
+    AppHeap,                    // for general Application layer stuff
+    NetworkHeap,                // for network layer
+    ScaleformHeap,              // the scaleform UI heap
+    
+    NumHeapTypes,
+    InvalidHeapType,
+};
+
+//------------------------------------------------------------------------------
+/**
+    Heap pointers are defined here. Call ValidateHeap() to check whether
+    a heap already has been setup, and to setup the heap if not.
+*/
+extern Posix::PosixHeapArena* volatile Heaps[NumHeapTypes];
+
+//------------------------------------------------------------------------------
+/**
+    This method is called by SysFunc::Setup() to setup the different heap
+    types. Under POSIX all heaps grow on demand, there are no initial
+    or maximum sizes.
+*/
+extern void SetupHeaps();
+
+//------------------------------------------------------------------------------
+/**
+    Returns a human readable name for a heap type.
+*/
+extern const char* GetHeapTypeName(HeapType heapType);
+
+//------------------------------------------------------------------------------
+/**
+    Global PoolArrayAllocator objects, these are all setup in a central
+    place in the Memory::SetupHeaps() function!
+*/
+#if NEBULA3_OBJECTS_USE_MEMORYPOOL
+class PoolArrayAllocator;
+extern PoolArrayAllocator* ObjectPoolAllocator;  // Rtti::AllocInstanceMemory() and new operators alloc from here
+#endif    
+
+} // namespace Memory    
+//------------------------------------------------------------------------------
@@ -0,0 +1,145 @@
+//------------------------------------------------------------------------------
+//  posixmemorypool.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "memory/posix/posixmemorypool.h"
+#include "util/string.h"
+
+namespace Posix
+{
+using namespace Util;
+
+//------------------------------------------------------------------------------
+/**
+*/
+PosixMemoryPool::PosixMemoryPool() :
+    heapType(Memory::InvalidHeapType),
+    blockSize(0),
+    alignedBlockSize(0),
+    poolSize(0),
+    numBlocks(0),
+    #if NEBULA3_MEMORY_STATS
+    allocCount(0),
+    #endif
+    listHead(0),
+    poolStart(0),
+    poolEnd(0)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+PosixMemoryPool::~PosixMemoryPool()
+{
+    #if NEBULA3_MEMORY_STATS
+    if (this->allocCount != 0)
+    {
+        String str;
+        str.Format("PosixMemoryPool: %d memory leaks in pool '%p'!\n", this->allocCount, this);
+        Core::SysFunc::DebugOut(str.AsCharPtr());
+    }
+    #endif
+
+    // discard memory pool
+    Memory::Free(this->heapType, this->poolStart);
+    this->poolStart = 0;
+    this->poolEnd = 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PosixMemoryPool::Setup(Memory::HeapType heapType_, uint blockSize_, uint numBlocks_)
+{
+    n_assert(0 == this->poolStart);
+    n_assert(0 == this->poolEnd);
+    this->blockSize = blockSize_;
+    this->numBlocks = numBlocks_;
+    this->heapType = heapType_;
+
+    #if NEBULA3_MEMORY_STATS
+    this->allocCount = 0;
+    #endif
+
+    // compute block size with header
+    this->alignedBlockSize = ComputeAlignedBlockSize(this->blockSize);
+    this->poolSize = this->numBlocks * this->alignedBlockSize;
+
+    // setup pool memory block, each entry in the block has a 16 byte header
+    // with a pointer to the next block, the actual start of the memory block
+    // is 16-byte-aligned
+    this->poolStart = (ubyte*) Memory::Alloc(this->heapType, this->poolSize);
+    this->poolEnd = this->poolStart + this->poolSize;
+    
+    // setup forward-linked free-block-list
+    this->listHead = 0;
+    IndexT i;
+    for (i = this->numBlocks - 1; i >= 0; i--)
+    {
+        ListEntry* entry = (ListEntry*) (this->poolStart + i * this->alignedBlockSize);
+        entry->next = this->listHead;
+        this->listHead = entry;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void*
+PosixMemoryPool::Alloc()
+{
+    // get the next free block from the free list and fixup the free list
+    this->critSect.Enter();
+    ListEntry* entry = this->listHead;
+    if (0 != entry)
+    {
+        this->listHead = entry->next;
+    }
+    this->critSect.Leave();
+    if (0 == entry)
+    {
+        return 0;
+    }
+    #if NEBULA3_MEMORY_STATS
+    Threading::Interlocked::Increment(this->allocCount);
+    #endif
+    void* ptr = (void*) (((ubyte*)entry) + BlockAlign);
+
+    // fill with debug pattern
+    #if NEBULA3_DEBUG
+    Memory::Fill(ptr, this->blockSize, NewBlockPattern);
+    #endif
+
+    return ptr;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PosixMemoryPool::Free(void* ptr)
+{
+    n_assert(this->IsPoolBlock(ptr));
+    #if NEBULA3_MEMORY_STATS
+    n_assert(this->allocCount > 0);
+    Threading::Interlocked::Decrement(this->allocCount);
+    #endif
+
+    // fill free'd block with debug pattern
+    #if NEBULA3_DEBUG
+    Memory::Fill(ptr, this->blockSize, FreeBlockPattern);
+    #endif
+
+    // get pointer to header and fixup free list
+    ListEntry* entry = (ListEntry*) (((ubyte*)ptr) - BlockAlign);
+    this->critSect.Enter();
+    entry->next = this->listHead;
+    this->listHead = entry;
+    this->critSect.Leave();
+}
+
+} // namespace Posix
@@ -0,0 +1,141 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Posix::PosixMemoryPool
+    
+    A simple thread-safe memory pool. Memory pool items are 16-byte aligned.
+    The free block list is protected by a critical section.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+#include "threading/criticalsection.h"
+
+//------------------------------------------------------------------------------
+namespace Posix
+{
+class PosixMemoryPool
+{
+public:
+    /// constructor
+    PosixMemoryPool();
+    /// destructor
+    ~PosixMemoryPool();
+    /// compute the actual block size including alignment and management data
+    static uint ComputeAlignedBlockSize(uint blockSize);
+    /// setup the memory pool
+    void Setup(Memory::HeapType heapType, uint blockSize, uint numBlocks);
+    /// allocate a block from the pool (NOTE: returns 0 if pool exhausted!)
+    void* Alloc();
+    /// deallocate a block from the pool
+    void Free(void* ptr);
+    /// return true if block is owned by this pool
+    bool IsPoolBlock(void* ptr) const;
+    /// get number of allocated blocks in pool
+    uint GetNumBlocks() const;
+    /// get block size
+    uint GetBlockSize() const;
+    /// get aligned block size
+    uint GetAlignedBlockSize() const;
+    /// get pool size
+    uint GetPoolSize() const;
+    /// get current allocation count
+    #if NEBULA3_MEMORY_STATS
+    uint GetAllocCount() const;
+    #endif
+
+private:
+    /// free list entry, located in the 16 bytes in front of each block
+    struct ListEntry
+    {
+        ListEntry* next;
+    };
+
+    static const uint FreeBlockPattern = 0xFE;
+    static const uint NewBlockPattern = 0xFD;
+    static const int  BlockAlign = 16;
+
+    Memory::HeapType heapType;
+    uint blockSize;
+    uint alignedBlockSize;
+    uint poolSize;
+    uint numBlocks;
+    #if NEBULA3_MEMORY_STATS
+    int volatile allocCount;
+    #endif
+    
+    Threading::CriticalSection critSect;
+    ListEntry* listHead;
+    ubyte* poolStart;
+    ubyte* poolEnd;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+#if NEBULA3_MEMORY_STATS
+inline uint
+PosixMemoryPool::GetAllocCount() const
+{
+    return this->allocCount;
+}
+#endif
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline uint
+PosixMemoryPool::ComputeAlignedBlockSize(uint blockSize)
+{
+    uint blockSizeWithHeader = blockSize + BlockAlign;
+    uint padding = (BlockAlign - (blockSizeWithHeader % BlockAlign)) % BlockAlign;
+    return (blockSizeWithHeader + padding);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline uint
+PosixMemoryPool::GetNumBlocks() const
+{
+    return this->numBlocks;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline uint
+PosixMemoryPool::GetBlockSize() const
+{
+    return this->blockSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline uint
+PosixMemoryPool::GetAlignedBlockSize() const
+{
+    return this->alignedBlockSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline uint
+PosixMemoryPool::GetPoolSize() const
+{
+    return this->poolSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+PosixMemoryPool::IsPoolBlock(void* ptr) const
+{
+    return (ptr >= this->poolStart) && (ptr < this->poolEnd);
+}
+
+} // namespace Posix
+//------------------------------------------------------------------------------
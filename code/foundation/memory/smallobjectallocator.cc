@@ -0,0 +1,403 @@
+//------------------------------------------------------------------------------
+//  smallobjectallocator.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "memory/smallobjectallocator.h"
+#include "threading/interlocked.h"
+
+#if NEBULA3_USE_SMALLOBJECT_ALLOCATOR
+#if __LINUX__
+#include <sys/mman.h>
+#include <sched.h>
+#endif
+
+namespace Memory
+{
+Threading::ThreadLocalSlot SmallObjectAllocator::Cache;
+unsigned char* SmallObjectAllocator::ArenaStart = 0;
+size_t SmallObjectAllocator::ArenaSize = 0;
+void* volatile SmallObjectAllocator::Depot[NumSizeClasses] = { 0 };
+int volatile SmallObjectAllocator::DepotLocks[NumSizeClasses] = { 0 };
+int volatile SmallObjectAllocator::ChunkLock = 0;
+SizeT SmallObjectAllocator::NumChunks = 0;
+unsigned char* SmallObjectAllocator::ChunkPos[NumSizeClasses] = { 0 };
+unsigned char* SmallObjectAllocator::ChunkEnd[NumSizeClasses] = { 0 };
+void* SmallObjectAllocator::FreeBlocks[NumSizeClasses] = { 0 };
+SizeT SmallObjectAllocator::ClassNumChunks[NumSizeClasses] = { 0 };
+unsigned char* SmallObjectAllocator::CacheChunkPos = 0;
+unsigned char* SmallObjectAllocator::CacheChunkEnd = 0;
+SmallObjectAllocator::ThreadCache* SmallObjectAllocator::FreeCaches = 0;
+unsigned char SmallObjectAllocator::ChunkClasses[MaxArenaSize / ChunkSize] = { 0 };
+
+//------------------------------------------------------------------------------
+/**
+    Reserves the address range for all small blocks, physical memory is
+    only committed when a new chunk is needed. This is called very early
+    from Memory::SetupHeaps(), so no Nebula3 services may be used here.
+    If the address range can't be reserved, the allocator simply stays
+    invalid and all allocations go to the normal heaps.
+*/
+void
+SmallObjectAllocator::Setup(SizeT arenaSize)
+{
+    n_assert(!IsValid());
+    n_assert((arenaSize > 0) && (arenaSize <= MaxArenaSize));
+    size_t size = ((arenaSize + ChunkSize - 1) / ChunkSize) * ChunkSize;
+    #if __WIN32__
+        void* ptr = VirtualAlloc(NULL, size, MEM_RESERVE, PAGE_READWRITE);
+    #elif __LINUX__
+        void* ptr = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (MAP_FAILED == ptr)
+        {
+            ptr = 0;
+        }
+    #else
+    #error "SmallObjectAllocator::Setup() not implemented on this platform!"
+    #endif
+    if (0 != ptr)
+    {
+        ArenaSize = size;
+        ArenaStart = (unsigned char*) ptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+SmallObjectAllocator::Lock(int volatile& lockFlag)
+{
+    while (0 != Threading::Interlocked::CompareExchange(&lockFlag, 1, 0))
+    {
+        #if __WIN32__
+            SwitchToThread();
+        #elif __LINUX__
+            sched_yield();
+        #endif
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+SmallObjectAllocator::Unlock(int volatile& lockFlag)
+{
+    Threading::Interlocked::Exchange(&lockFlag, 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Commit the next chunk of the arena. The chunk class is either a size
+    class, or CacheChunkClass for chunks which contain thread caches.
+    Returns 0 if the arena is exhausted.
+*/
+unsigned char*
+SmallObjectAllocator::CommitChunk(unsigned char chunkClass)
+{
+    if (size_t(NumChunks + 1) * ChunkSize > ArenaSize)
+    {
+        return 0;
+    }
+    unsigned char* chunk = ArenaStart + NumChunks * ChunkSize;
+    #if __WIN32__
+    if (0 == VirtualAlloc(chunk, ChunkSize, MEM_COMMIT, PAGE_READWRITE))
+    {
+        return 0;
+    }
+    #endif
+    ChunkClasses[NumChunks++] = chunkClass;
+    return chunk;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Fill a magazine, first with blocks which have been returned by
+    terminated threads, then with new blocks from the current chunk of
+    the size class. Returns false if no block could be found at all.
+*/
+bool
+SmallObjectAllocator::CarveMagazine(IndexT sizeClass, Magazine& outMagazine)
+{
+    size_t blockSize = ClassBlockSize(sizeClass);
+    outMagazine.blocks = 0;
+    outMagazine.count = 0;
+    while ((outMagazine.count < MagazineSize) && (0 != FreeBlocks[sizeClass]))
+    {
+        void* ptr = FreeBlocks[sizeClass];
+        FreeBlocks[sizeClass] = *(void**)ptr;
+        *(void**)ptr = outMagazine.blocks;
+        outMagazine.blocks = ptr;
+        outMagazine.count++;
+    }
+    while (outMagazine.count < MagazineSize)
+    {
+        if (size_t(ChunkEnd[sizeClass] - ChunkPos[sizeClass]) < blockSize)
+        {
+            unsigned char* chunk = CommitChunk((unsigned char)sizeClass);
+            if (0 == chunk)
+            {
+                break;
+            }
+            ChunkPos[sizeClass] = chunk;
+            ChunkEnd[sizeClass] = chunk + ChunkSize;
+            ClassNumChunks[sizeClass]++;
+        }
+        void* ptr = ChunkPos[sizeClass];
+        ChunkPos[sizeClass] += blockSize;
+        *(void**)ptr = outMagazine.blocks;
+        outMagazine.blocks = ptr;
+        outMagazine.count++;
+    }
+    return (outMagazine.count > 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Push a full magazine to the depot. The first block of the magazine
+    links the magazines in the depot (the second pointer in the block,
+    the first pointer links the blocks in the magazine).
+*/
+void
+SmallObjectAllocator::PushMagazine(IndexT sizeClass, void* blocks)
+{
+    // start with an empty depot as guess, a failed compare-exchange
+    // returns the actual head
+    void* head = 0;
+    while (true)
+    {
+        ((void**)blocks)[1] = head;
+        void* prevHead = Threading::Interlocked::CompareExchangePointer(&Depot[sizeClass], blocks, head);
+        if (prevHead == head)
+        {
+            break;
+        }
+        head = prevHead;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Pop a full magazine from the depot. Since only one thread at a time
+    may pop, the head can't be popped and pushed again by another thread
+    between reading its link and the compare-exchange.
+*/
+bool
+SmallObjectAllocator::PopMagazine(IndexT sizeClass, Magazine& outMagazine)
+{
+    Lock(DepotLocks[sizeClass]);
+    // a compare-exchange with 0 is an atomic read of the head
+    void* head = Threading::Interlocked::CompareExchangePointer(&Depot[sizeClass], 0, 0);
+    while (0 != head)
+    {
+        void* prevHead = Threading::Interlocked::CompareExchangePointer(&Depot[sizeClass], ((void**)head)[1], head);
+        if (prevHead == head)
+        {
+            break;
+        }
+        head = prevHead;
+    }
+    Unlock(DepotLocks[sizeClass]);
+    if (0 != head)
+    {
+        outMagazine.blocks = head;
+        outMagazine.count = MagazineSize;
+        return true;
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Setup the thread cache of the calling thread. The caches of terminated
+    threads are reused, new caches are placed in special chunks of the
+    arena, so that creating a cache doesn't need the normal heaps.
+*/
+SmallObjectAllocator::ThreadCache*
+SmallObjectAllocator::CreateThreadCache()
+{
+    n_assert(0 == Cache.Get());
+    Lock(ChunkLock);
+    ThreadCache* cache = FreeCaches;
+    if (0 != cache)
+    {
+        FreeCaches = cache->nextFree;
+    }
+    else
+    {
+        if (size_t(CacheChunkEnd - CacheChunkPos) < sizeof(ThreadCache))
+        {
+            unsigned char* chunk = CommitChunk(CacheChunkClass);
+            if (0 != chunk)
+            {
+                CacheChunkPos = chunk;
+                CacheChunkEnd = chunk + ChunkSize;
+            }
+        }
+        if (size_t(CacheChunkEnd - CacheChunkPos) >= sizeof(ThreadCache))
+        {
+            cache = (ThreadCache*) CacheChunkPos;
+            CacheChunkPos += sizeof(ThreadCache);
+        }
+    }
+    Unlock(ChunkLock);
+    if (0 != cache)
+    {
+        Memory::Clear(cache, sizeof(ThreadCache));
+        Cache.Set(cache);
+    }
+    return cache;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Called when the current magazine is empty. Swaps in the previous
+    magazine if it is full, otherwise gets a full magazine from the depot,
+    or carves a new magazine from the chunks.
+*/
+void*
+SmallObjectAllocator::AllocSlow(IndexT sizeClass)
+{
+    ThreadCache* cache = (ThreadCache*) Cache.Get();
+    if (0 == cache)
+    {
+        cache = CreateThreadCache();
+        if (0 == cache)
+        {
+            return 0;
+        }
+    }
+    Magazine& current = cache->current[sizeClass];
+    Magazine& previous = cache->previous[sizeClass];
+    n_assert(0 == current.count);
+    if (previous.count > 0)
+    {
+        Magazine empty = current;
+        current = previous;
+        previous = empty;
+    }
+    else if (!PopMagazine(sizeClass, current))
+    {
+        Lock(ChunkLock);
+        bool carved = CarveMagazine(sizeClass, current);
+        Unlock(ChunkLock);
+        if (!carved)
+        {
+            return 0;
+        }
+    }
+    void* ptr = current.blocks;
+    current.blocks = *(void**)ptr;
+    current.count--;
+    return ptr;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Called when the current magazine is full. The previous magazine is
+    either empty or full, a full previous magazine goes to the depot,
+    and the current magazine becomes the previous magazine.
+*/
+void
+SmallObjectAllocator::FreeSlow(void* ptr, IndexT sizeClass)
+{
+    ThreadCache* cache = (ThreadCache*) Cache.Get();
+    if (0 == cache)
+    {
+        cache = CreateThreadCache();
+        if (0 == cache)
+        {
+            // no cache available, return the block directly
+            Lock(ChunkLock);
+            *(void**)ptr = FreeBlocks[sizeClass];
+            FreeBlocks[sizeClass] = ptr;
+            Unlock(ChunkLock);
+            return;
+        }
+    }
+    Magazine& current = cache->current[sizeClass];
+    Magazine& previous = cache->previous[sizeClass];
+    if (MagazineSize == current.count)
+    {
+        if (previous.count > 0)
+        {
+            n_assert(MagazineSize == previous.count);
+            PushMagazine(sizeClass, previous.blocks);
+        }
+        previous = current;
+        current.blocks = 0;
+        current.count = 0;
+    }
+    *(void**)ptr = current.blocks;
+    current.blocks = ptr;
+    current.count++;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Return all blocks of the calling thread's cache. Full magazines go to
+    the depot, the blocks of partially filled magazines go to the free
+    block lists which are used when carving new magazines. The cache
+    itself is kept for reuse by new threads.
+*/
+void
+SmallObjectAllocator::FlushThreadCache()
+{
+    ThreadCache* cache = (ThreadCache*) Cache.Get();
+    if (0 == cache)
+    {
+        return;
+    }
+    Cache.Set(0);
+    Lock(ChunkLock);
+    IndexT sizeClass;
+    for (sizeClass = 0; sizeClass < NumSizeClasses; sizeClass++)
+    {
+        Magazine* magazines[2] = { &cache->current[sizeClass], &cache->previous[sizeClass] };
+        IndexT i;
+        for (i = 0; i < 2; i++)
+        {
+            Magazine& magazine = *magazines[i];
+            if (MagazineSize == magazine.count)
+            {
+                PushMagazine(sizeClass, magazine.blocks);
+            }
+            else
+            {
+                while (0 != magazine.blocks)
+                {
+                    void* ptr = magazine.blocks;
+                    magazine.blocks = *(void**)ptr;
+                    *(void**)ptr = FreeBlocks[sizeClass];
+                    FreeBlocks[sizeClass] = ptr;
+                }
+            }
+        }
+    }
+    cache->nextFree = FreeCaches;
+    FreeCaches = cache;
+    Unlock(ChunkLock);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+SizeT
+SmallObjectAllocator::GetNumChunks()
+{
+    return NumChunks;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+SizeT
+SmallObjectAllocator::GetNumChunks(IndexT sizeClass)
+{
+    n_assert(sizeClass < NumSizeClasses);
+    return ClassNumChunks[sizeClass];
+}
+
+} // namespace Memory
+#endif // NEBULA3_USE_SMALLOBJECT_ALLOCATOR
@@ -0,0 +1,253 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Memory::SmallObjectAllocator
+
+    A lock-free allocator for small memory blocks, used by Memory::Alloc()
+    for all allocations of up to MaxBlockSize bytes from the heap types
+    where IsSmallObjectHeap() returns true (RefCounted objects, messages,
+    strings and small arrays).
+
+    Block sizes are rounded up to one of NumSizeClasses size classes
+    (16, 32, 48, ... 256 bytes), all blocks are 16-byte aligned. The
+    memory comes from one contiguous address range which is reserved
+    at startup, so that Memory::Free() can identify a small block
+    with a simple range check. The address range is committed in chunks
+    of ChunkSize bytes, each chunk only contains blocks of one size class.
+
+    Each thread owns a cache with 2 magazines per size class (found
+    through a Threading::ThreadLocalSlot, which also works in the DLL
+    builds for Maya and the editor). A magazine
+    is a linked list of up to MagazineSize free blocks. Alloc() and Free()
+    only touch the calling thread's cache as long as possible. Full
+    magazines are exchanged with a global depot stack per size class.
+    Freeing threads push to the depot with a lock-free compare-exchange,
+    only popping is serialized by a per-class spin lock (which avoids
+    the ABA problem without tagged pointers). Only when the depot is
+    empty, new blocks are taken from a chunk under a spin lock. A block
+    can be freed by any thread, it then simply goes into the freeing
+    thread's cache.
+
+    Memory is never returned to the operating system. If the reserved
+    address range is exhausted, Alloc() returns 0 and Memory::Alloc()
+    falls back to the normal heap.
+
+    FlushThreadCache() must be called before a thread terminates, the
+    Nebula3 thread classes do this automatically.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+#include "threading/threadlocalslot.h"
+
+#if NEBULA3_USE_SMALLOBJECT_ALLOCATOR
+//------------------------------------------------------------------------------
+namespace Memory
+{
+class SmallObjectAllocator
+{
+public:
+    /// setup the allocator, called from Memory::SetupHeaps()
+    static void Setup(SizeT arenaSize = DefaultArenaSize);
+    /// return true if the allocator has been setup
+    static bool IsValid();
+    /// return true if small allocations from the heap type should go through the allocator
+    static bool IsSmallObjectHeap(HeapType heapType);
+    /// allocate a block, returns 0 if size is too big or the allocator is exhausted
+    static void* Alloc(size_t size);
+    /// free a block which has been allocated by Alloc()
+    static void Free(void* ptr);
+    /// return true if a pointer has been allocated by Alloc()
+    static bool IsSmallBlock(const void* ptr);
+    /// get the actual (rounded-up) size of a block
+    static size_t GetBlockSize(const void* ptr);
+    /// return the cached blocks of the calling thread to the global depot
+    static void FlushThreadCache();
+    /// get number of committed chunks
+    static SizeT GetNumChunks();
+    /// get number of committed chunks of a size class
+    static SizeT GetNumChunks(IndexT sizeClass);
+
+    static const SizeT MaxBlockSize = 256;
+    static const SizeT Granularity = 16;
+    static const SizeT NumSizeClasses = MaxBlockSize / Granularity;
+    static const SizeT ChunkSize = 64 * 1024;
+    static const SizeT MagazineSize = 64;
+    static const SizeT DefaultArenaSize = 64 * 1024 * 1024;
+    static const SizeT MaxArenaSize = 256 * 1024 * 1024;
+
+private:
+    /// a linked list of free blocks
+    struct Magazine
+    {
+        void* blocks;
+        SizeT count;
+    };
+    /// the per-thread cache
+    struct ThreadCache
+    {
+        Magazine current[NumSizeClasses];
+        Magazine previous[NumSizeClasses];
+        ThreadCache* nextFree;
+    };
+
+    /// get the size class of a size
+    static IndexT SizeClass(size_t size);
+    /// get the block size of a size class
+    static size_t ClassBlockSize(IndexT sizeClass);
+    /// slow path of Alloc()
+    static void* AllocSlow(IndexT sizeClass);
+    /// slow path of Free()
+    static void FreeSlow(void* ptr, IndexT sizeClass);
+    /// create or reuse the calling thread's cache
+    static ThreadCache* CreateThreadCache();
+    /// push a full magazine to the depot
+    static void PushMagazine(IndexT sizeClass, void* blocks);
+    /// pop a full magazine from the depot
+    static bool PopMagazine(IndexT sizeClass, Magazine& outMagazine);
+    /// fill a magazine with new blocks, called with the chunk lock taken
+    static bool CarveMagazine(IndexT sizeClass, Magazine& outMagazine);
+    /// commit a new chunk of the arena, called with the chunk lock taken
+    static unsigned char* CommitChunk(unsigned char chunkClass);
+    /// take a spin lock
+    static void Lock(int volatile& lockFlag);
+    /// release a spin lock
+    static void Unlock(int volatile& lockFlag);
+
+    static const unsigned char CacheChunkClass = 0xff;
+
+    static Threading::ThreadLocalSlot Cache;
+    static unsigned char* ArenaStart;
+    static size_t ArenaSize;
+    static void* volatile Depot[NumSizeClasses];
+    static int volatile DepotLocks[NumSizeClasses];
+    static int volatile ChunkLock;
+    static SizeT NumChunks;
+    static unsigned char* ChunkPos[NumSizeClasses];
+    static unsigned char* ChunkEnd[NumSizeClasses];
+    static void* FreeBlocks[NumSizeClasses];
+    static SizeT ClassNumChunks[NumSizeClasses];
+    static unsigned char* CacheChunkPos;
+    static unsigned char* CacheChunkEnd;
+    static ThreadCache* FreeCaches;
+    static unsigned char ChunkClasses[MaxArenaSize / ChunkSize];
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+SmallObjectAllocator::IsValid()
+{
+    return (0 != ArenaStart);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+SmallObjectAllocator::IsSmallObjectHeap(HeapType heapType)
+{
+    switch (heapType)
+    {
+        case DefaultHeap:
+        case ObjectHeap:
+        case ObjectArrayHeap:
+        case ScratchHeap:
+        case StringDataHeap:
+            return true;
+        default:
+            return false;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Works for any pointer, even if the allocator has not been setup.
+*/
+inline bool
+SmallObjectAllocator::IsSmallBlock(const void* ptr)
+{
+    return ((size_t)ptr - (size_t)ArenaStart) < ArenaSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline IndexT
+SmallObjectAllocator::SizeClass(size_t size)
+{
+    return (0 == size) ? 0 : IndexT((size - 1) / Granularity);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline size_t
+SmallObjectAllocator::ClassBlockSize(IndexT sizeClass)
+{
+    return (sizeClass + 1) * Granularity;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline size_t
+SmallObjectAllocator::GetBlockSize(const void* ptr)
+{
+    n_assert(IsSmallBlock(ptr));
+    return ClassBlockSize(ChunkClasses[((const unsigned char*)ptr - ArenaStart) / ChunkSize]);
+}
+
+//------------------------------------------------------------------------------
+/**
+    The fast path only pops a block from the thread's current magazine.
+*/
+inline void*
+SmallObjectAllocator::Alloc(size_t size)
+{
+    if ((size > MaxBlockSize) || !IsValid())
+    {
+        return 0;
+    }
+    IndexT sizeClass = SizeClass(size);
+    ThreadCache* cache = (ThreadCache*) Cache.Get();
+    if (0 != cache)
+    {
+        Magazine& magazine = cache->current[sizeClass];
+        if (magazine.count > 0)
+        {
+            void* ptr = magazine.blocks;
+            magazine.blocks = *(void**)ptr;
+            magazine.count--;
+            return ptr;
+        }
+    }
+    return AllocSlow(sizeClass);
+}
+
+//------------------------------------------------------------------------------
+/**
+    The fast path only pushes the block to the thread's current magazine.
+*/
+inline void
+SmallObjectAllocator::Free(void* ptr)
+{
+    n_assert(IsSmallBlock(ptr));
+    IndexT sizeClass = ChunkClasses[((unsigned char*)ptr - ArenaStart) / ChunkSize];
+    n_assert(sizeClass < NumSizeClasses);
+    ThreadCache* cache = (ThreadCache*) Cache.Get();
+    if ((0 != cache) && (cache->current[sizeClass].count < MagazineSize))
+    {
+        Magazine& magazine = cache->current[sizeClass];
+        *(void**)ptr = magazine.blocks;
+        magazine.blocks = ptr;
+        magazine.count++;
+        return;
+    }
+    FreeSlow(ptr, sizeClass);
+}
+
+} // namespace Memory
+#endif // NEBULA3_USE_SMALLOBJECT_ALLOCATOR
+//------------------------------------------------------------------------------
@@ -28,6 +28,22 @@ Copy(const void* from, void* to, size_t numBytes)
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+    Copy a chunk of memory, the source and destination may overlap
+    (note the argument order is different from memmove()!!!)
+*/
+__forceinline void
+Move(const void* from, void* to, size_t numBytes)
+{
+    if (numBytes > 0)
+    {
+        n_assert(0 != from);
+        n_assert(0 != to);
+        MoveMemory(to, from, numBytes);
+    }
+}
+
 //------------------------------------------------------------------------------
 /**
     Copy data from a system memory buffer to graphics resource memory. Some
@@ -7,6 +7,7 @@
 #include "core/sysfunc.h"
 #include "memory/heap.h"
 #include "memory/poolarrayallocator.h"
+#include "memory/smallobjectallocator.h"
 
 namespace Memory
 {
@@ -32,6 +33,19 @@ Alloc(HeapType heapType, size_t size)
     Core::SysFunc::Setup();
 
     void* allocPtr = 0;
+    #if NEBULA3_USE_SMALLOBJECT_ALLOCATOR
+    if (SmallObjectAllocator::IsSmallObjectHeap(heapType))
+    {
+        allocPtr = SmallObjectAllocator::Alloc(size);
+    }
+    if (0 != allocPtr)
+    {
+        #if NEBULA3_MEMORY_STATS
+            size = SmallObjectAllocator::GetBlockSize(allocPtr);
+        #endif
+    }
+    else
+    #endif
     #if __XBOX360__
     if (Xbox360GraphicsHeap == heapType)
     {
@@ -76,6 +90,21 @@ Realloc(HeapType heapType, void* ptr, size_t size)
 {
     n_assert((heapType != Xbox360GraphicsHeap) && (heapType != Xbox360AudioHeap));
     n_assert((heapType < NumHeapTypes) && (0 != Heaps[heapType]));
+    #if NEBULA3_USE_SMALLOBJECT_ALLOCATOR
+    if (SmallObjectAllocator::IsSmallBlock(ptr))
+    {
+        // small blocks can shrink in place, but can't grow
+        size_t oldSize = SmallObjectAllocator::GetBlockSize(ptr);
+        if (size <= oldSize)
+        {
+            return ptr;
+        }
+        void* newPtr = Alloc(heapType, size);
+        Memory::Copy(ptr, newPtr, oldSize);
+        Free(heapType, ptr);
+        return newPtr;
+    }
+    #endif
     #if NEBULA3_MEMORY_STATS
         SIZE_T oldSize = __HeapSize16(Heaps[heapType], 0, ptr);
     #endif
@@ -113,6 +142,16 @@ Free(HeapType heapType, void* ptr)
         #if NEBULA3_MEMORY_STATS
             SIZE_T size = 0;
         #endif    
+        #if NEBULA3_USE_SMALLOBJECT_ALLOCATOR
+        if (SmallObjectAllocator::IsSmallBlock(ptr))
+        {
+            #if NEBULA3_MEMORY_STATS
+                size = SmallObjectAllocator::GetBlockSize(ptr);
+            #endif
+            SmallObjectAllocator::Free(ptr);
+        }
+        else
+        #endif
         #if __XBOX360__
         if (Xbox360GraphicsHeap == heapType)
         {
@@ -5,6 +5,7 @@
 #include "stdneb.h"
 #include "memory/win360/win360memoryconfig.h"
 #include "core/sysfunc.h"
+#include "memory/smallobjectallocator.h"
 
 #if NEBULA3_OBJECTS_USE_MEMORYPOOL
 #include "memory/poolarrayallocator.h"
@@ -95,6 +96,11 @@ SetupHeaps()
         }
     }
 
+    #if NEBULA3_USE_SMALLOBJECT_ALLOCATOR
+    // setup the allocator for small blocks from the general purpose heaps
+    SmallObjectAllocator::Setup(SmallObjectAllocator::DefaultArenaSize);
+    #endif
+
     #if NEBULA3_OBJECTS_USE_MEMORYPOOL        
     // setup the RefCounted pool allocator
     // HMM THESE NUMBERS ARE SO HIGH BECAUSE OF GODSEND...
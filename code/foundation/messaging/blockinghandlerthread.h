@@ -9,7 +9,7 @@
     (C) 2009 Radon Labs GmbH
 */
 #include "messaging/handlerthreadbase.h"
-#include "threading/safequeue.h"
+#include "messaging/messagequeue.h"
 
 //------------------------------------------------------------------------------
 namespace Messaging
@@ -38,7 +38,7 @@ public:
 
 private:
     int waitTimeout;
-    Threading::SafeQueue<Ptr<Message> > msgQueue;
+    MessageQueue msgQueue;
 };
 
 //------------------------------------------------------------------------------
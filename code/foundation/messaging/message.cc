@@ -17,7 +17,10 @@ __ImplementMsgId(Message);
 Message::Message() :
     handled(0),
     deferred(false),
-    deferredHandled(false)
+    deferredHandled(false),
+    queueNext(0),
+    queueEnqueued(0),
+    queueCanceled(0)
 {
     // empty
 }
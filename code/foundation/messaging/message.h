@@ -10,6 +10,11 @@
     Messages are implemented as normal C++ objects which can encode and
     decode themselves from and to a stream.
 
+    The __ImplementMsgId macro enables the instance pool of the message
+    class (see Core::Rtti::EnableInstancePool()), so the memory of
+    destroyed messages is recycled for new messages of the same class
+    instead of going back to the heap.
+
     (C) 2006 Radon Labs GmbH
 */
 #include "core/refcounted.h"
@@ -25,11 +30,13 @@
 #define __DeclareMsgId \
 public:\
     static Messaging::Id Id; \
+    static const bool InstancePoolEnabled; \
     virtual const Messaging::Id& GetId() const;\
 private:
 
 #define __ImplementMsgId(type) \
     Messaging::Id type::Id; \
+    const bool type::InstancePoolEnabled = type::RTTI.EnableInstancePool(NEBULA3_MESSAGE_POOL_SIZE); \
     const Messaging::Id& type::GetId() const { return type::Id; }
 
 //------------------------------------------------------------------------------
@@ -37,6 +44,7 @@ namespace Messaging
 {
 class MessageReader;
 class MessageWriter;
+class MessageQueue;
 class Port;
 
 class Message : public Core::RefCounted
@@ -68,6 +76,12 @@ protected:
     volatile int handled;
     bool deferred;
     bool deferredHandled;
+
+private:
+    friend class MessageQueue;
+    Message* queueNext;             // link in a MessageQueue
+    volatile int queueEnqueued;     // set while the message is in a MessageQueue
+    volatile int queueCanceled;     // set by MessageQueue::Cancel()
 };
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,100 @@
+//------------------------------------------------------------------------------
+//  messagequeue.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "messaging/messagequeue.h"
+
+namespace Messaging
+{
+using namespace Threading;
+
+//------------------------------------------------------------------------------
+/**
+*/
+MessageQueue::MessageQueue() :
+    head(0),
+    signalOnEnqueueEnabled(true)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+    Releases the references to all messages which are still in the queue.
+*/
+MessageQueue::~MessageQueue()
+{
+    Message* msg = this->TakeAll();
+    while (0 != msg)
+    {
+        Message* next = msg->queueNext;
+        msg->queueNext = 0;
+        msg->queueEnqueued = 0;
+        msg->Release();
+        msg = next;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Since producers only ever push to the head and the consumer always
+    takes the whole list, the compare-exchange doesn't suffer from the
+    ABA problem.
+*/
+Message*
+MessageQueue::TakeAll()
+{
+    Message* list;
+    do
+    {
+        list = this->head;
+    }
+    while ((0 != list) && (Interlocked::CompareExchangePointer((void* volatile*)&this->head, 0, list) != list));
+    return list;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Replaces the content of outArray with the pending messages in the order
+    they have been sent. The queue's references to the messages are
+    handed over to the array.
+*/
+void
+MessageQueue::DequeueAll(Util::Array<Ptr<Message> >& outArray)
+{
+    outArray.Clear();
+    Message* list = this->TakeAll();
+    if (0 == list)
+    {
+        return;
+    }
+
+    // the list is in reverse sending order, reverse it and count messages
+    Message* fifo = 0;
+    SizeT numMessages = 0;
+    while (0 != list)
+    {
+        Message* next = list->queueNext;
+        list->queueNext = fifo;
+        fifo = list;
+        list = next;
+        numMessages++;
+    }
+
+    outArray.Reserve(numMessages);
+    while (0 != fifo)
+    {
+        Message* next = fifo->queueNext;
+        fifo->queueNext = 0;
+        fifo->queueEnqueued = 0;
+        if (0 == fifo->queueCanceled)
+        {
+            outArray.Append(fifo);
+        }
+        fifo->Release();
+        fifo = next;
+    }
+}
+
+} // namespace Messaging
@@ -0,0 +1,177 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Messaging::MessageQueue
+
+    A lock-free multiple-producer/single-consumer message queue for the
+    handler threads of AsyncPorts. Any number of threads may call
+    Enqueue() at the same time, DequeueAll(), Wait() and WaitTimeout()
+    must only be called from the handler thread.
+
+    The queue is an intrusive linked list through the messages, so a
+    message can only be in one queue at a time, and only once. It may be
+    sent again after it has been dequeued. Enqueue() pushes the message
+    with a single compare-exchange, DequeueAll() takes the whole list with
+    another compare-exchange and restores the sending order. No locks are
+    taken and no memory is allocated on either side.
+
+    Wakeups are batched: the internal event is only signalled when a
+    message is added to an empty queue, all further messages are picked up
+    by the same wakeup of the handler thread. As with Threading::SafeQueue,
+    signalling can be disabled for continously running threads.
+
+    Cancel() doesn't remove the message from the queue, it flags the
+    message so that DequeueAll() drops it. If the message has already been
+    dequeued it's too late to cancel the message.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "messaging/message.h"
+#include "threading/event.h"
+#include "threading/interlocked.h"
+
+//------------------------------------------------------------------------------
+namespace Messaging
+{
+class MessageQueue
+{
+public:
+    /// constructor
+    MessageQueue();
+    /// destructor
+    ~MessageQueue();
+
+    /// enable/disable signalling on Enqueue() (default is enabled)
+    void SetSignalOnEnqueueEnabled(bool b);
+    /// return signalling-on-Enqueue() flag
+    bool IsSignalOnEnqueueEnabled() const;
+    /// return true if queue is empty
+    bool IsEmpty() const;
+    /// add a message to the back of the queue (can be called from any thread)
+    void Enqueue(const Ptr<Message>& msg);
+    /// dequeue all messages in sending order, dropping cancelled messages
+    void DequeueAll(Util::Array<Ptr<Message> >& outArray);
+    /// cancel a pending message (can be called from any thread)
+    void Cancel(const Ptr<Message>& msg);
+    /// wait until queue contains at least one message
+    void Wait();
+    /// wait until queue contains at least one message, or time-out happens
+    void WaitTimeout(int ms);
+    /// signal the internal event, so that Wait() will return
+    void Signal();
+
+private:
+    /// take the whole list from the queue, returns list in reverse order
+    Message* TakeAll();
+
+    Message* volatile head;
+    Threading::Event enqueueEvent;
+    bool signalOnEnqueueEnabled;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+MessageQueue::SetSignalOnEnqueueEnabled(bool b)
+{
+    this->signalOnEnqueueEnabled = b;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+MessageQueue::IsSignalOnEnqueueEnabled() const
+{
+    return this->signalOnEnqueueEnabled;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+MessageQueue::IsEmpty() const
+{
+    return (0 == this->head);
+}
+
+//------------------------------------------------------------------------------
+/**
+    The queue holds a reference to the message until it is dequeued. Only
+    the push to an empty queue signals the event, since the handler
+    thread can't be waiting while there are messages in the queue.
+    Enqueueing a message which is still in a queue would corrupt the
+    list, this is caught by an assertion.
+*/
+inline void
+MessageQueue::Enqueue(const Ptr<Message>& msg)
+{
+    n_assert(msg.isvalid());
+    Message* newHead = msg.get_unsafe();
+    int wasEnqueued = Threading::Interlocked::Exchange(&newHead->queueEnqueued, 1);
+    n_assert2(0 == wasEnqueued, "MessageQueue::Enqueue(): message is already in a queue!");
+    newHead->AddRef();
+    newHead->queueCanceled = 0;
+    Message* oldHead;
+    do
+    {
+        oldHead = this->head;
+        newHead->queueNext = oldHead;
+    }
+    while (Threading::Interlocked::CompareExchangePointer((void* volatile*)&this->head, newHead, oldHead) != oldHead);
+
+    if ((0 == oldHead) && this->signalOnEnqueueEnabled)
+    {
+        this->enqueueEvent.Signal();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+MessageQueue::Cancel(const Ptr<Message>& msg)
+{
+    n_assert(msg.isvalid());
+    Threading::Interlocked::Exchange(&msg->queueCanceled, 1);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+MessageQueue::Wait()
+{
+    if (this->signalOnEnqueueEnabled && this->IsEmpty())
+    {
+        this->enqueueEvent.Wait();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+MessageQueue::WaitTimeout(int ms)
+{
+    if (this->signalOnEnqueueEnabled && this->IsEmpty())
+    {
+        this->enqueueEvent.WaitTimeout(ms);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    This signals the internal event object, on which Wait() may be waiting.
+    This method may be useful to wake up a thread waiting for messages
+    when it should stop.
+*/
+inline void
+MessageQueue::Signal()
+{
+    this->enqueueEvent.Signal();
+}
+
+} // namespace Messaging
+//------------------------------------------------------------------------------
@@ -30,14 +30,14 @@ RunThroughHandlerThread::AddMessage(const Ptr<Message>& msg)
 
 //------------------------------------------------------------------------------
 /**
-    This removes a message from the thread's message queue, regardless
-    of its state.
+    This cancels a message in the thread's message queue, if the message
+    has already been dequeued it's too late to cancel.
 */
 void
 RunThroughHandlerThread::CancelMessage(const Ptr<Message>& msg)
 {
     n_assert(msg.isvalid());
-    this->msgQueue.EraseMatchingElements(msg);
+    this->msgQueue.Cancel(msg);
 }
 
 //------------------------------------------------------------------------------
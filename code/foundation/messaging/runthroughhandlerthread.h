@@ -9,7 +9,7 @@
     (C) 2009 Radon Labs GmbH
 */
 #include "messaging/handlerthreadbase.h"
-#include "threading/safequeue.h"
+#include "messaging/messagequeue.h"
 
 //------------------------------------------------------------------------------
 namespace Messaging
@@ -30,7 +30,7 @@ public:
     virtual void DoWork();
 
 private:
-    Threading::SafeQueue<Ptr<Message> > msgQueue;
+    MessageQueue msgQueue;
 };
 
 } // namespace Messaging
@@ -18,6 +18,8 @@
 #include "core/ps3/precompiled.h"
 #elif __OSX__
 #include "core/osx/precompiled.h"
+#elif __LINUX__
+#include "core/posix/precompiled.h"
 #else
 #error "precompiled.h not implemented on this platform"
 #endif
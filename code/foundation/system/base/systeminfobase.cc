@@ -33,6 +33,7 @@ SystemInfoBase::PlatformAsString(Platform p)
         case Xbox360:   return "xbox360";
         case Wii:       return "wii";
         case PS3:       return "ps3";
+        case Linux:     return "linux";
         default:        return "unknownplatform";
     }
 }
@@ -22,6 +22,7 @@ public:
         Xbox360,
         Wii,
         PS3,
+        Linux,
         
         UnknownPlatform,        
     };
@@ -37,6 +37,12 @@ namespace System
 {
 typedef OSX::OSXCpu Cpu;
 }
+#elif __LINUX__
+#include "system/posix/posixcpu.h"
+namespace System
+{
+typedef Posix::PosixCpu Cpu;
+}
 #else
 #error "System::Cpu not implemented on this platform!"
 #endif
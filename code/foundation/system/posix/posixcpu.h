@@ -0,0 +1,34 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Posix::PosixCpu
+    
+    CPU related definitions for POSIX platforms. Threads with a valid
+    core id are pinned to (coreId % numCores), see Posix::PosixThread.
+    
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+
+//------------------------------------------------------------------------------
+namespace Posix
+{
+class PosixCpu
+{
+public:
+    typedef unsigned int CoreId;
+    
+    /// core identifiers
+    static const CoreId InvalidCoreId       = 0xffffffff;
+    static const CoreId MainThreadCore      = 0;
+    static const CoreId IoThreadCore        = 2;
+    static const CoreId RenderThreadCore    = 1;
+    static const CoreId AudioThreadCore     = 3;
+    static const CoreId MiscThreadCore      = 4;
+    static const CoreId NetworkThreadCore   = 5;
+
+    static const CoreId JobThreadFirstCore  = 6;
+};
+
+} // namespace Posix
+//------------------------------------------------------------------------------
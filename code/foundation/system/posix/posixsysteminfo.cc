@@ -0,0 +1,32 @@
+//------------------------------------------------------------------------------
+//  posixsysteminfo.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "system/posix/posixsysteminfo.h"
+
+namespace Posix
+{
+
+//------------------------------------------------------------------------------
+/**
+*/
+PosixSystemInfo::PosixSystemInfo()
+{
+    this->platform = Linux;
+    #if (defined(__x86_64__) || defined(__amd64__))
+    this->cpuType = X86_64;
+    #elif defined(__i386__)
+    this->cpuType = X86_32;
+    #else
+    this->cpuType = UnknownCpuType;
+    #endif
+    this->numCpuCores = (SizeT) sysconf(_SC_NPROCESSORS_ONLN);
+    if (this->numCpuCores < 1)
+    {
+        this->numCpuCores = 1;
+    }
+    this->pageSize = (SizeT) sysconf(_SC_PAGESIZE);
+}
+
+} // namespace Posix
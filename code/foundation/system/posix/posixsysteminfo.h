@@ -0,0 +1,23 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Posix::PosixSystemInfo
+    
+    Provide information about the system we're running on.
+    
+    (C) 2010 Radon Labs GmbH
+*/
+#include "system/base/systeminfobase.h"
+
+//------------------------------------------------------------------------------
+namespace Posix
+{
+class PosixSystemInfo : public Base::SystemInfoBase
+{
+public:
+    /// constructor
+    PosixSystemInfo();
+};
+
+} // namespace Posix
+//------------------------------------------------------------------------------
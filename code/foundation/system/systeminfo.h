@@ -31,6 +31,12 @@ namespace System
 {
 class SystemInfo : public PS3::PS3SystemInfo {};
 }
+#elif __LINUX__
+#include "system/posix/posixsysteminfo.h"
+namespace System
+{
+class SystemInfo : public Posix::PosixSystemInfo {};
+}
 #else
 #error "System::SystemInfo not implemented on this platform!"
 #endif
@@ -20,6 +20,8 @@
 #include "threading/wii/wiibarrier.h"
 #elif __PS3__
 #include "threading/ps3/ps3barrier.h"
+#elif __LINUX__
+#include "threading/posix/posixbarrier.h"
 #else
 #error "Barrier not implemented on this platform!"
 #endif
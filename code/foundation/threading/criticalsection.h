@@ -38,6 +38,13 @@ namespace Threading
 class CriticalSection : public OSX::OSXCriticalSection
 { };
 }
+#elif __LINUX__
+#include "threading/posix/posixcriticalsection.h"
+namespace Threading
+{
+class CriticalSection : public Posix::PosixCriticalSection
+{ };
+}
 #else
 #error "Threading::CriticalSection not implemented on this platform!"
 #endif
@@ -32,6 +32,16 @@ namespace Threading
 class Event : public PS3::PS3Event
 { };
 }
+#elif __LINUX__
+#include "threading/posix/posixevent.h"
+namespace Threading
+{
+class Event : public Posix::PosixEvent
+{
+public:
+    Event(bool manualReset=false) : PosixEvent(manualReset) {};
+};
+}
 #else
 #error "Threading::Event not implemented on this platform!"
 #endif
@@ -36,6 +36,13 @@ namespace Threading
 class Interlocked : public OSX::OSXInterlocked
 { };
 }
+#elif __LINUX__
+#include "threading/posix/posixinterlocked.h"
+namespace Threading
+{
+class Interlocked : public Posix::PosixInterlocked
+{ };
+}
 #else
 #error "Threading::Interlocked not implemented on this platform!"
 #endif
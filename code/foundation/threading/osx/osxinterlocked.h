@@ -25,6 +25,8 @@ public:
     static int Exchange(int volatile* dest, int value);
     /// interlocked compare-exchange
     static int CompareExchange(int volatile* dest, int exchange, int comparand);
+    /// interlocked compare-exchange of a pointer
+    static void* CompareExchangePointer(void* volatile* dest, void* exchange, void* comparand);
 };
 
 //------------------------------------------------------------------------------
@@ -72,5 +74,14 @@ OSXInterlocked::CompareExchange(int volatile* dest, int exchange, int comparand)
     return __sync_val_compare_and_swap(dest, comparand, exchange);
 }
 
+//------------------------------------------------------------------------------
+/**
+ */
+inline void*
+OSXInterlocked::CompareExchangePointer(void* volatile* dest, void* exchange, void* comparand)
+{
+    return __sync_val_compare_and_swap(dest, comparand, exchange);
+}
+
 } // namespace OSX
 //------------------------------------------------------------------------------
@@ -0,0 +1,22 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Posix::PosixBarrier
+    
+    Implements the 2 macros ReadWriteBarrier and MemoryBarrier.
+    
+    ReadWriteBarrier prevents the compiler from re-ordering memory
+    accesses accross the barrier.
+
+    MemoryBarrier prevents the CPU from reordering memory access across
+    the barrier (all memory access will be finished before the barrier
+    is crossed).
+    
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+
+//------------------------------------------------------------------------------
+#define ReadWriteBarrier() __atomic_signal_fence(__ATOMIC_SEQ_CST)
+#define MemoryBarrier() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+//------------------------------------------------------------------------------
@@ -0,0 +1,75 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Posix::PosixCriticalSection
+
+    On POSIX platforms, recursive pthread mutexes are used for critical 
+    sections (Win32 critical sections may be entered recursively by the
+    owning thread as well).
+ 
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+
+//------------------------------------------------------------------------------
+namespace Posix
+{
+class PosixCriticalSection
+{
+public:
+    /// constructor
+    PosixCriticalSection();
+    /// destructor
+    ~PosixCriticalSection();
+    /// enter the critical section
+    void Enter() const;
+    /// leave the critical section
+    void Leave() const;
+private:
+    mutable pthread_mutex_t mutex;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline
+PosixCriticalSection::PosixCriticalSection()
+{
+    pthread_mutexattr_t mutexAttrs;
+    pthread_mutexattr_init(&mutexAttrs);
+    pthread_mutexattr_settype(&mutexAttrs, PTHREAD_MUTEX_RECURSIVE);    // allow nesting
+    int res = pthread_mutex_init(&this->mutex, &mutexAttrs);
+    n_assert(0 == res);
+    pthread_mutexattr_destroy(&mutexAttrs);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline 
+PosixCriticalSection::~PosixCriticalSection()
+{
+    int res = pthread_mutex_destroy(&this->mutex);
+    n_assert(0 == res);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+PosixCriticalSection::Enter() const
+{
+    pthread_mutex_lock(&this->mutex);
+}
+    
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+PosixCriticalSection::Leave() const
+{
+    pthread_mutex_unlock(&this->mutex);
+}
+
+} // namespace Posix
+//------------------------------------------------------------------------------
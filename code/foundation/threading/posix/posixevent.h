@@ -0,0 +1,210 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Posix::PosixEvent
+
+    Linux implementation of an event synchronization object. The event
+    state lives in a single int which threads wait on with the futex 
+    syscall, so that Signal() on an event nobody is waiting for doesn't 
+    leave user space. Behaves like the Win32 event: auto-reset events
+    release exactly one waiting thread and reset themselves, manual-reset
+    events release all waiting threads and stay signalled until Reset()
+    is called.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+
+//------------------------------------------------------------------------------
+namespace Posix
+{
+class PosixEvent
+{
+public:
+    /// constructor
+    PosixEvent(bool manualReset=false);
+    /// destructor
+    ~PosixEvent();
+    /// signal the event
+    void Signal();
+    /// reset the event (only if manual reset)
+    void Reset();
+    /// wait for the event to become signalled
+    void Wait() const;
+    /// wait for the event with timeout in millisecs
+    bool WaitTimeout(int ms) const;
+    /// check if event is signalled
+    bool Peek() const;
+
+private:
+    /// consume the signalled state, returns false if the event isn't signalled
+    bool TryConsume() const;
+    /// futex wait while the state equals the expected value
+    void FutexWait(int expected, const timespec* timeout) const;
+    /// futex wake up to num threads
+    void FutexWake(int num);
+
+    enum
+    {
+        NotSignalled = 0,
+        Signalled = 1,
+    };
+
+    mutable int volatile state;
+    mutable int volatile numWaiters;
+    bool manualReset;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline
+PosixEvent::PosixEvent(bool manual) :
+    state(NotSignalled),
+    numWaiters(0),
+    manualReset(manual)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline
+PosixEvent::~PosixEvent()
+{
+    n_assert(0 == this->numWaiters);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+PosixEvent::FutexWait(int expected, const timespec* timeout) const
+{
+    syscall(SYS_futex, (int*)&this->state, FUTEX_WAIT_PRIVATE, expected, timeout, 0, 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+PosixEvent::FutexWake(int num)
+{
+    syscall(SYS_futex, (int*)&this->state, FUTEX_WAKE_PRIVATE, num, 0, 0, 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+    An auto-reset event is consumed by the thread which observes the 
+    signalled state, a manual-reset event stays signalled.
+*/
+inline bool
+PosixEvent::TryConsume() const
+{
+    if (this->manualReset)
+    {
+        return (Signalled == __atomic_load_n(&this->state, __ATOMIC_ACQUIRE));
+    }
+    else
+    {
+        int expected = Signalled;
+        return __atomic_compare_exchange_n(&this->state, &expected, NotSignalled, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Only enters the kernel if a thread is actually waiting on the event.
+*/
+inline void
+PosixEvent::Signal()
+{
+    __atomic_store_n(&this->state, Signalled, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&this->numWaiters, __ATOMIC_SEQ_CST) > 0)
+    {
+        this->FutexWake(this->manualReset ? INT_MAX : 1);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+PosixEvent::Reset()
+{
+    __atomic_store_n(&this->state, NotSignalled, __ATOMIC_RELEASE);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+PosixEvent::Wait() const
+{
+    if (this->TryConsume())
+    {
+        return;
+    }
+    __atomic_add_fetch(&this->numWaiters, 1, __ATOMIC_SEQ_CST);
+    while (!this->TryConsume())
+    {
+        // returns immediately if the state has changed in the meantime
+        this->FutexWait(NotSignalled, 0);
+    }
+    __atomic_sub_fetch(&this->numWaiters, 1, __ATOMIC_SEQ_CST);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Waits for the event to become signaled with a specified timeout
+    in milli seconds. If the method times out it will return false,
+    if the event becomes signalled within the timeout it will return 
+    true.
+*/
+inline bool
+PosixEvent::WaitTimeout(int timeoutInMilliSec) const
+{
+    if (this->TryConsume())
+    {
+        return true;
+    }
+
+    // compute absolute deadline, the futex itself takes a relative timeout
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    long long deadline = (long long)now.tv_sec * 1000000000LL + now.tv_nsec + (long long)timeoutInMilliSec * 1000000LL;
+
+    bool signalled = false;
+    __atomic_add_fetch(&this->numWaiters, 1, __ATOMIC_SEQ_CST);
+    while (!(signalled = this->TryConsume()))
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        long long remaining = deadline - ((long long)now.tv_sec * 1000000000LL + now.tv_nsec);
+        if (remaining <= 0)
+        {
+            break;
+        }
+        timespec timeout;
+        timeout.tv_sec = (time_t) (remaining / 1000000000LL);
+        timeout.tv_nsec = (long) (remaining % 1000000000LL);
+        this->FutexWait(NotSignalled, &timeout);
+    }
+    __atomic_sub_fetch(&this->numWaiters, 1, __ATOMIC_SEQ_CST);
+    return signalled;
+}
+
+//------------------------------------------------------------------------------
+/**
+    This checks if the event is signalled and returnes immediately.
+    Like WaitForSingleObject() with a zero timeout, this consumes the
+    signal of an auto-reset event.
+*/
+inline bool
+PosixEvent::Peek() const
+{
+    return this->TryConsume();
+}
+
+} // namespace Posix
+//------------------------------------------------------------------------------
@@ -0,0 +1,95 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Posix::PosixInterlocked
+ 
+    Provides simple atomic operations on shared variables. Implemented
+    with the GCC atomic builtins, all operations are sequentially
+    consistent (like the Win32 Interlocked functions).
+ 
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+
+//------------------------------------------------------------------------------
+namespace Posix
+{
+class PosixInterlocked
+{
+public:
+    /// interlocked increment, return result
+    static int Increment(int volatile& var);
+    /// interlocked decrement, return result
+    static int Decrement(int volatile& var);
+    /// interlocked add, return original value
+    static int Add(int volatile& var, int add);
+    /// interlocked exchange
+    static int Exchange(int volatile* dest, int value);
+    /// interlocked compare-exchange
+    static int CompareExchange(int volatile* dest, int exchange, int comparand);
+    /// interlocked compare-exchange of a pointer
+    static void* CompareExchangePointer(void* volatile* dest, void* exchange, void* comparand);
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline int
+PosixInterlocked::Increment(int volatile& var)
+{
+    return __atomic_add_fetch(&var, 1, __ATOMIC_SEQ_CST);
+}
+    
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline int
+PosixInterlocked::Decrement(int volatile& var)
+{
+    return __atomic_sub_fetch(&var, 1, __ATOMIC_SEQ_CST);
+}
+    
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline int
+PosixInterlocked::Add(int volatile& var, int add)
+{
+    return __atomic_fetch_add(&var, add, __ATOMIC_SEQ_CST);
+}
+   
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline int
+PosixInterlocked::Exchange(int volatile* dest, int value)
+{
+    return __atomic_exchange_n(dest, value, __ATOMIC_SEQ_CST);
+}
+    
+//------------------------------------------------------------------------------
+/**
+    Returns the original value of dest, the exchange happened if the
+    result equals the comparand.
+*/
+__forceinline int
+PosixInterlocked::CompareExchange(int volatile* dest, int exchange, int comparand)
+{
+    __atomic_compare_exchange_n(dest, &comparand, exchange, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return comparand;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns the original value of dest, the exchange happened if the
+    result equals the comparand.
+*/
+__forceinline void*
+PosixInterlocked::CompareExchangePointer(void* volatile* dest, void* exchange, void* comparand)
+{
+    __atomic_compare_exchange_n(dest, &comparand, exchange, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return comparand;
+}
+
+} // namespace Posix
+//------------------------------------------------------------------------------
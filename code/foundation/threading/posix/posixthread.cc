@@ -0,0 +1,294 @@
+//------------------------------------------------------------------------------
+//  posixthread.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "threading/posix/posixthread.h"
+#include "system/systeminfo.h"
+#include "memory/smallobjectallocator.h"
+
+namespace Posix
+{
+__ImplementClass(Posix::PosixThread, 'THRD', Core::RefCounted);
+
+using namespace Util;
+using namespace System;
+
+ThreadLocal const char* PosixThread::ThreadName = 0;
+
+#if NEBULA3_DEBUG
+Threading::CriticalSection PosixThread::criticalSection;
+List<PosixThread*> PosixThread::ThreadList;
+#endif
+
+//------------------------------------------------------------------------------
+/**
+*/
+PosixThread::PosixThread() :
+    stopRequestEvent(true),
+    isRunning(0),
+    priority(Normal),
+    stackSize(65536),
+    coreId(Cpu::InvalidCoreId)
+{
+    // register with thread list
+    #if NEBULA3_DEBUG
+        PosixThread::criticalSection.Enter();
+        this->threadListIterator = ThreadList.AddBack(this);
+        PosixThread::criticalSection.Leave();
+    #endif
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+PosixThread::~PosixThread()
+{
+    if (this->IsRunning())
+    {
+        this->Stop();
+    }
+
+    // unregister from thread list
+    #if NEBULA3_DEBUG
+        n_assert(0 != this->threadListIterator);
+        PosixThread::criticalSection.Enter();
+        ThreadList.Remove(this->threadListIterator);
+        PosixThread::criticalSection.Leave();
+        this->threadListIterator = 0;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+/**
+    Start the thread, this creates a pthread and calls the static
+    ThreadProc, which in turn calls the virtual DoWork() class of this object.
+    If a core id has been set, the thread is created with an affinity
+    mask containing only that core, so that job worker threads don't
+    migrate between cores (and caches). The method waits for the thread 
+    to start and then returns.
+*/
+void
+PosixThread::Start()
+{
+    n_assert(!this->IsRunning());
+    this->stopRequestEvent.Reset();
+
+    pthread_attr_t attrs;
+    pthread_attr_init(&attrs);
+    SizeT stackSize = (this->stackSize < PTHREAD_STACK_MIN) ? PTHREAD_STACK_MIN : this->stackSize;
+    pthread_attr_setstacksize(&attrs, stackSize);
+    if (Cpu::InvalidCoreId != this->coreId)
+    {
+        SystemInfo systemInfo;
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(this->coreId % systemInfo.GetNumCpuCores(), &cpuSet);
+        pthread_attr_setaffinity_np(&attrs, sizeof(cpuSet), &cpuSet);
+    }
+    this->isRunning = 1;
+    int res = pthread_create(&this->thread, &attrs, ThreadProc, (void*) this);
+    n_assert(0 == res);
+    pthread_attr_destroy(&attrs);
+
+    // wait for the thread to start
+    this->threadStartedEvent.Wait();
+}
+
+//------------------------------------------------------------------------------
+/**
+    This method is called by Thread::Stop() after setting the 
+    stopRequest event and before waiting for the thread to stop. If your
+    thread runs a loop and waits for jobs it may need an extra wakeup
+    signal to stop waiting and check for the ThreadStopRequested() event. In
+    this case, override this method and signal your event object.
+*/
+void
+PosixThread::EmitWakeupSignal()
+{
+    // empty, override in subclass!
+}
+
+//------------------------------------------------------------------------------
+/**
+    This stops the thread by signalling the stopRequestEvent and waits for the
+    thread to actually quit. If the thread code runs in a loop it should use the 
+    IsStopRequested() method to see if the thread object wants it to shutdown. 
+    If so DoWork() should simply return.
+*/
+void
+PosixThread::Stop()
+{
+    n_assert(this->IsRunning());
+
+    // signal the thread to stop
+    this->stopRequestEvent.Signal();
+
+    // call the wakeup-thread method, may be derived in a subclass
+    // if the threads needs to be woken up, it is important that this
+    // method is called AFTER the stopRequestEvent is signalled!
+    this->EmitWakeupSignal();
+
+    // wait for the thread to terminate
+    pthread_join(this->thread, 0);
+    this->isRunning = 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns true if the thread is currently running.
+*/
+bool
+PosixThread::IsRunning() const
+{
+    return (0 != this->isRunning);
+}
+
+//------------------------------------------------------------------------------
+/**
+    This method should be derived in a Thread subclass and contains the
+    actual code which is run in the thread. To terminate the thread, just 
+    return from this function. If DoWork() runs in an infinite loop, call 
+    ThreadStopRequested() to check whether the Thread object wants the 
+    thread code to quit.
+*/
+void
+PosixThread::DoWork()
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+    Internal static helper method. This is called by pthread_create() and
+    simply calls the virtual DoWork() method on the thread object. Thread
+    priorities are mapped to nice values of the kernel thread, raising
+    the priority above normal requires CAP_SYS_NICE and silently fails
+    otherwise.
+*/
+void*
+PosixThread::ThreadProc(void* self)
+{
+    n_assert(0 != self);
+    {
+        #if NEBULA3_ENABLE_THREADLOCAL_STRINGATOM_TABLES
+        // setup thread-local string atom table (will be discarded when thread terminates)
+        LocalStringAtomTable localStringAtomTable;
+        #endif
+
+        PosixThread* threadObj = (PosixThread*) self;
+        switch (threadObj->priority)
+        {
+            case Low:
+                setpriority(PRIO_PROCESS, GetMyThreadId(), 5);
+                break;
+
+            case Normal:
+                break;
+
+            case High:
+                setpriority(PRIO_PROCESS, GetMyThreadId(), -5);
+                break;
+        }
+        PosixThread::SetMyThreadName(threadObj->GetName().AsCharPtr());
+        threadObj->threadStartedEvent.Signal();
+        threadObj->DoWork();
+    }
+
+    #if NEBULA3_USE_SMALLOBJECT_ALLOCATOR
+    // return the thread's cached small memory blocks, after the
+    // thread-local string atom table has been discarded
+    Memory::SmallObjectAllocator::FlushThreadCache();
+    #endif
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Static method which sets the name of this thread. This is called from
+    within ThreadProc. The string pointed to must remain valid until
+    the thread is terminated! The kernel thread name is limited to 15
+    characters, longer names are truncated.
+*/
+void
+PosixThread::SetMyThreadName(const char* n)
+{
+    // first update our own internal thread-name pointer
+    ThreadName = n;
+
+    // update the kernel thread name so that it shows up in top and the debugger
+    if (0 != n)
+    {
+        char buf[16];
+        strncpy(buf, n, sizeof(buf) - 1);
+        buf[sizeof(buf) - 1] = 0;
+        pthread_setname_np(pthread_self(), buf);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Static method to obtain the current thread name from anywhere
+    in the thread's code.
+*/
+const char*
+PosixThread::GetMyThreadName()
+{
+    return ThreadName;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Static method which returns the ThreadId of this thread.
+*/
+Threading::ThreadId
+PosixThread::GetMyThreadId()
+{
+    return (Threading::ThreadId) syscall(SYS_gettid);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Give up time slice.
+*/
+void
+PosixThread::YieldThread()
+{
+    sched_yield();
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns an array with infos about all currently existing thread objects.
+*/
+#if NEBULA3_DEBUG
+Array<PosixThread::ThreadDebugInfo>
+PosixThread::GetRunningThreadDebugInfos()
+{
+    // NOTE: Portions of this loop aren't completely thread-safe
+    // (getting the thread-name for instance), but since those
+    // attributes don't change when the thread has been started
+    // this shouldn't be a problem.
+    Array<ThreadDebugInfo> infos;
+    PosixThread::criticalSection.Enter();
+    List<PosixThread*>::Iterator iter;
+    for (iter = ThreadList.Begin(); iter != ThreadList.End(); iter++)
+    {
+        PosixThread* cur = *iter;
+        if (cur->IsRunning())
+        {
+            ThreadDebugInfo info;
+            info.threadName = cur->GetName();
+            info.threadPriority = cur->GetPriority();
+            info.threadCoreId = cur->GetCoreId();
+            info.threadStackSize = cur->GetStackSize();
+            infos.Append(info);
+        }
+    }
+    PosixThread::criticalSection.Leave();
+    return infos;
+}
+#endif
+
+} // namespace Posix
@@ -0,0 +1,205 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Posix::PosixThread
+    
+    POSIX implementation of thread class, uses the pthread API. If a
+    core id has been set, the thread will be pinned to that core
+    (modulo the number of online cores).
+    
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/refcounted.h"
+#include "threading/posix/posixevent.h"
+#include "threading/threadid.h"
+#include "system/cpu.h"
+#include "util/localstringatomtable.h"
+
+//------------------------------------------------------------------------------
+namespace Posix
+{
+class PosixThread : public Core::RefCounted
+{
+    __DeclareClass(PosixThread);
+public:
+    /// thread priorities
+    enum Priority
+    {
+        Low,
+        Normal,
+        High,
+    };
+
+    /// constructor
+    PosixThread();
+    /// destructor
+    virtual ~PosixThread();
+    /// set the thread priority
+    void SetPriority(Priority p);
+    /// get the thread priority
+    Priority GetPriority() const;
+    /// set cpu core on which the thread should be running
+    void SetCoreId(System::Cpu::CoreId coreId);
+    /// get the cpu core on which the thread should be running
+    System::Cpu::CoreId GetCoreId() const;
+    /// set stack size in bytes (default is 64 KByte)
+    void SetStackSize(SizeT s);
+    /// get stack size
+    SizeT GetStackSize() const;
+    /// set thread name
+    void SetName(const Util::String& n);
+    /// get thread name
+    const Util::String& GetName() const;
+
+    /// start executing the thread code, returns when thread has actually started
+    void Start();
+    /// request threading code to stop, returns when thread has actually finished
+    void Stop();
+    /// return true if thread has been started
+    bool IsRunning() const;
+    
+    /// yield the thread (gives up current time slice)
+    static void YieldThread();
+    /// set thread name from within thread context
+    static void SetMyThreadName(const char* n);
+    /// obtain name of thread from within thread context
+    static const char* GetMyThreadName();
+    /// get the thread ID of this thread
+    static Threading::ThreadId GetMyThreadId();
+    
+    #if NEBULA3_DEBUG
+    struct ThreadDebugInfo
+    {
+        Util::String threadName;
+        PosixThread::Priority threadPriority;
+        System::Cpu::CoreId threadCoreId;
+        SizeT threadStackSize;
+    };
+    /// query thread stats (debug mode only)
+    static Util::Array<ThreadDebugInfo> GetRunningThreadDebugInfos();        
+    #endif
+
+protected:
+    /// override this method if your thread loop needs a wakeup call before stopping
+    virtual void EmitWakeupSignal();
+    /// this method runs in the thread context
+    virtual void DoWork();
+    /// check if stop is requested, call from DoWork() to see if the thread proc should quit
+    bool ThreadStopRequested() const;
+
+private:
+    /// internal thread proc helper function
+    static void* ThreadProc(void* self);
+
+    pthread_t thread;
+    PosixEvent threadStartedEvent;
+    PosixEvent stopRequestEvent;   // manual-reset, so that Peek() doesn't consume the stop request
+    int volatile isRunning;
+    Priority priority;
+    SizeT stackSize;
+    Util::String name;
+    System::Cpu::CoreId coreId;
+    ThreadLocal static const char* ThreadName;
+ 
+    #if NEBULA3_DEBUG
+    static Threading::CriticalSection criticalSection;
+    static Util::List<PosixThread*> ThreadList;
+    Util::List<PosixThread*>::Iterator threadListIterator;
+    #endif
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+PosixThread::SetPriority(Priority p)
+{
+    this->priority = p;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline PosixThread::Priority
+PosixThread::GetPriority() const
+{
+    return this->priority;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+PosixThread::SetStackSize(SizeT s)
+{
+    this->stackSize = s;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+PosixThread::GetStackSize() const
+{
+    return this->stackSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+    If the derived DoWork() method is running in a loop it must regularly
+    check if the process wants the thread to terminate by calling
+    ThreadStopRequested() and simply return if the result is true. This
+    will cause the thread to shut down.
+*/
+inline bool
+PosixThread::ThreadStopRequested() const
+{
+    return this->stopRequestEvent.Peek();
+}
+
+//------------------------------------------------------------------------------
+/**
+    Set the thread's name. To obtain the current thread's name from anywhere
+    in the thread's execution context, call the static method
+    Thread::GetMyThreadName().
+*/
+inline void
+PosixThread::SetName(const Util::String& n)
+{
+    n_assert(n.IsValid());
+    this->name = n;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Get the thread's name. This is the vanilla method which
+    returns the name member. To obtain the current thread's name from anywhere
+    in the thread's execution context, call the static method
+    Thread::GetMyThreadName().
+*/
+inline const Util::String&
+PosixThread::GetName() const
+{
+    return this->name;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+PosixThread::SetCoreId(System::Cpu::CoreId id)
+{
+    this->coreId = id;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline System::Cpu::CoreId
+PosixThread::GetCoreId() const
+{
+    return this->coreId;
+}
+
+} // namespace Posix
+//------------------------------------------------------------------------------
@@ -0,0 +1,125 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Posix::PosixThreadBarrier
+    
+    Block until all thread have arrived at the barrier.
+    
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+#include "threading/criticalsection.h"
+#include "threading/posix/posixevent.h"
+
+//------------------------------------------------------------------------------
+namespace Posix
+{
+class PosixThreadBarrier
+{
+public:
+    /// constructor
+    PosixThreadBarrier();
+    /// setup the object with the number of threads
+    void Setup(SizeT numThreads);
+    /// return true if the object has been setup
+    bool IsValid() const;
+    /// enter thread barrier, return false if not all threads have arrived yet
+    bool Arrive();
+    /// call after Arrive() returns false to wait for other threads
+    void Wait();
+    /// call after Arrive() returns true to resume all threads
+    void SignalContinue();
+
+private:
+    Threading::CriticalSection critSect;
+    long numThreads;
+    volatile long outstandingThreads;
+    PosixEvent event;
+    bool isValid;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline
+PosixThreadBarrier::PosixThreadBarrier() :
+    numThreads(0),
+    outstandingThreads(0),
+    event(true),
+    isValid(false)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+PosixThreadBarrier::Setup(SizeT num)
+{
+    n_assert(!this->isValid);
+    this->numThreads = num;
+    this->outstandingThreads = num;
+    this->isValid = true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+PosixThreadBarrier::IsValid() const
+{
+    return this->isValid;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Notify arrival at thread-sync point, return false if not all threads
+    have arrived yet, and true if all threads have arrived. If the
+    method returns false, you should immediately call Wait(), if the
+    method returns true, the caller has a chance to perform some actions
+    which should happen before threads continue, and then call the
+    SignalContinue() method.
+*/
+inline bool
+PosixThreadBarrier::Arrive()
+{
+    this->critSect.Enter();
+    n_assert(this->outstandingThreads > 0);
+    this->outstandingThreads--;
+    return (0 == this->outstandingThreads);
+}
+
+//------------------------------------------------------------------------------
+/**
+    This method should be called when Arrive() returns false. It will
+    put the thread to sleep because not all threads have arrived yet.
+    When the method returns, all threads have arrived at the sync point.
+*/
+inline void
+PosixThreadBarrier::Wait()
+{
+    this->event.Reset();
+    this->critSect.Leave();
+    if (!this->event.WaitTimeout(2000))
+    {
+        n_printf("PosixThreadBarrier::Wait() timed out!\n");
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    This method should be called after Arrive() returns true. This means
+    that all threads have arrived at the sync point and execution of all
+    threads may resume.
+*/
+inline void
+PosixThreadBarrier::SignalContinue()
+{
+    this->outstandingThreads = this->numThreads;
+    this->event.Signal();
+    this->critSect.Leave();
+}
+
+} // namespace Posix
+//------------------------------------------------------------------------------
@@ -0,0 +1,19 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @type Posix::ThreadId
+ 
+    A thread id uniquely identifies a thread within the process. On Linux
+    this is the kernel thread id (gettid), which is also what shows up
+    in top, gdb and perf.
+ 
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+
+namespace Threading
+{
+typedef pid_t ThreadId;
+static const ThreadId InvalidThreadId = 0;
+}
+//------------------------------------------------------------------------------
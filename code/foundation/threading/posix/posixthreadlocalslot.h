@@ -0,0 +1,76 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Posix::PosixThreadLocalSlot
+
+    Posix implementation of Threading::ThreadLocalSlot, uses pthread keys.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+#include "threading/interlocked.h"
+#include <pthread.h>
+
+//------------------------------------------------------------------------------
+namespace Posix
+{
+class PosixThreadLocalSlot
+{
+public:
+    /// set the value of the calling thread
+    void Set(void* ptr);
+    /// get the value of the calling thread
+    void* Get() const;
+
+private:
+    /// create the pthread key (thread-safe)
+    void Setup();
+
+    int volatile slot;      // pthread key + 1, 0 until the first Set()
+};
+
+//------------------------------------------------------------------------------
+/**
+    If two threads create a key at the same time, the loser deletes
+    its key again.
+*/
+inline void
+PosixThreadLocalSlot::Setup()
+{
+    pthread_key_t key;
+    int res = pthread_key_create(&key, NULL);
+    n_assert(0 == res);
+    if (0 != Threading::Interlocked::CompareExchange(&this->slot, int(key) + 1, 0))
+    {
+        pthread_key_delete(key);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+PosixThreadLocalSlot::Set(void* ptr)
+{
+    if (0 == this->slot)
+    {
+        this->Setup();
+    }
+    pthread_setspecific(pthread_key_t(this->slot - 1), ptr);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void*
+PosixThreadLocalSlot::Get() const
+{
+    if (0 == this->slot)
+    {
+        return 0;
+    }
+    return pthread_getspecific(pthread_key_t(this->slot - 1));
+}
+
+} // namespace Posix
+//------------------------------------------------------------------------------
@@ -15,6 +15,8 @@ __ImplementClass(Threading::Thread, 'TRED', Wii::WiiThread);
 __ImplementClass(Threading::Thread, 'TRED', PS3::PS3Thread);
 #elif __OSX__
 __ImplementClass(Threading::Thread, 'TRED', OSX::OSXThread);
+#elif __LINUX__
+__ImplementClass(Threading::Thread, 'TRED', Posix::PosixThread);
 #else
 #error "Thread class not implemented on this platform!"
 #endif
@@ -44,6 +44,15 @@ class Thread : public OSX::OSXThread
     __DeclareClass(Thread);
 };
 }
+#elif __LINUX__
+#include "threading/posix/posixthread.h"
+namespace Threading
+{
+class Thread : public Posix::PosixThread
+{
+    __DeclareClass(Thread);
+};
+}
 #else
 #error "Threading::Thread not implemented on this platform!"
 #endif
@@ -29,6 +29,13 @@ namespace Threading
 class ThreadBarrier : public Wii::WiiThreadBarrier
 { };
 }
+#elif __LINUX__
+#include "threading/posix/posixthreadbarrier.h"
+namespace Threading
+{
+class ThreadBarrier : public Posix::PosixThreadBarrier
+{ };
+}
 #else
 #error "Threading::ThreadBarrier not implemented on this platform!"
 #endif
@@ -17,6 +17,8 @@
 #include "threading/ps3/ps3threadid.h"
 #elif __OSX__
 #include "threading/osx/osxthreadid.h"
+#elif __LINUX__
+#include "threading/posix/posixthreadid.h"
 #else
 #error "Threading::ThreadId not implemented on this platform!"
 #endif
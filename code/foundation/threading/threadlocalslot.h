@@ -0,0 +1,37 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Threading::ThreadLocalSlot
+
+    A pointer which has a separate value in each thread. Unlike the
+    ThreadLocal storage class, this also works in builds where
+    compiler-supported thread local storage can't be used (Maya plugins
+    and the editor, which are loaded as DLLs).
+
+    A ThreadLocalSlot has no constructor, so that it can be used as a
+    static object even before static constructors have run (for instance
+    by the memory subsystem). The system's TLS slot is allocated on the
+    first Set() and is never freed. Get() returns 0 in all threads
+    which haven't set a value yet.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/config.h"
+#if (__WIN32__ || __XBOX360__)
+#include "threading/win360/win360threadlocalslot.h"
+namespace Threading
+{
+class ThreadLocalSlot : public Win360::Win360ThreadLocalSlot
+{ };
+}
+#elif (__OSX__ || __LINUX__)
+#include "threading/posix/posixthreadlocalslot.h"
+namespace Threading
+{
+class ThreadLocalSlot : public Posix::PosixThreadLocalSlot
+{ };
+}
+#else
+#error "Threading::ThreadLocalSlot not implemented on this platform!"
+#endif
+//------------------------------------------------------------------------------
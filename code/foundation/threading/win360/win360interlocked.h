@@ -25,6 +25,8 @@ public:
     static int Exchange(int volatile* dest, int value);
     /// interlocked compare-exchange
     static int CompareExchange(int volatile* dest, int exchange, int comparand);
+    /// interlocked compare-exchange of a pointer
+    static void* CompareExchangePointer(void* volatile* dest, void* exchange, void* comparand);
 };
 
 //------------------------------------------------------------------------------
@@ -72,5 +74,14 @@ Win360Interlocked::CompareExchange(int volatile* dest, int exchange, int compara
     return _InterlockedCompareExchange((volatile LONG*)dest, exchange, comparand);
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void*
+Win360Interlocked::CompareExchangePointer(void* volatile* dest, void* exchange, void* comparand)
+{
+    return InterlockedCompareExchangePointer((PVOID volatile*)dest, exchange, comparand);
+}
+
 } // namespace Win360
 //------------------------------------------------------------------------------
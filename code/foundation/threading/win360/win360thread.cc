@@ -5,6 +5,7 @@
 #include "stdneb.h"
 #include "threading/win360/win360thread.h"
 #include "system/systeminfo.h"
+#include "memory/smallobjectallocator.h"
 #if __XBOX360__
 #include "threading/xbox360/xbox360threading.h"
 #endif
@@ -206,16 +207,23 @@ DWORD WINAPI
 Win360Thread::ThreadProc(LPVOID self)
 {
     n_assert(0 != self);
-    
-    #if NEBULA3_ENABLE_THREADLOCAL_STRINGATOM_TABLES
-    // setup thread-local string atom table (will be discarded when thread terminates)
-    LocalStringAtomTable localStringAtomTable;
-    #endif
+    {
+        #if NEBULA3_ENABLE_THREADLOCAL_STRINGATOM_TABLES
+        // setup thread-local string atom table (will be discarded when thread terminates)
+        LocalStringAtomTable localStringAtomTable;
+        #endif
+
+        Win360Thread* threadObj = (Win360Thread*) self;
+        Win360Thread::SetMyThreadName(threadObj->GetName().AsCharPtr());
+        threadObj->threadStartedEvent.Signal();
+        threadObj->DoWork();
+    }
 
-    Win360Thread* threadObj = (Win360Thread*) self;
-    Win360Thread::SetMyThreadName(threadObj->GetName().AsCharPtr());
-    threadObj->threadStartedEvent.Signal();
-    threadObj->DoWork();
+    #if NEBULA3_USE_SMALLOBJECT_ALLOCATOR
+    // return the thread's cached small memory blocks, after the
+    // thread-local string atom table has been discarded
+    Memory::SmallObjectAllocator::FlushThreadCache();
+    #endif
 
     return 0;
 }
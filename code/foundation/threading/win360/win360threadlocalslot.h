@@ -0,0 +1,75 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Win360::Win360ThreadLocalSlot
+
+    Win32/Xbox360 implementation of Threading::ThreadLocalSlot, uses
+    the TlsAlloc() family of functions.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+#include "threading/win360/win360interlocked.h"
+
+//------------------------------------------------------------------------------
+namespace Win360
+{
+class Win360ThreadLocalSlot
+{
+public:
+    /// set the value of the calling thread
+    void Set(void* ptr);
+    /// get the value of the calling thread
+    void* Get() const;
+
+private:
+    /// allocate the TLS index (thread-safe)
+    void Setup();
+
+    int volatile slot;      // TLS index + 1, 0 until the first Set()
+};
+
+//------------------------------------------------------------------------------
+/**
+    If two threads allocate an index at the same time, the loser
+    frees its index again.
+*/
+inline void
+Win360ThreadLocalSlot::Setup()
+{
+    DWORD index = TlsAlloc();
+    n_assert(TLS_OUT_OF_INDEXES != index);
+    if (0 != Win360Interlocked::CompareExchange(&this->slot, int(index + 1), 0))
+    {
+        TlsFree(index);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+Win360ThreadLocalSlot::Set(void* ptr)
+{
+    if (0 == this->slot)
+    {
+        this->Setup();
+    }
+    TlsSetValue(DWORD(this->slot - 1), ptr);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void*
+Win360ThreadLocalSlot::Get() const
+{
+    if (0 == this->slot)
+    {
+        return 0;
+    }
+    return TlsGetValue(DWORD(this->slot - 1));
+}
+
+} // namespace Win360
+//------------------------------------------------------------------------------
@@ -31,6 +31,13 @@ namespace Timing
 class CalendarTime : public PS3::PS3CalendarTime
 { };
 }
+#elif __LINUX__
+#include "timing/posix/posixcalendartime.h"
+namespace Timing
+{
+class CalendarTime : public Posix::PosixCalendarTime
+{ };
+}
 #else
 #error "Timing::CalendarTime not implemented on this platform!"
 #endif
@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+//  posixcalendartime.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "timing/calendartime.h"
+
+namespace Posix
+{
+using namespace Timing;
+using namespace Util;
+using namespace IO;
+
+//------------------------------------------------------------------------------
+/**
+*/
+CalendarTime
+PosixCalendarTime::FromPosixTime(const struct tm& t, unsigned int milliSecond)
+{
+    CalendarTime calTime;
+    calTime.year    = t.tm_year + 1900;
+    calTime.month   = (Month) (t.tm_mon + 1);
+    calTime.weekday = (Weekday) t.tm_wday;
+    calTime.day     = t.tm_mday;
+    calTime.hour    = t.tm_hour;
+    calTime.minute  = t.tm_min;
+    calTime.second  = t.tm_sec;
+    calTime.milliSecond = milliSecond;
+    return calTime;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+struct tm
+PosixCalendarTime::ToPosixTime(const CalendarTime& calTime)
+{
+    struct tm t;
+    Memory::Clear(&t, sizeof(t));
+    t.tm_year  = calTime.year - 1900;
+    t.tm_mon   = calTime.month - 1;
+    t.tm_wday  = calTime.weekday;
+    t.tm_mday  = calTime.day;
+    t.tm_hour  = calTime.hour;
+    t.tm_min   = calTime.minute;
+    t.tm_sec   = calTime.second;
+    t.tm_isdst = -1;
+    return t;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Obtains the current system time. This does not depend on the current
+    time zone.
+*/
+CalendarTime
+PosixCalendarTime::GetSystemTime()
+{
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    struct tm t;
+    gmtime_r(&tv.tv_sec, &t);
+    return FromPosixTime(t, tv.tv_usec / 1000);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Obtains the current local time (with time-zone adjustment).
+*/
+CalendarTime
+PosixCalendarTime::GetLocalTime()
+{
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    struct tm t;
+    localtime_r(&tv.tv_sec, &t);
+    return FromPosixTime(t, tv.tv_usec / 1000);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+FileTime
+PosixCalendarTime::SystemTimeToFileTime(const CalendarTime& systemTime)
+{
+    struct tm t = ToPosixTime(systemTime);
+    FileTime fileTime;
+    fileTime.fileTime = timegm(&t);
+    return fileTime;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+CalendarTime
+PosixCalendarTime::FileTimeToSystemTime(const FileTime& fileTime)
+{
+    struct tm t;
+    gmtime_r(&fileTime.fileTime, &t);
+    return FromPosixTime(t, 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+FileTime
+PosixCalendarTime::LocalTimeToFileTime(const CalendarTime& localTime)
+{
+    struct tm t = ToPosixTime(localTime);
+    FileTime fileTime;
+    fileTime.fileTime = mktime(&t);
+    return fileTime;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+CalendarTime
+PosixCalendarTime::FileTimeToLocalTime(const FileTime& fileTime)
+{
+    struct tm t;
+    localtime_r(&fileTime.fileTime, &t);
+    return FromPosixTime(t, 0);
+}
+
+} // namespace Posix
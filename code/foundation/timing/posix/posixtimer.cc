@@ -0,0 +1,135 @@
+//------------------------------------------------------------------------------
+//  posixtimer.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "timing/posix/posixtimer.h"
+
+namespace Posix
+{
+
+//------------------------------------------------------------------------------
+/**
+*/
+PosixTimer::PosixTimer() :
+    running(false),
+    diffTime(0),
+    stopTime(0)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+long long
+PosixTimer::RealTime()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((long long)ts.tv_sec * 1000000000LL) + ts.tv_nsec;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Start the timer. This will update the diffTime member to reflect
+    the accumulated time when the timer was not running (basically the
+    difference between this timer's time and the real system time).
+*/
+void
+PosixTimer::Start()
+{
+    n_assert(!this->running);
+    
+    // query the current real time and update the diffTime member
+    // to take the "lost" time into account since the timer was stopped
+    long long curRealTime = RealTime();
+    this->diffTime += curRealTime - this->stopTime;
+    this->stopTime = 0;
+    this->running = true;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Stop the timer. This will record the current realtime, so that
+    the next Start() can measure the time lost between Stop() and Start()
+    which must be taken into account to keep track of the difference between
+    this timer's time and realtime.
+*/
+void
+PosixTimer::Stop()
+{
+    n_assert(this->running);
+    this->stopTime = RealTime();
+    this->running = false;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Reset the timer so that will start counting at zero again.
+*/
+void
+PosixTimer::Reset()
+{
+    bool wasRunning = this->running;
+    if (wasRunning)
+    {
+        this->Stop();
+    }
+    this->stopTime = 0;
+    this->diffTime = 0;
+    if (wasRunning)
+    {
+        this->Start();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns true if the timer is currently running.
+*/
+bool
+PosixTimer::Running() const
+{
+    return this->running;
+}
+
+//------------------------------------------------------------------------------
+/**
+    This returns the internal local time in nanoseconds.
+*/
+long long
+PosixTimer::InternalTime() const
+{
+    // get the current real time, or the time at last stop
+    long long time = this->running ? RealTime() : this->stopTime;
+ 
+    // convert to local time
+    time -= this->diffTime;
+    return time;
+}
+
+//------------------------------------------------------------------------------
+/**
+    This returns the timer's current time in seconds.
+*/
+Timing::Time
+PosixTimer::GetTime() const
+{
+    long long time = this->InternalTime();
+    return ((Timing::Time)time) / 1000000000.0;
+}
+
+//------------------------------------------------------------------------------
+/**
+    This returns the timer's current time in "ticks". A tick is defined
+    as one millisecond (1/1000 seconds).
+*/
+Timing::Tick
+PosixTimer::GetTicks() const
+{
+    long long time = this->InternalTime();
+    return (Timing::Tick) (time / 1000000LL);
+}
+
+} // namespace Posix
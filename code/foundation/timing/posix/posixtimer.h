@@ -0,0 +1,48 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Posix::PosixTimer
+    
+    POSIX implementation of the Time::Timer class. Uses 
+    clock_gettime() with the monotonic clock, which is consistent 
+    across cores and not affected by changes of the wall clock time.
+    
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+#include "timing/time.h"
+
+//------------------------------------------------------------------------------
+namespace Posix
+{
+class PosixTimer
+{
+public:
+    /// constructor
+    PosixTimer();
+    /// start/continue the timer
+    void Start();
+    /// stop the timer
+    void Stop();
+    /// reset the timer
+    void Reset();
+    /// return true if currently running
+    bool Running() const;
+    /// get current time in seconds
+    Timing::Time GetTime() const;
+    /// get current time in ticks
+    Timing::Tick GetTicks() const;
+
+private:
+    /// return current real time in nanoseconds
+    static long long RealTime();
+    /// return internal time in nanoseconds
+    long long InternalTime() const;
+
+    bool running;
+    long long diffTime;  // accumulated time when the timer was not running
+    long long stopTime;  // when was the timer last stopped?
+};
+
+} // namespace Posix
+//------------------------------------------------------------------------------
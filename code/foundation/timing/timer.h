@@ -30,6 +30,13 @@ namespace Timing
 class Timer : public PS3::PS3Timer
 { };
 }
+#elif __LINUX__
+#include "timing/posix/posixtimer.h"
+namespace Timing
+{
+class Timer : public Posix::PosixTimer
+{ };
+}
 #else
 #error "Timing::Timer not implemented on this platform!"
 #endif
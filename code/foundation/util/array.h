@@ -27,14 +27,30 @@
     element shuffling in some situations (especially when sorting and erasing
     elements).
 
+    The optional ALLOCATOR template argument defines how the element
+    buffer is allocated (see util/arrayallocator.h). The default is
+    ArrayHeapAllocator, ArrayFrameAllocator places the elements in the
+    thread's Memory::FrameArena, which is useful for temporary arrays
+    which are built every frame, ArrayInlineAllocator keeps a small
+    number of elements inside the array object.
+
+    The element type's Core::TypeTraits decide how elements are copied
+    and moved. Trivial types (int, float4, pointers...) are copied with
+    memcpy and are never constructed or destroyed. Relocatable types
+    (Ptr<>, String...) are moved with memcpy when the array grows and
+    when elements are inserted or erased, so that no copy constructors,
+    assignment operators or destructors are called for them.
+
     (C) 2006 RadonLabs GmbH
 */
 #include "core/types.h"
+#include "util/arrayallocator.h"
+#include <new>
 
 //------------------------------------------------------------------------------
 namespace Util
 {
-template<class TYPE> class Array
+template<class TYPE, class ALLOCATOR = ArrayHeapAllocator> class Array : private ALLOCATOR
 {
 public:
     /// define iterator
@@ -47,25 +63,25 @@ public:
     /// constructor with initial size, grow size and initial values
     Array(SizeT initialSize, SizeT initialGrow, const TYPE& initialValue);
     /// copy constructor
-    Array(const Array<TYPE>& rhs);
+    Array(const Array<TYPE, ALLOCATOR>& rhs);
     /// destructor
     ~Array();
 
     /// assignment operator
-    void operator=(const Array<TYPE>& rhs);
+    void operator=(const Array<TYPE, ALLOCATOR>& rhs);
     /// [] operator
     TYPE& operator[](IndexT index) const;
     /// equality operator
-    bool operator==(const Array<TYPE>& rhs) const;
+    bool operator==(const Array<TYPE, ALLOCATOR>& rhs) const;
     /// inequality operator
-    bool operator!=(const Array<TYPE>& rhs) const;
+    bool operator!=(const Array<TYPE, ALLOCATOR>& rhs) const;
     /// convert to "anything"
     template<typename T> T As() const;
 
     /// append element to end of array
     void Append(const TYPE& elm);
     /// append the contents of an array to this array
-    void AppendArray(const Array<TYPE>& rhs);
+    void AppendArray(const Array<TYPE, ALLOCATOR>& rhs);
     /// increase capacity to fit N more elements into the array
     void Reserve(SizeT num);
     /// get number of elements in array
@@ -111,17 +127,25 @@ public:
     /// clear contents and preallocate with new attributes
     void Realloc(SizeT capacity, SizeT grow);
     /// returns new array with elements which are not in rhs (slow!)
-    Array<TYPE> Difference(const Array<TYPE>& rhs);
+    Array<TYPE, ALLOCATOR> Difference(const Array<TYPE, ALLOCATOR>& rhs);
     /// sort the array
     void Sort();
     /// do a binary search, requires a sorted array
     IndexT BinarySearchIndex(const TYPE& elm) const;
 
 private:
+    /// allocate and construct a new element buffer
+    TYPE* AllocElements(SizeT num);
+    /// destroy and free an element buffer
+    void FreeElements(TYPE* ptr, SizeT num);
+    /// default-construct a range of elements
+    void ConstructRange(TYPE* ptr, SizeT num);
+    /// destroy a range of elements
+    void DestroyRange(TYPE* ptr, SizeT num);
     /// destroy an element (call destructor without freeing memory)
     void Destroy(TYPE* elm);
     /// copy content
-    void Copy(const Array<TYPE>& src);
+    void Copy(const Array<TYPE, ALLOCATOR>& src);
     /// delete content
     void Delete();
     /// grow array
@@ -142,8 +166,8 @@ private:
 //------------------------------------------------------------------------------
 /**
 */
-template<class TYPE>
-Array<TYPE>::Array() :
+template<class TYPE, class ALLOCATOR>
+Array<TYPE, ALLOCATOR>::Array() :
     grow(8),
     capacity(0),
     size(0),
@@ -155,8 +179,8 @@ Array<TYPE>::Array() :
 //------------------------------------------------------------------------------
 /**
 */
-template<class TYPE>
-Array<TYPE>::Array(SizeT _capacity, SizeT _grow) :
+template<class TYPE, class ALLOCATOR>
+Array<TYPE, ALLOCATOR>::Array(SizeT _capacity, SizeT _grow) :
     grow(_grow),
     capacity(_capacity),
     size(0)
@@ -167,7 +191,7 @@ Array<TYPE>::Array(SizeT _capacity, SizeT _grow) :
     }
     if (this->capacity > 0)
     {
-        this->elements = n_new_array(TYPE, this->capacity);
+        this->elements = this->AllocElements(this->capacity);
     }
     else
     {
@@ -178,8 +202,8 @@ Array<TYPE>::Array(SizeT _capacity, SizeT _grow) :
 //------------------------------------------------------------------------------
 /**
 */
-template<class TYPE>
-Array<TYPE>::Array(SizeT initialSize, SizeT _grow, const TYPE& initialValue) :
+template<class TYPE, class ALLOCATOR>
+Array<TYPE, ALLOCATOR>::Array(SizeT initialSize, SizeT _grow, const TYPE& initialValue) :
     grow(_grow),
     capacity(initialSize),
     size(initialSize)
@@ -190,7 +214,7 @@ Array<TYPE>::Array(SizeT initialSize, SizeT _grow, const TYPE& initialValue) :
     }
     if (initialSize > 0)
     {
-        this->elements = n_new_array(TYPE, this->capacity);
+        this->elements = this->AllocElements(this->capacity);
         IndexT i;
         for (i = 0; i < initialSize; i++)
         {
@@ -206,8 +230,8 @@ Array<TYPE>::Array(SizeT initialSize, SizeT _grow, const TYPE& initialValue) :
 //------------------------------------------------------------------------------
 /**
 */
-template<class TYPE> void
-Array<TYPE>::Copy(const Array<TYPE>& src)
+template<class TYPE, class ALLOCATOR> void
+Array<TYPE, ALLOCATOR>::Copy(const Array<TYPE, ALLOCATOR>& src)
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(0 == this->elements);
@@ -218,11 +242,18 @@ Array<TYPE>::Copy(const Array<TYPE>& src)
     this->size = src.size;
     if (this->capacity > 0)
     {
-        this->elements = n_new_array(TYPE, this->capacity);
-        IndexT i;
-        for (i = 0; i < this->size; i++)
+        this->elements = this->AllocElements(this->capacity);
+        if (Core::TypeTraits<TYPE>::IsTrivial)
+        {
+            Memory::Copy(src.elements, this->elements, this->size * sizeof(TYPE));
+        }
+        else
         {
-            this->elements[i] = src.elements[i];
+            IndexT i;
+            for (i = 0; i < this->size; i++)
+            {
+                this->elements[i] = src.elements[i];
+            }
         }
     }
 }
@@ -230,24 +261,79 @@ Array<TYPE>::Copy(const Array<TYPE>& src)
 //------------------------------------------------------------------------------
 /**
 */
-template<class TYPE> void
-Array<TYPE>::Delete()
+template<class TYPE, class ALLOCATOR> void
+Array<TYPE, ALLOCATOR>::Delete()
 {
+    if (this->elements)
+    {
+        this->FreeElements(this->elements, this->capacity);
+        this->elements = 0;
+    }
     this->grow = 0;
     this->capacity = 0;
     this->size = 0;
-    if (this->elements)
+}
+
+//------------------------------------------------------------------------------
+/**
+    Allocates the buffer with the allocator policy, and default-constructs
+    all elements (unless the element type is trivial).
+*/
+template<class TYPE, class ALLOCATOR> TYPE*
+Array<TYPE, ALLOCATOR>::AllocElements(SizeT num)
+{
+    TYPE* ptr = (TYPE*) ALLOCATOR::Alloc(num * sizeof(TYPE));
+    this->ConstructRange(ptr, num);
+    return ptr;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class TYPE, class ALLOCATOR> void
+Array<TYPE, ALLOCATOR>::FreeElements(TYPE* ptr, SizeT num)
+{
+    this->DestroyRange(ptr, num);
+    ALLOCATOR::Free(ptr);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class TYPE, class ALLOCATOR> void
+Array<TYPE, ALLOCATOR>::ConstructRange(TYPE* ptr, SizeT num)
+{
+    if (!Core::TypeTraits<TYPE>::IsTrivial)
     {
-        n_delete_array(this->elements);
-        this->elements = 0;
+        IndexT i;
+        for (i = 0; i < num; i++)
+        {
+            ::new(&(ptr[i])) TYPE;
+        }
     }
 }
 
 //------------------------------------------------------------------------------
 /**
 */
-template<class TYPE> void
-Array<TYPE>::Destroy(TYPE* elm)
+template<class TYPE, class ALLOCATOR> void
+Array<TYPE, ALLOCATOR>::DestroyRange(TYPE* ptr, SizeT num)
+{
+    if (!Core::TypeTraits<TYPE>::IsTrivial)
+    {
+        IndexT i;
+        for (i = 0; i < num; i++)
+        {
+            this->Destroy(&(ptr[i]));
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class TYPE, class ALLOCATOR> void
+Array<TYPE, ALLOCATOR>::Destroy(TYPE* elm)
 {
     elm->~TYPE();
 }
@@ -255,8 +341,8 @@ Array<TYPE>::Destroy(TYPE* elm)
 //------------------------------------------------------------------------------
 /**
 */
-template<class TYPE>
-Array<TYPE>::Array(const Array<TYPE>& rhs) :
+template<class TYPE, class ALLOCATOR>
+Array<TYPE, ALLOCATOR>::Array(const Array<TYPE, ALLOCATOR>& rhs) :
     grow(0),
     capacity(0),
     size(0),
@@ -268,8 +354,8 @@ Array<TYPE>::Array(const Array<TYPE>& rhs) :
 //------------------------------------------------------------------------------
 /**
 */
-template<class TYPE>
-Array<TYPE>::~Array()
+template<class TYPE, class ALLOCATOR>
+Array<TYPE, ALLOCATOR>::~Array()
 {
     this->Delete();
 }
@@ -277,8 +363,8 @@ Array<TYPE>::~Array()
 //------------------------------------------------------------------------------
 /**
 */
-template<class TYPE> void
-Array<TYPE>::Realloc(SizeT _capacity, SizeT _grow)
+template<class TYPE, class ALLOCATOR> void
+Array<TYPE, ALLOCATOR>::Realloc(SizeT _capacity, SizeT _grow)
 {
     this->Delete();
     this->grow = _grow;
@@ -286,7 +372,7 @@ Array<TYPE>::Realloc(SizeT _capacity, SizeT _grow)
     this->size = 0;
     if (this->capacity > 0)
     {
-        this->elements = n_new_array(TYPE, this->capacity);
+        this->elements = this->AllocElements(this->capacity);
     }
     else
     {
@@ -297,8 +383,8 @@ Array<TYPE>::Realloc(SizeT _capacity, SizeT _grow)
 //------------------------------------------------------------------------------
 /**
 */
-template<class TYPE> void 
-Array<TYPE>::operator=(const Array<TYPE>& rhs)
+template<class TYPE, class ALLOCATOR> void 
+Array<TYPE, ALLOCATOR>::operator=(const Array<TYPE, ALLOCATOR>& rhs)
 {
     if (this != &rhs)
     {
@@ -307,9 +393,17 @@ Array<TYPE>::operator=(const Array<TYPE>& rhs)
             // source array fits into our capacity, copy in place
             n_assert(0 != this->elements);
             IndexT i;
-            for (i = 0; i < rhs.size; i++)
+            if (Core::TypeTraits<TYPE>::IsTrivial)
+            {
+                Memory::Copy(rhs.elements, this->elements, rhs.size * sizeof(TYPE));
+                i = rhs.size;
+            }
+            else
             {
-                this->elements[i] = rhs.elements[i];
+                for (i = 0; i < rhs.size; i++)
+                {
+                    this->elements[i] = rhs.elements[i];
+                }
             }
 
             // properly destroy remaining original elements
@@ -331,22 +425,40 @@ Array<TYPE>::operator=(const Array<TYPE>& rhs)
 
 //------------------------------------------------------------------------------
 /**
+    Relocatable elements are moved into the new buffer with a memcpy,
+    the old buffer is then freed without calling their destructors.
 */
-template<class TYPE> void
-Array<TYPE>::GrowTo(SizeT newCapacity)
+template<class TYPE, class ALLOCATOR> void
+Array<TYPE, ALLOCATOR>::GrowTo(SizeT newCapacity)
 {
-    TYPE* newArray = n_new_array(TYPE, newCapacity);
-    if (this->elements)
+    TYPE* newArray;
+    if (Core::TypeTraits<TYPE>::IsRelocatable)
     {
-        // copy over contents
-        IndexT i;
-        for (i = 0; i < this->size; i++)
+        newArray = (TYPE*) ALLOCATOR::Alloc(newCapacity * sizeof(TYPE));
+        if (this->elements)
         {
-            newArray[i] = this->elements[i];
+            // move over contents, only the unused old elements must be destroyed
+            Memory::Copy(this->elements, newArray, this->size * sizeof(TYPE));
+            this->DestroyRange(this->elements + this->size, this->capacity - this->size);
+            ALLOCATOR::Free(this->elements);
         }
+        this->ConstructRange(newArray + this->size, newCapacity - this->size);
+    }
+    else
+    {
+        newArray = this->AllocElements(newCapacity);
+        if (this->elements)
+        {
+            // copy over contents
+            IndexT i;
+            for (i = 0; i < this->size; i++)
+            {
+                newArray[i] = this->elements[i];
+            }
 
-        // discard old array and update contents
-        n_delete_array(this->elements);
+            // discard old array and update contents
+            this->FreeElements(this->elements, this->capacity);
+        }
     }
     this->elements  = newArray;
     this->capacity = newCapacity;
@@ -355,8 +467,8 @@ Array<TYPE>::GrowTo(SizeT newCapacity)
 //------------------------------------------------------------------------------
 /**
 */
-template<class TYPE> void
-Array<TYPE>::Grow()
+template<class TYPE, class ALLOCATOR> void
+Array<TYPE, ALLOCATOR>::Grow()
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(this->grow > 0);
@@ -389,8 +501,8 @@ Array<TYPE>::Grow()
     30-Jan-03   floh    serious bugfixes!
 	07-Dec-04	jo		bugfix: neededSize >= this->capacity => neededSize > capacity	
 */
-template<class TYPE> void
-Array<TYPE>::Move(IndexT fromIndex, IndexT toIndex)
+template<class TYPE, class ALLOCATOR> void
+Array<TYPE, ALLOCATOR>::Move(IndexT fromIndex, IndexT toIndex)
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(this->elements);
@@ -413,7 +525,27 @@ Array<TYPE>::Move(IndexT fromIndex, IndexT toIndex)
         this->Grow();
     }
 
-    if (fromIndex > toIndex)
+    if (Core::TypeTraits<TYPE>::IsRelocatable)
+    {
+        // destroy the elements which are overwritten, move the elements
+        // with a memmove, and re-construct the vacated elements
+        SizeT distance;
+        if (fromIndex > toIndex)
+        {
+            distance = fromIndex - toIndex;
+            this->DestroyRange(this->elements + toIndex, distance);
+            Memory::Move(this->elements + fromIndex, this->elements + toIndex, num * sizeof(TYPE));
+            this->ConstructRange(this->elements + toIndex + num, distance);
+        }
+        else
+        {
+            distance = toIndex - fromIndex;
+            this->DestroyRange(this->elements + this->size, distance);
+            Memory::Move(this->elements + fromIndex, this->elements + toIndex, num * sizeof(TYPE));
+            this->ConstructRange(this->elements + fromIndex, distance);
+        }
+    }
+    else if (fromIndex > toIndex)
     {
         // this is a backward move
         IndexT i;
@@ -451,8 +583,8 @@ Array<TYPE>::Move(IndexT fromIndex, IndexT toIndex)
 //------------------------------------------------------------------------------
 /**
 */
-template<class TYPE> void
-Array<TYPE>::Append(const TYPE& elm)
+template<class TYPE, class ALLOCATOR> void
+Array<TYPE, ALLOCATOR>::Append(const TYPE& elm)
 {
     // grow allocated space if exhausted
     if (this->size == this->capacity)
@@ -468,8 +600,8 @@ Array<TYPE>::Append(const TYPE& elm)
 //------------------------------------------------------------------------------
 /**
 */
-template<class TYPE> void
-Array<TYPE>::AppendArray(const Array<TYPE>& rhs)
+template<class TYPE, class ALLOCATOR> void
+Array<TYPE, ALLOCATOR>::AppendArray(const Array<TYPE, ALLOCATOR>& rhs)
 {
     IndexT i;
     SizeT num = rhs.Size();
@@ -489,8 +621,8 @@ Array<TYPE>::AppendArray(const Array<TYPE>& rhs)
     NOTE: the functionality of this method has been changed as of 26-Apr-08,
     it will now only change the capacity of the array, not its size.
 */
-template<class TYPE> void
-Array<TYPE>::Reserve(SizeT num)
+template<class TYPE, class ALLOCATOR> void
+Array<TYPE, ALLOCATOR>::Reserve(SizeT num)
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(num > 0);
@@ -505,8 +637,8 @@ Array<TYPE>::Reserve(SizeT num)
 //------------------------------------------------------------------------------
 /**
 */
-template<class TYPE> SizeT
-Array<TYPE>::Size() const
+template<class TYPE, class ALLOCATOR> SizeT
+Array<TYPE, ALLOCATOR>::Size() const
 {
     return this->size;
 }
@@ -514,8 +646,8 @@ Array<TYPE>::Size() const
 //------------------------------------------------------------------------------
 /**
 */
-template<class TYPE> SizeT
-Array<TYPE>::Capacity() const
+template<class TYPE, class ALLOCATOR> SizeT
+Array<TYPE, ALLOCATOR>::Capacity() const
 {
     return this->capacity;
 }
@@ -525,8 +657,8 @@ Array<TYPE>::Capacity() const
     Access an element. This method will NOT grow the array, and instead do
     a range check, which may throw an assertion.
 */
-template<class TYPE> TYPE&
-Array<TYPE>::operator[](IndexT index) const
+template<class TYPE, class ALLOCATOR> TYPE&
+Array<TYPE, ALLOCATOR>::operator[](IndexT index) const
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(this->elements && (index < this->size));
@@ -539,8 +671,8 @@ Array<TYPE>::operator[](IndexT index) const
     The equality operator returns true if all elements are identical. The
     TYPE class must support the equality operator.
 */
-template<class TYPE> bool
-Array<TYPE>::operator==(const Array<TYPE>& rhs) const
+template<class TYPE, class ALLOCATOR> bool
+Array<TYPE, ALLOCATOR>::operator==(const Array<TYPE, ALLOCATOR>& rhs) const
 {
     if (rhs.Size() == this->Size())
     {
@@ -566,8 +698,8 @@ Array<TYPE>::operator==(const Array<TYPE>& rhs) const
     The inequality operator returns true if at least one element in the 
     array is different, or the array sizes are different.
 */
-template<class TYPE> bool
-Array<TYPE>::operator!=(const Array<TYPE>& rhs) const
+template<class TYPE, class ALLOCATOR> bool
+Array<TYPE, ALLOCATOR>::operator!=(const Array<TYPE, ALLOCATOR>& rhs) const
 {
     return !(*this == rhs);
 }
@@ -575,8 +707,8 @@ Array<TYPE>::operator!=(const Array<TYPE>& rhs) const
 //------------------------------------------------------------------------------
 /**
 */
-template<class TYPE> TYPE&
-Array<TYPE>::Front() const
+template<class TYPE, class ALLOCATOR> TYPE&
+Array<TYPE, ALLOCATOR>::Front() const
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(this->elements && (this->size > 0));
@@ -587,8 +719,8 @@ Array<TYPE>::Front() const
 //------------------------------------------------------------------------------
 /**
 */
-template<class TYPE> TYPE&
-Array<TYPE>::Back() const
+template<class TYPE, class ALLOCATOR> TYPE&
+Array<TYPE, ALLOCATOR>::Back() const
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(this->elements && (this->size > 0));
@@ -599,8 +731,8 @@ Array<TYPE>::Back() const
 //------------------------------------------------------------------------------
 /**
 */
-template<class TYPE> bool 
-Array<TYPE>::IsEmpty() const
+template<class TYPE, class ALLOCATOR> bool 
+Array<TYPE, ALLOCATOR>::IsEmpty() const
 {
     return (this->size == 0);
 }
@@ -608,8 +740,8 @@ Array<TYPE>::IsEmpty() const
 //------------------------------------------------------------------------------
 /**
 */
-template<class TYPE> void
-Array<TYPE>::EraseIndex(IndexT index)
+template<class TYPE, class ALLOCATOR> void
+Array<TYPE, ALLOCATOR>::EraseIndex(IndexT index)
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(this->elements && (index < this->size));
@@ -630,8 +762,8 @@ Array<TYPE>::EraseIndex(IndexT index)
 /**    
     NOTE: this method is fast but destroys the sorting order!
 */
-template<class TYPE> void
-Array<TYPE>::EraseIndexSwap(IndexT index)
+template<class TYPE, class ALLOCATOR> void
+Array<TYPE, ALLOCATOR>::EraseIndexSwap(IndexT index)
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(this->elements && (index < this->size));
@@ -650,8 +782,8 @@ Array<TYPE>::EraseIndexSwap(IndexT index)
 //------------------------------------------------------------------------------
 /**
 */
-template<class TYPE> typename Array<TYPE>::Iterator
-Array<TYPE>::Erase(typename Array<TYPE>::Iterator iter)
+template<class TYPE, class ALLOCATOR> typename Array<TYPE, ALLOCATOR>::Iterator
+Array<TYPE, ALLOCATOR>::Erase(typename Array<TYPE, ALLOCATOR>::Iterator iter)
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(this->elements && (iter >= this->elements) && (iter < (this->elements + this->size)));
@@ -664,8 +796,8 @@ Array<TYPE>::Erase(typename Array<TYPE>::Iterator iter)
 /**
     NOTE: this method is fast but destroys the sorting order!
 */
-template<class TYPE> typename Array<TYPE>::Iterator
-Array<TYPE>::EraseSwap(typename Array<TYPE>::Iterator iter)
+template<class TYPE, class ALLOCATOR> typename Array<TYPE, ALLOCATOR>::Iterator
+Array<TYPE, ALLOCATOR>::EraseSwap(typename Array<TYPE, ALLOCATOR>::Iterator iter)
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(this->elements && (iter >= this->elements) && (iter < (this->elements + this->size)));
@@ -677,8 +809,8 @@ Array<TYPE>::EraseSwap(typename Array<TYPE>::Iterator iter)
 //------------------------------------------------------------------------------
 /**
 */
-template<class TYPE> void
-Array<TYPE>::Insert(IndexT index, const TYPE& elm)
+template<class TYPE, class ALLOCATOR> void
+Array<TYPE, ALLOCATOR>::Insert(IndexT index, const TYPE& elm)
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(index <= this->size);
@@ -700,8 +832,8 @@ Array<TYPE>::Insert(IndexT index, const TYPE& elm)
     The current implementation of this method does not shrink the 
     preallocated space. It simply sets the array size to 0.
 */
-template<class TYPE> void
-Array<TYPE>::Clear()
+template<class TYPE, class ALLOCATOR> void
+Array<TYPE, ALLOCATOR>::Clear()
 {
     IndexT i;
     for (i = 0; i < this->size; i++)
@@ -716,8 +848,8 @@ Array<TYPE>::Clear()
     This is identical with Clear(), but does NOT call destructors (it just
     resets the size member. USE WITH CARE!
 */
-template<class TYPE> void
-Array<TYPE>::Reset()
+template<class TYPE, class ALLOCATOR> void
+Array<TYPE, ALLOCATOR>::Reset()
 {
     this->size = 0;
 }
@@ -725,8 +857,8 @@ Array<TYPE>::Reset()
 //------------------------------------------------------------------------------
 /**
 */
-template<class TYPE> typename Array<TYPE>::Iterator
-Array<TYPE>::Begin() const
+template<class TYPE, class ALLOCATOR> typename Array<TYPE, ALLOCATOR>::Iterator
+Array<TYPE, ALLOCATOR>::Begin() const
 {
     return this->elements;
 }
@@ -734,8 +866,8 @@ Array<TYPE>::Begin() const
 //------------------------------------------------------------------------------
 /**
 */
-template<class TYPE> typename Array<TYPE>::Iterator
-Array<TYPE>::End() const
+template<class TYPE, class ALLOCATOR> typename Array<TYPE, ALLOCATOR>::Iterator
+Array<TYPE, ALLOCATOR>::End() const
 {
     return this->elements + this->size;
 }
@@ -748,8 +880,8 @@ Array<TYPE>::End() const
     @param  elm     element to find
     @return         element iterator, or 0 if not found
 */
-template<class TYPE> typename Array<TYPE>::Iterator
-Array<TYPE>::Find(const TYPE& elm) const
+template<class TYPE, class ALLOCATOR> typename Array<TYPE, ALLOCATOR>::Iterator
+Array<TYPE, ALLOCATOR>::Find(const TYPE& elm) const
 {
     IndexT index;
     for (index = 0; index < this->size; index++)
@@ -770,8 +902,8 @@ Array<TYPE>::Find(const TYPE& elm) const
     @param  elm     element to find
     @return         index to element, or InvalidIndex if not found
 */
-template<class TYPE> IndexT
-Array<TYPE>::FindIndex(const TYPE& elm) const
+template<class TYPE, class ALLOCATOR> IndexT
+Array<TYPE, ALLOCATOR>::FindIndex(const TYPE& elm) const
 {
     IndexT index;
     for (index = 0; index < this->size; index++)
@@ -793,8 +925,8 @@ Array<TYPE>::FindIndex(const TYPE& elm) const
     @param  num     num elements to fill
     @param  elm     fill value
 */
-template<class TYPE> void
-Array<TYPE>::Fill(IndexT first, SizeT num, const TYPE& elm)
+template<class TYPE, class ALLOCATOR> void
+Array<TYPE, ALLOCATOR>::Fill(IndexT first, SizeT num, const TYPE& elm)
 {
     if ((first + num) > this->size)
     {
@@ -814,10 +946,10 @@ Array<TYPE>::Fill(IndexT first, SizeT num, const TYPE& elm)
 
     @todo this method is broken, check test case to see why!
 */
-template<class TYPE> Array<TYPE>
-Array<TYPE>::Difference(const Array<TYPE>& rhs)
+template<class TYPE, class ALLOCATOR> Array<TYPE, ALLOCATOR>
+Array<TYPE, ALLOCATOR>::Difference(const Array<TYPE, ALLOCATOR>& rhs)
 {
-    Array<TYPE> diff;
+    Array<TYPE, ALLOCATOR> diff;
     IndexT i;
     SizeT num = rhs.Size();
     for (i = 0; i < num; i++)
@@ -834,8 +966,8 @@ Array<TYPE>::Difference(const Array<TYPE>& rhs)
 /**
     Sorts the array. This just calls the STL sort algorithm.
 */
-template<class TYPE> void
-Array<TYPE>::Sort()
+template<class TYPE, class ALLOCATOR> void
+Array<TYPE, ALLOCATOR>::Sort()
 {
     std::sort(this->Begin(), this->End());
 }
@@ -845,8 +977,8 @@ Array<TYPE>::Sort()
     Does a binary search on the array, returns the index of the identical
     element, or InvalidIndex if not found
 */
-template<class TYPE> IndexT
-Array<TYPE>::BinarySearchIndex(const TYPE& elm) const
+template<class TYPE, class ALLOCATOR> IndexT
+Array<TYPE, ALLOCATOR>::BinarySearchIndex(const TYPE& elm) const
 {
     SizeT num = this->Size();
     if (num > 0)
@@ -900,8 +1032,8 @@ Array<TYPE>::BinarySearchIndex(const TYPE& elm) const
     This tests, whether the array is sorted. This is a slow operation
     O(n).
 */
-template<class TYPE> bool
-Array<TYPE>::IsSorted() const
+template<class TYPE, class ALLOCATOR> bool
+Array<TYPE, ALLOCATOR>::IsSorted() const
 {
     if (this->size > 1)
     {
@@ -923,8 +1055,8 @@ Array<TYPE>::IsSorted() const
     starting at a given index. Performance is O(n). Returns the index
     at which the element was added.
 */
-template<class TYPE> IndexT
-Array<TYPE>::InsertAtEndOfIdenticalRange(IndexT startIndex, const TYPE& elm)
+template<class TYPE, class ALLOCATOR> IndexT
+Array<TYPE, ALLOCATOR>::InsertAtEndOfIdenticalRange(IndexT startIndex, const TYPE& elm)
 {
     IndexT i = startIndex + 1;
     for (; i < this->size; i++)
@@ -946,8 +1078,8 @@ Array<TYPE>::InsertAtEndOfIdenticalRange(IndexT startIndex, const TYPE& elm)
     This inserts the element into a sorted array. Returns the index
     at which the element was inserted.
 */
-template<class TYPE> IndexT
-Array<TYPE>::InsertSorted(const TYPE& elm)
+template<class TYPE, class ALLOCATOR> IndexT
+Array<TYPE, ALLOCATOR>::InsertSorted(const TYPE& elm)
 {
     SizeT num = this->Size();
     if (num == 0)
@@ -1032,5 +1164,27 @@ Array<TYPE>::InsertSorted(const TYPE& elm)
     return InvalidIndex;
 }
 
+} // namespace Util
+
+//------------------------------------------------------------------------------
+namespace Core
+{
+template<class TYPE> struct TypeTraits<Util::Array<TYPE, Util::ArrayHeapAllocator> >
+{
+    enum
+    {
+        IsTrivial = false,
+        IsRelocatable = true
+    };
+};
+
+template<class TYPE> struct TypeTraits<Util::Array<TYPE, Util::ArrayFrameAllocator> >
+{
+    enum
+    {
+        IsTrivial = false,
+        IsRelocatable = true
+    };
+};
 } // namespace Core
 //------------------------------------------------------------------------------
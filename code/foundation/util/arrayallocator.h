@@ -0,0 +1,188 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @file util/arrayallocator.h
+
+    Allocator policies for the element buffer of Util::Array (and the
+    containers which are built on top of Util::Array). An allocator
+    policy only provides raw memory, construction and destruction of the
+    elements is handled by the Array:
+
+    void* Alloc(size_t size)    - allocate memory for the element buffer
+    void Free(void* ptr)        - free an element buffer
+
+    ArrayHeapAllocator is the default and uses the ObjectArrayHeap.
+
+    ArrayFrameAllocator allocates from the calling thread's
+    Memory::FrameArena, and falls back to the heap if the thread has no
+    arena or the arena is exhausted. Freeing frame memory does nothing.
+    An array with the ArrayFrameAllocator must only be used by the thread
+    which created it, and must not live longer than the arena's buffers.
+
+    ArrayInlineAllocator keeps room for NUMINLINE elements inside the
+    array object, and only goes to the heap if the array grows beyond
+    that. This is useful for small arrays which are created and
+    destroyed often, note that an array with inline storage can not
+    be moved with a memcpy.
+
+    @code
+    Util::Array<Math::point, Util::ArrayFrameAllocator> lines;
+    Util::Array<Ptr<ModelNode>, Util::ArrayInlineAllocator<Ptr<ModelNode>, 8> > nodes;
+    @endcode
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+#include "memory/framearena.h"
+
+//------------------------------------------------------------------------------
+namespace Util
+{
+class ArrayHeapAllocator
+{
+public:
+    /// allocate an element buffer
+    static void* Alloc(size_t size);
+    /// free an element buffer
+    static void Free(void* ptr);
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void*
+ArrayHeapAllocator::Alloc(size_t size)
+{
+    return Memory::Alloc(Memory::ObjectArrayHeap, size);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+ArrayHeapAllocator::Free(void* ptr)
+{
+    Memory::Free(Memory::ObjectArrayHeap, ptr);
+}
+
+//------------------------------------------------------------------------------
+class ArrayFrameAllocator
+{
+public:
+    /// allocate an element buffer
+    static void* Alloc(size_t size);
+    /// free an element buffer
+    static void Free(void* ptr);
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void*
+ArrayFrameAllocator::Alloc(size_t size)
+{
+    Memory::FrameArena* arena = Memory::FrameArena::GetThreadArena();
+    void* ptr = (0 != arena) ? arena->Alloc(size) : 0;
+    if (0 == ptr)
+    {
+        ptr = Memory::Alloc(Memory::ObjectArrayHeap, size);
+    }
+    return ptr;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+ArrayFrameAllocator::Free(void* ptr)
+{
+    Memory::FrameArena* arena = Memory::FrameArena::GetThreadArena();
+    if ((0 == arena) || !arena->Owns(ptr))
+    {
+        Memory::Free(Memory::ObjectArrayHeap, ptr);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> class ArrayInlineAllocator
+{
+public:
+    /// constructor
+    ArrayInlineAllocator();
+    /// copy constructor, the inline buffer is never shared
+    ArrayInlineAllocator(const ArrayInlineAllocator<TYPE, NUMINLINE>& rhs);
+    /// assignment operator, the inline buffer is never shared
+    void operator=(const ArrayInlineAllocator<TYPE, NUMINLINE>& rhs);
+
+    /// allocate an element buffer, uses the inline buffer if possible
+    void* Alloc(size_t size);
+    /// free an element buffer
+    void Free(void* ptr);
+
+private:
+    NEBULA3_ALIGN16 unsigned char buffer[NUMINLINE * sizeof(TYPE)];
+    bool inUse;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class TYPE, int NUMINLINE>
+ArrayInlineAllocator<TYPE, NUMINLINE>::ArrayInlineAllocator() :
+    inUse(false)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class TYPE, int NUMINLINE>
+ArrayInlineAllocator<TYPE, NUMINLINE>::ArrayInlineAllocator(const ArrayInlineAllocator<TYPE, NUMINLINE>& rhs) :
+    inUse(false)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class TYPE, int NUMINLINE> void
+ArrayInlineAllocator<TYPE, NUMINLINE>::operator=(const ArrayInlineAllocator<TYPE, NUMINLINE>& rhs)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class TYPE, int NUMINLINE> void*
+ArrayInlineAllocator<TYPE, NUMINLINE>::Alloc(size_t size)
+{
+    if (!this->inUse && (size <= sizeof(this->buffer)))
+    {
+        this->inUse = true;
+        return this->buffer;
+    }
+    return Memory::Alloc(Memory::ObjectArrayHeap, size);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class TYPE, int NUMINLINE> void
+ArrayInlineAllocator<TYPE, NUMINLINE>::Free(void* ptr)
+{
+    if (ptr == this->buffer)
+    {
+        n_assert(this->inUse);
+        this->inUse = false;
+    }
+    else
+    {
+        Memory::Free(Memory::ObjectArrayHeap, ptr);
+    }
+}
+
+} // namespace Util
+//------------------------------------------------------------------------------
@@ -65,7 +65,7 @@ Delegate<ARGTYPE>::operator()(ARGTYPE arg) const
 */
 template<class ARGTYPE>
 template<class CLASS, void (CLASS::*METHOD)(ARGTYPE)>
-static Delegate<ARGTYPE>
+Delegate<ARGTYPE>
 Delegate<ARGTYPE>::FromMethod(CLASS* objPtr_)
 {
     Delegate<ARGTYPE> del;
@@ -79,7 +79,7 @@ Delegate<ARGTYPE>::FromMethod(CLASS* objPtr_)
 */
 template<class ARGTYPE>
 template<void(*FUNCTION)(ARGTYPE)>
-static Delegate<ARGTYPE>
+Delegate<ARGTYPE>
 Delegate<ARGTYPE>::FromFunction()
 {
     Delegate<ARGTYPE> del;
@@ -93,7 +93,7 @@ Delegate<ARGTYPE>::FromFunction()
 */
 template<class ARGTYPE>
 template<class CLASS, void (CLASS::*METHOD)(ARGTYPE)>
-static void
+void
 Delegate<ARGTYPE>::MethodStub(void* objPtr_, ARGTYPE arg_)
 {
     CLASS* obj = static_cast<CLASS*>(objPtr_);
@@ -105,7 +105,7 @@ Delegate<ARGTYPE>::MethodStub(void* objPtr_, ARGTYPE arg_)
 */
 template<class ARGTYPE>
 template<void(*FUNCTION)(ARGTYPE)>
-static void
+void
 Delegate<ARGTYPE>::FunctionStub(void* dummyPtr, ARGTYPE arg_)
 {
     (*FUNCTION)(arg_);
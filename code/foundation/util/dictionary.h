@@ -20,6 +20,9 @@
     Any methods which require the internal array to be sorted will
     throw an assertion between BeginBulkAdd() and EndBulkAdd().
 
+    The optional ALLOCATOR is the allocator policy of the internal
+    array, see Util::Array.
+
     (C) 2006 Radon Labs GmbH
 */    
 #include "util/array.h"
@@ -28,15 +31,15 @@
 //------------------------------------------------------------------------------
 namespace Util
 {
-template<class KEYTYPE, class VALUETYPE> class Dictionary
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR = ArrayHeapAllocator> class Dictionary
 {
 public:
     /// default constructor
     Dictionary();
     /// copy constructor
-    Dictionary(const Dictionary<KEYTYPE, VALUETYPE>& rhs);
+    Dictionary(const Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>& rhs);
     /// assignment operator
-    void operator=(const Dictionary<KEYTYPE, VALUETYPE>& rhs);
+    void operator=(const Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>& rhs);
     /// read/write [] operator
     VALUETYPE& operator[](const KEYTYPE& key);
     /// read-only [] operator
@@ -86,15 +89,15 @@ protected:
     /// make sure the key value pair array is sorted
     void SortIfDirty() const;
 
-    Array<KeyValuePair<KEYTYPE, VALUETYPE> > keyValuePairs;
+    Array<KeyValuePair<KEYTYPE, VALUETYPE>, ALLOCATOR> keyValuePairs;
     bool inBulkInsert;
 };
 
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE>
-Dictionary<KEYTYPE, VALUETYPE>::Dictionary() :
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
+Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>::Dictionary() :
     inBulkInsert(false)
 {
     // empty
@@ -103,8 +106,8 @@ Dictionary<KEYTYPE, VALUETYPE>::Dictionary() :
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE>
-Dictionary<KEYTYPE, VALUETYPE>::Dictionary(const Dictionary<KEYTYPE, VALUETYPE>& rhs) :
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
+Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>::Dictionary(const Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>& rhs) :
     keyValuePairs(rhs.keyValuePairs),
     inBulkInsert(false)
 {
@@ -116,8 +119,8 @@ Dictionary<KEYTYPE, VALUETYPE>::Dictionary(const Dictionary<KEYTYPE, VALUETYPE>&
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE> void
-Dictionary<KEYTYPE, VALUETYPE>::operator=(const Dictionary<KEYTYPE, VALUETYPE>& rhs)
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR> void
+Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>::operator=(const Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>& rhs)
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(!this->inBulkInsert);
@@ -129,8 +132,8 @@ Dictionary<KEYTYPE, VALUETYPE>::operator=(const Dictionary<KEYTYPE, VALUETYPE>&
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE> void
-Dictionary<KEYTYPE, VALUETYPE>::Clear()
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR> void
+Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>::Clear()
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(!this->inBulkInsert);
@@ -141,8 +144,8 @@ Dictionary<KEYTYPE, VALUETYPE>::Clear()
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE> SizeT
-Dictionary<KEYTYPE, VALUETYPE>::Size() const
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR> SizeT
+Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>::Size() const
 {
     return this->keyValuePairs.Size();
 }
@@ -150,8 +153,8 @@ Dictionary<KEYTYPE, VALUETYPE>::Size() const
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE> bool
-Dictionary<KEYTYPE, VALUETYPE>::IsEmpty() const
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR> bool
+Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>::IsEmpty() const
 {
     return (0 == this->keyValuePairs.Size());
 }
@@ -159,8 +162,8 @@ Dictionary<KEYTYPE, VALUETYPE>::IsEmpty() const
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE> void
-Dictionary<KEYTYPE, VALUETYPE>::Add(const KeyValuePair<KEYTYPE, VALUETYPE>& kvp)
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR> void
+Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>::Add(const KeyValuePair<KEYTYPE, VALUETYPE>& kvp)
 {
     if (this->inBulkInsert)
     {
@@ -175,8 +178,8 @@ Dictionary<KEYTYPE, VALUETYPE>::Add(const KeyValuePair<KEYTYPE, VALUETYPE>& kvp)
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE> void
-Dictionary<KEYTYPE, VALUETYPE>::Reserve(SizeT numElements)
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR> void
+Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>::Reserve(SizeT numElements)
 {
     this->keyValuePairs.Reserve(numElements);
 }
@@ -184,8 +187,8 @@ Dictionary<KEYTYPE, VALUETYPE>::Reserve(SizeT numElements)
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE> void
-Dictionary<KEYTYPE, VALUETYPE>::BeginBulkAdd()
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR> void
+Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>::BeginBulkAdd()
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(!this->inBulkInsert);
@@ -196,8 +199,8 @@ Dictionary<KEYTYPE, VALUETYPE>::BeginBulkAdd()
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE> void
-Dictionary<KEYTYPE, VALUETYPE>::EndBulkAdd()
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR> void
+Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>::EndBulkAdd()
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(this->inBulkInsert);
@@ -209,8 +212,8 @@ Dictionary<KEYTYPE, VALUETYPE>::EndBulkAdd()
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE> void
-Dictionary<KEYTYPE, VALUETYPE>::Add(const KEYTYPE& key, const VALUETYPE& value)
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR> void
+Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>::Add(const KEYTYPE& key, const VALUETYPE& value)
 {
     //n_assert(!this->Contains(key));
     KeyValuePair<KEYTYPE, VALUETYPE> kvp(key, value);
@@ -227,8 +230,8 @@ Dictionary<KEYTYPE, VALUETYPE>::Add(const KEYTYPE& key, const VALUETYPE& value)
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE> void
-Dictionary<KEYTYPE, VALUETYPE>::Erase(const KEYTYPE& key)
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR> void
+Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>::Erase(const KEYTYPE& key)
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(!this->inBulkInsert);
@@ -243,8 +246,8 @@ Dictionary<KEYTYPE, VALUETYPE>::Erase(const KEYTYPE& key)
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE> void
-Dictionary<KEYTYPE, VALUETYPE>::EraseAtIndex(IndexT index)
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR> void
+Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>::EraseAtIndex(IndexT index)
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(!this->inBulkInsert);
@@ -255,8 +258,8 @@ Dictionary<KEYTYPE, VALUETYPE>::EraseAtIndex(IndexT index)
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE> IndexT
-Dictionary<KEYTYPE, VALUETYPE>::FindIndex(const KEYTYPE& key) const
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR> IndexT
+Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>::FindIndex(const KEYTYPE& key) const
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(!this->inBulkInsert);
@@ -267,8 +270,8 @@ Dictionary<KEYTYPE, VALUETYPE>::FindIndex(const KEYTYPE& key) const
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE> bool
-Dictionary<KEYTYPE, VALUETYPE>::Contains(const KEYTYPE& key) const
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR> bool
+Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>::Contains(const KEYTYPE& key) const
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(!this->inBulkInsert);
@@ -279,8 +282,8 @@ Dictionary<KEYTYPE, VALUETYPE>::Contains(const KEYTYPE& key) const
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE> const KEYTYPE&
-Dictionary<KEYTYPE, VALUETYPE>::KeyAtIndex(IndexT index) const
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR> const KEYTYPE&
+Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>::KeyAtIndex(IndexT index) const
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(!this->inBulkInsert);
@@ -291,8 +294,8 @@ Dictionary<KEYTYPE, VALUETYPE>::KeyAtIndex(IndexT index) const
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE> VALUETYPE&
-Dictionary<KEYTYPE, VALUETYPE>::ValueAtIndex(IndexT index)
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR> VALUETYPE&
+Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>::ValueAtIndex(IndexT index)
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(!this->inBulkInsert);
@@ -303,8 +306,8 @@ Dictionary<KEYTYPE, VALUETYPE>::ValueAtIndex(IndexT index)
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE> const VALUETYPE&
-Dictionary<KEYTYPE, VALUETYPE>::ValueAtIndex(IndexT index) const
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR> const VALUETYPE&
+Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>::ValueAtIndex(IndexT index) const
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(!this->inBulkInsert);
@@ -315,8 +318,8 @@ Dictionary<KEYTYPE, VALUETYPE>::ValueAtIndex(IndexT index) const
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE> KeyValuePair<KEYTYPE, VALUETYPE>&
-Dictionary<KEYTYPE, VALUETYPE>::KeyValuePairAtIndex(IndexT index) const
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR> KeyValuePair<KEYTYPE, VALUETYPE>&
+Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>::KeyValuePairAtIndex(IndexT index) const
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(!this->inBulkInsert);
@@ -327,8 +330,8 @@ Dictionary<KEYTYPE, VALUETYPE>::KeyValuePairAtIndex(IndexT index) const
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE> VALUETYPE&
-Dictionary<KEYTYPE, VALUETYPE>::operator[](const KEYTYPE& key)
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR> VALUETYPE&
+Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>::operator[](const KEYTYPE& key)
 {
     int keyValuePairIndex = this->FindIndex(key);
     #if NEBULA3_BOUNDSCHECKS
@@ -340,8 +343,8 @@ Dictionary<KEYTYPE, VALUETYPE>::operator[](const KEYTYPE& key)
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE> const VALUETYPE&
-Dictionary<KEYTYPE, VALUETYPE>::operator[](const KEYTYPE& key) const
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR> const VALUETYPE&
+Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>::operator[](const KEYTYPE& key) const
 {
     int keyValuePairIndex = this->FindIndex(key);
     #if NEBULA3_BOUNDSCHECKS
@@ -353,10 +356,10 @@ Dictionary<KEYTYPE, VALUETYPE>::operator[](const KEYTYPE& key) const
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE>
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
 template<class RETURNTYPE>
 RETURNTYPE
-Dictionary<KEYTYPE, VALUETYPE>::ValuesAs() const
+Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>::ValuesAs() const
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(!this->inBulkInsert);
@@ -373,9 +376,9 @@ Dictionary<KEYTYPE, VALUETYPE>::ValuesAs() const
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE>
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
 Array<VALUETYPE>
-Dictionary<KEYTYPE, VALUETYPE>::ValuesAsArray() const
+Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>::ValuesAsArray() const
 {
     return this->ValuesAs<Array<VALUETYPE> >();
 }
@@ -383,10 +386,10 @@ Dictionary<KEYTYPE, VALUETYPE>::ValuesAsArray() const
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE> 
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR> 
 template<class RETURNTYPE>
 RETURNTYPE
-Dictionary<KEYTYPE, VALUETYPE>::KeysAs() const
+Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>::KeysAs() const
 {
     #if NEBULA3_BOUNDSCHECKS    
     n_assert(!this->inBulkInsert);
@@ -403,12 +406,25 @@ Dictionary<KEYTYPE, VALUETYPE>::KeysAs() const
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE>
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
 Array<KEYTYPE>
-Dictionary<KEYTYPE, VALUETYPE>::KeysAsArray() const
+Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR>::KeysAsArray() const
 {
     return this->KeysAs<Array<KEYTYPE> >();
 }
 
 } // namespace Util
+
+//------------------------------------------------------------------------------
+namespace Core
+{
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR> struct TypeTraits<Util::Dictionary<KEYTYPE, VALUETYPE, ALLOCATOR> >
+{
+    enum
+    {
+        IsTrivial = false,
+        IsRelocatable = TypeTraits<Util::Array<Util::KeyValuePair<KEYTYPE, VALUETYPE>, ALLOCATOR> >::IsRelocatable
+    };
+};
+} // namespace Core
 //------------------------------------------------------------------------------
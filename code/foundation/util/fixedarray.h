@@ -467,4 +467,17 @@ FixedArray<TYPE>::AsArray() const
 }
 
 } // namespace Util
+
+//------------------------------------------------------------------------------
+namespace Core
+{
+template<class TYPE> struct TypeTraits<Util::FixedArray<TYPE> >
+{
+    enum
+    {
+        IsTrivial = false,
+        IsRelocatable = true
+    };
+};
+} // namespace Core
 //------------------------------------------------------------------------------
@@ -40,6 +40,8 @@ public:
     void SetFromUInt(uint f);
     /// get as 32-bit-value
     uint AsUInt() const;
+    /// get hash code (for Util::HashTable)
+    IndexT HashCode() const;
     /// set as string
     void SetFromString(const String& s);
     /// get as string
@@ -164,6 +166,15 @@ FourCC::AsUInt() const
     return this->fourCC;
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+inline IndexT
+FourCC::HashCode() const
+{
+    return IndexT(this->fourCC & 0x7fffffff);
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -4,20 +4,28 @@
 //------------------------------------------------------------------------------
 #include "stdneb.h"
 #include "util/globalstringatomtable.h"
+#include "threading/interlocked.h"
 
 namespace Util
 {
 __ImplementInterfaceSingleton(Util::GlobalStringAtomTable);
 
+using namespace Threading;
+
 //------------------------------------------------------------------------------
 /**
 */
 GlobalStringAtomTable::GlobalStringAtomTable()
 {
     __ConstructInterfaceSingleton;
-    
-    // setup the global string buffer
-    this->stringBuffer.Setup(NEBULA3_GLOBAL_STRINGBUFFER_CHUNKSIZE);
+
+    // setup the shards
+    IndexT i;
+    for (i = 0; i < NumShards; i++)
+    {
+        this->shards[i].table = AllocTable(InitialShardCapacity);
+        this->shards[i].stringBuffer.Setup(ShardChunkSize);
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -25,44 +33,103 @@ GlobalStringAtomTable::GlobalStringAtomTable()
 */
 GlobalStringAtomTable::~GlobalStringAtomTable()
 {
-    this->critSect.Enter();
-    this->stringBuffer.Discard();
+    IndexT i;
+    for (i = 0; i < NumShards; i++)
+    {
+        Shard& shard = this->shards[i];
+        shard.critSect.Enter();
+        Memory::Free(Memory::StringDataHeap, shard.table);
+        shard.table = 0;
+        IndexT tableIndex;
+        for (tableIndex = 0; tableIndex < shard.oldTables.Size(); tableIndex++)
+        {
+            Memory::Free(Memory::StringDataHeap, shard.oldTables[tableIndex]);
+        }
+        shard.oldTables.Clear();
+        shard.stringBuffer.Discard();
+        shard.critSect.Leave();
+    }
     __DestructInterfaceSingleton;
-    this->critSect.Leave();
 }
 
 //------------------------------------------------------------------------------
 /**
+    The table header, the hash codes and the string pointers are allocated
+    as one memory block.
 */
-void
-GlobalStringAtomTable::Lock()
+GlobalStringAtomTable::Table*
+GlobalStringAtomTable::AllocTable(SizeT capacity)
 {
-    this->critSect.Enter();
+    n_assert(0 == (capacity & (capacity - 1)));
+    size_t tableSize = sizeof(Table) + capacity * (sizeof(const char*) + sizeof(uint));
+    Table* table = (Table*) Memory::Alloc(Memory::StringDataHeap, tableSize);
+    table->capacity = capacity;
+    table->size = 0;
+    table->strings = (const char* volatile*) (table + 1);
+    table->hashCodes = (uint*) (table->strings + capacity);
+    Memory::Clear((void*)table->strings, capacity * sizeof(const char*));
+    return table;
 }
 
 //------------------------------------------------------------------------------
 /**
+    Copies all strings into a table with twice the capacity and publishes
+    the new table. Other threads may still be reading the old table, so
+    it is only freed in the destructor.
 */
 void
-GlobalStringAtomTable::Unlock()
+GlobalStringAtomTable::GrowTable(Shard& shard)
 {
-    this->critSect.Leave();
+    Table* oldTable = shard.table;
+    Table* newTable = AllocTable(oldTable->capacity * 2);
+    SizeT mask = newTable->capacity - 1;
+    IndexT i;
+    for (i = 0; i < oldTable->capacity; i++)
+    {
+        const char* str = oldTable->strings[i];
+        if (0 != str)
+        {
+            uint hashCode = oldTable->hashCodes[i];
+            IndexT newIndex = hashCode & mask;
+            while (0 != newTable->strings[newIndex])
+            {
+                newIndex = (newIndex + 1) & mask;
+            }
+            newTable->hashCodes[newIndex] = hashCode;
+            newTable->strings[newIndex] = str;
+        }
+    }
+    newTable->size = oldTable->size;
+    Interlocked::CompareExchangePointer((void* volatile*)&shard.table, newTable, oldTable);
+    shard.oldTables.Append(oldTable);
 }
 
 //------------------------------------------------------------------------------
 /**
-    This adds a new string to the atom table and the global string buffer,
-    and returns the pointer to the string in the string buffer.
-
-    NOTE: you MUST call this method within Lock()/Unlock()!
+    Copies the string into the shard's string buffer and adds it to the
+    shard's table. The table is kept at most 3/4 full.
 */
 const char*
-GlobalStringAtomTable::Add(const char* str)
+GlobalStringAtomTable::AddToShard(Shard& shard, const char* str, uint hashCode)
 {
-    StaticString sstr;
-    sstr.ptr = (char*)this->stringBuffer.AddString(str);
-    this->table.InsertSorted(sstr);
-    return sstr.ptr;
+    if ((shard.table->size + 1) * 4 > shard.table->capacity * 3)
+    {
+        GrowTable(shard);
+    }
+    Table* table = shard.table;
+    SizeT mask = table->capacity - 1;
+    IndexT i = hashCode & mask;
+    while (0 != table->strings[i])
+    {
+        i = (i + 1) & mask;
+    }
+
+    // the string pointer must become visible after the hash code and the string data
+    const char* newString = shard.stringBuffer.AddString(str);
+    table->hashCodes[i] = hashCode;
+    Interlocked::CompareExchangePointer((void* volatile*)&(table->strings[i]), (void*)newString, 0);
+    table->size++;
+    return newString;
 }
 
 //------------------------------------------------------------------------------
@@ -72,24 +139,33 @@ GlobalStringAtomTable::Add(const char* str)
 GlobalStringAtomTable::DebugInfo
 GlobalStringAtomTable::GetDebugInfo() const
 {
-    this->critSect.Enter();
     DebugInfo debugInfo;
-    debugInfo.strings.Reserve(this->table.Size());
-    debugInfo.chunkSize = NEBULA3_GLOBAL_STRINGBUFFER_CHUNKSIZE;
-    debugInfo.numChunks = this->stringBuffer.GetNumChunks();
-    debugInfo.allocSize = debugInfo.chunkSize * debugInfo.numChunks;
+    debugInfo.chunkSize = ShardChunkSize;
+    debugInfo.numChunks = 0;
     debugInfo.usedSize  = 0;
     debugInfo.growthEnabled = NEBULA3_ENABLE_GLOBAL_STRINGBUFFER_GROWTH;
 
-    IndexT i;
-    for (i = 0; i < table.Size(); i++)
-    {        
-        const char* str = this->table[i].ptr;
-        debugInfo.strings.Append(this->table[i].ptr);
-        debugInfo.usedSize += strlen(str) + 1;
+    IndexT shardIndex;
+    for (shardIndex = 0; shardIndex < NumShards; shardIndex++)
+    {
+        const Shard& shard = this->shards[shardIndex];
+        shard.critSect.Enter();
+        const Table* table = shard.table;
+        debugInfo.numChunks += shard.stringBuffer.GetNumChunks();
+        IndexT i;
+        for (i = 0; i < table->capacity; i++)
+        {
+            const char* str = table->strings[i];
+            if (0 != str)
+            {
+                debugInfo.strings.Append(str);
+                debugInfo.usedSize += strlen(str) + 1;
+            }
+        }
+        shard.critSect.Leave();
     }
-    this->critSect.Leave();
+    debugInfo.allocSize = debugInfo.chunkSize * debugInfo.numChunks;
     return debugInfo;
 }
 
-} // namespace Util
\ No newline at end of file
+} // namespace Util
@@ -2,24 +2,43 @@
 //------------------------------------------------------------------------------
 /**
     @class Util::GlobalStringAtomTable
-  
+
     Global string atom table. This is the definitive string atom table which
-    contains the string of all string atoms of all threads. Locking
-    is necessary to lookup or add a string (that's why thread-local
-    string atom tables exist as local cache to prevent too much locking of
-    the global table).
-    
+    contains the string of all string atoms of all threads.
+
+    The table is split into NumShards shards by the hash code of the
+    strings, each shard is an open-addressing hash table of string pointers
+    with its own lock and its own StringBuffer for the string data. The
+    string buffers of all shards together start with the size of one
+    global string buffer chunk, a shard's buffer grows by adding chunks
+    when it is full.
+
+    Finding a string which is already in the table doesn't take any
+    locks: a slot is only written once (under the shard's lock) and the
+    hash codes of the slots are compared before the strings. Only if the
+    string isn't found, the shard's lock is taken, so threads only
+    contend when they add new strings with the same shard at the same
+    time.
+
+    When a shard's table grows, the new table is published with an
+    interlocked operation, the old table stays valid for concurrent
+    readers until the GlobalStringAtomTable is destroyed. A reader which
+    doesn't see a string which has just been added falls back to the
+    locked path.
+
     (C) 2009 Radon Labs GmbH
 */
-#include "util/stringatomtablebase.h"
+#include "core/types.h"
 #include "core/singleton.h"
 #include "threading/criticalsection.h"
 #include "util/stringbuffer.h"
 
+#include <string.h>
+
 //------------------------------------------------------------------------------
 namespace Util
 {
-class GlobalStringAtomTable : public StringAtomTableBase
+class GlobalStringAtomTable
 {
     __DeclareInterfaceSingleton(GlobalStringAtomTable);
 public:
@@ -28,9 +47,6 @@ public:
     /// destructor
     ~GlobalStringAtomTable();
 
-    /// get pointer to global string buffer
-    StringBuffer* GetGlobalStringBuffer() const;
-
     /// debug functionality: DebugInfo struct
     struct DebugInfo
     {
@@ -41,24 +57,127 @@ public:
         SizeT usedSize;
         bool growthEnabled;
     };
-    
+
     /// debug functionality: get copy of the string atom table
     DebugInfo GetDebugInfo() const;
 
+    static const SizeT NumShards = 16;
+    static const SizeT ShardChunkSize = NEBULA3_GLOBAL_STRINGBUFFER_CHUNKSIZE / NumShards;
+    static const SizeT InitialShardCapacity = 256;
+
 private:
     friend class StringAtom;
 
-    /// take the critical section
-    void Lock();
-    /// add a string pointer to the atom table and string buffer (must be called inside Lock())
-    const char* Add(const char* str);
-    /// release the critical section
-    void Unlock();
+    /// an open-addressing hash table of string pointers
+    struct Table
+    {
+        SizeT capacity;
+        SizeT size;
+        uint* hashCodes;
+        const char* volatile* strings;
+    };
+    /// a shard of the global table
+    struct Shard
+    {
+        Table* volatile table;
+        Util::Array<Table*> oldTables;
+        StringBuffer stringBuffer;
+        Threading::CriticalSection critSect;
+    };
 
-    Threading::CriticalSection critSect;
-    StringBuffer stringBuffer;
+    /// find or add a string, returns pointer to the string in the string buffer (thread-safe)
+    const char* Intern(const char* str);
+    /// compute hash code of a string
+    static uint HashCode(const char* str);
+    /// get the shard of a hash code
+    Shard& GetShard(uint hashCode);
+    /// find a string in a table, returns 0 if not found
+    static const char* Find(const Table* table, const char* str, uint hashCode);
+    /// allocate an empty table
+    static Table* AllocTable(SizeT capacity);
+    /// replace the table of a shard by a bigger one (must be called inside the shard's lock)
+    static void GrowTable(Shard& shard);
+    /// add a string to the shard's table (must be called inside the shard's lock)
+    static const char* AddToShard(Shard& shard, const char* str, uint hashCode);
+
+    Shard shards[NumShards];
 };
 
-} // namespace Util
 //------------------------------------------------------------------------------
+/**
+    Same hash function as Util::String::HashCode().
+*/
+inline uint
+GlobalStringAtomTable::HashCode(const char* str)
+{
+    uint hash = 0;
+    while (0 != *str)
+    {
+        hash += *str++;
+        hash += hash << 10;
+        hash ^= hash >>  6;
+    }
+    hash += hash << 3;
+    hash ^= hash >> 11;
+    hash += hash << 15;
+    return hash;
+}
+
+//------------------------------------------------------------------------------
+/**
+    The shard is selected by the high bits of the hash code, the slot in
+    the shard's table by the low bits.
+*/
+inline GlobalStringAtomTable::Shard&
+GlobalStringAtomTable::GetShard(uint hashCode)
+{
+    return this->shards[(hashCode >> 24) & (NumShards - 1)];
+}
 
+//------------------------------------------------------------------------------
+/**
+    This doesn't need a lock, slots are only written once and the string
+    pointer is published after the hash code.
+*/
+inline const char*
+GlobalStringAtomTable::Find(const Table* table, const char* str, uint hashCode)
+{
+    SizeT mask = table->capacity - 1;
+    IndexT i = hashCode & mask;
+    const char* slotString;
+    while (0 != (slotString = table->strings[i]))
+    {
+        if ((table->hashCodes[i] == hashCode) && (0 == strcmp(slotString, str)))
+        {
+            return slotString;
+        }
+        i = (i + 1) & mask;
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const char*
+GlobalStringAtomTable::Intern(const char* str)
+{
+    uint hashCode = HashCode(str);
+    Shard& shard = this->GetShard(hashCode);
+    const char* result = Find(shard.table, str, hashCode);
+    if (0 == result)
+    {
+        // not found, or just being added by another thread
+        shard.critSect.Enter();
+        result = Find(shard.table, str, hashCode);
+        if (0 == result)
+        {
+            result = AddToShard(shard, str, hashCode);
+        }
+        shard.critSect.Leave();
+    }
+    return result;
+}
+
+} // namespace Util
+//------------------------------------------------------------------------------
@@ -38,6 +38,12 @@ namespace Util
 {
 typedef OSX::OSXGuid Guid;
 }
+#elif __LINUX__
+#include "util/posix/posixguid.h"
+namespace Util
+{
+typedef Posix::PosixGuid Guid;
+}
 #else
 #error "Util::Guid not implemented on this platform!"
 #endif
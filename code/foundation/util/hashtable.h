@@ -2,39 +2,52 @@
 //------------------------------------------------------------------------------
 /**
     @class Util::HashTable
-    
+
     Organizes key/value pairs by a hash code. Looks very similar
-    to a Dictionary, but may provide better search times (up to O(1))
-    by computing a (ideally unique) hash code on the key and using that as an
-    index into an array. The flipside is that the key class must provide
-    a hash code and the memory footprint may be larger then Dictionary.
-    
-    The default capacity is 128. Matching the capacity against the number
-    of expected elements in the hash table is one key to get optimal 
-    insertion and search times, the other is to provide a good (and fast) 
-    hash code computation which produces as few collissions as possible 
-    for the key type.
-
-    The key class must implement the following method in order to
-    work with the HashTable:    
+    to a Dictionary, but provides better search times (O(1) on average)
+    by computing a hash code on the key and using that as an index into
+    a flat table. The flipside is that the key class must provide a hash
+    code and the memory footprint may be larger then Dictionary.
+
+    The key class must implement the following methods in order to
+    work with the HashTable:
     IndexT HashCode() const;
+    bool operator==(const KEYTYPE& rhs) const;
 
     The Util::String class implements this method as an example.
-    Internally the hash table is implemented as a fixed array
-    of sorted arrays. The fixed array is indexed by the hash code
-    of the key, the sorted arrays contain all values with identical
-    keys.
+
+    Internally the hash table uses open addressing: all key/value pairs
+    live in one table, there are no per-bucket arrays. A separate array
+    of control bytes holds one byte per slot: either "empty", "deleted",
+    or 7 bits of the key's hash code. The table is divided into groups
+    of 16 slots. A lookup tests all 16 control bytes of a group at once
+    (with SSE2 where available) and only compares keys of slots whose
+    hash bits match, the key/value pairs of other slots are never
+    touched. Groups are probed quadratically until a group with an
+    empty slot is found.
+
+    The capacity is always a power of 2 and a multiple of 16, the table
+    grows by doubling when it is 7/8 full (including deleted slots). Adding
+    or erasing elements may move all key/value pairs, so indices returned
+    by FindIndex() are only valid until the table is modified.
+
+    The optional ALLOCATOR is the allocator policy for the table (see
+    util/arrayallocator.h).
 
     (C) 2006 Radon Labs GmbH
 */
 #include "util/fixedarray.h"
 #include "util/array.h"
 #include "util/keyvaluepair.h"
+#include <new>
+#if NEBULA3_HASHTABLE_USE_SSE2
+#include <emmintrin.h>
+#endif
 
 //------------------------------------------------------------------------------
 namespace Util
 {
-template<class KEYTYPE, class VALUETYPE> class HashTable
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR = ArrayHeapAllocator> class HashTable : private ALLOCATOR
 {
 public:
     /// default constructor
@@ -42,19 +55,23 @@ public:
     /// constructor with capacity
     HashTable(SizeT capacity);
     /// copy constructor
-    HashTable(const HashTable<KEYTYPE, VALUETYPE>& rhs);
+    HashTable(const HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>& rhs);
+    /// destructor
+    ~HashTable();
     /// assignment operator
-    void operator=(const HashTable<KEYTYPE, VALUETYPE>& rhs);
+    void operator=(const HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>& rhs);
     /// read/write [] operator, assertion if key not found
     VALUETYPE& operator[](const KEYTYPE& key) const;
     /// return current number of values in the hashtable
     SizeT Size() const;
-    /// return fixed-size capacity of the hash table
+    /// return current capacity of the hash table
     SizeT Capacity() const;
     /// clear the hashtable
     void Clear();
     /// return true if empty
     bool IsEmpty() const;
+    /// make room for a number of elements
+    void Reserve(SizeT numElements);
     /// add a key/value pair object to the hash table
     void Add(const KeyValuePair<KEYTYPE, VALUETYPE>& kvp);
     /// add a key and associated value
@@ -63,98 +80,407 @@ public:
     void Erase(const KEYTYPE& key);
     /// return true if key exists in the array
     bool Contains(const KEYTYPE& key) const;
+    /// find slot index of key (InvalidIndex if doesn't exist), valid until the table is modified
+    IndexT FindIndex(const KEYTYPE& key) const;
+    /// get key at slot index
+    const KEYTYPE& KeyAtIndex(IndexT index) const;
+    /// get value at slot index
+    VALUETYPE& ValueAtIndex(IndexT index) const;
     /// return array of all key/value pairs in the table (slow)
     Array<KeyValuePair<KEYTYPE, VALUETYPE> > Content() const;
 
 private:
-    FixedArray<Array<KeyValuePair<KEYTYPE, VALUETYPE> > > hashArray;
-    int size;
+    /// control byte values, full slots contain 7 bits of the hash code
+    enum
+    {
+        Empty = -128,
+        Deleted = -2
+    };
+    static const SizeT GroupSize = 16;
+
+    /// compute the hash of a key
+    static uint Hash(const KEYTYPE& key);
+    /// get mask of control bytes in a group which match a value
+    static uint MatchByte(const signed char* group, signed char value);
+    /// get mask of empty slots in a group
+    static uint MatchEmpty(const signed char* group);
+    /// get mask of empty or deleted slots in a group
+    static uint MatchFree(const signed char* group);
+    /// get index of lowest set bit in a non-zero mask
+    static IndexT FirstBit(uint mask);
+    /// allocate an empty table
+    void Alloc(SizeT capacity);
+    /// destroy all elements and free the table
+    void Delete();
+    /// copy content of another hash table
+    void Copy(const HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>& src);
+    /// move all elements into a new table
+    void Rehash(SizeT newCapacity);
+    /// find a free slot for a new element
+    IndexT FindFreeSlot(uint hash) const;
+
+    signed char* ctrl;
+    KeyValuePair<KEYTYPE, VALUETYPE>* slots;
+    SizeT capacity;
+    SizeT size;
+    SizeT numDeleted;
 };
 
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE>
-HashTable<KEYTYPE, VALUETYPE>::HashTable() :
-    hashArray(128),
-    size(0)
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::HashTable() :
+    ctrl(0),
+    slots(0),
+    capacity(0),
+    size(0),
+    numDeleted(0)
 {
     // empty
 }
 
 //------------------------------------------------------------------------------
 /**
+    The capacity is rounded up to the next power of 2.
 */
-template<class KEYTYPE, class VALUETYPE>
-HashTable<KEYTYPE, VALUETYPE>::HashTable(SizeT capacity) :
-    hashArray(capacity),
-    size(0)
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::HashTable(SizeT capacity) :
+    ctrl(0),
+    slots(0),
+    capacity(0),
+    size(0),
+    numDeleted(0)
 {
-    // empty
+    SizeT num = GroupSize;
+    while (num < capacity)
+    {
+        num <<= 1;
+    }
+    this->Alloc(num);
 }
 
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE>
-HashTable<KEYTYPE, VALUETYPE>::HashTable(const HashTable<KEYTYPE, VALUETYPE>& rhs) :
-    hashArray(rhs.hashArray),
-    size(rhs.size)
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::HashTable(const HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>& rhs) :
+    ctrl(0),
+    slots(0),
+    capacity(0),
+    size(0),
+    numDeleted(0)
 {
-    // empty
+    this->Copy(rhs);
 }
 
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE>
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::~HashTable()
+{
+    this->Delete();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
 void
-HashTable<KEYTYPE, VALUETYPE>::operator=(const HashTable<KEYTYPE, VALUETYPE>& rhs)
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::operator=(const HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>& rhs)
 {
     if (this != &rhs)
     {
-        this->hashArray = rhs.hashArray;
-        this->size = rhs.size;
+        this->Delete();
+        this->Copy(rhs);
     }
 }
 
 //------------------------------------------------------------------------------
 /**
+    This is the finalizer of MurmurHash3, it spreads the entropy of the
+    key's hash code over all bits. The low 7 bits go into the control
+    bytes, the other bits select the first group to probe.
 */
-template<class KEYTYPE, class VALUETYPE>
-VALUETYPE&
-HashTable<KEYTYPE, VALUETYPE>::operator[](const KEYTYPE& key) const
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
+uint
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::Hash(const KEYTYPE& key)
+{
+    uint h = (uint) key.HashCode();
+    h ^= h >> 16;
+    h *= 0x85ebca6b;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35;
+    h ^= h >> 16;
+    return h;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
+uint
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::MatchByte(const signed char* group, signed char value)
+{
+    #if NEBULA3_HASHTABLE_USE_SSE2
+    __m128i ctrlBytes = _mm_loadu_si128((const __m128i*) group);
+    return (uint) _mm_movemask_epi8(_mm_cmpeq_epi8(ctrlBytes, _mm_set1_epi8(value)));
+    #else
+    uint mask = 0;
+    IndexT i;
+    for (i = 0; i < GroupSize; i++)
+    {
+        if (group[i] == value)
+        {
+            mask |= (1 << i);
+        }
+    }
+    return mask;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
+uint
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::MatchEmpty(const signed char* group)
+{
+    return MatchByte(group, (signed char) Empty);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Empty and deleted slots are the only negative control bytes.
+*/
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
+uint
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::MatchFree(const signed char* group)
+{
+    #if NEBULA3_HASHTABLE_USE_SSE2
+    return (uint) _mm_movemask_epi8(_mm_loadu_si128((const __m128i*) group));
+    #else
+    uint mask = 0;
+    IndexT i;
+    for (i = 0; i < GroupSize; i++)
+    {
+        if (group[i] < 0)
+        {
+            mask |= (1 << i);
+        }
+    }
+    return mask;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
+IndexT
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::FirstBit(uint mask)
 {
-    // get hash code from key, trim to capacity
-    IndexT hashIndex = key.HashCode() % this->hashArray.Size();
-    const Array<KeyValuePair<KEYTYPE, VALUETYPE> >& hashElements = this->hashArray[hashIndex];
-    int numHashElements = hashElements.Size();
-    #if NEBULA3_BOUNDSCHECKS    
-    n_assert(0 != numHashElements); // element with key doesn't exist
+    #if __WIN32__
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (IndexT) index;
+    #elif __GNUC__
+    return __builtin_ctz(mask);
+    #else
+    IndexT index = 0;
+    while (0 == (mask & 1))
+    {
+        mask >>= 1;
+        index++;
+    }
+    return index;
     #endif
-    if (1 == numHashElements)
+}
+
+//------------------------------------------------------------------------------
+/**
+    The control bytes and the slots share one allocation, the slots
+    are not constructed.
+*/
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
+void
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::Alloc(SizeT num)
+{
+    n_assert(0 == this->ctrl);
+    n_assert((num >= GroupSize) && (0 == (num & (num - 1))));
+    this->ctrl = (signed char*) ALLOCATOR::Alloc(num + num * sizeof(KeyValuePair<KEYTYPE, VALUETYPE>));
+    this->slots = (KeyValuePair<KEYTYPE, VALUETYPE>*) (this->ctrl + num);
+    Memory::Fill(this->ctrl, num, (unsigned char) Empty);
+    this->capacity = num;
+    this->size = 0;
+    this->numDeleted = 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
+void
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::Delete()
+{
+    if (0 != this->ctrl)
     {
-        // no hash collissions, just return the only existing element
-        return hashElements[0].Value();
+        this->Clear();
+        ALLOCATOR::Free(this->ctrl);
+        this->ctrl = 0;
+        this->slots = 0;
+        this->capacity = 0;
     }
-    else
+}
+
+//------------------------------------------------------------------------------
+/**
+    The control bytes are copied, so all elements end up in the same slots.
+*/
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
+void
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::Copy(const HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>& src)
+{
+    if (src.capacity > 0)
     {
-        // here's a hash collision, find the right key
-        // with a binary search
-        IndexT hashElementIndex = hashElements.BinarySearchIndex(key);
-        #if NEBULA3_BOUNDSCHECKS
-        n_assert(InvalidIndex != hashElementIndex);
-        #endif
-        return hashElements[hashElementIndex].Value();
+        this->Alloc(src.capacity);
+        Memory::Copy(src.ctrl, this->ctrl, src.capacity);
+        IndexT i;
+        for (i = 0; i < src.capacity; i++)
+        {
+            if (src.ctrl[i] >= 0)
+            {
+                ::new(&(this->slots[i])) KeyValuePair<KEYTYPE, VALUETYPE>(src.slots[i]);
+            }
+        }
+        this->size = src.size;
+        this->numDeleted = src.numDeleted;
     }
 }
 
 //------------------------------------------------------------------------------
 /**
+    Move all elements into a new table, this also gets rid of deleted slots.
+    Relocatable key/value pairs are moved with a memcpy.
 */
-template<class KEYTYPE, class VALUETYPE>
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
+void
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::Rehash(SizeT newCapacity)
+{
+    signed char* oldCtrl = this->ctrl;
+    KeyValuePair<KEYTYPE, VALUETYPE>* oldSlots = this->slots;
+    SizeT oldCapacity = this->capacity;
+    SizeT oldSize = this->size;
+    this->ctrl = 0;
+    this->Alloc(newCapacity);
+    if (0 != oldCtrl)
+    {
+        IndexT i;
+        for (i = 0; i < oldCapacity; i++)
+        {
+            if (oldCtrl[i] >= 0)
+            {
+                uint hash = Hash(oldSlots[i].Key());
+                IndexT slotIndex = this->FindFreeSlot(hash);
+                this->ctrl[slotIndex] = (signed char) (hash & 0x7f);
+                if (Core::TypeTraits<KeyValuePair<KEYTYPE, VALUETYPE> >::IsRelocatable)
+                {
+                    Memory::Copy(&(oldSlots[i]), &(this->slots[slotIndex]), sizeof(KeyValuePair<KEYTYPE, VALUETYPE>));
+                }
+                else
+                {
+                    ::new(&(this->slots[slotIndex])) KeyValuePair<KEYTYPE, VALUETYPE>(oldSlots[i]);
+                    oldSlots[i].~KeyValuePair<KEYTYPE, VALUETYPE>();
+                }
+            }
+        }
+        ALLOCATOR::Free(oldCtrl);
+    }
+    this->size = oldSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Find the first empty or deleted slot on the probe sequence of a hash.
+*/
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
+IndexT
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::FindFreeSlot(uint hash) const
+{
+    SizeT groupMask = (this->capacity / GroupSize) - 1;
+    IndexT group = (hash >> 7) & groupMask;
+    IndexT probe;
+    for (probe = 1; ; probe++)
+    {
+        uint freeMask = MatchFree(this->ctrl + group * GroupSize);
+        if (0 != freeMask)
+        {
+            return group * GroupSize + FirstBit(freeMask);
+        }
+        group = (group + probe) & groupMask;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
+IndexT
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::FindIndex(const KEYTYPE& key) const
+{
+    if (0 == this->size)
+    {
+        return InvalidIndex;
+    }
+    uint hash = Hash(key);
+    signed char hashBits = (signed char) (hash & 0x7f);
+    SizeT numGroups = this->capacity / GroupSize;
+    IndexT group = (hash >> 7) & (numGroups - 1);
+    IndexT probe;
+    for (probe = 1; probe <= numGroups; probe++)
+    {
+        const signed char* groupCtrl = this->ctrl + group * GroupSize;
+        uint matchMask = MatchByte(groupCtrl, hashBits);
+        while (0 != matchMask)
+        {
+            IndexT slotIndex = group * GroupSize + FirstBit(matchMask);
+            if (this->slots[slotIndex].Key() == key)
+            {
+                return slotIndex;
+            }
+            matchMask &= (matchMask - 1);
+        }
+        if (0 != MatchEmpty(groupCtrl))
+        {
+            // the key would have been placed into this group
+            break;
+        }
+        group = (group + probe) & (numGroups - 1);
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
+VALUETYPE&
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::operator[](const KEYTYPE& key) const
+{
+    IndexT slotIndex = this->FindIndex(key);
+    #if NEBULA3_BOUNDSCHECKS
+    n_assert(InvalidIndex != slotIndex); // element with key doesn't exist
+    #endif
+    return this->slots[slotIndex].Value();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
 SizeT
-HashTable<KEYTYPE, VALUETYPE>::Size() const
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::Size() const
 {
     return this->size;
 }
@@ -162,60 +488,115 @@ HashTable<KEYTYPE, VALUETYPE>::Size() const
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE>
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
 SizeT
-HashTable<KEYTYPE, VALUETYPE>::Capacity() const
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::Capacity() const
 {
-    return this->hashArray.Size();
+    return this->capacity;
 }
 
 //------------------------------------------------------------------------------
 /**
+    Destroys all elements but keeps the capacity.
 */
-template<class KEYTYPE, class VALUETYPE>
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
 void
-HashTable<KEYTYPE, VALUETYPE>::Clear()
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::Clear()
 {
-    IndexT i;
-    SizeT num = this->hashArray.Size();
-    for (i = 0; i < num; i++)
+    if (0 != this->ctrl)
     {
-        this->hashArray[i].Clear();
+        if (!Core::TypeTraits<KeyValuePair<KEYTYPE, VALUETYPE> >::IsTrivial)
+        {
+            IndexT i;
+            for (i = 0; i < this->capacity; i++)
+            {
+                if (this->ctrl[i] >= 0)
+                {
+                    this->slots[i].~KeyValuePair<KEYTYPE, VALUETYPE>();
+                }
+            }
+        }
+        Memory::Fill(this->ctrl, this->capacity, (unsigned char) Empty);
     }
     this->size = 0;
+    this->numDeleted = 0;
 }
 
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE>
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
 bool
-HashTable<KEYTYPE, VALUETYPE>::IsEmpty() const
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::IsEmpty() const
 {
     return (0 == this->size);
 }
 
 //------------------------------------------------------------------------------
 /**
+    Grow the table so that the given number of elements fit in without
+    rehashing.
 */
-template<class KEYTYPE, class VALUETYPE>
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
 void
-HashTable<KEYTYPE, VALUETYPE>::Add(const KeyValuePair<KEYTYPE, VALUETYPE>& kvp)
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::Reserve(SizeT numElements)
+{
+    SizeT num = (this->capacity > 0) ? this->capacity : GroupSize;
+    while ((num - (num >> 3)) < numElements)
+    {
+        num <<= 1;
+    }
+    if (num > this->capacity)
+    {
+        this->Rehash(num);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    If the table is full (including deleted slots), it is rehashed. The
+    capacity is doubled if more than 3/4 of the slots are in use,
+    otherwise rehashing just removes the deleted slots.
+*/
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
+void
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::Add(const KeyValuePair<KEYTYPE, VALUETYPE>& kvp)
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(!this->Contains(kvp.Key()));
     #endif
-    IndexT hashIndex = kvp.Key().HashCode() % this->hashArray.Size();
-    this->hashArray[hashIndex].InsertSorted(kvp);
+    if (0 == this->capacity)
+    {
+        this->Alloc(GroupSize);
+    }
+    else if ((this->size + this->numDeleted) >= (this->capacity - (this->capacity >> 3)))
+    {
+        if (this->size >= (this->capacity - (this->capacity >> 2)))
+        {
+            this->Rehash(this->capacity << 1);
+        }
+        else
+        {
+            this->Rehash(this->capacity);
+        }
+    }
+    uint hash = Hash(kvp.Key());
+    IndexT slotIndex = this->FindFreeSlot(hash);
+    if (Deleted == this->ctrl[slotIndex])
+    {
+        this->numDeleted--;
+    }
+    this->ctrl[slotIndex] = (signed char) (hash & 0x7f);
+    ::new(&(this->slots[slotIndex])) KeyValuePair<KEYTYPE, VALUETYPE>(kvp);
     this->size++;
 }
 
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE>
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
 void
-HashTable<KEYTYPE, VALUETYPE>::Add(const KEYTYPE& key, const VALUETYPE& value)
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::Add(const KEYTYPE& key, const VALUETYPE& value)
 {
     KeyValuePair<KEYTYPE, VALUETYPE> kvp(key, value);
     this->Add(kvp);
@@ -223,59 +604,88 @@ HashTable<KEYTYPE, VALUETYPE>::Add(const KEYTYPE& key, const VALUETYPE& value)
 
 //------------------------------------------------------------------------------
 /**
+    A slot in a group which still has an empty slot can be marked as empty,
+    because no probe sequence ever continued past that group. Otherwise
+    the slot must be marked as deleted.
 */
-template<class KEYTYPE, class VALUETYPE>
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
 void
-HashTable<KEYTYPE, VALUETYPE>::Erase(const KEYTYPE& key)
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::Erase(const KEYTYPE& key)
 {
     #if NEBULA3_BOUNDSCHECKS
     n_assert(this->size > 0);
     #endif
-    IndexT hashIndex = key.HashCode() % this->hashArray.Size();
-    Array<KeyValuePair<KEYTYPE, VALUETYPE> >& hashElements = this->hashArray[hashIndex];
-    IndexT hashElementIndex = hashElements.BinarySearchIndex(key);
+    IndexT slotIndex = this->FindIndex(key);
     #if NEBULA3_BOUNDSCHECKS
-    n_assert(InvalidIndex != hashElementIndex); // key doesn't exist
+    n_assert(InvalidIndex != slotIndex); // key doesn't exist
     #endif
-    hashElements.EraseIndex(hashElementIndex);
+    this->slots[slotIndex].~KeyValuePair<KEYTYPE, VALUETYPE>();
+    if (0 != MatchEmpty(this->ctrl + (slotIndex & ~(GroupSize - 1))))
+    {
+        this->ctrl[slotIndex] = (signed char) Empty;
+    }
+    else
+    {
+        this->ctrl[slotIndex] = (signed char) Deleted;
+        this->numDeleted++;
+    }
     this->size--;
 }
 
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE>
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
 bool
-HashTable<KEYTYPE, VALUETYPE>::Contains(const KEYTYPE& key) const
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::Contains(const KEYTYPE& key) const
 {
-    if (this->size > 0)
-    {
-        IndexT hashIndex = key.HashCode() % this->hashArray.Size();
-        Array<KeyValuePair<KEYTYPE, VALUETYPE> >& hashElements = this->hashArray[hashIndex];
-        IndexT hashElementIndex = hashElements.BinarySearchIndex(key);
-        return (InvalidIndex != hashElementIndex);
-    }
-    else
-    {
-        return false;
-    }
+    return (InvalidIndex != this->FindIndex(key));
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
+const KEYTYPE&
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::KeyAtIndex(IndexT index) const
+{
+    #if NEBULA3_BOUNDSCHECKS
+    n_assert((index >= 0) && (index < this->capacity) && (this->ctrl[index] >= 0));
+    #endif
+    return this->slots[index].Key();
 }
 
 //------------------------------------------------------------------------------
 /**
 */
-template<class KEYTYPE, class VALUETYPE>
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
+VALUETYPE&
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::ValueAtIndex(IndexT index) const
+{
+    #if NEBULA3_BOUNDSCHECKS
+    n_assert((index >= 0) && (index < this->capacity) && (this->ctrl[index] >= 0));
+    #endif
+    return this->slots[index].Value();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class KEYTYPE, class VALUETYPE, class ALLOCATOR>
 Array<KeyValuePair<KEYTYPE, VALUETYPE> >
-HashTable<KEYTYPE, VALUETYPE>::Content() const
+HashTable<KEYTYPE, VALUETYPE, ALLOCATOR>::Content() const
 {
     Array<KeyValuePair<KEYTYPE, VALUETYPE> > result;
-    int i;
-    int num = this->hashArray.Size();
-    for (i = 0; i < num; i++)
+    if (this->size > 0)
     {
-        if (this->hashArray[i].Size() > 0)
+        result.Reserve(this->size);
+        IndexT i;
+        for (i = 0; i < this->capacity; i++)
         {
-            result.AppendArray(this->hashArray[i]);
+            if (this->ctrl[i] >= 0)
+            {
+                result.Append(this->slots[i]);
+            }
         }
     }
     return result;
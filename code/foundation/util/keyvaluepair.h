@@ -195,5 +195,18 @@ KeyValuePair<KEYTYPE, VALUETYPE>::Value() const
 }
 
 } // namespace Util
+
+//------------------------------------------------------------------------------
+namespace Core
+{
+template<class KEYTYPE, class VALUETYPE> struct TypeTraits<Util::KeyValuePair<KEYTYPE, VALUETYPE> >
+{
+    enum
+    {
+        IsTrivial = TypeTraits<KEYTYPE>::IsTrivial && TypeTraits<VALUETYPE>::IsTrivial,
+        IsRelocatable = TypeTraits<KEYTYPE>::IsRelocatable && TypeTraits<VALUETYPE>::IsRelocatable
+    };
+};
+} // namespace Core
 //------------------------------------------------------------------------------
     
\ No newline at end of file
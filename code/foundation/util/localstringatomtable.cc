@@ -35,7 +35,7 @@ LocalStringAtomTable::Add(const char* str)
 {
     StaticString sstr;
     sstr.ptr = (char*)str;
-    this->table.InsertSorted(sstr);
+    this->table.Add(sstr, sstr.ptr);
 }
 
 } // namespace Util
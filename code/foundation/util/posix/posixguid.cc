@@ -0,0 +1,223 @@
+//------------------------------------------------------------------------------
+//  posixguid.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "util/posix/posixguid.h"
+
+namespace Posix
+{
+using namespace Util;
+    
+//------------------------------------------------------------------------------
+/**
+*/
+void
+PosixGuid::operator=(const PosixGuid& rhs)
+{
+    if (this != &rhs)
+    {
+        Memory::Copy(rhs.uuid, this->uuid, NumBytes);
+    }
+}
+    
+//------------------------------------------------------------------------------
+/**
+    Parses the canonical form "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx".
+*/
+void
+PosixGuid::operator=(const String& rhs)
+{
+    n_assert(rhs.Length() == 36);
+    const char* str = rhs.AsCharPtr();
+    IndexT byteIndex = 0;
+    IndexT i;
+    for (i = 0; i < 36; i++)
+    {
+        if ((8 == i) || (13 == i) || (18 == i) || (23 == i))
+        {
+            n_assert('-' == str[i]);
+            continue;
+        }
+        char c = str[i];
+        unsigned char nibble = 0;
+        if ((c >= '0') && (c <= '9'))      nibble = c - '0';
+        else if ((c >= 'a') && (c <= 'f')) nibble = c - 'a' + 10;
+        else if ((c >= 'A') && (c <= 'F')) nibble = c - 'A' + 10;
+        else n_error("PosixGuid: invalid guid string '%s'!", str);
+        
+        if (0 == (byteIndex & 1))
+        {
+            this->uuid[byteIndex >> 1] = nibble << 4;
+        }
+        else
+        {
+            this->uuid[byteIndex >> 1] |= nibble;
+        }
+        byteIndex++;
+    }
+}
+    
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+PosixGuid::operator==(const PosixGuid& rhs) const
+{
+    return (memcmp(this->uuid, rhs.uuid, NumBytes) == 0);
+}
+    
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+PosixGuid::operator!=(const PosixGuid& rhs) const
+{
+    return (memcmp(this->uuid, rhs.uuid, NumBytes) != 0);
+}
+                
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+PosixGuid::operator<(const PosixGuid& rhs) const
+{
+    return (memcmp(this->uuid, rhs.uuid, NumBytes) < 0);
+}
+    
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+PosixGuid::operator<=(const PosixGuid& rhs) const
+{
+    return (memcmp(this->uuid, rhs.uuid, NumBytes) <= 0);
+}
+    
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+PosixGuid::operator>(const PosixGuid& rhs) const
+{
+    return (memcmp(this->uuid, rhs.uuid, NumBytes) > 0);
+}
+    
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+PosixGuid::operator>=(const PosixGuid& rhs) const
+{
+    return (memcmp(this->uuid, rhs.uuid, NumBytes) >= 0);
+}
+    
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+PosixGuid::IsValid() const
+{
+    IndexT i;
+    for (i = 0; i < NumBytes; i++)
+    {
+        if (0 != this->uuid[i])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+    
+//------------------------------------------------------------------------------
+/**
+    Generates a random (version 4, variant 1) UUID.
+*/
+void
+PosixGuid::Generate()
+{
+    int fd = open("/dev/urandom", O_RDONLY);
+    n_assert(fd >= 0);
+    ssize_t bytesRead = read(fd, this->uuid, NumBytes);
+    close(fd);
+    n_assert(bytesRead == NumBytes);
+    this->uuid[6] = (this->uuid[6] & 0x0f) | 0x40;
+    this->uuid[8] = (this->uuid[8] & 0x3f) | 0x80;
+}
+    
+//------------------------------------------------------------------------------
+/**
+*/
+String
+PosixGuid::AsString() const
+{
+    const unsigned char* u = this->uuid;
+    String result;
+    result.Format("%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x",
+        u[0], u[1], u[2], u[3], u[4], u[5], u[6], u[7],
+        u[8], u[9], u[10], u[11], u[12], u[13], u[14], u[15]);
+    return result;
+}
+    
+//------------------------------------------------------------------------------
+/**
+    This method allows read access to the raw binary data of the uuid.
+    It returns the number of bytes in the buffer, and a pointer to the
+    data.
+*/
+SizeT
+PosixGuid::AsBinary(const unsigned char*& outPtr) const
+{
+    outPtr = this->uuid;
+    return NumBytes;
+}
+    
+//------------------------------------------------------------------------------
+/**
+*/
+PosixGuid
+PosixGuid::FromString(const Util::String& str)
+{
+    PosixGuid newGuid;
+    newGuid = str;
+    return newGuid;
+}
+    
+//------------------------------------------------------------------------------
+/**
+    Constructs the guid from binary data, as returned by the AsBinary().
+*/
+PosixGuid
+PosixGuid::FromBinary(const unsigned char* ptr, SizeT numBytes)
+{
+    n_assert((0 != ptr) && (numBytes == NumBytes));
+    PosixGuid newGuid(ptr, numBytes);
+    return newGuid;
+}
+    
+//------------------------------------------------------------------------------
+/**
+    This method returns a hash code for the uuid, compatible with 
+    Util::HashTable.
+    This is simply copied from String::HashCode...
+*/
+IndexT
+PosixGuid::HashCode() const
+{
+    IndexT hash = 0;
+    const unsigned char* ptr = this->uuid;
+    IndexT i;
+    for (i = 0; i < NumBytes; i++)
+    {
+        hash += ptr[i];
+        hash += hash << 10;
+        hash ^= hash >>  6;
+    }
+    hash += hash << 3;
+    hash ^= hash >> 11;
+    hash += hash << 15;
+    hash &= ~(1<<31);       // don't return a negative number (in case IndexT is defined signed)
+    return hash;
+}
+    
+} // namespace Posix
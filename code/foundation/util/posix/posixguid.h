@@ -0,0 +1,139 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Posix::PosixGuid
+ 
+    POSIX implementation of the Util::Guid class. Stores the 16 raw
+    bytes of the guid, new guids are random (version 4) UUIDs generated
+    from /dev/urandom, so that no uuid library is required.
+ 
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+#include "util/string.h"
+#include "core/sysfunc.h"
+
+//------------------------------------------------------------------------------
+namespace Posix
+{
+class PosixGuid
+{
+public:
+    /// override new operator
+    void* operator new(size_t s);
+    /// override delete operator
+    void operator delete(void* ptr);
+    
+    /// constructor
+    PosixGuid();
+    /// copy constructor
+    PosixGuid(const PosixGuid& rhs);
+    /// construct from raw binary data as returned by AsBinary()
+    PosixGuid(const unsigned char* ptr, SizeT size);
+    /// assignement operator
+    void operator=(const PosixGuid& rhs);
+    /// assignment operator from string
+    void operator=(const Util::String& rhs);
+    /// equality operator
+    bool operator==(const PosixGuid& rhs) const;
+    /// inequlality operator
+    bool operator!=(const PosixGuid& rhs) const;
+    /// less-then operator
+    bool operator<(const PosixGuid& rhs) const;
+    /// less-or-equal operator
+    bool operator<=(const PosixGuid& rhs) const;
+    /// greater-then operator
+    bool operator>(const PosixGuid& rhs) const;
+    /// greater-or-equal operator
+    bool operator>=(const PosixGuid& rhs) const;
+    /// return true if the contained guid is valid (not NIL)
+    bool IsValid() const;
+    /// generate a new guid
+    void Generate();
+    /// construct from string representation
+    static PosixGuid FromString(const Util::String& str);
+    /// construct from binary representation
+    static PosixGuid FromBinary(const unsigned char* ptr, SizeT numBytes);
+    /// get as string
+    Util::String AsString() const;
+    /// get pointer to binary data
+    SizeT AsBinary(const unsigned char*& outPtr) const;
+    /// return the size of the binary representation in bytes
+    static SizeT BinarySize();
+    /// get a hash code (compatible with Util::HashTable)
+    IndexT HashCode() const;
+    
+private:
+    static const SizeT NumBytes = 16;
+    unsigned char uuid[NumBytes];
+};
+    
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void*
+PosixGuid::operator new(size_t size)
+{
+    #if NEBULA3_DEBUG
+    n_assert(size == sizeof(PosixGuid));
+    #endif
+    
+    #if NEBULA3_OBJECTS_USE_MEMORYPOOL
+    return Memory::ObjectPoolAllocator->Alloc(size);
+    #else
+    return Memory::Alloc(Memory::ObjectHeap, size);
+    #endif
+}
+    
+//------------------------------------------------------------------------------
+/**
+*/
+__forceinline void
+PosixGuid::operator delete(void* ptr)
+{
+    #if NEBULA3_OBJECTS_USE_MEMORYPOOL
+    return Memory::ObjectPoolAllocator->Free(ptr, sizeof(PosixGuid));
+    #else
+    return Memory::Free(Memory::ObjectHeap, ptr);
+    #endif
+}
+    
+//------------------------------------------------------------------------------
+/**
+*/
+inline
+PosixGuid::PosixGuid()
+{
+    Memory::Clear(this->uuid, NumBytes);
+}
+    
+//------------------------------------------------------------------------------
+/**
+*/
+inline
+PosixGuid::PosixGuid(const PosixGuid& rhs)
+{
+    Memory::Copy(rhs.uuid, this->uuid, NumBytes);
+}
+    
+//------------------------------------------------------------------------------
+/**
+*/
+inline
+PosixGuid::PosixGuid(const unsigned char* ptr, SizeT size)
+{
+    n_assert((0 != ptr) && (size == NumBytes));
+    Memory::Copy(ptr, this->uuid, NumBytes);
+}
+    
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+PosixGuid::BinarySize()
+{
+    return NumBytes;
+}
+    
+} // namespace Posix
+//------------------------------------------------------------------------------
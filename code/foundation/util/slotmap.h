@@ -0,0 +1,280 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Util::SlotMap
+
+    A table of values which are addressed through generational handles.
+    Add, Erase and handle lookups are O(1). The values are stored
+    contiguously and can be iterated with ValueAtIndex(), erasing a value
+    moves the last value into its place, so the order of values is not
+    stable.
+
+    A handle contains a slot index and the generation of the slot. The
+    generation is incremented whenever a slot is freed, so that stale
+    handles of erased values are detected by IsValid().
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+#include "util/array.h"
+
+//------------------------------------------------------------------------------
+namespace Util
+{
+template<class TYPE> class SlotMap
+{
+public:
+    /// a generational handle to a value
+    typedef uint Handle;
+    /// the invalid handle
+    static const Handle InvalidHandle = 0xffffffff;
+
+    /// constructor
+    SlotMap();
+    /// reserve space for a number of values
+    void Reserve(SizeT num);
+    /// add a value, returns the handle of the value
+    Handle Add(const TYPE& value);
+    /// erase the value of a handle
+    void Erase(Handle handle);
+    /// return true if the handle refers to a value
+    bool IsValid(Handle handle) const;
+    /// access the value of a handle
+    TYPE& operator[](Handle handle) const;
+    /// erase all values, invalidates all handles
+    void Clear();
+
+    /// get number of values
+    SizeT Size() const;
+    /// return true if the slot map contains no values
+    bool IsEmpty() const;
+    /// get value by contiguous index
+    TYPE& ValueAtIndex(IndexT index) const;
+    /// get handle by contiguous index
+    Handle HandleAtIndex(IndexT index) const;
+
+private:
+    static const uint IndexBits = 20;
+    static const uint IndexMask = (1 << IndexBits) - 1;
+    static const uint GenerationMask = 0xfff;
+
+    /// build a handle from slot index and generation
+    static Handle BuildHandle(IndexT slotIndex, uint generation);
+    /// get slot index of a handle
+    static IndexT SlotIndex(Handle handle);
+    /// get generation of a handle
+    static uint Generation(Handle handle);
+
+    struct Slot
+    {
+        IndexT index;           // index into the values, or next free slot
+        uint generation;
+    };
+    Array<Slot> slots;
+    Array<TYPE> values;
+    Array<IndexT> valueSlots;   // slot index for each value
+    IndexT freeSlot;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class TYPE>
+SlotMap<TYPE>::SlotMap() :
+    freeSlot(InvalidIndex)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class TYPE> typename SlotMap<TYPE>::Handle
+SlotMap<TYPE>::BuildHandle(IndexT slotIndex, uint generation)
+{
+    return (generation << IndexBits) | (uint)slotIndex;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class TYPE> IndexT
+SlotMap<TYPE>::SlotIndex(Handle handle)
+{
+    return (IndexT)(handle & IndexMask);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class TYPE> uint
+SlotMap<TYPE>::Generation(Handle handle)
+{
+    return handle >> IndexBits;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class TYPE> void
+SlotMap<TYPE>::Reserve(SizeT num)
+{
+    this->slots.Reserve(num);
+    this->values.Reserve(num);
+    this->valueSlots.Reserve(num);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class TYPE> typename SlotMap<TYPE>::Handle
+SlotMap<TYPE>::Add(const TYPE& value)
+{
+    // get a free slot, or create a new one
+    IndexT slotIndex;
+    if (InvalidIndex != this->freeSlot)
+    {
+        slotIndex = this->freeSlot;
+        this->freeSlot = this->slots[slotIndex].index;
+    }
+    else
+    {
+        slotIndex = this->slots.Size();
+        n_assert(slotIndex < (IndexT)IndexMask);
+        Slot slot;
+        slot.generation = 0;
+        this->slots.Append(slot);
+    }
+
+    Slot& slot = this->slots[slotIndex];
+    slot.index = this->values.Size();
+    this->values.Append(value);
+    this->valueSlots.Append(slotIndex);
+    Handle handle = BuildHandle(slotIndex, slot.generation);
+    n_assert(InvalidHandle != handle);
+    return handle;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class TYPE> void
+SlotMap<TYPE>::Erase(Handle handle)
+{
+    n_assert(this->IsValid(handle));
+    IndexT slotIndex = SlotIndex(handle);
+    Slot& slot = this->slots[slotIndex];
+
+    // move the last value into the gap
+    IndexT valueIndex = slot.index;
+    IndexT lastIndex = this->values.Size() - 1;
+    if (valueIndex != lastIndex)
+    {
+        this->values[valueIndex] = this->values[lastIndex];
+        this->valueSlots[valueIndex] = this->valueSlots[lastIndex];
+        this->slots[this->valueSlots[valueIndex]].index = valueIndex;
+    }
+    this->values.EraseIndex(lastIndex);
+    this->valueSlots.EraseIndex(lastIndex);
+
+    // invalidate existing handles and put the slot on the free list
+    slot.generation = (slot.generation + 1) & GenerationMask;
+    slot.index = this->freeSlot;
+    this->freeSlot = slotIndex;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class TYPE> bool
+SlotMap<TYPE>::IsValid(Handle handle) const
+{
+    if (InvalidHandle == handle)
+    {
+        return false;
+    }
+    IndexT slotIndex = SlotIndex(handle);
+    if (slotIndex >= this->slots.Size())
+    {
+        return false;
+    }
+    const Slot& slot = this->slots[slotIndex];
+    return (slot.generation == Generation(handle)) &&
+           (slot.index >= 0) && (slot.index < this->values.Size()) &&
+           (this->valueSlots[slot.index] == slotIndex);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class TYPE> TYPE&
+SlotMap<TYPE>::operator[](Handle handle) const
+{
+    #if NEBULA3_BOUNDSCHECKS
+    n_assert(this->IsValid(handle));
+    #endif
+    return this->values[this->slots[SlotIndex(handle)].index];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class TYPE> void
+SlotMap<TYPE>::Clear()
+{
+    // invalidate all handles, then chain all slots into the free list
+    this->freeSlot = InvalidIndex;
+    IndexT i;
+    for (i = this->slots.Size() - 1; i >= 0; i--)
+    {
+        Slot& slot = this->slots[i];
+        if (this->IsValid(BuildHandle(i, slot.generation)))
+        {
+            slot.generation = (slot.generation + 1) & GenerationMask;
+        }
+        slot.index = this->freeSlot;
+        this->freeSlot = i;
+    }
+    this->values.Clear();
+    this->valueSlots.Clear();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class TYPE> SizeT
+SlotMap<TYPE>::Size() const
+{
+    return this->values.Size();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class TYPE> bool
+SlotMap<TYPE>::IsEmpty() const
+{
+    return this->values.IsEmpty();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class TYPE> TYPE&
+SlotMap<TYPE>::ValueAtIndex(IndexT index) const
+{
+    return this->values[index];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+template<class TYPE> typename SlotMap<TYPE>::Handle
+SlotMap<TYPE>::HandleAtIndex(IndexT index) const
+{
+    IndexT slotIndex = this->valueSlots[index];
+    return BuildHandle(slotIndex, this->slots[slotIndex].generation);
+}
+
+} // namespace Util
+//------------------------------------------------------------------------------
@@ -1018,5 +1018,6 @@ String::AppendMatrix44(const Math::matrix44& val)
 #endif
     
 } // namespace Util
+__DeclareRelocatableType(Util::String)
 //------------------------------------------------------------------------------
 
@@ -32,16 +32,9 @@ StringAtom::Setup(const char* str)
     #endif
 
     // the string wasn't in the local table (or thread-local tables are disabled), 
-    // so we need to check the global table, this involves thread synchronisation
-    GlobalStringAtomTable* globalTable = GlobalStringAtomTable::Instance();
-    globalTable->Lock();
-    this->content = globalTable->Find(str);
-    if (0 == this->content)
-    {
-        // hrmpf, string isn't in global table either yet, so add it...
-        this->content = globalTable->Add(str);
-    }
-    globalTable->Unlock();
+    // so we need to check the global table, this only takes a lock if the
+    // string isn't in the global table either yet
+    this->content = GlobalStringAtomTable::Instance()->Intern(str);
 
     #if NEBULA3_ENABLE_THREADLOCAL_STRINGATOM_TABLES
         // finally, add the new string to our local table as well, so the
@@ -332,4 +332,5 @@ StringAtom::AsString() const
 }
 
 } // namespace Util
+__DeclareRelocatableType(Util::StringAtom)
 //------------------------------------------------------------------------------
@@ -34,18 +34,40 @@ StringAtomTableBase::Find(const char* str) const
 {
     StaticString sstr;
     sstr.ptr = (char*)str;
-    IndexT i = this->table.BinarySearchIndex(sstr);
+    IndexT i = this->table.FindIndex(sstr);
     if (InvalidIndex == i)
     {
         return 0;
     }
     else
     {
-        return this->table[i].ptr;
-
+        return this->table.ValueAtIndex(i);
     }
 }    
 
+//------------------------------------------------------------------------------
+/**
+    Same hash function as Util::String::HashCode(), so that a StringAtom
+    hashes to the same value as the String it has been created from.
+*/
+IndexT
+StringAtomTableBase::StaticString::HashCode() const
+{
+    IndexT hash = 0;
+    const char* ptr = this->ptr;
+    while (0 != *ptr)
+    {
+        hash += *ptr++;
+        hash += hash << 10;
+        hash ^= hash >>  6;
+    }
+    hash += hash << 3;
+    hash ^= hash >> 11;
+    hash += hash << 15;
+    hash &= ~(1<<31);       // don't return a negative number (in case IndexT is defined signed)
+    return hash;
+}
+
 //------------------------------------------------------------------------------
 /**
 */
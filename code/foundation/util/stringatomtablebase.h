@@ -14,16 +14,18 @@
     already been registered in the thread-local table, the string atom will
     be setup and no locking at all is necessary. Only if the string is
     not in the thread local table, the global string atom table will
-    be consulted (which requires locking). If the string is in the
-    global table, the pointer to the string will be sorted into the
+    be consulted (which only requires locking if the string is new, see
+    GlobalStringAtomTable). If the string is in the
+    global table, the pointer to the string will be added to the
     thread-local atom table and the string will be setup. If the 
     string is completely new (not even in the global atom table),
-    then the string needs to be sorted both into the global, and
-    the thread-local atom table.
+    then the string needs to be added both to the global, and
+    the thread-local atom table. Both tables are hash tables
+    keyed by the string contents.
     
     (C) 2009 Radon Labs GmbH
 */
-#include "util/array.h"
+#include "util/hashtable.h"
 
 //------------------------------------------------------------------------------
 namespace Util
@@ -42,9 +44,11 @@ protected:
     /// find a string pointer in the atom table
     const char* Find(const char* str) const;
 
-    /// a static string class for sorting the array
+    /// a static string class for the hash table
     struct StaticString
     {
+        /// get hash code of the string
+        IndexT HashCode() const;
         /// equality operator
         bool operator==(const StaticString& rhs) const;
         /// inequality operator
@@ -57,7 +61,7 @@ protected:
         char* ptr;
     };
 
-    Util::Array<StaticString> table;
+    Util::HashTable<StaticString, const char*> table;
 };
 
 } // namespace Util
@@ -84,9 +84,16 @@ StringBuffer::AddString(const char* str)
     n_assert(0 != str);
     n_assert(this->IsValid());
 
-    // get string length, must be less then chunk size
+    // a string which doesn't fit into a chunk gets its own chunk,
+    // inserted before the current chunk
     SizeT strLength = strlen(str) + 1;
-    n_assert(strLength < this->chunkSize);
+    if (strLength >= this->chunkSize)
+    {
+        char* bigChunk = (char*) Memory::Alloc(Memory::StringDataHeap, strLength);
+        strcpy(bigChunk, str);
+        this->chunks.Insert(this->chunks.Size() - 1, bigChunk);
+        return bigChunk;
+    }
 
     // check if a new buffer must be allocated
     if ((this->curPointer + strLength) >= (this->chunks.Back() + this->chunkSize))
@@ -474,9 +474,14 @@ AnimSequencer::UpdateTime(Timing::Tick curTime)
     This method should be called once per-frame for each visible animated
     object AFTER UpdateTime() has been called. Actual animation sampling
     and mixing happens here.
+
+    Active anim jobs with a current blend weight below minBlendWeight
+    are not evaluated (used for the animation level-of-detail of 
+    distant characters). The active anim job with the highest blend
+    weight is always evaluated.
 */
 bool
-AnimSequencer::StartAsyncEvaluation(const Ptr<JobPort>& jobPort)
+AnimSequencer::StartAsyncEvaluation(const Ptr<JobPort>& jobPort, float minBlendWeight)
 {
     // clear previous jobs which may still be lying around
     this->jobChain.Clear();
@@ -485,11 +490,23 @@ AnimSequencer::StartAsyncEvaluation(const Ptr<JobPort>& jobPort)
     // exists, sample directly into the destination buffer without mixing
     IndexT i;
     IndexT numActiveAnimJobs = 0;
+    IndexT maxWeightAnimJobIndex = InvalidIndex;
+    float maxWeight = 0.0f;
     for (i = 0; i < this->animJobs.Size(); i++)
     {
-        if (this->animJobs[i]->IsActive(this->time))
+        const Ptr<AnimJob>& animJob = this->animJobs[i];
+        if (animJob->IsActive(this->time))
         {
             numActiveAnimJobs++;
+            if (minBlendWeight > 0.0f)
+            {
+                float weight = animJob->ComputeBlendWeight(animJob->curRelEvalTime);
+                if ((InvalidIndex == maxWeightAnimJobIndex) || (weight > maxWeight))
+                {
+                    maxWeightAnimJobIndex = i;
+                    maxWeight = weight;
+                }
+            }
         }
     }
 
@@ -504,7 +521,7 @@ AnimSequencer::StartAsyncEvaluation(const Ptr<JobPort>& jobPort)
         bool firstActiveAnimJob = true;
         for (i = 0; i < this->animJobs.Size(); i++)
         {
-            if (this->animJobs[i]->IsActive(this->time))
+            if (this->MustEvaluateAnimJob(i, minBlendWeight, maxWeightAnimJobIndex))
             {
                 if (firstActiveAnimJob)
                 {
@@ -532,6 +549,28 @@ AnimSequencer::StartAsyncEvaluation(const Ptr<JobPort>& jobPort)
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+    Return true if an anim job is active and its current blend weight
+    is not below the minimum blend weight. The anim job with the highest
+    blend weight is never skipped, so that at least one anim job
+    contributes to the result.
+*/
+bool
+AnimSequencer::MustEvaluateAnimJob(IndexT animJobIndex, float minBlendWeight, IndexT maxWeightAnimJobIndex) const
+{
+    const Ptr<AnimJob>& animJob = this->animJobs[animJobIndex];
+    if (!animJob->IsActive(this->time))
+    {
+        return false;
+    }
+    if ((minBlendWeight <= 0.0f) || (animJobIndex == maxWeightAnimJobIndex))
+    {
+        return true;
+    }
+    return animJob->ComputeBlendWeight(animJob->curRelEvalTime) >= minBlendWeight;
+}
+
 //------------------------------------------------------------------------------
 /**
 */
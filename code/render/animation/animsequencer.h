@@ -51,12 +51,14 @@ public:
     /// update the animation sequencer time
     void UpdateTime(Timing::Tick time);
     /// start asynchronous animation update, returns false if nothing had to be done
-    bool StartAsyncEvaluation(const Ptr<Jobs::JobPort>& jobPort);
+    bool StartAsyncEvaluation(const Ptr<Jobs::JobPort>& jobPort, float minBlendWeight = 0.0f);
 
     /// get the currently set time
     Timing::Tick GetTime() const;
     /// get the final sampled result of the last evaluation
     const Ptr<CoreAnimation::AnimSampleBuffer>& GetResult() const;
+    /// get the job chain started by the last StartAsyncEvaluation(), the last job writes the result
+    const Util::Array<Ptr<Jobs::Job> >& GetEvaluationJobs() const;
     /// get pointer to animation resource object
     const Ptr<CoreAnimation::AnimResource>& GetAnimResource() const;
     /// get all anim jobs
@@ -82,6 +84,8 @@ private:
     void RemoveExpiredAnimJobs(Timing::Tick time);
     /// update active animjobs times
     void UpdateTimeActiveAnimJobs(Timing::Tick time);
+    /// return true if an active anim job must be evaluated (see StartAsyncEvaluation)
+    bool MustEvaluateAnimJob(IndexT animJobIndex, float minBlendWeight, IndexT maxWeightAnimJobIndex) const;
 
     /// FIXME FIXME FIXME: helper method, for determining dominating job
     IndexT FindDominatingAnimJobIndex(Timing::Tick startTime, Timing::Tick endTime) const;
@@ -142,6 +146,15 @@ AnimSequencer::GetResult() const
     return this->dstSampleBuffer;
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+inline const Util::Array<Ptr<Jobs::Job> >&
+AnimSequencer::GetEvaluationJobs() const
+{
+    return this->jobChain;
+}
+
 //------------------------------------------------------------------------------
 /**
 */
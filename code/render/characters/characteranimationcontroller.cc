@@ -70,7 +70,7 @@ CharacterAnimationController::SetupAnimDrivenMotion(IndexT jointIndex)
     // NOTE: we're overwriting the same anim resource several 
     // times here, it would be better to handle this offline
     // during asset export!
-    float4* keys = animRes->GetKeyBuffer()->GetKeyBufferPointer();
+    uchar* keys = animRes->GetKeyBuffer()->GetKeyBufferPointer();
     IndexT translationCurveIndex = this->animDrivenMotionJointIndex * 4;
     float4 nullVec(0.0f, 0.0f, 0.0f, 0.0f);
     IndexT clipIndex;
@@ -82,15 +82,20 @@ CharacterAnimationController::SetupAnimDrivenMotion(IndexT jointIndex)
         {
             curve.SetStaticKey(nullVec);
         }
+        else if (KeyFormat::Float4 != curve.GetKeyFormat())
+        {
+            // quantized keys dequantize to the key bias if the key scale is 0
+            curve.SetKeyQuantization(nullVec, nullVec);
+        }
         else
         {
-            IndexT firstKeyIndex = curve.GetFirstKeyIndex();
+            IndexT firstKeyOffset = curve.GetFirstKeyOffset();
             SizeT keyStride = clip.GetKeyStride();
             SizeT numKeys = clip.GetNumKeys();
             IndexT i;
             for (i = 0; i < numKeys; i++)
             {
-                keys[firstKeyIndex + i * keyStride] = nullVec;
+                nullVec.storeu((scalar*)(keys + firstKeyOffset + i * keyStride));
             }
         }
     }
@@ -112,13 +117,16 @@ CharacterAnimationController::Discard()
 /**
     Update the character's animation. This method must be called once
     per frame *after* starting or stopping animations! The method will
-    return false if no animation is currently active.
+    return false if no animation is currently active, or if evaluate
+    is false (animation lod: the time is updated, but the animation 
+    is not sampled this frame). Anim jobs with a current blend weight
+    below minBlendWeight are not sampled.
 */
 bool
-CharacterAnimationController::Update(Timing::Tick t)
+CharacterAnimationController::Update(Timing::Tick t, bool evaluate, float minBlendWeight)
 {
     this->animSequencer.UpdateTime(t);
-    if (this->animSequencer.StartAsyncEvaluation(this->extJobPort))
+    if (evaluate && this->animSequencer.StartAsyncEvaluation(this->extJobPort, minBlendWeight))
     {
         this->animDrivenMotionVectorDirty = true;
         return true;
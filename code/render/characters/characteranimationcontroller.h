@@ -50,8 +50,8 @@ public:
 private:
     friend class CharacterInstance;
 
-    /// update the animation controller
-    bool Update(Timing::Tick time);
+    /// update the animation controller, optionally start evaluating the animation
+    bool Update(Timing::Tick time, bool evaluate, float minBlendWeight);
     /// update the anim-driven motion vector (called by Update)
     void UpdateAnimDrivenMotionVector();
     /// get the time which is currently set in the anim controller
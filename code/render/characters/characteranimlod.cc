@@ -0,0 +1,63 @@
+//------------------------------------------------------------------------------
+//  characteranimlod.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "characters/characteranimlod.h"
+
+namespace Characters
+{
+
+//------------------------------------------------------------------------------
+/**
+*/
+CharacterAnimLod::CharacterAnimLod() :
+    enabled(true)
+{
+    this->SetupLevel(Full, 0.25f, 1, 0.0f, false);
+    this->SetupLevel(Reduced, 0.1f, 2, 0.05f, false);
+    this->SetupLevel(Low, 0.04f, 3, 0.1f, true);
+    this->SetupLevel(Lowest, 0.0f, 4, 0.2f, true);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Setup the parameters of a level. The minimum screen sizes must
+    decrease with the level, and the update interval must be at least 1.
+*/
+void
+CharacterAnimLod::SetupLevel(Level level, float minScreenSize, SizeT updateInterval, float minBlendWeight, bool skipDetailJoints)
+{
+    n_assert(level < NumLevels);
+    n_assert(updateInterval > 0);
+    LevelParams& params = this->levels[level];
+    params.minScreenSize = minScreenSize;
+    params.updateInterval = updateInterval;
+    params.minBlendWeight = minBlendWeight;
+    params.skipDetailJoints = skipDetailJoints;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns the first level whose minimum screen size is reached, or the
+    last level.
+*/
+CharacterAnimLod::Level
+CharacterAnimLod::SelectLevel(float screenSize) const
+{
+    if (!this->enabled)
+    {
+        return Full;
+    }
+    IndexT i;
+    for (i = 0; i < NumLevels - 1; i++)
+    {
+        if (screenSize >= this->levels[i].minScreenSize)
+        {
+            return (Level) i;
+        }
+    }
+    return (Level) (NumLevels - 1);
+}
+
+} // namespace Characters
@@ -0,0 +1,131 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Characters::CharacterAnimLod
+
+    Describes the animation level-of-detail of characters. The level
+    of a visible character is selected by its screen size (the height of
+    its bounding sphere projected to the screen, relative to the screen
+    height). Each level defines:
+
+    - the skeleton update interval in frames, between updates the skin
+      matrix palette is interpolated from the last 2 evaluated palettes
+    - the minimum blend weight of anim jobs, anim jobs with a lower
+      current blend weight are not sampled
+    - whether detail joints (fingers, face, ...) are evaluated or
+      simply follow their parent joint
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+
+//------------------------------------------------------------------------------
+namespace Characters
+{
+class CharacterAnimLod
+{
+public:
+    /// animation lod levels
+    enum Level
+    {
+        Full = 0,           // full update rate, all anim jobs and joints
+        Reduced,
+        Low,
+        Lowest,
+
+        NumLevels,
+    };
+
+    /// constructor, sets up the default levels
+    CharacterAnimLod();
+
+    /// enable/disable animation lod (if disabled, all characters use the Full level)
+    void SetEnabled(bool b);
+    /// return true if animation lod is enabled
+    bool IsEnabled() const;
+    /// setup a level
+    void SetupLevel(Level level, float minScreenSize, SizeT updateInterval, float minBlendWeight, bool skipDetailJoints);
+    /// select the level for a screen size
+    Level SelectLevel(float screenSize) const;
+
+    /// get the minimum screen size of a level
+    float GetMinScreenSize(Level level) const;
+    /// get the skeleton update interval in frames of a level
+    SizeT GetUpdateInterval(Level level) const;
+    /// get the minimum anim job blend weight of a level
+    float GetMinBlendWeight(Level level) const;
+    /// return true if detail joints are skipped at a level
+    bool GetSkipDetailJoints(Level level) const;
+
+private:
+    struct LevelParams
+    {
+        float minScreenSize;
+        SizeT updateInterval;
+        float minBlendWeight;
+        bool skipDetailJoints;
+    };
+    LevelParams levels[NumLevels];
+    bool enabled;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+CharacterAnimLod::SetEnabled(bool b)
+{
+    this->enabled = b;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+CharacterAnimLod::IsEnabled() const
+{
+    return this->enabled;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline float
+CharacterAnimLod::GetMinScreenSize(Level level) const
+{
+    n_assert(level < NumLevels);
+    return this->levels[level].minScreenSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+CharacterAnimLod::GetUpdateInterval(Level level) const
+{
+    n_assert(level < NumLevels);
+    return this->levels[level].updateInterval;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline float
+CharacterAnimLod::GetMinBlendWeight(Level level) const
+{
+    n_assert(level < NumLevels);
+    return this->levels[level].minBlendWeight;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+CharacterAnimLod::GetSkipDetailJoints(Level level) const
+{
+    n_assert(level < NumLevels);
+    return this->levels[level].skipDetailJoints;
+}
+
+} // namespace Characters
+//------------------------------------------------------------------------------
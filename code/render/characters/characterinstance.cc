@@ -13,6 +13,7 @@
 #include "internalgraphics/internalmodelentity.h"
 #include "internalgraphics/internalgraphicsserver.h"
 #include "characters/skinnedmeshrenderer.h"
+#include "characters/characterserver.h"
 
 // for debug visualization
 #include "coregraphics/shaperenderer.h"
@@ -29,12 +30,17 @@ using namespace CoreGraphics;
 using namespace InternalGraphics;
 using namespace Jobs;
 
+IndexT CharacterInstance::nextAnimLodPhase = 0;
+
 //------------------------------------------------------------------------------
 /**
 */
 CharacterInstance::CharacterInstance():
     updateFrameIndex(InvalidIndex),
     updateTime(InvalidIndex),
+    animLodLevel(CharacterAnimLod::Full),
+    lastStartUpdateFrameIndex(InvalidIndex),
+    animLodPhase(0),
     jointTextureRowIndex(InvalidIndex),
     isValidForRendering(false)
 {
@@ -70,6 +76,8 @@ CharacterInstance::Setup(const Ptr<Character>& origCharacter, const Ptr<Models::
     this->animController.Setup(this->jobPort, origCharacter->AnimationLibrary());
     this->skeletonInst.Setup(origCharacter->Skeleton());
     this->variationSet.Setup("", origCharacter->VariationLibrary());
+    this->animLodPhase = nextAnimLodPhase;
+    nextAnimLodPhase = (nextAnimLodPhase + 1) & 0xffff;
 
     // for joint texture use, register our character  instance
     SkinnedMeshRenderer* skinRenderer = SkinnedMeshRenderer::Instance();
@@ -87,6 +95,12 @@ CharacterInstance::Discard()
 {
     n_assert(this->IsValid());    
 
+    // a batched skeleton evaluation may still write into the skeleton instance
+    if (this->batchJobPort.isvalid())
+    {
+        this->batchJobPort->WaitDone();
+        this->batchJobPort = 0;
+    }
     this->skeletonInst.Discard();
     this->skinSet.Discard();
     this->animController.Discard();
@@ -129,6 +143,18 @@ CharacterInstance::PrepareUpdate(Timing::Tick time, IndexT frameIndex)
 //------------------------------------------------------------------------------
 /**
     Start asynchronous update of the character instance skeleton.
+
+    At the Full animation lod level, the animation is sampled and the
+    skeleton is evaluated every frame. At reduced levels this only happens
+    every few frames (the update interval of the level), the skeleton is
+    evaluated into a key palette and the joint and skin matrices
+    are interpolated between the last 2 key palettes. Interpolation
+    restarts if the character hasn't been updated in the previous frame.
+
+    With batched skeleton evaluation, the evaluation is added to the
+    CharacterSkeletonBatcher, which pushes the evaluation job (and the
+    blend job if a key palette is evaluated) after all visible characters
+    have been started.
 */
 void
 CharacterInstance::StartUpdate()
@@ -136,18 +162,39 @@ CharacterInstance::StartUpdate()
     n_assert(this->IsValid());
     n_assert(InvalidIndex != this->updateFrameIndex);
     this->isValidForRendering = true;
-    
+
+    // get the animation lod parameters
+    CharacterServer* charServer = CharacterServer::Instance();
+    const CharacterAnimLod& animLod = charServer->AnimLod();
+    SizeT updateInterval = animLod.GetUpdateInterval(this->animLodLevel);
+    float minBlendWeight = animLod.GetMinBlendWeight(this->animLodLevel);
+    bool skipDetailJoints = animLod.GetSkipDetailJoints(this->animLodLevel);
+    bool interpolate = (updateInterval > 1);
+    if (!interpolate || (this->updateFrameIndex != (this->lastStartUpdateFrameIndex + 1)))
+    {
+        this->skeletonInst.InvalidateKeys();
+    }
+    this->lastStartUpdateFrameIndex = this->updateFrameIndex;
+    IndexT keyFrame = (this->updateFrameIndex + this->animLodPhase) % updateInterval;
+    bool evaluate = !interpolate || !this->skeletonInst.HasKeys() || (0 == keyFrame);
+
     const float4* samplesPtr = 0;
     SizeT numSamples = 0;
-    bool animUpdateValid = this->animController.Update(this->updateTime);
+    Ptr<Job> animJob;
+    bool animUpdateValid = this->animController.Update(this->updateTime, evaluate, minBlendWeight);
     if (animUpdateValid)
     {
         // animation sample result is valid
         const Ptr<AnimSampleBuffer>& animSampleBuffer = this->animController.AnimSequencer().GetResult();
         numSamples = animSampleBuffer->GetNumSamples();
         samplesPtr = animSampleBuffer->GetSamplesPointer();
+        const Array<Ptr<Job> >& animJobs = this->animController.AnimSequencer().GetEvaluationJobs();
+        if (!animJobs.IsEmpty())
+        {
+            animJob = animJobs.Back();
+        }
     }
-    else
+    else if (evaluate)
     {
         // animation sample result is invalid, use jesus pose
         const FixedArray<float4>& defaultSamples = this->character->Skeleton().GetDefaultSamplesArray();
@@ -164,12 +211,56 @@ CharacterInstance::StartUpdate()
         jointTextureRowPtr = skinRenderer->AcquireJointTextureRowPointer(this, jointTextureRowSize);
     }
 
-    // evaluate the skeleton (updates skinning matrices)
-    n_assert(0 != samplesPtr);
-    this->skeletonInst.EvaluateAsync(this->jobPort, 
-                                     samplesPtr, numSamples, 
-                                     jointTextureRowPtr, jointTextureRowSize,
-                                     animUpdateValid);
+    CharacterSkeletonBatcher& batcher = charServer->SkeletonBatcher();
+    bool batched = evaluate && batcher.IsEnabled();
+    this->batchJobPort = batched ? batcher.GetJobPort() : Ptr<JobPort>();
+    if (!interpolate)
+    {
+        // evaluate the skeleton (updates skinning matrices)
+        n_assert(0 != samplesPtr);
+        if (batched)
+        {
+            this->skeletonInst.EvaluateBatched(batcher, animJob,
+                                               samplesPtr, numSamples,
+                                               skipDetailJoints,
+                                               jointTextureRowPtr);
+        }
+        else
+        {
+            this->skeletonInst.EvaluateAsync(this->jobPort, 
+                                             samplesPtr, numSamples, 
+                                             skipDetailJoints,
+                                             jointTextureRowPtr, jointTextureRowSize,
+                                             animUpdateValid);
+        }
+    }
+    else
+    {
+        // evaluate the next key palette if necessary, and interpolate the skinning matrices
+        float blendFactor = float(keyFrame) / float(updateInterval);
+        if (batched)
+        {
+            // the batcher pushes the blend job after the batched evaluation
+            n_assert(0 != samplesPtr);
+            this->skeletonInst.EvaluateKeyBatched(batcher, animJob,
+                                                  samplesPtr, numSamples,
+                                                  skipDetailJoints,
+                                                  this->jobPort, blendFactor,
+                                                  jointTextureRowPtr, jointTextureRowSize);
+        }
+        else
+        {
+            if (evaluate)
+            {
+                n_assert(0 != samplesPtr);
+                this->skeletonInst.EvaluateKeyAsync(this->jobPort,
+                                                    samplesPtr, numSamples,
+                                                    skipDetailJoints,
+                                                    animUpdateValid);
+            }
+            this->skeletonInst.BlendKeysAsync(this->jobPort, blendFactor, jointTextureRowPtr, jointTextureRowSize, Ptr<Job>());
+        }
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -179,6 +270,10 @@ CharacterInstance::StartUpdate()
 void
 CharacterInstance::WaitUpdateDone() const
 {
+    if (this->batchJobPort.isvalid() && !this->batchJobPort->CheckDone())
+    {
+        this->batchJobPort->WaitDone();
+    }
     if (!this->jobPort->CheckDone())
     {
         // n_printf("WARNING: CharacterInstance waiting for async update!\n");
@@ -193,6 +288,10 @@ CharacterInstance::WaitUpdateDone() const
 bool
 CharacterInstance::CheckUpdateDone() const
 {
+    if (this->batchJobPort.isvalid() && !this->batchJobPort->CheckDone())
+    {
+        return false;
+    }
     return this->jobPort->CheckDone();
 }
 
@@ -203,7 +302,7 @@ CharacterInstance::CheckUpdateDone() const
 void
 CharacterInstance::RenderDebug(const matrix44& modelTransform)
 {
-    if (this->jobPort->CheckDone())
+    if (this->CheckUpdateDone())
     {
         this->skeletonInst.RenderDebug(modelTransform);
     }       
@@ -4,6 +4,17 @@
     @class Characters::CharacterInstance
     
     Contains the per-instance data of a character.
+
+    Characters at a reduced animation level-of-detail (selected by the
+    CharacterServer) only sample their animation and evaluate their 
+    skeleton every few frames, the joint and skin matrices are 
+    interpolated in between. The frames in which the skeleton is
+    evaluated are staggered across the character instances.
+
+    If batched skeleton evaluation is enabled, the skeleton is evaluated
+    together with other instances of the same skeleton by a job of the
+    CharacterSkeletonBatcher, instead of by a job on the instance's own
+    job port.
         
     (C) 2008 Radon Labs GmbH
 */
@@ -12,6 +23,7 @@
 #include "characters/characterskinset.h"
 #include "characters/charactervariationset.h"
 #include "characters/characteranimationcontroller.h"
+#include "characters/characteranimlod.h"
 #include "jobs/jobport.h"
 
 //------------------------------------------------------------------------------
@@ -57,12 +69,16 @@ public:
     bool IsValidForRendering() const;
     /// get character joint texture row index (for GPUTextureSkinning)
     IndexT GetJointTextureRowIndex() const;
+    /// get the animation lod level of the current frame
+    CharacterAnimLod::Level GetAnimLodLevel() const;
 
 private:
     friend class CharacterServer;
 
     /// prepare the next update, returns true if update would be redundant
     bool PrepareUpdate(Timing::Tick time, IndexT frameIndex);
+    /// set the animation lod level for the next update
+    void SetAnimLodLevel(CharacterAnimLod::Level level);
     /// update the character instance
     void StartUpdate();
 
@@ -73,8 +89,13 @@ private:
     CharacterAnimationController animController;
     IndexT updateFrameIndex;
     Timing::Tick updateTime;
+    CharacterAnimLod::Level animLodLevel;
+    IndexT lastStartUpdateFrameIndex;
+    IndexT animLodPhase;                // staggers the skeleton evaluations at reduced animation lod
+    static IndexT nextAnimLodPhase;
     IndexT jointTextureRowIndex;
     Ptr<Jobs::JobPort> jobPort;
+    Ptr<Jobs::JobPort> batchJobPort;    // job port of the batched skeleton evaluation of the current frame
     bool isValidForRendering;
     //CharacterTextureSet textureSet;
     CharacterVariationSet variationSet;
@@ -134,6 +155,24 @@ CharacterInstance::GetJointTextureRowIndex() const
     return this->jointTextureRowIndex;
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+inline CharacterAnimLod::Level
+CharacterInstance::GetAnimLodLevel() const
+{
+    return this->animLodLevel;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+CharacterInstance::SetAnimLodLevel(CharacterAnimLod::Level level)
+{
+    this->animLodLevel = level;
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -4,6 +4,9 @@
 //------------------------------------------------------------------------------
 #include "stdneb.h"
 #include "characters/characterserver.h"
+#include "coregraphics/transformdevice.h"
+#include "models/modelinstance.h"
+#include "internalgraphics/internalmodelentity.h"
 
 namespace Characters
 {
@@ -12,11 +15,13 @@ __ImplementSingleton(Characters::CharacterServer);
 
 using namespace Util;
 using namespace CoreGraphics;
+using namespace Math;
 
 //------------------------------------------------------------------------------
 /**
 */
 CharacterServer::CharacterServer() :
+    projYScale(1.0f),
     curFrameIndex(InvalidIndex),
     isValid(false),
     inFrame(false),
@@ -45,6 +50,7 @@ CharacterServer::Setup()
     this->isValid = true;
     this->skinnedMeshRenderer = SkinnedMeshRenderer::Create();
     this->skinnedMeshRenderer->Setup();
+    this->skeletonBatcher.Setup();
 }
 
 //------------------------------------------------------------------------------
@@ -55,6 +61,7 @@ CharacterServer::Discard()
 {
     n_assert(this->isValid);
     n_assert(this->visCharInstArray.IsEmpty());
+    this->skeletonBatcher.Discard();
     this->skinnedMeshRenderer->Discard();
     this->skinnedMeshRenderer = 0;
     this->isValid = false;    
@@ -100,6 +107,11 @@ CharacterServer::BeginGather()
 
     this->inGather = true;
     this->skinnedMeshRenderer->BeginGatherSkins();
+
+    // get the camera for the animation lod selection
+    TransformDevice* transformDevice = TransformDevice::Instance();
+    this->viewTransform = transformDevice->GetViewTransform();
+    this->projYScale = transformDevice->GetProjTransform().getrow1().y();
 }
 
 //------------------------------------------------------------------------------
@@ -115,10 +127,38 @@ CharacterServer::GatherVisibleCharacter(const Ptr<CharacterInstance>& charInst,
     Timing::Tick ticks = Timing::SecondsToTicks(time);
     if (charInst->PrepareUpdate(ticks, this->curFrameIndex))
     {
+        // select the animation lod level from the screen size of the model
+        CharacterAnimLod::Level animLodLevel = CharacterAnimLod::Full;
+        const Ptr<Models::ModelInstance>& modelInst = charInst->modelInstance;
+        if (this->animLod.IsEnabled() && modelInst.isvalid() && modelInst->GetModelEntity().isvalid())
+        {
+            float screenSize = this->ComputeScreenSize(modelInst->GetModelEntity()->GetGlobalBoundingBox());
+            animLodLevel = this->animLod.SelectLevel(screenSize);
+        }
+        charInst->SetAnimLodLevel(animLodLevel);
         this->visCharInstArray.Append(charInst);
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+    Computes the projected height of the bounding sphere of a box relative
+    to the screen height. Returns 1.0 if the camera is inside the
+    bounding sphere.
+*/
+float
+CharacterServer::ComputeScreenSize(const bbox& box) const
+{
+    scalar radius = box.extents().length();
+    float4 viewPos = matrix44::transform(box.center(), this->viewTransform);
+    scalar depth = -viewPos.z();
+    if (depth <= radius)
+    {
+        return 1.0f;
+    }
+    return n_min(1.0f, (radius * this->projYScale) / depth);
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -144,17 +184,22 @@ CharacterServer::EndGather()
 //------------------------------------------------------------------------------
 /**
     Start updating character skeletons. This is an asynchronous operation!        
+    The skeleton evaluations are collected by the skeleton batcher and
+    pushed as one job per skeleton after all characters have started
+    their animation jobs.
 */
 void
 CharacterServer::StartUpdateCharacterSkeletons()
 {
     n_assert(!this->inGather)
+    this->skeletonBatcher.Begin();
     IndexT i;
     SizeT num = this->visCharInstArray.Size();
     for (i = 0; i < num; i++)
     {
         this->visCharInstArray[i]->StartUpdate();
     }
+    this->skeletonBatcher.End();
 }
 
 //------------------------------------------------------------------------------
@@ -4,12 +4,19 @@
     @class Characters::CharacterServer
   
     Handles central aspects of the character system.
+
+    The server also selects the animation level-of-detail of visible
+    characters from their screen size (see CharacterAnimLod), and
+    batches the skeleton evaluations of visible characters with the
+    same skeleton (see CharacterSkeletonBatcher).
     
     (C) 2009 Radon Labs GmbH
 */    
 #include "core/refcounted.h"
 #include "core/singleton.h"
 #include "characters/characterinstance.h"
+#include "characters/characteranimlod.h"
+#include "characters/characterskeletonbatcher.h"
 #include "characters/skinningtechnique.h"
 #include "characters/skinnedmeshrenderer.h"
 #include "timing/time.h"
@@ -36,6 +43,10 @@ public:
 
     /// get the skinning technique used by this platform
     SkinningTechnique::Code GetSkinningTechnique() const;    
+    /// access to the animation level-of-detail settings
+    CharacterAnimLod& AnimLod();
+    /// access to the batched skeleton evaluation
+    CharacterSkeletonBatcher& SkeletonBatcher();
 
     /// begin frame
     void BeginFrame(IndexT frameIndex);
@@ -69,7 +80,14 @@ public:
     void EndFrame();    
 
 private:
+    /// compute the screen size of a bounding box (relative to the screen height)
+    float ComputeScreenSize(const Math::bbox& box) const;
+
     Ptr<SkinnedMeshRenderer> skinnedMeshRenderer;
+    CharacterAnimLod animLod;
+    CharacterSkeletonBatcher skeletonBatcher;
+    Math::matrix44 viewTransform;       // camera view transform of the current gather phase
+    float projYScale;                   // y scale of the camera projection of the current gather phase
     Util::Array<Ptr<CharacterInstance> > visCharInstArray;
     IndexT curFrameIndex;
     bool isValid;
@@ -96,5 +114,23 @@ CharacterServer::GetSkinningTechnique() const
     return this->skinnedMeshRenderer->GetSkinningTechnique();
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+inline CharacterAnimLod&
+CharacterServer::AnimLod()
+{
+    return this->animLod;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline CharacterSkeletonBatcher&
+CharacterServer::SkeletonBatcher()
+{
+    return this->skeletonBatcher;
+}
+
 } // namespace Characters
 //------------------------------------------------------------------------------
@@ -4,12 +4,19 @@
 //------------------------------------------------------------------------------
 #include "stdneb.h"
 #include "characters/characterskeleton.h"
+#include "util/round.h"
 
 namespace Characters
 {
 using namespace Util;
 using namespace Math;
 
+// joint name patterns of detail joints (matched against the lower-case joint name)
+static const char* DetailJointPatterns[] = 
+{
+    "*finger*", "*thumb*", "*toe*", "*face*", "*jaw*", "*eye*", "*brow*", "*lid*", "*lip*", "*cheek*", "*tongue*", 0
+};
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -39,6 +46,10 @@ CharacterSkeleton::Setup(SizeT numJoints)
     this->jointArray.SetSize(numJoints);
     this->jointIndexMap.Reserve(numJoints);
     this->defaultSamplesArray.SetSize(numJoints * 4);
+    this->noSkipJointArray.SetSize(Round::RoundUp16(numJoints));
+    this->noSkipJointArray.Fill(0);
+    this->detailSkipJointArray.SetSize(Round::RoundUp16(numJoints));
+    this->detailSkipJointArray.Fill(0);
     this->isValid = true;
 }
 
@@ -53,10 +64,14 @@ CharacterSkeleton::Discard()
     this->jointArray.Clear();
     this->jointIndexMap.Clear();
     this->invPoseMatrixArray.Clear();
+    this->noSkipJointArray.Clear();
+    this->detailSkipJointArray.Clear();
 }
 
 //------------------------------------------------------------------------------
 /**
+    NOTE: joints must be setup in hierarchy order (parent joints before
+    their child joints).
 */
 void
 CharacterSkeleton::SetupJoint(IndexT jointIndex, IndexT parentJointIndex, const point& poseTranslation, const quaternion& poseRotation, const vector& poseScale, const StringAtom& name)
@@ -80,6 +95,36 @@ CharacterSkeleton::SetupJoint(IndexT jointIndex, IndexT parentJointIndex, const
     this->defaultSamplesArray[jointIndex * 4 + 1].load((const float*)&poseRotation);
     this->defaultSamplesArray[jointIndex * 4 + 2] = poseScale;
     this->defaultSamplesArray[jointIndex * 4 + 3] = vector::nullvec();  // velocity
+
+    // flag detail joints, the children of detail joints are detail joints as well,
+    // the root joint is never a detail joint
+    if (InvalidIndex != parentJointIndex)
+    {
+        n_assert(parentJointIndex < jointIndex);
+        if ((0 != this->detailSkipJointArray[parentJointIndex]) || IsDetailJointName(name))
+        {
+            this->detailSkipJointArray[jointIndex] = 1;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+CharacterSkeleton::IsDetailJointName(const StringAtom& name)
+{
+    String lowerName = name.AsString();
+    lowerName.ToLower();
+    IndexT i;
+    for (i = 0; 0 != DetailJointPatterns[i]; i++)
+    {
+        if (String::MatchPattern(lowerName, DetailJointPatterns[i]))
+        {
+            return true;
+        }
+    }
+    return false;
 }
 
 } // namespace Characters
\ No newline at end of file
@@ -5,6 +5,11 @@
     
     Contains the skeleton data of a character which is shared between all
     instances of the character.
+
+    Joints which only add small details (fingers, toes, face joints) and
+    all of their child joints are flagged as detail joints by their name.
+    Detail joints may be skipped during skeleton evaluation when a
+    character is rendered at a low animation level-of-detail.
     
     (C) 2008 Radon Labs GmbH
 */
@@ -43,10 +48,19 @@ public:
     const Util::FixedArray<Math::matrix44>& GetInvPoseMatrixArray() const;
     /// get pointer to default samples if no valid anim is set on character 
     const Util::FixedArray<Math::float4>& GetDefaultSamplesArray() const;
+    /// return true if a joint is a detail joint
+    bool IsDetailJoint(IndexT jointIndex) const;
+    /// get the per-joint skip flags for the skeleton evaluation job (padded to 16 bytes)
+    const Util::FixedArray<uchar>& GetJointSkipArray(bool skipDetailJoints) const;
 
 private:
+    /// return true if a joint name matches one of the detail joint patterns
+    static bool IsDetailJointName(const Util::StringAtom& name);
+
     Util::FixedArray<Math::float4> defaultSamplesArray;  // used as sample result if no valid animation exists to provide samples
     Util::FixedArray<Math::matrix44> invPoseMatrixArray;
+    Util::FixedArray<uchar> noSkipJointArray;       // all joints evaluated
+    Util::FixedArray<uchar> detailSkipJointArray;   // detail joints skipped
     Util::FixedArray<CharacterJoint> jointArray;
     Util::Dictionary<Util::StringAtom, IndexT> jointIndexMap;
     bool isValid;
@@ -118,6 +132,27 @@ CharacterSkeleton::GetDefaultSamplesArray() const
     return this->defaultSamplesArray;
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+CharacterSkeleton::IsDetailJoint(IndexT jointIndex) const
+{
+    return 0 != this->detailSkipJointArray[jointIndex];
+}
+
+//------------------------------------------------------------------------------
+/**
+    The skip array contains one byte per joint, a non-zero value
+    means that the joint is not evaluated, and simply follows its
+    parent joint.
+*/
+inline const Util::FixedArray<uchar>&
+CharacterSkeleton::GetJointSkipArray(bool skipDetailJoints) const
+{
+    return skipDetailJoints ? this->detailSkipJointArray : this->noSkipJointArray;
+}
+
 } // namespace Characters
 //------------------------------------------------------------------------------
     
\ No newline at end of file
@@ -0,0 +1,252 @@
+//------------------------------------------------------------------------------
+//  characterskeletonbatcher.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "characters/characterskeletonbatcher.h"
+#include "characters/characterskeleton.h"
+#include "characters/characterskeletoninstance.h"
+
+namespace Characters
+{
+using namespace Util;
+using namespace Math;
+using namespace Jobs;
+
+// job function declaration
+#if !__PS3__
+extern void CharEvalSkeletonBatchJobFunc(const JobFuncContext& ctx);
+#endif
+
+// number of character instances per job slice, and the scratch size
+// of a joint (4x3 float4's per joint, see CharEvalSkeletonBatchJobFunc)
+static const SizeT BatchSliceInstances = 4;
+static const SizeT BatchScratchJointSize = 12 * sizeof(float4);
+
+//------------------------------------------------------------------------------
+/**
+*/
+CharacterSkeletonBatcher::CharacterSkeletonBatcher() :
+    #if __PS3__
+    enabled(false),
+    #else
+    enabled(true),
+    #endif
+    inBegin(false)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+CharacterSkeletonBatcher::~CharacterSkeletonBatcher()
+{
+    n_assert(!this->IsValid());
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CharacterSkeletonBatcher::Setup()
+{
+    n_assert(!this->IsValid());
+    this->jobPort = JobPort::Create();
+    this->jobPort->Setup();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CharacterSkeletonBatcher::Discard()
+{
+    n_assert(this->IsValid());
+    n_assert(!this->inBegin);
+    this->jobPort->WaitDone();
+    this->jobPort->Discard();
+    this->jobPort = 0;
+    this->evaluations.Clear();
+    this->batchInstances.Clear();
+    this->batchResults.Clear();
+    this->batchJobs.Clear();
+    this->predecessors.Clear();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CharacterSkeletonBatcher::SetEnabled(bool b)
+{
+    #if __PS3__
+    n_assert2(!b, "CharacterSkeletonBatcher: batched skeleton evaluation not supported on PS3!\n");
+    #endif
+    this->enabled = b;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Begin adding skeleton evaluations. Waits for the batch jobs of the
+    previous frame, since they still reference the batch buffers.
+*/
+void
+CharacterSkeletonBatcher::Begin()
+{
+    n_assert(this->IsValid());
+    n_assert(!this->inBegin);
+    this->inBegin = true;
+    this->jobPort->WaitDone();
+    this->evaluations.Clear();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CharacterSkeletonBatcher::AddEvaluation(const CharacterSkeleton* skeleton, bool skipDetailJoints, const CharSkeletonBatchInstance& inst, const Ptr<Job>& animJob)
+{
+    n_assert(this->inBegin);
+    n_assert(this->enabled);
+    n_assert(0 != inst.samples);
+    Evaluation eval;
+    eval.skeleton = skeleton;
+    eval.skipDetailJoints = skipDetailJoints;
+    eval.inst = inst;
+    eval.animJob = animJob;
+    eval.blendSkeletonInst = 0;
+    eval.blendFactor = 0.0f;
+    eval.jointTextureRowPtr = 0;
+    eval.jointTextureRowSize = 0;
+    this->evaluations.Append(eval);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CharacterSkeletonBatcher::AddKeyEvaluation(const CharacterSkeleton* skeleton, bool skipDetailJoints, const CharSkeletonBatchInstance& inst, const Ptr<Job>& animJob,
+                                           CharacterSkeletonInstance* skelInst, const Ptr<JobPort>& blendJobPort, float blendFactor, void* jointTextureRowPtr, SizeT jointTextureRowSize)
+{
+    n_assert(0 != skelInst);
+    this->AddEvaluation(skeleton, skipDetailJoints, inst, animJob);
+    Evaluation& eval = this->evaluations.Back();
+    eval.blendSkeletonInst = skelInst;
+    eval.blendJobPort = blendJobPort;
+    eval.blendFactor = blendFactor;
+    eval.jointTextureRowPtr = jointTextureRowPtr;
+    eval.jointTextureRowSize = jointTextureRowSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Sort the evaluations into batches and push the batch jobs. The
+    batch buffers are completely filled before the first job is pushed,
+    so that they are not re-allocated while jobs are running.
+*/
+void
+CharacterSkeletonBatcher::End()
+{
+    n_assert(this->inBegin);
+    this->inBegin = false;
+    if (this->evaluations.IsEmpty())
+    {
+        return;
+    }
+    this->evaluations.Sort();
+
+    SizeT numEvals = this->evaluations.Size();
+    this->batchInstances.Clear();
+    this->batchInstances.Reserve(numEvals);
+    this->batchResults.Clear();
+    this->batchResults.Reserve(numEvals);
+    IndexT i;
+    for (i = 0; i < numEvals; i++)
+    {
+        this->batchInstances.Append(this->evaluations[i].inst);
+        this->batchResults.Append(0);
+    }
+
+    // push one job per run of evaluations with the same skeleton and skip mode
+    IndexT batchIndex = 0;
+    IndexT firstEvalIndex = 0;
+    for (i = 1; i <= numEvals; i++)
+    {
+        if ((i == numEvals) || !this->evaluations[i].IsSameBatch(this->evaluations[firstEvalIndex]))
+        {
+            this->PushBatch(batchIndex++, firstEvalIndex, i - firstEvalIndex);
+            firstEvalIndex = i;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Setup and push the evaluation job of a batch. The job starts when
+    the animation jobs of all its instances are done. Batch jobs are
+    re-used across frames, but need to be setup again since the number
+    of job slices depends on the number of instances.
+*/
+void
+CharacterSkeletonBatcher::PushBatch(IndexT batchIndex, IndexT firstEvalIndex, SizeT numEvals)
+{
+    #if __PS3__
+    n_error("CharacterSkeletonBatcher: batched skeleton evaluation not supported on PS3!\n");
+    #else
+    if (batchIndex >= this->batchJobs.Size())
+    {
+        this->batchJobs.Append(Job::Create());
+    }
+    const Ptr<Job>& job = this->batchJobs[batchIndex];
+    if (job->IsValid())
+    {
+        job->Discard();
+    }
+
+    const Evaluation& firstEval = this->evaluations[firstEvalIndex];
+    const FixedArray<matrix44>& invPoseMatrixArray = firstEval.skeleton->GetInvPoseMatrixArray();
+    const FixedArray<uchar>& jointSkipArray = firstEval.skeleton->GetJointSkipArray(firstEval.skipDetailJoints);
+    SizeT numJoints = invPoseMatrixArray.Size();
+    SizeT instBufSize = numEvals * sizeof(CharSkeletonBatchInstance);
+    SizeT resultBufSize = numEvals * sizeof(uint);
+    JobFuncDesc jobFunc(CharEvalSkeletonBatchJobFunc);
+    JobUniformDesc uniform(invPoseMatrixArray.Begin(), numJoints * sizeof(matrix44),
+                           jointSkipArray.Begin(), jointSkipArray.Size(),
+                           numJoints * BatchScratchJointSize);
+    JobDataDesc input(&(this->batchInstances[firstEvalIndex]), instBufSize, BatchSliceInstances * sizeof(CharSkeletonBatchInstance));
+    JobDataDesc output(&(this->batchResults[firstEvalIndex]), resultBufSize, BatchSliceInstances * sizeof(uint));
+    job->Setup(uniform, input, output, jobFunc);
+
+    // the job depends on the animation jobs of its instances
+    this->predecessors.Clear();
+    IndexT i;
+    for (i = firstEvalIndex; i < firstEvalIndex + numEvals; i++)
+    {
+        if (this->evaluations[i].animJob.isvalid())
+        {
+            this->predecessors.Append(this->evaluations[i].animJob);
+        }
+    }
+    if (this->predecessors.IsEmpty())
+    {
+        this->jobPort->PushJob(job);
+    }
+    else
+    {
+        this->jobPort->PushDependentJob(job, this->predecessors);
+    }
+
+    // push the key palette blends which depend on this batch
+    for (i = firstEvalIndex; i < firstEvalIndex + numEvals; i++)
+    {
+        const Evaluation& eval = this->evaluations[i];
+        if (0 != eval.blendSkeletonInst)
+        {
+            eval.blendSkeletonInst->BlendKeysAsync(eval.blendJobPort, eval.blendFactor, eval.jointTextureRowPtr, eval.jointTextureRowSize, job);
+        }
+    }
+    #endif
+}
+
+} // namespace Characters
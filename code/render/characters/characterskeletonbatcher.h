@@ -0,0 +1,149 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Characters::CharacterSkeletonBatcher
+
+    Batches the skeleton evaluations of all visible character instances
+    of the same skeleton into a single job, instead of pushing one small
+    evaluation job per character instance. The batched job evaluates
+    4 character instances at once with SIMD operations and is split into
+    slices of 4 instances, which are distributed over the worker threads.
+
+    Between Begin() and End(), CharacterInstance::StartUpdate() adds the
+    skeleton evaluations of the visible character instances. End() sorts
+    them by skeleton (and joint skip mode) and pushes one evaluation job
+    per batch, each depending on the animation jobs of its instances.
+    Key palette blends of instances at a reduced animation lod are
+    pushed after their batch job.
+
+    Batched evaluation is not available on the PS3, because the batched
+    job reads the instance data through main memory pointers.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+#include "characters/charskeletonbatchinstance.h"
+#include "jobs/job.h"
+#include "jobs/jobport.h"
+#include "util/array.h"
+
+//------------------------------------------------------------------------------
+namespace Characters
+{
+class CharacterSkeleton;
+class CharacterSkeletonInstance;
+
+class CharacterSkeletonBatcher
+{
+public:
+    /// constructor
+    CharacterSkeletonBatcher();
+    /// destructor
+    ~CharacterSkeletonBatcher();
+
+    /// setup the batcher
+    void Setup();
+    /// discard the batcher
+    void Discard();
+    /// return true if the batcher has been setup
+    bool IsValid() const;
+    /// enable/disable batched skeleton evaluation (always disabled on the PS3)
+    void SetEnabled(bool b);
+    /// return true if batched skeleton evaluation is enabled
+    bool IsEnabled() const;
+    /// get the job port of the batched evaluation jobs
+    const Ptr<Jobs::JobPort>& GetJobPort() const;
+
+    /// begin adding skeleton evaluations for the current frame
+    void Begin();
+    /// add a skeleton evaluation, animJob is the last animation job of the instance (may be invalid)
+    void AddEvaluation(const CharacterSkeleton* skeleton, bool skipDetailJoints, const CharSkeletonBatchInstance& inst, const Ptr<Jobs::Job>& animJob);
+    /// add a key palette evaluation, the key palettes of skelInst are blended after the evaluation
+    void AddKeyEvaluation(const CharacterSkeleton* skeleton, bool skipDetailJoints, const CharSkeletonBatchInstance& inst, const Ptr<Jobs::Job>& animJob,
+                          CharacterSkeletonInstance* skelInst, const Ptr<Jobs::JobPort>& blendJobPort, float blendFactor, void* jointTextureRowPtr, SizeT jointTextureRowSize);
+    /// push the batched evaluation jobs
+    void End();
+
+private:
+    struct Evaluation
+    {
+        /// less-than operator for sorting by batch
+        bool operator<(const Evaluation& rhs) const;
+        /// return true if 2 evaluations belong to the same batch
+        bool IsSameBatch(const Evaluation& rhs) const;
+
+        const CharacterSkeleton* skeleton;
+        bool skipDetailJoints;
+        CharSkeletonBatchInstance inst;
+        Ptr<Jobs::Job> animJob;
+        CharacterSkeletonInstance* blendSkeletonInst;   // 0 if no key palette blend follows
+        Ptr<Jobs::JobPort> blendJobPort;
+        float blendFactor;
+        void* jointTextureRowPtr;
+        SizeT jointTextureRowSize;
+    };
+
+    /// push the evaluation job of a batch
+    void PushBatch(IndexT batchIndex, IndexT firstEvalIndex, SizeT numEvals);
+
+    Ptr<Jobs::JobPort> jobPort;
+    Util::Array<Evaluation> evaluations;
+    Util::Array<CharSkeletonBatchInstance> batchInstances;  // sorted instances, input of the batch jobs
+    Util::Array<uint> batchResults;                         // output of the batch jobs
+    Util::Array<Ptr<Jobs::Job> > batchJobs;                 // need to keep jobs around until they are finished!
+    Util::Array<Ptr<Jobs::Job> > predecessors;
+    bool enabled;
+    bool inBegin;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+CharacterSkeletonBatcher::IsValid() const
+{
+    return this->jobPort.isvalid();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+CharacterSkeletonBatcher::IsEnabled() const
+{
+    return this->enabled;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const Ptr<Jobs::JobPort>&
+CharacterSkeletonBatcher::GetJobPort() const
+{
+    return this->jobPort;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+CharacterSkeletonBatcher::Evaluation::operator<(const Evaluation& rhs) const
+{
+    if (this->skeleton != rhs.skeleton)
+    {
+        return this->skeleton < rhs.skeleton;
+    }
+    return this->skipDetailJoints < rhs.skipDetailJoints;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+CharacterSkeletonBatcher::Evaluation::IsSameBatch(const Evaluation& rhs) const
+{
+    return (this->skeleton == rhs.skeleton) && (this->skipDetailJoints == rhs.skipDetailJoints);
+}
+
+} // namespace Characters
+//------------------------------------------------------------------------------
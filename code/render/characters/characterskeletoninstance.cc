@@ -5,6 +5,7 @@
 #include "stdneb.h"
 #include "characters/characterskeletoninstance.h"
 #include "characters/skinnedmeshrenderer.h"
+#include "characters/characterskeletonbatcher.h"
 
 // for debug visualization
 #include "coregraphics/shaperenderer.h"
@@ -22,9 +23,12 @@ using namespace Jobs;
 extern "C" {
     extern const char _binary_jqjob_render_charevalskeletonjob_ps3_bin_start[];
     extern const char _binary_jqjob_render_charevalskeletonjob_ps3_bin_size[];
+    extern const char _binary_jqjob_render_charblendpalettejob_ps3_bin_start[];
+    extern const char _binary_jqjob_render_charblendpalettejob_ps3_bin_size[];
 }
 #else
 extern void CharEvalSkeletonJobFunc(const JobFuncContext& ctx);
+extern void CharBlendPaletteJobFunc(const JobFuncContext& ctx);
 #endif
 
 //------------------------------------------------------------------------------
@@ -32,6 +36,8 @@ extern void CharEvalSkeletonJobFunc(const JobFuncContext& ctx);
 */
 CharacterSkeletonInstance::CharacterSkeletonInstance() :
     skeletonPtr(0),
+    nextKeyIndex(0),
+    numKeys(0),
     isValid(false),
     jointComponentsDirty(false)
 {
@@ -88,6 +94,14 @@ CharacterSkeletonInstance::Discard()
     this->startJointComponentsArray.Clear();
     this->scaledMatrixArray.Clear();
     this->skinMatrixArray.Clear();
+    this->blendJob = 0;
+    IndexT i;
+    for (i = 0; i < 2; i++)
+    {
+        this->keyScaledMatrixArray[i].Clear();
+        this->keySkinMatrixArray[i].Clear();
+    }
+    this->numKeys = 0;
     this->isValid = false;
 }
 
@@ -117,12 +131,15 @@ CharacterSkeletonInstance::SetupEvalJob()
     SizeT compBufferSize = numElements * sizeof(CharJointComponents);
     SizeT outBufSize = numElements * elmSize;
 
-    // setup the job, patch the sample buffer data later
+    // setup the job, patch the sample buffer data later, the 
+    // joint skip flags select the joints which are not evaluated
     this->evalJob = Job::Create();
     const FixedArray<matrix44>& invPoseMatrixArray = this->skeletonPtr->GetInvPoseMatrixArray();
+    const FixedArray<uchar>& jointSkipArray = this->skeletonPtr->GetJointSkipArray(false);
     JobUniformDesc uniform(invPoseMatrixArray.Begin(), invPoseMatrixArray.Size() * sizeof(matrix44), outBufSize);
     JobDataDesc input(this->jointComponentsArrayPtr->Begin(), compBufferSize, compBufferSize,
-                      0, 16, 16);
+                      0, 16, 16,
+                      jointSkipArray.Begin(), jointSkipArray.Size(), jointSkipArray.Size());
 
     if (SkinnedMeshRenderer::Instance()->GetSkinningTechnique() == SkinningTechnique::GPUTextureSkinning)
     {
@@ -141,6 +158,72 @@ CharacterSkeletonInstance::SetupEvalJob()
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+    Setup the job which interpolates the joint and skin matrices between
+    the key palettes, and allocate the key palettes. This only happens
+    when the character is rendered at a reduced animation lod for the
+    first time.
+*/
+void
+CharacterSkeletonInstance::SetupBlendJob()
+{
+    n_assert(!this->blendJob.isvalid());
+
+    #if __PS3__
+    JobFuncDesc jobFunc(_binary_jqjob_render_charblendpalettejob_ps3_bin_start, _binary_jqjob_render_charblendpalettejob_ps3_bin_size);
+    #else
+    JobFuncDesc jobFunc(CharBlendPaletteJobFunc);
+    #endif
+
+    SizeT numJoints = this->scaledMatrixArray.Size();
+    SizeT bufSize = numJoints * sizeof(matrix44);
+    IndexT i;
+    for (i = 0; i < 2; i++)
+    {
+        this->keyScaledMatrixArray[i].SetSize(numJoints);
+        this->keySkinMatrixArray[i].SetSize(numJoints);
+    }
+    this->nextKeyIndex = 0;
+    this->numKeys = 0;
+    this->blendParams = float4(0.0f, 0.0f, 0.0f, 0.0f);
+
+    // setup the job, inputs and outputs are patched in BlendKeysAsync()
+    this->blendJob = Job::Create();
+    JobUniformDesc uniform(&this->blendParams, sizeof(float4), 0);
+    JobDataDesc input(this->keyScaledMatrixArray[0].Begin(), bufSize, bufSize,
+                      this->keySkinMatrixArray[0].Begin(), bufSize, bufSize,
+                      this->keyScaledMatrixArray[1].Begin(), bufSize, bufSize,
+                      this->keySkinMatrixArray[1].Begin(), bufSize, bufSize);
+    JobDataDesc output(this->scaledMatrixArray.Begin(), bufSize, bufSize,
+                       this->skinMatrixArray.Begin(), bufSize, bufSize);
+    this->blendJob->Setup(uniform, input, output, jobFunc);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Patch the animation samples, the joint components and the joint
+    skip flags into the evaluation job.
+    NOTE: The sampleBuffer pointer may be 0, if this is the case, there is
+    no animation sample data avaliable, and the skeleton should simply set
+    itself to the jesus pose
+*/
+void
+CharacterSkeletonInstance::PatchEvalJobInputs(const Math::float4* sampleBuffer, SizeT numSamples, bool skipDetailJoints)
+{
+    SizeT sampleBufferSize = numSamples * sizeof(float4);
+    JobDataDesc input = this->evalJob->GetInputDesc();
+    input.Update(1, (void*)sampleBuffer, sampleBufferSize, sampleBufferSize);
+    if (this->jointComponentsDirty)
+    {
+        input.Update(0, this->jointComponentsArrayPtr->Begin(), input.GetBufferSize(0), input.GetSliceSize(0));
+        this->jointComponentsDirty = false;                
+    }
+    const FixedArray<uchar>& jointSkipArray = this->skeletonPtr->GetJointSkipArray(skipDetailJoints);
+    input.Update(2, jointSkipArray.Begin(), jointSkipArray.Size(), jointSkipArray.Size());
+    this->evalJob->PatchInputDesc(input);
+}
+
 //------------------------------------------------------------------------------
 /**
     Evaluate the joints in the skeleton. Must be called after joints
@@ -153,32 +236,29 @@ CharacterSkeletonInstance::SetupEvalJob()
 void
 CharacterSkeletonInstance::EvaluateAsync(const Ptr<Jobs::JobPort>& jobPort,
                                          const Math::float4* sampleBuffer, SizeT numSamples, 
+                                         bool skipDetailJoints,
                                          void* jointTextureRowPtr, SizeT jointTextureRowSize,
                                          bool waitAnimJobsDone)
 {
     // patch input and optional joint texture row pointers into the eval job
-    // NOTE: The sampleBuffer pointer may be 0, if this is the case, there is
-    // no animation sample data avaliable, and the skeleton should simply set
-    // itself to the jesus pose
     // the jointTexture data will only be valid if a GPU texture skinning is used
-   
-    // patch the input buffer into the job
-    SizeT sampleBufferSize = numSamples * sizeof(float4);
-    JobDataDesc input = this->evalJob->GetInputDesc();
-    input.Update(1, (void*)sampleBuffer, sampleBufferSize, sampleBufferSize);
-    if (this->jointComponentsDirty)
-    {
-        input.Update(0, this->jointComponentsArrayPtr->Begin(), input.GetBufferSize(0), input.GetSliceSize(0));
-        this->jointComponentsDirty = false;                
-    }
-    this->evalJob->PatchInputDesc(input);
+    this->PatchEvalJobInputs(sampleBuffer, numSamples, skipDetailJoints);
 
-    // patch the joint texture pointer into the output desc
+    // write directly into the joint and skin matrices (the outputs
+    // may point to the key palettes from a previous EvaluateKeyAsync())
+    SizeT outBufSize = this->scaledMatrixArray.Size() * sizeof(matrix44);
     if (SkinnedMeshRenderer::Instance()->GetSkinningTechnique() == SkinningTechnique::GPUTextureSkinning)
     {
         n_assert(0 != jointTextureRowPtr);
-        JobDataDesc output = this->evalJob->GetOutputDesc();
-        output.Update(2, jointTextureRowPtr, jointTextureRowSize, jointTextureRowSize);
+        JobDataDesc output(this->scaledMatrixArray.Begin(), outBufSize, outBufSize,
+                           this->skinMatrixArray.Begin(), outBufSize, outBufSize,
+                           jointTextureRowPtr, jointTextureRowSize, jointTextureRowSize);
+        this->evalJob->PatchOutputDesc(output);
+    }
+    else
+    {
+        JobDataDesc output(this->scaledMatrixArray.Begin(), outBufSize, outBufSize,
+                           this->skinMatrixArray.Begin(), outBufSize, outBufSize);
         this->evalJob->PatchOutputDesc(output);
     }
 
@@ -190,6 +270,196 @@ CharacterSkeletonInstance::EvaluateAsync(const Ptr<Jobs::JobPort>& jobPort,
     jobPort->PushJob(this->evalJob);
 }
 
+//------------------------------------------------------------------------------
+/**
+    Evaluate the joints into the next key palette, the current next key
+    palette becomes the previous key palette. The joint and skin matrices
+    used for rendering are not touched, BlendKeysAsync() must be called
+    every frame to update them.
+*/
+void
+CharacterSkeletonInstance::EvaluateKeyAsync(const Ptr<Jobs::JobPort>& jobPort,
+                                            const Math::float4* sampleBuffer, SizeT numSamples,
+                                            bool skipDetailJoints,
+                                            bool waitAnimJobsDone)
+{
+    if (!this->blendJob.isvalid())
+    {
+        this->SetupBlendJob();
+    }
+    this->PatchEvalJobInputs(sampleBuffer, numSamples, skipDetailJoints);
+
+    // flip the key palettes and evaluate into the next key palette (the
+    // joint texture row is written by the blend job)
+    this->FlipKeys();
+    SizeT outBufSize = this->scaledMatrixArray.Size() * sizeof(matrix44);
+    JobDataDesc output(this->keyScaledMatrixArray[this->nextKeyIndex].Begin(), outBufSize, outBufSize,
+                       this->keySkinMatrixArray[this->nextKeyIndex].Begin(), outBufSize, outBufSize);
+    this->evalJob->PatchOutputDesc(output);
+
+    if (waitAnimJobsDone)
+    {
+        // need to wait until animation system jobs are done
+        jobPort->PushSync();
+    }
+    jobPort->PushJob(this->evalJob);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Evaluate the joints as part of a batched evaluation job instead of
+    pushing the evaluation job of this instance. The batched job is
+    pushed by CharacterSkeletonBatcher::End(), and starts after animJob.
+*/
+void
+CharacterSkeletonInstance::EvaluateBatched(CharacterSkeletonBatcher& batcher, const Ptr<Jobs::Job>& animJob,
+                                           const Math::float4* sampleBuffer, SizeT numSamples,
+                                           bool skipDetailJoints,
+                                           void* jointTextureRowPtr)
+{
+    if (SkinnedMeshRenderer::Instance()->GetSkinningTechnique() == SkinningTechnique::GPUTextureSkinning)
+    {
+        n_assert(0 != jointTextureRowPtr);
+    }
+    CharSkeletonBatchInstance inst;
+    this->SetupBatchInstance(sampleBuffer, numSamples, this->scaledMatrixArray.Begin(), this->skinMatrixArray.Begin(), jointTextureRowPtr, inst);
+    batcher.AddEvaluation(this->skeletonPtr, skipDetailJoints, inst, animJob);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Evaluate the joints into the next key palette as part of a batched
+    evaluation job. Since the blend of the key palettes may depend on
+    the batched job, the batcher also pushes the blend job (see 
+    BlendKeysAsync()).
+*/
+void
+CharacterSkeletonInstance::EvaluateKeyBatched(CharacterSkeletonBatcher& batcher, const Ptr<Jobs::Job>& animJob,
+                                              const Math::float4* sampleBuffer, SizeT numSamples,
+                                              bool skipDetailJoints,
+                                              const Ptr<Jobs::JobPort>& jobPort, float blendFactor,
+                                              void* jointTextureRowPtr, SizeT jointTextureRowSize)
+{
+    if (!this->blendJob.isvalid())
+    {
+        this->SetupBlendJob();
+    }
+    this->FlipKeys();
+    CharSkeletonBatchInstance inst;
+    this->SetupBatchInstance(sampleBuffer, numSamples, 
+                             this->keyScaledMatrixArray[this->nextKeyIndex].Begin(), 
+                             this->keySkinMatrixArray[this->nextKeyIndex].Begin(), 
+                             0, inst);
+    batcher.AddKeyEvaluation(this->skeletonPtr, skipDetailJoints, inst, animJob, 
+                             this, jobPort, blendFactor, jointTextureRowPtr, jointTextureRowSize);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CharacterSkeletonInstance::SetupBatchInstance(const Math::float4* sampleBuffer, SizeT numSamples, 
+                                              Math::matrix44* scaledMatrices, Math::matrix44* skinMatrices, 
+                                              void* jointTextureRowPtr, 
+                                              CharSkeletonBatchInstance& outInst) const
+{
+    n_assert(0 != sampleBuffer);
+    SizeT numJoints = this->jointComponentsArrayPtr->Size();
+    outInst.samples = sampleBuffer;
+    outInst.jointComponents = this->jointComponentsArrayPtr->Begin();
+    outInst.scaledMatrices = scaledMatrices;
+    outInst.skinMatrices = skinMatrices;
+    outInst.jointTextureRow = jointTextureRowPtr;
+    outInst.sampleWidth = numSamples / numJoints;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CharacterSkeletonInstance::FlipKeys()
+{
+    this->nextKeyIndex = 1 - this->nextKeyIndex;
+    if (this->numKeys < 2)
+    {
+        this->numKeys++;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Interpolate the joint and skin matrices between the previous and next
+    key palette. The interpolation lags one key behind the animation: a
+    blend factor of 0 produces the previous key palette, and the next key
+    palette is reached right when a new key palette is evaluated. This
+    way the blend never needs to wait for the evaluation of the next key
+    palette, except when only a single key palette exists. In that case
+    the blend depends on keyEvalJob if it is valid (the batched 
+    evaluation job), otherwise on all previous jobs of the job port.
+*/
+void
+CharacterSkeletonInstance::BlendKeysAsync(const Ptr<Jobs::JobPort>& jobPort, float blendFactor, void* jointTextureRowPtr, SizeT jointTextureRowSize, const Ptr<Jobs::Job>& keyEvalJob)
+{
+    n_assert(this->blendJob.isvalid());
+    n_assert(this->HasKeys());
+
+    IndexT fromKeyIndex = 1 - this->nextKeyIndex;
+    IndexT toKeyIndex = this->nextKeyIndex;
+    bool waitKeyEval = false;
+    if (1 == this->numKeys)
+    {
+        // only the first key palette exists, which may still be evaluated,
+        // simply copy it
+        fromKeyIndex = this->nextKeyIndex;
+        blendFactor = 0.0f;
+        waitKeyEval = true;
+    }
+    else if (0.0f == blendFactor)
+    {
+        // don't touch the next key palette, it may be evaluated right now
+        toKeyIndex = fromKeyIndex;
+    }
+    this->blendParams = float4(blendFactor, 0.0f, 0.0f, 0.0f);
+
+    SizeT bufSize = this->scaledMatrixArray.Size() * sizeof(matrix44);
+    JobDataDesc input(this->keyScaledMatrixArray[fromKeyIndex].Begin(), bufSize, bufSize,
+                      this->keySkinMatrixArray[fromKeyIndex].Begin(), bufSize, bufSize,
+                      this->keyScaledMatrixArray[toKeyIndex].Begin(), bufSize, bufSize,
+                      this->keySkinMatrixArray[toKeyIndex].Begin(), bufSize, bufSize);
+    this->blendJob->PatchInputDesc(input);
+    if (SkinnedMeshRenderer::Instance()->GetSkinningTechnique() == SkinningTechnique::GPUTextureSkinning)
+    {
+        n_assert(0 != jointTextureRowPtr);
+        JobDataDesc output(this->scaledMatrixArray.Begin(), bufSize, bufSize,
+                           this->skinMatrixArray.Begin(), bufSize, bufSize,
+                           jointTextureRowPtr, jointTextureRowSize, jointTextureRowSize);
+        this->blendJob->PatchOutputDesc(output);
+    }
+    if (waitKeyEval && keyEvalJob.isvalid())
+    {
+        Array<Ptr<Job> > predecessors;
+        predecessors.Append(keyEvalJob);
+        jobPort->PushDependentJob(this->blendJob, predecessors);
+    }
+    else
+    {
+        if (waitKeyEval)
+        {
+            jobPort->PushSync();
+        }
+        jobPort->PushJob(this->blendJob);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+CharacterSkeletonInstance::InvalidateKeys()
+{
+    this->numKeys = 0;
+}
+
 //------------------------------------------------------------------------------
 /**
     Setup a single joint in the skeleton instance.
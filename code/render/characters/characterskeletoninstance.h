@@ -4,18 +4,27 @@
     @class Characters::CharacterSkeletonInstance
     
     Contains the per-instance skeleton data of a character.
+
+    At reduced animation level-of-detail the skeleton is not evaluated
+    every frame. Instead the evaluation results are written into 2 
+    alternating key palettes, and the joint and skin matrices are 
+    interpolated between the last 2 key palettes in the frames 
+    between evaluations (see CharacterInstance::StartUpdate()).
     
     (C) 2008 Radon Labs GmbH
 */
 #include "core/types.h"
 #include "characters/characterskeleton.h"
 #include "characters/charjointcomponents.h"
+#include "characters/charskeletonbatchinstance.h"
 #include "jobs/job.h"
 #include "jobs/jobport.h"
 
 //------------------------------------------------------------------------------
 namespace Characters
 {
+class CharacterSkeletonBatcher;
+
 class CharacterSkeletonInstance
 {
 public:
@@ -46,24 +55,61 @@ public:
 
 private:
     friend class CharacterInstance;
+    friend class CharacterSkeletonBatcher;
 
     /// setup skeleton evaluation job
     void SetupEvalJob();
+    /// setup the palette blend job and the key palettes (called on first use)
+    void SetupBlendJob();
     /// setup a single joint
     void SetupJoint(const CharacterSkeleton& skeleton, IndexT jointIndex);
+    /// patch the input buffers of the evaluation job
+    void PatchEvalJobInputs(const Math::float4* sampleBuffer, SizeT numSamples, bool skipDetailJoints);
     /// evaluate the joints (computes new skin matrices)
-    void EvaluateAsync(const Ptr<Jobs::JobPort>& jobPort, const Math::float4* sampleBuffer, SizeT numSamples, void* jointTextureRowPtr, SizeT jointTextureRowSize, bool waitAnimJobsDone);
+    void EvaluateAsync(const Ptr<Jobs::JobPort>& jobPort, const Math::float4* sampleBuffer, SizeT numSamples, bool skipDetailJoints, void* jointTextureRowPtr, SizeT jointTextureRowSize, bool waitAnimJobsDone);
+    /// evaluate the joints into the next key palette
+    void EvaluateKeyAsync(const Ptr<Jobs::JobPort>& jobPort, const Math::float4* sampleBuffer, SizeT numSamples, bool skipDetailJoints, bool waitAnimJobsDone);
+    /// evaluate the joints in a batched evaluation job
+    void EvaluateBatched(CharacterSkeletonBatcher& batcher, const Ptr<Jobs::Job>& animJob, const Math::float4* sampleBuffer, SizeT numSamples, bool skipDetailJoints, void* jointTextureRowPtr);
+    /// evaluate the joints into the next key palette in a batched evaluation job, the key palettes are blended after the batch job
+    void EvaluateKeyBatched(CharacterSkeletonBatcher& batcher, const Ptr<Jobs::Job>& animJob, const Math::float4* sampleBuffer, SizeT numSamples, bool skipDetailJoints,
+                            const Ptr<Jobs::JobPort>& jobPort, float blendFactor, void* jointTextureRowPtr, SizeT jointTextureRowSize);
+    /// setup the description of this instance for a batched evaluation job
+    void SetupBatchInstance(const Math::float4* sampleBuffer, SizeT numSamples, Math::matrix44* scaledMatrices, Math::matrix44* skinMatrices, void* jointTextureRowPtr, CharSkeletonBatchInstance& outInst) const;
+    /// interpolate joint and skin matrices between the last 2 key palettes, keyEvalJob is the job evaluating the next key palette (optional)
+    void BlendKeysAsync(const Ptr<Jobs::JobPort>& jobPort, float blendFactor, void* jointTextureRowPtr, SizeT jointTextureRowSize, const Ptr<Jobs::Job>& keyEvalJob);
+    /// make the next key palette the previous key palette
+    void FlipKeys();
+    /// invalidate the key palettes, the next EvaluateKeyAsync() restarts interpolation
+    void InvalidateKeys();
+    /// return true if at least one key palette has been evaluated
+    bool HasKeys() const;
 
     const CharacterSkeleton* skeletonPtr;
     Ptr<Jobs::Job> evalJob;
+    Ptr<Jobs::Job> blendJob;
     Util::FixedArray<CharJointComponents> startJointComponentsArray;         
     Util::FixedArray<CharJointComponents>* jointComponentsArrayPtr;  
     bool jointComponentsDirty;
     Util::FixedArray<Math::matrix44> scaledMatrixArray;
     Util::FixedArray<Math::matrix44> skinMatrixArray;
+    Util::FixedArray<Math::matrix44> keyScaledMatrixArray[2];
+    Util::FixedArray<Math::matrix44> keySkinMatrixArray[2];
+    IndexT nextKeyIndex;
+    SizeT numKeys;
+    Math::float4 blendParams;       // x: blend factor between previous and next key palette
     bool isValid;
 };
 
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+CharacterSkeletonInstance::HasKeys() const
+{
+    return this->numKeys > 0;
+}
+
 //------------------------------------------------------------------------------
 /**
 */
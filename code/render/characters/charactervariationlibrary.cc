@@ -39,8 +39,6 @@ CharacterVariationLibrary::Setup(const Ptr<AnimResource>& animRes, const Charact
 
     // sample character variation
     SizeT numVariations = animRes->GetNumClips();
-    const Ptr<AnimKeyBuffer>& keyBuffer = animRes->GetKeyBuffer();
-    Math::float4* keyPtr = keyBuffer->GetKeyBufferPointer();
     IndexT i;
     for (i = 0; i < numVariations; ++i)
     {
@@ -48,7 +46,6 @@ CharacterVariationLibrary::Setup(const Ptr<AnimResource>& animRes, const Charact
         Util::StringAtom variationName = clip.GetName();                   
         // just get the static keys from the variation curves
         SizeT numCurves = clip.GetNumCurves(); 
-        SizeT keyStride = clip.GetKeyStride();
         // save as CharJointComponents                      
         Util::FixedArray<CharJointComponents> jointCompArray(skeleton.GetNumJoints());    
         SizeT curveJointRatio = 3; // translationm, scaling, rotation
@@ -58,18 +55,8 @@ CharacterVariationLibrary::Setup(const Ptr<AnimResource>& animRes, const Charact
             IndexT jointIdx = curveIdx / curveJointRatio;
             CharJointComponents& jointComp = jointCompArray[jointIdx];
             const AnimCurve& curve = clip.CurveByIndex(curveIdx);  
-            IndexT startKeyIndex = clip.GetStartKeyIndex();
-            float4 key;
-            if (curve.IsStatic())
-            {
-                key = curve.GetStaticKey();
-            }
-            else
-            {
-                // use last key
-                IndexT keyIndex = curve.GetFirstKeyIndex();
-                key = keyPtr[keyIndex + (clip.GetNumKeys()-1) * clip.GetKeyStride()];                               
-            }
+            // use last key (returns the static key for static curves)
+            float4 key = animRes->GetKey(i, curveIdx, clip.GetNumKeys() - 1);
             
             switch (curve.GetCurveType())
             {
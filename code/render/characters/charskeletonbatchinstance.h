@@ -0,0 +1,31 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Characters::CharSkeletonBatchInstance
+
+    Describes one character instance in a batched skeleton evaluation
+    job (see CharacterSkeletonBatcher). The batched job reads the
+    animation samples and joint components of the instance and writes
+    the joint and skin matrices directly through these pointers.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "math/float4.h"
+#include "math/matrix44.h"
+#include "characters/charjointcomponents.h"
+
+//------------------------------------------------------------------------------
+namespace Characters
+{
+struct CharSkeletonBatchInstance
+{
+    const Math::float4* samples;                // translate/rotate/scale(/velocity) samples per joint
+    const CharJointComponents* jointComponents; // variation components of the instance
+    Math::matrix44* scaledMatrices;             // output joint matrices
+    Math::matrix44* skinMatrices;               // output skin matrices
+    void* jointTextureRow;                      // optional joint texture row, may be 0
+    uint sampleWidth;                           // number of samples per joint
+};
+
+} // namespace Characters
+//------------------------------------------------------------------------------
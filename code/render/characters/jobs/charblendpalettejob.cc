@@ -0,0 +1,64 @@
+//------------------------------------------------------------------------------
+//  charblendpalettejob.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "jobs/stdjob.h"
+#include "math/float4.h"
+#include "math/matrix44.h"
+#include "characters/jobs/charjobutil.h"
+
+namespace Characters
+{
+using namespace Math;
+
+//------------------------------------------------------------------------------
+/**
+    Linearly interpolate the rows of 2 matrices.
+*/
+inline void
+CharBlendMatrix(const matrix44& m0, const matrix44& m1, scalar s, matrix44& outMatrix)
+{
+    outMatrix.set(float4::lerp(m0.getrow0(), m1.getrow0(), s),
+                  float4::lerp(m0.getrow1(), m1.getrow1(), s),
+                  float4::lerp(m0.getrow2(), m1.getrow2(), s),
+                  float4::lerp(m0.getrow3(), m1.getrow3(), s));
+}
+
+//------------------------------------------------------------------------------
+/**
+    Interpolate the joint and skin matrices of a character between 2 key
+    palettes (used between skeleton evaluations at a reduced animation lod).
+    The matrices are interpolated component-wise, which is accurate
+    enough for the small differences between 2 key palettes.
+*/
+void
+CharBlendPaletteJobFunc(const JobFuncContext& ctx)
+{
+    const float4* blendParams = (const float4*) ctx.uniforms[0];
+    scalar blendFactor = blendParams->x();
+
+    const matrix44* fromScaledMatrixBase = (const matrix44*) ctx.inputs[0];
+    const matrix44* fromSkinMatrixBase = (const matrix44*) ctx.inputs[1];
+    const matrix44* toScaledMatrixBase = (const matrix44*) ctx.inputs[2];
+    const matrix44* toSkinMatrixBase = (const matrix44*) ctx.inputs[3];
+    matrix44* scaledMatrixBase = (matrix44*) ctx.outputs[0];
+    matrix44* skinMatrixBase = (matrix44*) ctx.outputs[1];
+
+    int numJoints = ctx.inputSizes[0] / sizeof(matrix44);
+    int jointIndex;
+    for (jointIndex = 0; jointIndex < numJoints; jointIndex++)
+    {
+        CharBlendMatrix(fromScaledMatrixBase[jointIndex], toScaledMatrixBase[jointIndex], blendFactor, scaledMatrixBase[jointIndex]);
+        CharBlendMatrix(fromSkinMatrixBase[jointIndex], toSkinMatrixBase[jointIndex], blendFactor, skinMatrixBase[jointIndex]);
+    }
+
+    // optionally write to the joint texture
+    if (ctx.numOutputs > 2)
+    {
+        CharJobUtilWriteJointTextureRow(skinMatrixBase, numJoints, ctx.outputs[2]);
+    }
+}
+
+} // namespace Characters
+__ImplementSpursJob(Characters::CharBlendPaletteJobFunc);
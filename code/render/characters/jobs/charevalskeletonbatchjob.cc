@@ -0,0 +1,306 @@
+//------------------------------------------------------------------------------
+//  charevalskeletonbatchjob.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "jobs/stdjob.h"
+#include "math/float4.h"
+#include "math/matrix44.h"
+#include "characters/charjointcomponents.h"
+#include "characters/charskeletonbatchinstance.h"
+#include "characters/jobs/charjobutil.h"
+
+namespace Characters
+{
+using namespace Math;
+
+// number of character instances evaluated together
+static const SizeT CharBatchLanes = 4;
+
+//------------------------------------------------------------------------------
+/**
+    The upper 4x3 part of the affine joint matrices of 4 character
+    instances in SoA layout: each float4 holds one matrix element of
+    all 4 instances. The 4th column of an affine matrix is always
+    (0, 0, 0, 1) and isn't stored.
+*/
+struct CharSoaMatrix
+{
+    float4 m[4][3];
+};
+
+//------------------------------------------------------------------------------
+/**
+    Convert 4 vectors (one per instance) into SoA layout.
+*/
+inline void
+CharSoaLoad(const float4& v0, const float4& v1, const float4& v2, const float4& v3, float4& outX, float4& outY, float4& outZ, float4& outW)
+{
+    matrix44 m = matrix44::transpose(matrix44(v0, v1, v2, v3));
+    outX = m.getrow0();
+    outY = m.getrow1();
+    outZ = m.getrow2();
+    outW = m.getrow3();
+}
+
+//------------------------------------------------------------------------------
+/**
+    Multiply 2 affine SoA matrices (outMatrix must not be m0 or m1).
+*/
+inline void
+CharSoaMultiply(const CharSoaMatrix& m0, const CharSoaMatrix& m1, CharSoaMatrix& outMatrix)
+{
+    IndexT row, col;
+    for (row = 0; row < 4; row++)
+    {
+        for (col = 0; col < 3; col++)
+        {
+            float4 v = float4::multiply(m0.m[row][0], m1.m[0][col]) +
+                       float4::multiply(m0.m[row][1], m1.m[1][col]) +
+                       float4::multiply(m0.m[row][2], m1.m[2][col]);
+            if (3 == row)
+            {
+                v += m1.m[3][col];
+            }
+            outMatrix.m[row][col] = v;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Multiply a matrix which is shared by all instances with an affine
+    SoA matrix. The 4th column of the result is the 4th column of m0.
+*/
+inline void
+CharSoaMultiplyShared(const matrix44& m0, const CharSoaMatrix& m1, CharSoaMatrix& outMatrix)
+{
+    const float4 rows[4] = { m0.getrow0(), m0.getrow1(), m0.getrow2(), m0.getrow3() };
+    IndexT row, col;
+    for (row = 0; row < 4; row++)
+    {
+        float4 r0 = float4::splat_x(rows[row]);
+        float4 r1 = float4::splat_y(rows[row]);
+        float4 r2 = float4::splat_z(rows[row]);
+        float4 r3 = float4::splat_w(rows[row]);
+        for (col = 0; col < 3; col++)
+        {
+            outMatrix.m[row][col] = float4::multiply(r0, m1.m[0][col]) +
+                                    float4::multiply(r1, m1.m[1][col]) +
+                                    float4::multiply(r2, m1.m[2][col]) +
+                                    float4::multiply(r3, m1.m[3][col]);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Convert a SoA matrix back into one matrix per instance and store
+    the matrices of the first numLanes instances. The 4th column of
+    the matrices is taken from wColumn.
+*/
+inline void
+CharSoaStore(const CharSoaMatrix& soa, const float4& wColumn, matrix44* const* dstBase, SizeT numLanes, IndexT jointIndex)
+{
+    matrix44 rows[4];
+    IndexT row;
+    for (row = 0; row < 4; row++)
+    {
+        rows[row] = matrix44::transpose(matrix44(soa.m[row][0], soa.m[row][1], soa.m[row][2], float4::splat(wColumn, row)));
+    }
+    dstBase[0][jointIndex] = matrix44(rows[0].getrow0(), rows[1].getrow0(), rows[2].getrow0(), rows[3].getrow0());
+    if (numLanes > 1) dstBase[1][jointIndex] = matrix44(rows[0].getrow1(), rows[1].getrow1(), rows[2].getrow1(), rows[3].getrow1());
+    if (numLanes > 2) dstBase[2][jointIndex] = matrix44(rows[0].getrow2(), rows[1].getrow2(), rows[2].getrow2(), rows[3].getrow2());
+    if (numLanes > 3) dstBase[3][jointIndex] = matrix44(rows[0].getrow3(), rows[1].getrow3(), rows[2].getrow3(), rows[3].getrow3());
+}
+
+//------------------------------------------------------------------------------
+/**
+    Evaluates the skeletons of several instances of the same character
+    skeleton (see CharacterSkeletonBatcher). Each job slice contains up
+    to 4 instances, which are evaluated together with SIMD operations
+    working on one matrix element of all 4 instances at once. The
+    results are identical to CharEvalSkeletonJobFunc().
+
+    Uniform 0 contains the inverse pose matrices of the skeleton,
+    uniform 1 the joint skip flags. The input contains the instance
+    descriptions, the evaluated joint and skin matrices are written
+    directly through their pointers. The job system requires an
+    output buffer, it receives the number of evaluated joints per
+    instance.
+
+    NOTE: the job dereferences main memory pointers in its input,
+    so it can't be used on the PS3.
+*/
+void
+CharEvalSkeletonBatchJobFunc(const JobFuncContext& ctx)
+{
+    const matrix44* invPoseMatrixBase = (const matrix44*) ctx.uniforms[0];
+    const uchar* jointSkipBase = (const uchar*) ctx.uniforms[1];
+    const CharSkeletonBatchInstance* instBase = (const CharSkeletonBatchInstance*) ctx.inputs[0];
+    uint* resultBase = (uint*) ctx.outputs[0];
+    CharSoaMatrix* unscaledMatrixBase = (CharSoaMatrix*) ctx.scratch;
+
+    SizeT numJoints = ctx.uniformSizes[0] / sizeof(matrix44);
+    SizeT numLanes = ctx.inputSizes[0] / sizeof(CharSkeletonBatchInstance);
+    n_assert((numLanes > 0) && (numLanes <= CharBatchLanes));
+
+    // gather the per-instance pointers, unused lanes repeat the last
+    // instance (their results are not stored)
+    const CharSkeletonBatchInstance* lanes[CharBatchLanes];
+    matrix44* scaledMatrixBase[CharBatchLanes];
+    matrix44* skinMatrixBase[CharBatchLanes];
+    IndexT lane;
+    for (lane = 0; lane < CharBatchLanes; lane++)
+    {
+        lanes[lane] = &instBase[n_min(lane, numLanes - 1)];
+        scaledMatrixBase[lane] = lanes[lane]->scaledMatrices;
+        skinMatrixBase[lane] = lanes[lane]->skinMatrices;
+    }
+
+    const float4 one(1.0f, 1.0f, 1.0f, 1.0f);
+    const float4 two(2.0f, 2.0f, 2.0f, 2.0f);
+    const float4 affineWColumn(0.0f, 0.0f, 0.0f, 1.0f);
+    float4 tx, ty, tz, tw;          // animation translation
+    float4 qx, qy, qz, qw;          // animation rotation
+    float4 sx, sy, sz, sw;          // animation scale
+    float4 vtx, vty, vtz, vtw;      // variation translation
+    float4 vsx, vsy, vsz, vsw;      // variation scale
+    float4 psx, psy, psz, psw;      // parent variation scale
+    CharSoaMatrix local, scaled, skin;
+
+    IndexT jointIndex;
+    for (jointIndex = 0; jointIndex < numJoints; jointIndex++)
+    {
+        // the joint hierarchy is the same for all instances
+        IndexT parentJointIndex = lanes[0]->jointComponents[jointIndex].parentJointIndex;
+        CharSoaMatrix& unscaled = unscaledMatrixBase[jointIndex];
+        if (0 != jointSkipBase[jointIndex])
+        {
+            // skipped joint, rigidly follows its parent joint in pose
+            n_assert(InvalidIndex != parentJointIndex);
+            unscaled = unscaledMatrixBase[parentJointIndex];
+            for (lane = 0; lane < numLanes; lane++)
+            {
+                scaledMatrixBase[lane][jointIndex] = scaledMatrixBase[lane][parentJointIndex];
+                skinMatrixBase[lane][jointIndex] = skinMatrixBase[lane][parentJointIndex];
+            }
+            continue;
+        }
+
+        // load joint translate/rotate/scale and variation components of all instances
+        const float4* s0 = lanes[0]->samples + lanes[0]->sampleWidth * jointIndex;
+        const float4* s1 = lanes[1]->samples + lanes[1]->sampleWidth * jointIndex;
+        const float4* s2 = lanes[2]->samples + lanes[2]->sampleWidth * jointIndex;
+        const float4* s3 = lanes[3]->samples + lanes[3]->sampleWidth * jointIndex;
+        CharSoaLoad(s0[0], s1[0], s2[0], s3[0], tx, ty, tz, tw);
+        CharSoaLoad(s0[1], s1[1], s2[1], s3[1], qx, qy, qz, qw);
+        CharSoaLoad(s0[2], s1[2], s2[2], s3[2], sx, sy, sz, sw);
+        const CharJointComponents* c0 = &lanes[0]->jointComponents[jointIndex];
+        const CharJointComponents* c1 = &lanes[1]->jointComponents[jointIndex];
+        const CharJointComponents* c2 = &lanes[2]->jointComponents[jointIndex];
+        const CharJointComponents* c3 = &lanes[3]->jointComponents[jointIndex];
+        CharSoaLoad(float4(c0->varTranslationX, c0->varTranslationY, c0->varTranslationZ, 0.0f),
+                    float4(c1->varTranslationX, c1->varTranslationY, c1->varTranslationZ, 0.0f),
+                    float4(c2->varTranslationX, c2->varTranslationY, c2->varTranslationZ, 0.0f),
+                    float4(c3->varTranslationX, c3->varTranslationY, c3->varTranslationZ, 0.0f),
+                    vtx, vty, vtz, vtw);
+        CharSoaLoad(float4(c0->varScaleX, c0->varScaleY, c0->varScaleZ, 0.0f),
+                    float4(c1->varScaleX, c1->varScaleY, c1->varScaleZ, 0.0f),
+                    float4(c2->varScaleX, c2->varScaleY, c2->varScaleZ, 0.0f),
+                    float4(c3->varScaleX, c3->varScaleY, c3->varScaleZ, 0.0f),
+                    vsx, vsy, vsz, vsw);
+
+        // rotation matrix from the animation rotation (same as matrix44::rotationquaternion())
+        float4 xx = float4::multiply(qx, qx);
+        float4 yy = float4::multiply(qy, qy);
+        float4 zz = float4::multiply(qz, qz);
+        float4 xy = float4::multiply(qx, qy);
+        float4 xz = float4::multiply(qx, qz);
+        float4 yz = float4::multiply(qy, qz);
+        float4 xw = float4::multiply(qx, qw);
+        float4 yw = float4::multiply(qy, qw);
+        float4 zw = float4::multiply(qz, qw);
+        local.m[0][0] = one - float4::multiply(two, yy + zz);
+        local.m[0][1] = float4::multiply(two, xy + zw);
+        local.m[0][2] = float4::multiply(two, xz - yw);
+        local.m[1][0] = float4::multiply(two, xy - zw);
+        local.m[1][1] = one - float4::multiply(two, xx + zz);
+        local.m[1][2] = float4::multiply(two, yz + xw);
+        local.m[2][0] = float4::multiply(two, xz + yw);
+        local.m[2][1] = float4::multiply(two, yz - xw);
+        local.m[2][2] = one - float4::multiply(two, xx + yy);
+
+        // animation and variation translation
+        local.m[3][0] = tx + vtx;
+        local.m[3][1] = ty + vty;
+        local.m[3][2] = tz + vtz;
+
+        // combine animation and variation scale
+        float4 fsx = float4::multiply(sx, vsx);
+        float4 fsy = float4::multiply(sy, vsy);
+        float4 fsz = float4::multiply(sz, vsz);
+
+        if (InvalidIndex == parentJointIndex)
+        {
+            unscaled = local;
+        }
+        else
+        {
+            // transform our unscaled position with the animation scale
+            // and the parent variation scale (like CharEvalSkeletonJobFunc)
+            const CharJointComponents* pc0 = &lanes[0]->jointComponents[parentJointIndex];
+            const CharJointComponents* pc1 = &lanes[1]->jointComponents[parentJointIndex];
+            const CharJointComponents* pc2 = &lanes[2]->jointComponents[parentJointIndex];
+            const CharJointComponents* pc3 = &lanes[3]->jointComponents[parentJointIndex];
+            CharSoaLoad(float4(pc0->varScaleX, pc0->varScaleY, pc0->varScaleZ, 0.0f),
+                        float4(pc1->varScaleX, pc1->varScaleY, pc1->varScaleZ, 0.0f),
+                        float4(pc2->varScaleX, pc2->varScaleY, pc2->varScaleZ, 0.0f),
+                        float4(pc3->varScaleX, pc3->varScaleY, pc3->varScaleZ, 0.0f),
+                        psx, psy, psz, psw);
+            local.m[3][0] = float4::multiply(local.m[3][0], float4::multiply(sx, psx));
+            local.m[3][1] = float4::multiply(local.m[3][1], float4::multiply(sy, psy));
+            local.m[3][2] = float4::multiply(local.m[3][2], float4::multiply(sz, psz));
+        }
+
+        // scale after rotation
+        IndexT col;
+        for (col = 0; col < 3; col++)
+        {
+            scaled.m[0][col] = float4::multiply(local.m[0][col], fsx);
+            scaled.m[1][col] = float4::multiply(local.m[1][col], fsy);
+            scaled.m[2][col] = float4::multiply(local.m[2][col], fsz);
+            scaled.m[3][col] = local.m[3][col];
+        }
+
+        if (InvalidIndex != parentJointIndex)
+        {
+            // apply rotation and relative animation translation of parent
+            const CharSoaMatrix& parentUnscaled = unscaledMatrixBase[parentJointIndex];
+            CharSoaMultiply(local, parentUnscaled, unscaled);
+            CharSoaMatrix localScaled = scaled;
+            CharSoaMultiply(localScaled, parentUnscaled, scaled);
+        }
+        CharSoaMultiplyShared(invPoseMatrixBase[jointIndex], scaled, skin);
+
+        // write the results of the used lanes
+        CharSoaStore(scaled, affineWColumn, scaledMatrixBase, numLanes, jointIndex);
+        CharSoaStore(skin, float4(invPoseMatrixBase[jointIndex].getrow0().w(),
+                                  invPoseMatrixBase[jointIndex].getrow1().w(),
+                                  invPoseMatrixBase[jointIndex].getrow2().w(),
+                                  invPoseMatrixBase[jointIndex].getrow3().w()),
+                     skinMatrixBase, numLanes, jointIndex);
+    }
+
+    // optionally write to the joint textures
+    for (lane = 0; lane < numLanes; lane++)
+    {
+        if (0 != lanes[lane]->jointTextureRow)
+        {
+            CharJobUtilWriteJointTextureRow(skinMatrixBase[lane], numJoints, lanes[lane]->jointTextureRow);
+        }
+        resultBase[lane] = numJoints;
+    }
+}
+
+} // namespace Characters
@@ -7,18 +7,17 @@
 #include "math/float4.h"
 #include "math/matrix44.h"
 #include "characters/charjointcomponents.h"
+#include "characters/jobs/charjobutil.h"
 
 namespace Characters
 {
 using namespace Math;
 
-#if __XBOX360__
-extern "C" void _WriteBarrier();
-#pragma intrinsic(_WriteBarrier)
-#endif
-
 //------------------------------------------------------------------------------
 /**
+    Joints which are flagged in the joint skip array (input 2) are not
+    evaluated, they simply follow their parent joint (this is used for
+    detail joints at a low animation lod).
 */
 void
 CharEvalSkeletonJobFunc(const JobFuncContext& ctx)
@@ -40,6 +39,7 @@ CharEvalSkeletonJobFunc(const JobFuncContext& ctx)
     n_assert(0 != compsBase);
     const float4* samplesBase = (const float4*) ctx.inputs[1];
     const float4* samplesPtr  = samplesBase;
+    const uchar* jointSkipBase = (const uchar*) ctx.inputs[2];
 
     matrix44* scaledMatrixBase = (matrix44*) ctx.outputs[0];
     matrix44* skinMatrixBase = (matrix44*) ctx.outputs[1];
@@ -62,6 +62,16 @@ CharEvalSkeletonJobFunc(const JobFuncContext& ctx)
         samplesPtr += sampleWidth;
                                      
         const CharJointComponents& comps = compsBase[jointIndex];
+        if (0 != jointSkipBase[jointIndex])
+        {
+            // skipped joint, rigidly follows its parent joint in pose
+            // (the root joint is never skipped)
+            n_assert(InvalidIndex != comps.parentJointIndex);
+            unscaledMatrixBase[jointIndex] = unscaledMatrixBase[comps.parentJointIndex];
+            scaledMatrixBase[jointIndex] = scaledMatrixBase[comps.parentJointIndex];
+            skinMatrixBase[jointIndex] = skinMatrixBase[comps.parentJointIndex];
+            continue;
+        }
         // load variation scale
         finalScale.load(&comps.varScaleX);                
         finalScale = float4::multiply(scale, finalScale);
@@ -112,28 +122,12 @@ CharEvalSkeletonJobFunc(const JobFuncContext& ctx)
         skinMatrixBase[jointIndex] = matrix44::multiply(invPoseMatrixBase[jointIndex], scaledMatrix);
     }
 
-    #if __XBOX360__
-    // on Xbox360, also write to the joint texture
-    matrix44 transSkinMatrix;
-    XMHALF4* texRowPtr = (XMHALF4*) ctx.outputs[2];
-    for (jointIndex = 0; jointIndex < numJoints; jointIndex++)
+    // optionally write to the joint texture (not when evaluating into 
+    // the key palettes of an interpolated update)
+    if (ctx.numOutputs > 2)
     {
-        transSkinMatrix = matrix44::transpose(skinMatrixBase[jointIndex]);
-
-        // Writing the 3x4 matrix to memory.
-        // Note the usage of write barriers here; they instruct the compiler not to
-        // reorder the writes, in case we're writing to write-combined memory.
-        // If the writes happen out of order, the CPU's store-gathering hardware that
-        // is used for write-combined memory will not be used effectively, and the 
-        // entire write operation will be much slower.
-        // cause we use a texture with 16-bit per component, we store a half vector
-        XMStoreHalf4(texRowPtr++, transSkinMatrix.getrow0().vec);
-        _WriteBarrier();
-        XMStoreHalf4(texRowPtr++, transSkinMatrix.getrow1().vec);
-        _WriteBarrier();
-        XMStoreHalf4(texRowPtr++, transSkinMatrix.getrow2().vec);
+        CharJobUtilWriteJointTextureRow(skinMatrixBase, numJoints, ctx.outputs[2]);
     }
-    #endif
 }
 
 } // namespace Characters
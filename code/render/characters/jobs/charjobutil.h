@@ -0,0 +1,55 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @file charjobutil.h
+
+    Utility functions shared by the character skeleton jobs.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "math/float4.h"
+#include "math/matrix44.h"
+
+namespace Characters
+{
+
+#if __XBOX360__
+extern "C" void _WriteBarrier();
+#pragma intrinsic(_WriteBarrier)
+#endif
+
+//------------------------------------------------------------------------------
+/**
+    Write the skin matrices into a row of the joint texture (only on
+    platforms which use GPUTextureSkinning).
+*/
+inline void
+CharJobUtilWriteJointTextureRow(const Math::matrix44* skinMatrixBase, int numJoints, void* texRow)
+{
+    #if __XBOX360__
+    // on Xbox360, also write to the joint texture
+    Math::matrix44 transSkinMatrix;
+    XMHALF4* texRowPtr = (XMHALF4*) texRow;
+    int jointIndex;
+    for (jointIndex = 0; jointIndex < numJoints; jointIndex++)
+    {
+        transSkinMatrix = Math::matrix44::transpose(skinMatrixBase[jointIndex]);
+
+        // Writing the 3x4 matrix to memory.
+        // Note the usage of write barriers here; they instruct the compiler not to
+        // reorder the writes, in case we're writing to write-combined memory.
+        // If the writes happen out of order, the CPU's store-gathering hardware that
+        // is used for write-combined memory will not be used effectively, and the
+        // entire write operation will be much slower.
+        // cause we use a texture with 16-bit per component, we store a half vector
+        XMStoreHalf4(texRowPtr++, transSkinMatrix.getrow0().vec);
+        _WriteBarrier();
+        XMStoreHalf4(texRowPtr++, transSkinMatrix.getrow1().vec);
+        _WriteBarrier();
+        XMStoreHalf4(texRowPtr++, transSkinMatrix.getrow2().vec);
+    }
+    #endif
+}
+
+} // namespace Characters
+//------------------------------------------------------------------------------
@@ -20,9 +20,10 @@ AnimClip::AnimClip() :
     keyDuration(0),
     preInfinityType(InfinityType::Constant),
     postInfinityType(InfinityType::Constant),
-    keySliceFirstKeyIndex(InvalidIndex),
+    keySliceFirstKeyOffset(InvalidIndex),
     keySliceByteSize(0),
     keySliceValuesValid(false),
+    hasQuantizedKeys(false),
     inBeginEvents(false)
 {
     // empty
@@ -126,10 +127,11 @@ AnimClip::GetEventByName(const StringAtom& name) const
 
 //------------------------------------------------------------------------------
 /**
-    Precompute the 2 key slice values (first key index and key slice size).
+    Precompute the 2 key slice values (first key offset and key slice size).
     A key slice is the memory range of all curve-keys at a given 
     key index. The numbers must be pre-computed because only non-static
-    curves have keys in the key-slice.
+    curves have keys in the key-slice, and the size of a key depends
+    on the key format of the curve.
 */
 void
 AnimClip::PrecomputeKeySliceValues()
@@ -144,11 +146,15 @@ AnimClip::PrecomputeKeySliceValues()
         const AnimCurve& curve = this->curves[curveIndex];
         if (!curve.IsStatic())
         {
-            if (InvalidIndex == this->keySliceFirstKeyIndex)
+            if (InvalidIndex == this->keySliceFirstKeyOffset)
             {
-                this->keySliceFirstKeyIndex = curve.GetFirstKeyIndex();
+                this->keySliceFirstKeyOffset = curve.GetFirstKeyOffset();
+            }
+            this->keySliceByteSize += KeyFormat::ByteSize(curve.GetKeyFormat());
+            if (KeyFormat::Float4 != curve.GetKeyFormat())
+            {
+                this->hasQuantizedKeys = true;
             }
-            this->keySliceByteSize += sizeof(float4);
         }
     }
 }
@@ -33,7 +33,7 @@ public:
     void SetNumKeys(SizeT numKeys);
     /// get the number of keys per animation curve in the clip
     SizeT GetNumKeys() const;
-    /// set the key stride (number of float's between keys of the same curve)
+    /// set the key stride (number of bytes between keys of the same curve)
     void SetKeyStride(SizeT stride);
     /// get the key stride
     SizeT GetKeyStride() const;
@@ -86,10 +86,12 @@ public:
     void PrecomputeKeySliceValues();
     /// return true if PrecomputeKeySliceValues had been called
     bool AreKeySliceValuesValid() const;
-    /// get index of first key in clip's key range (this is the key index of the first non-static curve)
-    IndexT GetKeySliceFirstKeyIndex() const;
+    /// get byte offset of first key in clip's key range (this is the key offset of the first non-static curve)
+    IndexT GetKeySliceFirstKeyOffset() const;
     /// get byte size of a key slize in the clip
     SizeT GetKeySliceByteSize() const;
+    /// return true if any non-static curve of the clip has quantized keys
+    bool HasQuantizedKeys() const;
 
 private:
     Util::StringAtom name;
@@ -102,9 +104,10 @@ private:
     Util::FixedArray<AnimCurve> curves;
     Util::Array<AnimEvent> events;
     Util::Dictionary<Util::StringAtom, IndexT> eventIndexMap;
-    IndexT keySliceFirstKeyIndex;       // pre-computed in SetupKeyRange()
+    IndexT keySliceFirstKeyOffset;      // pre-computed in SetupKeyRange()
     SizeT keySliceByteSize;             // pre-computed in SetupKeyRange()
     bool keySliceValuesValid;
+    bool hasQuantizedKeys;              // pre-computed in SetupKeyRange()
     bool inBeginEvents;
 };
 
@@ -114,9 +117,9 @@ private:
     InvalidIndex, this is not an error situation!
 */
 inline IndexT
-AnimClip::GetKeySliceFirstKeyIndex() const
+AnimClip::GetKeySliceFirstKeyOffset() const
 {
-    return this->keySliceFirstKeyIndex;
+    return this->keySliceFirstKeyOffset;
 }
 
 //------------------------------------------------------------------------------
@@ -139,6 +142,15 @@ AnimClip::AreKeySliceValuesValid() const
     return this->keySliceValuesValid;
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+AnimClip::HasQuantizedKeys() const
+{
+    return this->hasQuantizedKeys;
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -11,12 +11,17 @@
     For performance reasons, AnimCurve's are not as flexible as their
     Maya counterparts, for instance it is not possible to set 
     the pre- and post-infinity types per curve, but only per clip.
+
+    The keys of a non-static curve may be stored in a quantized key
+    format (see KeyFormat), the key scale and key bias are used to
+    dequantize Vec48 keys.
     
     (C) 2008 Radon Labs GmbH
 */
 #include "core/types.h"
 #include "coreanimation/curvetype.h"
 #include "coreanimation/infinitytype.h"
+#include "coreanimation/keyformat.h"
 #include "math/float4.h"
 
 //------------------------------------------------------------------------------
@@ -39,19 +44,32 @@ public:
     void SetStaticKey(const Math::float4& staticKey);
     /// get the static key of the curve
     const Math::float4& GetStaticKey() const;
-    /// set index of the first key in the AnimKeyBuffer
-    void SetFirstKeyIndex(IndexT index);
-    /// get index of the first key in the AnimKeyBuffer
-    IndexT GetFirstKeyIndex() const;
+    /// set byte offset of the first key in the AnimKeyBuffer
+    void SetFirstKeyOffset(IndexT offset);
+    /// get byte offset of the first key in the AnimKeyBuffer
+    IndexT GetFirstKeyOffset() const;
     /// set the curve type
     void SetCurveType(CurveType::Code curveType);
     /// get the curve type
     CurveType::Code GetCurveType() const;
+    /// set the key format
+    void SetKeyFormat(KeyFormat::Code keyFormat);
+    /// get the key format
+    KeyFormat::Code GetKeyFormat() const;
+    /// set the dequantization scale and bias of quantized keys
+    void SetKeyQuantization(const Math::float4& scale, const Math::float4& bias);
+    /// get the dequantization scale
+    const Math::float4& GetKeyScale() const;
+    /// get the dequantization bias
+    const Math::float4& GetKeyBias() const;
 
 private:
     Math::float4 staticKey;
-    IndexT firstKeyIndex;
+    Math::float4 keyScale;
+    Math::float4 keyBias;
+    IndexT firstKeyOffset;
     CurveType::Code curveType;
+    KeyFormat::Code keyFormat;
     bool isActive;
     bool isStatic;
 };
@@ -62,8 +80,11 @@ private:
 inline
 AnimCurve::AnimCurve() :
     staticKey(0.0f, 0.0f, 0.0f, 0.0f),
-    firstKeyIndex(0),
+    keyScale(1.0f, 1.0f, 1.0f, 1.0f),
+    keyBias(0.0f, 0.0f, 0.0f, 0.0f),
+    firstKeyOffset(0),
     curveType(CurveType::Float4),
+    keyFormat(KeyFormat::Float4),
     isActive(true),
     isStatic(false)
 {
@@ -128,18 +149,18 @@ AnimCurve::GetStaticKey() const
 /**
 */
 inline void
-AnimCurve::SetFirstKeyIndex(IndexT i)
+AnimCurve::SetFirstKeyOffset(IndexT offset)
 {
-    this->firstKeyIndex = i;
+    this->firstKeyOffset = offset;
 }
 
 //------------------------------------------------------------------------------
 /**
 */
 inline IndexT
-AnimCurve::GetFirstKeyIndex() const
+AnimCurve::GetFirstKeyOffset() const
 {
-    return this->firstKeyIndex;
+    return this->firstKeyOffset;
 }
 
 //------------------------------------------------------------------------------
@@ -160,6 +181,52 @@ AnimCurve::GetCurveType() const
     return this->curveType;
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+AnimCurve::SetKeyFormat(KeyFormat::Code f)
+{
+    this->keyFormat = f;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline KeyFormat::Code
+AnimCurve::GetKeyFormat() const
+{
+    return this->keyFormat;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+AnimCurve::SetKeyQuantization(const Math::float4& scale, const Math::float4& bias)
+{
+    this->keyScale = scale;
+    this->keyBias = bias;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const Math::float4&
+AnimCurve::GetKeyScale() const
+{
+    return this->keyScale;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const Math::float4&
+AnimCurve::GetKeyBias() const
+{
+    return this->keyBias;
+}
+
 } // namespace AnimCurve
 //------------------------------------------------------------------------------
     
\ No newline at end of file
@@ -16,7 +16,7 @@ using namespace Math;
 /**
 */
 AnimKeyBuffer::AnimKeyBuffer() :
-    numKeys(0),
+    byteSize(0),
     mapCount(0),
     keyBuffer(0)
 {
@@ -38,11 +38,11 @@ AnimKeyBuffer::~AnimKeyBuffer()
 /**
 */
 void
-AnimKeyBuffer::Setup(SizeT numKeys_)
+AnimKeyBuffer::Setup(SizeT byteSize_)
 {
     n_assert(!this->IsValid());
     n_assert(!this->IsMapped());
-    this->numKeys = numKeys_;
+    this->byteSize = byteSize_;
     this->mapCount = 0;
     this->keyBuffer = Memory::Alloc(Memory::ResourceHeap, this->GetByteSize());
 }
@@ -57,7 +57,7 @@ AnimKeyBuffer::Discard()
     n_assert(!this->IsMapped());
     Memory::Free(Memory::ResourceHeap, this->keyBuffer);
     this->keyBuffer = 0;
-    this->numKeys = 0;
+    this->byteSize = 0;
 }
 
 //------------------------------------------------------------------------------
@@ -3,7 +3,9 @@
 /**
     @class CoreAnimation::AnimKeyBuffer
     
-    A simple buffer of float4 animation keys.
+    A simple buffer of animation keys. Depending on the key format of 
+    the anim curves, the buffer contains float4 keys or quantized keys, 
+    so the buffer is addressed by byte offsets.
     
     (C) 2008 Radon Labs GmbH
 */
@@ -21,13 +23,11 @@ public:
     /// destructor
     virtual ~AnimKeyBuffer();
     /// setup the buffer
-    void Setup(SizeT numKeys);
+    void Setup(SizeT byteSize);
     /// discard the buffer
     void Discard();
     /// return true if the object has been setup
     bool IsValid() const;
-    /// get number of keys in buffer
-    SizeT GetNumKeys() const;
     /// get buffer size in bytes
     SizeT GetByteSize() const;
     /// (obsolete) map key buffer for CPU access
@@ -37,10 +37,10 @@ public:
     /// return true if the key buffer is currently mapped
     bool IsMapped() const;
     /// get direct pointer to key buffer
-    Math::float4* GetKeyBufferPointer() const;
+    uchar* GetKeyBufferPointer() const;
 
 private:
-    SizeT numKeys;
+    SizeT byteSize;
     uint mapCount;
     void* keyBuffer;
 };
@@ -63,31 +63,22 @@ AnimKeyBuffer::IsMapped() const
     return (0 != this->mapCount);
 }
 
-//------------------------------------------------------------------------------
-/**
-*/
-inline SizeT
-AnimKeyBuffer::GetNumKeys() const
-{
-    return this->numKeys;
-}
-
 //------------------------------------------------------------------------------
 /**
 */
 inline SizeT
 AnimKeyBuffer::GetByteSize() const
 {
-    return this->numKeys * sizeof(Math::float4);
+    return this->byteSize;
 }
 
 //------------------------------------------------------------------------------
 /**
 */
-inline Math::float4*
+inline uchar*
 AnimKeyBuffer::GetKeyBufferPointer() const
 {
-    return (Math::float4*) this->keyBuffer;
+    return (uchar*) this->keyBuffer;
 }
 
 } // namespace CoreAnimation
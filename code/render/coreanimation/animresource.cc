@@ -4,6 +4,7 @@
 //------------------------------------------------------------------------------
 #include "stdneb.h"
 #include "coreanimation/animresource.h"
+#include "coreanimation/jobs/animjobutil.h"
 
 namespace CoreAnimation
 {
@@ -53,11 +54,11 @@ AnimResource::Unload()
     the animation key buffer.
 */
 const Ptr<AnimKeyBuffer>&
-AnimResource::SetupKeyBuffer(SizeT numKeysInBuffer)
+AnimResource::SetupKeyBuffer(SizeT keyBufferByteSize)
 {
     n_assert(!this->animKeyBuffer.isvalid());
     this->animKeyBuffer = AnimKeyBuffer::Create();
-    this->animKeyBuffer->Setup(numKeysInBuffer);
+    this->animKeyBuffer->Setup(keyBufferByteSize);
     return this->animKeyBuffer;
 }
 
@@ -137,13 +138,13 @@ AnimResource::BuildClipIndexMap()
     means there are exist no actual keys), then the method will return
     a NULL pointer, and an outSliceByteSlice of 0.
 */
-const float4*
+const uchar*
 AnimResource::ComputeKeySlicePointerAndSize(IndexT clipIndex, IndexT keyIndex, SizeT& outSliceByteSize) const
 {
     const AnimClip& clip = this->animClips[clipIndex];
     n_assert(clip.AreKeySliceValuesValid());
-    IndexT firstKeyIndex = clip.GetKeySliceFirstKeyIndex();
-    if (InvalidIndex == firstKeyIndex)
+    IndexT firstKeyOffset = clip.GetKeySliceFirstKeyOffset();
+    if (InvalidIndex == firstKeyOffset)
     {
         // all curves of the clip are static
         outSliceByteSize = 0;
@@ -152,10 +153,45 @@ AnimResource::ComputeKeySlicePointerAndSize(IndexT clipIndex, IndexT keyIndex, S
     else
     {
         outSliceByteSize = clip.GetKeySliceByteSize();
-        IndexT sliceKeyIndex = firstKeyIndex + keyIndex * clip.GetKeyStride();
-        const float4* sliceKeyPtr = this->animKeyBuffer->GetKeyBufferPointer() + sliceKeyIndex;
+        IndexT sliceKeyOffset = firstKeyOffset + keyIndex * clip.GetKeyStride();
+        const uchar* sliceKeyPtr = this->animKeyBuffer->GetKeyBufferPointer() + sliceKeyOffset;
         return sliceKeyPtr;
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+    Compute the pointer to a key of a non-static curve in the key buffer.
+    The key may be quantized, use GetKey() to read a key.
+*/
+const uchar*
+AnimResource::ComputeKeyPointer(IndexT clipIndex, IndexT curveIndex, IndexT keyIndex) const
+{
+    const AnimClip& clip = this->animClips[clipIndex];
+    const AnimCurve& curve = clip.CurveByIndex(curveIndex);
+    n_assert(!curve.IsStatic());
+    IndexT keyOffset = curve.GetFirstKeyOffset() + keyIndex * clip.GetKeyStride();
+    n_assert((keyOffset + KeyFormat::ByteSize(curve.GetKeyFormat())) <= this->animKeyBuffer->GetByteSize());
+    return this->animKeyBuffer->GetKeyBufferPointer() + keyOffset;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Get a key of a curve, quantized keys are decoded. For static curves
+    the static key is returned.
+*/
+float4
+AnimResource::GetKey(IndexT clipIndex, IndexT curveIndex, IndexT keyIndex) const
+{
+    const AnimCurve& curve = this->animClips[clipIndex].CurveByIndex(curveIndex);
+    if (curve.IsStatic())
+    {
+        return curve.GetStaticKey();
+    }
+    else
+    {
+        return AnimJobUtilDecodeKey(curve, this->ComputeKeyPointer(clipIndex, curveIndex, keyIndex));
+    }
+}
+
 } // namespace CoreAnimation
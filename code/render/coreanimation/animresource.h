@@ -13,6 +13,7 @@
 #include "resources/resource.h"
 #include "coreanimation/animclip.h"
 #include "coreanimation/animkeybuffer.h"
+#include "math/float4.h"
 
 //------------------------------------------------------------------------------
 namespace CoreAnimation
@@ -43,13 +44,17 @@ public:
     const Ptr<AnimKeyBuffer>& GetKeyBuffer() const;
 
     /// get pointer to start of a key slice, and return size of a key slice
-    const Math::float4* ComputeKeySlicePointerAndSize(IndexT clipIndex, IndexT keyIndex, SizeT& outSliceByteSize) const;
+    const uchar* ComputeKeySlicePointerAndSize(IndexT clipIndex, IndexT keyIndex, SizeT& outSliceByteSize) const;
+    /// get pointer to the key of a non-static curve
+    const uchar* ComputeKeyPointer(IndexT clipIndex, IndexT curveIndex, IndexT keyIndex) const;
+    /// get a dequantized key of a curve
+    Math::float4 GetKey(IndexT clipIndex, IndexT curveIndex, IndexT keyIndex) const;
 
 private:
     friend class StreamAnimationLoader;
 
     /// setup the object, called by the resource loader
-    const Ptr<AnimKeyBuffer>& SetupKeyBuffer(SizeT numKeysInBuffer);
+    const Ptr<AnimKeyBuffer>& SetupKeyBuffer(SizeT keyBufferByteSize);
     /// begin setting up clips, called by the resource loader
     void BeginSetupClips(SizeT numClips);
     /// access to anim clip for setup
@@ -20,6 +20,7 @@ struct NEBULA3_ALIGN16 AnimSampleMixInfo
     SampleType::Code sampleType;
     float sampleWeight;
     float mixWeight;
+    bool hasQuantizedKeys;          // if true, the key slices must be decoded
     Math::float4 velocityScale;
 };
 
@@ -5,6 +5,7 @@
 #include "stdneb.h"
 #include "coreanimation/animutil.h"
 #include "coreanimation/animsamplemixinfo.h"
+#include "coreanimation/jobs/animjobutil.h"
 #include "math/quaternion.h"
 #include "util/round.h"
 
@@ -125,7 +126,6 @@ AnimUtil::Sample(const Ptr<AnimResource>& animResource,
     n_assert((sampleType == SampleType::Step) || (sampleType == SampleType::Linear));
  
     const AnimClip& clip = animResource->GetClipByIndex(clipIndex);
-    SizeT keyStride  = clip.GetKeyStride();
     Tick keyDuration = clip.GetKeyDuration();
     n_assert(clip.GetNumCurves() == result->GetNumSamples());
 
@@ -134,82 +134,36 @@ AnimUtil::Sample(const Ptr<AnimResource>& animResource,
     IndexT keyIndex1 = AnimUtil::ClampKeyIndex(keyIndex0 + 1, clip);
     Tick inbetweenTicks = AnimUtil::InbetweenTicks(time, clip);
     float lerpValue = float(inbetweenTicks) / float(keyDuration);  
+    float4 velocityScale(timeFactor, timeFactor, timeFactor, 1.0f);
 
-    // sample curves...
-    float4 f4Key0, f4Key1, f4SampleKey;
-    quaternion qKey0, qKey1, qSampleKey;
-    float4 vecOne(1.0f, 1.0f, 1.0f, 1.0f);
-    float4 scaleVec;
-
-    float4* srcKeyStart = animResource->GetKeyBuffer()->GetKeyBufferPointer();
+    // sample curves with the same functions as the sampling jobs
+    SizeT src0ByteSize, src1ByteSize;
+    const uchar* src0SamplePtr = animResource->ComputeKeySlicePointerAndSize(clipIndex, keyIndex0, src0ByteSize);
+    const uchar* src1SamplePtr = animResource->ComputeKeySlicePointerAndSize(clipIndex, keyIndex1, src1ByteSize);
+    const AnimCurve* curves = &(clip.CurveByIndex(0));
+    SizeT numCurves = clip.GetNumCurves();
     float4* dstKeyBuffer = result->GetSamplesPointer();
     uchar* dstSampleCounts = result->GetSampleCountsPointer();
-    IndexT curveIndex;
-    SizeT numCurves = clip.GetNumCurves();
-    for (curveIndex = 0; curveIndex < numCurves; curveIndex++)
+    if (clip.HasQuantizedKeys())
     {
-        const AnimCurve& curve = clip.CurveByIndex(curveIndex);
-        if (!curve.IsActive())
+        if (SampleType::Step == sampleType)
         {
-            // curve is not active, set sample count to 0
-            dstSampleCounts[curveIndex] = 0;            
+            AnimJobUtilSampleStepQuantized(curves, numCurves, velocityScale, src0SamplePtr, dstKeyBuffer, dstSampleCounts);
         }
         else
         {
-            if (curve.GetCurveType() == CurveType::Velocity)
-            {
-                scaleVec.set(timeFactor, timeFactor, timeFactor, 1.0f);
-            }
-            else
-            {
-                scaleVec = vecOne;
-            }
-
-            // curve is active, set sample count to 1
-            dstSampleCounts[curveIndex] = 1;
-            scalar* resultPtr = (scalar*) &(dstKeyBuffer[curveIndex]);
-            if (curve.IsStatic())
-            {
-                // the curve is constant, just copy the constant value into the result buffer
-                float4 val = float4::multiply(curve.GetStaticKey(), scaleVec);
-                val.store(resultPtr);
-            }
-            else
-            {
-                // non-static curve, need to actually sample the result
-                IndexT startKeyIndex = curve.GetFirstKeyIndex();
-
-                // compute position of first key in source key buffer
-                scalar* keyPtr0 = (scalar*) (srcKeyStart + startKeyIndex + (keyIndex0 * keyStride));
-                if (SampleType::Step == sampleType)
-                {
-                    // if no interpolation needed, just copy the key to the sample buffer
-                    f4SampleKey.load(keyPtr0);
-                    f4SampleKey = float4::multiply(f4SampleKey, scaleVec);
-                    f4SampleKey.store(resultPtr);
-                }
-                else
-                {
-                    // need to interpolate between 2 keys
-                    scalar* keyPtr1 = (scalar*) (srcKeyStart + startKeyIndex + (keyIndex1 * keyStride));
-                    if (curve.GetCurveType() == CurveType::Rotation)
-                    {
-                        // perform spherical interpolation
-                        qKey0.load(keyPtr0);
-                        qKey1.load(keyPtr1);
-                        qSampleKey = quaternion::slerp(qKey0, qKey1, lerpValue);
-                        qSampleKey.store(resultPtr);
-                    }
-                    else
-                    {
-                        // perform linear interpolation
-                        f4Key0.load(keyPtr0);
-                        f4Key1.load(keyPtr1);
-                        f4SampleKey = float4::multiply(float4::lerp(f4Key0, f4Key1, lerpValue), scaleVec);
-                        f4SampleKey.store(resultPtr);
-                    }
-                }
-            }            
+            AnimJobUtilSampleLinearQuantized(curves, numCurves, lerpValue, velocityScale, src0SamplePtr, src1SamplePtr, dstKeyBuffer, dstSampleCounts);
+        }
+    }
+    else
+    {
+        if (SampleType::Step == sampleType)
+        {
+            AnimJobUtilSampleStep(curves, numCurves, velocityScale, (const float4*)src0SamplePtr, dstKeyBuffer, dstSampleCounts);
+        }
+        else
+        {
+            AnimJobUtilSampleLinear(curves, numCurves, lerpValue, velocityScale, (const float4*)src0SamplePtr, (const float4*)src1SamplePtr, dstKeyBuffer, dstSampleCounts);
         }
     }
 }
@@ -244,11 +198,12 @@ AnimUtil::CreateSampleJob(const Ptr<AnimResource>& animResource,
     sampleMixInfo->sampleType = sampleType;
     sampleMixInfo->sampleWeight = float(inbetweenTicks) / float(keyDuration);
     sampleMixInfo->velocityScale.set(timeFactor, timeFactor, timeFactor, 1.0f);
+    sampleMixInfo->hasQuantizedKeys = clip.HasQuantizedKeys();
 
     // get start pointers to source keys
     SizeT src0ByteSize, src1ByteSize;
-    const float4* src0SamplePtr = animResource->ComputeKeySlicePointerAndSize(clipIndex, keyIndex0, src0ByteSize);
-    const float4* src1SamplePtr = animResource->ComputeKeySlicePointerAndSize(clipIndex, keyIndex1, src1ByteSize);
+    const uchar* src0SamplePtr = animResource->ComputeKeySlicePointerAndSize(clipIndex, keyIndex0, src0ByteSize);
+    const uchar* src1SamplePtr = animResource->ComputeKeySlicePointerAndSize(clipIndex, keyIndex1, src1ByteSize);
 
     // get pointers to output buffers
     float4* outSamplesPtr = resultBuffer->GetSamplesPointer();
@@ -309,11 +264,12 @@ AnimUtil::CreateSampleAndMixJob(const Ptr<AnimResource>& animResource,
     sampleMixInfo->sampleWeight = float(inbetweenTicks) / float(keyDuration);
     sampleMixInfo->velocityScale.set(timeFactor, timeFactor, timeFactor, 1.0f);
     sampleMixInfo->mixWeight = mixWeight;
+    sampleMixInfo->hasQuantizedKeys = clip.HasQuantizedKeys();
 
     // get start pointers to source keys
     SizeT src0ByteSize, src1ByteSize;
-    const float4* src0SamplePtr = animResource->ComputeKeySlicePointerAndSize(clipIndex, keyIndex0, src0ByteSize);
-    const float4* src1SamplePtr = animResource->ComputeKeySlicePointerAndSize(clipIndex, keyIndex1, src1ByteSize);
+    const uchar* src0SamplePtr = animResource->ComputeKeySlicePointerAndSize(clipIndex, keyIndex0, src0ByteSize);
+    const uchar* src1SamplePtr = animResource->ComputeKeySlicePointerAndSize(clipIndex, keyIndex1, src1ByteSize);
     const float4* mixSamplePtr = mixIn->GetSamplesPointer();
     uchar* mixSampleCounts = mixIn->GetSampleCountsPointer();
     SizeT mixNumSamples = mixIn->GetNumSamples();
@@ -22,18 +22,32 @@ AnimSampleJobFunc(const JobFuncContext& ctx)
     const AnimCurve* animCurves = (const AnimCurve*) ctx.uniforms[0];
     int numCurves = ctx.uniformSizes[0] / sizeof(AnimCurve);
     const AnimSampleMixInfo* info = (const AnimSampleMixInfo*) ctx.uniforms[1];
-    const float4* src0SamplePtr = (const float4*) ctx.inputs[0];
-    const float4* src1SamplePtr = (const float4*) ctx.inputs[1];
+    const uchar* src0SamplePtr = ctx.inputs[0];
+    const uchar* src1SamplePtr = ctx.inputs[1];
     float4* outSamplePtr = (float4*) ctx.outputs[0];
     uchar* outSampleCounts = ctx.outputs[1];
 
-    if (SampleType::Step == info->sampleType)
+    if (info->hasQuantizedKeys)
     {
-        AnimJobUtilSampleStep(animCurves, numCurves, info->velocityScale, src0SamplePtr, outSamplePtr, outSampleCounts);
+        if (SampleType::Step == info->sampleType)
+        {
+            AnimJobUtilSampleStepQuantized(animCurves, numCurves, info->velocityScale, src0SamplePtr, outSamplePtr, outSampleCounts);
+        }
+        else
+        {
+            AnimJobUtilSampleLinearQuantized(animCurves, numCurves, info->sampleWeight, info->velocityScale, src0SamplePtr, src1SamplePtr, outSamplePtr, outSampleCounts);
+        }
     }
     else
     {
-        AnimJobUtilSampleLinear(animCurves, numCurves, info->sampleWeight, info->velocityScale, src0SamplePtr, src1SamplePtr, outSamplePtr, outSampleCounts);
+        if (SampleType::Step == info->sampleType)
+        {
+            AnimJobUtilSampleStep(animCurves, numCurves, info->velocityScale, (const float4*)src0SamplePtr, outSamplePtr, outSampleCounts);
+        }
+        else
+        {
+            AnimJobUtilSampleLinear(animCurves, numCurves, info->sampleWeight, info->velocityScale, (const float4*)src0SamplePtr, (const float4*)src1SamplePtr, outSamplePtr, outSampleCounts);
+        }
     }
 }
 
@@ -21,8 +21,8 @@ AnimSampleMixJobFunc(const JobFuncContext& ctx)
     const AnimCurve* animCurves = (const AnimCurve*) ctx.uniforms[0];
     int numCurves = ctx.uniformSizes[0] / sizeof(AnimCurve);
     const AnimSampleMixInfo* info = (const AnimSampleMixInfo*) ctx.uniforms[1];
-    const float4* src0SamplePtr = (const float4*) ctx.inputs[0];
-    const float4* src1SamplePtr = (const float4*) ctx.inputs[1];
+    const uchar* src0SamplePtr = ctx.inputs[0];
+    const uchar* src1SamplePtr = ctx.inputs[1];
     const float4* mixSamplePtr  = (const float4*) ctx.inputs[2];
     float4* tmpSamplePtr   = (float4*) ctx.scratch;
     uchar* tmpSampleCounts = (uchar*) (tmpSamplePtr + numCurves);
@@ -31,13 +31,27 @@ AnimSampleMixJobFunc(const JobFuncContext& ctx)
     uchar* outSampleCounts = ctx.outputs[1];
 
     // first perform sampling step...
-    if (SampleType::Step == info->sampleType)
+    if (info->hasQuantizedKeys)
     {
-        AnimJobUtilSampleStep(animCurves, numCurves, info->velocityScale, src0SamplePtr, tmpSamplePtr, tmpSampleCounts);
+        if (SampleType::Step == info->sampleType)
+        {
+            AnimJobUtilSampleStepQuantized(animCurves, numCurves, info->velocityScale, src0SamplePtr, tmpSamplePtr, tmpSampleCounts);
+        }
+        else
+        {
+            AnimJobUtilSampleLinearQuantized(animCurves, numCurves, info->sampleWeight, info->velocityScale, src0SamplePtr, src1SamplePtr, tmpSamplePtr, tmpSampleCounts);
+        }
     }
     else
     {
-        AnimJobUtilSampleLinear(animCurves, numCurves, info->sampleWeight, info->velocityScale, src0SamplePtr, src1SamplePtr, tmpSamplePtr, tmpSampleCounts);
+        if (SampleType::Step == info->sampleType)
+        {
+            AnimJobUtilSampleStep(animCurves, numCurves, info->velocityScale, (const float4*)src0SamplePtr, tmpSamplePtr, tmpSampleCounts);
+        }
+        else
+        {
+            AnimJobUtilSampleLinear(animCurves, numCurves, info->sampleWeight, info->velocityScale, (const float4*)src0SamplePtr, (const float4*)src1SamplePtr, tmpSamplePtr, tmpSampleCounts);
+        }
     }
     
     // ...then mixing, NOTE: outSamplePtr and outSampleCounts are read and overwritten!
@@ -16,6 +16,79 @@ namespace CoreAnimation
 
 using namespace Math;
 
+/// largest absolute value of the 3 smallest components of a unit quaternion (1/sqrt(2))
+const scalar AnimJobUtilQuat48Range = 0.707106781f;
+/// 15-bit quantization step of a smallest-three component
+const scalar AnimJobUtilQuat48Scale = (2.0f * AnimJobUtilQuat48Range) / 32767.0f;
+
+//------------------------------------------------------------------------------
+/**
+    Load the 3 raw unsigned shorts of a Vec48 key as float4 with w = 0.
+*/
+inline float4
+AnimJobUtilLoadVec48(const uchar* keyPtr)
+{
+    const ushort* q = (const ushort*) keyPtr;
+    return float4(scalar(q[0]), scalar(q[1]), scalar(q[2]), 0.0f);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Dequantize raw Vec48 values, the w component is taken from the bias.
+*/
+inline float4
+AnimJobUtilDequantizeVec48(const float4& raw, const AnimCurve& curve)
+{
+    return float4::multiply(raw, curve.GetKeyScale()) + curve.GetKeyBias();
+}
+
+//------------------------------------------------------------------------------
+/**
+    Decode a smallest-three Quat48 key. The omitted largest component
+    is always positive, and is reconstructed from the unit length.
+*/
+inline float4
+AnimJobUtilDecodeQuat48(const uchar* keyPtr)
+{
+    const ushort* q = (const ushort*) keyPtr;
+    uint largestIndex = (q[0] >> 15) | ((q[1] >> 15) << 1);
+    float4 abc(scalar(q[0] & 0x7fff), scalar(q[1] & 0x7fff), scalar(q[2] & 0x7fff), 0.0f);
+    abc = float4::multiply(abc, float4(AnimJobUtilQuat48Scale, AnimJobUtilQuat48Scale, AnimJobUtilQuat48Scale, 0.0f)) -
+          float4(AnimJobUtilQuat48Range, AnimJobUtilQuat48Range, AnimJobUtilQuat48Range, 0.0f);
+    scalar sq = 1.0f - float4::dot3(abc, abc);
+    scalar d = (sq > 0.0f) ? n_sqrt(sq) : 0.0f;
+    switch (largestIndex)
+    {
+        case 0:     return float4(d, abc.x(), abc.y(), abc.z());
+        case 1:     return float4(abc.x(), d, abc.y(), abc.z());
+        case 2:     return float4(abc.x(), abc.y(), d, abc.z());
+        default:    return float4(abc.x(), abc.y(), abc.z(), d);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Decode a single key of a non-static curve.
+*/
+inline float4
+AnimJobUtilDecodeKey(const AnimCurve& curve, const uchar* keyPtr)
+{
+    float4 key;
+    switch (curve.GetKeyFormat())
+    {
+        case KeyFormat::Quat48:
+            key = AnimJobUtilDecodeQuat48(keyPtr);
+            break;
+        case KeyFormat::Vec48:
+            key = AnimJobUtilDequantizeVec48(AnimJobUtilLoadVec48(keyPtr), curve);
+            break;
+        default:
+            key.loadu((const scalar*)keyPtr);
+            break;
+    }
+    return key;
+}
+
 //------------------------------------------------------------------------------
 /**
     Sampler for "step" interpolation type.
@@ -135,6 +208,150 @@ AnimJobUtilSampleLinear(const AnimCurve* curves,
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+    Sampler for "step" interpolation type on a key slice which contains
+    quantized keys. The keys of the non-static curves are packed in curve
+    order, the size of each key depends on the key format of its curve.
+*/
+inline void
+AnimJobUtilSampleStepQuantized(const AnimCurve* curves,
+                               int numCurves,
+                               const float4& velocityScale,
+                               const uchar* src0SamplePtr,
+                               float4* outSamplePtr,
+                               uchar* outSampleCounts)
+{
+    float4 f0;
+    int i;
+    for (i = 0; i < numCurves; i++)
+    {
+        const AnimCurve& curve = curves[i];
+        if (!curve.IsActive())
+        {
+            // an inactive curve, set sample count to 0
+            outSampleCounts[i] = 0;
+            if (!curve.IsStatic())
+            {
+                src0SamplePtr += KeyFormat::ByteSize(curve.GetKeyFormat());
+            }
+        }
+        else
+        {
+            // curve is active, set sample count to 1
+            outSampleCounts[i] = 1;
+
+            if (curve.IsStatic())
+            {
+                f0 = curve.GetStaticKey();
+            }
+            else
+            {
+                f0 = AnimJobUtilDecodeKey(curve, src0SamplePtr);
+                src0SamplePtr += KeyFormat::ByteSize(curve.GetKeyFormat());
+            }
+
+            // if a velocity curve, multiply the velocity scale
+            // (this is necessary if time factor is != 1)
+            if (curve.GetCurveType() == CurveType::Velocity)
+            {
+                f0 = float4::multiply(f0, velocityScale);
+            }
+            f0.store((scalar*)outSamplePtr);
+        }
+        outSamplePtr++;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Sampler for "linear" interpolation type on a key slice which contains
+    quantized keys. Vec48 keys are interpolated before dequantization, 
+    so that only one multiply-add is needed per sample. Quat48 keys are
+    decoded and interpolated spherically.
+*/
+inline void
+AnimJobUtilSampleLinearQuantized(const AnimCurve* curves,
+                                 int numCurves,
+                                 float sampleWeight,
+                                 const float4& velocityScale,
+                                 const uchar* src0SamplePtr,
+                                 const uchar* src1SamplePtr,
+                                 float4* outSamplePtr,
+                                 uchar* outSampleCounts)
+{
+    float4 f0, f1, fDst;
+    quaternion qDst;
+    int i;
+    for (i = 0; i < numCurves; i++)
+    {
+        const AnimCurve& curve = curves[i];
+        KeyFormat::Code keyFormat = curve.GetKeyFormat();
+        if (!curve.IsActive())
+        {
+            // an inactive curve, set sample count to 0
+            outSampleCounts[i] = 0;
+            if (!curve.IsStatic())
+            {
+                src0SamplePtr += KeyFormat::ByteSize(keyFormat);
+                src1SamplePtr += KeyFormat::ByteSize(keyFormat);
+            }
+        }
+        else
+        {
+            CurveType::Code curveType = curve.GetCurveType();
+
+            // curve is active, set sample count to 1
+            outSampleCounts[i] = 1;
+
+            if (curve.IsStatic())
+            {
+                // a static curve, just copy the curve's static key as output
+                fDst = curve.GetStaticKey();
+                if (CurveType::Velocity == curveType)
+                {
+                    fDst = float4::multiply(fDst, velocityScale);
+                }
+                fDst.store((scalar*)outSamplePtr);
+            }
+            else
+            {
+                // NOTE: rotation curves are either Quat48 or Float4
+                if (CurveType::Rotation == curveType)
+                {
+                    f0 = AnimJobUtilDecodeKey(curve, src0SamplePtr);
+                    f1 = AnimJobUtilDecodeKey(curve, src1SamplePtr);
+                    qDst = quaternion::slerp(quaternion(f0), quaternion(f1), sampleWeight);
+                    qDst.store((scalar*)outSamplePtr);
+                }
+                else
+                {
+                    if (KeyFormat::Vec48 == keyFormat)
+                    {
+                        f0 = AnimJobUtilLoadVec48(src0SamplePtr);
+                        f1 = AnimJobUtilLoadVec48(src1SamplePtr);
+                        fDst = AnimJobUtilDequantizeVec48(float4::lerp(f0, f1, sampleWeight), curve);
+                    }
+                    else
+                    {
+                        f0 = AnimJobUtilDecodeKey(curve, src0SamplePtr);
+                        f1 = AnimJobUtilDecodeKey(curve, src1SamplePtr);
+                        fDst = float4::lerp(f0, f1, sampleWeight);
+                    }
+                    if (CurveType::Velocity == curveType)
+                    {
+                        fDst = float4::multiply(fDst, velocityScale);
+                    }
+                    fDst.store((scalar*)outSamplePtr);
+                }
+                src0SamplePtr += KeyFormat::ByteSize(keyFormat);
+                src1SamplePtr += KeyFormat::ByteSize(keyFormat);
+            }
+        }
+        outSamplePtr++;
+    }
+}
+
 //------------------------------------------------------------------------------
 /**
     Mixes 2 source sample buffers into a destination sample buffer using a
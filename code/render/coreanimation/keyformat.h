@@ -0,0 +1,59 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class CoreAnimation::KeyFormat
+  
+    Describes how the keys of an animation curve are stored in the
+    AnimKeyBuffer. NAX3 files only contain Float4 keys, NAX4 files
+    may contain quantized keys:
+
+    - Float4: 4 floats (16 bytes)
+    - Quat48: smallest-three quaternion, 3 unsigned shorts (6 bytes), the
+      low 15 bits of each short hold one of the 3 smallest components,
+      the top bits of the first 2 shorts hold the index of the omitted
+      largest component
+    - Vec48: range-quantized vector, 3 unsigned shorts (6 bytes), the 
+      curve's key scale and key bias are used to dequantize x, y and z, 
+      w is taken from the key bias
+    
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+
+//------------------------------------------------------------------------------
+namespace CoreAnimation
+{
+class KeyFormat
+{
+public:
+    /// key formats
+    enum Code
+    {
+        Float4,         //> uncompressed 4D key
+        Quat48,         //> 48-bit smallest-three quaternion
+        Vec48,          //> 48-bit range-quantized vector
+
+        NumKeyFormats,
+        InvalidKeyFormat,
+    };
+
+    /// get the byte size of a key in the given format
+    static SizeT ByteSize(Code c);
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+KeyFormat::ByteSize(Code c)
+{
+    switch (c)
+    {
+        case Quat48:    return 6;
+        case Vec48:     return 6;
+        default:        return 16;
+    }
+}
+
+} // namespace CoreAnimation
+//------------------------------------------------------------------------------
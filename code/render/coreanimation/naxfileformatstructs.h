@@ -14,6 +14,7 @@ namespace CoreAnimation
 #pragma pack(push, 1)
 
 #define NEBULA3_NAX3_MAGICNUMBER 'NA01'
+#define NEBULA3_NAX4_MAGICNUMBER 'NA04'
 
 //------------------------------------------------------------------------------
 /** 
@@ -61,6 +62,44 @@ struct Nax3Curve
     float staticKeyW;
 };
 
+//------------------------------------------------------------------------------
+/** 
+    NAX4 file format structs. NAX4 files use the Nax3Clip and Nax3AnimEvent
+    structs, but the keyStride of a clip is the byte size of a key slice
+    (padded to 16 bytes). The keys of a non-static curve are stored in 
+    the curve's key format (see CoreAnimation::KeyFormat), the key data
+    starts 16-byte aligned relative to the start of the key data block.
+
+    NOTE: keep all header-structs 4-byte aligned!
+*/
+struct Nax4Header
+{
+    uint magic;
+    uint numClips;
+    uint keyBufferSize;             // byte size of the key data
+};
+
+struct Nax4Curve
+{
+    uint firstKeyOffset;            // byte offset of the first key in the key data
+    uchar isActive;                 // 0 or 1
+    uchar isStatic;                 // 0 or 1
+    uchar curveType;                // CoreAnimation::CurveType::Code
+    uchar keyFormat;                // CoreAnimation::KeyFormat::Code
+    float staticKeyX;
+    float staticKeyY;
+    float staticKeyZ;
+    float staticKeyW;
+    float keyScaleX;                // dequantization scale of Vec48 keys
+    float keyScaleY;
+    float keyScaleZ;
+    float keyScaleW;
+    float keyBiasX;                 // dequantization bias of Vec48 keys
+    float keyBiasY;
+    float keyBiasZ;
+    float keyBiasW;
+};
+
 //------------------------------------------------------------------------------
 /** 
     legacy NAX2 file format structs
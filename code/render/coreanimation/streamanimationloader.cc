@@ -25,95 +25,174 @@ StreamAnimationLoader::SetupResourceFromStream(const Ptr<Stream>& stream)
 {
     n_assert(stream.isvalid());
     n_assert(this->resource.isvalid());
-    return this->SetupFromNax3(stream);
+    n_assert(!this->resource.downcast<AnimResource>()->IsLoaded());
+    stream->SetAccessMode(Stream::ReadAccess);
+    // the file is parsed front to back from the mapped pages
+    stream->SetAccessPattern(Stream::Sequential);
+    if (stream->Open())
+    {
+        const uchar* ptr = (const uchar*) stream->Map();
+
+        // check magic value, NAX3 and NAX4 headers start with the magic number
+        FourCC magic(*(const uint*)ptr);
+        if (magic == NEBULA3_NAX3_MAGICNUMBER)
+        {
+            this->SetupFromNax3(ptr);
+        }
+        else if (magic == NEBULA3_NAX4_MAGICNUMBER)
+        {
+            this->SetupFromNax4(ptr);
+        }
+        else
+        {
+            n_error("StreamAnimationLoader::SetupResourceFromStream(): '%s' has invalid file format (magic number doesn't match)!", stream->GetURI().AsString().AsCharPtr());
+            return false;
+        }
+
+        // shutdown stream
+        stream->Unmap();
+        stream->Close();
+        return true;
+    }
+    return false;
 }
 
 //------------------------------------------------------------------------------
 /**
+    Setup the attributes and anim events of a clip, returns the pointer
+    behind the anim events.
 */
-bool
-StreamAnimationLoader::SetupFromNax3(const Ptr<Stream>& stream)
+const uchar*
+StreamAnimationLoader::SetupClip(const uchar* ptr, AnimClip& clip)
 {
-    const Ptr<AnimResource>& anim = this->resource.downcast<AnimResource>();
-    n_assert(!anim->IsLoaded());
-    stream->SetAccessMode(Stream::ReadAccess);
-    if (stream->Open())
+    const Nax3Clip* naxClip = (const Nax3Clip*) ptr;
+    ptr += sizeof(Nax3Clip);
+
+    // setup anim clip object
+    clip.SetNumCurves(naxClip->numCurves);
+    clip.SetStartKeyIndex(naxClip->startKeyIndex);
+    clip.SetNumKeys(naxClip->numKeys);
+    clip.SetKeyDuration(naxClip->keyDuration);
+    clip.SetPreInfinityType((InfinityType::Code)naxClip->preInfinityType);
+    clip.SetPostInfinityType((InfinityType::Code)naxClip->postInfinityType);
+    clip.SetName(naxClip->name);
+
+    // add anim events
+    clip.BeginEvents(naxClip->numEvents);
+    IndexT eventIndex;
+    for (eventIndex = 0; eventIndex < naxClip->numEvents; eventIndex++)
     {
-        uchar* ptr = (uchar*) stream->Map();
+        const Nax3AnimEvent* naxEvent = (const Nax3AnimEvent*) ptr;
+        ptr += sizeof(Nax3AnimEvent);
+        AnimEvent animEvent(naxEvent->name, naxEvent->category, naxEvent->keyIndex * clip.GetKeyDuration());
+        clip.AddEvent(animEvent);
+    }
+    clip.EndEvents();
+    return ptr;
+}
 
-        // read header
-        Nax3Header* naxHeader = (Nax3Header*) ptr;
-        ptr += sizeof(Nax3Header);
+//------------------------------------------------------------------------------
+/**
+    NAX3 files contain float4 keys, key indices and key strides are
+    converted to byte offsets.
+*/
+void
+StreamAnimationLoader::SetupFromNax3(const uchar* ptr)
+{
+    const Ptr<AnimResource>& anim = this->resource.downcast<AnimResource>();
+
+    // read header
+    const Nax3Header* naxHeader = (const Nax3Header*) ptr;
+    ptr += sizeof(Nax3Header);
+    n_assert(0 != naxHeader->numClips)
+
+    // setup animation clips
+    anim->BeginSetupClips(naxHeader->numClips);
+    IndexT clipIndex;
+    SizeT numClips = (SizeT) naxHeader->numClips;
+    for (clipIndex = 0; clipIndex < numClips; clipIndex++)
+    {
+        const Nax3Clip* naxClip = (const Nax3Clip*) ptr;
+        AnimClip& clip = anim->Clip(clipIndex);
+        ptr = SetupClip(ptr, clip);
+        clip.SetKeyStride(naxClip->keyStride * sizeof(float4));
 
-        // check magic value
-        if (FourCC(naxHeader->magic) != NEBULA3_NAX3_MAGICNUMBER)
+        // setup anim curves
+        IndexT curveIndex;
+        for (curveIndex = 0; curveIndex < naxClip->numCurves; curveIndex++)
         {
-            n_error("StreamAnimationLoader::SetupFromNax3(): '%s' has invalid file format (magic number doesn't match)!", stream->GetURI().AsString().AsCharPtr());
-            return false;
+            const Nax3Curve* naxCurve = (const Nax3Curve*) ptr;
+            ptr += sizeof(Nax3Curve);
+            
+            AnimCurve& animCurve = clip.CurveByIndex(curveIndex);
+            animCurve.SetFirstKeyOffset(naxCurve->firstKeyIndex * sizeof(float4));
+            animCurve.SetActive(naxCurve->isActive != 0);
+            animCurve.SetStatic(naxCurve->isStatic != 0);
+            animCurve.SetCurveType((CurveType::Code)naxCurve->curveType);
+            animCurve.SetKeyFormat(KeyFormat::Float4);
+            animCurve.SetStaticKey(float4(naxCurve->staticKeyX, naxCurve->staticKeyY, naxCurve->staticKeyZ, naxCurve->staticKeyW));
         }
-        n_assert(0 != naxHeader->numClips)
+    }
+    anim->EndSetupClips();
+
+    // load keys
+    const Ptr<AnimKeyBuffer>& animKeyBuffer = anim->SetupKeyBuffer(naxHeader->numKeys * sizeof(float4));
+    void* keyPtr = animKeyBuffer->Map();
+    Memory::Copy(ptr, keyPtr, animKeyBuffer->GetByteSize());
+    animKeyBuffer->Unmap();
+}
+
+//------------------------------------------------------------------------------
+/**
+    NAX4 files contain per-curve key formats and quantization ranges,
+    key offsets and key strides are byte offsets.
+*/
+void
+StreamAnimationLoader::SetupFromNax4(const uchar* ptr)
+{
+    const Ptr<AnimResource>& anim = this->resource.downcast<AnimResource>();
+
+    // read header
+    const Nax4Header* naxHeader = (const Nax4Header*) ptr;
+    ptr += sizeof(Nax4Header);
+    n_assert(0 != naxHeader->numClips)
+
+    // setup animation clips
+    anim->BeginSetupClips(naxHeader->numClips);
+    IndexT clipIndex;
+    SizeT numClips = (SizeT) naxHeader->numClips;
+    for (clipIndex = 0; clipIndex < numClips; clipIndex++)
+    {
+        const Nax3Clip* naxClip = (const Nax3Clip*) ptr;
+        AnimClip& clip = anim->Clip(clipIndex);
+        ptr = SetupClip(ptr, clip);
+        clip.SetKeyStride(naxClip->keyStride);
 
-        // setup animation clips
-        anim->BeginSetupClips(naxHeader->numClips);
-        IndexT clipIndex;
-        SizeT numClips = (SizeT) naxHeader->numClips;
-        for (clipIndex = 0; clipIndex < numClips; clipIndex++)
+        // setup anim curves
+        IndexT curveIndex;
+        for (curveIndex = 0; curveIndex < naxClip->numCurves; curveIndex++)
         {
-            Nax3Clip* naxClip = (Nax3Clip*) ptr;
-            ptr += sizeof(Nax3Clip);
-
-            // setup anim clip object
-            AnimClip& clip = anim->Clip(clipIndex);
-            clip.SetNumCurves(naxClip->numCurves);
-            clip.SetStartKeyIndex(naxClip->startKeyIndex);
-            clip.SetNumKeys(naxClip->numKeys);
-            clip.SetKeyStride(naxClip->keyStride);
-            clip.SetKeyDuration(naxClip->keyDuration);
-            clip.SetPreInfinityType((InfinityType::Code)naxClip->preInfinityType);
-            clip.SetPostInfinityType((InfinityType::Code)naxClip->postInfinityType);
-            clip.SetName(naxClip->name);
-
-            // add anim events
-            clip.BeginEvents(naxClip->numEvents);
-            IndexT eventIndex;
-            for (eventIndex = 0; eventIndex < naxClip->numEvents; eventIndex++)
-            {
-                Nax3AnimEvent* naxEvent = (Nax3AnimEvent*) ptr;
-                ptr += sizeof(Nax3AnimEvent);
-                AnimEvent animEvent(naxEvent->name, naxEvent->category, naxEvent->keyIndex * clip.GetKeyDuration());
-                clip.AddEvent(animEvent);
-            }
-            clip.EndEvents();
-
-            // setup anim curves
-            IndexT curveIndex;
-            for (curveIndex = 0; curveIndex < naxClip->numCurves; curveIndex++)
-            {
-                Nax3Curve* naxCurve = (Nax3Curve*) ptr;
-                ptr += sizeof(Nax3Curve);
-                
-                AnimCurve& animCurve = clip.CurveByIndex(curveIndex);
-                animCurve.SetFirstKeyIndex(naxCurve->firstKeyIndex);
-                animCurve.SetActive(naxCurve->isActive != 0);
-                animCurve.SetStatic(naxCurve->isStatic != 0);
-                animCurve.SetCurveType((CurveType::Code)naxCurve->curveType);
-                animCurve.SetStaticKey(float4(naxCurve->staticKeyX, naxCurve->staticKeyY, naxCurve->staticKeyZ, naxCurve->staticKeyW));
-            }
+            const Nax4Curve* naxCurve = (const Nax4Curve*) ptr;
+            ptr += sizeof(Nax4Curve);
+            
+            AnimCurve& animCurve = clip.CurveByIndex(curveIndex);
+            animCurve.SetFirstKeyOffset(naxCurve->firstKeyOffset);
+            animCurve.SetActive(naxCurve->isActive != 0);
+            animCurve.SetStatic(naxCurve->isStatic != 0);
+            animCurve.SetCurveType((CurveType::Code)naxCurve->curveType);
+            animCurve.SetKeyFormat((KeyFormat::Code)naxCurve->keyFormat);
+            animCurve.SetStaticKey(float4(naxCurve->staticKeyX, naxCurve->staticKeyY, naxCurve->staticKeyZ, naxCurve->staticKeyW));
+            animCurve.SetKeyQuantization(float4(naxCurve->keyScaleX, naxCurve->keyScaleY, naxCurve->keyScaleZ, naxCurve->keyScaleW),
+                                         float4(naxCurve->keyBiasX, naxCurve->keyBiasY, naxCurve->keyBiasZ, naxCurve->keyBiasW));
         }
-        anim->EndSetupClips();
-
-        // load keys
-        const Ptr<AnimKeyBuffer>& animKeyBuffer = anim->SetupKeyBuffer(naxHeader->numKeys);
-        void* keyPtr = animKeyBuffer->Map();
-        Memory::Copy(ptr, keyPtr, animKeyBuffer->GetByteSize());
-        animKeyBuffer->Unmap();
-        
-        // shutdown stream
-        stream->Unmap();
-        stream->Close();
-        return true;
     }
-    return false;
+    anim->EndSetupClips();
+
+    // load keys
+    const Ptr<AnimKeyBuffer>& animKeyBuffer = anim->SetupKeyBuffer(naxHeader->keyBufferSize);
+    void* keyPtr = animKeyBuffer->Map();
+    Memory::Copy(ptr, keyPtr, animKeyBuffer->GetByteSize());
+    animKeyBuffer->Unmap();
 }
 
 } // namespace CoreAnimation
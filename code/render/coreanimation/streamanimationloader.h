@@ -4,10 +4,13 @@
     @class CoreAnimation::StreamAnimationLoader
     
     Initialize a CoreAnimation::AnimResource from the content of a stream.
+    The stream may contain a NAX3 file (float4 keys) or a NAX4 file
+    (quantized keys), the file format is detected by the magic number.
     
     (C) 2008 Radon Labs GmbH
 */
 #include "resources/streamresourceloader.h"
+#include "coreanimation/animclip.h"
 
 //------------------------------------------------------------------------------
 namespace CoreAnimation
@@ -19,8 +22,12 @@ protected:
     /// setup the AnimResource object from a stream
     virtual bool SetupResourceFromStream(const Ptr<IO::Stream>& stream);
 
-    /// setup the AnimResource from an NAX3 stream
-    bool SetupFromNax3(const Ptr<IO::Stream>& stream);
+    /// setup the AnimResource from the mapped content of a NAX3 stream
+    void SetupFromNax3(const uchar* ptr);
+    /// setup the AnimResource from the mapped content of a NAX4 stream
+    void SetupFromNax4(const uchar* ptr);
+    /// setup clip attributes and anim events, NAX3 and NAX4 share the clip layout
+    static const uchar* SetupClip(const uchar* ptr, AnimClip& clip);
 };
 
 } // namespace CoreAnimation
@@ -141,7 +141,7 @@ ShapeRendererBase::AddWireFrameBox(const Math::bbox& boundingBox, const Math::fl
         vector(-1,1,1),
         vector(-1,-1,1)};
 
-    Util::Array<point> lineList;
+    Util::Array<point, Util::ArrayFrameAllocator> lineList;
     IndexT i;
     for (i = 0; i < 24; ++i)
     {
@@ -33,6 +33,8 @@ D3D9StreamTextureLoader::SetupResourceFromStream(const Ptr<Stream>& stream)
     n_assert(!res->IsLoaded());
 
     stream->SetAccessMode(Stream::ReadAccess);
+    // the texture is created straight from the mapped pages
+    stream->SetAccessPattern(Stream::Sequential);
     if (stream->Open())
     {
         void* srcData = stream->Map();
@@ -69,6 +69,8 @@ D3D9StreamMeshLoader::SetupMeshFromNvx2(const Ptr<Stream>& stream)
     nvx2Reader->SetStream(stream);
     nvx2Reader->SetUsage(this->usage);
     nvx2Reader->SetAccess(this->access);
+    // the nvx2 reader parses the mesh front to back from the mapped pages
+    stream->SetAccessPattern(Stream::Sequential);
     if (nvx2Reader->Open())
     {
         const Ptr<Mesh>& res = this->resource.downcast<Mesh>();
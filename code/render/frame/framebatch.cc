@@ -18,6 +18,12 @@
 #include "lighting/lightserver.h"
 #include "rendermodules/rt/rtpluginregistry.h"
 #include "coregraphics/shadersemantics.h"
+#include "models/nodes/statenode.h"
+#include "models/nodes/shapenode.h"
+#include "models/nodes/shapenodeinstance.h"
+#include "coregraphics/transformdevice.h"
+#include "frame/frameserver.h"
+#include "jobs/job.h"
 
 namespace Frame
 {
@@ -29,6 +35,18 @@ using namespace Models;
 using namespace Util;
 using namespace Lighting;
 using namespace FrameSync;
+using namespace Jobs;
+using namespace Math;
+
+// job function declaration
+#if __PS3__
+extern "C" {
+    extern const char _binary_jqjob_render_framesortjob_ps3_bin_start[];
+    extern const char _binary_jqjob_render_framesortjob_ps3_bin_size[];
+}
+#else
+extern void FrameSortJobFunc(const JobFuncContext& ctx);
+#endif
 
 //------------------------------------------------------------------------------
 /**
@@ -38,7 +56,10 @@ FrameBatch::FrameBatch() :
     nodeFilter(ModelNodeType::InvalidModelNodeType),
     lightingMode(LightingMode::None),
     sortingMode(SortingMode::None),
-    shaderFeatures(0)
+    shaderFeatures(0),
+    numUnsortedStateChanges(0),
+    numStateChanges(0),
+    numInstancedNodeInstances(0)
 {
     // empty
 }
@@ -65,8 +86,27 @@ FrameBatch::Discard()
         this->shader = 0;
     }
     this->shaderVariables.Clear();
+    this->drawList.Clear();
+    this->sortEntries.Clear();
+    this->sortBuffer.Clear();
+    this->instances.Clear();
+    this->shaderIds.Clear();
+    this->meshIds.Clear();
+    if (this->sortJobPort.isvalid())
+    {
+        this->sortJobPort->WaitDone();
+        this->sortJobPort->Discard();
+        this->sortJobPort = 0;
+    }
 
     _discard_timer(this->debugTimer);
+#if NEBULA3_ENABLE_PROFILING
+    if (this->stateChangesCounter.isvalid())
+    {
+        _discard_counter(this->stateChangesCounter);
+        _discard_counter(this->stateChangesSavedCounter);
+    }
+#endif
 }
 
 //------------------------------------------------------------------------------
@@ -85,9 +125,24 @@ FrameBatch::Render()
     }
 
     // render the batch
+    this->numUnsortedStateChanges = 0;
+    this->numStateChanges = 0;
+    this->numInstancedNodeInstances = 0;
     renderDevice->BeginBatch(this->batchType, this->shader);
     this->RenderBatch();
     renderDevice->EndBatch();
+
+#if NEBULA3_ENABLE_PROFILING
+    if (this->stateChangesCounter.isvalid())
+    {
+        _begin_counter(this->stateChangesCounter);
+        _set_counter(this->stateChangesCounter, int(this->numStateChanges));
+        _end_counter(this->stateChangesCounter);
+        _begin_counter(this->stateChangesSavedCounter);
+        _set_counter(this->stateChangesSavedCounter, this->GetNumStateChangesSaved());
+        _end_counter(this->stateChangesSavedCounter);
+    }
+#endif
 }
 
 //------------------------------------------------------------------------------
@@ -101,11 +156,6 @@ FrameBatch::RenderBatch()
     RenderModules::RTPluginRegistry* rtPluginRegistry = RenderModules::RTPluginRegistry::Instance();
     rtPluginRegistry->OnRenderFrameBatch(batchPtr);
 
-    // now do usual render stuff
-    ShaderServer* shaderServer = ShaderServer::Instance();
-    VisResolver* visResolver = VisResolver::Instance();      
-    LightServer* lightServer = LightServer::Instance(); 
-
     _start_timer(this->debugTimer);
     // handle special cases
     if (BatchType::UI == this->batchType)
@@ -155,91 +205,412 @@ FrameBatch::RenderBatch()
         IndexT frameIndex = FrameSyncTimer::Instance()->GetFrameCount();
 
         // default case: render models...
-        const Array<Ptr<Model> >& models = visResolver->GetVisibleModels(this->nodeFilter);
-        IndexT modelIndex;
-        for (modelIndex = 0; modelIndex < models.Size(); modelIndex++)
+        this->BuildDrawList();
+        this->SortDrawList();
+        this->SubmitDrawList(frameIndex);
+    }
+    _stop_timer(this->debugTimer);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Collects the visible node instances of the batch into the draw list
+    and computes a sort key for each draw. From the most to the least
+    significant bits, the key contains:
+
+    - the number of local lights of the model entity (SinglePass lighting
+      only), which selects the light count shader variation
+    - the shader of the model node
+    - the mesh of the model node (nodes of a model usually share a mesh
+      and only differ in the primitive group)
+    - the material, a unique id for each model node (each node owns its
+      shader instance and textures)
+    - the view depth of the model entity (FrontToBack only)
+
+    For BackToFront sorting, the inverted depth is placed right below the
+    light count, so that the depth order takes precedence over the
+    render states. The ids are only unique within a batch, and clamped
+    to their bit range, which only makes the sorting less effective,
+    since SubmitDrawList() compares the actual render states.
+
+    Also counts the state changes the batch would cause when rendering
+    in visibility order (the old nested model/node/instance loops), and
+    flags the draws which may be rendered instanced: plain ShapeNode 
+    instances without per-instance shader variables in batches without
+    lighting (lights are applied per model entity).
+*/
+void
+FrameBatch::BuildDrawList()
+{
+    VisResolver* visResolver = VisResolver::Instance();
+    LightServer* lightServer = LightServer::Instance();
+
+    this->drawList.Reset();
+    this->sortEntries.Reset();
+    this->shaderIds.Clear();
+    this->meshIds.Clear();
+
+    // bit positions of the key fields
+    const unsigned int lightShift = 64 - NumLightBits;
+    unsigned int depthShift, shaderShift, meshShift, materialShift;
+    if (SortingMode::BackToFront == this->sortingMode)
+    {
+        materialShift = 0;
+        meshShift = materialShift + NumMaterialBits;
+        shaderShift = meshShift + NumMeshBits;
+        depthShift = shaderShift + NumShaderBits;
+    }
+    else
+    {
+        depthShift = 0;
+        materialShift = depthShift + NumDepthBits;
+        meshShift = materialShift + NumMaterialBits;
+        shaderShift = meshShift + NumMeshBits;
+    }
+    const IndexT maxLightId = (1 << NumLightBits) - 1;
+    const IndexT maxShaderId = (1 << NumShaderBits) - 1;
+    const IndexT maxMeshId = (1 << NumMeshBits) - 1;
+    const IndexT maxMaterialId = (1 << NumMaterialBits) - 1;
+    const uint maxDepth = (1 << NumDepthBits) - 1;
+
+    // the camera looks along its negative z axis
+    const matrix44& camTransform = visResolver->GetCameraTransform();
+    float4 camPos = camTransform.getrow3();
+    float4 camDir = -camTransform.getrow2();
+
+    IndexT materialId = 0;
+    const Array<Ptr<Model> >& models = visResolver->GetVisibleModels(this->nodeFilter);
+    IndexT modelIndex;
+    for (modelIndex = 0; modelIndex < models.Size(); modelIndex++)
+    {
+        const Array<Ptr<ModelNode> >& modelNodes = visResolver->GetVisibleModelNodes(this->nodeFilter, models[modelIndex]);
+        IndexT modelNodeIndex;  
+        for (modelNodeIndex = 0; modelNodeIndex < modelNodes.Size(); modelNodeIndex++)
         {
-            FRAME_LOG("      FrameBatch::RenderBatch() model: %s", models[modelIndex]->GetResourceId().Value());
+            const Ptr<ModelNode>& modelNode = modelNodes[modelNodeIndex];
 
-            // for each visible model node of the model...
-            const Array<Ptr<ModelNode> >& modelNodes = visResolver->GetVisibleModelNodes(this->nodeFilter, models[modelIndex]);
-            IndexT modelNodeIndex;  
-            for (modelNodeIndex = 0; modelNodeIndex < modelNodes.Size(); modelNodeIndex++)
+            // get dense shader and mesh ids of the node
+            IndexT shaderId = 0;
+            if (modelNode->IsA(StateNode::RTTI))
             {
-                // apply render state which is shared by all instances
-                shaderServer->ResetFeatureBits();
-                shaderServer->SetFeatureBits(this->shaderFeatures);
-                const Ptr<ModelNode>& modelNode = modelNodes[modelNodeIndex];            
-                modelNode->ApplySharedState(frameIndex);
+                const Ptr<ShaderInstance>& shdInst = modelNode.downcast<StateNode>()->GetShaderInstance();
+                if (shdInst.isvalid())
+                {
+                    Shader* shd = shdInst->GetOriginalShader().get();
+                    IndexT shdIndex = this->shaderIds.FindIndex(shd);
+                    if (InvalidIndex == shdIndex)
+                    {
+                        shaderId = this->shaderIds.Size();
+                        this->shaderIds.Add(shd, shaderId);
+                    }
+                    else
+                    {
+                        shaderId = this->shaderIds.ValueAtIndex(shdIndex);
+                    }
+                }
+            }
+            IndexT meshId = 0;
+            if (modelNode->IsA(ShapeNode::RTTI))
+            {
+                Mesh* mesh = modelNode.downcast<ShapeNode>()->GetManagedMesh()->GetMesh().get();
+                IndexT meshIndex = this->meshIds.FindIndex(mesh);
+                if (InvalidIndex == meshIndex)
+                {
+                    meshId = this->meshIds.Size();
+                    this->meshIds.Add(mesh, meshId);
+                }
+                else
+                {
+                    meshId = this->meshIds.ValueAtIndex(meshIndex);
+                }
+            }
+            unsigned long long nodeKey = ((unsigned long long) n_min(shaderId, maxShaderId) << shaderShift) |
+                                         ((unsigned long long) n_min(meshId, maxMeshId) << meshShift) |
+                                         ((unsigned long long) n_min(materialId, maxMaterialId) << materialShift);
+            materialId++;
 
-                FRAME_LOG("        FrameBatch::RenderBatch() node: %s", modelNode->GetName().Value());
+            // unsorted rendering applies the shared state once per node, and
+            // selects the shader variation once per node without lighting
+            this->numUnsortedStateChanges += (LightingMode::None == this->lightingMode) ? 2 : 1;
 
-                // if lighting mode is Off, we can render all node instances with the same shader
-                const Ptr<ShaderInstance>& shaderInst = shaderServer->GetActiveShaderInstance();
-                if (LightingMode::None == this->lightingMode)
+            const Array<Ptr<ModelNodeInstance> >& nodeInstances = visResolver->GetVisibleModelNodeInstances(this->nodeFilter, modelNode);
+            IndexT nodeInstIndex;
+            for (nodeInstIndex = 0; nodeInstIndex < nodeInstances.Size(); nodeInstIndex++)
+            {
+                const Ptr<ModelNodeInstance>& nodeInstance = nodeInstances[nodeInstIndex];
+                const Ptr<InternalModelEntity>& modelEntity = nodeInstance->GetModelInstance()->GetModelEntity();
+                unsigned long long key = nodeKey;
+
+                if (LightingMode::SinglePass == this->lightingMode)
                 {
-                    shaderInst->SelectActiveVariation(shaderServer->GetFeatureBits());
-                    SizeT numPasses = shaderInst->Begin();
-                    n_assert(1 == numPasses);
-                    shaderInst->BeginPass(0);
+                    // unsorted rendering applies the lights and selects the 
+                    // shader variation for every node instance
+                    this->numUnsortedStateChanges += 2;
+                    SizeT numLights = lightServer->CountModelEntityLights(modelEntity);
+                    key |= (unsigned long long) n_min(numLights, maxLightId) << lightShift;
                 }
 
-                // render instances
-                const Array<Ptr<ModelNodeInstance> >& nodeInstances = visResolver->GetVisibleModelNodeInstances(this->nodeFilter, modelNode);
-                IndexT nodeInstIndex;
-                for (nodeInstIndex = 0; nodeInstIndex < nodeInstances.Size(); nodeInstIndex++)
+                if (SortingMode::None != this->sortingMode)
                 {
-                    const Ptr<ModelNodeInstance>& nodeInstance = nodeInstances[nodeInstIndex];
-
-                    // if single-pass lighting is enabled, we need to setup the lighting 
-                    // shader states
-                    // FIXME: This may set a new shader variation for every node instance
-                    // which is expensive! Would be better to sort node instances by number
-                    // of active lights!!!
-                    if (LightingMode::SinglePass == this->lightingMode)
+                    // non-negative floats keep their order when compared as integers
+                    uint depthKey = 0;
+                    float depth = float4::dot3(modelEntity->GetTransform().getrow3() - camPos, camDir);
+                    if (depth > 0.0f)
                     {
-                        // setup lighting render states
-                        // NOTE: this may change the shader feature bit mask which may select
-                        // a different shader variation per entity
-                        const Ptr<InternalGraphics::InternalModelEntity>& modelEntity = nodeInstance->GetModelInstance()->GetModelEntity();
-                        lightServer->ApplyModelEntityLights(modelEntity);
-                        shaderInst->SelectActiveVariation(shaderServer->GetFeatureBits());
-                        SizeT numPasses = shaderInst->Begin();
-                        n_assert(1 == numPasses);
-                        shaderInst->BeginPass(0);
+                        union { float f; uint u; } depthBits;
+                        depthBits.f = depth;
+                        depthKey = depthBits.u >> (32 - NumDepthBits);
                     }
-
-                    // render the node instance
-                    nodeInstance->ApplyState();
-                    // get object id and apply object id 
-                #if !__WII__
-                    shaderServer->ApplyObjectId(nodeInstance->GetModelNodeInstanceIndex());
-                #endif
-                    shaderInst->Commit();
-
-                #if NEBULA3_ENABLE_PROFILING
-                    nodeInstance->StartDebugTimer();
-                #endif  
-                    nodeInstance->Render();
-                #if NEBULA3_ENABLE_PROFILING
-                    nodeInstance->StopDebugTimer();
-                #endif  
-                    if (LightingMode::SinglePass == this->lightingMode)
+                    if (SortingMode::BackToFront == this->sortingMode)
                     {
-                        shaderInst->EndPass();
-                        shaderInst->End();
+                        depthKey = maxDepth - depthKey;
                     }
+                    key |= (unsigned long long) depthKey << depthShift;
                 }
 
-                if (LightingMode::None == this->lightingMode)
+                FrameSortEntry entry;
+                entry.key = key;
+                entry.index = this->drawList.Size();
+                this->sortEntries.Append(entry);
+
+                Draw draw;
+                draw.modelNode = modelNode.get();
+                draw.nodeInstance = nodeInstance.get();
+                draw.modelEntity = modelEntity.get();
+                #if NEBULA3_ENABLE_AUTO_INSTANCING
+                draw.instanceable = (LightingMode::None == this->lightingMode) && 
+                                    nodeInstance->IsInstanceOf(ShapeNodeInstance::RTTI) &&
+                                    (0 == nodeInstance.downcast<ShapeNodeInstance>()->GetNumShaderVariableInstances());
+                #else
+                draw.instanceable = false;
+                #endif
+                this->drawList.Append(draw);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Sorts the draw list by sort key into the first half of the sort buffer.
+    Medium sized draw lists are sorted in a job, small draw lists are not
+    worth the job overhead, and big ones would not fit into a single
+    job data slice.
+*/
+void
+FrameBatch::SortDrawList()
+{
+    SizeT num = this->sortEntries.Size();
+    this->sortBuffer.Reset();
+    this->sortBuffer.AppendArray(this->sortEntries);
+    this->sortBuffer.AppendArray(this->sortEntries);
+    if ((num < MinJobSortEntries) || (num > MaxJobSortEntries))
+    {
+        FrameSortJobUtilRadixSort(this->sortEntries.Begin(), this->sortBuffer.Begin(), this->sortBuffer.Begin() + num, num);
+    }
+    else
+    {
+        if (!this->sortJobPort.isvalid())
+        {
+            this->sortJobPort = JobPort::Create();
+            this->sortJobPort->Setup();
+        }
+
+        #if __PS3__
+        JobFuncDesc jobFunc(_binary_jqjob_render_framesortjob_ps3_bin_start, _binary_jqjob_render_framesortjob_ps3_bin_size);
+        #else
+        JobFuncDesc jobFunc(FrameSortJobFunc);
+        #endif
+
+        // the output buffer holds the sorted entries and the scratch buffer
+        SizeT bufSize = num * sizeof(FrameSortEntry);
+        JobUniformDesc uniform;
+        JobDataDesc input(this->sortEntries.Begin(), bufSize, bufSize);
+        JobDataDesc output(this->sortBuffer.Begin(), 2 * bufSize, 2 * bufSize);
+        Ptr<Job> job = Job::Create();
+        job->Setup(uniform, input, output, jobFunc);
+        this->sortJobPort->PushJob(job);
+        this->sortJobPort->WaitDone();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Renders the sorted draw list. Only applies the shared node state when
+    the model node changes, the lights when the model entity changes, and
+    only selects a new shader variation when the shader instance or the 
+    feature bits have changed.
+
+    Runs of at least MinNumInstances instanceable draws of the same node
+    are rendered with a single instanced draw, if the shader instance
+    has a variation with the instanced feature bits.
+*/
+void
+FrameBatch::SubmitDrawList(IndexT frameIndex)
+{
+    ShaderServer* shaderServer = ShaderServer::Instance();
+    LightServer* lightServer = LightServer::Instance(); 
+    #if NEBULA3_ENABLE_AUTO_INSTANCING
+    RenderDevice* renderDevice = RenderDevice::Instance();
+    ShaderFeature::Mask instancedFeatureBits = FrameServer::Instance()->GetInstanceStream()->GetFeatureBits();
+    #endif
+
+    ModelNode* curModelNode = 0;
+    InternalModelEntity* curModelEntity = 0;
+    ShaderInstance* curShaderInst = 0;
+    ShaderFeature::Mask curFeatureBits = 0;
+    SizeT num = this->sortEntries.Size();
+    IndexT i;
+    for (i = 0; i < num; i++)
+    {
+        const Draw& draw = this->drawList[this->sortBuffer[i].index];
+
+        // apply render state which is shared by all instances
+        if (draw.modelNode != curModelNode)
+        {
+            shaderServer->ResetFeatureBits();
+            shaderServer->SetFeatureBits(this->shaderFeatures);
+            draw.modelNode->ApplySharedState(frameIndex);
+            curModelNode = draw.modelNode;
+            this->numStateChanges++;
+
+            // resetting the feature bits has cleared the lighting feature bits
+            curModelEntity = 0;
+
+            FRAME_LOG("        FrameBatch::SubmitDrawList() node: %s", draw.modelNode->GetName().Value());
+        }
+
+        // if single-pass lighting is enabled, we need to setup the lighting 
+        // shader states
+        // NOTE: this may change the shader feature bit mask which may select
+        // a different shader variation per entity
+        if ((LightingMode::SinglePass == this->lightingMode) && (draw.modelEntity != curModelEntity))
+        {
+            lightServer->ApplyModelEntityLights(draw.modelEntity);
+            curModelEntity = draw.modelEntity;
+            this->numStateChanges++;
+        }
+
+        ShaderInstance* shaderInst = shaderServer->GetActiveShaderInstance().get();
+        ShaderFeature::Mask featureBits = shaderServer->GetFeatureBits();
+
+        // find the run of instanceable draws of the same node
+        SizeT numInstances = 1;
+        #if NEBULA3_ENABLE_AUTO_INSTANCING
+        if (draw.instanceable)
+        {
+            while (((i + numInstances) < num) && (numInstances < FrameInstanceStream::MaxNumInstances))
+            {
+                const Draw& nextDraw = this->drawList[this->sortBuffer[i + numInstances].index];
+                if ((nextDraw.modelNode != draw.modelNode) || !nextDraw.instanceable)
                 {
-                    shaderInst->EndPass();
-                    shaderInst->End();
-                }                
+                    break;
+                }
+                numInstances++;
+            }
+            if ((numInstances >= MinNumInstances) &&
+                (renderDevice->GetPrimitiveGroup().GetNumIndices() > 0) &&
+                shaderInst->HasVariation(featureBits | instancedFeatureBits))
+            {
+                featureBits |= instancedFeatureBits;
+            }
+            else
+            {
+                numInstances = 1;
             }
         }
+        #endif
+
+        // select a new shader variation if the shader or the features have changed
+        if ((shaderInst != curShaderInst) || (featureBits != curFeatureBits))
+        {
+            if (0 != curShaderInst)
+            {
+                curShaderInst->EndPass();
+                curShaderInst->End();
+            }
+            shaderInst->SelectActiveVariation(featureBits);
+            SizeT numPasses = shaderInst->Begin();
+            n_assert(1 == numPasses);
+            shaderInst->BeginPass(0);
+            curShaderInst = shaderInst;
+            curFeatureBits = featureBits;
+            this->numStateChanges++;
+        }
+
+        if (numInstances > 1)
+        {
+            this->SubmitInstancedDraws(i, numInstances, shaderInst);
+            i += numInstances - 1;
+            continue;
+        }
+
+        // render the node instance
+        ModelNodeInstance* nodeInstance = draw.nodeInstance;
+        nodeInstance->ApplyState();
+        // get object id and apply object id 
+    #if !__WII__
+        shaderServer->ApplyObjectId(nodeInstance->GetModelNodeInstanceIndex());
+    #endif
+        shaderInst->Commit();
+
+    #if NEBULA3_ENABLE_PROFILING
+        nodeInstance->StartDebugTimer();
+    #endif  
+        nodeInstance->Render();
+    #if NEBULA3_ENABLE_PROFILING
+        nodeInstance->StopDebugTimer();
+    #endif  
+    }
+
+    if (0 != curShaderInst)
+    {
+        curShaderInst->EndPass();
+        curShaderInst->End();
     }
-    _stop_timer(this->debugTimer);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Gathers the model transforms and object ids of a run of sorted draws
+    into the instance stream, and renders them with a single instanced
+    draw. The shared node state and the instanced shader variation must
+    have been applied. The per-instance state of the node instances is
+    not applied, the model transforms are set to identity instead.
+*/
+void
+FrameBatch::SubmitInstancedDraws(IndexT firstSortIndex, SizeT num, const Ptr<ShaderInstance>& shaderInst)
+{
+    RenderDevice* renderDevice = RenderDevice::Instance();
+    TransformDevice* transformDevice = TransformDevice::Instance();
+    const Ptr<FrameInstanceStream>& instanceStream = FrameServer::Instance()->GetInstanceStream();
+
+    // gather instance data
+    this->instances.Reset();
+    IndexT i;
+    for (i = 0; i < num; i++)
+    {
+        const Draw& draw = this->drawList[this->sortBuffer[firstSortIndex + i].index];
+        TransformNodeInstance* nodeInstance = static_cast<TransformNodeInstance*>(draw.nodeInstance);
+        FrameInstanceStream::Instance inst;
+        inst.transform = nodeInstance->GetModelTransform();
+        inst.data.set(float(nodeInstance->GetModelNodeInstanceIndex()) / 255.0f, 0.0f, 0.0f, 0.0f);
+        this->instances.Append(inst);
+    }
+    IndexT firstInstance = instanceStream->Write(this->instances.Begin(), num);
+
+    // the instanced shader variation applies the instance transforms
+    transformDevice->SetModelTransform(matrix44::identity());
+    transformDevice->ApplyModelTransforms(shaderInst);
+
+    // render all instances, and restore the vertex layout of the mesh for following draws
+    Ptr<VertexLayout> meshLayout = renderDevice->GetVertexLayout();
+    instanceStream->ApplyInstances(firstInstance);
+    shaderInst->Commit();
+    renderDevice->DrawIndexedInstanced(num);
+    renderDevice->SetVertexLayout(meshLayout);
+
+    this->numInstancedNodeInstances += num;
 }
 
 #if NEBULA3_ENABLE_PROFILING
@@ -251,6 +622,14 @@ FrameBatch::SetBatchDebugTimer(const Util::String& name)
 {
     this->debugTimer = Debug::DebugTimer::Create();
     this->debugTimer->Setup(name);
+
+    Util::String counterName = name;
+    counterName.Append("_StateChanges");
+    this->stateChangesCounter = Debug::DebugCounter::Create();
+    this->stateChangesCounter->Setup(counterName);
+    counterName.Append("Saved");
+    this->stateChangesSavedCounter = Debug::DebugCounter::Create();
+    this->stateChangesSavedCounter->Setup(counterName);
 }
 #endif
 } // namespace Frame
@@ -4,6 +4,16 @@
     @class Frame::FrameBatch
     
     A frame batch encapsulates the rendering of a batch of ModelNodeInstances.
+
+    The visible node instances of the batch are collected into a flat
+    draw list with a 64 bit sort key per draw (light count, shader, mesh,
+    material and depth), the keys are radix-sorted in a job, and the
+    sorted draws are submitted with redundant state changes filtered out.
+    Runs of draws of the same ShapeNode are rendered with a single
+    instanced draw call if the node's shader has an "Instanced"
+    variation (see FrameInstanceStream).
+    GetNumStateChanges() and GetNumStateChangesSaved() report the state
+    changes of the last Render() call.
     
     (C) 2007 Radon Labs GmbH
 */
@@ -12,10 +22,17 @@
 #include "coregraphics/shadervariableinstance.h"
 #include "coregraphics/batchtype.h"
 #include "coregraphics/shaderfeature.h"
+#include "coregraphics/shader.h"
+#include "coregraphics/mesh.h"
+#include "util/dictionary.h"
 #include "models/modelnodetype.h"
 #include "frame/lightingmode.h"
 #include "frame/sortingmode.h"
 #include "debug/debugtimer.h"
+#include "debug/debugcounter.h"
+#include "jobs/jobport.h"
+#include "frame/jobs/framesortjobutil.h"
+#include "frame/frameinstancestream.h"
 
 #define NEBULA3_FRAME_LOG_ENABLED   (0)
 #if NEBULA3_FRAME_LOG_ENABLED
@@ -25,6 +42,16 @@
 #endif
 
 //------------------------------------------------------------------------------
+namespace Models
+{
+class ModelNode;
+class ModelNodeInstance;
+}
+namespace InternalGraphics
+{
+class InternalModelEntity;
+}
+
 namespace Frame
 {
 class FrameBatch : public Core::RefCounted
@@ -72,6 +99,13 @@ public:
     /// get shader variable by index
     const Ptr<CoreGraphics::ShaderVariableInstance>& GetVariableByIndex(IndexT i) const;
 
+    /// get number of state changes (shared node state, lights, shader variations) of the last Render()
+    SizeT GetNumStateChanges() const;
+    /// get number of state changes saved by sorting in the last Render(), compared to unsorted rendering
+    int GetNumStateChangesSaved() const;
+    /// get number of node instances rendered with instanced draws in the last Render()
+    SizeT GetNumInstancedNodeInstances() const;
+
 #if NEBULA3_ENABLE_PROFILING
     /// add batch profiler
     void SetBatchDebugTimer(const Util::String& name);
@@ -80,6 +114,36 @@ public:
 private:
     /// actual rendering method
     void RenderBatch();
+    /// collect the visible node instances into the draw list, and compute their sort keys
+    void BuildDrawList();
+    /// sort the draw list by sort key
+    void SortDrawList();
+    /// render the sorted draw list
+    void SubmitDrawList(IndexT frameIndex);
+    /// render a run of sorted draws of the same node with a single instanced draw
+    void SubmitInstancedDraws(IndexT firstSortIndex, SizeT num, const Ptr<CoreGraphics::ShaderInstance>& shaderInst);
+
+    /// a draw in the draw list (pointers are kept alive by the VisResolver during rendering)
+    struct Draw
+    {
+        Models::ModelNode* modelNode;
+        Models::ModelNodeInstance* nodeInstance;
+        InternalGraphics::InternalModelEntity* modelEntity;
+        bool instanceable;
+    };
+
+    /// sort key layout: 4 bits light count, 10 bits shader, 12 bits mesh, 14 bits material, 24 bits depth
+    static const unsigned int NumLightBits = 4;
+    static const unsigned int NumShaderBits = 10;
+    static const unsigned int NumMeshBits = 12;
+    static const unsigned int NumMaterialBits = 14;
+    static const unsigned int NumDepthBits = 24;
+    /// draw lists with less entries are sorted directly instead of in a job
+    static const SizeT MinJobSortEntries = 256;
+    /// draw lists with more entries are sorted directly (job data must fit into a single slice)
+    static const SizeT MaxJobSortEntries = 4096;
+    /// shorter runs of draws of the same node are not rendered instanced
+    static const SizeT MinNumInstances = 4;
 
     Ptr<CoreGraphics::ShaderInstance> shader;
     CoreGraphics::BatchType::Code batchType;
@@ -89,7 +153,20 @@ private:
     CoreGraphics::ShaderFeature::Mask shaderFeatures;
     Util::Array<Ptr<CoreGraphics::ShaderVariableInstance> > shaderVariables;
 
+    Util::Array<Draw> drawList;
+    Util::Array<FrameSortEntry> sortEntries;
+    Util::Array<FrameSortEntry> sortBuffer;     // sorted entries, followed by the sort scratch buffer
+    Util::Dictionary<CoreGraphics::Shader*, IndexT> shaderIds;
+    Util::Dictionary<CoreGraphics::Mesh*, IndexT> meshIds;
+    Ptr<Jobs::JobPort> sortJobPort;
+    Util::Array<FrameInstanceStream::Instance> instances;
+    SizeT numUnsortedStateChanges;
+    SizeT numStateChanges;
+    SizeT numInstancedNodeInstances;
+
     _declare_timer(debugTimer);
+    _declare_counter(stateChangesCounter);
+    _declare_counter(stateChangesSavedCounter);
 };
 
 //------------------------------------------------------------------------------
@@ -209,6 +286,37 @@ FrameBatch::GetVariableByIndex(IndexT i) const
     return this->shaderVariables[i];
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+FrameBatch::GetNumStateChanges() const
+{
+    return this->numStateChanges;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Compares the state changes of the last Render() with the state changes
+    the batch would have caused when rendering models, nodes and node
+    instances in visibility order. May be negative for BackToFront
+    batches, where the depth order takes precedence over state changes.
+*/
+inline int
+FrameBatch::GetNumStateChangesSaved() const
+{
+    return int(this->numUnsortedStateChanges) - int(this->numStateChanges);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+FrameBatch::GetNumInstancedNodeInstances() const
+{
+    return this->numInstancedNodeInstances;
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -0,0 +1,155 @@
+//------------------------------------------------------------------------------
+//  frameinstancestream.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "frame/frameinstancestream.h"
+#include "coregraphics/memoryvertexbufferloader.h"
+#include "coregraphics/vertexlayoutserver.h"
+#include "coregraphics/renderdevice.h"
+#include "coregraphics/shaderserver.h"
+
+namespace Frame
+{
+__ImplementClass(Frame::FrameInstanceStream, 'FINS', Core::RefCounted);
+
+using namespace Util;
+using namespace CoreGraphics;
+using namespace Resources;
+using namespace Math;
+
+//------------------------------------------------------------------------------
+/**
+*/
+FrameInstanceStream::FrameInstanceStream() :
+    featureBits(0),
+    curInstanceIndex(0)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+FrameInstanceStream::~FrameInstanceStream()
+{
+    if (this->IsValid())
+    {
+        this->Discard();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+FrameInstanceStream::Setup()
+{
+    n_assert(!this->IsValid());
+
+    this->featureBits = ShaderServer::Instance()->FeatureStringToMask("Instanced");
+    this->curInstanceIndex = 0;
+
+    // setup the dynamic instance vertex buffer (one vertex per instance)
+    this->instanceComponents.Clear();
+    this->instanceComponents.Append(VertexComponent(VertexComponent::TexCoord, 4, VertexComponent::Float4, 1));  // transform row 0
+    this->instanceComponents.Append(VertexComponent(VertexComponent::TexCoord, 5, VertexComponent::Float4, 1));  // transform row 1
+    this->instanceComponents.Append(VertexComponent(VertexComponent::TexCoord, 6, VertexComponent::Float4, 1));  // transform row 2
+    this->instanceComponents.Append(VertexComponent(VertexComponent::TexCoord, 7, VertexComponent::Float4, 1));  // transform row 3
+    this->instanceComponents.Append(VertexComponent(VertexComponent::TexCoord, 8, VertexComponent::Float4, 1));  // x: object id
+
+    Ptr<MemoryVertexBufferLoader> vbLoader = MemoryVertexBufferLoader::Create();
+    vbLoader->Setup(this->instanceComponents, MaxNumInstances, NULL, 0, VertexBuffer::UsageDynamic, VertexBuffer::AccessWrite);
+
+    this->vertexBuffer = VertexBuffer::Create();
+    this->vertexBuffer->SetLoader(vbLoader.upcast<ResourceLoader>());
+    this->vertexBuffer->SetAsyncEnabled(false);
+    this->vertexBuffer->Load();
+    if (!this->vertexBuffer->IsLoaded())
+    {
+        n_error("FrameInstanceStream: Failed to setup instance vertex buffer!");
+    }
+    this->vertexBuffer->SetLoader(0);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+FrameInstanceStream::Discard()
+{
+    n_assert(this->IsValid());
+    this->vertexBuffer->Unload();
+    this->vertexBuffer = 0;
+    this->instanceComponents.Clear();
+    this->instancedLayouts.Clear();
+}
+
+//------------------------------------------------------------------------------
+/**
+    Appends the instances to the vertex buffer. Only discards the buffer
+    when the instances don't fit behind the instances of previous draws.
+*/
+IndexT
+FrameInstanceStream::Write(const Instance* instances, SizeT num)
+{
+    n_assert(this->IsValid());
+    n_assert((num > 0) && (num <= MaxNumInstances));
+
+    VertexBuffer::MapType mapType = VertexBuffer::MapWriteNoOverwrite;
+    if ((this->curInstanceIndex + num) > MaxNumInstances)
+    {
+        mapType = VertexBuffer::MapWriteDiscard;
+        this->curInstanceIndex = 0;
+    }
+    IndexT firstInstance = this->curInstanceIndex;
+    float* ptr = (float*) this->vertexBuffer->Map(mapType);
+    n_assert(0 != ptr);
+    ptr += firstInstance * (sizeof(Instance) / sizeof(float));
+
+    // NOTE: it's important to write in order here, since the writes
+    // go to write-combined memory!
+    IndexT i;
+    for (i = 0; i < num; i++)
+    {
+        const Instance& inst = instances[i];
+        inst.transform.getrow0().stream(ptr); ptr += 4;
+        inst.transform.getrow1().stream(ptr); ptr += 4;
+        inst.transform.getrow2().stream(ptr); ptr += 4;
+        inst.transform.getrow3().stream(ptr); ptr += 4;
+        inst.data.stream(ptr); ptr += 4;
+    }
+    this->vertexBuffer->Unmap();
+    this->curInstanceIndex += num;
+    return firstInstance;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Binds the instances as vertex stream 1, and replaces the vertex layout
+    of the mesh with a layout which contains the mesh vertex components
+    and the instance components. The combined layouts are cached per
+    mesh vertex layout.
+*/
+void
+FrameInstanceStream::ApplyInstances(IndexT firstInstance)
+{
+    n_assert(this->IsValid());
+    RenderDevice* renderDevice = RenderDevice::Instance();
+    const Ptr<VertexLayout>& meshLayout = renderDevice->GetVertexLayout();
+    n_assert(meshLayout.isvalid());
+
+    IndexT layoutIndex = this->instancedLayouts.FindIndex(meshLayout);
+    if (InvalidIndex == layoutIndex)
+    {
+        Array<VertexComponent> components = meshLayout->GetVertexComponents();
+        components.AppendArray(this->instanceComponents);
+        Ptr<VertexLayout> instancedLayout = VertexLayoutServer::Instance()->CreateSharedVertexLayout(components);
+        this->instancedLayouts.Add(meshLayout, instancedLayout);
+        layoutIndex = this->instancedLayouts.FindIndex(meshLayout);
+    }
+    renderDevice->SetStreamSource(1, this->vertexBuffer, firstInstance);
+    renderDevice->SetVertexLayout(this->instancedLayouts.ValueAtIndex(layoutIndex));
+}
+
+} // namespace Frame
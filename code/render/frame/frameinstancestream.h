@@ -0,0 +1,93 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Frame::FrameInstanceStream
+
+    Dynamic vertex stream with per-instance data for the automatic
+    hardware instancing of FrameBatch. Each instance vertex holds the
+    model transform of a node instance (TexCoord4..7) and additional
+    instance data (TexCoord8, x: object id), the stream is bound as
+    vertex stream 1 next to the mesh vertices in stream 0.
+
+    Shaders opt in by providing variations with the "Instanced" shader
+    feature. An instanced variation must multiply the vertex position
+    (and normals) with the instance transform before applying the usual
+    model transforms, which are set to identity for instanced draws.
+
+    The vertex buffer is used as a ring buffer, instances are appended
+    without overwriting data of pending draws until the buffer is full,
+    then the buffer is discarded and filled from the start again.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/refcounted.h"
+#include "coregraphics/vertexbuffer.h"
+#include "coregraphics/vertexlayout.h"
+#include "coregraphics/vertexcomponent.h"
+#include "coregraphics/shaderfeature.h"
+#include "math/matrix44.h"
+#include "util/dictionary.h"
+
+//------------------------------------------------------------------------------
+namespace Frame
+{
+class FrameInstanceStream : public Core::RefCounted
+{
+    __DeclareClass(FrameInstanceStream);
+public:
+    /// an instance vertex
+    struct Instance
+    {
+        Math::matrix44 transform;
+        Math::float4 data;          // x: object id
+    };
+    /// max number of instances in the vertex buffer
+    static const SizeT MaxNumInstances = 4096;
+
+    /// constructor
+    FrameInstanceStream();
+    /// destructor
+    virtual ~FrameInstanceStream();
+
+    /// setup the instance stream
+    void Setup();
+    /// discard the instance stream
+    void Discard();
+    /// return true if the instance stream has been setup
+    bool IsValid() const;
+
+    /// get the shader feature bits which select instanced shader variations
+    CoreGraphics::ShaderFeature::Mask GetFeatureBits() const;
+    /// write instances into the vertex buffer, returns the index of the first instance
+    IndexT Write(const Instance* instances, SizeT num);
+    /// set instance stream and combined vertex layout on the render device (mesh primitives must be applied)
+    void ApplyInstances(IndexT firstInstance);
+
+private:
+    Ptr<CoreGraphics::VertexBuffer> vertexBuffer;
+    Util::Array<CoreGraphics::VertexComponent> instanceComponents;
+    Util::Dictionary<Ptr<CoreGraphics::VertexLayout>, Ptr<CoreGraphics::VertexLayout> > instancedLayouts;
+    CoreGraphics::ShaderFeature::Mask featureBits;
+    IndexT curInstanceIndex;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+FrameInstanceStream::IsValid() const
+{
+    return this->vertexBuffer.isvalid();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline CoreGraphics::ShaderFeature::Mask
+FrameInstanceStream::GetFeatureBits() const
+{
+    return this->featureBits;
+}
+
+} // namespace Frame
+//------------------------------------------------------------------------------
@@ -64,6 +64,13 @@ FrameServer::Close()
         this->frameShaders.ValueAtIndex(i)->Discard();
     }
     this->frameShaders.Clear();
+
+    // discard the instance stream
+    if (this->instanceStream.isvalid())
+    {
+        this->instanceStream->Discard();
+        this->instanceStream = 0;
+    }
     this->isOpen = false;
 }
 
@@ -95,4 +102,19 @@ FrameServer::LookupFrameShader(const ResourceId& resId)
     return this->frameShaders[resId];
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+const Ptr<FrameInstanceStream>&
+FrameServer::GetInstanceStream()
+{
+    n_assert(this->IsOpen());
+    if (!this->instanceStream.isvalid())
+    {
+        this->instanceStream = FrameInstanceStream::Create();
+        this->instanceStream->Setup();
+    }
+    return this->instanceStream;
+}
+
 } // namespace Frame
@@ -11,6 +11,7 @@
 #include "core/singleton.h"
 #include "resources/resourceid.h"
 #include "frame/frameshader.h"
+#include "frame/frameinstancestream.h"
 
 //------------------------------------------------------------------------------
 namespace Frame
@@ -32,12 +33,15 @@ public:
     bool IsOpen() const;
     /// gain access to a frame shader by name, shader will be loaded if not happened yet
     Ptr<FrameShader> LookupFrameShader(const Resources::ResourceId& name);
+    /// get the instance stream shared by all frame batches, stream will be setup if not happened yet
+    const Ptr<FrameInstanceStream>& GetInstanceStream();
     
 private:
     /// load a frame shader
     void LoadFrameShader(const Resources::ResourceId& name);
 
     Util::Dictionary<Resources::ResourceId, Ptr<FrameShader> > frameShaders;
+    Ptr<FrameInstanceStream> instanceStream;
     bool isOpen;
 };
 
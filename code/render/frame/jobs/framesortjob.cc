@@ -0,0 +1,30 @@
+//------------------------------------------------------------------------------
+//  framesortjob.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "jobs/stdjob.h"
+#include "frame/jobs/framesortjobutil.h"
+
+namespace Frame
+{
+
+//------------------------------------------------------------------------------
+/**
+    Sort the draw list of a frame batch by sort key. The input are the
+    unsorted FrameSortEntry's, the output buffer must be twice the size
+    of the input, the sorted entries are written to its first half, the
+    second half is used as scratch buffer. Only works with a single slice.
+*/
+void
+FrameSortJobFunc(const JobFuncContext& ctx)
+{
+    n_assert(ctx.outputSizes[0] == (2 * ctx.inputSizes[0]));
+    const FrameSortEntry* entries = (const FrameSortEntry*) ctx.inputs[0];
+    FrameSortEntry* sorted = (FrameSortEntry*) ctx.outputs[0];
+    SizeT num = ctx.inputSizes[0] / sizeof(FrameSortEntry);
+    FrameSortJobUtilRadixSort(entries, sorted, sorted + num, num);
+}
+
+} // namespace Frame
+__ImplementSpursJob(Frame::FrameSortJobFunc);
@@ -0,0 +1,98 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @file framesortjobutil.h
+
+    Sort entries and the radix sort used by the frame batch sort job.
+    FrameBatch also calls the sort directly for draw lists which are
+    too small (or too big) to be worth a job.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+
+namespace Frame
+{
+
+//------------------------------------------------------------------------------
+/**
+    A 64 bit draw sort key and the index of the draw in the frame batch's
+    draw list. Sorted in ascending key order.
+*/
+struct FrameSortEntry
+{
+    unsigned long long key;
+    IndexT index;
+};
+
+//------------------------------------------------------------------------------
+/**
+    Stable LSD radix sort of the sort entries, 8 bits per pass. The
+    histograms of all key bytes are built in a single pass over the keys,
+    passes over bytes which are identical in all keys are skipped (which
+    is the case for most of the high bytes in a typical frame). The
+    result is written to sorted, scratch must have room for num entries
+    as well, and entries may not overlap sorted or scratch.
+*/
+inline void
+FrameSortJobUtilRadixSort(const FrameSortEntry* entries, FrameSortEntry* sorted, FrameSortEntry* scratch, SizeT num)
+{
+    if (0 == num)
+    {
+        return;
+    }
+
+    // count the values of all key bytes
+    unsigned int histograms[8][256];
+    Memory::Clear(histograms, sizeof(histograms));
+    IndexT i;
+    for (i = 0; i < num; i++)
+    {
+        unsigned long long key = entries[i].key;
+        IndexT byteIndex;
+        for (byteIndex = 0; byteIndex < 8; byteIndex++)
+        {
+            histograms[byteIndex][(unsigned int)(key >> (byteIndex * 8)) & 0xff]++;
+        }
+    }
+
+    // one counting sort pass per key byte, ping-pong between sorted and scratch
+    const FrameSortEntry* src = entries;
+    FrameSortEntry* dst = sorted;
+    IndexT byteIndex;
+    for (byteIndex = 0; byteIndex < 8; byteIndex++)
+    {
+        unsigned int shift = byteIndex * 8;
+        unsigned int* histogram = histograms[byteIndex];
+        if (histogram[(unsigned int)(src[0].key >> shift) & 0xff] == (unsigned int) num)
+        {
+            // all keys have the same value in this byte
+            continue;
+        }
+
+        // convert counts into output offsets
+        unsigned int offset = 0;
+        IndexT bucket;
+        for (bucket = 0; bucket < 256; bucket++)
+        {
+            unsigned int count = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += count;
+        }
+        for (i = 0; i < num; i++)
+        {
+            dst[histogram[(unsigned int)(src[i].key >> shift) & 0xff]++] = src[i];
+        }
+        src = dst;
+        dst = (dst == sorted) ? scratch : sorted;
+    }
+
+    // the last pass may have ended up in the scratch buffer (or no pass was needed at all)
+    if (src != sorted)
+    {
+        Memory::Copy(src, sorted, num * sizeof(FrameSortEntry));
+    }
+}
+
+} // namespace Frame
+//------------------------------------------------------------------------------
@@ -7,6 +7,8 @@
 #include "internalgraphics/internalstage.h"
 #include "internalgraphics/internalgraphicsserver.h"
 #include "shared/graphics/graphicsentityshared.h"
+#include "visibility/visibilitycontext.h"
+#include "util/slotmap.h"
 
 namespace InternalGraphics
 {
@@ -36,7 +38,8 @@ InternalGraphicsEntity::InternalGraphicsEntity() :
     notifyCullingVisibleFrameIndex(InvalidIndex),
     entityTime(0.0),
     timeFactor(1.0),
-    clipStatus(ClipStatus::Invalid)
+    clipStatus(ClipStatus::Invalid),
+    visibilityHandle(Util::SlotMap<Ptr<Visibility::VisibilityContext> >::InvalidHandle)
 {
     this->id = ++UniqueIdCounter;
 }
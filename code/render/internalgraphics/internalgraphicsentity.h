@@ -193,6 +193,7 @@ protected:
     Timing::Time entityTime;
     float timeFactor;
     Math::ClipStatus::Type clipStatus;
+    uint visibilityHandle;                  // handle into the VisibilityChecker of the stage
     Util::Array<Ptr<Messaging::Message> > deferredMessages;
     Ptr<FrameSync::FrameSyncSharedData> sharedData;
 };
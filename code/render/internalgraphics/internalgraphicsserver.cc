@@ -77,6 +77,11 @@ InternalGraphicsServer::Open()
     this->rtPluginRegistry = RenderModules::RTPluginRegistry::Create();
     this->rtPluginRegistry->Setup();
 
+    // setup the frame arena of the render thread, visibility results
+    // live for 2 frames, so use 3 buffers
+    this->frameArena.Setup(Memory::ScratchHeap, FrameArenaBufferSize, 3);
+    Memory::FrameArena::SetThreadArena(&this->frameArena);
+
     // setup profiling timers
     _setup_timer(InternalGfxServerEndFrameTimer);
     _setup_timer(InternalGfxServerRenderView);
@@ -97,6 +102,7 @@ InternalGraphicsServer::Close()
     this->DiscardAllStages();
     this->rtPluginRegistry->Discard();
     this->rtPluginRegistry = 0;
+    this->frameArena.Discard();
     this->isOpen = false;
 
     _discard_timer(InternalGfxServerEndFrameTimer);
@@ -413,6 +419,9 @@ InternalGraphicsServer::OnFrame(Timing::Time curTime, Timing::Time globalTimeFac
     DisplayDevice* displayDevice = DisplayDevice::Instance();
     IndexT frameIndex = FrameSyncTimer::Instance()->GetFrameCount();
 
+    // release the per-frame data of 3 frames ago
+    this->frameArena.BeginFrame(frameIndex);
+
     // call pre-render update on resource manager
     ResourceManager::Instance()->Prepare(false);
 
@@ -6,6 +6,10 @@
     The graphics server maintains a the "graphics world" consisting of 
     one or more "stages" and one or more "views" which are attached to
     the stages.
+
+    The graphics server also owns the frame arena of the render thread,
+    which is used by arrays with the Util::ArrayFrameAllocator for
+    temporary per-frame data.
     
     (C) 2007 Radon Labs GmbH
 */
@@ -20,6 +24,7 @@
 #include "internalgraphics/internalgraphicsentity.h"
 #include "rendermodules/rt/rtpluginregistry.h"
 #include "debug/debugtimer.h"
+#include "memory/framearena.h"
 #include "visibility/visibilitysystems/visibilitysystembase.h"
 
 // forward declarations
@@ -107,6 +112,8 @@ private:
     /// unregister a graphics entity
     void UnregisterEntity(const Ptr<InternalGraphicsEntity>& entity);
 
+    static const SizeT FrameArenaBufferSize = 256 * 1024;
+
     Ptr<RenderModules::RTPluginRegistry> rtPluginRegistry;
     Util::Array<Ptr<InternalGraphicsEntity> > entities;
     Util::Dictionary<InternalGraphicsEntity::Id, IndexT> entityIndexMap;
@@ -116,6 +123,7 @@ private:
     Util::Dictionary<Util::StringAtom, IndexT> viewIndexMap;
     Ptr<InternalView> defaultView;
     Ptr<CoreGraphics::ShaderVariable> timeShaderVar;
+    Memory::FrameArena frameArena;
     bool isOpen;
     bool renderDebug;
     _declare_timer(InternalGfxServerEndFrameTimer);
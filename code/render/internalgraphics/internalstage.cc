@@ -232,18 +232,23 @@ InternalStage::UpdateLightLinks()
 {
     // clear old links
     visibilityChecker.ClearVisibilityLinks(InternalGraphicsEntity::LightLink);
-    // for each visible light...
+    // collect visible lights
     const Array<Ptr<InternalGraphicsEntity> >& lightEntities = this->entitiesByType[InternalGraphicsEntityType::Light];
+    Array<Ptr<InternalGraphicsEntity> > visibleLights;
+    Array<uint> entityMasks;
     IndexT lightIndex;
     for (lightIndex = 0; lightIndex < lightEntities.Size(); lightIndex++)
     {
         const Ptr<InternalGraphicsEntity>& lightEntity = lightEntities[lightIndex];
         if (lightEntity->GetLinks(InternalGraphicsEntity::CameraLink).Size() > 0)
         {
-            // find model entities influenced by this light
-            this->visibilityChecker.PerformVisibilityQuery(this->curFrameIndex, lightEntity, (1<<InternalGraphicsEntityType::Model));            
+            visibleLights.Append(lightEntity);
+            entityMasks.Append(1 << InternalGraphicsEntityType::Model);
         }
     }
+
+    // find model entities influenced by the lights, with one visibility pass for all lights
+    this->visibilityChecker.PerformBatchVisibilityQuery(this->curFrameIndex, visibleLights, entityMasks);
 }
 
 //------------------------------------------------------------------------------
@@ -287,7 +292,7 @@ InternalStage::OnRenderDebug()
         if (linkedEntities.Size() > 0)
         {   
             const Math::point& lightPos = lightEntities[lightIndex]->GetTransform().get_position();
-            Util::Array<Math::point> lines;        
+            Util::Array<Math::point, Util::ArrayFrameAllocator> lines;
             IndexT i;
             for (i = 0; i < linkedEntities.Size(); ++i)
             {
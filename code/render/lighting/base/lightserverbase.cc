@@ -146,6 +146,19 @@ LightServerBase::EndAttachVisibleLights()
     // @todo: sort light source by importance
 }
 
+//------------------------------------------------------------------------------
+/**
+    Returns the number of local lights which ApplyModelEntityLights() would
+    apply for the provided ModelEntity. Used by frame batches to sort
+    model entities by the light count dependent shader variation.
+*/
+SizeT
+LightServerBase::CountModelEntityLights(const Ptr<InternalModelEntity>& modelEntity) const
+{
+    // no local lights, override in subclass
+    return 0;
+}
+
 //------------------------------------------------------------------------------
 /**
     This method is called during rendering to apply lighting parameters 
@@ -45,6 +45,8 @@ public:
     void AttachVisibleLight(const Ptr<InternalAbstractLightEntity>& lightEntity);
     /// end attaching visible light sources
     void EndAttachVisibleLights();
+    /// get the number of local lights ApplyModelEntityLights() would apply for a model entity
+    SizeT CountModelEntityLights(const Ptr<InternalGraphics::InternalModelEntity>& modelEntity) const;
     /// apply lighting parameters for a visible model entity 
     void ApplyModelEntityLights(const Ptr<InternalGraphics::InternalModelEntity>& modelEntity);
     /// render light pass
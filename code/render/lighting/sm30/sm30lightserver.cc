@@ -129,6 +129,23 @@ SM30LightServer::Close()
     LightServerBase::Close();
 }
 
+//------------------------------------------------------------------------------
+/**
+    Must count the same lights as ApplyModelEntityLights(): the linked
+    lights without the global light, clamped to MaxLocalLights.
+*/
+SizeT
+SM30LightServer::CountModelEntityLights(const Ptr<InternalModelEntity>& modelEntity) const
+{
+    const Array<Ptr<InternalGraphicsEntity> >& localLights = modelEntity->GetLinks(InternalGraphicsEntity::LightLink);
+    SizeT numLocalLights = localLights.Size();
+    if ((numLocalLights > 0) && localLights[0]->IsA(InternalGlobalLightEntity::RTTI))
+    {
+        numLocalLights--;
+    }
+    return n_min(numLocalLights, MaxLocalLights);
+}
+
 //------------------------------------------------------------------------------
 /**
     @todo: set light properties only once per-frame and only set a
@@ -31,6 +31,8 @@ public:
     void Open();
     /// close the light server
     void Close();
+    /// get the number of local lights ApplyModelEntityLights() would apply for a model entity
+    SizeT CountModelEntityLights(const Ptr<InternalGraphics::InternalModelEntity>& modelEntity) const;
     /// apply lighting parameters for a visible model entity 
     void ApplyModelEntityLights(const Ptr<InternalGraphics::InternalModelEntity>& modelEntity);
 
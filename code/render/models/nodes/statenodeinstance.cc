@@ -103,4 +103,13 @@ StateNodeInstance::GetShaderVariableInstance(const ShaderVariable::Semantic& sem
     return this->shaderVariableInstances[sem];
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+SizeT
+StateNodeInstance::GetNumShaderVariableInstances() const
+{
+    return this->shaderVariableInstances.Size();
+}
+
 } // namespace Models
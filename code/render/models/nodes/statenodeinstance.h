@@ -32,6 +32,8 @@ public:
     bool HasShaderVariableInstance(const CoreGraphics::ShaderVariable::Semantic& semantic) const;
     /// get a shader variable instance
     const Ptr<CoreGraphics::ShaderVariableInstance>& GetShaderVariableInstance(const CoreGraphics::ShaderVariable::Semantic& semantic) const;
+    /// get number of instantiated shader variables
+    SizeT GetNumShaderVariableInstances() const;
 
 protected:
     /// called when removed from ModelInstance
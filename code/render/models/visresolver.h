@@ -47,6 +47,8 @@ public:
     void AttachVisibleModelInstancePlayerCamera(const Ptr<ModelInstance>& inst);
     /// end resolve
     void EndResolve();
+    /// get the camera transform of the current resolve
+    const Math::matrix44& GetCameraTransform() const;
 
     /// post-resolve: get Models with visible ModelNodeInstances by node type
     const Util::Array<Ptr<Model> >& GetVisibleModels(ModelNodeType::Code nodeType) const;
@@ -77,6 +79,15 @@ VisResolver::IsOpen() const
     return this->isOpen;
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+inline const Math::matrix44&
+VisResolver::GetCameraTransform() const
+{
+    return this->cameraTransform;
+}
+
 //------------------------------------------------------------------------------
 /**
 */
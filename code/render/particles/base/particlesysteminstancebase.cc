@@ -60,6 +60,7 @@ ParticleSystemInstanceBase::ParticleSystemInstanceBase() :
 #endif    
     this->jobData.running = false;
     this->jobData.sliceCount = 0;
+    this->jobData.particlesPerSlice = 0;
     this->jobData.sliceOutputCapacity = 0;
     this->jobData.sliceOutput = NULL;
 }
@@ -173,6 +174,10 @@ ParticleSystemInstanceBase::Update(Timing::Time time)
 {
     n_assert(this->IsValid());
 
+    // the particle job of the last update must be finished before new 
+    // particles are emitted into the particle buffer
+    this->FinalizeJobs();
+
     // update the state of the particle system (started, stopped, etc...)
     this->UpdateState((float)time);
 
@@ -461,7 +466,7 @@ ParticleSystemInstanceBase::EmitParticle(IndexT emissionSampleIndex, float initi
     //particle.particleId = (float)this->particleId;    
     //if (++this->particleId > 3) this->particleId = 0;         
 
-    // add the new particle to the particle ring buffer
+    // add the new particle to the particle buffer
     this->particles.Add(particle);
 }
 
@@ -479,18 +484,21 @@ ParticleSystemInstanceBase::FinalizeJobs()
     }
 
     // collect slice-specific output data
-    this->numLivingParticles = 0;
     this->boundingBox.begin_extend();
     for(int i = 0; i < this->jobData.sliceCount; ++i)
     {
         if(this->jobData.sliceOutput[i].numLivingParticles)
         {
-            this->numLivingParticles += this->jobData.sliceOutput[i].numLivingParticles;
             this->boundingBox.extend(this->jobData.sliceOutput[i].bboxMin);
             this->boundingBox.extend(this->jobData.sliceOutput[i].bboxMax);
         }
     }
     this->boundingBox.end_extend();
+
+    // the job moved the living particles to the front of each slice, 
+    // now move them to the front of the particle buffer
+    this->particles.Compact(this->jobData.sliceOutput, this->jobData.sliceCount, this->jobData.particlesPerSlice);
+    this->numLivingParticles = this->particles.Size();
     if(!this->numLivingParticles)
     {
         this->boundingBox.pmin = this->GetTransform().get_position();
@@ -562,7 +570,7 @@ ParticleSystemInstanceBase::StartJobStepParticles(float stepTime, bool generateV
 #if !__WII__ && !NEBULA3_EDITOR    
     n_assert(!((int)this->particles.GetBuffer() & 0xF));
 #endif    
-    const int inputBufferSize = this->particles.Size() * PARTICLE_JOB_INPUT_ELEMENT_SIZE;
+    const int inputBufferSize = this->particles.GetNumBlocks() * PARTICLE_JOB_INPUT_ELEMENT_SIZE;
 
 
 #if __PS3__
@@ -581,6 +589,7 @@ ParticleSystemInstanceBase::StartJobStepParticles(float stepTime, bool generateV
     // calculate number of slices
     this->jobData.sliceCount = (inputBufferSize +(intputSliceSize-1)) / intputSliceSize;
     n_assert(this->jobData.sliceCount > 0);
+    this->jobData.particlesPerSlice = (intputSliceSize / PARTICLE_JOB_INPUT_ELEMENT_SIZE) * ParticleBlockSize;
     // and resize the slice-outputbuffer if necessary
     if(this->jobData.sliceCount > this->jobData.sliceOutputCapacity)
     {
@@ -618,6 +627,7 @@ ParticleSystemInstanceBase::StartJobStepParticles(float stepTime, bool generateV
 void
 ParticleSystemInstanceBase::RenderDebug()
 {
+    this->FinalizeJobs();
     if (this->numLivingParticles > 0)
     {
         Array<float4> lineList;
@@ -627,24 +637,23 @@ ParticleSystemInstanceBase::RenderDebug()
         vector zAxis(0.0f, 0.0f, 1.0f);
 
         // render each living particle as a x/y/z cross
+        Particle particle;
         IndexT i;
         for (i = 0; i < this->particles.Size(); i++)
         {
-            const Particle& particle = this->particles[i];
-            if (particle.relAge < 1.0f)
-            {
-                // cross 1
-                lineList.Append(particle.position - xAxis * particle.size);
-                lineList.Append(particle.position + xAxis * particle.size);
-                lineList.Append(particle.position - yAxis * particle.size);
-                lineList.Append(particle.position + yAxis * particle.size);
-                lineList.Append(particle.position - zAxis * particle.size);
-                lineList.Append(particle.position + zAxis * particle.size);
-
-                // connection
-                lineList.Append(particle.position);
-                lineList.Append(particle.stretchPosition);
-            }
+            this->particles.GetParticle(i, particle);
+
+            // cross 1
+            lineList.Append(particle.position - xAxis * particle.size);
+            lineList.Append(particle.position + xAxis * particle.size);
+            lineList.Append(particle.position - yAxis * particle.size);
+            lineList.Append(particle.position + yAxis * particle.size);
+            lineList.Append(particle.position - zAxis * particle.size);
+            lineList.Append(particle.position + zAxis * particle.size);
+
+            // connection
+            lineList.Append(particle.position);
+            lineList.Append(particle.stretchPosition);
         }
         if (!lineList.IsEmpty())
         {
@@ -679,11 +688,14 @@ ParticleSystemInstanceBase::RenderDebug()
 
 //------------------------------------------------------------------------------
 /**
+    Subclasses must call this before reading the particle buffer, since 
+    the particle job may still be running.
 */
 void ParticleSystemInstanceBase::UpdateVertexStreams()
 {
     n_assert(ParticleRenderer::Instance()->IsInAttach());
     n_assert(this->renderInfo.IsEmpty());
+    this->FinalizeJobs();
 }
 
 } // namespace Particles
\ No newline at end of file
@@ -12,8 +12,8 @@
 #include "particles/particlesystem.h"
 #include "particles/particlesystemstate.h"
 #include "particles/particle.h"
+#include "particles/particlebuffer.h"
 #include "math/matrix44.h"
-#include "util/ringbuffer.h"
 #include "timing/time.h"
 #include "jobs/job.h"
 #include "particles/particlerenderinfo.h"
@@ -24,8 +24,6 @@ namespace Jobs { class JobPort; }
 namespace Particles
 {
 
-typedef Util::RingBuffer<Particles::Particle> ParticleBuffer;
-
 class ParticleSystemInstanceBase : public Core::RefCounted
 {
     __DeclareAbstractClass(ParticleSystemInstanceBase);
@@ -133,6 +131,8 @@ protected:
         Ptr<Jobs::Job> job;               
         // slices for current job
         int sliceCount;        
+        // number of particles per slice of the current job
+        int particlesPerSlice;
         // number of JobSliceOutputData's which can be stored 
         // in sliceOutput
         int sliceOutputCapacity;
@@ -29,6 +29,20 @@ D3D9ParticleSystemInstance::~D3D9ParticleSystemInstance()
     n_assert(!this->IsValid());
 }
 
+//------------------------------------------------------------------------------
+/**
+    Transposes 4 SoA particle streams into 4 per-particle vectors.
+*/
+static inline void
+TransposeParticleStreams(const Math::float4& v0, const Math::float4& v1, const Math::float4& v2, const Math::float4& v3, Math::float4 outVecs[4])
+{
+    Math::matrix44 m = Math::matrix44::transpose(Math::matrix44(v0, v1, v2, v3));
+    outVecs[0] = m.getrow0();
+    outVecs[1] = m.getrow1();
+    outVecs[2] = m.getrow2();
+    outVecs[3] = m.getrow3();
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -42,24 +56,36 @@ void D3D9ParticleSystemInstance::UpdateVertexStreams()
     IndexT baseVertexIndex = particleRenderer->GetCurParticleVertexIndex();
 
     float* ptr = (float*)particleRenderer->GetCurVertexPtr();
-    Math::float4 tmp;
-    IndexT i;
+    const Math::float4 zero(0.0f, 0.0f, 0.0f, 0.0f);
+    const Math::float4 one(1.0f, 1.0f, 1.0f, 1.0f);
+    Math::float4 position[4], stretchPosition[4], color[4], uvMinMax[4], misc[4];
+
+    // all particles in the buffer are alive, convert them block-wise
+    // from the SoA layout of the particle blocks to vertices
+    const ParticleBlock* blocks = this->particles.GetBuffer();
     SizeT num = this->particles.Size();
+    IndexT i;
     for (i = 0; (i < num) && (particleRenderer->GetCurParticleVertexIndex() < MaxNumRenderedParticles); i++)
     {
-        const Particle& particle = this->particles[i];
-        if (particle.relAge < 1.0f)
+        IndexT lane = i % ParticleBlockSize;
+        if (0 == lane)
         {
-            // NOTE: it's important to write in order here, since the writes
-            // go to write-combined memory!
-            particle.position.stream(ptr); ptr += 4;
-            particle.stretchPosition.stream(ptr); ptr += 4;
-            particle.color.stream(ptr); ptr += 4;
-            particle.uvMinMax.stream(ptr); ptr += 4;
-            tmp.set(particle.rotation, particle.size, particle.particleId, 0.0f);
-            tmp.stream(ptr); ptr += 4;
-            particleRenderer->AddCurParticleVertexIndex(1);
+            const Math::float4* s = blocks[i / ParticleBlockSize].streams;
+            TransposeParticleStreams(s[ParticleBlock::PositionX], s[ParticleBlock::PositionY], s[ParticleBlock::PositionZ], one, position);
+            TransposeParticleStreams(s[ParticleBlock::StretchPositionX], s[ParticleBlock::StretchPositionY], s[ParticleBlock::StretchPositionZ], one, stretchPosition);
+            TransposeParticleStreams(s[ParticleBlock::ColorR], s[ParticleBlock::ColorG], s[ParticleBlock::ColorB], s[ParticleBlock::ColorA], color);
+            TransposeParticleStreams(s[ParticleBlock::UvMinX], s[ParticleBlock::UvMinY], s[ParticleBlock::UvMaxX], s[ParticleBlock::UvMaxY], uvMinMax);
+            TransposeParticleStreams(s[ParticleBlock::Rotation], s[ParticleBlock::Size], s[ParticleBlock::ParticleId], zero, misc);
         }
+
+        // NOTE: it's important to write in order here, since the writes
+        // go to write-combined memory!
+        position[lane].stream(ptr); ptr += 4;
+        stretchPosition[lane].stream(ptr); ptr += 4;
+        color[lane].stream(ptr); ptr += 4;
+        uvMinMax[lane].stream(ptr); ptr += 4;
+        misc[lane].stream(ptr); ptr += 4;
+        particleRenderer->AddCurParticleVertexIndex(1);
     }
     particleRenderer->SetCurVertexPtr(ptr);
     SizeT numVertices = particleRenderer->GetCurParticleVertexIndex() - baseVertexIndex;
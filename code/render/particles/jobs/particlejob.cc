@@ -10,14 +10,6 @@
 #include "math/matrix44.h"
 #include "particles/particle.h"
 
-#if __NEBULA_NO_ASSERT__
-#define ASSERT_POINT(p)
-#define ASSERT_VECTOR(v)
-#else
-#define ASSERT_POINT(p)     n_assert((p).w() > 0.995f);  n_assert((p).w() < 1.005f)
-#define ASSERT_VECTOR(v)    n_assert((v).w() > -0.005f); n_assert((v).w() < 0.005f)
-#endif
-
 namespace Particles
 {
 
@@ -25,6 +17,12 @@ using namespace Math;
 
 //------------------------------------------------------------------------------
 /**
+    The particle job updates ParticleBlocks, 4 particles in SoA layout,
+    so that all particle attributes of 4 particles are updated with one
+    SIMD operation. Dead particles are removed by moving the living
+    particles of the slice to its front, the number of living particles
+    of the slice is written to the slice output. Unused and dead particles
+    at the end of the slice have a relAge >= 1.
 
     NOTE: JobStepAndVlist does the same as JobStep, but it also generates the vertex 
           list. It could be in one function, but then we would always have to check a 
@@ -38,17 +36,19 @@ using namespace Math;
 void ParticleJobFunc(const JobFuncContext& ctx);
 /// lookup samples at index "sampleIndex" in samplte-table
 const float* LookupEnvelopeSamples(const float sampleBuffer[ParticleSystemNumEnvelopeSamples*EmitterAttrs::NumEnvelopeAttrs], IndexT sampleIndex);
-/// update bounding box (min, max) with vector v
-void UpdateBbox(__Float4Arg v, float4 &min, float4 &max);
-/// update the age of one particle
-void ParticleUpdateAge(const JobUniformData *uniform, const Particle &in, Particle &out);
-/// integrate the particle state with a given time-step
-void ParticleStep(const JobUniformData *uniform, const Particle &in, Particle &out, JobSliceOutputData *sliceOutput);
+/// lookup the envelope samples of the 4 particles of a block in SoA layout
+void LookupEnvelopeSamplesSoa(const float sampleBuffer[ParticleSystemNumEnvelopeSamples*EmitterAttrs::NumEnvelopeAttrs], const ParticleBlock& block, float4 outSamples[EmitterAttrs::NumEnvelopeAttrs]);
+/// return 1.0 for each component where v0 is less than v1, otherwise 0.0
+float4 LessMask(const float4& v0, const float4& v1);
+/// integrate the state of the 4 particles of a block with a given time-step, returns number of living particles
+SizeT ParticleBlockStep(const JobUniformData *uniform, ParticleBlock& block, unsigned char* alive, float4 bboxMinMax[6]);
+/// move the living particles of a slice to the front of the slice, returns number of living particles
+SizeT CompactParticles(ParticleBlock* blocks, SizeT numParticles, SizeT numLivingParticles, const unsigned char* alive);
 /// update particle system step
-void JobStep(const JobUniformData *uniform, unsigned int numParticles, const Particle *particles_input, Particle *particles_output, JobSliceOutputData *sliceOutput);
+void JobStep(const JobUniformData *uniform, unsigned int numBlocks, const ParticleBlock *blocks_input, ParticleBlock *blocks_output, JobSliceOutputData *sliceOutput);
 #if __PS3__
 /// update particle system step and generate vertex list
-void JobStepAndVlist(const JobUniformData *uniform, unsigned int numParticles, const Particle *particles_input, Particle *particles_output, JobSliceOutputData *sliceOutput, ParticleQuadRenderVertex *vertexStream);
+void JobStepAndVlist(const JobUniformData *uniform, unsigned int numBlocks, const ParticleBlock *blocks_input, ParticleBlock *blocks_output, JobSliceOutputData *sliceOutput, ParticleQuadRenderVertex *vertexStream);
 /// generate vertex list
 void ParticleGenerateVertexList(const JobUniformData *uniform, Particle &out, ParticleQuadRenderVertex *&currentVertex);
 /// just a helper for readability
@@ -69,90 +69,183 @@ LookupEnvelopeSamples(const float sampleBuffer[ParticleSystemNumEnvelopeSamples*
 
 //------------------------------------------------------------------------------
 /**
+    Looks up the envelope samples of the 4 particles and transposes them,
+    so that outSamples[attr] contains the sample of attr for all 4 particles.
+    The sample index of dead particles is clamped, their samples are not used.
 */
-__forceinline 
+__forceinline
 void
-UpdateBbox(__Float4Arg v, float4 &min, float4 &max)
+LookupEnvelopeSamplesSoa(const float sampleBuffer[ParticleSystemNumEnvelopeSamples*EmitterAttrs::NumEnvelopeAttrs], const ParticleBlock& block, float4 outSamples[EmitterAttrs::NumEnvelopeAttrs])
 {
-    min = float4::minimize(min, v);
-    max = float4::maximize(max, v);
+    const float* samples[ParticleBlockSize];
+    IndexT lane;
+    for (lane = 0; lane < ParticleBlockSize; lane++)
+    {
+        IndexT sampleIndex = IndexT(ParticleBlockValue(block, ParticleBlock::RelAge, lane) * (float)(ParticleSystemNumEnvelopeSamples-1));
+        sampleIndex = n_iclamp(sampleIndex, 0, ParticleSystemNumEnvelopeSamples - 1);
+        samples[lane] = LookupEnvelopeSamples(sampleBuffer, sampleIndex);
+    }
+
+    // the sample rows are not 16 byte aligned in the uniform data
+    float4 v0, v1, v2, v3;
+    IndexT attr;
+    for (attr = 0; attr < EmitterAttrs::NumEnvelopeAttrs; attr += 4)
+    {
+        v0.loadu(samples[0] + attr);
+        v1.loadu(samples[1] + attr);
+        v2.loadu(samples[2] + attr);
+        v3.loadu(samples[3] + attr);
+        matrix44 m = matrix44::transpose(matrix44(v0, v1, v2, v3));
+        outSamples[attr + 0] = m.getrow0();
+        outSamples[attr + 1] = m.getrow1();
+        outSamples[attr + 2] = m.getrow2();
+        outSamples[attr + 3] = m.getrow3();
+    }
 }
 
 //------------------------------------------------------------------------------
 /**
 */
 __forceinline
-void ParticleUpdateAge(const JobUniformData *uniform, const Particle &in, Particle &out)
+float4
+LessMask(const float4& v0, const float4& v1)
 {
-    // update particle's age
-    out.oneDivLifeTime = in.oneDivLifeTime;
-    out.age = in.age + uniform->stepTime;
-    out.relAge = in.relAge + uniform->stepTime * in.oneDivLifeTime;
+    return float4((v0.x() < v1.x()) ? 1.0f : 0.0f,
+                  (v0.y() < v1.y()) ? 1.0f : 0.0f,
+                  (v0.z() < v1.z()) ? 1.0f : 0.0f,
+                  (v0.w() < v1.w()) ? 1.0f : 0.0f);
 }
 
 //------------------------------------------------------------------------------
 /**
+    Updates the 4 particles of a block in place. Writes the living state
+    of each particle to alive and updates the bounding box of the living
+    particles, which is kept in SoA layout (minX, minY, minZ, maxX, maxY, maxZ).
+    Dead particles only get their age updated.
 */
 __forceinline
-void ParticleStep(const JobUniformData *uniform, const Particle &in, Particle &out, JobSliceOutputData *sliceOutput)
+SizeT
+ParticleBlockStep(const JobUniformData *uniform, ParticleBlock& block, unsigned char* alive, float4 bboxMinMax[6])
 {
-    ++sliceOutput->numLivingParticles;
-
-    // copy the *const* members
-    out.startPosition = in.startPosition;
-    out.uvMinMax = in.uvMinMax;
-    out.rotationVariation = in.rotationVariation;
-    out.sizeVariation = in.sizeVariation;
-
-    const IndexT sampleIndex = IndexT(out.relAge * (float)(ParticleSystemNumEnvelopeSamples-1));
-    n_assert(sampleIndex >= 0);            
-    n_assert(sampleIndex < ParticleSystemNumEnvelopeSamples);
-
-    const float* samples = LookupEnvelopeSamples(uniform->sampleBuffer, sampleIndex);
-    
-    // compute current particle acceleration
-    Math::float4 acceleration = uniform->windVector * samples[EmitterAttrs::AirResistance];
-    acceleration += uniform->gravity;
-    acceleration *= samples[EmitterAttrs::Mass];
-
-    float curStretchTime = 0.0f;
-
-    // fix stretch time (if particle stretch is enabled
-    if (uniform->stretchTime > 0.0f)
+    float4* s = block.streams;
+    const float stepTime = uniform->stepTime;
+    const float4 one(1.0f, 1.0f, 1.0f, 1.0f);
+
+    // update the particles' age
+    s[ParticleBlock::Age] += float4::splat(stepTime);
+    s[ParticleBlock::RelAge] += s[ParticleBlock::OneDivLifeTime] * stepTime;
+    const float4 aliveMask = LessMask(s[ParticleBlock::RelAge], one);
+    SizeT numAlive = 0;
+    IndexT lane;
+    for (lane = 0; lane < ParticleBlockSize; lane++)
+    {
+        alive[lane] = (ParticleBlockValue(block, ParticleBlock::RelAge, lane) < 1.0f) ? 1 : 0;
+        numAlive += alive[lane];
+    }
+    if (0 == numAlive)
     {
-        curStretchTime = (uniform->stretchTime > out.age) ? out.age : uniform->stretchTime;
+        return 0;
     }
 
-    // update position, velocity, rotation
-    ASSERT_POINT(in.position);
-    ASSERT_VECTOR(in.velocity);
-    out.position = in.position + in.velocity * samples[EmitterAttrs::VelocityFactor] * uniform->stepTime;
-    ASSERT_POINT(out.position);
-    UpdateBbox(out.position, sliceOutput->bboxMin, sliceOutput->bboxMax);
-    out.velocity = in.velocity + acceleration * uniform->stepTime;
-    ASSERT_VECTOR(out.velocity);
+    float4 samples[EmitterAttrs::NumEnvelopeAttrs];
+    LookupEnvelopeSamplesSoa(uniform->sampleBuffer, block, samples);
+
+    // compute current particle acceleration
+    const float4& mass = samples[EmitterAttrs::Mass];
+    const float4& airResistance = samples[EmitterAttrs::AirResistance];
+    const float4 accX = float4::multiply(airResistance * uniform->windVector.x() + float4::splat(uniform->gravity.x()), mass);
+    const float4 accY = float4::multiply(airResistance * uniform->windVector.y() + float4::splat(uniform->gravity.y()), mass);
+    const float4 accZ = float4::multiply(airResistance * uniform->windVector.z() + float4::splat(uniform->gravity.z()), mass);
+
+    // update position and velocity
+    const float4& velocityFactor = samples[EmitterAttrs::VelocityFactor];
+    const float4 velocityStep = velocityFactor * stepTime;
+    s[ParticleBlock::PositionX] += float4::multiply(s[ParticleBlock::VelocityX], velocityStep);
+    s[ParticleBlock::PositionY] += float4::multiply(s[ParticleBlock::VelocityY], velocityStep);
+    s[ParticleBlock::PositionZ] += float4::multiply(s[ParticleBlock::VelocityZ], velocityStep);
+    s[ParticleBlock::VelocityX] += accX * stepTime;
+    s[ParticleBlock::VelocityY] += accY * stepTime;
+    s[ParticleBlock::VelocityZ] += accZ * stepTime;
+
+    // update the bounding box, dead particles are moved out of the way
+    const float4 deadOffset = (one - aliveMask) * 1.0e30f;
+    bboxMinMax[0] = float4::minimize(bboxMinMax[0], s[ParticleBlock::PositionX] + deadOffset);
+    bboxMinMax[1] = float4::minimize(bboxMinMax[1], s[ParticleBlock::PositionY] + deadOffset);
+    bboxMinMax[2] = float4::minimize(bboxMinMax[2], s[ParticleBlock::PositionZ] + deadOffset);
+    bboxMinMax[3] = float4::maximize(bboxMinMax[3], s[ParticleBlock::PositionX] - deadOffset);
+    bboxMinMax[4] = float4::maximize(bboxMinMax[4], s[ParticleBlock::PositionY] - deadOffset);
+    bboxMinMax[5] = float4::maximize(bboxMinMax[5], s[ParticleBlock::PositionZ] - deadOffset);
+
+    // update stretch position and rotation
+    // NOTE: don't support particle rotation in stretch modes
     if (uniform->stretchToStart)
     {
-        // NOTE: don't support particle rotation in stretch modes
-        out.stretchPosition = in.startPosition;
-        out.rotation = in.rotation;
+        s[ParticleBlock::StretchPositionX] = s[ParticleBlock::StartPositionX];
+        s[ParticleBlock::StretchPositionY] = s[ParticleBlock::StartPositionY];
+        s[ParticleBlock::StretchPositionZ] = s[ParticleBlock::StartPositionZ];
     }
-    else if (curStretchTime > 0.0f)
-    {
-        // NOTE: don't support particle rotation in stretch modes
-        // ???
-        out.stretchPosition = out.position -
-                              (out.velocity - acceleration * curStretchTime * 0.5f) *
-                              (uniform->stretchTime * samples[EmitterAttrs::VelocityFactor]);
-        out.rotation = in.rotation;
-    }                
     else
     {
-        out.stretchPosition = out.position;
-        out.rotation = in.rotation + in.rotationVariation * samples[EmitterAttrs::RotationVelocity] * uniform->stepTime;
+        const float4 rotationStep = float4::multiply(s[ParticleBlock::RotationVariation], samples[EmitterAttrs::RotationVelocity]) * stepTime;
+        if (uniform->stretchTime > 0.0f)
+        {
+            // particles with a stretch time of 0 are handled like unstretched particles
+            const float4 curStretchTime = float4::minimize(float4::splat(uniform->stretchTime), s[ParticleBlock::Age]);
+            const float4 stretchMask = LessMask(float4(0.0f, 0.0f, 0.0f, 0.0f), curStretchTime);
+            const float4 halfStretchTime = curStretchTime * 0.5f;
+            const float4 stretchScale = velocityFactor * uniform->stretchTime;
+            const float4 offsX = float4::multiply(s[ParticleBlock::VelocityX] - float4::multiply(accX, halfStretchTime), stretchScale);
+            const float4 offsY = float4::multiply(s[ParticleBlock::VelocityY] - float4::multiply(accY, halfStretchTime), stretchScale);
+            const float4 offsZ = float4::multiply(s[ParticleBlock::VelocityZ] - float4::multiply(accZ, halfStretchTime), stretchScale);
+            s[ParticleBlock::StretchPositionX] = s[ParticleBlock::PositionX] - float4::multiply(offsX, stretchMask);
+            s[ParticleBlock::StretchPositionY] = s[ParticleBlock::PositionY] - float4::multiply(offsY, stretchMask);
+            s[ParticleBlock::StretchPositionZ] = s[ParticleBlock::PositionZ] - float4::multiply(offsZ, stretchMask);
+            s[ParticleBlock::Rotation] += float4::multiply(rotationStep, one - stretchMask);
+        }
+        else
+        {
+            s[ParticleBlock::StretchPositionX] = s[ParticleBlock::PositionX];
+            s[ParticleBlock::StretchPositionY] = s[ParticleBlock::PositionY];
+            s[ParticleBlock::StretchPositionZ] = s[ParticleBlock::PositionZ];
+            s[ParticleBlock::Rotation] += rotationStep;
+        }
     }
-    out.color.loadu(&(samples[EmitterAttrs::Red]));
-    out.size = samples[EmitterAttrs::Size] * in.sizeVariation;
+    s[ParticleBlock::ColorR] = samples[EmitterAttrs::Red];
+    s[ParticleBlock::ColorG] = samples[EmitterAttrs::Green];
+    s[ParticleBlock::ColorB] = samples[EmitterAttrs::Blue];
+    s[ParticleBlock::ColorA] = samples[EmitterAttrs::Alpha];
+    s[ParticleBlock::Size] = float4::multiply(samples[EmitterAttrs::Size], s[ParticleBlock::SizeVariation]);
+
+    return numAlive;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Fills the dead particles at the front of the slice with the living
+    particles from the end of the slice. The moved particles are marked
+    as dead, so that all particles behind the living particles are dead.
+*/
+__forceinline
+SizeT
+CompactParticles(ParticleBlock* blocks, SizeT numParticles, SizeT numLivingParticles, const unsigned char* alive)
+{
+    IndexT src = numParticles - 1;
+    IndexT dst;
+    for (dst = 0; dst < numLivingParticles; dst++)
+    {
+        if (!alive[dst])
+        {
+            while (!alive[src])
+            {
+                src--;
+            }
+            n_assert(src > dst);
+            ParticleBlockCopyParticle(blocks[src / ParticleBlockSize], src % ParticleBlockSize, blocks[dst / ParticleBlockSize], dst % ParticleBlockSize);
+            ParticleBlockKillParticle(blocks[src / ParticleBlockSize], src % ParticleBlockSize);
+            src--;
+        }
+    }
+    return numLivingParticles;
 }
 
 //------------------------------------------------------------------------------
@@ -232,47 +325,62 @@ void ParticleGenerateVertexList(const JobUniformData *uniform, Particle &out, Pa
 //------------------------------------------------------------------------------
 /**
 */
-#if __PS3__
-void JobStepAndVlist(const JobUniformData *uniform, unsigned int numParticles,
-                     const Particle *particles_input, Particle *particles_output,
-                     JobSliceOutputData *sliceOutput,
-                     ParticleQuadRenderVertex *vertexStream)
+void JobStep(const JobUniformData *uniform, unsigned int numBlocks,
+             const ParticleBlock *blocks_input, ParticleBlock *blocks_output, 
+             JobSliceOutputData *sliceOutput)
 {
+    n_assert((numBlocks * ParticleBlockSize) <= PARTICLE_JOB_MAX_PARTICLES_PER_SLICE);
+    unsigned char alive[PARTICLE_JOB_MAX_PARTICLES_PER_SLICE];
+    float4 bboxMinMax[6];
+    bboxMinMax[0] = float4::splat(999999.0f);
+    bboxMinMax[1] = bboxMinMax[0];
+    bboxMinMax[2] = bboxMinMax[0];
+    bboxMinMax[3] = float4::splat(-999999.0f);
+    bboxMinMax[4] = bboxMinMax[3];
+    bboxMinMax[5] = bboxMinMax[3];
+
+    SizeT numLivingParticles = 0;
     unsigned int i;
-    ParticleQuadRenderVertex *currentVertex = vertexStream;
-    for (i = 0; i < numParticles; i++)
+    for (i = 0; i < numBlocks; i++)
     {
-        const Particle &in = particles_input[i];
-        Particle &out = particles_output[i];
-        ParticleUpdateAge(uniform, in, out);
-        if (out.relAge < 1.0f)
+        if (blocks_output != blocks_input)
         {
-            ParticleStep(uniform, in, out, sliceOutput);
-            ParticleGenerateVertexList(uniform, out, currentVertex);
+            blocks_output[i] = blocks_input[i];
         }
+        numLivingParticles += ParticleBlockStep(uniform, blocks_output[i], &(alive[i * ParticleBlockSize]), bboxMinMax);
     }
+    sliceOutput->numLivingParticles = CompactParticles(blocks_output, numBlocks * ParticleBlockSize, numLivingParticles, alive);
+
+    // combine the SoA bounding box of the 4 lanes
+    const float4 one(1.0f, 1.0f, 1.0f, 1.0f);
+    matrix44 m = matrix44::transpose(matrix44(bboxMinMax[0], bboxMinMax[1], bboxMinMax[2], one));
+    sliceOutput->bboxMin = float4::minimize(float4::minimize(m.getrow0(), m.getrow1()), float4::minimize(m.getrow2(), m.getrow3()));
+    m = matrix44::transpose(matrix44(bboxMinMax[3], bboxMinMax[4], bboxMinMax[5], one));
+    sliceOutput->bboxMax = float4::maximize(float4::maximize(m.getrow0(), m.getrow1()), float4::maximize(m.getrow2(), m.getrow3()));
 }
-#endif
 
 //------------------------------------------------------------------------------
 /**
 */
-void JobStep(const JobUniformData *uniform, unsigned int numParticles,
-             const Particle *particles_input, Particle *particles_output, 
-             JobSliceOutputData *sliceOutput)
+#if __PS3__
+void JobStepAndVlist(const JobUniformData *uniform, unsigned int numBlocks,
+                     const ParticleBlock *blocks_input, ParticleBlock *blocks_output,
+                     JobSliceOutputData *sliceOutput,
+                     ParticleQuadRenderVertex *vertexStream)
 {
+    JobStep(uniform, numBlocks, blocks_input, blocks_output, sliceOutput);
+
+    // the living particles are at the front of the slice now
+    ParticleQuadRenderVertex *currentVertex = vertexStream;
+    Particle particle;
     unsigned int i;
-    for (i = 0; i < numParticles; i++)
+    for (i = 0; i < sliceOutput->numLivingParticles; i++)
     {
-        const Particle &in = particles_input[i];
-        Particle &out = particles_output[i];
-        ParticleUpdateAge(uniform, in, out);
-        if (out.relAge < 1.0f)
-        {
-            ParticleStep(uniform, in, out, sliceOutput);
-        }
+        ParticleBlockGetParticle(blocks_output[i / ParticleBlockSize], i % ParticleBlockSize, particle);
+        ParticleGenerateVertexList(uniform, particle, currentVertex);
     }
 }
+#endif
 
 //------------------------------------------------------------------------------
 /**
@@ -283,32 +391,28 @@ ParticleJobFunc(const JobFuncContext& ctx)
     const JobUniformData *uniform = (const JobUniformData *)ctx.uniforms[0];
     n_assert(ctx.uniformSizes[0] == sizeof(JobUniformData));
 
-    const Particle *particles_input = (const Particle *)ctx.inputs[0];
-    const unsigned int numParticles = ctx.inputSizes[0] / sizeof(Particle);
+    const ParticleBlock *blocks_input = (const ParticleBlock *)ctx.inputs[0];
+    const unsigned int numBlocks = ctx.inputSizes[0] / sizeof(ParticleBlock);
 
-    Particle *particles_output = (Particle *)ctx.outputs[0];
-    n_assert( (ctx.outputSizes[0] / sizeof(Particle)) == numParticles);
+    ParticleBlock *blocks_output = (ParticleBlock *)ctx.outputs[0];
+    n_assert( (ctx.outputSizes[0] / sizeof(ParticleBlock)) == numBlocks);
 
     JobSliceOutputData *sliceOutput = (JobSliceOutputData*)ctx.outputs[1];
     n_assert(ctx.outputSizes[1] == sizeof(JobSliceOutputData));
 
-    sliceOutput->numLivingParticles = 0;
-    sliceOutput->bboxMin = float4(999999.0f, 999999.0f, 999999.0f, 1.0f);
-    sliceOutput->bboxMax = float4(-999999.0f, -999999.0f, -999999.0f, 1.0f);
-
 #if __PS3__
     if(uniform->generateVertexList)
     {
         n_assert(3 == ctx.numOutputs);
         ParticleQuadRenderVertex *vertexStream = (ParticleQuadRenderVertex*)ctx.outputs[2];
         n_assert((unsigned int)ctx.outputSizes[2] == (unsigned int)Particles::PARTICLE_JOB_PS3_OUTPUT_VBUFFER_SLICE_SIZE);
-        JobStepAndVlist(uniform, numParticles, particles_input, particles_output, sliceOutput, vertexStream);
+        JobStepAndVlist(uniform, numBlocks, blocks_input, blocks_output, sliceOutput, vertexStream);
         return;
     }
 #endif
 
     n_assert(2 == ctx.numOutputs);
-    JobStep(uniform, numParticles, particles_input, particles_output, sliceOutput);
+    JobStep(uniform, numBlocks, blocks_input, blocks_output, sliceOutput);
 }
 
 } // namespace Particles
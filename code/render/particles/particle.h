@@ -4,7 +4,12 @@
     @class Particles::Particle
     
     The particle structure holds the current state of a single particle and
-    common data for particle-job and nebula3 particle system
+    common data for particle-job and nebula3 particle system.
+
+    Particle systems store their particles in ParticleBlocks, 4 particles
+    in SoA layout, so that the particle job can update 4 particles at once
+    with SIMD operations. The Particle structure is used to emit particles
+    and to access single particles of a block.
 
     !! NOTE: this header is also included from job particlejob.cc, so only 
     !! job-compliant headers can be included here
@@ -45,6 +50,145 @@ namespace Particles
         float particleId;                   // id for differing particles in vertex shader
     };
 
+    /// number of particles in a ParticleBlock
+    static const SizeT ParticleBlockSize = 4;
+
+    // 4 particles in SoA layout, each stream holds one particle attribute
+    // of the 4 particles, positions have an implicit w of 1, velocities 
+    // an implicit w of 0, unused or dead particles have a relAge >= 1
+    NEBULA3_ALIGN16
+    struct ParticleBlock
+    {
+        enum Stream
+        {
+            PositionX = 0, PositionY, PositionZ,
+            StartPositionX, StartPositionY, StartPositionZ,
+            StretchPositionX, StretchPositionY, StretchPositionZ,
+            VelocityX, VelocityY, VelocityZ,
+            UvMinX, UvMinY, UvMaxX, UvMaxY,
+            ColorR, ColorG, ColorB, ColorA,
+            Rotation,
+            RotationVariation,
+            Size,
+            SizeVariation,
+            OneDivLifeTime,
+            RelAge,
+            Age,
+            ParticleId,
+
+            NumStreams,
+        };
+        Math::float4 streams[NumStreams];
+    };
+
+    //------------------------------------------------------------------------------
+    /**
+        Access a single value of a particle block.
+    */
+    __forceinline float&
+    ParticleBlockValue(ParticleBlock& block, ParticleBlock::Stream stream, IndexT lane)
+    {
+        return ((float*)&(block.streams[stream]))[lane];
+    }
+
+    //------------------------------------------------------------------------------
+    /**
+        Access a single value of a particle block.
+    */
+    __forceinline float
+    ParticleBlockValue(const ParticleBlock& block, ParticleBlock::Stream stream, IndexT lane)
+    {
+        return ((const float*)&(block.streams[stream]))[lane];
+    }
+
+    //------------------------------------------------------------------------------
+    /**
+        Write a particle into a particle block.
+    */
+    inline void
+    ParticleBlockSetParticle(ParticleBlock& block, IndexT lane, const Particle& p)
+    {
+        float* f = (float*) block.streams;
+        f[ParticleBlock::PositionX * 4 + lane] = p.position.x();
+        f[ParticleBlock::PositionY * 4 + lane] = p.position.y();
+        f[ParticleBlock::PositionZ * 4 + lane] = p.position.z();
+        f[ParticleBlock::StartPositionX * 4 + lane] = p.startPosition.x();
+        f[ParticleBlock::StartPositionY * 4 + lane] = p.startPosition.y();
+        f[ParticleBlock::StartPositionZ * 4 + lane] = p.startPosition.z();
+        f[ParticleBlock::StretchPositionX * 4 + lane] = p.stretchPosition.x();
+        f[ParticleBlock::StretchPositionY * 4 + lane] = p.stretchPosition.y();
+        f[ParticleBlock::StretchPositionZ * 4 + lane] = p.stretchPosition.z();
+        f[ParticleBlock::VelocityX * 4 + lane] = p.velocity.x();
+        f[ParticleBlock::VelocityY * 4 + lane] = p.velocity.y();
+        f[ParticleBlock::VelocityZ * 4 + lane] = p.velocity.z();
+        f[ParticleBlock::UvMinX * 4 + lane] = p.uvMinMax.x();
+        f[ParticleBlock::UvMinY * 4 + lane] = p.uvMinMax.y();
+        f[ParticleBlock::UvMaxX * 4 + lane] = p.uvMinMax.z();
+        f[ParticleBlock::UvMaxY * 4 + lane] = p.uvMinMax.w();
+        f[ParticleBlock::ColorR * 4 + lane] = p.color.x();
+        f[ParticleBlock::ColorG * 4 + lane] = p.color.y();
+        f[ParticleBlock::ColorB * 4 + lane] = p.color.z();
+        f[ParticleBlock::ColorA * 4 + lane] = p.color.w();
+        f[ParticleBlock::Rotation * 4 + lane] = p.rotation;
+        f[ParticleBlock::RotationVariation * 4 + lane] = p.rotationVariation;
+        f[ParticleBlock::Size * 4 + lane] = p.size;
+        f[ParticleBlock::SizeVariation * 4 + lane] = p.sizeVariation;
+        f[ParticleBlock::OneDivLifeTime * 4 + lane] = p.oneDivLifeTime;
+        f[ParticleBlock::RelAge * 4 + lane] = p.relAge;
+        f[ParticleBlock::Age * 4 + lane] = p.age;
+        f[ParticleBlock::ParticleId * 4 + lane] = p.particleId;
+    }
+
+    //------------------------------------------------------------------------------
+    /**
+        Read a particle from a particle block.
+    */
+    inline void
+    ParticleBlockGetParticle(const ParticleBlock& block, IndexT lane, Particle& p)
+    {
+        const float* f = (const float*) block.streams;
+        p.position.set(f[ParticleBlock::PositionX * 4 + lane], f[ParticleBlock::PositionY * 4 + lane], f[ParticleBlock::PositionZ * 4 + lane], 1.0f);
+        p.startPosition.set(f[ParticleBlock::StartPositionX * 4 + lane], f[ParticleBlock::StartPositionY * 4 + lane], f[ParticleBlock::StartPositionZ * 4 + lane], 1.0f);
+        p.stretchPosition.set(f[ParticleBlock::StretchPositionX * 4 + lane], f[ParticleBlock::StretchPositionY * 4 + lane], f[ParticleBlock::StretchPositionZ * 4 + lane], 1.0f);
+        p.velocity.set(f[ParticleBlock::VelocityX * 4 + lane], f[ParticleBlock::VelocityY * 4 + lane], f[ParticleBlock::VelocityZ * 4 + lane], 0.0f);
+        p.uvMinMax.set(f[ParticleBlock::UvMinX * 4 + lane], f[ParticleBlock::UvMinY * 4 + lane], f[ParticleBlock::UvMaxX * 4 + lane], f[ParticleBlock::UvMaxY * 4 + lane]);
+        p.color.set(f[ParticleBlock::ColorR * 4 + lane], f[ParticleBlock::ColorG * 4 + lane], f[ParticleBlock::ColorB * 4 + lane], f[ParticleBlock::ColorA * 4 + lane]);
+        p.rotation = f[ParticleBlock::Rotation * 4 + lane];
+        p.rotationVariation = f[ParticleBlock::RotationVariation * 4 + lane];
+        p.size = f[ParticleBlock::Size * 4 + lane];
+        p.sizeVariation = f[ParticleBlock::SizeVariation * 4 + lane];
+        p.oneDivLifeTime = f[ParticleBlock::OneDivLifeTime * 4 + lane];
+        p.relAge = f[ParticleBlock::RelAge * 4 + lane];
+        p.age = f[ParticleBlock::Age * 4 + lane];
+        p.particleId = f[ParticleBlock::ParticleId * 4 + lane];
+    }
+
+    //------------------------------------------------------------------------------
+    /**
+        Copy a single particle between particle blocks.
+    */
+    __forceinline void
+    ParticleBlockCopyParticle(const ParticleBlock& src, IndexT srcLane, ParticleBlock& dst, IndexT dstLane)
+    {
+        const float* srcPtr = ((const float*) src.streams) + srcLane;
+        float* dstPtr = ((float*) dst.streams) + dstLane;
+        IndexT i;
+        for (i = 0; i < ParticleBlock::NumStreams; i++)
+        {
+            dstPtr[i * 4] = srcPtr[i * 4];
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /**
+        Mark a particle of a particle block as dead.
+    */
+    __forceinline void
+    ParticleBlockKillParticle(ParticleBlock& block, IndexT lane)
+    {
+        ParticleBlockValue(block, ParticleBlock::RelAge, lane) = 2.0f;
+    }
+
     typedef unsigned int JOB_ID;
 
     // uniform data for particle system instances, used for job-uniform data as well,
@@ -79,7 +223,8 @@ namespace Particles
 #endif
 	};
 
-    // each job-slice generates this output
+    // each job-slice generates this output, the living particles 
+    // of a slice are moved to the front of the slice by the job
 	NEBULA3_ALIGN16
     struct JobSliceOutputData
     {
@@ -100,21 +245,20 @@ namespace Particles
     };
 #endif
 
-    static const SizeT PARTICLE_JOB_INPUT_ELEMENT_SIZE = sizeof(Particle);
+    // the input elements of the particle job are particle blocks
+    static const SizeT PARTICLE_JOB_INPUT_ELEMENT_SIZE = sizeof(ParticleBlock);
 
 #if __PS3__
-    // vertex output buffer is twice as big as input buffer, thats why we divide by 2, if
-    // for vertex stream generation jiobs
-    static const SizeT PARTICLE_JOB_INPUT_MAX_ELEMENTS_PER_SLICE__VSTREAM_ON = (JobMaxSliceSize / PARTICLE_JOB_INPUT_ELEMENT_SIZE) / 2;
+    static const SizeT PARTICLE_JOB_PS3_RENDER_QUAD_SIZE = 4 * sizeof(Particles::ParticleQuadRenderVertex);
+    // the vertex output slice must hold the quads of all particles in the input slice
+    static const SizeT PARTICLE_JOB_INPUT_MAX_ELEMENTS_PER_SLICE__VSTREAM_ON = JobMaxSliceSize / (PARTICLE_JOB_PS3_RENDER_QUAD_SIZE * ParticleBlockSize);
     static const SizeT PARTICLE_JOB_INPUT_SLICE_SIZE__VSTREAM_ON = PARTICLE_JOB_INPUT_MAX_ELEMENTS_PER_SLICE__VSTREAM_ON * PARTICLE_JOB_INPUT_ELEMENT_SIZE;
+    static const SizeT PARTICLE_JOB_PS3_OUTPUT_VBUFFER_SLICE_SIZE = PARTICLE_JOB_INPUT_MAX_ELEMENTS_PER_SLICE__VSTREAM_ON * ParticleBlockSize * PARTICLE_JOB_PS3_RENDER_QUAD_SIZE;
 #endif
     static const SizeT PARTICLE_JOB_INPUT_MAX_ELEMENTS_PER_SLICE__VSTREAM_OFF = JobMaxSliceSize / PARTICLE_JOB_INPUT_ELEMENT_SIZE;
     static const SizeT PARTICLE_JOB_INPUT_SLICE_SIZE__VSTREAM_OFF = PARTICLE_JOB_INPUT_MAX_ELEMENTS_PER_SLICE__VSTREAM_OFF * PARTICLE_JOB_INPUT_ELEMENT_SIZE;
-
-#if __PS3__
-    static const SizeT PARTICLE_JOB_PS3_RENDER_QUAD_SIZE = 4 * sizeof(Particles::ParticleQuadRenderVertex);
-    static const SizeT PARTICLE_JOB_PS3_OUTPUT_VBUFFER_SLICE_SIZE = PARTICLE_JOB_INPUT_MAX_ELEMENTS_PER_SLICE__VSTREAM_ON * PARTICLE_JOB_PS3_RENDER_QUAD_SIZE;
-#endif
+    // max number of particles in a job slice
+    static const SizeT PARTICLE_JOB_MAX_PARTICLES_PER_SLICE = PARTICLE_JOB_INPUT_MAX_ELEMENTS_PER_SLICE__VSTREAM_OFF * ParticleBlockSize;
 
 } // namespace Particles
 //------------------------------------------------------------------------------
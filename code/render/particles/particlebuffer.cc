@@ -0,0 +1,156 @@
+//------------------------------------------------------------------------------
+//  particlebuffer.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "particles/particlebuffer.h"
+
+namespace Particles
+{
+
+//------------------------------------------------------------------------------
+/**
+*/
+ParticleBuffer::ParticleBuffer() :
+    blocks(0),
+    capacity(0),
+    size(0),
+    replaceIndex(0)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+ParticleBuffer::~ParticleBuffer()
+{
+    if (0 != this->blocks)
+    {
+        n_delete_array(this->blocks);
+        this->blocks = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ParticleBuffer::SetCapacity(SizeT num)
+{
+    n_assert(num > 0);
+    if (0 != this->blocks)
+    {
+        n_delete_array(this->blocks);
+        this->blocks = 0;
+    }
+    SizeT numBlocks = (num + ParticleBlockSize - 1) / ParticleBlockSize;
+    this->blocks = n_new_array(ParticleBlock, numBlocks);
+    Memory::Clear(this->blocks, numBlocks * sizeof(ParticleBlock));
+    this->capacity = num;
+    this->size = this->capacity;
+    this->Reset();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ParticleBuffer::Reset()
+{
+    this->KillParticles();
+    this->size = 0;
+    this->replaceIndex = 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+    The particle job only updates the used blocks, so all particles 
+    behind the current size must be dead.
+*/
+void
+ParticleBuffer::KillParticles()
+{
+    SizeT numParticles = this->GetNumBlocks() * ParticleBlockSize;
+    IndexT i;
+    for (i = 0; i < numParticles; i++)
+    {
+        ParticleBlockKillParticle(this->blocks[i / ParticleBlockSize], i % ParticleBlockSize);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ParticleBuffer::Add(const Particle& particle)
+{
+    n_assert(0 != this->blocks);
+    IndexT index;
+    if (this->size < this->capacity)
+    {
+        index = this->size++;
+    }
+    else
+    {
+        // buffer is full, replace an existing particle
+        index = this->replaceIndex;
+        this->replaceIndex = (this->replaceIndex + 1) % this->capacity;
+    }
+    ParticleBlockSetParticle(this->blocks[index / ParticleBlockSize], index % ParticleBlockSize, particle);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Called after the particle job has finished. The job moved the living 
+    particles of each slice to the front of the slice, this fills the 
+    gaps at the end of the slices with the living particles from the
+    last slices, so that all living particles are at the front of the
+    buffer again.
+*/
+void
+ParticleBuffer::Compact(const JobSliceOutputData* sliceOutput, SizeT numSlices, SizeT particlesPerSlice)
+{
+    n_assert(numSlices > 0);
+    n_assert(((numSlices - 1) * particlesPerSlice) < this->size);
+
+    SizeT numLivingParticles = 0;
+    IndexT slice;
+    for (slice = 0; slice < numSlices; slice++)
+    {
+        numLivingParticles += sliceOutput[slice].numLivingParticles;
+    }
+
+    // src is one behind the last not yet moved living particle of srcSlice
+    IndexT srcSlice = numSlices - 1;
+    IndexT src = srcSlice * particlesPerSlice + sliceOutput[srcSlice].numLivingParticles;
+    for (slice = 0; slice < numSlices; slice++)
+    {
+        IndexT sliceStart = slice * particlesPerSlice;
+        if (sliceStart >= numLivingParticles)
+        {
+            break;
+        }
+        IndexT dst = sliceStart + sliceOutput[slice].numLivingParticles;
+        IndexT dstEnd = Math::n_min(sliceStart + particlesPerSlice, numLivingParticles);
+        for (; dst < dstEnd; dst++)
+        {
+            while (src <= (srcSlice * particlesPerSlice))
+            {
+                srcSlice--;
+                src = srcSlice * particlesPerSlice + sliceOutput[srcSlice].numLivingParticles;
+            }
+            src--;
+            n_assert(src >= numLivingParticles);
+            ParticleBlockCopyParticle(this->blocks[src / ParticleBlockSize], src % ParticleBlockSize, this->blocks[dst / ParticleBlockSize], dst % ParticleBlockSize);
+            ParticleBlockKillParticle(this->blocks[src / ParticleBlockSize], src % ParticleBlockSize);
+        }
+    }
+    this->size = numLivingParticles;
+    if (this->replaceIndex >= this->size)
+    {
+        this->replaceIndex = 0;
+    }
+}
+
+} // namespace Particles
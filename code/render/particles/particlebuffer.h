@@ -0,0 +1,120 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Particles::ParticleBuffer
+    
+    Stores the particles of a particle system instance in ParticleBlocks 
+    (4 particles in SoA layout), which are updated in place by the 
+    particle job. The living particles are always kept at the front of 
+    the buffer: the particle job moves the living particles to the front
+    of each job slice, and Compact() closes the gaps between the slices
+    after the job has finished. If the buffer is full, new particles 
+    replace existing particles in rotating order.
+    
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/types.h"
+#include "particles/particle.h"
+
+//------------------------------------------------------------------------------
+namespace Particles
+{
+class ParticleBuffer
+{
+public:
+    /// constructor
+    ParticleBuffer();
+    /// destructor
+    ~ParticleBuffer();
+
+    /// set the max number of particles, discards the current content
+    void SetCapacity(SizeT num);
+    /// get the max number of particles
+    SizeT GetCapacity() const;
+    /// get number of particles in the buffer
+    SizeT Size() const;
+    /// return true if the buffer is empty
+    bool IsEmpty() const;
+    /// remove all particles
+    void Reset();
+    /// add a particle, replaces an existing particle if the buffer is full
+    void Add(const Particle& particle);
+    /// copy a particle out of the buffer
+    void GetParticle(IndexT index, Particle& outParticle) const;
+
+    /// get number of used particle blocks
+    SizeT GetNumBlocks() const;
+    /// get pointer to the particle blocks
+    ParticleBlock* GetBuffer() const;
+    /// close the gaps between the living particles of the job slices
+    void Compact(const JobSliceOutputData* sliceOutput, SizeT numSlices, SizeT particlesPerSlice);
+
+private:
+    /// mark the particles in the used blocks as dead
+    void KillParticles();
+
+    ParticleBlock* blocks;
+    SizeT capacity;
+    SizeT size;
+    IndexT replaceIndex;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+ParticleBuffer::GetCapacity() const
+{
+    return this->capacity;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+ParticleBuffer::Size() const
+{
+    return this->size;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+ParticleBuffer::IsEmpty() const
+{
+    return (0 == this->size);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+ParticleBuffer::GetParticle(IndexT index, Particle& outParticle) const
+{
+    #if NEBULA3_BOUNDSCHECKS
+    n_assert((index >= 0) && (index < this->size));
+    #endif
+    ParticleBlockGetParticle(this->blocks[index / ParticleBlockSize], index % ParticleBlockSize, outParticle);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+ParticleBuffer::GetNumBlocks() const
+{
+    return (this->size + ParticleBlockSize - 1) / ParticleBlockSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline ParticleBlock*
+ParticleBuffer::GetBuffer() const
+{
+    return this->blocks;
+}
+
+} // namespace Particles
+//------------------------------------------------------------------------------
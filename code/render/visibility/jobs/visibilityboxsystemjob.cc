@@ -1,5 +1,5 @@
 //------------------------------------------------------------------------------
-//  charevalskeletonjob.cc
+//  visibilityboxsystemjob.cc
 //  (C) 2009 Radon Labs GmbH
 //------------------------------------------------------------------------------
 #include "stdneb.h"
@@ -103,12 +103,10 @@ VisibilityBoxSystemJobFunc(const JobFuncContext& ctx)
     SizeT numBoxes = ctx.uniformSizes[0];
     IndexT* neighbors = (IndexT*)ctx.uniforms[1];
     SizeT numNeighbors = ctx.uniformSizes[1];
-    Ptr<VisibilityContext>* output = (Ptr<VisibilityContext>*)ctx.outputs[0];
-    SizeT numOutputs = ctx.outputSizes[0];
+    IndexT* output = (IndexT*)ctx.outputs[0];
+    SizeT& numVisible = *(SizeT*)ctx.outputs[1];
     const Math::point& observerPosition = *(Math::point*)ctx.inputs[0];
-    uint entityTypeMask = *(uint*)ctx.inputs[1];
-    uint curCellIndex = 0;
-    uint curEntitiesIndex = 0;
+    const Ptr<VisibilityContext>* contexts = (const Ptr<VisibilityContext>*)ctx.inputs[1];
 
     // update visibility boxes for this observer     
     matrix44* observerFrustum = (matrix44*)ctx.inputs[2]; 
@@ -116,43 +114,50 @@ VisibilityBoxSystemJobFunc(const JobFuncContext& ctx)
 
     IndexT* boxMapping = (IndexT*)ctx.inputs[3];
     SizeT numBoxMappings = ctx.inputSizes[3];
-    // now go thru visiblecontexts, checked before
-    // cause this vis system comes after other systems, we work on the outEntitiyArray
+    // now go thru visible contexts, checked before
+    // cause this vis system comes after other systems, we work on the index list
     // and throw out any non visible contexts
     IndexT contextIdx;
-    for (contextIdx = 0; contextIdx < numOutputs; ++contextIdx)
+    for (contextIdx = 0; contextIdx < numVisible; ++contextIdx)
     {           
-        if (output[contextIdx].isvalid())
-        { 
-            // FIXME: optimize search for box mapping 
-            IndexT* mPtr = boxMapping; 
-            IndexT boxMapIdx;
-            for (boxMapIdx = 0; boxMapIdx < numBoxMappings; ++boxMapIdx)
-            {                   
-                uint boxMappingPtr = *mPtr;
-                mPtr++;
-                SizeT numBoxesForContext = *mPtr;
-                mPtr++;
-                if (numBoxesForContext > 0)
+        // works only on 32 bit systems, see VisibilityBoxSystem::CollectFlattenBoxMapping()
+        uint contextPtr = (uint)contexts[output[contextIdx]].get();
+        bool contextVisible = true;
+
+        // FIXME: optimize search for box mapping 
+        IndexT* mPtr = boxMapping; 
+        IndexT boxMapIdx;
+        for (boxMapIdx = 0; (boxMapIdx < numBoxMappings) && contextVisible; ++boxMapIdx)
+        {                   
+            uint boxMappingPtr = *mPtr;
+            mPtr++;
+            SizeT numBoxesForContext = *mPtr;
+            mPtr++;
+            if (numBoxesForContext > 0)
+            {   
+                if (boxMappingPtr == contextPtr)
                 {   
-                    uint contextPtr = (uint)output[contextIdx].get();
-                    if (boxMappingPtr == contextPtr)
-                    {   
-                        IndexT boxMappingIdx;
-                        for (boxMappingIdx = 0; boxMappingIdx < numBoxesForContext; ++boxMappingIdx)
-                        {  
-                            const VisibilityBox::VisibilityBoxJobData& box = visBoxes[mPtr[boxMappingIdx]];                
-                            if (!box.isVisible)
-                            {
-                                output[contextIdx] = 0;
-                                break;
-                            }  
+                    IndexT boxMappingIdx;
+                    for (boxMappingIdx = 0; boxMappingIdx < numBoxesForContext; ++boxMappingIdx)
+                    {  
+                        const VisibilityBox::VisibilityBoxJobData& box = visBoxes[mPtr[boxMappingIdx]];                
+                        if (!box.isVisible)
+                        {
+                            contextVisible = false;
+                            break;
                         }  
-                    }
-                    mPtr += numBoxesForContext;
-                }            	
-            }
-             
+                    }  
+                }
+                mPtr += numBoxesForContext;
+            }            	
+        }
+
+        if (!contextVisible)
+        {
+            // remove from index list, order of visible entities doesn't matter
+            output[contextIdx] = output[numVisible - 1];
+            numVisible--;
+            contextIdx--;
         }
     }
 }
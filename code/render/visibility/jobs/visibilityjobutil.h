@@ -0,0 +1,211 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @file visibilityjobutil.h
+
+    Utility functions for the visibility jobs. Entity bounding boxes
+    are tested in groups of 4 from the SoA entity data of the
+    VisibilityQuadtree.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "math/float4.h"
+#include "math/matrix44.h"
+#include "math/bbox.h"
+#include "visibility/visibilitysystems/visibilityquadtree.h"
+
+namespace Visibility
+{
+
+using namespace Math;
+
+/// the clip planes of a projection observer, splatted for SoA tests
+struct VisibilityJobFrustum
+{
+    float4 planes[6];
+    float4 a[6];
+    float4 b[6];
+    float4 c[6];
+    float4 d[6];
+};
+
+/// the bounding box of a box observer, splatted for SoA tests
+struct VisibilityJobBox
+{
+    float4 minX;
+    float4 minY;
+    float4 minZ;
+    float4 maxX;
+    float4 maxY;
+    float4 maxZ;
+};
+
+/// SoA view on the entity data of the quadtree
+struct VisibilityJobEntities
+{
+    const float* minX;
+    const float* minY;
+    const float* minZ;
+    const float* maxX;
+    const float* maxY;
+    const float* maxZ;
+    const uint* types;
+};
+
+//------------------------------------------------------------------------------
+/**
+    Setup the SoA view from the entity data uniform buffer.
+*/
+inline void
+VisibilityJobUtilSetupEntities(const void* entityData, SizeT entityDataSize, VisibilityJobEntities& outEntities)
+{
+    SizeT numEntitiesPadded = entityDataSize / VisibilityQuadtree::EntityDataStride;
+    outEntities.minX = (const float*)entityData;
+    outEntities.minY = outEntities.minX + numEntitiesPadded;
+    outEntities.minZ = outEntities.minY + numEntitiesPadded;
+    outEntities.maxX = outEntities.minZ + numEntitiesPadded;
+    outEntities.maxY = outEntities.maxX + numEntitiesPadded;
+    outEntities.maxZ = outEntities.maxY + numEntitiesPadded;
+    outEntities.types = (const uint*)(outEntities.maxZ + numEntitiesPadded);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Extract the clip planes from a view-projection matrix. The plane normals
+    point to the inside of the frustum, a point is inside of a plane if
+    dot(plane, point) >= 0, which is the same test as in bbox::clipstatus().
+*/
+inline void
+VisibilityJobUtilSetupFrustum(const matrix44& viewProj, VisibilityJobFrustum& outFrustum)
+{
+    // the rows of the transposed matrix are the clip space x, y, z and w components
+    matrix44 m = matrix44::transpose(viewProj);
+    const float4& cx = m.getrow0();
+    const float4& cy = m.getrow1();
+    const float4& cz = m.getrow2();
+    const float4& cw = m.getrow3();
+    outFrustum.planes[0] = cw + cx;
+    outFrustum.planes[1] = cw - cx;
+    outFrustum.planes[2] = cw + cy;
+    outFrustum.planes[3] = cw - cy;
+    outFrustum.planes[4] = cw + cz;
+    outFrustum.planes[5] = cw - cz;
+
+    IndexT i;
+    for (i = 0; i < 6; i++)
+    {
+        outFrustum.a[i] = float4::splat_x(outFrustum.planes[i]);
+        outFrustum.b[i] = float4::splat_y(outFrustum.planes[i]);
+        outFrustum.c[i] = float4::splat_z(outFrustum.planes[i]);
+        outFrustum.d[i] = float4::splat_w(outFrustum.planes[i]);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+VisibilityJobUtilSetupBox(const bbox& box, VisibilityJobBox& outBox)
+{
+    outBox.minX = float4::splat_x(box.pmin);
+    outBox.minY = float4::splat_y(box.pmin);
+    outBox.minZ = float4::splat_z(box.pmin);
+    outBox.maxX = float4::splat_x(box.pmax);
+    outBox.maxY = float4::splat_y(box.pmax);
+    outBox.maxZ = float4::splat_z(box.pmax);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Get the clip status of a cell box against the frustum planes.
+*/
+inline ClipStatus::Type
+VisibilityJobUtilCellClipStatus(const bbox& box, const VisibilityJobFrustum& frustum)
+{
+    const float4& pmin = box.pmin;
+    const float4& pmax = box.pmax;
+    bool inside = true;
+    IndexT i;
+    for (i = 0; i < 6; i++)
+    {
+        const float4& p = frustum.planes[i];
+
+        // the box corner farthest along the plane normal
+        float4 pVertex(p.x() > 0.0f ? pmax.x() : pmin.x(),
+                       p.y() > 0.0f ? pmax.y() : pmin.y(),
+                       p.z() > 0.0f ? pmax.z() : pmin.z(),
+                       0.0f);
+        if ((float4::dot3(p, pVertex) + p.w()) < 0.0f)
+        {
+            return ClipStatus::Outside;
+        }
+
+        // the box corner nearest along the plane normal
+        float4 nVertex(p.x() > 0.0f ? pmin.x() : pmax.x(),
+                       p.y() > 0.0f ? pmin.y() : pmax.y(),
+                       p.z() > 0.0f ? pmin.z() : pmax.z(),
+                       0.0f);
+        if ((float4::dot3(p, nVertex) + p.w()) < 0.0f)
+        {
+            inside = false;
+        }
+    }
+    return inside ? ClipStatus::Inside : ClipStatus::Clipped;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Test a group of 4 entity boxes against the frustum planes. For each
+    plane the distance of the box corner farthest along the plane normal
+    is computed, the minimum over all planes is returned. A box is
+    visible if its distance is not negative.
+*/
+inline float4
+VisibilityJobUtilFrustumDistance(const VisibilityJobEntities& entities, IndexT groupIndex, const VisibilityJobFrustum& frustum)
+{
+    float4 minX, minY, minZ, maxX, maxY, maxZ;
+    minX.load(entities.minX + groupIndex);
+    minY.load(entities.minY + groupIndex);
+    minZ.load(entities.minZ + groupIndex);
+    maxX.load(entities.maxX + groupIndex);
+    maxY.load(entities.maxY + groupIndex);
+    maxZ.load(entities.maxZ + groupIndex);
+
+    float4 minDist;
+    IndexT i;
+    for (i = 0; i < 6; i++)
+    {
+        float4 dist = float4::maximize(float4::multiply(frustum.a[i], minX), float4::multiply(frustum.a[i], maxX)) +
+                      float4::maximize(float4::multiply(frustum.b[i], minY), float4::multiply(frustum.b[i], maxY)) +
+                      float4::maximize(float4::multiply(frustum.c[i], minZ), float4::multiply(frustum.c[i], maxZ)) +
+                      frustum.d[i];
+        minDist = (0 == i) ? dist : float4::minimize(minDist, dist);
+    }
+    return minDist;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Test a group of 4 entity boxes against an observer box. The separation
+    of the boxes is computed per axis, the negated maximum separation is
+    returned, so that a box is visible if the result is not negative.
+*/
+inline float4
+VisibilityJobUtilBoxDistance(const VisibilityJobEntities& entities, IndexT groupIndex, const VisibilityJobBox& box)
+{
+    float4 minX, minY, minZ, maxX, maxY, maxZ;
+    minX.load(entities.minX + groupIndex);
+    minY.load(entities.minY + groupIndex);
+    minZ.load(entities.minZ + groupIndex);
+    maxX.load(entities.maxX + groupIndex);
+    maxY.load(entities.maxY + groupIndex);
+    maxZ.load(entities.maxZ + groupIndex);
+
+    float4 sepX = float4::maximize(minX - box.maxX, box.minX - maxX);
+    float4 sepY = float4::maximize(minY - box.maxY, box.minY - maxY);
+    float4 sepZ = float4::maximize(minZ - box.maxZ, box.minZ - maxZ);
+    return float4(0.0f, 0.0f, 0.0f, 0.0f) - float4::maximize(float4::maximize(sepX, sepY), sepZ);
+}
+
+} // namespace Visibility
+//------------------------------------------------------------------------------
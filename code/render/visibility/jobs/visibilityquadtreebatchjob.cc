@@ -0,0 +1,229 @@
+//------------------------------------------------------------------------------
+//  visibilityquadtreebatchjob.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "jobs/stdjob.h"
+#include "visibility/observercontext.h"
+#include "visibility/visibilityresult.h"
+#include "visibility/visibilitysystems/visibilityquadtree.h"
+#include "visibility/jobs/visibilityjobutil.h"
+
+namespace Visibility
+{
+using namespace Math;
+using namespace Util;
+using namespace InternalGraphics;
+
+/// state of a batched quadtree traversal
+struct BatchTraversal
+{
+    const VisibilityQuadtree::CellInfo* cells;
+    VisibilityJobEntities entities;
+    SizeT numObservers;
+    uint boxObserverMask;
+    VisibilityJobFrustum frusta[VisibilityBatchResult::MaxNumObservers];
+    VisibilityJobBox boxes[VisibilityBatchResult::MaxNumObservers];
+    const bbox* observerBoxes[VisibilityBatchResult::MaxNumObservers];
+    uint typeObserverMasks[InternalGraphicsEntityType::NumTypes];
+    uint* output;
+};
+
+//------------------------------------------------------------------------------
+/**
+    Write the observer masks of all entities of a range.
+*/
+void
+WriteEntityRangeMasks(const BatchTraversal& batch, IndexT firstIndex, SizeT num, uint observerMask)
+{
+    IndexT endIndex = firstIndex + num;
+    IndexT i;
+    for (i = firstIndex; i < endIndex; i++)
+    {
+        batch.output[i] = observerMask & batch.typeObserverMasks[batch.entities.types[i]];
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Test the entities of a range against all observers of the clipped mask,
+    4 entities at a time. Observers of the inside mask see the whole range.
+*/
+void
+CullEntityRangeBatch(const BatchTraversal& batch, IndexT firstIndex, SizeT num, uint clippedMask, uint insideMask)
+{
+    const SizeT groupSize = VisibilityQuadtree::EntityGroupSize;
+    IndexT endIndex = firstIndex + num;
+    IndexT groupIndex;
+    for (groupIndex = firstIndex & ~(groupSize - 1); groupIndex < endIndex; groupIndex += groupSize)
+    {
+        uint laneMasks[4] = { insideMask, insideMask, insideMask, insideMask };
+        IndexT observerIndex;
+        for (observerIndex = 0; observerIndex < batch.numObservers; observerIndex++)
+        {
+            uint observerBit = (1 << observerIndex);
+            if (0 != (clippedMask & observerBit))
+            {
+                float4 dist;
+                if (0 != (batch.boxObserverMask & observerBit))
+                {
+                    dist = VisibilityJobUtilBoxDistance(batch.entities, groupIndex, batch.boxes[observerIndex]);
+                }
+                else
+                {
+                    dist = VisibilityJobUtilFrustumDistance(batch.entities, groupIndex, batch.frusta[observerIndex]);
+                }
+                if (dist.x() >= 0.0f) laneMasks[0] |= observerBit;
+                if (dist.y() >= 0.0f) laneMasks[1] |= observerBit;
+                if (dist.z() >= 0.0f) laneMasks[2] |= observerBit;
+                if (dist.w() >= 0.0f) laneMasks[3] |= observerBit;
+            }
+        }
+
+        IndexT lane;
+        for (lane = 0; lane < 4; lane++)
+        {
+            IndexT entityIndex = groupIndex + lane;
+            if ((entityIndex >= firstIndex) && (entityIndex < endIndex))
+            {
+                batch.output[entityIndex] = laneMasks[lane] & batch.typeObserverMasks[batch.entities.types[entityIndex]];
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Check a cell against all observers which see the parent cell partially
+    (clippedMask) or fully (insideMask), and recurse into the child cells.
+*/
+void
+CheckCellBatch(const BatchTraversal& batch, IndexT cellIndex, uint clippedMask, uint insideMask)
+{
+    const VisibilityQuadtree::CellInfo& cell = batch.cells[cellIndex];
+    if (0 == cell.numEntitiesInHierarchy)
+    {
+        return;
+    }
+
+    // only observers which clip the parent cell need to test this cell
+    uint testMask = clippedMask;
+    clippedMask = 0;
+    IndexT observerIndex;
+    for (observerIndex = 0; observerIndex < batch.numObservers; observerIndex++)
+    {
+        uint observerBit = (1 << observerIndex);
+        if (0 != (testMask & observerBit))
+        {
+            ClipStatus::Type clipStatus;
+            if (0 != (batch.boxObserverMask & observerBit))
+            {
+                clipStatus = batch.observerBoxes[observerIndex]->clipstatus(cell.box);
+            }
+            else
+            {
+                clipStatus = VisibilityJobUtilCellClipStatus(cell.box, batch.frusta[observerIndex]);
+            }
+            if (ClipStatus::Inside == clipStatus)
+            {
+                insideMask |= observerBit;
+            }
+            else if (ClipStatus::Clipped == clipStatus)
+            {
+                clippedMask |= observerBit;
+            }
+        }
+    }
+
+    if (0 == (clippedMask | insideMask))
+    {
+        // cell isn't visible by any observer
+        return;
+    }
+    if (0 == clippedMask)
+    {
+        // cell is fully visible by all remaining observers, everything in
+        // the subtree is visible as well
+        WriteEntityRangeMasks(batch, cell.firstEntityIndex, cell.numEntitiesInHierarchy, insideMask);
+        return;
+    }
+
+    // cell is partially visible, check the entities of the cell
+    if (cell.numEntitiesInCell > 0)
+    {
+        CullEntityRangeBatch(batch, cell.firstEntityIndex, cell.numEntitiesInCell, clippedMask, insideMask);
+    }
+
+    // recurse into child cells, which follow the cell in the cell array
+    IndexT childIndex = cellIndex + 1;
+    while (childIndex < cell.skipIndex)
+    {
+        CheckCellBatch(batch, childIndex, clippedMask, insideMask);
+        childIndex = batch.cells[childIndex].skipIndex;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Cull the quadtree entities against up to 32 observers in one traversal.
+    The output is one observer bit mask per entity.
+*/
+void
+VisibilityQuadtreeBatchJobFunc(const JobFuncContext& ctx)
+{
+    BatchTraversal batch;
+    batch.cells = (const VisibilityQuadtree::CellInfo*)ctx.uniforms[0];
+    VisibilityJobUtilSetupEntities(ctx.uniforms[1], ctx.uniformSizes[1], batch.entities);
+    batch.output = (uint*)ctx.outputs[0];
+    SizeT numEntities = batch.cells[0].numEntitiesInHierarchy;
+    Memory::Clear(batch.output, numEntities * sizeof(uint));
+
+    const VisibilityBatchResult::ObserverInfo* observers = (const VisibilityBatchResult::ObserverInfo*)ctx.inputs[0];
+    batch.numObservers = ctx.inputSizes[0] / sizeof(VisibilityBatchResult::ObserverInfo);
+    n_assert(batch.numObservers <= VisibilityBatchResult::MaxNumObservers);
+    batch.boxObserverMask = 0;
+
+    // setup observers, observers which see everything see every cell fully
+    uint clippedMask = 0;
+    uint insideMask = 0;
+    IndexT i;
+    for (i = 0; i < InternalGraphicsEntityType::NumTypes; i++)
+    {
+        batch.typeObserverMasks[i] = 0;
+    }
+    for (i = 0; i < batch.numObservers; i++)
+    {
+        uint observerBit = (1 << i);
+        const VisibilityBatchResult::ObserverInfo& observer = observers[i];
+        switch (observer.type)
+        {
+        case ObserverContext::BoundingBox:
+            batch.observerBoxes[i] = &observer.boundingBox;
+            VisibilityJobUtilSetupBox(observer.boundingBox, batch.boxes[i]);
+            batch.boxObserverMask |= observerBit;
+            clippedMask |= observerBit;
+            break;
+        case ObserverContext::ProjectionMatrix:
+            VisibilityJobUtilSetupFrustum(observer.projectionView, batch.frusta[i]);
+            clippedMask |= observerBit;
+            break;
+        default:
+            insideMask |= observerBit;
+            break;
+        }
+
+        IndexT type;
+        for (type = 0; type < InternalGraphicsEntityType::NumTypes; type++)
+        {
+            if (0 != (observer.entityMask & (1 << type)))
+            {
+                batch.typeObserverMasks[type] |= observerBit;
+            }
+        }
+    }
+
+    CheckCellBatch(batch, 0, clippedMask, insideMask);
+}
+
+} // namespace Visibility
+__ImplementSpursJob(Visibility::VisibilityQuadtreeBatchJobFunc);
@@ -1,15 +1,12 @@
 //------------------------------------------------------------------------------
-//  charevalskeletonjob.cc
+//  visibilityquadtreejob.cc
 //  (C) 2009 Radon Labs GmbH
 //------------------------------------------------------------------------------
 #include "stdneb.h"
 #include "jobs/stdjob.h"
-#include "math/float4.h"
-#include "math/matrix44.h"
-#include "math/bbox.h"
 #include "visibility/observercontext.h"
 #include "visibility/visibilitysystems/visibilityquadtree.h"
-#include "util/quadtree.h"
+#include "visibility/jobs/visibilityjobutil.h"
 
 namespace Visibility
 {
@@ -19,108 +16,73 @@ using namespace InternalGraphics;
 
 //------------------------------------------------------------------------------
 /**
+    Append the visible lanes of an entity group to the output index list.
 */
-void  
-CheckCell(QuadTree<VisibilityQuadtree::CellInfo>::Node* node,
-          VisibilityQuadtree::EntityInfo* entityInfos,
-          SizeT numEntityInfos,
-          bbox* observerBox, 
-          matrix44* observerFrustum, 
-          Ptr<VisibilityContext>* visEntities,
-          SizeT* numEntitiesVisible,
-          uint entityTypeMask,
-          ClipStatus::Type clipStatus)
-{       
-    SizeT numEntitiesInHierarchy = node->GetElement().numEntitiesInHierarchy;
-    if (numEntitiesInHierarchy == 0) 
-    {
-        return;
-    }
-    // if clip status unknown or clipped, get clip status of this cell against observer context
-    if ((ClipStatus::Invalid == clipStatus) || (ClipStatus::Clipped == clipStatus))
+inline void
+EmitVisibleLanes(const float4& visibleDist, IndexT groupIndex, IndexT firstIndex, IndexT endIndex, const uint* types, uint entityTypeMask, IndexT* output, SizeT& numVisible)
+{
+    const scalar dist[4] = { visibleDist.x(), visibleDist.y(), visibleDist.z(), visibleDist.w() };
+    IndexT lane;
+    for (lane = 0; lane < 4; lane++)
     {
-        if (observerBox != 0)
+        IndexT entityIndex = groupIndex + lane;
+        if ((entityIndex >= firstIndex) && (entityIndex < endIndex) &&
+            (dist[lane] >= 0.0f) && (0 != ((1 << types[entityIndex]) & entityTypeMask)))
         {
-            clipStatus = observerBox->clipstatus(node->GetBoundingBox());
+            output[numVisible++] = entityIndex;
         }
-        else if (observerFrustum != 0)
-        {               
-            clipStatus = node->GetBoundingBox().clipstatus(*observerFrustum);
-        }       
-        else
-        {
-            clipStatus = ClipStatus::Inside;
-        }        
     }
+}
 
-    // proceed depending on clip status of cell against observer context
-    if (ClipStatus::Outside == clipStatus)
-    {
-        // cell isn't visible by observer context
-        return;
-    }
-    else if (ClipStatus::Inside == clipStatus)
+//------------------------------------------------------------------------------
+/**
+    Append all entities of a range which match the entity type mask.
+*/
+void
+EmitEntityRange(const VisibilityJobEntities& entities, IndexT firstIndex, SizeT num, uint entityTypeMask, IndexT* output, SizeT& numVisible)
+{
+    IndexT endIndex = firstIndex + num;
+    IndexT i;
+    for (i = firstIndex; i < endIndex; i++)
     {
-        // cell is fully visible by observer context, everything inside
-        // the cell is fully visible as well        
-        SizeT numEntitiesInCell = node->GetElement().numEntitiesInCell;
-        IndexT entityInfoIdx = node->GetElement().entityInfoStartIndex;
-        IndexT i;
-        for (i = 0; i < numEntitiesInCell; ++i)
+        if (0 != ((1 << entities.types[i]) & entityTypeMask))
         {
-            if (0 != ((1<<entityInfos[entityInfoIdx].entityType) & entityTypeMask))
-            {
-                visEntities[*numEntitiesVisible] = entityInfos[entityInfoIdx].entityPtr;                	                
-                (*numEntitiesVisible)++;
-            }             
-            n_assert(entityInfoIdx < numEntityInfos);       
-            entityInfoIdx++;
-        }    
+            output[numVisible++] = i;
+        }
     }
-    else
+}
+
+//------------------------------------------------------------------------------
+/**
+    Test a range of entity boxes against the frustum planes, 4 boxes at a time.
+*/
+void
+CullEntityRangeFrustum(const VisibilityJobEntities& entities, IndexT firstIndex, SizeT num, const VisibilityJobFrustum& frustum, uint entityTypeMask, IndexT* output, SizeT& numVisible)
+{
+    const SizeT groupSize = VisibilityQuadtree::EntityGroupSize;
+    IndexT endIndex = firstIndex + num;
+    IndexT groupIndex;
+    for (groupIndex = firstIndex & ~(groupSize - 1); groupIndex < endIndex; groupIndex += groupSize)
     {
-        // cell is partially visible, must check visibility of each contained context        
-        SizeT numEntitiesInCell = node->GetElement().numEntitiesInCell;
-        IndexT entityInfoIdx = node->GetElement().entityInfoStartIndex;
-        IndexT index;                
-        for (index = 0; index < numEntitiesInCell; index++)
-        {
-            bbox& entityBox = entityInfos[entityInfoIdx].entityBox;  
-            ClipStatus::Type entityClipStatus;
-            if (observerBox != 0)
-            {
-                entityClipStatus = observerBox->clipstatus(entityBox);
-            }
-            else if (observerFrustum != 0)
-            {                           
-                entityClipStatus = entityBox.clipstatus(*observerFrustum);
-            }
-            else
-            {
-                clipStatus = ClipStatus::Inside;
-            }
-            if (entityClipStatus != ClipStatus::Outside)
-            {   
-                if (0 != ((1<<entityInfos[entityInfoIdx].entityType) & entityTypeMask))
-                {
-                    visEntities[*numEntitiesVisible] = entityInfos[entityInfoIdx].entityPtr; 
-                    (*numEntitiesVisible)++;
-                }                           
-            }
-            // increment info index    
-            n_assert(entityInfoIdx < numEntityInfos);
-            entityInfoIdx++;      
-        }
+        float4 dist = VisibilityJobUtilFrustumDistance(entities, groupIndex, frustum);
+        EmitVisibleLanes(dist, groupIndex, firstIndex, endIndex, entities.types, entityTypeMask, output, numVisible);
     }
-    
-    // recurse into child cells (if this cell is fully or partially visible)
-    IndexT childIndex;
-    // quadtree has always 0 or 4 children
-    const SizeT numChildren = node->GetChildAt(0) != 0 ? 4 : 0;
-    for (childIndex = 0; childIndex < numChildren; childIndex++)
+}
+
+//------------------------------------------------------------------------------
+/**
+    Test a range of entity boxes against the observer box, 4 boxes at a time.
+*/
+void
+CullEntityRangeBox(const VisibilityJobEntities& entities, IndexT firstIndex, SizeT num, const VisibilityJobBox& box, uint entityTypeMask, IndexT* output, SizeT& numVisible)
+{
+    const SizeT groupSize = VisibilityQuadtree::EntityGroupSize;
+    IndexT endIndex = firstIndex + num;
+    IndexT groupIndex;
+    for (groupIndex = firstIndex & ~(groupSize - 1); groupIndex < endIndex; groupIndex += groupSize)
     {
-        // jump to child cell        
-        CheckCell(node->GetChildAt(childIndex), entityInfos, numEntityInfos, observerBox, observerFrustum, visEntities, numEntitiesVisible, entityTypeMask, clipStatus);        
+        float4 dist = VisibilityJobUtilBoxDistance(entities, groupIndex, box);
+        EmitVisibleLanes(dist, groupIndex, firstIndex, endIndex, entities.types, entityTypeMask, output, numVisible);
     }
 }
 
@@ -130,40 +92,89 @@ CheckCell(QuadTree<VisibilityQuadtree::CellInfo>::Node* node,
 void
 VisibilityQuadtreeJobFunc(const JobFuncContext& ctx)
 {
-    QuadTree<VisibilityQuadtree::CellInfo>::Node* rootNode = (QuadTree<VisibilityQuadtree::CellInfo>::Node*)ctx.uniforms[0];    
-    VisibilityQuadtree::EntityInfo* entityInfos = (VisibilityQuadtree::EntityInfo*)ctx.uniforms[1];
-    SizeT numEntityInfos = ctx.uniformSizes[1] / sizeof(VisibilityQuadtree::EntityInfo);
-    // FIXME: array elements ptr points to extra memory address
-    Ptr<VisibilityContext>* output = (Ptr<VisibilityContext>*)ctx.outputs[0];
-    SizeT numEntitiesVisible = 0;
+    const VisibilityQuadtree::CellInfo* cells = (const VisibilityQuadtree::CellInfo*)ctx.uniforms[0];
+    SizeT numCells = ctx.uniformSizes[0] / sizeof(VisibilityQuadtree::CellInfo);
+    VisibilityJobEntities entities;
+    VisibilityJobUtilSetupEntities(ctx.uniforms[1], ctx.uniformSizes[1], entities);
+
+    IndexT* output = (IndexT*)ctx.outputs[0];
+    SizeT& numVisible = *(SizeT*)ctx.outputs[1];
+    numVisible = 0;
+
     ObserverContext::ObserverCullingType type = (ObserverContext::ObserverCullingType)*(uint*)ctx.inputs[0];
     uint entityTypeMask = *(uint*)ctx.inputs[1];
-    uint curCellIndex = 0;
-    uint curEntitiesIndex = 0;
-    switch (type)
+    if (ObserverContext::SeeAll == type)
+    {
+        // just copy all entities to output
+        EmitEntityRange(entities, 0, cells[0].numEntitiesInHierarchy, entityTypeMask, output, numVisible);
+        return;
+    }
+
+    VisibilityJobFrustum frustum;
+    VisibilityJobBox box;
+    const bbox* observerBox = 0;
+    if (ObserverContext::BoundingBox == type)
+    {
+        observerBox = (const bbox*)ctx.inputs[2];
+        VisibilityJobUtilSetupBox(*observerBox, box);
+    }
+    else
     {
-    case ObserverContext::BoundingBox:
+        VisibilityJobUtilSetupFrustum(*(const matrix44*)ctx.inputs[2], frustum);
+    }
+
+    // walk the depth-first cell array, a cell which is fully inside or
+    // outside skips its whole subtree
+    IndexT cellIndex = 0;
+    while (cellIndex < numCells)
+    {
+        const VisibilityQuadtree::CellInfo& cell = cells[cellIndex];
+        if (0 == cell.numEntitiesInHierarchy)
+        {
+            cellIndex = cell.skipIndex;
+            continue;
+        }
+
+        ClipStatus::Type clipStatus;
+        if (0 != observerBox)
         {
-            bbox* observerBox = (bbox*)ctx.inputs[2];
-            // go thru all boxes and compute clipspace
-            CheckCell(rootNode, entityInfos, numEntityInfos, observerBox, 0, output, &numEntitiesVisible, entityTypeMask, ClipStatus::Invalid);
-        }           
-        break;
-    case ObserverContext::ProjectionMatrix:
+            clipStatus = observerBox->clipstatus(cell.box);
+        }
+        else
         {
-            matrix44* observerFrustum = (matrix44*)ctx.inputs[2]; 
-            CheckCell(rootNode, entityInfos, numEntityInfos, 0, observerFrustum, output, &numEntitiesVisible, entityTypeMask, ClipStatus::Invalid);
-        }           
-        break;
-    case ObserverContext::SeeAll:
-        // just copy all entities to output
-        {    
-            CheckCell(rootNode, entityInfos, numEntityInfos, 0, 0, output, &numEntitiesVisible, entityTypeMask, ClipStatus::Invalid); 
+            clipStatus = VisibilityJobUtilCellClipStatus(cell.box, frustum);
+        }
+
+        if (ClipStatus::Outside == clipStatus)
+        {
+            // cell isn't visible by observer context
+            cellIndex = cell.skipIndex;
+        }
+        else if (ClipStatus::Inside == clipStatus)
+        {
+            // cell is fully visible, everything in the subtree is visible as well
+            EmitEntityRange(entities, cell.firstEntityIndex, cell.numEntitiesInHierarchy, entityTypeMask, output, numVisible);
+            cellIndex = cell.skipIndex;
+        }
+        else
+        {
+            // cell is partially visible, check the entities of the cell and
+            // continue with the first child cell
+            if (cell.numEntitiesInCell > 0)
+            {
+                if (0 != observerBox)
+                {
+                    CullEntityRangeBox(entities, cell.firstEntityIndex, cell.numEntitiesInCell, box, entityTypeMask, output, numVisible);
+                }
+                else
+                {
+                    CullEntityRangeFrustum(entities, cell.firstEntityIndex, cell.numEntitiesInCell, frustum, entityTypeMask, output, numVisible);
+                }
+            }
+            cellIndex++;
         }
-        break;
     }
 }
 
 } // namespace Visibility
 __ImplementSpursJob(Visibility::VisibilityQuadtreeJobFunc);
-
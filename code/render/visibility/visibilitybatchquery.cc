@@ -0,0 +1,138 @@
+//------------------------------------------------------------------------------
+//  visibilitybatchquery.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "visibility/visibilitybatchquery.h"
+#include "visibility/observercontext.h"
+
+namespace Visibility
+{
+__ImplementClass(Visibility::VisibilityBatchQuery, 'VIBQ', Core::RefCounted);
+
+using namespace Util;
+using namespace Math;
+using namespace Jobs;
+using namespace InternalGraphics;
+
+//------------------------------------------------------------------------------
+/**
+*/
+VisibilityBatchQuery::VisibilityBatchQuery()
+{
+    this->jobPort = JobPort::Create();
+    this->jobPort->Setup();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+VisibilityBatchQuery::~VisibilityBatchQuery()
+{
+    this->jobPort = 0;
+    this->observers.Clear();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void 
+VisibilityBatchQuery::AttachVisibilitySystem(const Ptr<VisibilitySystemBase>& visSystem)
+{
+    n_assert(visSystem->SupportsBatchQueries());
+    this->visibilitySystems.Append(visSystem);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void 
+VisibilityBatchQuery::AddObserver(const Ptr<InternalGraphicsEntity>& observer, uint entityMask)
+{
+    n_assert(this->observers.Size() < VisibilityBatchResult::MaxNumObservers);
+    IndexT observerIndex = this->observers.Size();
+    this->observers.Append(observer);
+
+    // convert to the plain observer description used by the jobs
+    Ptr<ObserverContext> observerContext = ObserverContext::Create();
+    observerContext->Setup(observer);
+    VisibilityBatchResult::ObserverInfo& info = this->result.observers[observerIndex];
+    info.type = observerContext->GetType();
+    info.entityMask = entityMask;
+    switch (observerContext->GetType())
+    {
+    case ObserverContext::BoundingBox:
+        info.boundingBox = observerContext->GetBoundingBox();
+        break;
+    case ObserverContext::ProjectionMatrix:
+        info.projectionView = observerContext->GetProjectionMatrix();
+        break;
+    default:
+        // nothing to do sees all
+        break;
+    }
+    this->result.numObservers = this->observers.Size();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void 
+VisibilityBatchQuery::Run(IndexT frameId)
+{
+    n_assert(this->observers.Size() > 0);
+
+    // the first visibility system sets up the entity table of the result
+    this->result.contexts = 0;
+    this->result.numContexts = 0;
+
+    Util::Array<Ptr<Job> > jobs;
+    IndexT i;
+    for (i = 0; i < this->visibilitySystems.Size(); ++i)
+    {   
+        Ptr<Job> newJob = this->visibilitySystems[i]->CreateBatchVisibilityJob(frameId, this->result);
+        if (newJob.isvalid())
+        {
+            jobs.Append(newJob);        
+        }  
+    }
+    // visibility systems are dependent on results of previous visibility system
+    if (jobs.Size() > 0)
+    {
+        this->jobPort->PushJobChain(jobs);
+        this->jobPort->WaitDone();
+    }
+}  
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool 
+VisibilityBatchQuery::IsFinished() const
+{
+    return this->jobPort->CheckDone();
+}
+    
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+VisibilityBatchQuery::WaitForFinished() const
+{
+    this->jobPort->WaitDone();
+    return true;
+}    
+
+//------------------------------------------------------------------------------
+/**
+*/
+InternalGraphicsEntity::LinkType 
+VisibilityBatchQuery::GetObserverType(IndexT i) const
+{       
+    if (this->observers[i]->GetType() == InternalGraphicsEntityType::Light)
+    {
+        return InternalGraphicsEntity::LightLink;
+    }
+    return InternalGraphicsEntity::CameraLink;
+}
+} // namespace Visibility
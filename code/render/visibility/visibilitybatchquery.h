@@ -0,0 +1,83 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Visibility::VisibilityBatchQuery
+
+    A VisibilityBatchQuery culls up to 32 observers at once. The attached 
+    visibility systems must support batched queries, the result is one
+    observer bit mask per entity.
+           
+    (C) 2010 Radon Labs GmbH
+*/
+#include "core/refcounted.h"
+#include "internalgraphics/internalgraphicsentity.h"
+#include "visibility/visibilitysystems/visibilitysystembase.h"
+#include "visibility/visibilityresult.h"
+#include "jobs/jobport.h"
+              
+//------------------------------------------------------------------------------
+namespace Visibility
+{   
+class VisibilityBatchQuery : public Core::RefCounted
+{
+    __DeclareClass(VisibilityBatchQuery);
+public:
+    /// constructor
+    VisibilityBatchQuery();
+    /// destructor
+    virtual ~VisibilityBatchQuery();
+    /// attach visible system, used by this job
+    void AttachVisibilitySystem(const Ptr<VisibilitySystemBase>& visSystem); 
+    /// add an observer with the entity types it is interested in
+    void AddObserver(const Ptr<InternalGraphics::InternalGraphicsEntity>& observer, uint entityMask);
+    /// get number of observers
+    SizeT GetNumObservers() const;
+    /// get observer at index
+    const Ptr<InternalGraphics::InternalGraphicsEntity>& GetObserver(IndexT i) const;
+    /// get observer link type at index
+    InternalGraphics::InternalGraphicsEntity::LinkType GetObserverType(IndexT i) const;
+    /// run job
+    void Run(IndexT frameId);
+    /// is finished
+    bool IsFinished() const;
+    /// wait for finished
+    bool WaitForFinished() const;
+    /// get visibility result
+    const VisibilityBatchResult& GetVisibilityResult() const;
+              
+private:  
+    Util::Array<Ptr<InternalGraphics::InternalGraphicsEntity> > observers;
+    VisibilityBatchResult result;
+    Util::Array<Ptr<VisibilitySystemBase> > visibilitySystems;       
+    Ptr<Jobs::JobPort> jobPort;
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline SizeT
+VisibilityBatchQuery::GetNumObservers() const
+{
+    return this->observers.Size();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const Ptr<InternalGraphics::InternalGraphicsEntity>& 
+VisibilityBatchQuery::GetObserver(IndexT i) const
+{
+    return this->observers[i];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const VisibilityBatchResult& 
+VisibilityBatchQuery::GetVisibilityResult() const
+{
+    n_assert(this->IsFinished());    
+    return this->result;
+}
+} // namespace Visibility
+//------------------------------------------------------------------------------
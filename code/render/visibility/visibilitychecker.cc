@@ -13,16 +13,20 @@ using namespace Math;
 using namespace InternalGraphics;
 
 #define NUM_JOBS_PERFRAME 64
+#define NUM_BATCHJOBS_PERFRAME 16
 //------------------------------------------------------------------------------
 /**
 */
 VisibilityChecker::VisibilityChecker():
     isOpen(false),
     lastFrameId(0),
-    numQueriesThisFrame(0)
+    numQueriesThisFrame(0),
+    numBatchQueriesThisFrame(0)
 { 
     this->visiblityQueries[0].SetSize(NUM_JOBS_PERFRAME);   
     this->visiblityQueries[1].SetSize(NUM_JOBS_PERFRAME);
+    this->visibilityBatchQueries[0].SetSize(NUM_BATCHJOBS_PERFRAME);   
+    this->visibilityBatchQueries[1].SetSize(NUM_BATCHJOBS_PERFRAME);
 }
 
 //------------------------------------------------------------------------------
@@ -39,12 +43,12 @@ VisibilityChecker::~VisibilityChecker()
 void 
 VisibilityChecker::RegisterEntity(const Ptr<InternalGraphics::InternalGraphicsEntity>& entity)
 {
-    n_assert(!this->registeredEntities.Contains(entity));
+    n_assert(!this->registeredEntities.IsValid(entity->visibilityHandle));
 
     // create one new entity context for this graphicsentity
     Ptr<VisibilityContext> entityVis = VisibilityContext::Create();
     entityVis->Setup(entity);
-    this->registeredEntities.Add(entity, entityVis);
+    entity->visibilityHandle = this->registeredEntities.Add(entityVis);
 
     // insert in each attached visibility system
     IndexT i;
@@ -60,15 +64,17 @@ VisibilityChecker::RegisterEntity(const Ptr<InternalGraphics::InternalGraphicsEn
 void 
 VisibilityChecker::UnregisterEntity(const Ptr<InternalGraphics::InternalGraphicsEntity>& entity)
 {
-    n_assert(this->registeredEntities.Contains(entity));
+    n_assert(this->registeredEntities.IsValid(entity->visibilityHandle));
 
+    const Ptr<VisibilityContext>& entityVis = this->registeredEntities[entity->visibilityHandle];
     IndexT i;
     for (i = 0; i < this->visibilitySystems.Size(); ++i)
     {
-        this->visibilitySystems[i]->RemoveVisibilityContext(this->registeredEntities[entity]);
+        this->visibilitySystems[i]->RemoveVisibilityContext(entityVis);
     }
 
-    this->registeredEntities.Erase(entity);
+    this->registeredEntities.Erase(entity->visibilityHandle);
+    entity->visibilityHandle = SlotMap<Ptr<VisibilityContext> >::InvalidHandle;
 }
 
 //------------------------------------------------------------------------------
@@ -98,9 +104,9 @@ VisibilityChecker::RemoveVisibilitySystem(const Ptr<VisibilitySystemBase>& syste
 void 
 VisibilityChecker::UpdateVisibilityContext(const Ptr<InternalGraphics::InternalGraphicsEntity>& entity)
 {         
-    n_assert(this->registeredEntities.Contains(entity.get()));
+    n_assert(this->registeredEntities.IsValid(entity->visibilityHandle));
 
-    const Ptr<VisibilityContext>& entityVis = this->registeredEntities[entity.get()];
+    const Ptr<VisibilityContext>& entityVis = this->registeredEntities[entity->visibilityHandle];
     entityVis->UpdateBoundingBox(entity->GetGlobalBoundingBox());
     IndexT i;
     for (i = 0; i < this->visibilitySystems.Size(); ++i)
@@ -116,10 +122,7 @@ void
 VisibilityChecker::PerformVisibilityQuery(IndexT frameId, const Ptr<InternalGraphics::InternalGraphicsEntity>& observerEntity, uint entityMask)
 {      
     IndexT bufferIndex = frameId % 2;
-    if (this->lastFrameId != frameId)
-    {
-        this->numQueriesThisFrame = 0;         
-    }
+    this->UpdateFrameId(frameId);
     IndexT slot = this->numQueriesThisFrame; 
     n_assert(slot < NUM_JOBS_PERFRAME);
     if (!this->visiblityQueries[bufferIndex][slot].isvalid())
@@ -142,13 +145,120 @@ VisibilityChecker::PerformVisibilityQuery(IndexT frameId, const Ptr<InternalGrap
         this->visiblityQueries[bufferIndex][slot]->Run(frameId); 
     }
 
-    this->lastFrameId = frameId;
     this->numQueriesThisFrame++; 
 
     // apply result of last frame
     this->ApplyLastVisibilityResults(frameId, slot);
 }
 
+//------------------------------------------------------------------------------
+/**
+    Check the visibility of a group of observers with one pass over the
+    visibility systems per MaxNumObservers observers. All visibility systems
+    used by any of the observers are attached to the batched query, so
+    this should be used for observers of the same type.
+*/
+void 
+VisibilityChecker::PerformBatchVisibilityQuery(IndexT frameId, const Util::Array<Ptr<InternalGraphicsEntity> >& observerEntities, const Util::Array<uint>& entityMasks)
+{
+    n_assert(observerEntities.Size() == entityMasks.Size());
+    if (observerEntities.IsEmpty())
+    {
+        return;
+    }
+
+    // collect the visibility systems used by any observer, fall back to 
+    // single queries if a system can't handle batched queries
+    uint observerMask = 0;
+    IndexT observerIdx;
+    for (observerIdx = 0; observerIdx < observerEntities.Size(); ++observerIdx)
+    {
+        observerMask |= 1 << observerEntities[observerIdx]->GetType();
+    }
+    Util::Array<Ptr<VisibilitySystemBase>, Util::ArrayFrameAllocator> systems;
+    bool batchSupported = true;
+    IndexT visSystemIdx;
+    for (visSystemIdx = 0; visSystemIdx < this->visibilitySystems.Size(); ++visSystemIdx)
+    {
+        const Ptr<VisibilitySystemBase>& visSystem = this->visibilitySystems[visSystemIdx];
+        if (0 != (observerMask & visSystem->GetObserverBitMask()))
+        {
+            batchSupported &= visSystem->SupportsBatchQueries();
+            systems.Append(visSystem);
+        }
+    }
+    if (!batchSupported || (1 == observerEntities.Size()))
+    {
+        for (observerIdx = 0; observerIdx < observerEntities.Size(); ++observerIdx)
+        {
+            this->PerformVisibilityQuery(frameId, observerEntities[observerIdx], entityMasks[observerIdx]);
+        }
+        return;
+    }
+
+    IndexT bufferIndex = frameId % 2;
+    this->UpdateFrameId(frameId);
+    for (observerIdx = 0; observerIdx < observerEntities.Size(); observerIdx += VisibilityBatchResult::MaxNumObservers)
+    {
+        IndexT slot = this->numBatchQueriesThisFrame; 
+        n_assert(slot < NUM_BATCHJOBS_PERFRAME);
+        Ptr<VisibilityBatchQuery>& query = this->visibilityBatchQueries[bufferIndex][slot];
+        if (!query.isvalid())
+        {
+            // create and start new batched visibility job   
+            query = VisibilityBatchQuery::Create();
+            for (visSystemIdx = 0; visSystemIdx < systems.Size(); ++visSystemIdx)
+            {
+                query->AttachVisibilitySystem(systems[visSystemIdx]);
+            }
+            IndexT endIdx = n_min(observerIdx + VisibilityBatchResult::MaxNumObservers, observerEntities.Size());
+            IndexT i;
+            for (i = observerIdx; i < endIdx; ++i)
+            {
+                query->AddObserver(observerEntities[i], entityMasks[i]);
+            }
+            query->Run(frameId);
+        }
+        this->numBatchQueriesThisFrame++;
+
+        // apply result of last frame
+        this->ApplyLastBatchVisibilityResults(frameId, slot);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void 
+VisibilityChecker::UpdateFrameId(IndexT frameId)
+{
+    if (this->lastFrameId != frameId)
+    {
+        this->numQueriesThisFrame = 0;         
+        this->numBatchQueriesThisFrame = 0;         
+        this->lastFrameId = frameId;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void 
+VisibilityChecker::LinkVisibleEntity(IndexT frameId, const Ptr<InternalGraphicsEntity>& observer, InternalGraphicsEntity::LinkType linkType, const Ptr<InternalGraphicsEntity>& gfxEntity)
+{
+    if (gfxEntity.isvalid() 
+        && gfxEntity->IsValid() 
+        && gfxEntity->IsActive())
+    {
+        gfxEntity->AddLink(linkType, observer);
+        observer->AddLink(linkType, gfxEntity);
+        if (linkType == InternalGraphicsEntity::CameraLink)
+        {    
+            gfxEntity->OnNotifyCullingVisible(observer, frameId);
+        }
+    } 
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -173,29 +283,60 @@ VisibilityChecker::ApplyLastVisibilityResults(IndexT frameId, IndexT slot)
             observer->ClearLinks(linkType);
 
             // link visible entities with observer
-            const Util::FixedArray<Ptr<VisibilityContext> >& visEntities = this->visiblityQueries[bufferIndex][slot]->GetVisibleEntities();
+            const VisibilityResult& result = this->visiblityQueries[bufferIndex][slot]->GetVisibilityResult();
             IndexT entityIdx;
-            for (entityIdx = 0; entityIdx < visEntities.Size(); ++entityIdx)
+            for (entityIdx = 0; entityIdx < result.numVisible; ++entityIdx)
             {
-                if (visEntities[entityIdx].isvalid())
-                {  
-                    const Ptr<InternalGraphicsEntity>& gfxEntity = visEntities[entityIdx]->GetGfxEntity();
-                    if (gfxEntity.isvalid() 
-                        && gfxEntity->IsValid() 
-                        && gfxEntity->IsActive())
+                this->LinkVisibleEntity(frameId, observer, linkType, result.GetVisibleContext(entityIdx)->GetGfxEntity());
+            }
+
+            // clear job in array
+            this->visiblityQueries[bufferIndex][slot] = 0; 
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void 
+VisibilityChecker::ApplyLastBatchVisibilityResults(IndexT frameId, IndexT slot)
+{   
+    IndexT bufferIndex = (frameId + 1) % 2;   
+    const Ptr<VisibilityBatchQuery>& query = this->visibilityBatchQueries[bufferIndex][slot];
+    if (query.isvalid())
+    {
+        if (query->IsFinished() || query->WaitForFinished()) 
+        {    
+            // clear old links for all observers
+            SizeT numObservers = query->GetNumObservers();
+            IndexT observerIdx;
+            for (observerIdx = 0; observerIdx < numObservers; ++observerIdx)
+            {
+                query->GetObserver(observerIdx)->ClearLinks(query->GetObserverType(observerIdx));
+            }
+
+            // link visible entities with their observers
+            const VisibilityBatchResult& result = query->GetVisibilityResult();
+            IndexT entityIdx;
+            for (entityIdx = 0; entityIdx < result.numContexts; ++entityIdx)
+            {
+                uint observerBits = result.observerMasks[entityIdx];
+                if (0 != observerBits)
+                {
+                    const Ptr<InternalGraphicsEntity>& gfxEntity = result.contexts[entityIdx]->GetGfxEntity();
+                    for (observerIdx = 0; observerIdx < numObservers; ++observerIdx)
                     {
-                        gfxEntity->AddLink(linkType, observer);
-                        observer->AddLink(linkType, gfxEntity);
-                        if (linkType == InternalGraphicsEntity::CameraLink)
-                        {    
-                            gfxEntity->OnNotifyCullingVisible(observer, frameId);
+                        if (0 != (observerBits & (1 << observerIdx)))
+                        {
+                            this->LinkVisibleEntity(frameId, query->GetObserver(observerIdx), query->GetObserverType(observerIdx), gfxEntity);
                         }
-                    } 
+                    }
                 }
             }
 
             // clear job in array
-            this->visiblityQueries[bufferIndex][slot] = 0; 
+            this->visibilityBatchQueries[bufferIndex][slot] = 0; 
         }
     }
 }
@@ -282,15 +423,15 @@ VisibilityChecker::AttachVisibilityContainer(const Ptr<VisibilityContainer>& con
         {           
             // create one new entity context for this graphicsentity
             Ptr<VisibilityContext> entityVis;
-            if (!this->registeredEntities.Contains(entities[i]))
+            if (!this->registeredEntities.IsValid(entities[i]->visibilityHandle))
             {
                 entityVis = VisibilityContext::Create();
                 entityVis->Setup(entities[i]);
-                this->registeredEntities.Add(entities[i], entityVis);	
+                entities[i]->visibilityHandle = this->registeredEntities.Add(entityVis);	
             }
             else
             {
-                entityVis = this->registeredEntities[entities[i]];
+                entityVis = this->registeredEntities[entities[i]->visibilityHandle];
             }
             contexts.Append(entityVis);
         }
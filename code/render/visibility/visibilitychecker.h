@@ -11,6 +11,11 @@
     If the stage wants to check the visibility it just calls PerformVisibilityQuery
     which starts a new visibility check with the given observer entity and applies 
     the result of the last frame check.
+
+    PerformBatchVisibilityQuery checks a group of observers (for instance all
+    visible lights) in a single pass over the visibility systems, if all
+    involved visibility systems support batched queries. Otherwise it falls
+    back to one query per observer.
        
     (C) 2010 Radon Labs GmbH
 */
@@ -19,7 +24,8 @@
 #include "visibility/visibilitycontext.h"
 #include "visibility/visibilitysystems/visibilitysystembase.h"
 #include "visibility/visibilityquery.h"
-#include "visibility/visibilitycontext.h"
+#include "visibility/visibilitybatchquery.h"
+#include "util/slotmap.h"
               
 //------------------------------------------------------------------------------
 namespace Visibility
@@ -63,6 +69,8 @@ public:
     
     /// check visibility with given view projection transform, will build links in entities
     void PerformVisibilityQuery(IndexT frameId, const Ptr<InternalGraphics::InternalGraphicsEntity>& observerEntity, uint entityMask);
+    /// check visibility for multiple observers at once, will build links in entities
+    void PerformBatchVisibilityQuery(IndexT frameId, const Util::Array<Ptr<InternalGraphics::InternalGraphicsEntity> >& observerEntities, const Util::Array<uint>& entityMasks);
           
     /// clear visibility links
     void ClearVisibilityLinks(InternalGraphics::InternalGraphicsEntity::LinkType linkType);
@@ -73,13 +81,21 @@ public:
 private:       
     /// apply visibility results of last visibility request 
     void ApplyLastVisibilityResults(IndexT frameId, IndexT slot);
+    /// apply visibility results of last batched visibility request 
+    void ApplyLastBatchVisibilityResults(IndexT frameId, IndexT slot);
+    /// reset the per frame query counters on a new frame
+    void UpdateFrameId(IndexT frameId);
+    /// link a visible entity with an observer
+    void LinkVisibleEntity(IndexT frameId, const Ptr<InternalGraphics::InternalGraphicsEntity>& observer, InternalGraphics::InternalGraphicsEntity::LinkType linkType, const Ptr<InternalGraphics::InternalGraphicsEntity>& gfxEntity);
 
     bool isOpen;
     IndexT lastFrameId;
     SizeT numQueriesThisFrame;
+    SizeT numBatchQueriesThisFrame;
     Util::Array<Ptr<VisibilitySystemBase> > visibilitySystems;    
     Util::FixedArray<Ptr<VisibilityQuery> > visiblityQueries[2];
-    Util::Dictionary<Ptr<InternalGraphics::InternalGraphicsEntity>, Ptr<VisibilityContext> > registeredEntities;
+    Util::FixedArray<Ptr<VisibilityBatchQuery> > visibilityBatchQueries[2];
+    Util::SlotMap<Ptr<VisibilityContext> > registeredEntities;     // handles are stored in the graphics entities
     Ptr<VisibilityContext> observerContext;
 };
 
@@ -50,9 +50,10 @@ VisibilityQuery::AttachVisibilitySystem(const Ptr<VisibilitySystemBase>& visSyst
 void 
 VisibilityQuery::Run(IndexT frameId)
 {
-    // not necessary, job will be destroyed after results are applied          
-    this->visibleEntities.SetSize(InternalGraphicsServer::Instance()->GetEntities().Size());     
-    this->visibleEntities.Fill(0);
+    // the first visibility system sets up the entity table of the result
+    this->result.contexts = 0;
+    this->result.numContexts = 0;
+    this->result.numVisible = 0;
     
     // TODO: create worker thread which goes thru all vis systems
     this->observerContext = ObserverContext::Create();
@@ -66,7 +67,7 @@ VisibilityQuery::Run(IndexT frameId)
         const Ptr<VisibilitySystemBase>& visSystem = this->visibilitySystems[i];
         Ptr<Job> newJob = visSystem->CreateVisibilityJob(frameId, 
                                                          this->observerContext, 
-                                                         this->visibleEntities, 
+                                                         this->result, 
                                                          this->entityMask);
         // for non multi-threaded 
         if (newJob.isvalid())
@@ -77,8 +78,11 @@ VisibilityQuery::Run(IndexT frameId)
         //
     }
     // visibility systems are dependent on results of previous visibility system
-    this->jobPort->PushJobChain(jobs);
-    this->jobPort->WaitDone();
+    if (jobs.Size() > 0)
+    {
+        this->jobPort->PushJobChain(jobs);
+        this->jobPort->WaitDone();
+    }
 }  
 
 //------------------------------------------------------------------------------
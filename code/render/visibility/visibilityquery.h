@@ -11,6 +11,7 @@
 #include "core/refcounted.h"
 #include "internalgraphics/internalgraphicsentity.h"
 #include "visibility/visibilitysystems/visibilitysystembase.h"
+#include "visibility/visibilityresult.h"
 #include "jobs/jobport.h"
               
 //------------------------------------------------------------------------------
@@ -38,15 +39,15 @@ public:
     bool WaitForFinished() const;
     /// get observer link type
     InternalGraphics::InternalGraphicsEntity::LinkType GetObserverType();
-    /// get visible entities   
-    const Util::FixedArray<Ptr<VisibilityContext> >& GetVisibleEntities() const;
+    /// get visibility result
+    const VisibilityResult& GetVisibilityResult() const;
     /// set entity mask
     void SetEntityMask(uint mask);
               
 private:  
     Ptr<InternalGraphics::InternalGraphicsEntity> observer; 
     Ptr<ObserverContext> observerContext;
-    Util::FixedArray<Ptr<VisibilityContext> > visibleEntities;
+    VisibilityResult result;
     Util::Array<Ptr<VisibilitySystemBase> > visibilitySystems;       
     uint entityMask;
     Ptr<Jobs::JobPort> jobPort;
@@ -55,11 +56,11 @@ private:
 //------------------------------------------------------------------------------
 /**
 */
-inline const Util::FixedArray<Ptr<VisibilityContext> >& 
-VisibilityQuery::GetVisibleEntities() const
+inline const VisibilityResult& 
+VisibilityQuery::GetVisibilityResult() const
 {
     n_assert(this->IsFinished());    
-    return this->visibleEntities;
+    return this->result;
 }
 
 //------------------------------------------------------------------------------
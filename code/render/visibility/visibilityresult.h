@@ -0,0 +1,141 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Visibility::VisibilityResult
+
+    The result of a visibility query. The first visibility system
+    (the VisibilityQuadtree) provides a snapshot of its entities as
+    a flat context table and writes the indices of all visible entities 
+    into a compact index list. Following visibility systems only
+    remove indices from the list.
+
+    The VisibilityBatchResult is the result of a batched query for up
+    to 32 observers. It stores one observer bit mask per entity of the
+    context table.
+           
+    (C) 2010 Radon Labs GmbH
+*/
+#include "util/fixedarray.h"
+#include "math/matrix44.h"
+#include "math/bbox.h"
+#include "visibility/visibilitycontext.h"
+              
+//------------------------------------------------------------------------------
+namespace Visibility
+{   
+struct VisibilityResult
+{
+    /// constructor
+    VisibilityResult();
+    /// reset the result, makes sure the index list can hold numEntities indices
+    void Reset(SizeT numEntities);
+    /// get visible context by index into the index list
+    const Ptr<VisibilityContext>& GetVisibleContext(IndexT i) const;
+
+    const Ptr<VisibilityContext>* contexts;     // entity table of the producing visibility system
+    SizeT numContexts;                          // number of entries in the entity table
+    Util::FixedArray<IndexT> indices;           // indices of the visible entities into the entity table
+    SizeT numVisible;                           // number of valid entries in the index list
+};
+
+struct VisibilityBatchResult
+{
+    /// max number of observers in a batched query
+    static const SizeT MaxNumObservers = 32;
+
+    /// observer description used by the batched visibility jobs
+    struct ObserverInfo
+    {
+        Math::matrix44 projectionView;
+        Math::bbox boundingBox;
+        uint type;                              // ObserverContext::ObserverCullingType
+        uint entityMask;                        // entity types the observer is interested in
+    };
+
+    /// constructor
+    VisibilityBatchResult();
+    /// reset the result, makes sure the observer masks can hold numEntities masks
+    void Reset(SizeT numEntities);
+    /// return true if an entity of the context table is visible by an observer
+    bool IsVisible(IndexT entityIndex, IndexT observerIndex) const;
+
+    Util::FixedArray<ObserverInfo> observers;   // observers of the query
+    SizeT numObservers;                         // number of valid observers
+    const Ptr<VisibilityContext>* contexts;     // entity table of the producing visibility system
+    SizeT numContexts;                          // number of entries in the entity table
+    Util::FixedArray<uint> observerMasks;       // per entity, bit n is set if visible by observer n
+};
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline
+VisibilityResult::VisibilityResult() :
+    contexts(0),
+    numContexts(0),
+    numVisible(0)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+VisibilityResult::Reset(SizeT numEntities)
+{
+    if (this->indices.Size() < numEntities)
+    {
+        this->indices.SetSize(numEntities);
+    }
+    this->numVisible = 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline const Ptr<VisibilityContext>&
+VisibilityResult::GetVisibleContext(IndexT i) const
+{
+    n_assert(i < this->numVisible);
+    n_assert(this->indices[i] < this->numContexts);
+    return this->contexts[this->indices[i]];
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline
+VisibilityBatchResult::VisibilityBatchResult() :
+    numObservers(0),
+    contexts(0),
+    numContexts(0)
+{
+    this->observers.SetSize(MaxNumObservers);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+VisibilityBatchResult::Reset(SizeT numEntities)
+{
+    if (this->observerMasks.Size() < numEntities)
+    {
+        this->observerMasks.SetSize(numEntities);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool
+VisibilityBatchResult::IsVisible(IndexT entityIndex, IndexT observerIndex) const
+{
+    n_assert(entityIndex < this->numContexts);
+    n_assert(observerIndex < this->numObservers);
+    return 0 != (this->observerMasks[entityIndex] & (1 << observerIndex));
+}
+
+} // namespace Visibility
+//------------------------------------------------------------------------------
@@ -350,7 +350,7 @@ VisibilityBoxSystem::EndAttachVisibilityContainer()
     Every generated buffer in this function has to doublebuffered!
 */
 Ptr<Jobs::Job> 
-VisibilityBoxSystem::CreateVisibilityJob(IndexT frameId, const Ptr<ObserverContext>& observer, Util::FixedArray<Ptr<VisibilityContext> >& outEntitiyArray, uint& entityMask)
+VisibilityBoxSystem::CreateVisibilityJob(IndexT frameId, const Ptr<ObserverContext>& observer, VisibilityResult& result, uint& entityMask)
 {               
     // collect all boxes for given entities in double buffer
     IndexT bufferIndex = frameId % 2;
@@ -361,7 +361,7 @@ VisibilityBoxSystem::CreateVisibilityJob(IndexT frameId, const Ptr<ObserverConte
     }
     
     // nothing to do if no entities are visible from rpevoius visibility systems
-    if (this->workData[bufferIndex].flatBoxMapping.Size() == 0) 
+    if ((this->workData[bufferIndex].flatBoxMapping.Size() == 0) || (0 == result.numContexts))
     {
         return 0;
     }
@@ -377,14 +377,18 @@ VisibilityBoxSystem::CreateVisibilityJob(IndexT frameId, const Ptr<ObserverConte
     JobUniformDesc uniformData(this->flatBoxData.Begin(), this->flatBoxData.Size(),  
                                this->flatNeighborList.Begin(), this->flatNeighborList.Size(), 0);  
 
-    // update observer data    
+    // update observer data, the entity table of the result is needed to map
+    // the visible indices to the contexts of the box mapping
+    SizeT contextsSize = result.numContexts * sizeof(Ptr<VisibilityContext>);
     JobDataDesc inputData(&observer->GetPosition(), sizeof(Math::point), sizeof(Math::point), 
-                          &entityMask, sizeof(uint), sizeof(uint), 
+                          (void*)result.contexts, contextsSize, contextsSize, 
                           &observer->GetProjectionMatrix(), sizeof(matrix44), sizeof(matrix44),
                           this->workData[bufferIndex].flatBoxMapping.Begin(), this->workData[bufferIndex].flatBoxMapping.Size(), this->workData[bufferIndex].flatBoxMapping.Size());
     
-    // update output data
-    JobDataDesc outputData(outEntitiyArray.Begin(), outEntitiyArray.Size(), outEntitiyArray.Size());
+    // update output data, the job removes indices from the index list
+    SizeT indicesSize = result.numContexts * sizeof(IndexT);
+    JobDataDesc outputData(result.indices.Begin(), indicesSize, indicesSize,
+                           &result.numVisible, sizeof(SizeT), sizeof(SizeT));
     // setup job with data
     visibilityJob->Setup(uniformData, inputData, outputData, jobFunction);
 
@@ -46,7 +46,7 @@ public:
     virtual void EndAttachVisibilityContainer();  
 
     /// attach visibility job to port
-    virtual Ptr<Jobs::Job> CreateVisibilityJob(IndexT frameId, const Ptr<ObserverContext>& observer, Util::FixedArray<Ptr<VisibilityContext> >& outEntitiyArray, uint& entityMask);
+    virtual Ptr<Jobs::Job> CreateVisibilityJob(IndexT frameId, const Ptr<ObserverContext>& observer, VisibilityResult& result, uint& entityMask);
              
     /// render debug visualizations
     virtual void OnRenderDebug(); 
@@ -90,20 +90,21 @@ VisibilityClusterSystem::UpdateVisibilityContext(const Ptr<VisibilityContext>& c
 /**
 */
 void 
-VisibilityClusterSystem::CheckVisibility(const Ptr<ObserverContext>& observer, Util::FixedArray<Ptr<VisibilityContext> >& outEntitiyArray, uint entityMask)
+VisibilityClusterSystem::CheckVisibility(const Ptr<ObserverContext>& observer, VisibilityResult& result, uint entityMask)
 {        
     // update visibility for this observer
     const point& cameraPos = observer->GetObserverEntity()->GetTransform().get_position();
     this->UpdateVisibilityClusters(cameraPos);
 
     // now go thru visiblecontexts, checked before
-    // cause this vis system comes after other systems, we work on the outEntitiyArray
+    // cause this vis system comes after other systems, we work on the index list
     // and throw out any non visible contexts
     IndexT i;
-    for (i = 0; i < outEntitiyArray.Size(); ++i)
+    for (i = 0; i < result.numVisible; ++i)
     {
         // visible context must not be in any cluster
-        if (!this->visContextBitmask.Contains(outEntitiyArray[i]))
+        const Ptr<VisibilityContext>& context = result.GetVisibleContext(i);
+        if (!this->visContextBitmask.Contains(context))
         {
             continue;
         }
@@ -111,7 +112,7 @@ VisibilityClusterSystem::CheckVisibility(const Ptr<ObserverContext>& observer, U
         // we are invisible, if our cluster bit mask is identical with
         // the visibility bit mask from the visibility server
         bool visible = true;
-        const BitField<64>& visContextBitmask = this->visContextBitmask[outEntitiyArray[i]];
+        const BitField<64>& visContextBitmask = this->visContextBitmask[context];
         if (!visContextBitmask.IsNull())
         {
             const BitField<64>& cameraClusterMask = this->GetVisibilityClusterBitMask();
@@ -130,8 +131,9 @@ VisibilityClusterSystem::CheckVisibility(const Ptr<ObserverContext>& observer, U
         }
         else
         {
-            // cull vis context
-            outEntitiyArray[i] = 0;
+            // cull vis context, order of visible entities doesn't matter
+            result.indices[i] = result.indices[result.numVisible - 1];
+            result.numVisible--;
             --i;
             this->IncrRejectedVisChecks();
         }            
@@ -249,10 +251,10 @@ VisibilityClusterSystem::OnRenderDebug()
 /**
 */
 Ptr<Jobs::Job> 
-VisibilityClusterSystem::CreateVisibilityJob(IndexT frameId, const Ptr<ObserverContext>& observer, Util::FixedArray<Ptr<VisibilityContext> >& outEntitiyArray, uint& entityMask)
+VisibilityClusterSystem::CreateVisibilityJob(IndexT frameId, const Ptr<ObserverContext>& observer, VisibilityResult& result, uint& entityMask)
 {
     // no multi threading yet
-    this->CheckVisibility(observer, outEntitiyArray, entityMask);
+    this->CheckVisibility(observer, result, entityMask);
 
     Ptr<Jobs::Job> visibilityJob;
     return visibilityJob;
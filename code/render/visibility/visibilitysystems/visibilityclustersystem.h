@@ -39,7 +39,7 @@ public:
     /// insert visibility container, bunch of contextes with bunch infos
     virtual void InsertVisibilityContainer(const Ptr<VisibilityContainer>& container);      
     /// attach visibility job to port
-    virtual Ptr<Jobs::Job> CreateVisibilityJob(IndexT frameId, const Ptr<ObserverContext>& observer, Util::FixedArray<Ptr<VisibilityContext> >& outEntitiyArray, uint& entityMask);
+    virtual Ptr<Jobs::Job> CreateVisibilityJob(IndexT frameId, const Ptr<ObserverContext>& observer, VisibilityResult& result, uint& entityMask);
 
      /// render debug visualizations
     virtual void OnRenderDebug(); 
@@ -52,7 +52,7 @@ private:
     /// get the camera cluster bit mask (bits of all clusters where the camera is inside)
     const Util::BitField<64>& GetVisibilityClusterBitMask() const; 
     /// generate visibility links
-    void CheckVisibility(const Ptr<ObserverContext>& observer, Util::FixedArray<Ptr<VisibilityContext> >& outEntitiyArray, uint entityMask);
+    void CheckVisibility(const Ptr<ObserverContext>& observer, VisibilityResult& result, uint entityMask);
       
     /// update visibility status of VisibilityClusters
     void UpdateVisibilityClusters(const Math::point& cameraPos);
@@ -25,16 +25,29 @@ using namespace InternalGraphics;
 extern "C" {
     extern const char _binary_jqjob_render_visibilityquadtreejobfunc_ps3_bin_start[];
     extern const char _binary_jqjob_render_visibilityquadtreejobfunc_ps3_bin_size[];
+    extern const char _binary_jqjob_render_visibilityquadtreebatchjobfunc_ps3_bin_start[];
+    extern const char _binary_jqjob_render_visibilityquadtreebatchjobfunc_ps3_bin_size[];
 }
 #else
 extern void VisibilityQuadtreeJobFunc(const JobFuncContext& ctx);
+extern void VisibilityQuadtreeBatchJobFunc(const JobFuncContext& ctx);
 #endif
 //------------------------------------------------------------------------------
 /**
 */
 VisibilityQuadtree::VisibilityQuadtree():
+    numCellsBuilt(0),
     quadTreeDepth(0)
 {
+    IndexT i;
+    for (i = 0; i < 2; i++)
+    {
+        this->workData[i].workBuffer = 0;
+        this->workData[i].bufferDirty = true;
+        this->workData[i].cellsSize = 0;
+        this->workData[i].entitiesSize = 0;
+        this->workData[i].numEntitiesPadded = 0;
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -42,6 +55,8 @@ VisibilityQuadtree::VisibilityQuadtree():
 */
 VisibilityQuadtree::~VisibilityQuadtree()
 {
+    this->DiscardTreeData(0);
+    this->DiscardTreeData(1);
 }
 
 //------------------------------------------------------------------------------
@@ -68,6 +83,9 @@ VisibilityQuadtree::Close()
     this->contextCellMapping.Clear();
     this->rootCell->OnRemove();
     this->rootCell = 0;
+    this->DiscardTreeData(0);
+    this->DiscardTreeData(1);
+    this->SetDirty();
     VisibilitySystemBase::Close();        
 }
 
@@ -120,7 +138,7 @@ VisibilityQuadtree::CreateQuadTreeCell(VisibilityCell* parentCell, uchar curLeve
     // create a new cell
     Ptr<VisibilityCell> cell = VisibilityCell::Create();
     int nodeIndex = this->quadTree.GetNodeIndex(curLevel, curCol, curRow);
-    const QuadTree<CellInfo>::Node& node = this->quadTree.GetNodeByIndex(nodeIndex);
+    const QuadTree<IndexT>::Node& node = this->quadTree.GetNodeByIndex(nodeIndex);
     cell->SetBoundingBox(node.GetBoundingBox());        
     this->numCellsBuilt++;
 
@@ -201,77 +219,147 @@ VisibilityQuadtree::RenderCell(const Ptr<VisibilityCell>& cell, const Math::floa
 
 //------------------------------------------------------------------------------
 /**
+    Linearize the quadtree into the work buffer of the job. The work buffer
+    contains the cell array followed by the SoA entity data:
+
+    minX[n], minY[n], minZ[n], maxX[n], maxY[n], maxZ[n], types[n]
+
+    with n being the number of entities rounded up to the entity group size.
+    The padding entities are never reported as visible, since the jobs
+    only look at the lanes of the entity ranges stored in the cells.
 */
 void 
 VisibilityQuadtree::PrepareTreeData(IndexT bufferIndex)
 {   
-    // allocate memory for entity infos
-    SizeT numEntitiesInTree = this->rootCell->GetNumEntitiesInHierarchy();
-    this->entityInfos.SetSize(numEntitiesInTree);
-    IndexT curEntityInfoIdx = 0;
-    this->CollectContextPtr(this->rootCell, &this->quadTree.NodeByIndex(0), curEntityInfoIdx);
-
-    workData[bufferIndex].quadtreeSize = this->quadTree.GetNumNodesInTree() * sizeof(QuadTree<CellInfo>::Node); 
-    workData[bufferIndex].entityInfosSize = this->entityInfos.Size() * sizeof(EntityInfo);
-    // copy tree, could change on next visibility query, so we need own mem copy for this job    
-    workData[bufferIndex].workBuffer = Memory::Alloc(Memory::ScratchHeap, workData[bufferIndex].quadtreeSize + workData[bufferIndex].entityInfosSize);
-    Memory::Copy(&this->quadTree.NodeByIndex(0), workData[bufferIndex].workBuffer, workData[bufferIndex].quadtreeSize);
-    Memory::Copy(this->entityInfos.Begin(), (uchar*)workData[bufferIndex].workBuffer + workData[bufferIndex].quadtreeSize, workData[bufferIndex].entityInfosSize);
+    JobWorkData& work = this->workData[bufferIndex];
+    this->DiscardTreeData(bufferIndex);
+
+    SizeT numEntities = this->rootCell->GetNumEntitiesInHierarchy();
+    work.numEntitiesPadded = (numEntities + EntityGroupSize - 1) & ~(EntityGroupSize - 1);
+    work.cellsSize = this->numCellsBuilt * sizeof(CellInfo);
+    work.entitiesSize = work.numEntitiesPadded * EntityDataStride;
+    work.contexts.SetSize(numEntities);
+
+    // tree could change on next visibility query, so we need own mem copy for this job
+    work.workBuffer = Memory::Alloc(Memory::ScratchHeap, work.cellsSize + work.entitiesSize);
+    Memory::Clear((uchar*)work.workBuffer + work.cellsSize, work.entitiesSize);
+
+    IndexT curCellIndex = 0;
+    IndexT curEntityIndex = 0;
+    this->LinearizeCell(this->rootCell, bufferIndex, curCellIndex, curEntityIndex);
+    n_assert(curCellIndex == this->numCellsBuilt);
+    n_assert(curEntityIndex == numEntities);
 }
 
 //------------------------------------------------------------------------------
 /**
+    Writes the cells in depth-first order, so the entities of a cell's
+    subtree are stored contiguously behind the entities of the cell itself.
 */
 void 
-VisibilityQuadtree::CollectContextPtr(const Ptr<VisibilityCell>& cell, Util::QuadTree<CellInfo>::Node* node, IndexT& curEntityIndex)
+VisibilityQuadtree::LinearizeCell(const Ptr<VisibilityCell>& cell, IndexT bufferIndex, IndexT& curCellIndex, IndexT& curEntityIndex)
 {
-    SizeT numEntitiesInCell = cell->GetEntityContexts().Size();
+    JobWorkData& work = this->workData[bufferIndex];
+    const Array<Ptr<VisibilityContext> >& entities = cell->GetEntityContexts();
+    SizeT numEntitiesInCell = entities.Size();
     n_assert(numEntitiesInCell < 65535);    
-             
-    // save number of entites in cell and start index of entity infos
-    CellInfo& info = const_cast<CellInfo&>(node->GetElement());
-    info.numEntitiesInHierarchy = cell->GetNumEntitiesInHierarchy();
-    info.entityInfoStartIndex = curEntityIndex;
+
+    CellInfo* cells = (CellInfo*)work.workBuffer;
+    CellInfo& info = cells[curCellIndex++];
+    info.box = cell->GetBoundingBox();
+    info.firstEntityIndex = curEntityIndex;
     info.numEntitiesInCell = numEntitiesInCell;
+    info.numEntitiesInHierarchy = cell->GetNumEntitiesInHierarchy();
 
-    // save additional infos per entity in linear array
+    // save entity bounds into the SoA arrays
+    SizeT n = work.numEntitiesPadded;
+    float* bounds = (float*)((uchar*)work.workBuffer + work.cellsSize);
+    uint* types = (uint*)(bounds + 6 * n);
     IndexT i;
     for (i = 0; i < numEntitiesInCell; ++i)
     {
-        this->entityInfos[curEntityIndex].entityPtr = cell->GetEntityContexts()[i].get();
-        this->entityInfos[curEntityIndex].entityBox = cell->GetEntityContexts()[i]->GetBoundingBox();
-        this->entityInfos[curEntityIndex].entityType = cell->GetEntityContexts()[i]->GetGfxEntity()->GetType();        
+        const Ptr<VisibilityContext>& context = entities[i];
+        const bbox& box = context->GetBoundingBox();
+        bounds[curEntityIndex]         = box.pmin.x();
+        bounds[curEntityIndex + n]     = box.pmin.y();
+        bounds[curEntityIndex + 2 * n] = box.pmin.z();
+        bounds[curEntityIndex + 3 * n] = box.pmax.x();
+        bounds[curEntityIndex + 4 * n] = box.pmax.y();
+        bounds[curEntityIndex + 5 * n] = box.pmax.z();
+        types[curEntityIndex] = context->GetGfxEntity()->GetType();
+        work.contexts[curEntityIndex] = context;
         curEntityIndex++;
     }      
 
     IndexT childIdx;
     for (childIdx = 0; childIdx < cell->GetChildCells().Size(); ++childIdx)
     {
-        this->CollectContextPtr(cell->GetChildCells()[childIdx], node->GetChildAt(childIdx), curEntityIndex);
+        this->LinearizeCell(cell->GetChildCells()[childIdx], bufferIndex, curCellIndex, curEntityIndex);
     }       
+    info.skipIndex = curCellIndex;
 }
 
 //------------------------------------------------------------------------------
 /**
 */
-Ptr<Jobs::Job> 
-VisibilityQuadtree::CreateVisibilityJob(IndexT frameId, const Ptr<ObserverContext>& observer, Util::FixedArray<Ptr<VisibilityContext> >& outEntitiyArray, uint& entityMask)
-{   
+void 
+VisibilityQuadtree::DiscardTreeData(IndexT bufferIndex)
+{
+    JobWorkData& work = this->workData[bufferIndex];
+    if (0 != work.workBuffer)
+    {
+        Memory::Free(Memory::ScratchHeap, work.workBuffer);
+        work.workBuffer = 0;
+    }
+    work.cellsSize = 0;
+    work.entitiesSize = 0;
+    work.numEntitiesPadded = 0;
+    work.contexts.SetSize(0);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+IndexT
+VisibilityQuadtree::UpdateWorkData(IndexT frameId)
+{
     IndexT bufferIndex = frameId % 2;
+
     // first check if tree data is dirty
-    if (workData[bufferIndex].bufferDirty)
+    if (this->workData[bufferIndex].bufferDirty)
     {
         this->PrepareTreeData(bufferIndex);      
-        workData[bufferIndex].bufferDirty = false;
+        this->workData[bufferIndex].bufferDirty = false;
     } 
+    return bufferIndex;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Ptr<Jobs::Job> 
+VisibilityQuadtree::CreateVisibilityJob(IndexT frameId, const Ptr<ObserverContext>& observer, VisibilityResult& result, uint& entityMask)
+{   
+    IndexT bufferIndex = this->UpdateWorkData(frameId);
+    JobWorkData& work = this->workData[bufferIndex];
+
+    // the result indices refer to the entity table of this work buffer
+    result.contexts = work.contexts.Begin();
+    result.numContexts = work.contexts.Size();
+    result.Reset(work.contexts.Size());
+    if (0 == work.contexts.Size())
+    {
+        // nothing to check
+        return Ptr<Jobs::Job>();
+    }
+
     // create new job           
     Ptr<Jobs::Job> visibilityJob = Jobs::Job::Create();
     // input data for job  
     // function
     JobFuncDesc jobFunction(VisibilityQuadtreeJobFunc);        
-    // uniform data     
-    
-    JobUniformDesc uniformData(workData[bufferIndex].workBuffer, workData[bufferIndex].quadtreeSize, (uchar*)workData[bufferIndex].workBuffer + workData[bufferIndex].quadtreeSize, workData[bufferIndex].entityInfosSize, 0);  
+    // uniform data: linear cell array and SoA entity data
+    JobUniformDesc uniformData(work.workBuffer, work.cellsSize, (uchar*)work.workBuffer + work.cellsSize, work.entitiesSize, 0);  
     uint dummy;
     // update observer data
     JobDataDesc inputData(observer->GetTypeRef(), sizeof(uint), sizeof(uint), 
@@ -290,14 +378,54 @@ VisibilityQuadtree::CreateVisibilityJob(IndexT frameId, const Ptr<ObserverContex
         break;
     }
 
-    // update output data
-    JobDataDesc outputData(outEntitiyArray.Begin(), outEntitiyArray.Size() * sizeof(Ptr<VisibilityContext>), outEntitiyArray.Size() * sizeof(Ptr<VisibilityContext>));
+    // output data: compact index list and number of visible entities
+    SizeT indicesSize = result.numContexts * sizeof(IndexT);
+    JobDataDesc outputData(result.indices.Begin(), indicesSize, indicesSize,
+                           &result.numVisible, sizeof(SizeT), sizeof(SizeT));
     // setup job with data
     visibilityJob->Setup(uniformData, inputData, outputData, jobFunction);
     
     return visibilityJob;
 }
 
+//------------------------------------------------------------------------------
+/**
+    Create a job which culls the entities against all observers of a 
+    batched query in a single traversal of the quadtree. The observer
+    infos of the result must be setup by the caller.
+*/
+Ptr<Jobs::Job> 
+VisibilityQuadtree::CreateBatchVisibilityJob(IndexT frameId, VisibilityBatchResult& result)
+{
+    n_assert((result.numObservers > 0) && (result.numObservers <= VisibilityBatchResult::MaxNumObservers));
+    IndexT bufferIndex = this->UpdateWorkData(frameId);
+    JobWorkData& work = this->workData[bufferIndex];
+
+    // the observer masks refer to the entity table of this work buffer
+    result.contexts = work.contexts.Begin();
+    result.numContexts = work.contexts.Size();
+    result.Reset(work.contexts.Size());
+    if (0 == work.contexts.Size())
+    {
+        // nothing to check
+        return Ptr<Jobs::Job>();
+    }
+
+    Ptr<Jobs::Job> visibilityJob = Jobs::Job::Create();
+    JobFuncDesc jobFunction(VisibilityQuadtreeBatchJobFunc);
+    // uniform data: linear cell array and SoA entity data
+    JobUniformDesc uniformData(work.workBuffer, work.cellsSize, (uchar*)work.workBuffer + work.cellsSize, work.entitiesSize, 0);  
+    // input data: the observers
+    SizeT observersSize = result.numObservers * sizeof(VisibilityBatchResult::ObserverInfo);
+    JobDataDesc inputData(result.observers.Begin(), observersSize, observersSize);
+    // output data: one observer mask per entity
+    SizeT masksSize = result.numContexts * sizeof(uint);
+    JobDataDesc outputData(result.observerMasks.Begin(), masksSize, masksSize);
+    visibilityJob->Setup(uniformData, inputData, outputData, jobFunction);
+
+    return visibilityJob;
+}
+
 //------------------------------------------------------------------------------
 /**
 */
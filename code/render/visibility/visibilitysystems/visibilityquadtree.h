@@ -5,6 +5,14 @@
 
     Simple quadtree for culling. 
     Entities are automatically sorted into quadtree.
+
+    For the visibility job the quadtree is linearized into a depth-first 
+    cell array, where each cell knows the index of the first cell behind its
+    subtree. The entities are stored in the same depth-first order, so the
+    entities of a cell's whole subtree form one contiguous range. Entity 
+    bounding boxes are stored as SoA min/max arrays, which the job tests 
+    4 boxes at a time against the observer. The job writes a compact 
+    list of indices into the entity table of the quadtree.
        
     (C) 2010 Radon Labs GmbH
 */
@@ -20,19 +28,20 @@ class VisibilityQuadtree : public VisibilitySystemBase
 {
     __DeclareClass(VisibilityQuadtree);
 public:      
+    /// a cell in the linearized job data
     struct CellInfo 
     {
+        Math::bbox box;
+        IndexT firstEntityIndex;            // entities of the whole subtree follow contiguously
+        SizeT numEntitiesInCell;
         SizeT numEntitiesInHierarchy;
-        IndexT entityInfoStartIndex;
-        IndexT numEntitiesInCell;
+        IndexT skipIndex;                   // index of the first cell behind the subtree of this cell
     };
 
-    struct EntityInfo
-    {
-        Math::bbox entityBox;        
-        VisibilityContext* entityPtr;
-        uint entityType;
-    };
+    /// number of entity bounding boxes tested per iteration
+    static const SizeT EntityGroupSize = 4;
+    /// number of bytes per entity in the SoA entity data (min/max x,y,z and entity type)
+    static const SizeT EntityDataStride = 6 * sizeof(float) + sizeof(uint);
     /// constructor
     VisibilityQuadtree();
     /// destructor
@@ -53,8 +62,12 @@ public:
     /// update entity visibility
     virtual void UpdateVisibilityContext(const Ptr<VisibilityContext>& entityVis);
                 
-    /// attach visibility job to port
-    virtual Ptr<Jobs::Job> CreateVisibilityJob(IndexT frameId, const Ptr<ObserverContext>& observer, Util::FixedArray<Ptr<VisibilityContext> >& outEntitiyArray, uint& entityMask);
+    /// create visibility job, writes the compact visibility result
+    virtual Ptr<Jobs::Job> CreateVisibilityJob(IndexT frameId, const Ptr<ObserverContext>& observer, VisibilityResult& result, uint& entityMask);
+    /// return true, the quadtree supports batched queries
+    virtual bool SupportsBatchQueries() const;
+    /// create visibility job for all observers of a batched query
+    virtual Ptr<Jobs::Job> CreateBatchVisibilityJob(IndexT frameId, VisibilityBatchResult& result);
     /// render debug visualizations
     virtual void OnRenderDebug();
     /// get observer type mask
@@ -65,26 +78,31 @@ private:
     Ptr<VisibilityCell> CreateQuadTreeCell(VisibilityCell* parentCell, uchar curLevel, ushort curCol, ushort curRow);
     /// render quadtree cell
     void RenderCell(const Ptr<VisibilityCell>& cell, const Math::float4& color);
+    /// get work buffer index for a frame, updates the job data if necessary
+    IndexT UpdateWorkData(IndexT frameId);
     /// prepare job input data from quadtree
     void PrepareTreeData(IndexT bufferIndex); 
-    /// collect context ptr
-    void CollectContextPtr(const Ptr<VisibilityCell>& cell, Util::QuadTree<CellInfo>::Node* node, IndexT& curEntityIndex);
+    /// linearize a cell and its children into the job data, recursively
+    void LinearizeCell(const Ptr<VisibilityCell>& cell, IndexT bufferIndex, IndexT& curCellIndex, IndexT& curEntityIndex);
+    /// free the job data of a work buffer
+    void DiscardTreeData(IndexT bufferIndex);
     /// mark tree structure as dirty
     void SetDirty();
 
     int numCellsBuilt;
     uchar quadTreeDepth;
     Math::bbox quadTreeBox;
-    Util::QuadTree<CellInfo> quadTree;
-    Util::FixedArray<EntityInfo> entityInfos;
+    Util::QuadTree<IndexT> quadTree;        // only used to compute the cell bounding boxes
     Ptr<VisibilityCell> rootCell;
     Util::Dictionary<Ptr<VisibilityContext>, Ptr<VisibilityCell> > contextCellMapping;    
     struct JobWorkData
     {
         void* workBuffer;
         bool bufferDirty;  
-        SizeT quadtreeSize;
-        SizeT entityInfosSize;
+        SizeT cellsSize;
+        SizeT entitiesSize;
+        SizeT numEntitiesPadded;
+        Util::FixedArray<Ptr<VisibilityContext> > contexts;     // entity table, indexed by the job results
     };
     JobWorkData workData[2];
 };
@@ -106,6 +124,15 @@ VisibilityQuadtree::GetObserverBitMask() const
 {
     return (1 << InternalGraphics::InternalGraphicsEntityType::Camera) | (1 << InternalGraphics::InternalGraphicsEntityType::Light);
 }
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool 
+VisibilityQuadtree::SupportsBatchQueries() const
+{
+    return true;
+}
 } // namespace Visibility
 //------------------------------------------------------------------------------
 
@@ -124,13 +124,26 @@ VisibilitySystemBase::EndAttachVisibilityContainer()
 /**
 */
 Ptr<Jobs::Job>
-VisibilitySystemBase::CreateVisibilityJob(IndexT frameId, const Ptr<ObserverContext>& observer, Util::FixedArray<Ptr<VisibilityContext> >& outEntitiyArray, uint& entityMask)
+VisibilitySystemBase::CreateVisibilityJob(IndexT frameId, const Ptr<ObserverContext>& observer, VisibilityResult& result, uint& entityMask)
 {
     // implement in subclass
     n_error("VisibilitySystemBase::AttachVisibilityJob called: Implement in subclass! Do it!");
 
-    Ptr<Jobs::Job> result;
-    return result;
+    Ptr<Jobs::Job> job;
+    return job;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+Ptr<Jobs::Job> 
+VisibilitySystemBase::CreateBatchVisibilityJob(IndexT frameId, VisibilityBatchResult& result)
+{
+    // implement in subclass
+    n_error("VisibilitySystemBase::CreateBatchVisibilityJob called: system doesn't support batched queries!");
+
+    Ptr<Jobs::Job> job;
+    return job;
 }
 
 } // namespace Visibility
@@ -8,6 +8,7 @@
 #include "core/refcounted.h"
 #include "visibility/observercontext.h"
 #include "visibility/visibilitycontext.h"
+#include "visibility/visibilityresult.h"
 #include "jobs/jobport.h"
               
 //------------------------------------------------------------------------------
@@ -44,8 +45,12 @@ public:
     /// end attach visibility container 
     virtual void EndAttachVisibilityContainer();
 
-    /// attach visibility job to port
-    virtual Ptr<Jobs::Job> CreateVisibilityJob(IndexT frameId, const Ptr<ObserverContext>& observer, Util::FixedArray<Ptr<VisibilityContext> >& outEntitiyArray, uint& entityMask);
+    /// create visibility job which writes or filters the visibility result
+    virtual Ptr<Jobs::Job> CreateVisibilityJob(IndexT frameId, const Ptr<ObserverContext>& observer, VisibilityResult& result, uint& entityMask);
+    /// return true if the system can cull all observers of a batched query in one job
+    virtual bool SupportsBatchQueries() const;
+    /// create visibility job which writes the observer masks of a batched query
+    virtual Ptr<Jobs::Job> CreateBatchVisibilityJob(IndexT frameId, VisibilityBatchResult& result);
     /// render debug visualizations
     virtual void OnRenderDebug();    
     /// get observer type mask
@@ -73,6 +78,15 @@ VisibilitySystemBase::GetObserverBitMask() const
 {
     return 0;
 }
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline bool 
+VisibilitySystemBase::SupportsBatchQueries() const
+{
+    return false;
+}
 } // namespace Visibility
 //------------------------------------------------------------------------------
 
@@ -25,6 +25,55 @@ extern "C" {
 }
 #else
 extern void ParticleJobFunc(const JobFuncContext& ctx);
+
+//------------------------------------------------------------------------------
+/**
+    Job function for the uneven slice benchmark. The input elements
+    define the number of iterations of a dummy computation for each
+    element, so that the cost of each slice can be controlled.
+*/
+void
+UnevenSliceJobFunc(const JobFuncContext& ctx)
+{
+    const uint* costs = (const uint*) ctx.inputs[0];
+    float* results = (float*) ctx.outputs[0];
+    SizeT numElements = ctx.inputSizes[0] / sizeof(uint);
+    IndexT elmIndex;
+    for (elmIndex = 0; elmIndex < numElements; elmIndex++)
+    {
+        float val = 1.0f;
+        uint i;
+        for (i = 0; i < costs[elmIndex]; i++)
+        {
+            val = val * 0.999f + 0.5f;
+        }
+        results[elmIndex] = val;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Job function for the job graph test, computes the sum of all inputs
+    multiplied by the uniform factor.
+*/
+void
+JobGraphFunc(const JobFuncContext& ctx)
+{
+    float factor = *(const float*) ctx.uniforms[0];
+    float* results = (float*) ctx.outputs[0];
+    SizeT numElements = ctx.outputSizes[0] / sizeof(float);
+    IndexT elmIndex;
+    for (elmIndex = 0; elmIndex < numElements; elmIndex++)
+    {
+        float sum = 0.0f;
+        IndexT inputIndex;
+        for (inputIndex = 0; inputIndex < (IndexT)ctx.numInputs; inputIndex++)
+        {
+            sum += ((const float*)ctx.inputs[inputIndex])[elmIndex];
+        }
+        results[elmIndex] = sum * factor;
+    }
+}
 #endif
 
 
@@ -88,6 +137,21 @@ JobsTestApplication::Close()
 */
 void
 JobsTestApplication::Run()
+{
+    this->RunParticleJobTest();
+#if !__PS3__
+    this->RunUnevenSliceBenchmark(EvenWorkload);
+    this->RunUnevenSliceBenchmark(StridedWorkload);
+    this->RunUnevenSliceBenchmark(FrontLoadedWorkload);
+    this->RunJobGraphTest();
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+JobsTestApplication::RunParticleJobTest()
 {
     // uniform
 #if __PS3__
@@ -102,7 +166,25 @@ JobsTestApplication::Run()
 #endif
     JobUniformDesc uniformDesc(un, sizeof(JobUniformData), 0);
 
-    const int input_size_bytes = sizeof(Particle) * particleCount; 
+    // convert the test particles into particle blocks, unused particles 
+    // of the last block are dead
+    const SizeT blockCount = (particleCount + ParticleBlockSize - 1) / ParticleBlockSize;
+    ParticleBlock *blocksInput = n_new_array(ParticleBlock, blockCount);
+    Memory::Clear(blocksInput, blockCount * sizeof(ParticleBlock));
+    IndexT particleIndex;
+    for (particleIndex = 0; particleIndex < blockCount * ParticleBlockSize; particleIndex++)
+    {
+        ParticleBlock& block = blocksInput[particleIndex / ParticleBlockSize];
+        if (particleIndex < particleCount)
+        {
+            ParticleBlockSetParticle(block, particleIndex % ParticleBlockSize, particlesInput[particleIndex]);
+        }
+        else
+        {
+            ParticleBlockKillParticle(block, particleIndex % ParticleBlockSize);
+        }
+    }
+    const int input_size_bytes = sizeof(ParticleBlock) * blockCount; 
     
 #if __PS3__
     const SizeT inputSliceSize = generateVertexList ? PARTICLE_JOB_INPUT_SLICE_SIZE__VSTREAM_ON :
@@ -110,13 +192,13 @@ JobsTestApplication::Run()
 #else
     const SizeT inputSliceSize = PARTICLE_JOB_INPUT_SLICE_SIZE__VSTREAM_OFF;
 #endif
-    JobDataDesc inputDesc(particlesInput, input_size_bytes, inputSliceSize);
+    JobDataDesc inputDesc(blocksInput, input_size_bytes, inputSliceSize);
 
 
     // output
     Jobs::JobDataDesc outputDesc;
-    Particle *particlesOutput = n_new_array(Particle, particleCount);
-    n_assert(particlesOutput);
+    ParticleBlock *blocksOutput = n_new_array(ParticleBlock, blockCount);
+    n_assert(blocksOutput);
     const int inputBufferSize = input_size_bytes;
     int sliceCount = (inputBufferSize +(inputSliceSize-1)) / inputSliceSize;
     n_assert(sliceCount > 0);
@@ -134,14 +216,14 @@ JobsTestApplication::Run()
         vertexCache = n_new_array(unsigned char, vertexBufferSize);
         n_assert(vertexCache);
         n_assert(vertexBufferSize > 0);
-        outputDesc = Jobs::JobDataDesc(particlesOutput, inputBufferSize, inputSliceSize,
+        outputDesc = Jobs::JobDataDesc(blocksOutput, inputBufferSize, inputSliceSize,
                                        sliceOutput, sizeof(JobSliceOutputData) * sliceCount, sizeof(JobSliceOutputData),
                                        vertexCache, vertexBufferSize, PARTICLE_JOB_PS3_OUTPUT_VBUFFER_SLICE_SIZE);
     }
     else
 #endif
     {
-        outputDesc = Jobs::JobDataDesc(particlesOutput, inputBufferSize, inputSliceSize,
+        outputDesc = Jobs::JobDataDesc(blocksOutput, inputBufferSize, inputSliceSize,
                                        sliceOutput, sizeof(JobSliceOutputData) * sliceCount, sizeof(JobSliceOutputData));
     }
 
@@ -189,6 +271,10 @@ JobsTestApplication::Run()
     }
     n_delete_array(sliceOutput);
     sliceOutput = NULL;
+    n_delete_array(blocksOutput);
+    blocksOutput = NULL;
+    n_delete_array(blocksInput);
+    blocksInput = NULL;
 #if __PS3__
     if(vertexCache)
     {
@@ -198,4 +284,189 @@ JobsTestApplication::Run()
 #endif
 }
 
+#if !__PS3__
+//------------------------------------------------------------------------------
+/**
+    Runs a job with an uneven cost distribution over its slices and
+    compares the time in the job system against running all slices
+    on the main thread. With work-stealing, the parallel time should 
+    stay close to the even workload even if the expensive slices
+    end up in the queue of a single worker thread.
+*/
+void
+JobsTestApplication::RunUnevenSliceBenchmark(Workload workload)
+{
+    const SizeT numSlices = 256;
+    const SizeT numElementsPerSlice = 16;
+    const SizeT numElements = numSlices * numElementsPerSlice;
+    const SizeT sliceSize = numElementsPerSlice * sizeof(uint);
+    const uint cheapCost = 64;
+    const uint expensiveCost = 1024;
+    const SizeT numRuns = 200;
+
+    // setup per-element costs, total cost is the same for all workloads
+    uint* costs = n_new_array(uint, numElements);
+    float* results = n_new_array(float, numElements);
+    uint totalCost = 0;
+    IndexT sliceIndex;
+    for (sliceIndex = 0; sliceIndex < numSlices; sliceIndex++)
+    {
+        uint cost;
+        switch (workload)
+        {
+            case StridedWorkload:
+                cost = (0 == (sliceIndex % 4)) ? expensiveCost : cheapCost;
+                break;
+            case FrontLoadedWorkload:
+                cost = (sliceIndex < (numSlices / 4)) ? expensiveCost : cheapCost;
+                break;
+            default:
+                cost = (expensiveCost + 3 * cheapCost) / 4;
+                break;
+        }
+        IndexT elmIndex;
+        for (elmIndex = 0; elmIndex < numElementsPerSlice; elmIndex++)
+        {
+            costs[sliceIndex * numElementsPerSlice + elmIndex] = cost;
+            totalCost += cost;
+        }
+    }
+
+    // setup the job
+    JobUniformDesc uniformDesc(&totalCost, sizeof(totalCost), 0);
+    JobDataDesc inputDesc(costs, numElements * sizeof(uint), sliceSize);
+    JobDataDesc outputDesc(results, numElements * sizeof(float), numElementsPerSlice * sizeof(float));
+    JobFuncDesc funcDesc(UnevenSliceJobFunc);
+    Ptr<Job> unevenJob = Job::Create();
+    unevenJob->Setup(uniformDesc, inputDesc, outputDesc, funcDesc);
+    Ptr<JobPort> unevenJobPort = JobPort::Create();
+    unevenJobPort->Setup();
+
+    // run the job in the job system
+    Timer parallelTimer;
+    parallelTimer.Start();
+    IndexT runIndex;
+    for (runIndex = 0; runIndex < numRuns; runIndex++)
+    {
+        unevenJobPort->PushJob(unevenJob);
+        unevenJobPort->WaitDone();
+    }
+    parallelTimer.Stop();
+
+    // run the same slices on the main thread for reference
+    Timer serialTimer;
+    serialTimer.Start();
+    for (runIndex = 0; runIndex < numRuns; runIndex++)
+    {
+        for (sliceIndex = 0; sliceIndex < numSlices; sliceIndex++)
+        {
+            JobFuncContext ctx = { 0 };
+            ctx.numInputs = 1;
+            ctx.inputs[0] = (ubyte*) (costs + sliceIndex * numElementsPerSlice);
+            ctx.inputSizes[0] = sliceSize;
+            ctx.numOutputs = 1;
+            ctx.outputs[0] = (ubyte*) (results + sliceIndex * numElementsPerSlice);
+            ctx.outputSizes[0] = numElementsPerSlice * sizeof(float);
+            UnevenSliceJobFunc(ctx);
+        }
+    }
+    serialTimer.Stop();
+
+    const char* workloadName = (StridedWorkload == workload) ? "strided" : (FrontLoadedWorkload == workload) ? "front-loaded" : "even";
+    n_printf("uneven slices (%s, runs %d): parallel %fs, serial %fs, speedup %.2f\n",
+        workloadName, numRuns, parallelTimer.GetTime(), serialTimer.GetTime(),
+        serialTimer.GetTime() / Math::n_max(parallelTimer.GetTime(), 0.000001));
+
+    unevenJob->Discard();
+    unevenJob = 0;
+    unevenJobPort->Discard();
+    unevenJobPort = 0;
+    n_delete_array(results);
+    n_delete_array(costs);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Runs a diamond-shaped job graph (A -> B, A -> C, B + C -> D) many
+    times and checks the result of D. Job B and C only depend on A and
+    may run in parallel, D depends on both.
+*/
+void
+JobsTestApplication::RunJobGraphTest()
+{
+    const SizeT numElements = 4096;
+    const SizeT bufSize = numElements * sizeof(float);
+    const SizeT sliceSize = 256 * sizeof(float);
+    const SizeT numRuns = 1000;
+
+    float* source = n_new_array(float, numElements);
+    float* bufA = n_new_array(float, numElements);
+    float* bufB = n_new_array(float, numElements);
+    float* bufC = n_new_array(float, numElements);
+    float* bufD = n_new_array(float, numElements);
+    IndexT i;
+    for (i = 0; i < numElements; i++)
+    {
+        source[i] = 1.0f;
+    }
+    float factorA = 1.0f;
+    float factorB = 2.0f;
+    float factorC = 3.0f;
+    float factorD = 1.0f;
+
+    JobFuncDesc funcDesc(JobGraphFunc);
+    Ptr<Job> jobA = Job::Create();
+    jobA->Setup(JobUniformDesc(&factorA, sizeof(float), 0), JobDataDesc(source, bufSize, sliceSize), JobDataDesc(bufA, bufSize, sliceSize), funcDesc);
+    Ptr<Job> jobB = Job::Create();
+    jobB->Setup(JobUniformDesc(&factorB, sizeof(float), 0), JobDataDesc(bufA, bufSize, sliceSize), JobDataDesc(bufB, bufSize, sliceSize), funcDesc);
+    Ptr<Job> jobC = Job::Create();
+    jobC->Setup(JobUniformDesc(&factorC, sizeof(float), 0), JobDataDesc(bufA, bufSize, sliceSize), JobDataDesc(bufC, bufSize, sliceSize), funcDesc);
+    Ptr<Job> jobD = Job::Create();
+    jobD->Setup(JobUniformDesc(&factorD, sizeof(float), 0), JobDataDesc(bufB, bufSize, sliceSize, bufC, bufSize, sliceSize), JobDataDesc(bufD, bufSize, sliceSize), funcDesc);
+
+    Util::Array<Ptr<Job> > predA;
+    predA.Append(jobA);
+    Util::Array<Ptr<Job> > predBC;
+    predBC.Append(jobB);
+    predBC.Append(jobC);
+
+    Ptr<JobPort> graphJobPort = JobPort::Create();
+    graphJobPort->Setup();
+
+    bool success = true;
+    Timer graphTimer;
+    graphTimer.Start();
+    IndexT runIndex;
+    for (runIndex = 0; runIndex < numRuns; runIndex++)
+    {
+        Memory::Clear(bufD, bufSize);
+        graphJobPort->PushJob(jobA);
+        graphJobPort->PushDependentJob(jobB, predA);
+        graphJobPort->PushDependentJob(jobC, predA);
+        graphJobPort->PushDependentJob(jobD, predBC);
+        graphJobPort->WaitDone();
+        for (i = 0; i < numElements; i++)
+        {
+            if (bufD[i] != 5.0f)
+            {
+                success = false;
+            }
+        }
+    }
+    graphTimer.Stop();
+    n_printf("job graph (runs %d): %fs, %s\n", numRuns, graphTimer.GetTime(), success ? "ok" : "FAILED");
+
+    jobA->Discard();
+    jobB->Discard();
+    jobC->Discard();
+    jobD->Discard();
+    graphJobPort->Discard();
+    n_delete_array(bufD);
+    n_delete_array(bufC);
+    n_delete_array(bufB);
+    n_delete_array(bufA);
+    n_delete_array(source);
+}
+#endif
+
 } // namespace Test
@@ -31,6 +31,20 @@ public:
     virtual void Run();
 
 private:
+    /// workload patterns for the uneven slice benchmark
+    enum Workload
+    {
+        EvenWorkload,           // all slices have the same cost
+        StridedWorkload,        // every 4th slice is expensive
+        FrontLoadedWorkload,    // the first quarter of the slices is expensive
+    };
+    /// run the particle job test
+    void RunParticleJobTest();
+    /// run a benchmark with uneven per-slice workloads
+    void RunUnevenSliceBenchmark(Workload workload);
+    /// run a diamond-shaped job graph and check the results
+    void RunJobGraphTest();
+
     Ptr<Jobs::JobSystem> jobSystem;
     Ptr<Jobs::JobPort> jobPort;
     Ptr<Jobs::Job> job;
@@ -4,6 +4,7 @@
 //------------------------------------------------------------------------------
 #include "stdneb.h"
 #include "arraytest.h"
+#include "math/matrix44.h"
 
 namespace Test
 {
@@ -134,6 +135,66 @@ ArrayTest::Run()
     this->Verify(array0.BinarySearchIndex(3) == 2);
     this->Verify(array0.BinarySearchIndex(4) == 3);
     this->Verify(array0.BinarySearchIndex(5) == -1);
+
+    // relocatable elements must survive growing, inserting and erasing
+    Array<String> strArray;
+    for (i = 0; i < 100; i++)
+    {
+        strArray.Insert(0, String::FromInt(i));
+    }
+    strArray.EraseIndex(0);
+    strArray.EraseIndex(50);
+    this->Verify(strArray.Size() == 98);
+    this->Verify(strArray[0] == "98");
+    this->Verify(strArray[49] == "49");
+    this->Verify(strArray[50] == "47");
+    this->Verify(strArray.Back() == "0");
+
+    // relocating smart pointers must not change the refcount
+    Ptr<Core::RefCounted> obj = Core::RefCounted::Create();
+    Array<Ptr<Core::RefCounted> > ptrArray;
+    for (i = 0; i < 100; i++)
+    {
+        ptrArray.Insert(0, obj);
+    }
+    this->Verify(obj->GetRefCount() == 101);
+    ptrArray.EraseIndex(10);
+    this->Verify(obj->GetRefCount() == 100);
+    ptrArray.Clear();
+    this->Verify(obj->GetRefCount() == 1);
+
+    // inline storage
+    Array<String, ArrayInlineAllocator<String, 4> > inlineArray;
+    inlineArray.Append("a"); inlineArray.Append("b"); inlineArray.Append("c");
+    Array<String, ArrayInlineAllocator<String, 4> > inlineCopy(inlineArray);
+    inlineArray.Append("d"); inlineArray.Append("e");
+    this->Verify(inlineArray.Size() == 5);
+    this->Verify(inlineArray[4] == "e");
+    this->Verify(inlineCopy.Size() == 3);
+    inlineCopy = inlineArray;
+    this->Verify(inlineCopy == inlineArray);
+    inlineCopy.EraseIndex(0);
+    this->Verify(inlineCopy[0] == "b");
+
+    // matrix44 is relocatable but not trivial, unused elements must be
+    // default constructed (identity) when the array grows
+    Array<Math::matrix44> matrixArray;
+    matrixArray.Append(Math::matrix44::translation(1.0f, 2.0f, 3.0f));
+    matrixArray.Reserve(matrixArray.Capacity());
+    SizeT numMatrices = matrixArray.Capacity();
+    for (i = 0; i < numMatrices; i++)
+    {
+        matrixArray.Append(Math::matrix44::translation(1.0f, 2.0f, 3.0f));
+    }
+    this->Verify(matrixArray.Size() < matrixArray.Capacity());
+    const Math::matrix44* matrixElements = matrixArray.Begin();
+    bool allIdentity = true;
+    for (i = matrixArray.Size(); i < matrixArray.Capacity(); i++)
+    {
+        allIdentity &= matrixElements[i].isidentity();
+    }
+    this->Verify(allIdentity);
+    this->Verify(!matrixArray.Back().isidentity());
 }
 
 }; // namespace Test
\ No newline at end of file
@@ -72,6 +72,57 @@ HashTableTest::Run()
     table.Clear();
     this->Verify(table.Size() == 0);
     this->Verify(table.IsEmpty());
+
+    // check growing and erasing with many elements
+    const SizeT numKeys = 5000;
+    HashTable<String, IndexT> bigTable;
+    this->Verify(bigTable.Capacity() == 0);
+    this->Verify(!bigTable.Contains("Porco Rosso"));
+    for (i = 0; i < numKeys; i++)
+    {
+        bigTable.Add(String::FromInt(i), i);
+    }
+    this->Verify(bigTable.Size() == numKeys);
+    this->Verify(bigTable.Capacity() >= numKeys);
+    for (i = 0; i < numKeys; i += 2)
+    {
+        bigTable.Erase(String::FromInt(i));
+    }
+    this->Verify(bigTable.Size() == numKeys / 2);
+    bool allFound = true;
+    for (i = 0; i < numKeys; i++)
+    {
+        IndexT index = bigTable.FindIndex(String::FromInt(i));
+        if (0 == (i & 1))
+        {
+            allFound &= (InvalidIndex == index);
+        }
+        else
+        {
+            allFound &= (InvalidIndex != index) && (bigTable.ValueAtIndex(index) == i) && (bigTable.KeyAtIndex(index) == String::FromInt(i));
+        }
+    }
+    this->Verify(allFound);
+
+    // re-adding into erased slots must not grow the table
+    SizeT bigCapacity = bigTable.Capacity();
+    for (i = 0; i < numKeys; i += 2)
+    {
+        bigTable.Add(String::FromInt(i), i);
+    }
+    this->Verify(bigTable.Size() == numKeys);
+    this->Verify(bigTable.Capacity() == bigCapacity);
+    this->Verify(bigTable.Content().Size() == numKeys);
+
+    // check assignment
+    HashTable<String, IndexT> assigned;
+    assigned = bigTable;
+    allFound = true;
+    for (i = 0; i < numKeys; i++)
+    {
+        allFound &= assigned.Contains(String::FromInt(i)) && (assigned[String::FromInt(i)] == i);
+    }
+    this->Verify(allFound);
 }
 
 };
\ No newline at end of file
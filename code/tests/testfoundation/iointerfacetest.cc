@@ -6,6 +6,7 @@
 #include "iointerfacetest.h"
 #include "io/iointerface.h"
 #include "io/memorystream.h"
+#include "messaging/batchmessage.h"
 
 namespace Test
 {
@@ -123,6 +124,84 @@ IOInterfaceTest::Run()
     this->Verify(!ioServer->FileExists(copyUri));
     #endif
 
+    // write a few small files, and read them back in one batch
+    const SizeT numFiles = 24;
+    ioServer->CreateDirectory("temp:iointerfacetest");
+    Util::Array<Ptr<ReadStream> > readMsgs;
+    Ptr<BatchMessage> batchMsg = BatchMessage::Create();
+    IndexT i;
+    for (i = 0; i < numFiles; i++)
+    {
+        Util::String fileName;
+        fileName.Format("temp:iointerfacetest/file%d.test", i);
+        URI fileUri(fileName);
+        Ptr<Stream> fileStream = ioServer->CreateStream(fileUri);
+        fileStream->SetAccessMode(Stream::WriteAccess);
+        if (fileStream->Open())
+        {
+            Util::String content;
+            content.Format("content of file %d", i);
+            fileStream->Write(content.AsCharPtr(), content.Length());
+            fileStream->Close();
+        }
+        Ptr<ReadStream> msg = ReadStream::Create();
+        msg->SetURI(fileUri);
+        Ptr<MemoryStream> memStream = MemoryStream::Create();
+        msg->SetStream(memStream.upcast<Stream>());
+        msg->SetPriority(i % 3);
+        msg->SetDeadline((i & 1) ? 5.0 : 0.0);
+        batchMsg->AddMessage(msg.upcast<Message>());
+        readMsgs.Append(msg);
+    }
+    iface->Send(batchMsg.upcast<Message>());
+
+    // wait for the read requests, and check the data
+    bool allRead = true;
+    bool allValid = true;
+    for (i = 0; i < numFiles; i++)
+    {
+        iface->Wait(readMsgs[i].upcast<Message>());
+        allRead &= readMsgs[i]->Handled() && readMsgs[i]->GetResult();
+        const Ptr<Stream>& stream = readMsgs[i]->GetStream();
+        Util::String content;
+        content.Format("content of file %d", i);
+        if (stream->GetSize() == content.Length())
+        {
+            stream->SetAccessMode(Stream::ReadAccess);
+            stream->Open();
+            allValid &= (0 == memcmp(stream->Map(), content.AsCharPtr(), content.Length()));
+            stream->Unmap();
+            stream->Close();
+        }
+        else
+        {
+            allValid = false;
+        }
+    }
+    this->Verify(allRead);
+    this->Verify(allValid);
+
+    // reading a non-existing file must fail
+    Ptr<ReadStream> failMsg = ReadStream::Create();
+    failMsg->SetURI("temp:iointerfacetest/nonexisting.test");
+    Ptr<MemoryStream> failStream = MemoryStream::Create();
+    failMsg->SetStream(failStream.upcast<Stream>());
+    iface->SendWait(failMsg.upcast<Message>());
+    this->Verify(failMsg->Handled());
+    this->Verify(!failMsg->GetResult());
+
+    // cleanup
+    for (i = 0; i < numFiles; i++)
+    {
+        Util::String fileName;
+        fileName.Format("temp:iointerfacetest/file%d.test", i);
+        ioServer->DeleteFile(fileName);
+    }
+    Ptr<DeleteDirectory> delDirMsg = DeleteDirectory::Create();
+    delDirMsg->SetURI("temp:iointerfacetest");
+    iface->SendWait(delDirMsg.upcast<Message>());
+    this->Verify(delDirMsg->GetResult());
+
     iface->Close();
 }
 
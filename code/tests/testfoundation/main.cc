@@ -16,7 +16,9 @@
 #include "fixedarraytest.h"
 #include "fixedtabletest.h"
 #include "hashtabletest.h"
+#include "slotmaptest.h"
 #include "queuetest.h"
+#include "messagequeuetest.h"
 #include "memorystreamtest.h"
 #include "guidtest.h"
 #include "fileservertest.h"
@@ -33,8 +35,11 @@
 #include "streamservertest.h"
 #include "luaservertest.h"
 #include "zipfstest.h"
+#include "zipblockcodectest.h"
+#include "n3archivetest.h"
 #include "float4test.h"
 #include "matrix44test.h"
+#include "mathtest.h"
 #include "threadtest.h"
 #include "memorypooltest.h"
 #include "runlengthcodectest.h"
@@ -78,8 +83,11 @@ __cdecl main()
     testRunner->AttachTestCase(RunLengthCodecTest::Create());
     testRunner->AttachTestCase(MemoryPoolTest::Create());
     testRunner->AttachTestCase(Matrix44Test::Create());
+    testRunner->AttachTestCase(MathTest::Create());
     testRunner->AttachTestCase(Float4Test::Create());
     testRunner->AttachTestCase(ZipFSTest::Create());
+    testRunner->AttachTestCase(ZipBlockCodecTest::Create());
+    testRunner->AttachTestCase(N3ArchiveTest::Create());
     testRunner->AttachTestCase(LuaServerTest::Create());
     testRunner->AttachTestCase(StreamServerTest::Create());
     testRunner->AttachTestCase(CmdLineArgsTest::Create());
@@ -93,7 +101,9 @@ __cdecl main()
     testRunner->AttachTestCase(FixedArrayTest::Create());
     testRunner->AttachTestCase(FixedTableTest::Create());
     testRunner->AttachTestCase(HashTableTest::Create());
+    testRunner->AttachTestCase(SlotMapTest::Create());
     testRunner->AttachTestCase(QueueTest::Create());
+    testRunner->AttachTestCase(MessageQueueTest::Create());
     testRunner->AttachTestCase(MemoryStreamTest::Create());
     testRunner->AttachTestCase(GuidTest::Create());
     testRunner->AttachTestCase(FileServerTest::Create());
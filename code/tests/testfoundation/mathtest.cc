@@ -0,0 +1,247 @@
+//------------------------------------------------------------------------------
+//  mathtest.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "mathtest.h"
+#include "math/matrix44.h"
+#include "math/quaternion.h"
+#include "math/plane.h"
+#include "math/batch.h"
+#include "math/sse/sse_ops.h"
+
+namespace Test
+{
+__ImplementClass(Test::MathTest, 'MATS', Test::TestCase);
+
+using namespace Math;
+
+// number of floats written by the MathTestResults functions
+static const SizeT NumMathTestResults = 4 * 24 + 16 * 4 + 2;
+
+//------------------------------------------------------------------------------
+/**
+    Defines a function which feeds the same input through all vector
+    primitives of one primitive set (ScalarOps, SSE41Ops or AVX2Ops)
+    and writes the results into a float array.
+*/
+#define __MathTestResults(OPS) \
+static void \
+OPS##Results(const float* in, float* out) \
+{ \
+    OPS::mat44 m; \
+    m.r[0] = OPS::loadu(in); \
+    m.r[1] = OPS::loadu(in + 4); \
+    m.r[2] = OPS::loadu(in + 8); \
+    m.r[3] = OPS::loadu(in + 12); \
+    OPS::mat44 m1; \
+    m1.r[0] = OPS::loadu(in + 16); \
+    m1.r[1] = OPS::loadu(in + 20); \
+    m1.r[2] = OPS::loadu(in + 24); \
+    m1.r[3] = OPS::loadu(in + 28); \
+    OPS::vec4 a = m.r[0]; \
+    OPS::vec4 b = m.r[1]; \
+    OPS::vec4 c = m.r[2]; \
+    OPS::storeu(out, OPS::add(a, b)); out += 4; \
+    OPS::storeu(out, OPS::sub(a, b)); out += 4; \
+    OPS::storeu(out, OPS::mul(a, b)); out += 4; \
+    OPS::storeu(out, OPS::div(a, b)); out += 4; \
+    OPS::storeu(out, OPS::scale(a, 3.0f)); out += 4; \
+    OPS::storeu(out, OPS::madd(a, b, c)); out += 4; \
+    OPS::storeu(out, OPS::negate(a)); out += 4; \
+    OPS::storeu(out, OPS::abs(a)); out += 4; \
+    OPS::storeu(out, OPS::min(a, b)); out += 4; \
+    OPS::storeu(out, OPS::max(a, b)); out += 4; \
+    OPS::storeu(out, OPS::reciprocal(a)); out += 4; \
+    OPS::storeu(out, OPS::sqrt(OPS::abs(a))); out += 4; \
+    OPS::storeu(out, OPS::splatx(a)); out += 4; \
+    OPS::storeu(out, OPS::splaty(a)); out += 4; \
+    OPS::storeu(out, OPS::splatz(a)); out += 4; \
+    OPS::storeu(out, OPS::splatw(a)); out += 4; \
+    OPS::storeu(out, OPS::dot3(a, b)); out += 4; \
+    OPS::storeu(out, OPS::dot4(a, b)); out += 4; \
+    OPS::storeu(out, OPS::cross3(a, b)); out += 4; \
+    OPS::storeu(out, OPS::set(OPS::getx(a), OPS::gety(a), OPS::getz(a), OPS::getw(a))); out += 4; \
+    OPS::storeu(out, OPS::setx(OPS::sety(a, 1.0f), 2.0f)); out += 4; \
+    OPS::storeu(out, OPS::setz(OPS::setw(a, 3.0f), 4.0f)); out += 4; \
+    OPS::storeu(out, OPS::transform(c, m)); out += 4; \
+    OPS::storeu(out, OPS::set(float(OPS::cmpeq(a, a)), float(OPS::cmplt(a, b)), float(OPS::cmple(a, b)), float(OPS::cmpgt(a, b) | (OPS::cmpge(a, b) << 4)))); out += 4; \
+    IndexT i; \
+    OPS::mat44 mul = OPS::multiply(m, m1); \
+    OPS::mat44 trans = OPS::transpose(m); \
+    OPS::mat44 inv = OPS::inverse(m); \
+    OPS::mat44 ident = OPS::identity(); \
+    for (i = 0; i < 4; i++) \
+    { \
+        OPS::storeu(out, mul.r[i]); \
+        OPS::storeu(out + 16, trans.r[i]); \
+        OPS::storeu(out + 32, inv.r[i]); \
+        OPS::storeu(out + 48, ident.r[i]); \
+        out += 4; \
+    } \
+    out += 48; \
+    out[0] = OPS::determinant(m); \
+    out[1] = OPS::determinant(m1); \
+}
+
+__MathTestResults(ScalarOps);
+#if NEBULA3_MATH_HAS_SSE41
+__MathTestResults(SSE41Ops);
+#endif
+#if NEBULA3_MATH_HAS_AVX2
+__MathTestResults(AVX2Ops);
+#endif
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+MathTest::Compare(const float* res0, const float* res1, SizeT num, float eps) const
+{
+    IndexT i;
+    for (i = 0; i < num; i++)
+    {
+        float tolerance = eps * (1.0f + n_abs(res0[i]) + n_abs(res1[i]));
+        if (n_abs(res0[i] - res1[i]) > tolerance)
+        {
+            n_printf("MathTest: result %d differs: %f != %f\n", i, res0[i], res1[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+MathTest::NearEqual(const matrix44& m0, const matrix44& m1, float eps) const
+{
+    NEBULA3_ALIGN16 float f0[16];
+    NEBULA3_ALIGN16 float f1[16];
+    m0.store(f0);
+    m1.store(f1);
+    return this->Compare(f0, f1, 16, eps);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+MathTest::Run()
+{
+    // compare the primitive sets against the scalar reference, the
+    // input matrices are well conditioned so that the inverse
+    // can be compared with a small tolerance
+    float in[32];
+    float scalarRes[NumMathTestResults];
+    float simdRes[NumMathTestResults];
+    IndexT iter;
+    for (iter = 0; iter < 256; iter++)
+    {
+        IndexT i;
+        for (i = 0; i < 32; i++)
+        {
+            in[i] = n_rand(-1.0f, 1.0f);
+            if ((i & 3) == ((i >> 2) & 3))
+            {
+                in[i] += 4.0f;
+            }
+        }
+        ScalarOpsResults(in, scalarRes);
+        #if NEBULA3_MATH_HAS_SSE41
+        SSE41OpsResults(in, simdRes);
+        this->Verify(this->Compare(scalarRes, simdRes, NumMathTestResults, 0.0001f));
+        #endif
+        #if NEBULA3_MATH_HAS_AVX2
+        AVX2OpsResults(in, simdRes);
+        this->Verify(this->Compare(scalarRes, simdRes, NumMathTestResults, 0.0001f));
+        #endif
+    }
+
+    // inverse and determinant
+    matrix44 m = matrix44::transformation(float4(0.0f, 0.0f, 0.0f, 0.0f), quaternion::identity(), float4(2.0f, 3.0f, 4.0f, 0.0f),
+                                          float4(0.0f, 0.0f, 0.0f, 0.0f), quaternion::rotationyawpitchroll(0.3f, 0.5f, 0.7f), float4(1.0f, 2.0f, 3.0f, 0.0f));
+    this->Verify(this->NearEqual(matrix44::multiply(m, matrix44::inverse(m)), matrix44::identity(), 0.0001f));
+    this->Verify(n_abs(m.determinant() - 24.0f) < 0.001f);
+
+    // rotations
+    matrix44 rot = matrix44::rotationyawpitchroll(0.3f, 0.5f, 0.7f);
+    matrix44 rotProduct = matrix44::multiply(matrix44::multiply(matrix44::rotationz(0.7f), matrix44::rotationx(0.5f)), matrix44::rotationy(0.3f));
+    this->Verify(this->NearEqual(rot, rotProduct, 0.0001f));
+    quaternion q = quaternion::rotationmatrix(rot);
+    this->Verify(this->NearEqual(matrix44::rotationquaternion(q), rot, 0.0001f));
+    quaternion qx = quaternion::rotationaxis(float4(1.0f, 0.0f, 0.0f, 0.0f), 0.5f);
+    quaternion qz = quaternion::rotationaxis(float4(0.0f, 0.0f, 1.0f, 0.0f), 0.7f);
+    this->Verify(this->NearEqual(matrix44::rotationquaternion(qx), matrix44::rotationx(0.5f), 0.0001f));
+    this->Verify(this->NearEqual(matrix44::rotationquaternion(quaternion::multiply(qz, qx)), matrix44::multiply(matrix44::rotationz(0.7f), matrix44::rotationx(0.5f)), 0.0001f));
+    quaternion qHalf = quaternion::slerp(quaternion::identity(), qx, 0.5f);
+    this->Verify(this->NearEqual(matrix44::rotationquaternion(qHalf), matrix44::rotationx(0.25f), 0.0001f));
+
+    // decompose
+    float4 scale;
+    quaternion rotation;
+    float4 translation;
+    m.decompose(scale, rotation, translation);
+    this->Verify(float4::nearequal4(scale, float4(2.0f, 3.0f, 4.0f, 0.0f), float4(0.0001f, 0.0001f, 0.0001f, 0.0001f)));
+    this->Verify(float4::nearequal4(translation, float4(1.0f, 2.0f, 3.0f, 0.0f), float4(0.0001f, 0.0001f, 0.0001f, 0.0001f)));
+    this->Verify(this->NearEqual(matrix44::rotationquaternion(rotation), rot, 0.0001f));
+
+    // planes
+    plane p(point(0.0f, 1.0f, 0.0f), point(1.0f, 1.0f, 0.0f), point(0.0f, 1.0f, 1.0f));
+    this->Verify(n_abs(p.dot(point(5.0f, 1.0f, 3.0f))) < 0.0001f);
+    float4 isect;
+    this->Verify(p.intersectline(point(0.0f, 0.0f, 0.0f), point(0.0f, 2.0f, 0.0f), isect));
+    this->Verify(n_abs(isect.y() - 1.0f) < 0.0001f);
+    float4 reflected = matrix44::transform(point(0.0f, 3.0f, 0.0f), matrix44::reflect(plane(0.0f, 1.0f, 0.0f, -1.0f)));
+    this->Verify(n_abs(reflected.y() + 1.0f) < 0.0001f);
+
+    // batch kernels against the per-value functions
+    const SizeT NumBatch = 37;
+    matrix44 matrices[NumBatch];
+    matrix44 batchMatrices[NumBatch];
+    bbox boxes[NumBatch];
+    bbox batchBoxes[NumBatch];
+    ClipStatus::Type batchStatus[NumBatch];
+    quaternion q0[NumBatch];
+    quaternion q1[NumBatch];
+    quaternion batchQuaternions[NumBatch];
+    IndexT i;
+    for (i = 0; i < NumBatch; i++)
+    {
+        q0[i] = quaternion::rotationyawpitchroll(n_rand(-N_PI, N_PI), n_rand(-N_PI, N_PI), n_rand(-N_PI, N_PI));
+        q1[i] = quaternion::rotationyawpitchroll(n_rand(-N_PI, N_PI), n_rand(-N_PI, N_PI), n_rand(-N_PI, N_PI));
+        matrices[i] = matrix44::rotationquaternion(q0[i]);
+        matrices[i].setrow3(float4(n_rand(-10.0f, 10.0f), n_rand(-10.0f, 10.0f), n_rand(-10.0f, 10.0f), 1.0f));
+        boxes[i].set(point(n_rand(-10.0f, 10.0f), n_rand(-10.0f, 10.0f), n_rand(-10.0f, 10.0f)), vector(1.0f, 2.0f, 0.5f));
+    }
+    Batch::MultiplyMatrices(matrices, rot, batchMatrices, NumBatch);
+    Batch::TransformBoxes(boxes, matrices, batchBoxes, NumBatch);
+    Batch::SlerpQuaternions(q0, q1, 0.3f, batchQuaternions, NumBatch);
+    for (i = 0; i < NumBatch; i++)
+    {
+        this->Verify(this->NearEqual(batchMatrices[i], matrix44::multiply(matrices[i], rot), 0.0001f));
+        bbox box = boxes[i];
+        box.transform(matrices[i]);
+        this->Verify(float4::nearequal4(box.pmin, batchBoxes[i].pmin, float4(0.001f, 0.001f, 0.001f, 0.001f)));
+        this->Verify(float4::nearequal4(box.pmax, batchBoxes[i].pmax, float4(0.001f, 0.001f, 0.001f, 0.001f)));
+        quaternion slerped = quaternion::slerp(q0[i], q1[i], 0.3f);
+        this->Verify(float4::nearequal4(float4(slerped.x(), slerped.y(), slerped.z(), slerped.w()),
+                                        float4(batchQuaternions[i].x(), batchQuaternions[i].y(), batchQuaternions[i].z(), batchQuaternions[i].w()),
+                                        float4(0.00001f, 0.00001f, 0.00001f, 0.00001f)));
+    }
+
+    // boxes in front of a camera looking down -z
+    matrix44 viewProj = matrix44::perspfovrh(n_deg2rad(60.0f), 1.0f, 0.1f, 100.0f);
+    for (i = 0; i < NumBatch; i++)
+    {
+        boxes[i].set(point(n_rand(-30.0f, 30.0f), n_rand(-30.0f, 30.0f), n_rand(-120.0f, -1.0f)), vector(1.0f, 2.0f, 0.5f));
+    }
+    Batch::ClipBoxes(viewProj, boxes, batchStatus, NumBatch);
+    for (i = 0; i < NumBatch; i++)
+    {
+        this->Verify(boxes[i].clipstatus(viewProj) == batchStatus[i]);
+    }
+}
+
+} // namespace Test
@@ -0,0 +1,36 @@
+#pragma once
+#ifndef TEST_MATHTEST_H
+#define TEST_MATHTEST_H
+//------------------------------------------------------------------------------
+/**
+    @class Test::MathTest
+    
+    Compares the vector primitives of the portable math backend (scalar
+    reference, SSE4.1 and AVX2/FMA) against each other, and checks
+    some identities of the math classes.
+    
+    (C) 2010 Radon Labs GmbH
+*/
+#include "testbase/testcase.h"
+#include "math/matrix44.h"
+
+//------------------------------------------------------------------------------
+namespace Test
+{
+class MathTest : public TestCase
+{
+    __DeclareClass(MathTest);
+public:
+    /// run the test
+    virtual void Run();
+
+private:
+    /// compare two result arrays with a relative tolerance
+    bool Compare(const float* res0, const float* res1, SizeT num, float eps) const;
+    /// return true if two matrices are equal within a tolerance
+    bool NearEqual(const Math::matrix44& m0, const Math::matrix44& m1, float eps) const;
+};
+
+}; // namespace Test
+//------------------------------------------------------------------------------
+#endif        
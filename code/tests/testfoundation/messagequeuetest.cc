@@ -0,0 +1,101 @@
+//------------------------------------------------------------------------------
+//  messagequeuetest.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "messagequeuetest.h"
+#include "messaging/messagequeue.h"
+
+namespace Test
+{
+__ImplementClass(Test::MessageQueueTest, 'MSQT', Test::TestCase);
+
+using namespace Util;
+using namespace Messaging;
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+MessageQueueTest::Run()
+{
+    MessageQueue queue;
+    this->Verify(queue.IsEmpty());
+    this->Verify(queue.IsSignalOnEnqueueEnabled());
+
+    Ptr<Message> msg0 = Message::Create();
+    Ptr<Message> msg1 = Message::Create();
+    Ptr<Message> msg2 = Message::Create();
+
+    // the queue holds a reference to queued messages
+    queue.Enqueue(msg0);
+    queue.Enqueue(msg1);
+    queue.Enqueue(msg2);
+    this->Verify(!queue.IsEmpty());
+    this->Verify(msg0->GetRefCount() == 2);
+
+    // messages must come out in sending order
+    Array<Ptr<Message> > msgArray;
+    queue.DequeueAll(msgArray);
+    this->Verify(queue.IsEmpty());
+    this->Verify(msgArray.Size() == 3);
+    this->Verify(msgArray[0] == msg0);
+    this->Verify(msgArray[1] == msg1);
+    this->Verify(msgArray[2] == msg2);
+    this->Verify(msg0->GetRefCount() == 2);
+    msgArray.Clear();
+    this->Verify(msg0->GetRefCount() == 1);
+
+    // cancelled messages are dropped
+    queue.Enqueue(msg0);
+    queue.Enqueue(msg1);
+    queue.Enqueue(msg2);
+    queue.Cancel(msg1);
+    queue.DequeueAll(msgArray);
+    this->Verify(msgArray.Size() == 2);
+    this->Verify(msgArray[0] == msg0);
+    this->Verify(msgArray[1] == msg2);
+    this->Verify(msg1->GetRefCount() == 1);
+
+    // a cancelled message can be sent again
+    queue.Enqueue(msg1);
+    queue.DequeueAll(msgArray);
+    this->Verify(msgArray.Size() == 1);
+    this->Verify(msgArray[0] == msg1);
+
+    // dequeued messages can be sent again, also in a different order
+    queue.Enqueue(msg0);
+    queue.Enqueue(msg1);
+    queue.DequeueAll(msgArray);
+    this->Verify(msgArray.Size() == 2);
+    queue.Enqueue(msg1);
+    queue.Enqueue(msg0);
+    queue.Enqueue(msg2);
+    queue.DequeueAll(msgArray);
+    this->Verify(msgArray.Size() == 3);
+    this->Verify(msgArray[0] == msg1);
+    this->Verify(msgArray[1] == msg0);
+    this->Verify(msgArray[2] == msg2);
+    msgArray.Clear();
+    this->Verify(msg0->GetRefCount() == 1);
+    this->Verify(msg1->GetRefCount() == 1);
+
+    // dequeueing an empty queue
+    queue.DequeueAll(msgArray);
+    this->Verify(msgArray.IsEmpty());
+
+    // the queue releases pending messages when destroyed
+    MessageQueue* tmpQueue = n_new(MessageQueue);
+    tmpQueue->Enqueue(msg2);
+    this->Verify(msg2->GetRefCount() == 2);
+    n_delete(tmpQueue);
+    this->Verify(msg2->GetRefCount() == 1);
+
+    // ...after which the messages can be sent to another queue
+    queue.Enqueue(msg2);
+    queue.DequeueAll(msgArray);
+    this->Verify(msgArray.Size() == 1);
+    this->Verify(msgArray[0] == msg2);
+}
+
+}; // namespace Test
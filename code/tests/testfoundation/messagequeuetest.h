@@ -0,0 +1,26 @@
+#ifndef TESTS_MESSAGEQUEUETEST_H
+#define TESTS_MESSAGEQUEUETEST_H
+//------------------------------------------------------------------------------
+/**
+    @class Test::MessageQueueTest
+
+    Test the lock-free Messaging::MessageQueue.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "testbase/testcase.h"
+
+//------------------------------------------------------------------------------
+namespace Test
+{
+class MessageQueueTest : public TestCase
+{
+    __DeclareClass(MessageQueueTest);
+public:
+    /// run the test
+    virtual void Run();
+};
+
+};
+//------------------------------------------------------------------------------
+#endif    
\ No newline at end of file
@@ -0,0 +1,139 @@
+//------------------------------------------------------------------------------
+//  n3archivetest.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "n3archivetest.h"
+#include "io/ioserver.h"
+#include "io/n3fs/n3archive.h"
+#include "io/n3fs/n3archivewriter.h"
+#include "io/zipfs/zipblockcodec.h"
+
+namespace Test
+{
+__ImplementClass(Test::N3ArchiveTest, 'N3AT', Test::TestCase);
+
+using namespace IO;
+using namespace Util;
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+N3ArchiveTest::Run()
+{
+    Ptr<IoServer> ioServer = IoServer::Create();
+    ioServer->CreateDirectory("temp:n3archivetest/src");
+
+    // a compressible and an incompressible source file
+    const SizeT textSize = 100000;
+    const SizeT noiseSize = 1000;
+    uchar* textData = (uchar*) Memory::Alloc(Memory::ScratchHeap, textSize);
+    uchar* noiseData = (uchar*) Memory::Alloc(Memory::ScratchHeap, noiseSize);
+    uint seed = 4711;
+    IndexT i;
+    for (i = 0; i < textSize; i++)
+    {
+        textData[i] = uchar('a' + (i % 7));
+    }
+    for (i = 0; i < noiseSize; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        noiseData[i] = uchar(seed >> 16);
+    }
+    Ptr<Stream> stream = ioServer->CreateStream("temp:n3archivetest/src/text.txt");
+    stream->SetAccessMode(Stream::WriteAccess);
+    this->Verify(stream->Open());
+    stream->Write(textData, textSize);
+    stream->Close();
+    stream = ioServer->CreateStream("temp:n3archivetest/src/noise.bin");
+    stream->SetAccessMode(Stream::WriteAccess);
+    this->Verify(stream->Open());
+    stream->Write(noiseData, noiseSize);
+    stream->Close();
+
+    // write an archive with 2 directories
+    N3ArchiveWriter writer;
+    writer.SetByteOrder(System::ByteOrder::LittleEndian);
+    writer.AddFile("test/data/text.txt", "temp:n3archivetest/src/text.txt", true);
+    writer.AddFile("test/data/noise.bin", "temp:n3archivetest/src/noise.bin", true);
+    writer.AddFile("test/stored.txt", "temp:n3archivetest/src/text.txt", false);
+    this->Verify(writer.Write("temp:n3archivetest/archive.n3a"));
+
+    // mount the archive and check lookups
+    Ptr<N3Archive> archive = N3Archive::Create();
+    this->Verify(archive->Setup("temp:n3archivetest/archive"));
+    this->Verify(archive->GetNumEntries() == 6);
+    this->Verify(0 != archive->FindDirEntry(""));
+    this->Verify(0 != archive->FindDirEntry("test"));
+    this->Verify(0 != archive->FindDirEntry("test/data/"));
+    this->Verify(0 == archive->FindDirEntry("test/stored.txt"));
+    this->Verify(0 == archive->FindFileEntry("test/data"));
+    this->Verify(0 == archive->FindFileEntry("test/data/missing.txt"));
+    this->Verify(0 == archive->FindFileEntry("test/data/text.tx"));
+    const N3ArchiveEntry* textEntry = archive->FindFileEntry("test/data/text.txt");
+    const N3ArchiveEntry* noiseEntry = archive->FindFileEntry("test\\data\\noise.bin");
+    const N3ArchiveEntry* storedEntry = archive->FindFileEntry("/test/stored.txt");
+    this->Verify(0 != textEntry);
+    this->Verify(0 != noiseEntry);
+    this->Verify(0 != storedEntry);
+    if ((0 != textEntry) && (0 != noiseEntry) && (0 != storedEntry))
+    {
+        this->Verify(String(archive->GetEntryName(textEntry)) == "text.txt");
+        this->Verify(String(archive->GetEntryPath(textEntry)) == "test/data/text.txt");
+
+        // compressible file must be block-compressed, the others stored
+        this->Verify(0 != (textEntry->flags & N3ArchiveBlockCompressed));
+        this->Verify(textEntry->fileSize == textSize);
+        this->Verify(textEntry->dataSize < textSize);
+        this->Verify(0 == (noiseEntry->flags & N3ArchiveBlockCompressed));
+        this->Verify(0 == (storedEntry->flags & N3ArchiveBlockCompressed));
+        this->Verify(0 == (storedEntry->dataOffset % N3ArchiveDataAlignment));
+
+        // read stored data
+        uchar* buf = (uchar*) Memory::Alloc(Memory::ScratchHeap, textSize);
+        this->Verify(archive->ReadData(noiseEntry, buf, noiseSize, 0));
+        this->Verify(0 == memcmp(buf, noiseData, noiseSize));
+        this->Verify(archive->ReadData(storedEntry, buf, 100, 500));
+        this->Verify(0 == memcmp(buf, textData + 500, 100));
+
+        // decompress the compressed file
+        uchar* compressedData = (uchar*) Memory::Alloc(Memory::ScratchHeap, textEntry->dataSize);
+        this->Verify(archive->ReadData(textEntry, compressedData, textEntry->dataSize, 0));
+        ZipBlockCodec::Header header;
+        this->Verify(ZipBlockCodec::DecodeHeader(compressedData, textEntry->dataSize, header));
+        FixedArray<uint> blockOffsets;
+        ZipBlockCodec::DecodeSeekTable(compressedData + ZipBlockCodec::HeaderSize, header, blockOffsets);
+        bool dataEqual = true;
+        for (i = 0; i < (IndexT)header.numBlocks; i++)
+        {
+            SizeT blockBytes = ZipBlockCodec::GetUncompressedBlockSize(header, i);
+            this->Verify(ZipBlockCodec::DecodeBlock(compressedData + blockOffsets[i], blockOffsets[i + 1] - blockOffsets[i], buf, blockBytes));
+            dataEqual &= (0 == memcmp(buf, textData + i * header.blockSize, blockBytes));
+        }
+        this->Verify(dataEqual);
+        Memory::Free(Memory::ScratchHeap, compressedData);
+        Memory::Free(Memory::ScratchHeap, buf);
+    }
+
+    // directory listing
+    Array<String> files = archive->ListFiles("test/data", "*");
+    this->Verify(files.Size() == 2);
+    this->Verify(InvalidIndex != files.FindIndex("text.txt"));
+    this->Verify(InvalidIndex != files.FindIndex("noise.bin"));
+    files = archive->ListFiles("test", "*.txt");
+    this->Verify(files.Size() == 1);
+    Array<String> dirs = archive->ListDirectories("test", "*");
+    this->Verify(dirs.Size() == 1);
+    this->Verify(dirs[0] == "data");
+    dirs = archive->ListDirectories("", "*");
+    this->Verify(dirs.Size() == 1);
+    this->Verify(dirs[0] == "test");
+
+    archive->Discard();
+    archive = 0;
+    Memory::Free(Memory::ScratchHeap, textData);
+    Memory::Free(Memory::ScratchHeap, noiseData);
+}
+
+} // namespace Test
@@ -0,0 +1,26 @@
+#ifndef TEST_N3ARCHIVETEST_H
+#define TEST_N3ARCHIVETEST_H
+//------------------------------------------------------------------------------
+/**
+    @class Test::N3ArchiveTest
+    
+    Test writing and reading Nebula3 archives.
+    
+    (C) 2010 Radon Labs GmbH
+*/
+#include "testbase/testcase.h"
+
+//------------------------------------------------------------------------------
+namespace Test
+{
+class N3ArchiveTest : public TestCase
+{
+    __DeclareClass(N3ArchiveTest);
+public:
+    /// run the test
+    virtual void Run();
+};
+
+} // namespace Test
+//------------------------------------------------------------------------------
+#endif
@@ -0,0 +1,111 @@
+//------------------------------------------------------------------------------
+//  slotmaptest.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "slotmaptest.h"
+#include "util/slotmap.h"
+
+namespace Test
+{
+__ImplementClass(Test::SlotMapTest, 'SLMT', Test::TestCase);
+
+using namespace Util;
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+SlotMapTest::Run()
+{
+    typedef SlotMap<int>::Handle Handle;
+    IndexT i;
+
+    SlotMap<int> slotMap;
+    this->Verify(slotMap.IsEmpty());
+    this->Verify(!slotMap.IsValid(SlotMap<int>::InvalidHandle));
+
+    // Add and lookup
+    Handle h0 = slotMap.Add(0);
+    Handle h1 = slotMap.Add(1);
+    Handle h2 = slotMap.Add(2);
+    Handle h3 = slotMap.Add(3);
+    this->Verify(slotMap.Size() == 4);
+    this->Verify(slotMap.IsValid(h0));
+    this->Verify(slotMap.IsValid(h1));
+    this->Verify(slotMap.IsValid(h2));
+    this->Verify(slotMap.IsValid(h3));
+    this->Verify(slotMap[h0] == 0);
+    this->Verify(slotMap[h2] == 2);
+    slotMap[h2] = 20;
+    this->Verify(slotMap.ValueAtIndex(2) == 20);
+    this->Verify(slotMap.HandleAtIndex(2) == h2);
+
+    // Erase moves the last value into the gap
+    slotMap.Erase(h1);
+    this->Verify(!slotMap.IsValid(h1));
+    this->Verify(slotMap.Size() == 3);
+    this->Verify(slotMap.ValueAtIndex(0) == 0);
+    this->Verify(slotMap.ValueAtIndex(1) == 3);
+    this->Verify(slotMap.ValueAtIndex(2) == 20);
+    this->Verify(slotMap.HandleAtIndex(1) == h3);
+    this->Verify(slotMap[h3] == 3);
+
+    // erasing the last value doesn't move anything
+    slotMap.Erase(h2);
+    this->Verify(!slotMap.IsValid(h2));
+    this->Verify(slotMap.Size() == 2);
+    this->Verify(slotMap.ValueAtIndex(0) == 0);
+    this->Verify(slotMap.ValueAtIndex(1) == 3);
+    this->Verify(slotMap.HandleAtIndex(0) == h0);
+    this->Verify(slotMap.HandleAtIndex(1) == h3);
+
+    // freed slots are reused, the stale handles remain invalid
+    Handle h4 = slotMap.Add(4);
+    Handle h5 = slotMap.Add(5);
+    this->Verify(slotMap.Size() == 4);
+    this->Verify((h4 != h1) && (h4 != h2));
+    this->Verify((h5 != h1) && (h5 != h2));
+    this->Verify(!slotMap.IsValid(h1));
+    this->Verify(!slotMap.IsValid(h2));
+    this->Verify(slotMap[h4] == 4);
+    this->Verify(slotMap[h5] == 5);
+    this->Verify(slotMap.HandleAtIndex(2) == h4);
+    this->Verify(slotMap.HandleAtIndex(3) == h5);
+
+    // Clear invalidates all handles
+    slotMap.Clear();
+    this->Verify(slotMap.IsEmpty());
+    this->Verify(!slotMap.IsValid(h0));
+    this->Verify(!slotMap.IsValid(h3));
+    this->Verify(!slotMap.IsValid(h4));
+    this->Verify(!slotMap.IsValid(h5));
+    Handle h6 = slotMap.Add(6);
+    this->Verify(slotMap.IsValid(h6));
+    this->Verify((h6 != h0) && (h6 != h3) && (h6 != h4) && (h6 != h5));
+    this->Verify(!slotMap.IsValid(h0));
+    this->Verify(slotMap[h6] == 6);
+
+    // a slot which is reused over and over gets new handles until
+    // its generation wraps around after 4096 reuses
+    SlotMap<int> wrapMap;
+    Handle first = wrapMap.Add(0);
+    Handle handle = first;
+    bool allStale = true;
+    for (i = 1; i < 4096; i++)
+    {
+        wrapMap.Erase(handle);
+        handle = wrapMap.Add(i);
+        allStale &= (handle != first) && !wrapMap.IsValid(first) && wrapMap.IsValid(handle);
+    }
+    this->Verify(allStale);
+    this->Verify(wrapMap.Size() == 1);
+    wrapMap.Erase(handle);
+    this->Verify(!wrapMap.IsValid(handle));
+    handle = wrapMap.Add(4096);
+    this->Verify(handle == first);
+    this->Verify(wrapMap.Size() == 1);
+    this->Verify(wrapMap[first] == 4096);
+}
+
+}; // namespace Test
@@ -0,0 +1,26 @@
+#ifndef TESTS_SLOTMAPTEST_H
+#define TESTS_SLOTMAPTEST_H
+//------------------------------------------------------------------------------
+/**
+    @class Test::SlotMapTest
+
+    Test Util::SlotMap functionality.
+
+    (C) 2010 Radon Labs GmbH
+*/
+#include "testbase/testcase.h"
+
+//------------------------------------------------------------------------------
+namespace Test
+{
+class SlotMapTest : public TestCase
+{
+    __DeclareClass(SlotMapTest);
+public:
+    /// run the test
+    virtual void Run();
+};
+
+};
+//------------------------------------------------------------------------------
+#endif
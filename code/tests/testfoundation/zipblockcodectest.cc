@@ -0,0 +1,81 @@
+//------------------------------------------------------------------------------
+//  zipblockcodectest.cc
+//  (C) 2010 Radon Labs GmbH
+//------------------------------------------------------------------------------
+#include "stdneb.h"
+#include "zipblockcodectest.h"
+#include "io/zipfs/zipblockcodec.h"
+#include "io/memorystream.h"
+
+namespace Test
+{
+__ImplementClass(Test::ZipBlockCodecTest, 'ZBCT', Test::TestCase);
+
+using namespace IO;
+using namespace Util;
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+ZipBlockCodecTest::Run()
+{
+    // source data with a compressible and a random part, 
+    // the last block is only partially filled
+    const SizeT blockSize = 1024;
+    const SizeT srcSize = 5 * blockSize + 100;
+    uchar* srcData = (uchar*) Memory::Alloc(Memory::ScratchHeap, srcSize);
+    uint seed = 12345;
+    IndexT i;
+    for (i = 0; i < srcSize; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        srcData[i] = (i < 3 * blockSize) ? uchar(i / 64) : uchar(seed >> 16);
+    }
+
+    // encode into a memory stream
+    Ptr<MemoryStream> stream = MemoryStream::Create();
+    stream->SetAccessMode(Stream::WriteAccess);
+    this->Verify(stream->Open());
+    this->Verify(ZipBlockCodec::Encode(srcData, srcSize, stream.upcast<Stream>(), blockSize));
+    SizeT encodedSize = stream->GetSize();
+    const uchar* encodedData = (const uchar*) stream->GetRawPointer();
+
+    // check header
+    ZipBlockCodec::Header header;
+    this->Verify(ZipBlockCodec::DecodeHeader(encodedData, encodedSize, header));
+    this->Verify(header.blockSize == blockSize);
+    this->Verify(header.uncompressedSize == srcSize);
+    this->Verify(header.numBlocks == 6);
+    this->Verify(ZipBlockCodec::GetUncompressedBlockSize(header, 0) == blockSize);
+    this->Verify(ZipBlockCodec::GetUncompressedBlockSize(header, 5) == 100);
+    this->Verify(!ZipBlockCodec::DecodeHeader(srcData, srcSize, header));
+    this->Verify(!ZipBlockCodec::DecodeHeader(encodedData, ZipBlockCodec::HeaderSize, header));
+
+    // check seek table, compressible blocks must have been compressed,
+    // random blocks must have been stored
+    FixedArray<uint> blockOffsets;
+    ZipBlockCodec::DecodeSeekTable(encodedData + ZipBlockCodec::HeaderSize, header, blockOffsets);
+    this->Verify(blockOffsets.Size() == 7);
+    this->Verify(blockOffsets[0] == ZipBlockCodec::HeaderSize + ZipBlockCodec::GetSeekTableSize(header));
+    this->Verify(blockOffsets[6] == encodedSize);
+    this->Verify((blockOffsets[1] - blockOffsets[0]) < blockSize);
+    this->Verify((blockOffsets[4] - blockOffsets[3]) == blockSize);
+
+    // decode every block independently, in reverse order
+    uchar decodeBuffer[blockSize];
+    bool blocksEqual = true;
+    for (i = header.numBlocks - 1; i >= 0; i--)
+    {
+        SizeT blockBytes = ZipBlockCodec::GetUncompressedBlockSize(header, i);
+        Memory::Clear(decodeBuffer, blockSize);
+        this->Verify(ZipBlockCodec::DecodeBlock(encodedData + blockOffsets[i], blockOffsets[i + 1] - blockOffsets[i], decodeBuffer, blockBytes));
+        blocksEqual &= (0 == memcmp(decodeBuffer, srcData + i * blockSize, blockBytes));
+    }
+    this->Verify(blocksEqual);
+
+    stream->Close();
+    Memory::Free(Memory::ScratchHeap, srcData);
+}
+
+} // namespace Test
@@ -0,0 +1,26 @@
+#ifndef TEST_ZIPBLOCKCODECTEST_H
+#define TEST_ZIPBLOCKCODECTEST_H
+//------------------------------------------------------------------------------
+/**
+    @class Test::ZipBlockCodecTest
+    
+    Test encoding and decoding of block-compressed files.
+    
+    (C) 2010 Radon Labs GmbH
+*/
+#include "testbase/testcase.h"
+
+//------------------------------------------------------------------------------
+namespace Test
+{
+class ZipBlockCodecTest : public TestCase
+{
+    __DeclareClass(ZipBlockCodecTest);
+public:
+    /// run the test
+    virtual void Run();
+};
+
+} // namespace Test
+//------------------------------------------------------------------------------
+#endif
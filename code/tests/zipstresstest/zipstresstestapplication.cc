@@ -6,12 +6,14 @@
 #include "zipstresstestapplication.h"
 #include "threading/thread.h"
 #include "io/stream.h"
+#include "timing/timer.h"
 
 namespace App
 {
 using namespace Util;
 using namespace IO;
 using namespace Threading;
+using namespace Timing;
 
 // thread subclass for file reading
 class ReaderThread : public Threading::Thread
@@ -19,13 +21,19 @@ class ReaderThread : public Threading::Thread
     __DeclareClass(ReaderThread);
 public:
     /// constructor
-    ReaderThread() : loopCount(0) {};
+    ReaderThread() : loopCount(0), numBytesRead(0.0) {};
     /// setup the directory and file pattern
     void Setup(SizeT loopCount_, const String& path_, const String& pattern_)
     {
         this->loopCount = loopCount_;
         this->path = path_;
         this->pattern = pattern_;
+        this->numBytesRead = 0.0;
+    };
+    /// get number of bytes read by the thread
+    double GetNumBytesRead() const
+    {
+        return this->numBytesRead;
     };
 
 protected:
@@ -36,6 +44,7 @@ private:
     SizeT loopCount;
     String path;
     String pattern;
+    double numBytesRead;
 };
 __ImplementClass(App::ReaderThread, 'RTHR', Threading::Thread);
 
@@ -57,17 +66,19 @@ ReaderThread::DoWork()
         for (i = 0; i < files.Size(); i++)
         {
             URI fileUri(this->path + "/" + files[i]);
-            n_printf("%s: %s\n", Thread::GetMyThreadName(), fileUri.AsString().AsCharPtr());
             Ptr<Stream> stream = ioServer->CreateStream(fileUri);
             if (stream->Open())
             {
+                // read the files like the resource loaders do
                 SizeT fileSize = stream->GetSize();
-                void* buf = Memory::Alloc(Memory::DefaultHeap, fileSize);
-                n_assert(buf);
-                SizeT readSize = stream->Read(buf, fileSize);
-                n_assert(readSize == fileSize);
-                Memory::Free(Memory::DefaultHeap, buf);
+                if (fileSize > 0)
+                {
+                    const void* buf = stream->Map();
+                    n_assert(buf);
+                    stream->Unmap();
+                }
                 stream->Close();
+                this->numBytesRead += fileSize;
             }
         }
     }
@@ -83,7 +94,31 @@ ZipStressTestApplication::Run()
 {
     // mount standard zip archives
     IoServer::Instance()->MountStandardArchives();
-    const SizeT numThreads = 8;
+
+    // warm up the file cache, so that the runs only measure decompression
+    this->RunReaderThreads(8, 1);
+
+    double singleThreadThroughput = this->RunReaderThreads(1, 10);
+    double multiThreadThroughput = this->RunReaderThreads(8, 10);
+    n_printf("Throughput 1 thread:  %.2f MB/s\n", singleThreadThroughput / (1024.0 * 1024.0));
+    n_printf("Throughput 8 threads: %.2f MB/s (%.2fx)\n", multiThreadThroughput / (1024.0 * 1024.0), multiThreadThroughput / singleThreadThroughput);
+    n_printf("DONE.\n");
+}
+
+//------------------------------------------------------------------------------
+/**
+    Every thread reads all texture directories, so that the amount of 
+    data read per thread is the same for all thread counts.
+*/
+double
+ZipStressTestApplication::RunReaderThreads(SizeT numThreads, SizeT loopCount)
+{
+    static const char* dirs[] = 
+    { 
+        "tex:characters", "tex:examples", "tex:ground", "tex:layered", 
+        "tex:lighting", "tex:materials", "tex:mlpaintmaps", "tex:system" 
+    };
+    static const SizeT numDirs = sizeof(dirs) / sizeof(dirs[0]);
 
     // create reader threads
     Array<Ptr<ReaderThread>> threads;
@@ -95,17 +130,12 @@ ZipStressTestApplication::Run()
         String threadName;
         threadName.Format("ReaderThread%d", i);
         threads[i]->SetName(threadName);
+        threads[i]->Setup(loopCount, dirs[i % numDirs], "*.dds");
     }
-    threads[0]->Setup(100, "tex:characters", "*.dds");
-    threads[1]->Setup(100, "tex:examples", "*.dds");
-    threads[2]->Setup(100, "tex:ground", "*.dds");
-    threads[3]->Setup(100, "tex:layered", "*.dds");
-    threads[4]->Setup(100, "tex:lighting", "*.dds");
-    threads[5]->Setup(100, "tex:materials", "*.dds");
-    threads[6]->Setup(100, "tex:mlpaintmaps", "*.dds");
-    threads[7]->Setup(100, "tex:system", "*.dds");
 
     // start threads
+    Timer timer;
+    timer.Start();
     for (i = 0; i < numThreads; i++)
     {
         threads[i]->Start();
@@ -124,11 +154,18 @@ ZipStressTestApplication::Run()
                 break;
             }
         }
-        n_sleep(0.01);
+        n_sleep(0.001);
     }
     while (anyRunning);
+    timer.Stop();
 
-    n_printf("DONE.\n");
+    double numBytesRead = 0.0;
+    for (i = 0; i < numThreads; i++)
+    {
+        numBytesRead += threads[i]->GetNumBytesRead();
+    }
+    n_printf("%d threads: %d MB in %f seconds\n", numThreads, int(numBytesRead / (1024.0 * 1024.0)), timer.GetTime());
+    return numBytesRead / timer.GetTime();
 }
 
 } // namespace App
\ No newline at end of file
@@ -3,7 +3,10 @@
 /**
     @class ZipStressTestApplication
     
-    Multithreading stress test for zip file access.
+    Multithreading stress test for zip file access. Reads the same files
+    with 1 reader thread and with 8 reader threads and prints the 
+    throughput, files of the same zip archive are decompressed in 
+    parallel by the reader threads.
     
     (C) 2009 Radon Labs GmbH
 */
@@ -18,6 +21,10 @@ class ZipStressTestApplication : public ConsoleApplication
 public:
     /// run the application, return when user wants to exit
     virtual void Run();
+
+private:
+    /// run the reader threads, returns number of bytes read per second
+    double RunReaderThreads(SizeT numThreads, SizeT loopCount);
 }; 
 
 } // namespace App
@@ -21,6 +21,8 @@ AnimConverterApp::ParseCmdLineArgs()
         this->category = this->args.GetString("-cat", "");
         this->animFileName = this->args.GetString("-anim", "");
         this->animConverter.SetAnimDrivenMotionFlag(this->args.GetBoolFlag("-animdrivenmotion"));
+        this->animConverter.SetCompressKeysFlag(this->args.GetBoolFlag("-compress"));
+        this->animConverter.SetKeyReductionTolerance(this->args.GetFloat("-reducekeys", 0.0f));
         return true;
     }
     return false;
@@ -41,6 +43,10 @@ AnimConverterApp::SetupProjectInfo()
         {
             this->animConverter.SetAnimDrivenMotionFlag(this->projectInfo.GetAttr("AnimDrivenMotionEnabled").AsBool());
         }
+        if (this->projectInfo.HasAttr("AnimKeyCompressionEnabled"))
+        {
+            this->animConverter.SetCompressKeysFlag(this->projectInfo.GetAttr("AnimKeyCompressionEnabled").AsBool());
+        }
         return true;
     }
     return false;
@@ -59,7 +65,9 @@ AnimConverterApp::ShowHelp()
              "-waitforkey -- wait for key when complete\n"
              "-force      -- force export (don't check time stamps)\n"
              "-cat        -- select specific category\n"
-             "-anim       -- select specific texture (also needs -cat)\n");
+             "-anim       -- select specific texture (also needs -cat)\n"
+             "-compress   -- write NAX4 files with quantized keys\n"
+             "-reducekeys -- remove keys which can be interpolated within tolerance\n");
 }
 
 //------------------------------------------------------------------------------
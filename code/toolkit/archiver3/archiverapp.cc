@@ -8,6 +8,7 @@
 #include "io/xmlwriter.h"
 #include "zlib/zlib.h"
 #include "io/binarywriter.h"
+#include "io/zipfs/zipblockcodec.h"
 
 namespace Toolkit
 {
@@ -19,7 +20,8 @@ using namespace IO;
 /**
 */
 ArchiverApp::ArchiverApp() :
-    webDeployFlag(false)
+    webDeployFlag(false),
+    n3ArchiveFlag(false)
 {
     // empty
 }
@@ -34,7 +36,8 @@ ArchiverApp::ShowHelp()
              "(C) Radon Labs GmbH 2008.\n"
              "Creates platform-specific asset archives (e.g. export.zip, export_win32.zip)\n"
              "-help -- display this help\n"
-             "-webdeploy -- create a web-deployment directory (only win32 platform)!\n");
+             "-webdeploy -- create a web-deployment directory (only win32 platform)!\n"
+             "-n3archive -- create a Nebula3 archive (.n3a) instead of a zip archive (only win32 and xbox360 platforms)\n");
 }
 
 //------------------------------------------------------------------------------
@@ -46,6 +49,7 @@ ArchiverApp::ParseCmdLineArgs()
     if (ToolkitApp::ParseCmdLineArgs())
     {
         this->webDeployFlag = this->args.GetBoolFlag("-webdeploy");
+        this->n3ArchiveFlag = this->args.GetBoolFlag("-n3archive");
         return true;
     }
     return false;
@@ -76,6 +80,10 @@ ArchiverApp::SetupProjectInfo()
         {
             this->excludePatterns.Append("*.db4");
         }
+        if (this->projectInfo.HasAttr("ArchiverBlockCompressPatterns"))
+        {
+            this->blockCompressPatterns = this->projectInfo.GetAttr("ArchiverBlockCompressPatterns").Tokenize("; ");
+        }
         if (this->projectInfo.HasAttr("WiiDvdRoot"))
         {
             this->wiiDvdRoot = this->projectInfo.GetPathAttr("WiiDvdRoot");
@@ -114,7 +122,14 @@ ArchiverApp::Run()
             }
             // fallthrough!
         case Platform::Xbox360:
-            this->PackDirectoryWin360(this->projectInfo.GetAttr("DstDir"));
+            if (this->n3ArchiveFlag)
+            {
+                this->PackN3Archive(this->projectInfo.GetAttr("DstDir"));
+            }
+            else
+            {
+                this->PackDirectoryWin360(this->projectInfo.GetAttr("DstDir"));
+            }
             break;
 
         case Platform::Wii:
@@ -241,7 +256,114 @@ ArchiverApp::CompressCopyFile(const String& srcPath, const String& dstPath)
 
 //------------------------------------------------------------------------------
 /**
-    Packs a single directory using zip.exe.
+    Return true if a file matches one of the block-compress patterns.
+*/
+bool
+ArchiverApp::IsBlockCompressFile(const String& fileName) const
+{
+    IndexT i;
+    for (i = 0; i < this->blockCompressPatterns.Size(); i++)
+    {
+        if (String::MatchPattern(fileName, this->blockCompressPatterns[i]))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Recursively copy a directory into the staging directory. Files which
+    match the block-compress patterns are block-compressed on the way.
+*/
+void
+ArchiverApp::RecurseBlockCompressDirectory(const String& srcDir, const String& dstDir)
+{
+    IoServer* ioServer = IoServer::Instance();
+    ioServer->CreateDirectory(dstDir);
+
+    Array<String> files = ioServer->ListFiles(srcDir, "*");
+    IndexT fileIndex;
+    for (fileIndex = 0; fileIndex < files.Size(); fileIndex++)
+    {
+        String srcPath = srcDir + "/" + files[fileIndex];
+        String dstPath = dstDir + "/" + files[fileIndex];
+        if (this->IsBlockCompressFile(files[fileIndex]))
+        {
+            this->BlockCompressCopyFile(srcPath, dstPath);
+        }
+        else if (!ioServer->CopyFile(srcPath, dstPath))
+        {
+            n_printf("WARNING: failed to copy '%s' to '%s'!\n", srcPath.AsCharPtr(), dstPath.AsCharPtr());
+        }
+    }
+
+    Array<String> dirs = ioServer->ListDirectories(srcDir, "*");
+    IndexT dirIndex;
+    for (dirIndex = 0; dirIndex < dirs.Size(); dirIndex++)
+    {
+        const String& curDir = dirs[dirIndex];
+        if ((curDir != "CVS") && (curDir != ".svn"))
+        {
+            this->RecurseBlockCompressDirectory(srcDir + "/" + curDir, dstDir + "/" + curDir);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Block-compress a single file (see IO::ZipBlockCodec). The result is 
+    stored uncompressed in the zip archive, so that the zip filesystem can
+    seek in the file by decompressing single blocks.
+*/
+void
+ArchiverApp::BlockCompressCopyFile(const String& srcPath, const String& dstPath)
+{
+    IoServer* ioServer = IoServer::Instance();
+    Ptr<Stream> srcStream = ioServer->CreateStream(srcPath);
+    if (srcStream->Open())
+    {
+        SizeT srcSize = srcStream->GetSize();
+        void* srcData = (srcSize > 0) ? srcStream->Map() : 0;
+
+        Ptr<Stream> dstStream = ioServer->CreateStream(dstPath);
+        dstStream->SetAccessMode(Stream::WriteAccess);
+        if (dstStream->Open())
+        {
+            if (ZipBlockCodec::Encode(srcData, srcSize, dstStream))
+            {
+                n_printf("-> %s (%d -> %d, block-compressed)\n", srcPath.AsCharPtr(), srcSize, dstStream->GetSize());
+            }
+            else
+            {
+                n_error("ArchiverApp::BlockCompressCopyFile(): failed to compress '%s'!\n", srcPath.AsCharPtr());
+            }
+            dstStream->Close();
+        }
+        else
+        {
+            n_error("ArchiverApp::BlockCompressCopyFile(): failed to open dst file '%s'!\n", dstPath.AsCharPtr());
+        }
+        if (srcSize > 0)
+        {
+            srcStream->Unmap();
+        }
+        srcStream->Close();
+    }
+    else
+    {
+        n_error("ArchiverApp::BlockCompressCopyFile(): failed to open src file '%s'!\n", srcPath.AsCharPtr());
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Packs a single directory using zip.exe. If block-compress patterns
+    are defined in the project info (ArchiverBlockCompressPatterns), 
+    the directory is first copied into a staging directory where the 
+    matching files are block-compressed, and the staging directory
+    is packed with zip compression disabled for these files.
 */
 void
 ArchiverApp::PackDirectoryWin360(const String& dirPath)
@@ -262,10 +384,36 @@ ArchiverApp::PackDirectoryWin360(const String& dirPath)
         ioServer->DeleteFile(filePath);
     }
 
+    // block-compress files into the staging directory
+    String workingDir = "proj:";
+    String zipFileName = filePath.ExtractFileName();
+    if (this->blockCompressPatterns.Size() > 0)
+    {
+        workingDir = "proj:archiver_stage";
+        zipFileName = "..\\" + zipFileName;
+        this->RecurseBlockCompressDirectory(dirPath, workingDir + "/" + dirPath.ExtractFileName());
+    }
+
     // invoke the zip tool
     String args;
-    args.Format("-r %s %s\\* ", filePath.ExtractFileName().AsCharPtr(), dirPath.ExtractFileName().AsCharPtr());    
+    args.Format("-r %s %s\\* ", zipFileName.AsCharPtr(), dirPath.ExtractFileName().AsCharPtr());    
     IndexT i;
+    if (this->blockCompressPatterns.Size() > 0)
+    {
+        // block-compressed files must be stored without zip compression
+        args.Append("-n ");
+        for (i = 0; i < this->blockCompressPatterns.Size(); i++)
+        {
+            String suffix = this->blockCompressPatterns[i];
+            suffix.TrimLeft("*");
+            if (i > 0)
+            {
+                args.Append(":");
+            }
+            args.Append(suffix);
+        }
+        args.Append(" ");
+    }
     for (i = 0; i < this->excludePatterns.Size(); i++)
     {
         args.Append("-x ");
@@ -276,7 +424,7 @@ ArchiverApp::PackDirectoryWin360(const String& dirPath)
     n_printf("Archiving: %s %s", this->toolPath.AsCharPtr(), args.AsCharPtr());
     AppLauncher appLauncher;
     appLauncher.SetExecutable(this->toolPath);
-    appLauncher.SetWorkingDirectory("proj:");
+    appLauncher.SetWorkingDirectory(workingDir);
     appLauncher.SetArguments(args);
     if (!appLauncher.LaunchWait())
     {
@@ -284,6 +432,100 @@ ArchiverApp::PackDirectoryWin360(const String& dirPath)
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+    Return true if a file name matches one of the exclude patterns.
+*/
+bool
+ArchiverApp::IsExcludedFile(const String& fileName) const
+{
+    IndexT i;
+    for (i = 0; i < this->excludePatterns.Size(); i++)
+    {
+        if (String::MatchPattern(fileName, this->excludePatterns[i]))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Packs a directory into a Nebula3 archive (see IO::N3ArchiveWriter). Like
+    the zip archive, the archive contains the directory itself as root 
+    directory. All files are block-compressed, the writer stores files
+    uncompressed if they don't get smaller.
+*/
+void
+ArchiverApp::PackN3Archive(const String& dirPath)
+{
+    IoServer* ioServer = IoServer::Instance();
+
+    // make sure the directory exists
+    if (!ioServer->DirectoryExists(dirPath))
+    {
+        n_printf("ERROR: dir '%s' does not exist!", dirPath.AsCharPtr());
+        return;
+    }
+
+    // delete the target file, if exists
+    String filePath = dirPath + ".n3a";
+    if (ioServer->FileExists(filePath))
+    {
+        ioServer->DeleteFile(filePath);
+    }
+
+    // the directory block must be in the byte order of the target platform
+    N3ArchiveWriter writer;
+    if (Platform::Xbox360 == this->platform)
+    {
+        writer.SetByteOrder(System::ByteOrder::BigEndian);
+    }
+    else
+    {
+        writer.SetByteOrder(System::ByteOrder::LittleEndian);
+    }
+    this->RecurseAddN3ArchiveFiles(writer, dirPath, dirPath.ExtractFileName());
+
+    n_printf("Archiving: %s (%d files)\n", filePath.AsCharPtr(), writer.GetNumFiles());
+    if (!writer.Write(filePath))
+    {
+        n_printf("ERROR: failed to write archive '%s'!\n", filePath.AsCharPtr());
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Recursively add the files in a directory to a Nebula3 archive.
+*/
+void
+ArchiverApp::RecurseAddN3ArchiveFiles(N3ArchiveWriter& writer, const String& srcDir, const String& pathInArchive)
+{
+    IoServer* ioServer = IoServer::Instance();
+
+    Array<String> files = ioServer->ListFiles(srcDir, "*");
+    IndexT fileIndex;
+    for (fileIndex = 0; fileIndex < files.Size(); fileIndex++)
+    {
+        if (!this->IsExcludedFile(files[fileIndex]))
+        {
+            writer.AddFile(pathInArchive + "/" + files[fileIndex], srcDir + "/" + files[fileIndex], true);
+        }
+    }
+
+    Array<String> dirs = ioServer->ListDirectories(srcDir, "*");
+    IndexT dirIndex;
+    for (dirIndex = 0; dirIndex < dirs.Size(); dirIndex++)
+    {
+        const String& curDir = dirs[dirIndex];
+        if ((curDir != "CVS") && (curDir != ".svn"))
+        {
+            this->RecurseAddN3ArchiveFiles(writer, srcDir + "/" + curDir, pathInArchive + "/" + curDir);
+        }
+    }
+}
+
 //------------------------------------------------------------------------------
 /**
     Invokes the Wii packer to pack the export and export_wii directories.
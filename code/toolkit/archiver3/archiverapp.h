@@ -8,6 +8,7 @@
     (C) 2009 Radon Labs GmbH
 */
 #include "toolkitutil/toolkitapp.h"
+#include "io/n3fs/n3archivewriter.h"
 
 //------------------------------------------------------------------------------
 namespace Toolkit
@@ -31,6 +32,12 @@ private:
     void PackWebDeploy(const Util::String& dir, const Util::String& webDeployDir);
     /// pack directory using ZIP for the Win32 and Xbox360 platforms
     void PackDirectoryWin360(const Util::String& dir);
+    /// pack directory into a Nebula3 archive (.n3a) for the Win32 and Xbox360 platforms
+    void PackN3Archive(const Util::String& dir);
+    /// recursively add the files of a directory to a Nebula3 archive
+    void RecurseAddN3ArchiveFiles(IO::N3ArchiveWriter& writer, const Util::String& srcDir, const Util::String& pathInArchive);
+    /// return true if a file matches an exclude pattern
+    bool IsExcludedFile(const Util::String& fileName) const;
     /// pack all asset directories for the Wii platform, and copy to Wii SDK's DVDROOT
     void PackAndCopyWiiArchive();
     /// pack PS3 archive
@@ -41,11 +48,19 @@ private:
     void RecursePackWebDeployDirectory(const Util::String& srcDir, const Util::String& dstDir);
     /// compress and copy a file for web deployment
     void CompressCopyFile(const Util::String& srcPath, const Util::String& dstPath);
+    /// recursively copy a directory into the staging directory, block-compressing matching files
+    void RecurseBlockCompressDirectory(const Util::String& srcDir, const Util::String& dstDir);
+    /// return true if a file should be block-compressed
+    bool IsBlockCompressFile(const Util::String& fileName) const;
+    /// block-compress and copy a single file
+    void BlockCompressCopyFile(const Util::String& srcPath, const Util::String& dstPath);
 
     Util::String toolPath;
     Util::String wiiDvdRoot;
     Util::Array<Util::String> excludePatterns;
+    Util::Array<Util::String> blockCompressPatterns;
     bool webDeployFlag;
+    bool n3ArchiveFlag;
 };
 
 } // namespace Toolkit
\ No newline at end of file
@@ -269,4 +269,146 @@ AnimBuilder::TrimEnd(SizeT numTrimKeys)
     this->FixAnimCurveFirstKeyIndices();
 }
 
+//------------------------------------------------------------------------------
+/**
+    Remove animation keys which can be reconstructed within the given
+    tolerance (maximum absolute difference per key component). Curves
+    with constant keys are collapsed into static curves. Since all curves
+    of a clip share the same key rate, the key rate of a clip is halved
+    as long as every removed key can be interpolated from its neighbours.
+*/
+void
+AnimBuilder::ReduceKeys(float tolerance)
+{
+    IndexT clipIndex;
+    for (clipIndex = 0; clipIndex < this->clipArray.Size(); clipIndex++)
+    {
+        AnimBuilderClip& clip = this->clipArray[clipIndex];
+        this->CollapseConstantCurves(clip, tolerance);
+
+        // only clips with an odd number of keys keep their last key
+        while ((clip.GetNumKeys() >= 3) && (1 == (clip.GetNumKeys() & 1)) && this->CanDropOddKeys(clip, tolerance))
+        {
+            this->DropOddKeys(clip);
+        }
+    }
+
+    // need to re-compute first-key-indices after removing keys!
+    this->FixAnimCurveFirstKeyIndices();
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AnimBuilder::CollapseConstantCurves(AnimBuilderClip& clip, float tolerance)
+{
+    float4 epsilon(tolerance, tolerance, tolerance, tolerance);
+    IndexT curveIndex;
+    for (curveIndex = 0; curveIndex < clip.GetNumCurves(); curveIndex++)
+    {
+        AnimBuilderCurve& curve = clip.GetCurveAtIndex(curveIndex);
+        if (!curve.IsStatic() && (curve.GetNumKeys() > 0))
+        {
+            const float4& firstKey = curve.GetKey(0);
+            bool isConstant = true;
+            IndexT keyIndex;
+            for (keyIndex = 1; isConstant && (keyIndex < curve.GetNumKeys()); keyIndex++)
+            {
+                isConstant = float4::nearequal4(firstKey, curve.GetKey(keyIndex), epsilon);
+            }
+            if (isConstant)
+            {
+                curve.SetStaticKey(firstKey);
+                curve.SetStatic(true);
+                curve.ResizeKeyArray(0);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Rotation keys are interpolated by normalizing the sum of the neighbour
+    quaternions (which is identical with a slerp at 0.5), quaternions are
+    sign-aligned before comparing.
+*/
+bool
+AnimBuilder::CanDropOddKeys(AnimBuilderClip& clip, float tolerance)
+{
+    float4 epsilon(tolerance, tolerance, tolerance, tolerance);
+    IndexT curveIndex;
+    for (curveIndex = 0; curveIndex < clip.GetNumCurves(); curveIndex++)
+    {
+        AnimBuilderCurve& curve = clip.GetCurveAtIndex(curveIndex);
+        if (curve.IsStatic())
+        {
+            continue;
+        }
+        IndexT keyIndex;
+        for (keyIndex = 1; keyIndex < (curve.GetNumKeys() - 1); keyIndex += 2)
+        {
+            const float4& prevKey = curve.GetKey(keyIndex - 1);
+            float4 nextKey = curve.GetKey(keyIndex + 1);
+            float4 key = curve.GetKey(keyIndex);
+            float4 interpolated;
+            if (CurveType::Rotation == curve.GetCurveType())
+            {
+                if ((float4::dot3(prevKey, nextKey) + prevKey.w() * nextKey.w()) < 0.0f)
+                {
+                    nextKey = -nextKey;
+                }
+                interpolated = float4::normalize(prevKey + nextKey);
+                if ((float4::dot3(interpolated, key) + interpolated.w() * key.w()) < 0.0f)
+                {
+                    key = -key;
+                }
+            }
+            else
+            {
+                interpolated = float4::lerp(prevKey, nextKey, 0.5f);
+            }
+            if (!float4::nearequal4(interpolated, key, epsilon))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Keep the even keys of all curves. Anim event key indices and the start
+    key index are scaled to the new key rate.
+*/
+void
+AnimBuilder::DropOddKeys(AnimBuilderClip& clip)
+{
+    SizeT newNumKeys = (clip.GetNumKeys() + 1) / 2;
+    IndexT curveIndex;
+    for (curveIndex = 0; curveIndex < clip.GetNumCurves(); curveIndex++)
+    {
+        AnimBuilderCurve& curve = clip.GetCurveAtIndex(curveIndex);
+        if (!curve.IsStatic())
+        {
+            IndexT keyIndex;
+            for (keyIndex = 1; keyIndex < newNumKeys; keyIndex++)
+            {
+                curve.SetKey(keyIndex, curve.GetKey(keyIndex * 2));
+            }
+            curve.ResizeKeyArray(newNumKeys);
+        }
+    }
+    IndexT eventIndex;
+    for (eventIndex = 0; eventIndex < clip.GetNumAnimEvents(); eventIndex++)
+    {
+        AnimEvent& animEvent = clip.GetAnimEventAtIndex(eventIndex);
+        animEvent.SetTime(animEvent.GetTime() / 2);
+    }
+    clip.SetStartKeyIndex(clip.GetStartKeyIndex() / 2);
+    clip.SetNumKeys(newNumKeys);
+    clip.SetKeyDuration(clip.GetKeyDuration() * 2);
+}
+
 } // namespace ToolkitUtil
\ No newline at end of file
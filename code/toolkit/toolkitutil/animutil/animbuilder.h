@@ -45,6 +45,8 @@ public:
     void FixInactiveCurveStaticKeyValues();
     /// cut keys from end of tracks
     void TrimEnd(SizeT numKeys);
+    /// remove keys which can be reconstructed within a tolerance
+    void ReduceKeys(float tolerance);
 
     /// downsample all anim curves once
     //void Downsample();
@@ -58,6 +60,13 @@ public:
     //void BuildAnimDrivenMotionData();
     
 private:
+    /// collapse curves with constant keys into static curves
+    void CollapseConstantCurves(AnimBuilderClip& clip, float tolerance);
+    /// return true if every odd key of the clip can be interpolated from its neighbours
+    bool CanDropOddKeys(AnimBuilderClip& clip, float tolerance);
+    /// remove every odd key of the clip, doubles the key duration
+    void DropOddKeys(AnimBuilderClip& clip);
+
     Util::Array<AnimBuilderClip> clipArray;
 };
 
@@ -6,6 +6,8 @@
 #include "toolkitutil/animutil/animbuildersaver.h"
 #include "io/ioserver.h"
 #include "coreanimation/naxfileformatstructs.h"
+#include "coreanimation/keyformat.h"
+#include "util/round.h"
 
 namespace ToolkitUtil
 {
@@ -71,28 +73,7 @@ AnimBuilderSaver::WriteClips(const Ptr<Stream>& stream, AnimBuilder& animBuilder
     for (clipIndex = 0; clipIndex < numClips; clipIndex++)
     {
         AnimBuilderClip& clip = animBuilder.GetClipAtIndex(clipIndex);
-        Nax3Clip nax3Clip;
-
-        // check clip name restrictions
-        const String& clipName = clip.GetName().AsString();
-        if (clipName.Length() >= sizeof(nax3Clip.name))
-        {
-            n_error("AnimBuilderSaver: Clip name '%s' is too long (%s)!\n", clipName.AsCharPtr(), stream->GetURI().LocalPath().AsCharPtr());
-        }
- 
-        // write clip attributes
-        clipName.CopyToBuffer(&(nax3Clip.name[0]), sizeof(nax3Clip.name));
-        nax3Clip.numCurves        = byteOrder.Convert<ushort>(clip.GetNumCurves());
-        nax3Clip.startKeyIndex    = byteOrder.Convert<ushort>(clip.GetStartKeyIndex());
-        nax3Clip.numKeys          = byteOrder.Convert<ushort>(clip.GetNumKeys());
-        nax3Clip.keyStride        = byteOrder.Convert<ushort>(clip.GetKeyStride());
-        nax3Clip.keyDuration      = byteOrder.Convert<ushort>(clip.GetKeyDuration());
-        nax3Clip.preInfinityType  = clip.GetPreInfinityType();
-        nax3Clip.postInfinityType = clip.GetPostInfinityType();
-        nax3Clip.numEvents        = byteOrder.Convert<ushort>(clip.GetNumAnimEvents());
-
-        // write clip header to stream
-        stream->Write(&nax3Clip, sizeof(nax3Clip));
+        AnimBuilderSaver::WriteClipHeader(stream, clip, clip.GetKeyStride(), byteOrder);
 
         // write clip anim events
         AnimBuilderSaver::WriteClipAnimEvents(stream, clip, byteOrder);
@@ -102,6 +83,42 @@ AnimBuilderSaver::WriteClips(const Ptr<Stream>& stream, AnimBuilder& animBuilder
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+    The key stride is the number of float4 keys for NAX3, and the byte
+    size of a key slice for NAX4.
+*/
+void
+AnimBuilderSaver::WriteClipHeader(const Ptr<Stream>& stream, AnimBuilderClip& clip, SizeT keyStride, const ByteOrder& byteOrder)
+{
+    Nax3Clip nax3Clip;
+
+    // check clip name restrictions
+    const String& clipName = clip.GetName().AsString();
+    if (clipName.Length() >= sizeof(nax3Clip.name))
+    {
+        n_error("AnimBuilderSaver: Clip name '%s' is too long (%s)!\n", clipName.AsCharPtr(), stream->GetURI().LocalPath().AsCharPtr());
+    }
+    if (keyStride > 0xffff)
+    {
+        n_error("AnimBuilderSaver: Key stride of clip '%s' is too big (%s)!\n", clipName.AsCharPtr(), stream->GetURI().LocalPath().AsCharPtr());
+    }
+
+    // write clip attributes
+    clipName.CopyToBuffer(&(nax3Clip.name[0]), sizeof(nax3Clip.name));
+    nax3Clip.numCurves        = byteOrder.Convert<ushort>(clip.GetNumCurves());
+    nax3Clip.startKeyIndex    = byteOrder.Convert<ushort>(clip.GetStartKeyIndex());
+    nax3Clip.numKeys          = byteOrder.Convert<ushort>(clip.GetNumKeys());
+    nax3Clip.keyStride        = byteOrder.Convert<ushort>(keyStride);
+    nax3Clip.keyDuration      = byteOrder.Convert<ushort>(clip.GetKeyDuration());
+    nax3Clip.preInfinityType  = clip.GetPreInfinityType();
+    nax3Clip.postInfinityType = clip.GetPostInfinityType();
+    nax3Clip.numEvents        = byteOrder.Convert<ushort>(clip.GetNumAnimEvents());
+
+    // write clip header to stream
+    stream->Write(&nax3Clip, sizeof(nax3Clip));
+}
+
 //------------------------------------------------------------------------------
 /**
 */
@@ -217,4 +234,292 @@ AnimBuilderSaver::WriteKeys(const Ptr<Stream>& stream, AnimBuilder& animBuilder,
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+bool
+AnimBuilderSaver::SaveNax4(const URI& uri, AnimBuilder& animBuilder, Platform::Code platform)
+{
+    // make sure the target directory exists
+    IoServer::Instance()->CreateDirectory(uri.LocalPath().ExtractDirName());
+
+    Ptr<Stream> stream = IoServer::Instance()->CreateStream(uri);
+    stream->SetAccessMode(Stream::WriteAccess);
+    if (stream->Open())
+    {
+        ByteOrder byteOrder(ByteOrder::Host, Platform::GetPlatformByteOrder(platform));
+
+        // select key formats and layout of the key data
+        Array<Nax4Curve> curves;
+        Array<SizeT> keyStrides;
+        SizeT keyBufferSize = AnimBuilderSaver::SetupNax4Curves(animBuilder, curves, keyStrides);
+
+        // write header
+        Nax4Header nax4Header;
+        nax4Header.magic         = byteOrder.Convert<uint>(NEBULA3_NAX4_MAGICNUMBER);
+        nax4Header.numClips      = byteOrder.Convert<uint>(animBuilder.GetNumClips());
+        nax4Header.keyBufferSize = byteOrder.Convert<uint>(keyBufferSize);
+        stream->Write(&nax4Header, sizeof(nax4Header));
+
+        AnimBuilderSaver::WriteNax4Clips(stream, animBuilder, curves, keyStrides, byteOrder);
+        AnimBuilderSaver::WriteNax4Keys(stream, animBuilder, curves, keyStrides, byteOrder);
+
+        stream->Close();
+        stream = 0;
+        return true;
+    }
+    else
+    {
+        // failed to open write stream
+        return false;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Selects the key format of each curve and computes the quantization
+    range and the byte offset of the first key. The keys of a clip are 
+    stored in key slices (one key of each non-static curve), key slices
+    are padded to 16 bytes.
+*/
+SizeT
+AnimBuilderSaver::SetupNax4Curves(AnimBuilder& animBuilder, Array<Nax4Curve>& outCurves, Array<SizeT>& outKeyStrides)
+{
+    outCurves.Clear();
+    outKeyStrides.Clear();
+    outCurves.Reserve(animBuilder.CountCurves());
+    outKeyStrides.Reserve(animBuilder.GetNumClips());
+
+    SizeT clipKeyOffset = 0;
+    IndexT clipIndex;
+    for (clipIndex = 0; clipIndex < animBuilder.GetNumClips(); clipIndex++)
+    {
+        AnimBuilderClip& clip = animBuilder.GetClipAtIndex(clipIndex);
+        SizeT sliceOffset = 0;
+        IndexT curveIndex;
+        for (curveIndex = 0; curveIndex < clip.GetNumCurves(); curveIndex++)
+        {
+            AnimBuilderCurve& curve = clip.GetCurveAtIndex(curveIndex);
+            Nax4Curve nax4Curve;
+            Memory::Clear(&nax4Curve, sizeof(nax4Curve));
+            nax4Curve.isActive = curve.IsActive();
+            nax4Curve.isStatic = curve.IsStatic();
+            nax4Curve.curveType = curve.GetCurveType();
+            nax4Curve.keyFormat = KeyFormat::Float4;
+            nax4Curve.staticKeyX = curve.GetStaticKey().x();
+            nax4Curve.staticKeyY = curve.GetStaticKey().y();
+            nax4Curve.staticKeyZ = curve.GetStaticKey().z();
+            nax4Curve.staticKeyW = curve.GetStaticKey().w();
+            nax4Curve.keyScaleX = nax4Curve.keyScaleY = nax4Curve.keyScaleZ = nax4Curve.keyScaleW = 1.0f;
+            if (!curve.IsStatic())
+            {
+                if (CurveType::Rotation == curve.GetCurveType())
+                {
+                    nax4Curve.keyFormat = KeyFormat::Quat48;
+                }
+                else
+                {
+                    // find the key range, Vec48 keys need a constant w component
+                    float4 minKey = curve.GetKey(0);
+                    float4 maxKey = curve.GetKey(0);
+                    bool constantW = true;
+                    IndexT keyIndex;
+                    for (keyIndex = 1; keyIndex < curve.GetNumKeys(); keyIndex++)
+                    {
+                        const float4& key = curve.GetKey(keyIndex);
+                        minKey = float4::minimize(minKey, key);
+                        maxKey = float4::maximize(maxKey, key);
+                        constantW &= (key.w() == minKey.w());
+                    }
+                    if (constantW)
+                    {
+                        float4 scale = (maxKey - minKey) * (1.0f / 65535.0f);
+                        nax4Curve.keyFormat = KeyFormat::Vec48;
+                        nax4Curve.keyScaleX = scale.x();
+                        nax4Curve.keyScaleY = scale.y();
+                        nax4Curve.keyScaleZ = scale.z();
+                        nax4Curve.keyScaleW = 0.0f;
+                        nax4Curve.keyBiasX = minKey.x();
+                        nax4Curve.keyBiasY = minKey.y();
+                        nax4Curve.keyBiasZ = minKey.z();
+                        nax4Curve.keyBiasW = minKey.w();
+                    }
+                }
+                nax4Curve.firstKeyOffset = clipKeyOffset + sliceOffset;
+                sliceOffset += KeyFormat::ByteSize((KeyFormat::Code)nax4Curve.keyFormat);
+            }
+            outCurves.Append(nax4Curve);
+        }
+        SizeT keyStride = Round::RoundUp16(sliceOffset);
+        outKeyStrides.Append(keyStride);
+        clipKeyOffset += keyStride * clip.GetNumKeys();
+    }
+    return clipKeyOffset;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AnimBuilderSaver::WriteNax4Clips(const Ptr<Stream>& stream, AnimBuilder& animBuilder, const Array<Nax4Curve>& curves, const Array<SizeT>& keyStrides, const ByteOrder& byteOrder)
+{
+    IndexT curveIndex = 0;
+    IndexT clipIndex;
+    for (clipIndex = 0; clipIndex < animBuilder.GetNumClips(); clipIndex++)
+    {
+        AnimBuilderClip& clip = animBuilder.GetClipAtIndex(clipIndex);
+        AnimBuilderSaver::WriteClipHeader(stream, clip, keyStrides[clipIndex], byteOrder);
+        AnimBuilderSaver::WriteClipAnimEvents(stream, clip, byteOrder);
+
+        // write clip curves
+        IndexT i;
+        for (i = 0; i < clip.GetNumCurves(); i++)
+        {
+            Nax4Curve nax4Curve = curves[curveIndex++];
+            byteOrder.ConvertInPlace<uint>(nax4Curve.firstKeyOffset);
+            byteOrder.ConvertInPlace<float>(nax4Curve.staticKeyX);
+            byteOrder.ConvertInPlace<float>(nax4Curve.staticKeyY);
+            byteOrder.ConvertInPlace<float>(nax4Curve.staticKeyZ);
+            byteOrder.ConvertInPlace<float>(nax4Curve.staticKeyW);
+            byteOrder.ConvertInPlace<float>(nax4Curve.keyScaleX);
+            byteOrder.ConvertInPlace<float>(nax4Curve.keyScaleY);
+            byteOrder.ConvertInPlace<float>(nax4Curve.keyScaleZ);
+            byteOrder.ConvertInPlace<float>(nax4Curve.keyScaleW);
+            byteOrder.ConvertInPlace<float>(nax4Curve.keyBiasX);
+            byteOrder.ConvertInPlace<float>(nax4Curve.keyBiasY);
+            byteOrder.ConvertInPlace<float>(nax4Curve.keyBiasZ);
+            byteOrder.ConvertInPlace<float>(nax4Curve.keyBiasW);
+            stream->Write(&nax4Curve, sizeof(nax4Curve));
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AnimBuilderSaver::WriteNax4Keys(const Ptr<Stream>& stream, AnimBuilder& animBuilder, const Array<Nax4Curve>& curves, const Array<SizeT>& keyStrides, const ByteOrder& byteOrder)
+{
+    const SizeT MaxSliceSize = 0x10000;
+    uchar* slice = (uchar*) Memory::Alloc(Memory::ScratchHeap, MaxSliceSize);
+
+    IndexT clipFirstCurveIndex = 0;
+    IndexT clipIndex;
+    for (clipIndex = 0; clipIndex < animBuilder.GetNumClips(); clipIndex++)
+    {
+        AnimBuilderClip& clip = animBuilder.GetClipAtIndex(clipIndex);
+        SizeT keyStride = keyStrides[clipIndex];
+        n_assert(keyStride <= MaxSliceSize);
+        IndexT keyIndex;
+        for (keyIndex = 0; keyIndex < clip.GetNumKeys(); keyIndex++)
+        {
+            Memory::Clear(slice, keyStride);
+            uchar* ptr = slice;
+            IndexT curveIndex;
+            for (curveIndex = 0; curveIndex < clip.GetNumCurves(); curveIndex++)
+            {
+                const AnimBuilderCurve& curve = clip.GetCurveAtIndex(curveIndex);
+                const Nax4Curve& nax4Curve = curves[clipFirstCurveIndex + curveIndex];
+                if (!curve.IsStatic())
+                {
+                    const float4& key = curve.GetKey(keyIndex);
+                    switch (nax4Curve.keyFormat)
+                    {
+                        case KeyFormat::Quat48:
+                        case KeyFormat::Vec48:
+                            {
+                                ushort* keyValues = (ushort*) ptr;
+                                if (KeyFormat::Quat48 == nax4Curve.keyFormat)
+                                {
+                                    AnimBuilderSaver::EncodeQuat48(key, keyValues);
+                                }
+                                else
+                                {
+                                    AnimBuilderSaver::EncodeVec48(key, nax4Curve, keyValues);
+                                }
+                                byteOrder.ConvertInPlace<ushort>(keyValues[0]);
+                                byteOrder.ConvertInPlace<ushort>(keyValues[1]);
+                                byteOrder.ConvertInPlace<ushort>(keyValues[2]);
+                            }
+                            break;
+
+                        default:
+                            {
+                                float* keyValues = (float*) ptr;
+                                keyValues[0] = byteOrder.Convert<float>(key.x());
+                                keyValues[1] = byteOrder.Convert<float>(key.y());
+                                keyValues[2] = byteOrder.Convert<float>(key.z());
+                                keyValues[3] = byteOrder.Convert<float>(key.w());
+                            }
+                            break;
+                    }
+                    ptr += KeyFormat::ByteSize((KeyFormat::Code)nax4Curve.keyFormat);
+                }
+            }
+            stream->Write(slice, keyStride);
+        }
+        clipFirstCurveIndex += clip.GetNumCurves();
+    }
+    Memory::Free(Memory::ScratchHeap, slice);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Smallest-three encoding: the largest component is omitted and made 
+    positive by negating the quaternion, the other 3 components are 
+    quantized to 15 bits in the range [-1/sqrt(2), 1/sqrt(2)]. The index
+    of the omitted component is stored in the top bits of the first 2 keys.
+*/
+void
+AnimBuilderSaver::EncodeQuat48(const float4& key, ushort* outKey)
+{
+    const float range = 0.707106781f;
+    float4 q = float4::normalize(key);
+    float c[4] = { q.x(), q.y(), q.z(), q.w() };
+    uint largestIndex = 0;
+    IndexT i;
+    for (i = 1; i < 4; i++)
+    {
+        if (n_abs(c[i]) > n_abs(c[largestIndex]))
+        {
+            largestIndex = i;
+        }
+    }
+    float sign = (c[largestIndex] < 0.0f) ? -1.0f : 1.0f;
+    IndexT outIndex = 0;
+    for (i = 0; i < 4; i++)
+    {
+        if (i != largestIndex)
+        {
+            float v = ((c[i] * sign) + range) / (2.0f * range);
+            outKey[outIndex++] = (ushort) n_iclamp(int(v * 32767.0f + 0.5f), 0, 32767);
+        }
+    }
+    outKey[0] |= (ushort)((largestIndex & 1) << 15);
+    outKey[1] |= (ushort)((largestIndex >> 1) << 15);
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+void
+AnimBuilderSaver::EncodeVec48(const float4& key, const Nax4Curve& curve, ushort* outKey)
+{
+    const float k[3] = { key.x(), key.y(), key.z() };
+    const float scale[3] = { curve.keyScaleX, curve.keyScaleY, curve.keyScaleZ };
+    const float bias[3] = { curve.keyBiasX, curve.keyBiasY, curve.keyBiasZ };
+    IndexT i;
+    for (i = 0; i < 3; i++)
+    {
+        if (scale[i] > 0.0f)
+        {
+            outKey[i] = (ushort) n_iclamp(int(((k[i] - bias[i]) / scale[i]) + 0.5f), 0, 65535);
+        }
+        else
+        {
+            outKey[i] = 0;
+        }
+    }
+}
+
 } // namespace ToolkitUtil
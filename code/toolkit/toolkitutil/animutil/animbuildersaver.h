@@ -3,7 +3,10 @@
 /**
     @class ToolkitUtil::AnimBuilderSaver
     
-    Save AnimBuilder object into NAX3 file.
+    Save AnimBuilder object into NAX3 or NAX4 file. NAX4 files store
+    rotation keys as 48-bit smallest-three quaternions, and other keys
+    as 48-bit range-quantized vectors if the w component of all keys of
+    the curve is identical.
     
     (C) 2009 Radon Labs GmbH
 */
@@ -12,6 +15,7 @@
 #include "toolkitutil/platform.h"
 #include "io/stream.h"
 #include "system/byteorder.h"
+#include "coreanimation/naxfileformatstructs.h"
 
 //------------------------------------------------------------------------------
 namespace ToolkitUtil
@@ -21,18 +25,33 @@ class AnimBuilderSaver
 public:
     /// save NAX3 file
     static bool SaveNax3(const IO::URI& uri, AnimBuilder& animBuilder, Platform::Code platform);
+    /// save NAX4 file with quantized keys
+    static bool SaveNax4(const IO::URI& uri, AnimBuilder& animBuilder, Platform::Code platform);
 
 private:
     /// write header to stream
     static void WriteHeader(const Ptr<IO::Stream>& stream, AnimBuilder& animBuilder, const System::ByteOrder& byteOrder);
     /// write clip headers to stream
     static void WriteClips(const Ptr<IO::Stream>& stream, AnimBuilder& animBuilder, const System::ByteOrder& byteOrder);
+    /// write the header of a single clip to stream
+    static void WriteClipHeader(const Ptr<IO::Stream>& stream, AnimBuilderClip& clip, SizeT keyStride, const System::ByteOrder& byteOrder);
     /// write clip anim events to stream
     static void WriteClipAnimEvents(const Ptr<IO::Stream>& stream, AnimBuilderClip& clip, const System::ByteOrder& byteOrder);
     /// write clip anim curves to stream
     static void WriteClipCurves(const Ptr<IO::Stream>& stream, AnimBuilderClip& clip, const System::ByteOrder& byteOrder);
     /// write keys to stream
     static void WriteKeys(const Ptr<IO::Stream>& stream, AnimBuilder& animBuilder, const System::ByteOrder& byteOrder);
+
+    /// select key formats and compute key offsets of all curves, returns the key buffer size
+    static SizeT SetupNax4Curves(AnimBuilder& animBuilder, Util::Array<CoreAnimation::Nax4Curve>& outCurves, Util::Array<SizeT>& outKeyStrides);
+    /// write NAX4 clip headers and curves to stream
+    static void WriteNax4Clips(const Ptr<IO::Stream>& stream, AnimBuilder& animBuilder, const Util::Array<CoreAnimation::Nax4Curve>& curves, const Util::Array<SizeT>& keyStrides, const System::ByteOrder& byteOrder);
+    /// write NAX4 keys to stream
+    static void WriteNax4Keys(const Ptr<IO::Stream>& stream, AnimBuilder& animBuilder, const Util::Array<CoreAnimation::Nax4Curve>& curves, const Util::Array<SizeT>& keyStrides, const System::ByteOrder& byteOrder);
+    /// encode a rotation quaternion as Quat48 key
+    static void EncodeQuat48(const Math::float4& key, ushort* outKey);
+    /// encode a vector as Vec48 key
+    static void EncodeVec48(const Math::float4& key, const CoreAnimation::Nax4Curve& curve, ushort* outKey);
 };
 
 } // namespace ToolkitUtil
@@ -20,6 +20,8 @@ AnimConverter::AnimConverter() :
     platform(Platform::Win32),
     forceFlag(false),
     animDrivenMotionFlag(false),
+    compressKeysFlag(false),
+    keyReductionTolerance(0.0f),
     isValid(false)
 {
     // empty
@@ -164,6 +166,12 @@ AnimConverter::ProcessAnimation(const String& categoryName, const String& animFi
             this->animBuilder.TrimEnd(1);
         }
 
+        // remove keys which can be interpolated
+        if (this->keyReductionTolerance > 0.0f)
+        {
+            this->animBuilder.ReduceKeys(this->keyReductionTolerance);
+        }
+
         // save nax3 anim file
         if (!this->SaveNax3Animation(categoryName, animFileName))
         {
@@ -296,8 +304,17 @@ AnimConverter::LoadNax2Animation(const String& categoryName, const String& animF
 bool
 AnimConverter::SaveNax3Animation(const String& categoryName, const String& animFileName)
 {
+    // NOTE: NAX4 files keep the .nax3 extension, the loader checks the magic number
     String path = this->BuildDstPath(categoryName, animFileName);
-    bool res = AnimBuilderSaver::SaveNax3(path, this->animBuilder, this->platform);
+    bool res;
+    if (this->compressKeysFlag)
+    {
+        res = AnimBuilderSaver::SaveNax4(path, this->animBuilder, this->platform);
+    }
+    else
+    {
+        res = AnimBuilderSaver::SaveNax3(path, this->animBuilder, this->platform);
+    }
     if (!res)
     {
         this->logger->Warning("Failed to save anim '%s'!\n", path.AsCharPtr());
@@ -37,6 +37,10 @@ public:
     void SetForceFlag(bool b);
     /// set flag to create anim-driven-motion data for characters
     void SetAnimDrivenMotionFlag(bool b);
+    /// set flag to write NAX4 files with quantized keys
+    void SetCompressKeysFlag(bool b);
+    /// set tolerance for key reduction (0.0 disables key reduction)
+    void SetKeyReductionTolerance(float t);
 
     /// setup the anim converter
     void Setup(Logger& logger);
@@ -68,7 +72,7 @@ private:
     Util::String BuildDstPath(const Util::String& categoryName, const Util::String& animFileName);
     /// load NAX2 animation into an anim builder object
     bool LoadNax2Animation(const Util::String& categoryName, const Util::String& animFileName);
-    /// save NAX3 animation from anim builder object
+    /// save NAX3 or NAX4 animation from anim builder object
     bool SaveNax3Animation(const Util::String& categoryName, const Util::String& animFileName);
     /// check if conversion is needed 
     bool NeedsConversion(const Util::String& srcFileName, const Util::String& dstFileName);
@@ -80,6 +84,8 @@ private:
     AnimBuilder animBuilder;
     bool forceFlag;
     bool animDrivenMotionFlag;
+    bool compressKeysFlag;
+    float keyReductionTolerance;
     bool isValid;
 };
 
@@ -155,5 +161,23 @@ AnimConverter::SetAnimDrivenMotionFlag(bool b)
     this->animDrivenMotionFlag = b;
 }
 
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+AnimConverter::SetCompressKeysFlag(bool b)
+{
+    this->compressKeysFlag = b;
+}
+
+//------------------------------------------------------------------------------
+/**
+*/
+inline void
+AnimConverter::SetKeyReductionTolerance(float t)
+{
+    this->keyReductionTolerance = t;
+}
+
 } // namespace ToolkitUtil
 //------------------------------------------------------------------------------